@@ -33,6 +33,9 @@ proc setBuildOptions { app_name configuration } {
    app config -name ${app_name} -add linker-misc -Wl,-Map=${app_name}.map 
    # keep the preprocessed file (*.i)
    app config -name ${app_name} -add compiler-misc -save-temps=obj
+   # NEON for the batch math kernels (common/MathBatch.c); the FreeRTOS
+   # port saves the 32 D registers shared with VFP (use_task_fpu_support)
+   app config -name ${app_name} -add compiler-misc -mfpu=neon-vfpv3
 }
 
 proc setSymbol { app_name configuration symbol} {
@@ -691,12 +691,10 @@ static SWORD checkandcompilepdo(UWORD uwPdoNum, BOOL bSync, BOOL bIsRxPdo, CANOP
             sPdoWrkTx[uwPdoNum].f.bCfgSyncCnt=FALSE;
 
             // if acyclic or async trigger immediate tx
-        if( psParam->bType==DS301_PDO_TYPE_ACYCLIC || \
+        spscevent_init(&sPdoWrkTx[uwPdoNum].sRTREvent, \
+            psParam->bType==DS301_PDO_TYPE_ACYCLIC || \
             psParam->bType==DS301_PDO_TYPE_ASYNCHRONOUS_MANUF || \
-            psParam->bType==DS301_PDO_TYPE_ASYNCHRONOUS_STD )
-            sPdoWrkTx[uwPdoNum].f.bStRTRTriggered=TRUE;
-        else
-            sPdoWrkTx[uwPdoNum].f.bStRTRTriggered=FALSE;
+            psParam->bType==DS301_PDO_TYPE_ASYNCHRONOUS_STD);
 
         sPdoWrkTx[uwPdoNum].f.bStTxTrigger=FALSE;
 
@@ -1217,14 +1215,12 @@ void cobRTRrequestevent(CANDRV_COB * pCob)
 
     pCob->flags.bNewRxCob=FALSE;//fast_atomic_clear_bits(pCob->flags, CANDRV_F_NEWCOB);
 
-        // just set flag only if enabled
+        // just post event only if enabled, no shared flags written here
+        // so no atomic section against tx encoding
     if(bCanOpenPSMPdoEnabled)
     {
         psTxP=(CANOPENPSM_PDOFASTENTRY_TX *)(UWORD)pCob->usrdata;
-    
-//        _atomic_(0);
-        psTxP->f.bStRTRTriggered=TRUE;
-//        _endatomic_();
+        spscevent_post(&psTxP->sRTREvent);
     }
 }
 
@@ -15,6 +15,7 @@
 #define _CANOPENPDOSYNCMGR_H
 
 #include "common\CommonDefines.h"
+#include "common\SpscRing.h"
 #include "system\SysAppGlobals.h"
 #include "system\SysAppConfig.h"
 #include "MultiCANController.h"
@@ -86,8 +87,8 @@ typedef struct
         UBYTE       bCfgCompare:1;
 
         UBYTE       bStTxTrigger:1;
-        UBYTE       bStRTRTriggered:1;
     } f;
+    SPSCEVENT       sRTREvent;      // RTR request, posted by can interrupt, taken by tx encoding
     UBYTE           ubNSync;
     UBYTE           ubSyncCnt;
     UWORD           uwNElements;
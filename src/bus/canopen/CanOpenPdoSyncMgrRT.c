@@ -204,8 +204,8 @@ void CanOpenPSM_RT_TxEncode(CANOPENPSM_PDOFASTENTRY_TX * psPdoDef)
         return;
     }
 
-        // by default take RTR triggered flag
-    if(psPdoDef->f.bStRTRTriggered)
+        // by default take RTR request, if any posted since last encoding
+    if(spscevent_take(&psPdoDef->sRTREvent))
         psPdoDef->f.bStTxTrigger=TRUE;
 
     {
@@ -360,13 +360,12 @@ void CanOpenPSM_RT_TxEncode(CANOPENPSM_PDOFASTENTRY_TX * psPdoDef)
     if(psPdoDef->f.bStTxTrigger)
     	memset(&(pCob->flags),0,sizeof(pCob->flags));//pCob->flags=CANDRV_F_DEFAULT;
 
-    psPdoDef->f.bStRTRTriggered=FALSE;
     return;
 
  hookerror:       
     CanOpenCM_CanFaultSignal(CANOPENPSM_PE_MASK(CANOPENPSM_PDOERR_HOOKPROCESSINGFAIL));
 
-    psPdoDef->f.bStTxTrigger=psPdoDef->f.bStRTRTriggered=FALSE;
+    psPdoDef->f.bStTxTrigger=FALSE;
     return;
 }
 
@@ -752,8 +752,10 @@ BOOL candrv_setperiodiccob(UWORD cannode, CANDRV_ID id, ULONG period)
     // set counter to 1, then next RT calling will send first COB
     sCanDrvSyncCobStat[cannode].uwCounter=1;
 
-    // calculate number of realtime task ticks
-    sCanDrvSyncCobStat[cannode].uwRestart=(UWORD)(period/(1000000/REALTIME_TASK_FREQ));
+    // calculate number of periodic COB task runs, at least one
+    sCanDrvSyncCobStat[cannode].uwRestart=(UWORD)(period/(CANDRV_PERIODICCOB_NSLOTS*1000000/REALTIME_TASK_FREQ));
+    if(sCanDrvSyncCobStat[cannode].uwRestart==0)
+        sCanDrvSyncCobStat[cannode].uwRestart=1;
 
     return TRUE;
 }
@@ -1228,7 +1230,7 @@ BOOL candrv_init(void)
 
         // install realtime task for periodic COBS
 #ifdef CFG_CANDRV_PERIODICCOB
-    if(!TaskSched_AddRTTask(&candrv_RT_periodiccobprocessing, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), 0))
+    if(!TaskSched_AddRTTask(&candrv_RT_periodiccobprocessing, TASKSCHEDULER_FLAG_EXEEVERYNSLOTS, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), CANDRV_PERIODICCOB_NSLOTS))
         return FALSE;
 #endif
 
@@ -48,6 +48,7 @@ typedef struct
     volatile CANDRV_COB  *  psTxCob;
 } TXMBOXPARAMS;
 
+    // periodic COB counters are in units of # realtime slots
 typedef struct
 {
     UWORD                   uwCounter;
@@ -57,6 +58,10 @@ typedef struct
 //***************************************************************************
 // Macros
 
+    // periodic COB task runs every # slots (500us), phase balanced by the
+    // scheduler
+#define CANDRV_PERIODICCOB_NSLOTS   4
+
     // max rx list, for optimized rx irq handler
 #define MAX_RXLIST_COBS         16
 
@@ -11,6 +11,7 @@
 /****************************************************************************/
 
 #include "common\CommonDefines.h"
+#include "common\Crc.h"
 #include "ECATEeprom.h"
 #include "ECATHw.h"
 #include "ecat_def.h"
@@ -149,7 +150,6 @@ static SWORD  * pswPort1Delay;
 //***************************************************************************
 // Local prototypes
 
-static ULONG crcbitbybitfast(void  *, ULONG);
 static SWORD escinfocheck(UBYTE  **);
 static SWORD slaveinfocheck(UBYTE  **);
 static SWORD catstringscheck(UBYTE  **);
@@ -174,33 +174,6 @@ static SWORD (* const pfE2PCheckMacro[])(UBYTE  **)=
 	&catendcheck,
 };
 
-//***************************************************************************
-// CRC calc per escinfo
-
-static ULONG crcbitbybitfast(void  * p, ULONG len)
-{
-	ULONG i, j, c, selbit;
-	ULONG crc = 0xFF;
-	ULONG crchighbit = 0x80;
-	ULONG polynom = 0x07;
-    UBYTE * bp = (UBYTE *)p;
-
-	for (i=0; i<len; i++)
-	{
-		c = (ULONG)*bp++;
-
-		for (j=0x80; j; j>>=1)
-		{
-			selbit = crc & crchighbit;
-			crc <<= 1;
-			if (c & j) selbit ^= crchighbit;
-			if (selbit) crc ^= polynom;
-		}
-	}   
-
-	return crc;
-}
-
 //***************************************************************************
 // Controllo ESC info area
 
@@ -216,7 +189,7 @@ static SWORD escinfocheck(UBYTE  ** e2paddress)
     tValid->ConfStatAlias=tEcatCMParam.uwConfStatAlias;
 	
 		// calcolo CRC struttura valida
-	crc=crcbitbybitfast(tValid, ECATE2P_SZ_FIX_ESCINFO);
+	crc=Crc8_Update(CRC8_INIT, (const UBYTE *)tValid, ECATE2P_SZ_FIX_ESCINFO);
 	tValid->Cksum=(UWORD)(crc&0x000000ff);
 
         // aggiorno puntatori di riferimento
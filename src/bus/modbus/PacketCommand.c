@@ -231,8 +231,6 @@ SWORD ExecutePacketCommand( HPUBYTE hpubInpBuffer, HPUBYTE hpubOutBuffer )
 #ifdef _AXX_SYSAPP
     	  bSysStatProgramFlashWriting=TRUE;
 #endif
-    	  // Disable Interrupts
-    	  DISABLE_IRQ();
     	  // Erase Sector : Internal Program FLASH
     	  if ( psMemorySectorInfo->uwMemoryConfig & MEMORY_CONFIG_PFLASH ) {
 #ifdef _AXX_BOOTBLOCK
@@ -246,8 +244,11 @@ SWORD ExecutePacketCommand( HPUBYTE hpubInpBuffer, HPUBYTE hpubOutBuffer )
 #ifndef _RD
     		  // Erase Sector : External Serial FLASH
     	  } else if ( psMemorySectorInfo->uwMemoryConfig & MEMORY_CONFIG_SFLASH ) {
+    		  // Disable Interrupts (only serial FLASH, program FLASH is queued)
+    		  DISABLE_IRQ();
     		  if( SerialFlashEraseSector( psMemorySectorInfo->ulLowerAddress ) )
     			  ubResult = PACKET_COMMAND_ANS_READY;
+    		  RESTORE_IRQ();
 #ifdef _AXX_BOOTBLOCK
     		  // if bootblock then always return OK, to comply with older controlboard
     		  // small sflash chip
@@ -255,8 +256,6 @@ SWORD ExecutePacketCommand( HPUBYTE hpubInpBuffer, HPUBYTE hpubOutBuffer )
 #endif
 #endif
     	  }
-    	  // Enable Interrupts
-    	  RESTORE_IRQ();
 
     	  // Set Result
     	  ubResult = PACKET_COMMAND_ANS_READY;
@@ -318,8 +317,6 @@ SWORD ExecutePacketCommand( HPUBYTE hpubInpBuffer, HPUBYTE hpubOutBuffer )
 #ifdef _AXX_SYSAPP
     	  bSysStatProgramFlashWriting=TRUE;
 #endif
-    	  // Disable Interrupts
-    	  DISABLE_IRQ();
     	  // Write Bytes : Internal Program FLASH
     	  if ( psMemorySectorInfo->uwMemoryConfig & MEMORY_CONFIG_PFLASH ) {
 #ifdef _AXX_BOOTBLOCK
@@ -333,8 +330,11 @@ SWORD ExecutePacketCommand( HPUBYTE hpubInpBuffer, HPUBYTE hpubOutBuffer )
 #ifndef _RD
     		  // Write Bytes : External Serial FLASH
     	  } else if ( psMemorySectorInfo->uwMemoryConfig & MEMORY_CONFIG_SFLASH ) {
+    		  // Disable Interrupts (only serial FLASH, program FLASH is queued)
+    		  DISABLE_IRQ();
     		  if( SerialFlashWriteBytes( ulAddrs, hpubInpBuffer, uwLength ) )
     			  ubResult = PACKET_COMMAND_ANS_READY;
+    		  RESTORE_IRQ();
 #ifdef _AXX_BOOTBLOCK
     		  // if bootblock then always return OK, to comply with older controlboard
     		  // small sflash chip
@@ -342,8 +342,6 @@ SWORD ExecutePacketCommand( HPUBYTE hpubInpBuffer, HPUBYTE hpubOutBuffer )
 #endif
 #endif
     	  }
-    	  // Enable Interrupts
-    	  RESTORE_IRQ();
 
 #ifdef _AXX_SYSAPP
     	  bSysStatProgramFlashWriting=FALSE;
@@ -0,0 +1,138 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : AmpMailbox.c                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Single producer/single consumer mailboxes shared           */
+/*               between CPU0 and CPU1 (AMP) in OCM                         */
+/*                                                                          */
+/****************************************************************************/
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\AmpMailbox.h"
+#include "common\TaskScheduler.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// Compiler Option
+#pragma GCC optimize (2)
+
+//***************************************************************************
+// Local prototypes
+
+static BOOL mboxserve(ULONG);
+
+//***************************************************************************
+// Globals
+
+    // mailboxes, out of .bss as cleared at init
+AMPMBOX sAmpMbox[AMPMBOX_COUNT] __attribute__((section(".amp_shared_section"), aligned(AMPMBOX_SLOT_SIZE)));
+
+//***************************************************************************
+// Locals
+
+    // handlers, set before second core start and then read only
+static AMPMBOX_HANDLER pfAmpMboxHandler[AMPMBOX_COUNT][AMPMBOX_CODES];
+
+//***************************************************************************
+// Init, before second core start: mailboxes are served by the background
+// scheduler of the consumer core
+
+BOOL AmpMbox_Init(void)
+{
+    UWORD uwBox;
+
+    memset(sAmpMbox, 0, sizeof(sAmpMbox));
+    memset(pfAmpMboxHandler, 0, sizeof(pfAmpMboxHandler));
+    for(uwBox=0;uwBox<AMPMBOX_COUNT;uwBox++)
+        spscring_init(&sAmpMbox[uwBox].sRing, sAmpMbox[uwBox].sMsg, AMPMBOX_SLOTS, sizeof(AMPMBOX_MSG));
+
+    if(!TaskSched_AddBackgroundTaskCpu1(&mboxserve, TASKSCHEDULER_BKG_PRIO_HIGH, 0, AMPMBOX_TOCPU1))
+        return FALSE;
+
+    return TaskSched_AddBackgroundTaskEx(&mboxserve, TASKSCHEDULER_BKG_PRIO_HIGH, 0, AMPMBOX_TOCPU0);
+}
+
+//***************************************************************************
+// Set handler of message code on mailbox, before second core start
+
+BOOL AmpMbox_SetHandler(UWORD uwBox, UWORD uwCode, AMPMBOX_HANDLER pfHandler)
+{
+    if(uwBox>=AMPMBOX_COUNT || uwCode>=AMPMBOX_CODES)
+        return FALSE;
+
+    pfAmpMboxHandler[uwBox][uwCode]=pfHandler;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Post message, producer side; FALSE if full or payload too long
+
+BOOL AmpMbox_Post(UWORD uwBox, UWORD uwCode, const void * pvData, UWORD uwSize)
+{
+    AMPMBOX_MSG * psMsg;
+
+    if(uwSize>AMPMBOX_PAYLOAD_SIZE)
+        return FALSE;
+
+        // fill slot in place
+    psMsg=(AMPMBOX_MSG *)spscring_reserve(&sAmpMbox[uwBox].sRing);
+    if(psMsg==NULL)
+        return FALSE;
+
+    psMsg->uwCode=uwCode;
+    psMsg->uwSize=uwSize;
+    memcpy(psMsg->ubData, pvData, uwSize);
+
+        // publish slot
+    spscring_commit(&sAmpMbox[uwBox].sRing);
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Fetch message, consumer side; FALSE if empty
+
+BOOL AmpMbox_Fetch(UWORD uwBox, AMPMBOX_MSG * psMsg)
+{
+    return spscring_pop(&sAmpMbox[uwBox].sRing, psMsg);
+}
+
+//***************************************************************************
+// No. of messages pending
+
+UWORD AmpMbox_Pending(UWORD uwBox)
+{
+    return (UWORD)spscring_count(&sAmpMbox[uwBox].sRing);
+}
+
+//***************************************************************************
+// Dispatch pending messages to handlers, consumer side; messages without
+// handler are dropped. Return no. of messages served
+
+UWORD AmpMbox_Serve(UWORD uwBox)
+{
+    AMPMBOX_MSG sMsg;
+    UWORD uwCnt;
+
+        // at most one mailbox round, producer may keep posting
+    for(uwCnt=0;uwCnt<AMPMBOX_SLOTS && AmpMbox_Fetch(uwBox, &sMsg);uwCnt++)
+        if(sMsg.uwCode<AMPMBOX_CODES && pfAmpMboxHandler[uwBox][sMsg.uwCode])
+            (*pfAmpMboxHandler[uwBox][sMsg.uwCode])(&sMsg);
+
+    return uwCnt;
+}
+
+//***************************************************************************
+// Background task serving mailbox #, continuation if more pending
+
+static BOOL mboxserve(ULONG ulBox)
+{
+    AmpMbox_Serve((UWORD)ulBox);
+
+    return AmpMbox_Pending((UWORD)ulBox)!=0;
+}
@@ -0,0 +1,96 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : AmpMailbox.h                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Single producer/single consumer mailboxes shared           */
+/*               between CPU0 and CPU1 (AMP) in OCM                         */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _AMPMAILBOX_H
+#define _AMPMAILBOX_H
+
+#include "common\CommonDefines.h"
+#include "common\SpscRing.h"
+
+//***************************************************************************
+// Configuration
+
+    // mailboxes, each one with a single producer and a single consumer core
+#define AMPMBOX_TOCPU1                  0           // CPU0 -> CPU1 requests
+#define AMPMBOX_TOCPU0                  1           // CPU1 -> CPU0 replies and notifications
+#define AMPMBOX_COUNT                   2
+
+    // slots per mailbox (power of 2)
+#define AMPMBOX_SLOTS                   16
+    // slot size, one cache line
+#define AMPMBOX_SLOT_SIZE               32
+#define AMPMBOX_PAYLOAD_SIZE            (AMPMBOX_SLOT_SIZE-2*sizeof(UWORD))
+    // message codes per mailbox
+#define AMPMBOX_CODES                   16
+
+    // message codes, unique per mailbox
+#define AMPMBOX_CODE_FLASHQ_WRITE       1           // TOCPU1: queue flash write
+#define AMPMBOX_CODE_FLASHQ_ERASE       2           // TOCPU1: queue flash erase
+#define AMPMBOX_CODE_FLASHQ_DONE        1           // TOCPU0: flash requests completed
+
+//***************************************************************************
+// Memory barrier: slot contents are visible to the other core before the
+// index publishing them
+
+#define AMPMBOX_BARRIER()               SPSCRING_BARRIER()
+
+//***************************************************************************
+// Structures
+
+    // Message, one slot
+typedef struct
+{
+    UWORD           uwCode;                     // message code
+    UWORD           uwSize;                     // payload size
+    UBYTE           ubData[AMPMBOX_PAYLOAD_SIZE];
+} AMPMBOX_MSG;
+
+    // Mailbox; ring indexes on own cache lines, as each one is written
+    // by a different core
+typedef struct
+{
+    SPSCRING        sRing;
+    AMPMBOX_MSG     sMsg[AMPMBOX_SLOTS];
+} AMPMBOX;
+
+    // Message handler, called by the consumer core
+typedef void (* AMPMBOX_HANDLER)(const AMPMBOX_MSG *);
+
+//***************************************************************************
+// Globals
+
+    // mailboxes, in OCM shared section
+extern AMPMBOX sAmpMbox[AMPMBOX_COUNT];
+
+//***************************************************************************
+// Prototypes
+
+// Init, before second core start
+BOOL AmpMbox_Init(void);
+
+// Set handler of message code on mailbox, before second core start
+BOOL AmpMbox_SetHandler(UWORD, UWORD, AMPMBOX_HANDLER);
+
+// Post message, producer side; FALSE if full or payload too long
+BOOL AmpMbox_Post(UWORD, UWORD, const void *, UWORD);
+
+// Fetch message, consumer side; FALSE if empty
+BOOL AmpMbox_Fetch(UWORD, AMPMBOX_MSG *);
+
+// No. of messages pending
+UWORD AmpMbox_Pending(UWORD);
+
+// Dispatch pending messages to handlers, consumer side; return no. served
+UWORD AmpMbox_Serve(UWORD);
+
+#endif
@@ -0,0 +1,324 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : Atomics.h                                                  */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Single-copy atomic accesses, barriers and                  */
+/*               seqlock, header only                                       */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _ATOMICS_H
+#define _ATOMICS_H
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+
+//***************************************************************************
+// Usage
+//
+// Cortex-A9 naturally aligned byte, halfword and word accesses are single
+// copy atomic, doubleword ones are only through LDREXD/STREXD: atomic_ld64
+// and atomic_st64 need an 8 byte aligned address.
+// Read-modify-write of shared bits (set/clear/write under mask) is done with
+// an exclusive load/store loop, safe against interrupts and against CPU1.
+//
+// Multi-word data written by one context and read by others is protected by
+// a seqlock: the writer never waits, readers retry while a write is running
+// or happened during their copy.
+//
+// Writer:  seqlock_write_begin(&l); update data; seqlock_write_end(&l);
+// Reader:  do { s=seqlock_read_begin(&l); copy data; } while(seqlock_read_retry(&l, s));
+//
+// A reader that may preempt the writer (interrupt reading data written by
+// background) must use seqlock_read, bounded in retries, the writer cannot
+// complete until the reader returns.
+
+//***************************************************************************
+// Configuration
+
+    // Max. copy attempts of seqlock_read
+#define ATOMIC_SEQLOCK_RETRIES          8
+
+//***************************************************************************
+// Barriers: ATOMIC_DMB orders memory accesses also for the other CPU and bus
+// masters, ATOMIC_COMPILER_BARRIER only prevents compiler reordering
+
+#define ATOMIC_COMPILER_BARRIER()       __asm__ __volatile__ ("" ::: "memory")
+
+#ifdef _HW_HOSTSIM
+#define ATOMIC_DMB()                    __sync_synchronize()
+#else
+#define ATOMIC_DMB()                    __asm__ __volatile__ ("dmb" ::: "memory")
+#endif
+
+//***************************************************************************
+// Local interrupt masking, for the copies that cannot be single-copy atomic
+
+#ifdef _HW_HOSTSIM
+#define ATOMIC_IRQ_SAVE(ulFlags)        { (ulFlags)=0; ATOMIC_COMPILER_BARRIER(); }
+#define ATOMIC_IRQ_RESTORE(ulFlags)     { (void)(ulFlags); ATOMIC_COMPILER_BARRIER(); }
+#else
+#define ATOMIC_IRQ_SAVE(ulFlags)        __asm__ __volatile__ ("mrs %0, cpsr\n\tcpsid i" : "=r" (ulFlags) :: "memory")
+#define ATOMIC_IRQ_RESTORE(ulFlags)     __asm__ __volatile__ ("msr cpsr_c, %0" :: "r" (ulFlags) : "memory")
+#endif
+
+//***************************************************************************
+// Structures
+
+    // Sequence lock, odd while a write is running
+typedef struct
+{
+    volatile ULONG  ulSeq;
+} ATOMIC_SEQLOCK;
+
+//***************************************************************************
+// 8/16/32 bit load and store, address naturally aligned
+
+static inline UBYTE atomic_ld8(const volatile void * pvSrc)
+{
+    return *(const volatile UBYTE *)pvSrc;
+}
+
+static inline void atomic_st8(volatile void * pvDst, UBYTE ubVal)
+{
+    *(volatile UBYTE *)pvDst=ubVal;
+}
+
+static inline UWORD atomic_ld16(const volatile void * pvSrc)
+{
+    return *(const volatile UWORD *)pvSrc;
+}
+
+static inline void atomic_st16(volatile void * pvDst, UWORD uwVal)
+{
+    *(volatile UWORD *)pvDst=uwVal;
+}
+
+static inline ULONG atomic_ld32(const volatile void * pvSrc)
+{
+    return *(const volatile ULONG *)pvSrc;
+}
+
+static inline void atomic_st32(volatile void * pvDst, ULONG ulVal)
+{
+    *(volatile ULONG *)pvDst=ulVal;
+}
+
+//***************************************************************************
+// 64 bit load, address 8 byte aligned
+
+static inline ULLNG atomic_ld64(const volatile void * pvSrc)
+{
+#ifdef _HW_HOSTSIM
+    return __atomic_load_n((const volatile ULLNG *)pvSrc, __ATOMIC_RELAXED);
+#else
+    ULLNG ullVal;
+
+    __asm__ __volatile__ (
+        "ldrexd     %0, %H0, [%1]       \n\t"
+        "clrex                          \n\t"
+        : "=&r" (ullVal)
+        : "r" (pvSrc)
+        : "memory");
+
+    return ullVal;
+#endif
+}
+
+//***************************************************************************
+// 64 bit store, address 8 byte aligned. STREXD succeeds only after an
+// exclusive load of the same address, so the old value is loaded first
+
+static inline void atomic_st64(volatile void * pvDst, ULLNG ullVal)
+{
+#ifdef _HW_HOSTSIM
+    __atomic_store_n((volatile ULLNG *)pvDst, ullVal, __ATOMIC_RELAXED);
+#else
+    ULLNG ullOld;
+    ULONG ulFail;
+
+    __asm__ __volatile__ (
+        "1: ldrexd  %0, %H0, [%2]       \n\t"
+        "   strexd  %1, %3, %H3, [%2]   \n\t"
+        "   teq     %1, #0              \n\t"
+        "   bne     1b                  \n\t"
+        : "=&r" (ullOld), "=&r" (ulFail)
+        : "r" (pvDst), "r" (ullVal)
+        : "cc", "memory");
+#endif
+}
+
+//***************************************************************************
+// Write bits under mask: *dst=(*dst&~mask)|(data&mask), new value returned
+
+static inline UBYTE atomic_wrbits8(volatile void * pvDst, UBYTE ubData, UBYTE ubMask)
+{
+#ifdef _HW_HOSTSIM
+    volatile UBYTE * pubDst=(volatile UBYTE *)pvDst;
+    UBYTE ubOld=*pubDst;
+    UBYTE ubNew;
+
+    do
+        ubNew=(UBYTE)((ubOld&~ubMask)|(ubData&ubMask));
+    while(!__atomic_compare_exchange_n(pubDst, &ubOld, ubNew, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return ubNew;
+#else
+    ULONG ulNew;
+    ULONG ulFail;
+
+    __asm__ __volatile__ (
+        "1: ldrexb  %0, [%2]            \n\t"
+        "   bic     %0, %0, %4          \n\t"
+        "   orr     %0, %0, %3          \n\t"
+        "   strexb  %1, %0, [%2]        \n\t"
+        "   teq     %1, #0              \n\t"
+        "   bne     1b                  \n\t"
+        : "=&r" (ulNew), "=&r" (ulFail)
+        : "r" (pvDst), "r" ((ULONG)(ubData&ubMask)), "r" ((ULONG)ubMask)
+        : "cc", "memory");
+
+    return (UBYTE)ulNew;
+#endif
+}
+
+static inline UWORD atomic_wrbits16(volatile void * pvDst, UWORD uwData, UWORD uwMask)
+{
+#ifdef _HW_HOSTSIM
+    volatile UWORD * puwDst=(volatile UWORD *)pvDst;
+    UWORD uwOld=*puwDst;
+    UWORD uwNew;
+
+    do
+        uwNew=(UWORD)((uwOld&~uwMask)|(uwData&uwMask));
+    while(!__atomic_compare_exchange_n(puwDst, &uwOld, uwNew, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return uwNew;
+#else
+    ULONG ulNew;
+    ULONG ulFail;
+
+    __asm__ __volatile__ (
+        "1: ldrexh  %0, [%2]            \n\t"
+        "   bic     %0, %0, %4          \n\t"
+        "   orr     %0, %0, %3          \n\t"
+        "   strexh  %1, %0, [%2]        \n\t"
+        "   teq     %1, #0              \n\t"
+        "   bne     1b                  \n\t"
+        : "=&r" (ulNew), "=&r" (ulFail)
+        : "r" (pvDst), "r" ((ULONG)(uwData&uwMask)), "r" ((ULONG)uwMask)
+        : "cc", "memory");
+
+    return (UWORD)ulNew;
+#endif
+}
+
+static inline ULONG atomic_wrbits32(volatile void * pvDst, ULONG ulData, ULONG ulMask)
+{
+#ifdef _HW_HOSTSIM
+    volatile ULONG * pulDst=(volatile ULONG *)pvDst;
+    ULONG ulOld=*pulDst;
+    ULONG ulNew;
+
+    do
+        ulNew=(ulOld&~ulMask)|(ulData&ulMask);
+    while(!__atomic_compare_exchange_n(pulDst, &ulOld, ulNew, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return ulNew;
+#else
+    ULONG ulNew;
+    ULONG ulFail;
+
+    __asm__ __volatile__ (
+        "1: ldrex   %0, [%2]            \n\t"
+        "   bic     %0, %0, %4          \n\t"
+        "   orr     %0, %0, %3          \n\t"
+        "   strex   %1, %0, [%2]        \n\t"
+        "   teq     %1, #0              \n\t"
+        "   bne     1b                  \n\t"
+        : "=&r" (ulNew), "=&r" (ulFail)
+        : "r" (pvDst), "r" (ulData&ulMask), "r" (ulMask)
+        : "cc", "memory");
+
+    return ulNew;
+#endif
+}
+
+//***************************************************************************
+// Seqlock init, before readers and writer are running
+
+static inline void seqlock_init(ATOMIC_SEQLOCK * psLock)
+{
+    psLock->ulSeq=0;
+    ATOMIC_DMB();
+}
+
+//***************************************************************************
+// Seqlock writer: one writer only, or writers serialized by the caller
+
+static inline void seqlock_write_begin(ATOMIC_SEQLOCK * psLock)
+{
+    psLock->ulSeq=psLock->ulSeq+1;
+    ATOMIC_DMB();
+}
+
+static inline void seqlock_write_end(ATOMIC_SEQLOCK * psLock)
+{
+    ATOMIC_DMB();
+    psLock->ulSeq=psLock->ulSeq+1;
+}
+
+//***************************************************************************
+// Seqlock reader: sequence at copy start, TRUE from retry if the copy may be
+// torn and must be repeated
+
+static inline ULONG seqlock_read_begin(const ATOMIC_SEQLOCK * psLock)
+{
+    ULONG ulSeq=psLock->ulSeq;
+
+    ATOMIC_DMB();
+
+    return ulSeq;
+}
+
+static inline BOOL seqlock_read_retry(const ATOMIC_SEQLOCK * psLock, ULONG ulSeq)
+{
+    ATOMIC_DMB();
+
+    return (BOOL)((ulSeq&1) || psLock->ulSeq!=ulSeq);
+}
+
+//***************************************************************************
+// Seqlock protected copies of a whole structure. seqlock_read returns FALSE
+// if no coherent copy was got in ATOMIC_SEQLOCK_RETRIES attempts (reader
+// preempting the writer), pvDst holds a possibly torn copy
+
+static inline void seqlock_write(ATOMIC_SEQLOCK * psLock, void * pvDst, const void * pvSrc, ULONG ulSize)
+{
+    seqlock_write_begin(psLock);
+    memcpy(pvDst, pvSrc, ulSize);
+    seqlock_write_end(psLock);
+}
+
+static inline BOOL seqlock_read(const ATOMIC_SEQLOCK * psLock, void * pvDst, const void * pvSrc, ULONG ulSize)
+{
+    UWORD uwRetry;
+    ULONG ulSeq;
+
+    for(uwRetry=0; uwRetry<ATOMIC_SEQLOCK_RETRIES; uwRetry++)
+    {
+        ulSeq=seqlock_read_begin(psLock);
+        memcpy(pvDst, pvSrc, ulSize);
+        if(!seqlock_read_retry(psLock, ulSeq))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+#endif
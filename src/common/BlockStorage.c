@@ -34,6 +34,10 @@
 static SWORD search_block(void  * *,ULONG *,SWORD,UWORD  * *);
 static HPVOID getblockdataaddr(BLKSTOR_HEADER  * head_addr);
 static SWORD findandgetdata(void  * stor_addr,ULONG stor_size,SWORD blkcode,void  * dest_addr,SWORD dest_size,void  * * data_addr);
+static SWORD getvaliddata(UWORD  * blk_addr,void  * dest_addr,SWORD dest_size,void  * * data_addr);
+static UWORD index_upper(const BLKSTOR_INDEX  * index,SWORD blkcode);
+static SWORD index_insert(BLKSTOR_INDEX  * index,UWORD  * blk_addr,SWORD blkcode);
+static UWORD  * index_find(const BLKSTOR_INDEX  * index,SWORD blkcode);
 
 //****************************************************************************
 // Cerca un blocco valido (se blkcode=0) oppure cerca il blocco specificato
@@ -157,7 +161,7 @@ static HPVOID getblockdataaddr(BLKSTOR_HEADER  * head_addr)
     if(head_addr->uwStartSignature==BLKSTOR_SIGN_HEAD)
         return (HPVOID)&(((UBYTE  *)(head_addr))[sizeof(BLKSTOR_HEADER)]);
     else
-        return (HPVOID)((ULONG)(UBYTE  *)head_addr-(head_addr->uwSize-sizeof(BLKSTOR_HEADER)));
+        return (HPVOID)((UBYTE  *)head_addr-(head_addr->uwSize-sizeof(BLKSTOR_HEADER)));
 }
 
 //****************************************************************************
@@ -172,11 +176,9 @@ static HPVOID getblockdataaddr(BLKSTOR_HEADER  * head_addr)
 
 static SWORD findandgetdata(void  * stor_addr,ULONG stor_size,SWORD blkcode,void  * dest_addr,SWORD dest_size,void  * * data_addr)
 {
-	BLKSTOR_HEADER lblk;
 	UWORD  * ldest;
     ULONG * stsize;
 	SWORD retval;
-    HPVOID ldaddr;
 
 	if(blkcode<1 || blkcode>32767)
 		return BLKSTOR_ERR_INVALIDSELBLK;
@@ -190,14 +192,26 @@ static SWORD findandgetdata(void  * stor_addr,ULONG stor_size,SWORD blkcode,void
 	if(retval<0)
 		return retval;
 	
-	memcpy(&lblk,ldest,sizeof(BLKSTOR_HEADER));
+    return getvaliddata(ldest,dest_addr,dest_size,data_addr);
+}
+
+//****************************************************************************
+// Copia e/o ritorna l'indirizzo dei dati di un blocco gia' validato
+// ritorna la dimensione del blocco (se >0) oppure errore (se <0)
+
+static SWORD getvaliddata(UWORD  * blk_addr,void  * dest_addr,SWORD dest_size,void  * * data_addr)
+{
+	BLKSTOR_HEADER lblk;
+    HPVOID ldaddr;
+
+	memcpy(&lblk,blk_addr,sizeof(BLKSTOR_HEADER));
 
     lblk.uwSize-=sizeof(BLKSTOR_HEADER);
 
 	if(dest_size>0 && dest_size<lblk.uwSize)
 		return BLKSTOR_ERR_INVALIDSIZE;
 	
-    ldaddr=getblockdataaddr((BLKSTOR_HEADER  *)ldest);
+    ldaddr=getblockdataaddr((BLKSTOR_HEADER  *)blk_addr);
 
 	if(dest_addr!=NULL)
 		memcpy((void  *)dest_addr,ldaddr,lblk.uwSize);
@@ -314,3 +328,218 @@ SWORD blkstor_tail_end(BLKSTOR_HEADER  * head_addr)
     
 	return head_addr->swCode;
 }
+
+//****************************************************************************
+// Indice: posizione (in ordine di codice) del primo elemento con codice
+// maggiore di quello specificato
+
+static UWORD index_upper(const BLKSTOR_INDEX  * index,SWORD blkcode)
+{
+    UWORD lo=0,hi=index->uwCount,mid;
+
+    while(lo<hi)
+    {
+        mid=(lo+hi)>>1;
+        if(index->psEntry[index->psEntry[mid].uwSorted].swCode<=blkcode)
+            lo=mid+1;
+        else
+            hi=mid;
+    }
+
+    return lo;
+}
+
+//****************************************************************************
+// Indice: aggiunge un blocco valido; i blocchi sono aggiunti in ordine di
+// memorizzazione, quindi a parita' di codice va dopo quelli gia' presenti
+
+static SWORD index_insert(BLKSTOR_INDEX  * index,UWORD  * blk_addr,SWORD blkcode)
+{
+    UWORD pos,ct;
+
+    if(index->uwCount>=index->uwMaxEntries)
+    {
+        index->bOverflow=TRUE;
+        return BLKSTOR_ERR_INDEXFULL;
+    }
+
+    pos=index_upper(index,blkcode);
+    for(ct=index->uwCount;ct>pos;ct--)
+        index->psEntry[ct].uwSorted=index->psEntry[ct-1].uwSorted;
+    index->psEntry[pos].uwSorted=index->uwCount;
+
+    index->psEntry[index->uwCount].ulOffset=(ULONG)((UBYTE  *)blk_addr-index->pubStor);
+    index->psEntry[index->uwCount].swCode=blkcode;
+    index->uwCount++;
+
+    return blkcode;
+}
+
+//****************************************************************************
+// Indice: ultimo blocco valido con il codice specificato, NULL se assente;
+// se l'indice e' pieno la ricerca e' fatta scandendo tutta l'area
+
+static UWORD  * index_find(const BLKSTOR_INDEX  * index,SWORD blkcode)
+{
+    BLKSTOR_INDEX_ENTRY  * lent;
+    UWORD  * lfound=NULL;
+    UWORD  * blk;
+    void  * stor_addr;
+    ULONG stor_size;
+    UWORD pos;
+
+    if(index->bOverflow)
+    {
+        stor_addr=index->pubStor;
+        stor_size=index->ulStorSize;
+        while(search_block(&stor_addr,&stor_size,blkcode,&blk)>0)
+            lfound=blk;
+        return lfound;
+    }
+
+    pos=index_upper(index,blkcode);
+    if(pos==0)
+        return NULL;
+
+    lent=&index->psEntry[index->psEntry[pos-1].uwSorted];
+    if(lent->swCode!=blkcode)
+        return NULL;
+
+    return (UWORD  *)&index->pubStor[lent->ulOffset];
+}
+
+//****************************************************************************
+// Costruisce l'indice dei blocchi validi di una zona di storage con una sola
+// scansione; ritorna il numero di blocchi indicizzati oppure errore se
+// entries non basta a contenerli tutti (l'indice resta comunque usabile)
+
+SWORD blkstor_index_build(BLKSTOR_INDEX  * index,void  * stor_addr,ULONG stor_size,BLKSTOR_INDEX_ENTRY  * entries,UWORD max_entries)
+{
+    UWORD  * blk;
+    SWORD blkcode;
+
+    index->pubStor=(UBYTE  *)stor_addr;
+    index->ulStorSize=stor_size;
+    index->psEntry=entries;
+    index->uwMaxEntries=max_entries;
+    index->uwCount=0;
+    index->bOverflow=FALSE;
+
+    while((blkcode=search_block(&stor_addr,&stor_size,0,&blk))>0)
+        if(index_insert(index,blk,blkcode)<0)
+            return BLKSTOR_ERR_INDEXFULL;
+
+    return (SWORD)index->uwCount;
+}
+
+//****************************************************************************
+// Aggiunge all'indice un blocco appena memorizzato in coda all'area
+// (header creato con blkstor_createheader o blkstor_tail_end); il blocco
+// viene validato una volta, ritorna il suo codice oppure errore
+
+SWORD blkstor_index_add(BLKSTOR_INDEX  * index,void  * blk_addr)
+{
+    UWORD  * blk;
+    SWORD blkcode;
+
+    if((UBYTE  *)blk_addr<index->pubStor || (UBYTE  *)blk_addr+sizeof(BLKSTOR_HEADER)>index->pubStor+index->ulStorSize)
+        return BLKSTOR_ERR_NOTFOUND;
+
+    blkcode=search_block(&blk_addr,NULL,0,&blk);
+    if(blkcode<0)
+        return blkcode;
+
+        // se pieno le ricerche scandiscono l'area, il blocco e' comunque visto
+    if(index->bOverflow)
+        return blkcode;
+
+    return index_insert(index,blk,blkcode);
+}
+
+//****************************************************************************
+// Ritorna i dati dell'ultimo blocco con codice specificato tramite indice
+
+SWORD blkstor_index_getdata(const BLKSTOR_INDEX  * index,SWORD blkcode,void  * dest_addr,SWORD dest_size)
+{
+    UWORD  * blk;
+
+	if(blkcode<1 || blkcode>32767)
+		return BLKSTOR_ERR_INVALIDSELBLK;
+
+    if((blk=index_find(index,blkcode))==NULL)
+        return BLKSTOR_ERR_NOTFOUND;
+
+    return getvaliddata(blk,dest_addr,dest_size,NULL);
+}
+
+//****************************************************************************
+// Ritorna l'indirizzo dei dati dell'ultimo blocco con codice specificato
+// tramite indice
+
+SWORD blkstor_index_getaddr(const BLKSTOR_INDEX  * index,SWORD blkcode,void  * * data_addr)
+{
+    UWORD  * blk;
+
+	if(blkcode<1 || blkcode>32767)
+		return BLKSTOR_ERR_INVALIDSELBLK;
+
+    if((blk=index_find(index,blkcode))==NULL)
+        return BLKSTOR_ERR_NOTFOUND;
+
+    return getvaliddata(blk,NULL,0,data_addr);
+}
+
+//****************************************************************************
+// Enumera i blocchi indicizzati in ordine di memorizzazione, pos va
+// azzerato prima della prima chiamata; i blocchi ritornati si leggono con
+// blkstor_index_read senza ricalcolarne il CRC
+// la fine e' segnalata dall'errore BLKSTOR_ERR_NOTFOUND
+
+SWORD blkstor_index_enum(const BLKSTOR_INDEX  * index,ULONG * pos,void  * * blk_addr)
+{
+    BLKSTOR_INDEX_ENTRY  * lent;
+    void  * stor_addr;
+    ULONG stor_size;
+    SWORD retval;
+
+        // se pieno pos e' l'offset da cui proseguire la scansione
+    if(index->bOverflow)
+    {
+        if(*pos>=index->ulStorSize)
+        {
+            *blk_addr=NULL;
+            return BLKSTOR_ERR_NOTFOUND;
+        }
+
+        stor_addr=&index->pubStor[*pos];
+        stor_size=index->ulStorSize-*pos;
+        retval=blkstor_enumvalid(&stor_addr,&stor_size,blk_addr);
+        *pos=index->ulStorSize-stor_size;
+        return retval;
+    }
+
+    if(*pos>=index->uwCount)
+    {
+        *blk_addr=NULL;
+        return BLKSTOR_ERR_NOTFOUND;
+    }
+
+    lent=&index->psEntry[(*pos)++];
+    *blk_addr=&index->pubStor[lent->ulOffset];
+
+    return lent->swCode;
+}
+
+//****************************************************************************
+// Legge un blocco ritornato da blkstor_index_enum (gia' validato)
+// se dest_addr!=NULL viene copiato nella zona specificata
+// se data_addr!=NULL viene ritornato il puntatore ai dati del blocco
+// ritorna la dimensione del blocco (se >0) oppure errore (se <0)
+
+SWORD blkstor_index_read(void  * blk_addr,void  * dest_addr,SWORD dest_size,void  * * data_addr)
+{
+    if(blk_addr==NULL)
+        return BLKSTOR_ERR_NOTFOUND;
+
+    return getvaliddata((UWORD  *)blk_addr,dest_addr,dest_size,data_addr);
+}
@@ -37,6 +37,9 @@
 	// blocco oggetto della ricerca non trovato nell'area specificata
 #define	BLKSTOR_ERR_NOTFOUND		-4
 
+	// indice pieno, le ricerche tornano alla scansione dell'area
+#define	BLKSTOR_ERR_INDEXFULL		-5
+
 //****************************************************************************
 // Struttura dati: vengono usate solo word per non avere padding e allineamenti
 // vari che aumentano dimensione struttura e riducono portabilita'
@@ -50,6 +53,30 @@ typedef struct
 	UWORD uwCrc;                // CRC del blocco compreso header
 } BLKSTOR_HEADER;
 
+//****************************************************************************
+// Indice dei blocchi validi di un'area: costruito con una sola scansione
+// (CRC di ogni blocco calcolato una volta), poi ricerca per codice O(log n)
+// e enumerazione in ordine di memorizzazione senza ricalcolo del CRC.
+// A parita' di codice la ricerca ritorna il blocco memorizzato per ultimo,
+// come rimarrebbe ripristinando i blocchi in ordine di enumerazione
+
+typedef struct
+{
+    ULONG ulOffset;             // offset dell'header dall'inizio area
+    SWORD swCode;               // identificativo del blocco
+    UWORD uwSorted;             // n-esimo elemento in ordine di codice
+} BLKSTOR_INDEX_ENTRY;
+
+typedef struct
+{
+    UBYTE  * pubStor;           // area indicizzata
+    ULONG ulStorSize;
+    BLKSTOR_INDEX_ENTRY  * psEntry;
+    UWORD uwMaxEntries;
+    UWORD uwCount;
+    BOOL bOverflow;             // indice pieno: ricerche su scansione area
+} BLKSTOR_INDEX;
+
 //****************************************************************************
 // Funzioni
 
@@ -62,4 +89,11 @@ SWORD  blkstor_tail_begin(BLKSTOR_HEADER  * head_addr,SWORD blkcode);
 SWORD  blkstor_tail_addata(BLKSTOR_HEADER  * head_addr,volatile void  * data_addr,UWORD data_size);
 SWORD  blkstor_tail_end(BLKSTOR_HEADER  * head_addr);
 
+SWORD  blkstor_index_build(BLKSTOR_INDEX  * index,void  * stor_addr,ULONG stor_size,BLKSTOR_INDEX_ENTRY  * entries,UWORD max_entries);
+SWORD  blkstor_index_add(BLKSTOR_INDEX  * index,void  * blk_addr);
+SWORD  blkstor_index_getdata(const BLKSTOR_INDEX  * index,SWORD blkcode,void  * dest_addr,SWORD dest_size);
+SWORD  blkstor_index_getaddr(const BLKSTOR_INDEX  * index,SWORD blkcode,void  * * data_addr);
+SWORD  blkstor_index_enum(const BLKSTOR_INDEX  * index,ULONG * pos,void  * * blk_addr);
+SWORD  blkstor_index_read(void  * blk_addr,void  * dest_addr,SWORD dest_size,void  * * data_addr);
+
 #endif
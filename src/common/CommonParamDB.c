@@ -17,6 +17,7 @@
 #include <string.h>
 #include "common\CommonParamDB.h"
 #include "common\CommonUtility.h"
+#include "common\Snapshot.h"
 #include "system\SystemAlarms.h"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -266,6 +267,9 @@ UWORD ComParDBEntryRead(COMMONPARAMDB_ENTRY  * psEntry, UWORD uwElement, void *
     UWORD uwRetVal;
     HPUBYTE hpubData;
     UWORD uwOffset;
+    UWORD uwRetry;
+    ULONG ulSeq;
+    ULONG ulIrq;
 
         // if hook, parameter must be externally processed via hook function
     if(psEntry->ubFlags&COMMONPARAMDB_FLAG_HOOK)
@@ -295,21 +299,46 @@ UWORD ComParDBEntryRead(COMMONPARAMDB_ENTRY  * psEntry, UWORD uwElement, void *
             // proceed to um conversion if required
         if(psEntry->ubFlags&COMMONPARAMDB_FLAG_UMCONV)
         {
-            uwRetVal=(*psEntry->uf.fpfUmConv)(COMMONPARAMDB_UCFLAG_READ, pvBufferDataOut, (void  *)hpubData);
+                // conversion may combine several realtime outputs, it is
+                // repeated if a realtime tick ran meanwhile (read conversions
+                // only write the local buffer); if ticks keep running into it
+                // the last attempt is done with interrupts masked
+            if(psEntry->ubFlags&COMMONPARAMDB_FLAG_RTDATA)
+            {
+                uwRetry=0;
+                do
+                {
+                    ulSeq=Snapshot_RTReadBegin();
+                    uwRetVal=(*psEntry->uf.fpfUmConv)(COMMONPARAMDB_UCFLAG_READ, ubLocBuf, (void  *)hpubData);
+                }
+                while(Snapshot_RTReadRetry(ulSeq, &uwRetry));
+
+                if(uwRetry>=ATOMIC_SEQLOCK_RETRIES)
+                {
+                    ATOMIC_IRQ_SAVE(ulIrq);
+                    uwRetVal=(*psEntry->uf.fpfUmConv)(COMMONPARAMDB_UCFLAG_READ, ubLocBuf, (void  *)hpubData);
+                    ATOMIC_IRQ_RESTORE(ulIrq);
+                }
+            }
+            else
+                uwRetVal=(*psEntry->uf.fpfUmConv)(COMMONPARAMDB_UCFLAG_READ, ubLocBuf, (void  *)hpubData);
+
             if(uwRetVal!=COMMONPARAMDB_CH_OK)
                 return uwRetVal;
         }
         else
         {
-                // get data atomically
             if(psEntry->ubType&COMMONPARAMDB_TYPE_POINTER_MASK)
-                atomic_read(ubLocBuf, &(*(UBYTE  *  *)hpubData)[uwOffset], uwSize);
-            else
-                atomic_read(ubLocBuf, hpubData, uwSize);
+                hpubData=&(*(UBYTE  *  *)hpubData)[uwOffset];
 
-            memcpy(pvBufferDataOut, ubLocBuf, uwSize);
+                // realtime data coherent with the tick, without masking it,
+                // unless ticks keep running into the copy; other data atomically
+            if(!(psEntry->ubFlags&COMMONPARAMDB_FLAG_RTDATA) || !Snapshot_RTRead(ubLocBuf, hpubData, uwSize))
+                atomic_read(ubLocBuf, hpubData, uwSize);
         }
 
+        memcpy(pvBufferDataOut, ubLocBuf, uwSize);
+
             // fix data out size
         *puwBufferSize=uwSize;
     }
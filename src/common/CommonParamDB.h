@@ -73,6 +73,9 @@
 #define COMMONPARAMDB_FLAG_VALIDATE         0x10
 #define COMMONPARAMDB_FLAG_RESETREQ         0x20
 #define COMMONPARAMDB_FLAG_WRLOCKREQ        0x40
+    // live data published by the realtime tick, read coherent with the tick
+    // without masking interrupts; other data is read atomically
+#define COMMONPARAMDB_FLAG_RTDATA           0x80
 
 //***************************************************************************
 // Hook callback operative flags
@@ -144,6 +147,8 @@ typedef struct _commonparamdb_entry
         // - near destination data pointer (if writing to internal write must be atomically)
         // - near source data pointer (if reading from internal read must be atomically)
         // return FALSE in case of successfull transaction
+        // read conversion writes the destination only, as it is repeated on
+        // realtime data changed meanwhile
         // validate callback pointer, parameters are (order of appearance):
         // - source data pointer
         // return FALSE in case of successfull transaction
@@ -0,0 +1,166 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : Crc.c                                                      */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Table driven CRC-8, CRC-16/ARC, Modbus CRC-16 and CRC-32   */
+/*               (slice-by-4/8) with streaming contexts                     */
+/*                                                                          */
+/****************************************************************************/
+#pragma GCC optimize (2)
+
+#include "common\Crc.h"
+
+//***************************************************************************
+// Slice tables: slice k gives the CRC of a byte followed by k zero bytes
+
+static const UBYTE ubCrc8Tab[4][256] =
+  {
+    #include "crc8_4x256.dat"
+  } ;
+
+static const UWORD uwCrc16Tab[8][256] =
+  {
+    #include "crc16_8x256.dat"
+  } ;
+
+static const ULONG ulCrc32Tab[8][256] =
+  {
+    #include "crc32_8x256.dat"
+  } ;
+
+//***************************************************************************
+// CRC-8, msb first, 4 bytes per step
+
+UBYTE Crc8_Update(UBYTE ubCrc, const UBYTE * pubData, ULONG ulLength)
+{
+    while(ulLength>=4)
+    {
+        ubCrc=ubCrc8Tab[3][ubCrc^pubData[0]]^
+              ubCrc8Tab[2][pubData[1]]^
+              ubCrc8Tab[1][pubData[2]]^
+              ubCrc8Tab[0][pubData[3]];
+        pubData+=4;
+        ulLength-=4;
+    }
+
+    while(ulLength--)
+        ubCrc=ubCrc8Tab[0][ubCrc^*pubData++];
+
+    return ubCrc;
+}
+
+//***************************************************************************
+// CRC-16/ARC, reflected, 8 bytes per step
+
+UWORD Crc16Arc_Update(UWORD uwCrc, const UBYTE * pubData, ULONG ulLength)
+{
+    ULONG ulCrc=uwCrc;
+
+    while(ulLength>=8)
+    {
+        ulCrc^=(ULONG)pubData[0]|((ULONG)pubData[1]<<8);
+        ulCrc=uwCrc16Tab[7][ulCrc&0xFF]^
+              uwCrc16Tab[6][ulCrc>>8]^
+              uwCrc16Tab[5][pubData[2]]^
+              uwCrc16Tab[4][pubData[3]]^
+              uwCrc16Tab[3][pubData[4]]^
+              uwCrc16Tab[2][pubData[5]]^
+              uwCrc16Tab[1][pubData[6]]^
+              uwCrc16Tab[0][pubData[7]];
+        pubData+=8;
+        ulLength-=8;
+    }
+
+    while(ulLength--)
+        ulCrc=(ulCrc>>8)^uwCrc16Tab[0][(ulCrc^*pubData++)&0xFF];
+
+    return (UWORD)ulCrc;
+}
+
+//***************************************************************************
+// Modbus CRC-16: CRC-16/ARC engine, seed 0xFFFF; the register low byte is
+// the first CRC byte on the wire
+
+UWORD Crc16Modbus_Update(UWORD uwCrc, const UBYTE * pubData, ULONG ulLength)
+{
+    return Crc16Arc_Update(uwCrc, pubData, ulLength);
+}
+
+//***************************************************************************
+// CRC-32, reflected, 8 bytes per step
+
+ULONG Crc32_Update(ULONG ulCrc, const UBYTE * pubData, ULONG ulLength)
+{
+    ULONG ulHi;
+
+    while(ulLength>=8)
+    {
+        ulCrc^=(ULONG)pubData[0]|((ULONG)pubData[1]<<8)|((ULONG)pubData[2]<<16)|((ULONG)pubData[3]<<24);
+        ulHi=(ULONG)pubData[4]|((ULONG)pubData[5]<<8)|((ULONG)pubData[6]<<16)|((ULONG)pubData[7]<<24);
+        ulCrc=ulCrc32Tab[7][ulCrc&0xFF]^
+              ulCrc32Tab[6][(ulCrc>>8)&0xFF]^
+              ulCrc32Tab[5][(ulCrc>>16)&0xFF]^
+              ulCrc32Tab[4][ulCrc>>24]^
+              ulCrc32Tab[3][ulHi&0xFF]^
+              ulCrc32Tab[2][(ulHi>>8)&0xFF]^
+              ulCrc32Tab[1][(ulHi>>16)&0xFF]^
+              ulCrc32Tab[0][ulHi>>24];
+        pubData+=8;
+        ulLength-=8;
+    }
+
+    while(ulLength--)
+        ulCrc=(ulCrc>>8)^ulCrc32Tab[0][(ulCrc^*pubData++)&0xFF];
+
+    return ulCrc;
+}
+
+//***************************************************************************
+// Streaming context
+
+void Crc_Init(CRC_CTX * psCtx, UWORD uwType)
+{
+    psCtx->uwType=uwType;
+
+    switch(uwType)
+    {
+        case CRC_TYPE_CRC8:         psCtx->ulCrc=CRC8_INIT;         break;
+        case CRC_TYPE_CRC16MODBUS:  psCtx->ulCrc=CRC16MODBUS_INIT;  break;
+        case CRC_TYPE_CRC32:        psCtx->ulCrc=CRC32_INIT;        break;
+        default:                    psCtx->ulCrc=CRC16ARC_INIT;     break;
+    }
+}
+
+void Crc_Update(CRC_CTX * psCtx, const void * pvData, ULONG ulLength)
+{
+    switch(psCtx->uwType)
+    {
+        case CRC_TYPE_CRC8:
+            psCtx->ulCrc=Crc8_Update((UBYTE)psCtx->ulCrc, (const UBYTE *)pvData, ulLength);
+            break;
+
+        case CRC_TYPE_CRC16MODBUS:
+            psCtx->ulCrc=Crc16Modbus_Update((UWORD)psCtx->ulCrc, (const UBYTE *)pvData, ulLength);
+            break;
+
+        case CRC_TYPE_CRC32:
+            psCtx->ulCrc=Crc32_Update(psCtx->ulCrc, (const UBYTE *)pvData, ulLength);
+            break;
+
+        default:
+            psCtx->ulCrc=Crc16Arc_Update((UWORD)psCtx->ulCrc, (const UBYTE *)pvData, ulLength);
+            break;
+    }
+}
+
+ULONG Crc_Final(const CRC_CTX * psCtx)
+{
+    if(psCtx->uwType==CRC_TYPE_CRC32)
+        return CRC32_FINAL(psCtx->ulCrc);
+
+    return psCtx->ulCrc;
+}
@@ -0,0 +1,62 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : Crc.h                                                      */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Table driven CRC-8, CRC-16/ARC, Modbus CRC-16 and CRC-32   */
+/*               (slice-by-4/8) with streaming contexts                     */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _CRC_H
+#define _CRC_H
+
+#include "common\CommonDefines.h"
+
+//***************************************************************************
+// Algorithms
+//   CRC-8       poly 0x07 msb first (SMBus/ROHC register), init 0xFF for
+//               EtherCAT ESC info and STGAP4S frames
+//   CRC-16/ARC  poly 0x8005 reflected, legacy crc16() of parameter and
+//               block storage
+//   CRC-16 Modbus, same engine with 0xFFFF seed (register lo byte first on
+//               the wire)
+//   CRC-32      IEEE 802.3, reflected, init and final xor 0xFFFFFFFF
+
+#define CRC_TYPE_CRC8           0
+#define CRC_TYPE_CRC16ARC       1
+#define CRC_TYPE_CRC16MODBUS    2
+#define CRC_TYPE_CRC32          3
+
+#define CRC8_INIT               0xFF
+#define CRC16ARC_INIT           0x0000
+#define CRC16MODBUS_INIT        0xFFFF
+#define CRC32_INIT              0xFFFFFFFFUL
+
+//***************************************************************************
+// Raw register update, can be chained on consecutive buffers
+
+UBYTE Crc8_Update(UBYTE ubCrc, const UBYTE * pubData, ULONG ulLength);
+UWORD Crc16Arc_Update(UWORD uwCrc, const UBYTE * pubData, ULONG ulLength);
+UWORD Crc16Modbus_Update(UWORD uwCrc, const UBYTE * pubData, ULONG ulLength);
+ULONG Crc32_Update(ULONG ulCrc, const UBYTE * pubData, ULONG ulLength);
+
+#define CRC32_FINAL(crc)        (~(ULONG)(crc))
+
+//***************************************************************************
+// Streaming context
+
+typedef struct
+{
+    ULONG ulCrc;
+    UWORD uwType;
+} CRC_CTX;
+
+void  Crc_Init(CRC_CTX * psCtx, UWORD uwType);
+void  Crc_Update(CRC_CTX * psCtx, const void * pvData, ULONG ulLength);
+ULONG Crc_Final(const CRC_CTX * psCtx);
+
+#endif // _CRC_H
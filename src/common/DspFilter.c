@@ -0,0 +1,422 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : DspFilter.c                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Cascaded biquad and FIR filters (Q15, Q31, float) over     */
+/*               interleaved channels, second order section design          */
+/*                                                                          */
+/****************************************************************************/
+#pragma GCC optimize (2)
+
+#include <math.h>
+#include "common\CommonDefines.h"
+#include "common\Int64Functions.h"
+#include "common\DspFilter.h"
+
+//***************************************************************************
+// Scalar helpers
+
+static inline SWORD sat16(SLLNG sllVal)
+{
+    if(sllVal>32767)
+        return 32767;
+    if(sllVal<-32768)
+        return -32768;
+    return (SWORD)sllVal;
+}
+
+static inline SWORD quant16(DOUBL dbVal)
+{
+    dbVal+=0.5;
+    if(dbVal>=32767.0)
+        return 32767;
+    if(dbVal<=-32768.0)
+        return -32768;
+    return (SWORD)dbVal;
+}
+
+//***************************************************************************
+// Biquad, Q15 samples
+
+void DspFlt_BiquadQ15(const DSPFLT_BIQUAD_Q15 * psCoef, UWORD uwStages, DSPFLT_BIQUAD_Q15_STATE * psState, const SWORD * pswIn, SWORD * pswOut, UWORD uwChannels, UWORD uwSamples)
+{
+    UWORD uwSmp,uwStg,uwCh;
+
+    for(uwSmp=0;uwSmp<uwSamples;uwSmp++)
+    {
+        const SWORD * pswSrc=pswIn;
+        DSPFLT_BIQUAD_Q15_STATE * psSt=psState;
+
+        for(uwStg=0;uwStg<uwStages;uwStg++)
+        {
+            const DSPFLT_BIQUAD_Q15 * psC=&psCoef[uwStg];
+
+            for(uwCh=0;uwCh<uwChannels;uwCh++,psSt++)
+            {
+                SWORD swX=pswSrc[uwCh];
+                SLLNG sllAcc;
+                SWORD swY;
+
+                sllAcc=s64_mul_32_32(psC->swB0, swX);
+                sllAcc=s64_mac_32_32(sllAcc, psC->swB1, psSt->swX1);
+                sllAcc=s64_mac_32_32(sllAcc, psC->swB2, psSt->swX2);
+                sllAcc=s64_mac_32_32(sllAcc, psC->swA1, psSt->swY1);
+                sllAcc=s64_mac_32_32(sllAcc, psC->swA2, psSt->swY2);
+                swY=sat16(s64_shr(sllAcc, psC->ubShift));
+
+                psSt->swX2=psSt->swX1;
+                psSt->swX1=swX;
+                psSt->swY2=psSt->swY1;
+                psSt->swY1=swY;
+
+                pswOut[uwCh]=swY;
+            }
+
+                // next section runs on this section output
+            pswSrc=pswOut;
+        }
+
+            // no sections: plain copy
+        if(uwStages==0)
+            for(uwCh=0;uwCh<uwChannels;uwCh++)
+                pswOut[uwCh]=pswIn[uwCh];
+
+        pswIn+=uwChannels;
+        pswOut+=uwChannels;
+    }
+}
+
+//***************************************************************************
+// Biquad, Q31 samples
+
+void DspFlt_BiquadQ31(const DSPFLT_BIQUAD_Q31 * psCoef, UWORD uwStages, DSPFLT_BIQUAD_Q31_STATE * psState, const SLONG * pslIn, SLONG * pslOut, UWORD uwChannels, UWORD uwSamples)
+{
+    UWORD uwSmp,uwStg,uwCh;
+
+    for(uwSmp=0;uwSmp<uwSamples;uwSmp++)
+    {
+        const SLONG * pslSrc=pslIn;
+        DSPFLT_BIQUAD_Q31_STATE * psSt=psState;
+
+        for(uwStg=0;uwStg<uwStages;uwStg++)
+        {
+            const DSPFLT_BIQUAD_Q31 * psC=&psCoef[uwStg];
+
+            for(uwCh=0;uwCh<uwChannels;uwCh++,psSt++)
+            {
+                SLONG slX=pslSrc[uwCh];
+                SLLNG sllAcc;
+                SLONG slY;
+
+                sllAcc=s64_mul_32_32(psC->slB0, slX);
+                sllAcc=s64_mac_32_32(sllAcc, psC->slB1, psSt->slX1);
+                sllAcc=s64_mac_32_32(sllAcc, psC->slB2, psSt->slX2);
+                sllAcc=s64_mac_32_32(sllAcc, psC->slA1, psSt->slY1);
+                sllAcc=s64_mac_32_32(sllAcc, psC->slA2, psSt->slY2);
+                slY=s64_sat32(s64_shr(sllAcc, psC->ubShift));
+
+                psSt->slX2=psSt->slX1;
+                psSt->slX1=slX;
+                psSt->slY2=psSt->slY1;
+                psSt->slY1=slY;
+
+                pslOut[uwCh]=slY;
+            }
+
+            pslSrc=pslOut;
+        }
+
+        if(uwStages==0)
+            for(uwCh=0;uwCh<uwChannels;uwCh++)
+                pslOut[uwCh]=pslIn[uwCh];
+
+        pslIn+=uwChannels;
+        pslOut+=uwChannels;
+    }
+}
+
+//***************************************************************************
+// Biquad, float samples (direct form II transposed)
+
+void DspFlt_BiquadF(const DSPFLT_BIQUAD_F * psCoef, UWORD uwStages, DSPFLT_BIQUAD_F_STATE * psState, const FLOAT * pflIn, FLOAT * pflOut, UWORD uwChannels, UWORD uwSamples)
+{
+    UWORD uwSmp,uwStg,uwCh;
+
+    for(uwSmp=0;uwSmp<uwSamples;uwSmp++)
+    {
+        const FLOAT * pflSrc=pflIn;
+        DSPFLT_BIQUAD_F_STATE * psSt=psState;
+
+        for(uwStg=0;uwStg<uwStages;uwStg++)
+        {
+            const FLOAT flB0=psCoef[uwStg].flB0;
+            const FLOAT flB1=psCoef[uwStg].flB1;
+            const FLOAT flB2=psCoef[uwStg].flB2;
+            const FLOAT flA1=psCoef[uwStg].flA1;
+            const FLOAT flA2=psCoef[uwStg].flA2;
+
+            for(uwCh=0;uwCh<uwChannels;uwCh++,psSt++)
+            {
+                FLOAT flX=pflSrc[uwCh];
+                FLOAT flY=flB0*flX+psSt->flS1;
+
+                psSt->flS1=flB1*flX+flA1*flY+psSt->flS2;
+                psSt->flS2=flB2*flX+flA2*flY;
+
+                pflOut[uwCh]=flY;
+            }
+
+            pflSrc=pflOut;
+        }
+
+        if(uwStages==0)
+            for(uwCh=0;uwCh<uwChannels;uwCh++)
+                pflOut[uwCh]=pflIn[uwCh];
+
+        pflIn+=uwChannels;
+        pflOut+=uwChannels;
+    }
+}
+
+//***************************************************************************
+// FIR delay line setup
+
+void DspFlt_FirQ15Init(DSPFLT_FIR_Q15_STATE * psState, SWORD * pswDelay, UWORD uwTaps)
+{
+    UWORD uwCt;
+
+    for(uwCt=0;uwCt<DSPFLT_FIR_DELAYSIZE(uwTaps);uwCt++)
+        pswDelay[uwCt]=0;
+
+    psState->pswDelay=pswDelay;
+    psState->uwIndex=0;
+}
+
+void DspFlt_FirQ31Init(DSPFLT_FIR_Q31_STATE * psState, SLONG * pslDelay, UWORD uwTaps)
+{
+    UWORD uwCt;
+
+    for(uwCt=0;uwCt<DSPFLT_FIR_DELAYSIZE(uwTaps);uwCt++)
+        pslDelay[uwCt]=0;
+
+    psState->pslDelay=pslDelay;
+    psState->uwIndex=0;
+}
+
+void DspFlt_FirFInit(DSPFLT_FIR_F_STATE * psState, FLOAT * pflDelay, UWORD uwTaps)
+{
+    UWORD uwCt;
+
+    for(uwCt=0;uwCt<DSPFLT_FIR_DELAYSIZE(uwTaps);uwCt++)
+        pflDelay[uwCt]=0.0f;
+
+    psState->pflDelay=pflDelay;
+    psState->uwIndex=0;
+}
+
+//***************************************************************************
+// FIR; the newest sample is written at uwIndex and uwIndex+uwTaps, walking
+// backwards, so x[n-k] is always pDelay[uwIndex+k]
+
+void DspFlt_FirQ15(const DSPFLT_FIR_Q15 * psFir, DSPFLT_FIR_Q15_STATE * psState, const SWORD * pswIn, SWORD * pswOut, UWORD uwChannels, UWORD uwSamples)
+{
+    const SWORD * pswTaps=psFir->pswTaps;
+    UWORD uwTaps=psFir->uwTaps;
+    UWORD uwSmp,uwCh,uwCt;
+
+    if(uwTaps==0)
+        return;
+
+    for(uwSmp=0;uwSmp<uwSamples;uwSmp++)
+    {
+        for(uwCh=0;uwCh<uwChannels;uwCh++)
+        {
+            DSPFLT_FIR_Q15_STATE * psSt=&psState[uwCh];
+            const SWORD * pswX;
+            SLLNG sllAcc=0;
+
+            psSt->uwIndex=(psSt->uwIndex==0 ? uwTaps : psSt->uwIndex)-1;
+            psSt->pswDelay[psSt->uwIndex]=psSt->pswDelay[psSt->uwIndex+uwTaps]=pswIn[uwCh];
+
+            pswX=&psSt->pswDelay[psSt->uwIndex];
+            for(uwCt=0;uwCt<uwTaps;uwCt++)
+                sllAcc=s64_mac_32_32(sllAcc, pswTaps[uwCt], pswX[uwCt]);
+
+            pswOut[uwCh]=sat16(s64_shr(sllAcc, psFir->ubShift));
+        }
+
+        pswIn+=uwChannels;
+        pswOut+=uwChannels;
+    }
+}
+
+void DspFlt_FirQ31(const DSPFLT_FIR_Q31 * psFir, DSPFLT_FIR_Q31_STATE * psState, const SLONG * pslIn, SLONG * pslOut, UWORD uwChannels, UWORD uwSamples)
+{
+    const SLONG * pslTaps=psFir->pslTaps;
+    UWORD uwTaps=psFir->uwTaps;
+    UWORD uwSmp,uwCh,uwCt;
+
+    if(uwTaps==0)
+        return;
+
+    for(uwSmp=0;uwSmp<uwSamples;uwSmp++)
+    {
+        for(uwCh=0;uwCh<uwChannels;uwCh++)
+        {
+            DSPFLT_FIR_Q31_STATE * psSt=&psState[uwCh];
+            const SLONG * pslX;
+            SLLNG sllAcc=0;
+
+            psSt->uwIndex=(psSt->uwIndex==0 ? uwTaps : psSt->uwIndex)-1;
+            psSt->pslDelay[psSt->uwIndex]=psSt->pslDelay[psSt->uwIndex+uwTaps]=pslIn[uwCh];
+
+            pslX=&psSt->pslDelay[psSt->uwIndex];
+            for(uwCt=0;uwCt<uwTaps;uwCt++)
+                sllAcc=s64_mac_32_32(sllAcc, pslTaps[uwCt], pslX[uwCt]);
+
+            pslOut[uwCh]=s64_sat32(s64_shr(sllAcc, psFir->ubShift));
+        }
+
+        pslIn+=uwChannels;
+        pslOut+=uwChannels;
+    }
+}
+
+void DspFlt_FirF(const DSPFLT_FIR_F * psFir, DSPFLT_FIR_F_STATE * psState, const FLOAT * pflIn, FLOAT * pflOut, UWORD uwChannels, UWORD uwSamples)
+{
+    const FLOAT * pflTaps=psFir->pflTaps;
+    UWORD uwTaps=psFir->uwTaps;
+    UWORD uwSmp,uwCh,uwCt;
+
+    if(uwTaps==0)
+        return;
+
+    for(uwSmp=0;uwSmp<uwSamples;uwSmp++)
+    {
+        for(uwCh=0;uwCh<uwChannels;uwCh++)
+        {
+            DSPFLT_FIR_F_STATE * psSt=&psState[uwCh];
+            const FLOAT * pflX;
+            FLOAT flAcc=0.0f;
+
+            psSt->uwIndex=(psSt->uwIndex==0 ? uwTaps : psSt->uwIndex)-1;
+            psSt->pflDelay[psSt->uwIndex]=psSt->pflDelay[psSt->uwIndex+uwTaps]=pflIn[uwCh];
+
+            pflX=&psSt->pflDelay[psSt->uwIndex];
+            for(uwCt=0;uwCt<uwTaps;uwCt++)
+                flAcc+=pflTaps[uwCt]*pflX[uwCt];
+
+            pflOut[uwCh]=flAcc;
+        }
+
+        pflIn+=uwChannels;
+        pflOut+=uwChannels;
+    }
+}
+
+//***************************************************************************
+// Second order section design; expressions kept as the former current loop
+// CalcFilterConstants and results held in double until quantization, so the
+// Q15 constants are bit identical to the legacy ones
+
+static BOOL designsos(UBYTE ubType, FLOAT flFreqMain, FLOAT flDampMain, FLOAT flFreqSec, FLOAT flDampSec, DOUBL dbTs, FLOAT flGain, DOUBL * pdbCoef)
+{
+    FLOAT flDv,flPw;
+
+    switch(ubType)
+    {
+        case DSPFLT_SOS_NONE:
+            pdbCoef[0]=flGain;
+            pdbCoef[1]=0.0;
+            pdbCoef[2]=0.0;
+            pdbCoef[3]=0.0;
+            pdbCoef[4]=0.0;
+            break;
+
+        case DSPFLT_SOS_NOTCH:
+            flPw=pow(dbTs*flFreqMain,2.0);
+            flDv=4+2*flFreqMain*flDampMain*dbTs+flPw;
+            flDv=flGain/flDv;
+
+            pdbCoef[0]=flDv*(4+flPw);
+            pdbCoef[1]=flDv*(2*flPw-8);
+            pdbCoef[2]=flDv*(4+flPw);
+            pdbCoef[3]=flDv*-(2*flPw-8);
+            pdbCoef[4]=flDv*-(4-2*dbTs*flFreqMain*flDampMain+flPw);
+            break;
+
+        case DSPFLT_SOS_BIQUAD:
+            flPw=pow(dbTs*flFreqMain,2.0);
+            flDv=4*flFreqMain*flFreqMain+4*flDampSec*flFreqMain*flFreqMain*flFreqSec*dbTs+pow(dbTs*flFreqMain*flFreqSec,2.0);
+            flDv=flGain/flDv;
+
+            pdbCoef[0]=flDv*flFreqSec*flFreqSec*(4+4*flDampMain*flFreqMain*dbTs+flPw);
+            pdbCoef[1]=flDv*flFreqSec*flFreqSec*(2*flPw-8);
+            pdbCoef[2]=flDv*flFreqSec*flFreqSec*(4-4*flDampMain*flFreqMain*dbTs+flPw);
+            pdbCoef[3]=flDv*-(flFreqMain*flFreqMain*(2*pow(dbTs*flFreqSec,2.0)-8));
+            pdbCoef[4]=flDv*-(4*flFreqMain*flFreqMain-4*flDampSec*flFreqMain*flFreqMain*flFreqSec*dbTs+pow(dbTs*flFreqMain*flFreqSec,2.0));
+            break;
+
+        case DSPFLT_SOS_LOWPASS:
+            flPw=pow(dbTs*flFreqMain,2.0);
+            flDv=4+4*flFreqMain*flDampMain*dbTs+flPw;
+            flDv=flGain/flDv;
+
+            pdbCoef[0]=flDv*flPw;
+            pdbCoef[1]=flDv*2*flPw;
+            pdbCoef[2]=flDv*flPw;
+            pdbCoef[3]=flDv*-(2*flPw-8);
+            pdbCoef[4]=flDv*-(4-4*flFreqMain*flDampMain*dbTs+flPw);
+            break;
+
+        default:
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+BOOL DspFlt_DesignSos(UBYTE ubType, FLOAT flFreqMain, FLOAT flDampMain, FLOAT flFreqSec, FLOAT flDampSec, DOUBL dbTs, DSPFLT_BIQUAD_F * psCoef)
+{
+    DOUBL dbCoef[5];
+
+    if(!designsos(ubType, flFreqMain, flDampMain, flFreqSec, flDampSec, dbTs, 1.0f, dbCoef))
+        return FALSE;
+
+    psCoef->flB0=(FLOAT)dbCoef[0];
+    psCoef->flB1=(FLOAT)dbCoef[1];
+    psCoef->flB2=(FLOAT)dbCoef[2];
+    psCoef->flA1=(FLOAT)dbCoef[3];
+    psCoef->flA2=(FLOAT)dbCoef[4];
+    return TRUE;
+}
+
+//***************************************************************************
+// Quantized design: adds 0.5 and truncates, as the legacy setup did
+
+BOOL DspFlt_DesignSosQ15(UBYTE ubType, FLOAT flFreqMain, FLOAT flDampMain, FLOAT flFreqSec, FLOAT flDampSec, DOUBL dbTs, UBYTE ubShift, DSPFLT_BIQUAD_Q15 * psQCoef)
+{
+    DOUBL dbCoef[5];
+
+    if(!designsos(ubType, flFreqMain, flDampMain, flFreqSec, flDampSec, dbTs, (FLOAT)(1UL<<ubShift), dbCoef))
+        return FALSE;
+
+    psQCoef->swB0=quant16(dbCoef[0]);
+    psQCoef->swB1=quant16(dbCoef[1]);
+    psQCoef->swB2=quant16(dbCoef[2]);
+    psQCoef->swA1=quant16(dbCoef[3]);
+    psQCoef->swA2=quant16(dbCoef[4]);
+    psQCoef->ubShift=ubShift;
+    return TRUE;
+}
+
+void DspFlt_TrimDcQ15(DSPFLT_BIQUAD_Q15 * psQCoef)
+{
+    SWORD swSum=psQCoef->swB0+psQCoef->swB1+psQCoef->swB2+psQCoef->swA1+psQCoef->swA2;
+
+    psQCoef->swB1+=(SWORD)((1<<psQCoef->ubShift)-swSum);
+}
@@ -0,0 +1,167 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : DspFilter.h                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Cascaded biquad and FIR filters (Q15, Q31, float) over     */
+/*               interleaved channels, second order section design          */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _DSPFILTER_H
+#define _DSPFILTER_H
+
+#include "common\CommonDefines.h"
+
+//***************************************************************************
+// Data layout
+//   a biquad filter is a cascade of uwStages sections, the state holds one
+//   entry per section and channel at [stage*uwChannels+channel]; samples are
+//   interleaved by channel at [sample*uwChannels+channel]. The same call can
+//   run one sample of several channels (realtime tasks) or a block of a
+//   single channel. In place processing (input == output) is allowed
+//
+// Biquad section, direct form I with the feedback sign folded in
+//   y = b0*x + b1*x1 + b2*x2 + a1*y1 + a2*y2
+// i.e. a1 = -den1/den0, a2 = -den2/den0 (same order and sign as the Iq
+// filter constants of the current loop)
+//
+// Fixed point sections have coefficients in Q(ubShift); the 64bit sum is
+// shifted right by ubShift (floor) and saturated to the output width
+
+typedef struct
+{
+    SWORD swB0;
+    SWORD swB1;
+    SWORD swB2;
+    SWORD swA1;
+    SWORD swA2;
+    UBYTE ubShift;
+} DSPFLT_BIQUAD_Q15;
+
+typedef struct
+{
+    SWORD swX1;
+    SWORD swX2;
+    SWORD swY1;
+    SWORD swY2;
+} DSPFLT_BIQUAD_Q15_STATE;
+
+typedef struct
+{
+    SLONG slB0;
+    SLONG slB1;
+    SLONG slB2;
+    SLONG slA1;
+    SLONG slA2;
+    UBYTE ubShift;
+} DSPFLT_BIQUAD_Q31;
+
+typedef struct
+{
+    SLONG slX1;
+    SLONG slX2;
+    SLONG slY1;
+    SLONG slY2;
+} DSPFLT_BIQUAD_Q31_STATE;
+
+typedef struct
+{
+    FLOAT flB0;
+    FLOAT flB1;
+    FLOAT flB2;
+    FLOAT flA1;
+    FLOAT flA2;
+} DSPFLT_BIQUAD_F;
+
+    // direct form II transposed
+typedef struct
+{
+    FLOAT flS1;
+    FLOAT flS2;
+} DSPFLT_BIQUAD_F_STATE;
+
+void DspFlt_BiquadQ15(const DSPFLT_BIQUAD_Q15 * psCoef, UWORD uwStages, DSPFLT_BIQUAD_Q15_STATE * psState, const SWORD * pswIn, SWORD * pswOut, UWORD uwChannels, UWORD uwSamples);
+void DspFlt_BiquadQ31(const DSPFLT_BIQUAD_Q31 * psCoef, UWORD uwStages, DSPFLT_BIQUAD_Q31_STATE * psState, const SLONG * pslIn, SLONG * pslOut, UWORD uwChannels, UWORD uwSamples);
+void DspFlt_BiquadF(const DSPFLT_BIQUAD_F * psCoef, UWORD uwStages, DSPFLT_BIQUAD_F_STATE * psState, const FLOAT * pflIn, FLOAT * pflOut, UWORD uwChannels, UWORD uwSamples);
+
+//***************************************************************************
+// FIR
+//   y = sum(h[k]*x[n-k]), k = 0..uwTaps-1
+// every channel owns a delay line of DSPFLT_FIR_DELAYSIZE(uwTaps) samples
+// (each sample is stored twice so the dot product runs on contiguous
+// memory), to be attached with DspFlt_FirXxxInit. Fixed point taps are in
+// Q(ubShift), the sum is 64bit
+
+#define DSPFLT_FIR_DELAYSIZE(taps)  (2*(taps))
+
+typedef struct
+{
+    const SWORD * pswTaps;
+    UWORD uwTaps;
+    UBYTE ubShift;
+} DSPFLT_FIR_Q15;
+
+typedef struct
+{
+    SWORD * pswDelay;
+    UWORD uwIndex;
+} DSPFLT_FIR_Q15_STATE;
+
+typedef struct
+{
+    const SLONG * pslTaps;
+    UWORD uwTaps;
+    UBYTE ubShift;
+} DSPFLT_FIR_Q31;
+
+typedef struct
+{
+    SLONG * pslDelay;
+    UWORD uwIndex;
+} DSPFLT_FIR_Q31_STATE;
+
+typedef struct
+{
+    const FLOAT * pflTaps;
+    UWORD uwTaps;
+} DSPFLT_FIR_F;
+
+typedef struct
+{
+    FLOAT * pflDelay;
+    UWORD uwIndex;
+} DSPFLT_FIR_F_STATE;
+
+void DspFlt_FirQ15Init(DSPFLT_FIR_Q15_STATE * psState, SWORD * pswDelay, UWORD uwTaps);
+void DspFlt_FirQ31Init(DSPFLT_FIR_Q31_STATE * psState, SLONG * pslDelay, UWORD uwTaps);
+void DspFlt_FirFInit(DSPFLT_FIR_F_STATE * psState, FLOAT * pflDelay, UWORD uwTaps);
+
+void DspFlt_FirQ15(const DSPFLT_FIR_Q15 * psFir, DSPFLT_FIR_Q15_STATE * psState, const SWORD * pswIn, SWORD * pswOut, UWORD uwChannels, UWORD uwSamples);
+void DspFlt_FirQ31(const DSPFLT_FIR_Q31 * psFir, DSPFLT_FIR_Q31_STATE * psState, const SLONG * pslIn, SLONG * pslOut, UWORD uwChannels, UWORD uwSamples);
+void DspFlt_FirF(const DSPFLT_FIR_F * psFir, DSPFLT_FIR_F_STATE * psState, const FLOAT * pflIn, FLOAT * pflOut, UWORD uwChannels, UWORD uwSamples);
+
+//***************************************************************************
+// Second order section design, bilinear transform at period dbTs without
+// prewarping; the type numbering is the one of MH_FILTER_xxx
+//   LOWPASS  w = flFreqMain [rad/s], damping flDampMain
+//   NOTCH    w = flFreqMain [rad/s], damping flDampMain (width)
+//   BIQUAD   zeros flFreqMain/flDampMain over poles flFreqSec/flDampSec
+// all types have unity DC gain. The Q15 design scales by 2^ubShift, adds
+// 0.5 and truncates (same constants as the legacy current loop setup);
+// TrimDc then moves the rounding residue into b1 so the DC gain stays
+// exactly one
+
+#define DSPFLT_SOS_NONE         0
+#define DSPFLT_SOS_LOWPASS      1
+#define DSPFLT_SOS_NOTCH        2
+#define DSPFLT_SOS_BIQUAD       3
+
+BOOL DspFlt_DesignSos(UBYTE ubType, FLOAT flFreqMain, FLOAT flDampMain, FLOAT flFreqSec, FLOAT flDampSec, DOUBL dbTs, DSPFLT_BIQUAD_F * psCoef);
+BOOL DspFlt_DesignSosQ15(UBYTE ubType, FLOAT flFreqMain, FLOAT flDampMain, FLOAT flFreqSec, FLOAT flDampSec, DOUBL dbTs, UBYTE ubShift, DSPFLT_BIQUAD_Q15 * psQCoef);
+void DspFlt_TrimDcQ15(DSPFLT_BIQUAD_Q15 * psQCoef);
+
+#endif // _DSPFILTER_H
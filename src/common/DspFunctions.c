@@ -403,51 +403,38 @@ SWORD _interpolation(SWORD  * hpswDat, SWORD swScale)
 // Interpolation: hpswDat[n]+(hpswDat[n+1]-hpswDat[n])*s
 // n:     uwLinSize  MSB bits
 // s: (16-uwLinSize) LSB bits
+// tables have (2^uwLinSize)+1 points per dimension over the SWORD range;
+// same arithmetic as the former C167 MAC code (saturated difference,
+// floor shift, saturated result). For new maps see LutInterp.h
 
 #ifdef _APP_XC
+static inline SWORD interpsat(SLONG slVal)
+{
+    if(slVal>32767)
+        return 32767;
+    if(slVal<-32768)
+        return -32768;
+    return (SWORD)slVal;
+}
+
+static inline UWORD interpidx(UWORD uwLinSize, SWORD swVal)
+{
+    return (UWORD)((UWORD)swVal+0x8000)>>(16-uwLinSize);
+}
+
+static inline SWORD interpseg(SWORD v0, SWORD v1, UWORD uwLinSize, SWORD swVal)
+{
+    UWORD uwFracBits=16-uwLinSize;
+    SLONG slDiff=interpsat((SLONG)v1-v0);
+    SLONG slFrac=(SWORD)((UWORD)swVal&(UWORD)((1UL<<uwFracBits)-1));
+
+    return interpsat((SLONG)v0+((slDiff*slFrac)>>uwFracBits));
+}
+
 SWORD _interp1d(SWORD  * hpswDat, UWORD uwLinSize, SWORD swVal)
 {
-#ifdef _INFINEON_
-   __asm
-   {
-       mov     r4,#16
-       sub     r4,r10
-
-       // compute array offset
-       mov     r3,r11
-       add     r3,#0x8000
-       shr     r3,r4
-       shl     r3,#1
-       add     r8,r3
-
-       // retrieve adjacent values
-       exts    r9,#2
-       mov     r1,[r8+]
-       mov     r2,[r8+]
-
-       // compute difference
-       mov     r6,#0
-       coload  r6,r2
-       cosub   r6,r1
-       costore r5,mas
-
-       // extract multiplier
-       mov     r3,#1
-       shl     r3,r4
-       sub     r3,#1
-       and     r3,r11
-       comul   r5,r3
-
-       // fractional shifting
-       coshl   r10
-
-       // add difference and retrieve result
-       coadd   r6,r1
-       costore r4,mas
-   }
-#else
-   return 0;
-#endif
+   hpswDat=&hpswDat[interpidx(uwLinSize,swVal)];
+   return interpseg(hpswDat[0],hpswDat[1],uwLinSize,swVal);
 }
 
 //***************************************************************************
@@ -455,35 +442,7 @@ SWORD _interp1d(SWORD  * hpswDat, UWORD uwLinSize, SWORD swVal)
 
 SWORD _interpv(SWORD v0, SWORD v1, UWORD uwLinSize, SWORD swVal)
 {
-#ifdef _INFINEON_
-   __asm
-   {
-       mov     r4,#16
-       sub     r4,r10
-
-       // compute difference
-       mov     r6,#0
-       coload  r6,r9
-       cosub   r6,r8
-       costore r5,mas
-
-       // extract multiplier
-       mov     r3,#1
-       shl     r3,r4
-       sub     r3,#1
-       and     r3,r11
-       comul   r5,r3
-
-       // fractional shifting
-       coshl   r10
-
-       // add difference and retrieve result
-       coadd   r6,r8
-       costore r4,mas
-   }
-#else
-   return 0;
-#endif
+   return interpseg(v0,v1,uwLinSize,swVal);
 }
 
 //***************************************************************************
@@ -491,14 +450,14 @@ SWORD _interpv(SWORD v0, SWORD v1, UWORD uwLinSize, SWORD swVal)
 
 SWORD _interp2d(SWORD  * hpswDat, UWORD uwLinSize, SWORD swVal0, SWORD swVal1)
 {
-   UWORD o=((UWORD)swVal1+0x8000)>>(16-uwLinSize);
    UWORD s=(1<<uwLinSize)+1;
+   UWORD i=interpidx(uwLinSize,swVal0);
    SWORD v0,v1;
 
-   hpswDat=&hpswDat[o*s];
-   v0=_interp1d( hpswDat,   uwLinSize,swVal0);
-   v1=_interp1d(&hpswDat[s],uwLinSize,swVal0);
-   return _interpv(v0,v1,uwLinSize,swVal1);
+   hpswDat=&hpswDat[interpidx(uwLinSize,swVal1)*s+i];
+   v0=interpseg(hpswDat[0],hpswDat[1],  uwLinSize,swVal0);
+   v1=interpseg(hpswDat[s],hpswDat[s+1],uwLinSize,swVal0);
+   return interpseg(v0,v1,uwLinSize,swVal1);
 }
 
 //***************************************************************************
@@ -506,15 +465,19 @@ SWORD _interp2d(SWORD  * hpswDat, UWORD uwLinSize, SWORD swVal0, SWORD swVal1)
 
 SWORD _interp3d(SWORD  * hpswDat, UWORD uwLinSize, SWORD swVal0, SWORD swVal1, SWORD swVal2)
 {
-   UWORD o=((UWORD)swVal2+0x8000)>>(16-uwLinSize);
    UWORD s=(1<<uwLinSize)+1;
-   SWORD v0,v1;
-
-   s=s*s;
-   hpswDat=&hpswDat[o*s];
-   v0=_interp2d( hpswDat,   uwLinSize,swVal0,swVal1);
-   v1=_interp2d(&hpswDat[s],uwLinSize,swVal0,swVal1);
-   return _interpv(v0,v1,uwLinSize,swVal2);
+   ULONG ss=(ULONG)s*s;
+   UWORD i=interpidx(uwLinSize,swVal0);
+   SWORD v00,v01,v10,v11;
+
+   hpswDat=&hpswDat[interpidx(uwLinSize,swVal2)*ss+interpidx(uwLinSize,swVal1)*s+i];
+   v00=interpseg(hpswDat[0],     hpswDat[1],       uwLinSize,swVal0);
+   v01=interpseg(hpswDat[s],     hpswDat[s+1],     uwLinSize,swVal0);
+   v10=interpseg(hpswDat[ss],    hpswDat[ss+1],    uwLinSize,swVal0);
+   v11=interpseg(hpswDat[ss+s],  hpswDat[ss+s+1],  uwLinSize,swVal0);
+   v00=interpseg(v00,v01,uwLinSize,swVal1);
+   v10=interpseg(v10,v11,uwLinSize,swVal1);
+   return interpseg(v00,v10,uwLinSize,swVal2);
 }
 #endif // _APP_XC
 
@@ -23,14 +23,125 @@
 #ifdef _AXX_SYSAPP
 #include "system\Os.h"
 
+//****************************************************************************
+// Defines
+
+    // pages kept in the write-back cache
+#define FLASHMGR_CACHE_PAGES        4
+
+//****************************************************************************
+// Data structures
+
+    // cached page, data are word aligned so the copies are word wide; the
+    // dirty range is programmed at write back, the page stays cached clean
+typedef struct
+{
+    HPUBYTE hpubPage;                                   // page address, NULL if free
+    ULONG   ulLastWrite;                                // sequence of last write
+    UWORD   uwDirtyBegin;                               // dirty range [begin, end)
+    UWORD   uwDirtyEnd;
+    ULONG   ulData[PROGRAMFLASH_PAGE_SIZE/sizeof(ULONG)];
+} FLASHMGR_CACHEPAGE;
+
 //****************************************************************************
 // Locals
 
 // OS_CREATEMUTEX(FlashMgrGlobalLock);
 static OS_MUTEX FlashMgrGlobalLock;
 
-static UBYTE ubBuffer[PROGRAMFLASH_PAGE_SIZE];
-static HPVOID hpvPageAddress;
+static FLASHMGR_CACHEPAGE sFlashMgrCache[FLASHMGR_CACHE_PAGES];
+static ULONG ulFlashMgrWriteSeq;
+
+    // page of the last written data
+static HPUBYTE hpubFlashMgrLastPage;
+
+//****************************************************************************
+// Cache handling
+
+    // drop all pages
+static void _invalidate(void)
+{
+    UWORD ct;
+
+    for(ct=0;ct<FLASHMGR_CACHE_PAGES;ct++)
+    {
+        sFlashMgrCache[ct].hpubPage=NULL;
+        sFlashMgrCache[ct].uwDirtyBegin=sFlashMgrCache[ct].uwDirtyEnd=0;
+    }
+
+    hpubFlashMgrLastPage=NULL;
+}
+
+    // program the dirty range of one page
+static SWORD _writeback(FLASHMGR_CACHEPAGE * psPage)
+{
+    SWORD retval=0;
+
+    if(psPage->uwDirtyEnd>psPage->uwDirtyBegin)
+        retval=ProgramFlashLoadWritePage((ULONG)&psPage->hpubPage[psPage->uwDirtyBegin],
+            &((UBYTE *)psPage->ulData)[psPage->uwDirtyBegin], psPage->uwDirtyEnd-psPage->uwDirtyBegin);
+
+    psPage->uwDirtyBegin=psPage->uwDirtyEnd=0;
+
+    return retval;
+}
+
+    // write back all dirty pages in order of their last write, so the page
+    // holding the last written data (e.g. a signature) is programmed last;
+    // on error the following pages are dropped, not programmed
+static SWORD _flush(void)
+{
+    FLASHMGR_CACHEPAGE * psPage, * psOldest;
+    UWORD ct;
+
+    for(;;)
+    {
+        psOldest=NULL;
+        for(ct=0,psPage=sFlashMgrCache;ct<FLASHMGR_CACHE_PAGES;ct++,psPage++)
+            if(psPage->uwDirtyEnd>psPage->uwDirtyBegin &&
+                (psOldest==NULL || (SLONG)(psPage->ulLastWrite-psOldest->ulLastWrite)<0))
+                psOldest=psPage;
+
+        if(psOldest==NULL)
+            return 0;
+
+        if(_writeback(psOldest))
+        {
+            _invalidate();
+            return 1;
+        }
+    }
+}
+
+    // get cached page, on miss use a free page or evict the least recently
+    // written one, that being the oldest keeps the write back order
+static FLASHMGR_CACHEPAGE * _getpage(HPUBYTE hpubPage)
+{
+    FLASHMGR_CACHEPAGE * psPage, * psVictim=NULL;
+    UWORD ct;
+
+    for(ct=0,psPage=sFlashMgrCache;ct<FLASHMGR_CACHE_PAGES;ct++,psPage++)
+    {
+        if(psPage->hpubPage==hpubPage)
+            return psPage;
+
+        if(psVictim==NULL || (psVictim->hpubPage!=NULL &&
+            (psPage->hpubPage==NULL || (SLONG)(psPage->ulLastWrite-psVictim->ulLastWrite)<0)))
+            psVictim=psPage;
+    }
+
+    if(psVictim->hpubPage!=NULL && _writeback(psVictim))
+    {
+        _invalidate();
+        return NULL;
+    }
+
+        // erased flash content for the bytes not written
+    psVictim->hpubPage=hpubPage;
+    memset(psVictim->ulData, 0xFF, sizeof(psVictim->ulData));
+
+    return psVictim;
+}
 
 //****************************************************************************
 // Initialize
@@ -56,89 +167,87 @@ UWORD FlashMgrBegin(UWORD uwTimeOut)
 
     assert(retval==OS_MUTEXWAIT_SIGNALED);
 
-        // reset page address
-    hpvPageAddress=NULL;
+        // empty cache
+    _invalidate();
 
     return FLASHMGR_R_OK;
 }
 
 //****************************************************************************
-// Write Data
+// Write Data, cached until page eviction or FlashMgrEnd(); rewrites of a
+// cached page are coalesced in a single program of its dirty range
 
 UWORD FlashMgrWriteData(HPVOID hpvDest, const HPVOID hpvSrc, ULONG ulSize)
 {
-    UWORD offset=(UWORD)(((ULONG)hpvDest)&(PROGRAMFLASH_PAGE_SIZE-1));
-    SWORD retval;
+    FLASHMGR_CACHEPAGE * psPage;
+    HPUBYTE hpubDest=(HPUBYTE)hpvDest;
     HPUBYTE hpubSrc=(HPUBYTE)hpvSrc;
+    UWORD offset, chunk;
 
-    hpvDest=(HPVOID)(((ULONG)hpvDest)&~(PROGRAMFLASH_PAGE_SIZE-1));
-
-        // loop until all data is written, each time write one page
+        // loop until all data is written, each time up to the end of one page
     while(ulSize)
     {
-            // if page change
-        if(hpvDest!=hpvPageAddress)
+        offset=(UWORD)(((ULONG)hpubDest)&(PROGRAMFLASH_PAGE_SIZE-1));
+        chunk=PROGRAMFLASH_PAGE_SIZE-offset;
+        if(chunk>ulSize)
+            chunk=(UWORD)ulSize;
+
+        psPage=_getpage(hpubDest-offset);
+        if(psPage==NULL)
+            return FLASHMGR_R_FLASHERROR;
+
+            // copy data to page
+        memcpy(&((UBYTE *)psPage->ulData)[offset], hpubSrc, chunk);
+
+            // extend dirty range
+        if(psPage->uwDirtyEnd==psPage->uwDirtyBegin)
         {
-                // if not null then flush actual data page
-            if(hpvPageAddress)
-            {
-                retval=ProgramFlashLoadWritePage((ULONG)hpvPageAddress, ubBuffer, PROGRAMFLASH_PAGE_SIZE);
-
-                    // if error
-                if(retval)
-                {
-                        // nulls actual page in order that releasing resource do not flush buffer
-                    hpvPageAddress=NULL;
-                    return FLASHMGR_R_FLASHERROR;
-                }
-            }
-
-                // new page
-            hpvPageAddress=hpvDest;
-
-                // zeroes buffer
-            memset(ubBuffer, 0xFF, PROGRAMFLASH_PAGE_SIZE);
-
-                // and restart offset
-            offset=0;
+            psPage->uwDirtyBegin=offset;
+            psPage->uwDirtyEnd=offset+chunk;
+        }
+        else
+        {
+            if(offset<psPage->uwDirtyBegin)
+                psPage->uwDirtyBegin=offset;
+            if(offset+chunk>psPage->uwDirtyEnd)
+                psPage->uwDirtyEnd=offset+chunk;
         }
 
-            // copy data to buffer
-        for(;offset<PROGRAMFLASH_PAGE_SIZE && ulSize; offset++, ulSize--)
-            ubBuffer[offset]=*hpubSrc++;
+        psPage->ulLastWrite=++ulFlashMgrWriteSeq;
+        hpubFlashMgrLastPage=psPage->hpubPage;
 
-            // apply offset to actual dest address
-        hpvDest=(HPVOID)(&((HPUBYTE)hpvDest)[offset]);
+        hpubDest+=chunk;
+        hpubSrc+=chunk;
+        ulSize-=chunk;
     }
     return FLASHMGR_R_OK;
 }
 
 //****************************************************************************
-// Flush buffer and unlock manager
+// Write back cache and unlock manager
 
 UWORD FlashMgrEnd(HPVOID * ppNextValidLocation)
 {
-    SWORD retval=0;
+    SWORD retval;
 
-        // if not null then flush actual data page
-    if(hpvPageAddress)
-        retval=ProgramFlashLoadWritePage((ULONG)hpvPageAddress, ubBuffer, PROGRAMFLASH_PAGE_SIZE);
+        // write back dirty pages
+    retval=_flush();
 
-        // set next valid location, if requested
+        // set next valid location (after page of the last written data), if requested
     if(ppNextValidLocation)
     {
-        if(hpvPageAddress)
-            *ppNextValidLocation=(HPVOID)(&((HPUBYTE)hpvPageAddress)[PROGRAMFLASH_PAGE_SIZE]);
+        if(hpubFlashMgrLastPage)
+            *ppNextValidLocation=(HPVOID)&hpubFlashMgrLastPage[PROGRAMFLASH_PAGE_SIZE];
         else
             *ppNextValidLocation=NULL;
     }
 
-    hpvPageAddress=NULL;
+    _invalidate();
 
         // unlock manager
     Os_MutexSignal(&FlashMgrGlobalLock);
 
-        // previous programming error
+        // programming error
     if(retval)
         return FLASHMGR_R_FLASHERROR;
 
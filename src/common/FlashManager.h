@@ -28,14 +28,14 @@
     // Initialize
 u32 FlashMgrInit(void);
 
-    // Write Data
+    // Write Data (cached in application, until page eviction or FlashMgrEnd)
 UWORD FlashMgrWriteData(HPVOID hpvDest, const HPVOID hpvSrc, ULONG ulSize);
 
 #ifdef _AXX_SYSAPP
     // lock manager
 UWORD FlashMgrBegin(UWORD uwTimeOut);
 
-    // Flush buffer and unlock manager
+    // Write back cached pages (in order of last write) and unlock manager
 UWORD FlashMgrEnd(HPVOID * ppNextValidLocation);
 #endif
 
@@ -0,0 +1,544 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : FlashQueue.c                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Queue of non blocking program flash write and erase        */
+/*               requests, served by a background tick                      */
+/*                                                                          */
+/****************************************************************************/
+
+/////////////////////////////////////////////////////////////////////////////
+// Compiler Option
+#pragma GCC optimize (2)
+
+#include <string.h>
+
+#include "common\FlashQueue.h"
+#include "common\Atomics.h"
+#include "core\Flash.h"
+#ifdef _AXX_SYSAPP
+#include "common\TaskScheduler.h"
+#include "system\Os.h"
+#include "system\SysAppConfig.h"
+#endif
+#if CFG_AMP
+#include "common\AmpMailbox.h"
+#include "core\Cpu1.h"
+#endif
+
+//***************************************************************************
+// Defines
+
+#define FLASHQ_OP_WRITE                 0
+#define FLASHQ_OP_ERASE                 1
+
+#define FLASHQ_BULK_ERASE_SIZE          (NUM_SECTORS*SECTOR_SIZE)
+
+//***************************************************************************
+// Data structures
+
+typedef struct
+{
+    ULONG           ulAddress;                  // next address to program or erase
+    ULONG           ulSize;                     // size left
+    const UBYTE *   hpubSrc;                    // next data to program
+    ULONG           ulEraseSize;                // erase unit
+    ULONG           ulTicket;                   // request ticket
+    SWORD           swResult;                   // request result
+    UBYTE           ubOp;                       // write or erase
+} FLASHQ_REQUEST;
+
+#if CFG_AMP
+    // request posted to the second core, operation is the message code
+typedef struct
+{
+    ULONG           ulAddress;
+    ULONG           ulSize;
+    const UBYTE *   hpubSrc;
+    ULONG           ulTicket;
+} FLASHQ_MSG;
+#endif
+
+#if CFG_AMP
+//***************************************************************************
+// Local prototypes
+
+static BOOL cpu1tick(ULONG);
+#endif
+
+//***************************************************************************
+// Locals
+
+    // Server side: the background tick, on the second core once started
+    // with CFG_AMP
+
+static FLASHQ_REQUEST sFlashQRequests[FLASHQ_MAX_REQUESTS];
+
+    // free running indexes, head written by queueing, tail by the tick
+static volatile UWORD uwFlashQHead;
+static volatile UWORD uwFlashQTail;
+
+    // device command of tail request in progress
+static volatile BOOL bFlashQCmdStarted;
+
+    // tail request partially served
+static volatile BOOL bFlashQReqStarted;
+
+    // tick in progress, from background task or from a waiting task
+static volatile BOOL bFlashQInTick;
+
+#if CFG_AMP
+    // last completed ticket notified to the first core
+static ULONG ulFlashQNotifiedTicket;
+#endif
+
+    // Shared: tickets are completed in order by the server, results of
+    // the last completed ones published before the ticket
+
+static volatile ULONG ulFlashQDoneTicket;
+static volatile SWORD swFlashQResults[FLASHQ_RESULT_HISTORY];
+
+    // readers holding the lock, no request starts
+static volatile UWORD uwFlashQReadLocks;
+
+    // Client side: tickets given at queueing, callbacks called once the
+    // completion is seen
+
+static ULONG ulFlashQNextTicket=1;
+static ULONG ulFlashQCompletedTicket;
+static FLASHQ_CALLBACK pfFlashQDone[FLASHQ_MAX_REQUESTS];
+static HPVOID hpvFlashQContext[FLASHQ_MAX_REQUESTS];
+
+//***************************************************************************
+// Local functions
+
+    // Server side
+
+    // request at the queue head, slot is free as outstanding tickets are
+    // limited at queueing
+static void push(UBYTE ubOp, ULONG ulAddress, const UBYTE * hpubSrc, ULONG ulSize, ULONG ulTicket)
+{
+    FLASHQ_REQUEST * psReq=&sFlashQRequests[uwFlashQHead&(FLASHQ_MAX_REQUESTS-1)];
+
+    psReq->ubOp=ubOp;
+    psReq->ulAddress=ulAddress;
+    psReq->ulSize=ulSize;
+    psReq->hpubSrc=hpubSrc;
+    psReq->ulTicket=ulTicket;
+    psReq->swResult=FLASHQ_R_OK;
+
+        // sub-sector erase if size fits in it, as FlashErase()
+    if(ubOp==FLASHQ_OP_WRITE)
+        psReq->ulEraseSize=0;
+    else if(ulSize==FLASHQ_BULK_ERASE_SIZE)
+        psReq->ulEraseSize=FLASHQ_BULK_ERASE_SIZE;
+    else
+        psReq->ulEraseSize=ulSize>SUBSECTOR_SIZE ? SECTOR_SIZE : SUBSECTOR_SIZE;
+
+        // publish the request
+    ATOMIC_COMPILER_BARRIER();
+    uwFlashQHead++;
+}
+
+    // Client side
+
+    // callbacks of the requests completed since last call, in order; each
+    // request is accounted as free before its callback, that could queue
+    // another one
+static void complete(void)
+{
+    FLASHQ_CALLBACK pfDone;
+    HPVOID hpvContext;
+    ULONG ulFlags,ulTicket;
+
+    for(;;)
+    {
+        ATOMIC_IRQ_SAVE(ulFlags);
+        if(ulFlashQCompletedTicket==ulFlashQDoneTicket)
+        {
+            ATOMIC_IRQ_RESTORE(ulFlags);
+            break;
+        }
+        ulTicket=ulFlashQCompletedTicket+1;
+        pfDone=pfFlashQDone[ulTicket&(FLASHQ_MAX_REQUESTS-1)];
+        hpvContext=hpvFlashQContext[ulTicket&(FLASHQ_MAX_REQUESTS-1)];
+        ulFlashQCompletedTicket=ulTicket;
+        ATOMIC_IRQ_RESTORE(ulFlags);
+
+        if(pfDone)
+            (*pfDone)(hpvContext, ulTicket);
+    }
+}
+
+#if CFG_AMP
+    // TRUE if the queue is served by the second core: before its start
+    // the first core serves it itself, as at boot
+#define served()                        Cpu1_IsStarted()
+
+    // second core: queue posted requests, payload copied out as it is
+    // not aligned for pointers
+static void mboxwrite(const AMPMBOX_MSG * psMsg)
+{
+    FLASHQ_MSG sReq;
+
+    memcpy(&sReq, psMsg->ubData, sizeof(sReq));
+    push(FLASHQ_OP_WRITE, sReq.ulAddress, sReq.hpubSrc, sReq.ulSize, sReq.ulTicket);
+}
+
+static void mboxerase(const AMPMBOX_MSG * psMsg)
+{
+    FLASHQ_MSG sReq;
+
+    memcpy(&sReq, psMsg->ubData, sizeof(sReq));
+    push(FLASHQ_OP_ERASE, sReq.ulAddress, NULL, sReq.ulSize, sReq.ulTicket);
+}
+
+    // first core: completion notified, done ticket is already published
+static void mboxdone(const AMPMBOX_MSG * psMsg)
+{
+    (void)psMsg;
+    complete();
+}
+
+#else
+#define served()                        FALSE
+#endif
+
+    // completions to the client: callbacks from the tick on a single
+    // core, a message to the first core with CFG_AMP (retried next tick
+    // if the mailbox is full)
+static void notify(void)
+{
+#if CFG_AMP
+    ULONG ulTicket;
+
+    if(served())
+    {
+        ulTicket=ulFlashQDoneTicket;
+        if(ulTicket!=ulFlashQNotifiedTicket && AmpMbox_Post(AMPMBOX_TOCPU0, AMPMBOX_CODE_FLASHQ_DONE, &ulTicket, sizeof(ulTicket)))
+            ulFlashQNotifiedTicket=ulTicket;
+        return;
+    }
+#endif
+
+    complete();
+}
+
+static SWORD enqueue(UBYTE ubOp, ULONG ulAddress, const UBYTE * hpubSrc, ULONG ulSize,
+                     FLASHQ_CALLBACK pfDone, HPVOID hpvContext, ULONG * pulTicket)
+{
+    ULONG ulFlags,ulTicket;
+#if CFG_AMP
+    FLASHQ_MSG sMsg;
+#endif
+
+#if CFG_AMP
+        // completed requests not seen by any task yet
+    if(served() && ulFlashQNextTicket-1-ulFlashQCompletedTicket>=FLASHQ_MAX_REQUESTS)
+        complete();
+#endif
+
+    ATOMIC_IRQ_SAVE(ulFlags);
+
+        // slots are freed once the completion is seen
+    if(ulFlashQNextTicket-1-ulFlashQCompletedTicket>=FLASHQ_MAX_REQUESTS)
+    {
+        ATOMIC_IRQ_RESTORE(ulFlags);
+        return FLASHQ_R_QUEUEFULL;
+    }
+
+    ulTicket=ulFlashQNextTicket;
+    pfFlashQDone[ulTicket&(FLASHQ_MAX_REQUESTS-1)]=pfDone;
+    hpvFlashQContext[ulTicket&(FLASHQ_MAX_REQUESTS-1)]=hpvContext;
+
+#if CFG_AMP
+        // posted with irq disabled, single producer among first core tasks
+    if(served())
+    {
+        sMsg.ulAddress=ulAddress;
+        sMsg.ulSize=ulSize;
+        sMsg.hpubSrc=hpubSrc;
+        sMsg.ulTicket=ulTicket;
+        if(!AmpMbox_Post(AMPMBOX_TOCPU1, ubOp==FLASHQ_OP_WRITE ? AMPMBOX_CODE_FLASHQ_WRITE : AMPMBOX_CODE_FLASHQ_ERASE, &sMsg, sizeof(sMsg)))
+        {
+            ATOMIC_IRQ_RESTORE(ulFlags);
+            return FLASHQ_R_QUEUEFULL;
+        }
+    }
+    else
+#endif
+        push(ubOp, ulAddress, hpubSrc, ulSize, ulTicket);
+
+    ulFlashQNextTicket++;
+    if(pulTicket)
+        *pulTicket=ulTicket;
+
+    ATOMIC_IRQ_RESTORE(ulFlags);
+
+    return FLASHQ_R_OK;
+}
+
+//***************************************************************************
+// Register the background tick; with CFG_AMP on the second core, requests
+// and completions through the mailboxes
+
+BOOL FlashQ_Init(void)
+{
+#if CFG_AMP
+    if(!AmpMbox_SetHandler(AMPMBOX_TOCPU1, AMPMBOX_CODE_FLASHQ_WRITE, &mboxwrite) ||
+       !AmpMbox_SetHandler(AMPMBOX_TOCPU1, AMPMBOX_CODE_FLASHQ_ERASE, &mboxerase) ||
+       !AmpMbox_SetHandler(AMPMBOX_TOCPU0, AMPMBOX_CODE_FLASHQ_DONE, &mboxdone))
+        return FALSE;
+
+    if(!TaskSched_AddBackgroundTaskCpu1(&cpu1tick, TASKSCHEDULER_BKG_PRIO_HIGH, 0, 0))
+        return FALSE;
+#elif defined(_AXX_SYSAPP)
+    if(!TaskSched_AddBackgroundTaskPrio(&FlashQ_Tick, TASKSCHEDULER_BKG_PRIO_HIGH, 0))
+        return FALSE;
+#endif
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Queue write of flash data
+
+SWORD FlashQ_Write(ULONG ulAddress, const HPVOID hpvSrc, ULONG ulSize, FLASHQ_CALLBACK pfDone, HPVOID hpvContext, ULONG * pulTicket)
+{
+    return enqueue(FLASHQ_OP_WRITE, ulAddress, (const UBYTE *)hpvSrc, ulSize, pfDone, hpvContext, pulTicket);
+}
+
+//***************************************************************************
+// Queue erase
+
+SWORD FlashQ_Erase(ULONG ulAddress, ULONG ulSize, FLASHQ_CALLBACK pfDone, HPVOID hpvContext, ULONG * pulTicket)
+{
+    if(ulSize==0)
+        return FLASHQ_R_INVALIDSIZE;
+
+    return enqueue(FLASHQ_OP_ERASE, ulAddress, NULL, ulSize, pfDone, hpvContext, pulTicket);
+}
+
+//***************************************************************************
+// TRUE if request of ticket is completed
+
+BOOL FlashQ_IsDone(ULONG ulTicket)
+{
+    return (SLONG)(ulFlashQDoneTicket-ulTicket)>=0;
+}
+
+//***************************************************************************
+// Result of request of ticket
+
+SWORD FlashQ_Result(ULONG ulTicket)
+{
+    SWORD swResult;
+
+    if(!FlashQ_IsDone(ulTicket))
+        return FLASHQ_R_PENDING;
+
+        // result published before the ticket, slot could be reused by a
+        // later request while reading
+    ATOMIC_DMB();
+    swResult=swFlashQResults[ulTicket&(FLASHQ_RESULT_HISTORY-1)];
+    ATOMIC_DMB();
+    if(ulFlashQDoneTicket-ulTicket>=FLASHQ_RESULT_HISTORY)
+        return FLASHQ_R_EXPIRED;
+
+    return swResult;
+}
+
+//***************************************************************************
+// TRUE if requests are pending
+
+BOOL FlashQ_Busy(void)
+{
+    return ulFlashQNextTicket-1!=ulFlashQDoneTicket;
+}
+
+//***************************************************************************
+// Server: if the device is idle complete the actual request or start its
+// next command (one page program or one erase unit)
+
+static void serve(void)
+{
+    FLASHQ_REQUEST * psReq;
+    ULONG ulFlags,ulChunk;
+
+        // single server
+    ATOMIC_IRQ_SAVE(ulFlags);
+    if(bFlashQInTick)
+    {
+        ATOMIC_IRQ_RESTORE(ulFlags);
+        return;
+    }
+    bFlashQInTick=TRUE;
+    ATOMIC_IRQ_RESTORE(ulFlags);
+
+    for(;;)
+    {
+            // one status read per tick while the device is busy
+        if(bFlashQCmdStarted)
+        {
+            if(FlashBusy())
+                break;
+
+            bFlashQCmdStarted=FALSE;
+
+                // failed command, drop the rest of the request
+            if(FlashCmdFailed())
+            {
+                psReq=&sFlashQRequests[uwFlashQTail&(FLASHQ_MAX_REQUESTS-1)];
+                psReq->swResult=FLASHQ_R_FLASHFAIL;
+                psReq->ulSize=0;
+            }
+        }
+
+        if(uwFlashQTail==uwFlashQHead)
+            break;
+
+        psReq=&sFlashQRequests[uwFlashQTail&(FLASHQ_MAX_REQUESTS-1)];
+
+            // request completed: publish result and ticket
+        if(psReq->ulSize==0)
+        {
+            swFlashQResults[psReq->ulTicket&(FLASHQ_RESULT_HISTORY-1)]=psReq->swResult;
+            ATOMIC_DMB();
+            ulFlashQDoneTicket=psReq->ulTicket;
+
+            ATOMIC_COMPILER_BARRIER();
+            uwFlashQTail++;
+            bFlashQReqStarted=FALSE;
+
+            continue;
+        }
+
+            // readers hold off a new request, a reader taking the lock
+            // later sees it started and waits its completion; flag and
+            // lock count are written and read crosswise, so at least one
+            // side sees the other, also from the other core
+        if(!bFlashQReqStarted)
+        {
+            bFlashQReqStarted=TRUE;
+            ATOMIC_DMB();
+            if(uwFlashQReadLocks)
+            {
+                bFlashQReqStarted=FALSE;
+                break;
+            }
+        }
+
+        if(psReq->ubOp==FLASHQ_OP_WRITE)
+        {
+                // up to the end of the page
+            ulChunk=PAGE_SIZE-(psReq->ulAddress&(PAGE_SIZE-1));
+            if(ulChunk>psReq->ulSize)
+                ulChunk=psReq->ulSize;
+
+            FlashProgramStart(psReq->ulAddress, psReq->hpubSrc, ulChunk);
+
+            psReq->hpubSrc+=ulChunk;
+            psReq->ulAddress+=ulChunk;
+        }
+        else
+        {
+            FlashEraseStart(psReq->ulAddress, psReq->ulEraseSize);
+
+                // sub-sector erase only if size fits in it, as FlashErase()
+            ulChunk=psReq->ulEraseSize==FLASHQ_BULK_ERASE_SIZE || psReq->ulSize<SECTOR_SIZE ? psReq->ulSize : SECTOR_SIZE;
+
+            psReq->ulAddress+=SECTOR_SIZE;
+        }
+
+        psReq->ulSize-=ulChunk;
+        bFlashQCmdStarted=TRUE;
+        break;
+    }
+
+    notify();
+
+    bFlashQInTick=FALSE;
+}
+
+//***************************************************************************
+// Background tick, serve the queue; with CFG_AMP once the second core
+// serves it only the completions are seen here
+
+void FlashQ_Tick(void)
+{
+    if(served())
+        complete();
+    else
+        serve();
+}
+
+#if CFG_AMP
+    // second core background task
+static BOOL cpu1tick(ULONG ulArg)
+{
+    (void)ulArg;
+    serve();
+
+    return FALSE;
+}
+#endif
+
+    // serve the queue from a waiting task, then sleep while the device is
+    // busy
+static void waittick(void)
+{
+    FlashQ_Tick();
+
+#ifdef _AXX_SYSAPP
+        // let other tasks run while the device is busy
+    if(Os_IsSchedulerRunning())
+        Os_Sleep(1);
+#endif
+}
+
+//***************************************************************************
+// Read lock: complete the request in progress, new ones are held off by the
+// tick
+
+void FlashQ_ReadLock(void)
+{
+    ULONG ulFlags;
+
+    ATOMIC_IRQ_SAVE(ulFlags);
+    uwFlashQReadLocks++;
+    ATOMIC_IRQ_RESTORE(ulFlags);
+
+        // lock count visible before reading the started flags
+    ATOMIC_DMB();
+
+    FlashQ_Tick();
+
+    while(bFlashQReqStarted || bFlashQCmdStarted)
+        waittick();
+}
+
+void FlashQ_ReadUnlock(void)
+{
+    ULONG ulFlags;
+
+    ATOMIC_IRQ_SAVE(ulFlags);
+    uwFlashQReadLocks--;
+    ATOMIC_IRQ_RESTORE(ulFlags);
+}
+
+//***************************************************************************
+// Wait for request completion
+
+SWORD FlashQ_Wait(ULONG ulTicket)
+{
+    FlashQ_Tick();
+
+    while(!FlashQ_IsDone(ulTicket))
+        waittick();
+
+    return FlashQ_Result(ulTicket);
+}
@@ -0,0 +1,111 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : FlashQueue.h                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Queue of non blocking program flash write and erase        */
+/*               requests, served by a background tick                      */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _FLASHQUEUE_H
+#define _FLASHQUEUE_H
+
+#include "common\CommonDefines.h"
+
+//***************************************************************************
+// Usage
+//
+// Program and erase operations are queued and return at once; the
+// background tick starts one device command at a time and checks its
+// completion with a single status read, so neither a spin loop nor masked
+// interrupts last for a whole page program or sector erase. Completion is
+// notified by callback (called from the tick, keep it short) or checked
+// with the ticket returned at queueing.
+//
+// With CFG_AMP the second core serves the queue once started: requests are
+// posted to it through the mailboxes, completions come back as a message
+// and callbacks are called by the first core background scheduler, or by
+// FlashQ_Tick() and the waiting functions, that no longer touch the device.
+// Before its start (boot) the first core serves the queue itself as on a
+// single core.
+//
+// Write data must stay valid until the request is completed. While a
+// command is in progress the whole flash content read through the linear
+// address space is undefined: readers enclose their reads between
+// FlashQ_ReadLock() and FlashQ_ReadUnlock(), that completes the request in
+// progress and holds off the start of the queued ones. Do not wait for a
+// queued request while holding the lock.
+//
+// The device error flags are checked after each command, a failed command
+// completes its request at once with FLASHQ_R_FLASHFAIL: check the result
+// with FlashQ_Result(), from the callback too.
+//
+// Synchronous use: FlashQ_Erase(addr, size, NULL, NULL, &ticket);
+//                  if(FlashQ_Wait(ticket)!=FLASHQ_R_OK) ...
+
+//***************************************************************************
+// Defines
+
+#define FLASHQ_R_OK                     0
+#define FLASHQ_R_QUEUEFULL              (-1)
+#define FLASHQ_R_INVALIDSIZE            (-2)
+#define FLASHQ_R_FLASHFAIL              (-3)    // device reported program or erase failure
+#define FLASHQ_R_PENDING                (-4)    // request not completed yet
+#define FLASHQ_R_EXPIRED                (-5)    // result no longer kept
+
+    // max queued requests (power of 2)
+#define FLASHQ_MAX_REQUESTS             8
+
+    // results kept for the last completed requests (power of 2)
+#define FLASHQ_RESULT_HISTORY           (2*FLASHQ_MAX_REQUESTS)
+
+//***************************************************************************
+// Data structures
+
+    // completion callback, context and ticket of the completed request
+typedef void (* FLASHQ_CALLBACK)(HPVOID hpvContext, ULONG ulTicket);
+
+//***************************************************************************
+// Global functions
+
+// Register the background tick
+BOOL FlashQ_Init(void);
+
+// Queue write of flash data, any size and alignment
+SWORD FlashQ_Write(ULONG ulAddress, const HPVOID hpvSrc, ULONG ulSize, FLASHQ_CALLBACK pfDone, HPVOID hpvContext, ULONG * pulTicket);
+
+// Queue erase, same granularity as FlashErase(): a single sub-sector if
+// size fits in it, whole sectors otherwise, bulk erase if flash size
+SWORD FlashQ_Erase(ULONG ulAddress, ULONG ulSize, FLASHQ_CALLBACK pfDone, HPVOID hpvContext, ULONG * pulTicket);
+
+// TRUE if request of ticket is completed
+BOOL FlashQ_IsDone(ULONG ulTicket);
+
+// Result of request of ticket: FLASHQ_R_OK, FLASHQ_R_FLASHFAIL, or
+// FLASHQ_R_PENDING/FLASHQ_R_EXPIRED if not known
+SWORD FlashQ_Result(ULONG ulTicket);
+
+// TRUE if requests are pending
+BOOL FlashQ_Busy(void);
+
+// Wait for the request in progress to complete and hold off new ones, so
+// flash can be read through the linear address space (nestable)
+void FlashQ_ReadLock(void);
+
+// Release the read lock
+void FlashQ_ReadUnlock(void);
+
+// Background tick, serve the queue; with CFG_AMP once the second core
+// serves it, only call the callbacks of the completed requests
+void FlashQ_Tick(void);
+
+// Wait for request completion, the device is served from the calling task
+// too, which sleeps between status reads if the Os is running; return the
+// result of the request
+SWORD FlashQ_Wait(ULONG ulTicket);
+
+#endif
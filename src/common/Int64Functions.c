@@ -17,7 +17,6 @@
 //#include <intrins.h>
 
 #include "Int64Functions.h"
-#include <math.h>
 
 //***************************************************************************
 // Avoids warning C47: unreferenced parameter
@@ -27,14 +26,13 @@
 /////////////////////////////////////////////////////////////////////////////
 // Compiler Option
 
-#pragma GCC optimize (0)
+#pragma GCC optimize (2)
 
 //***************************************************************************
 // constants
 
 const SQWRD sqZero64bit = {0L, 0UL} ; // 'zero' a 64 bit
 
-//#define _CRS_64FUNCFLOAT_
 //***************************************************************************
 // Atomic copy
 
@@ -49,26 +47,7 @@ void _sint64_atomic_copy( SQWRD * dst, const SQWRD * src )
 
 void _sint64_add( SQWRD * dst, const SQWRD * op1, const SQWRD * op2 )
 {
-#ifdef _CRS_64FUNCFLOAT_
-	// needed to create single variables, otherwise compiler
-	// create a mess with float cast to macro result
-	SLLNG s64_op1 = MAKE_INT64(op1->hi, op1->lo) ;
-	SLLNG s64_op2 = MAKE_INT64(op2->hi, op2->lo) ;
-	FLOAT 	flDst = (FLOAT)s64_op1 + (FLOAT)s64_op2 ; // use double?
-
-	// saturate to avoid overflow
-	if (flDst >= INT64_MAX_VALUE)
-		flDst = INT64_MAX_VALUE ;
-	else if (flDst <= INT64_MIN_VALUE)
-		flDst = INT64_MIN_VALUE ;
-
-	dst->hi = MAKE_SQWRDHI((SLLNG)flDst) ;
-	dst->lo = MAKE_SQWRDLO((SLLNG)flDst) ;
-#else
-	SLLNG s64Dst = (MAKE_INT64(op1->hi, op1->lo)) + (MAKE_INT64(op2->hi, op2->lo)) ;
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
-#endif	// _CRS_64FUNCFLOAT_
+	s64_st(dst, s64_add(s64_ld(op1), s64_ld(op2))) ;
 }
 
 //***************************************************************************
@@ -86,27 +65,7 @@ void _uint64_add( UQWRD * dst, const UQWRD * op1, const UQWRD * op2 )
 
 void _sint64_sub( SQWRD * dst, const SQWRD * op1, const SQWRD * op2 )
 {
-#ifdef _CRS_64FUNCFLOAT_
-	// needed to create single variables, otherwise compiler
-	// create a mess with float cast to macro result
-	SLLNG s64_op1 = MAKE_INT64(op1->hi, op1->lo) ;
-	SLLNG s64_op2 = MAKE_INT64(op2->hi, op2->lo) ;
-	FLOAT flDst = (FLOAT)s64_op1 - (FLOAT)s64_op2 ; // use double?
-
-	// saturate to avoid overflow
-	if (flDst >= INT64_MAX_VALUE)
-		flDst = INT64_MAX_VALUE ;
-	else if (flDst <= INT64_MIN_VALUE)
-		flDst = INT64_MIN_VALUE ;
-
-	dst->hi = MAKE_SQWRDHI((SLLNG)flDst) ;
-	dst->lo = MAKE_SQWRDLO((SLLNG)flDst) ;
-
-#else
-	SLLNG s64Dst = (MAKE_INT64(op1->hi, op1->lo)) - (MAKE_INT64(op2->hi, op2->lo)) ;
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
-#endif // _CRS_64FUNCFLOAT_
+	s64_st(dst, s64_sub(s64_ld(op1), s64_ld(op2))) ;
 }
 
 //***************************************************************************
@@ -124,9 +83,7 @@ void _uint64_sub( UQWRD * dst, const UQWRD * op1, const UQWRD * op2 )
 
 void _sint64_add_64_32( SQWRD * dst, const SQWRD * op1, const SLONG * op2 )
 {
-	SLLNG s64Dst = (MAKE_INT64(op1->hi, op1->lo)) + (SLLNG)(*op2) ;
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
+	s64_st(dst, s64_add(s64_ld(op1), (SLLNG)(*op2))) ;
 }
 
 //***************************************************************************
@@ -144,9 +101,7 @@ void _uint64_add_64_32( UQWRD * dst, const UQWRD * op1, const ULONG * op2 )
 
 void _sint64_add_32_32( SQWRD * dst, const SLONG * op1, const SLONG * op2 )
 {
-	SLLNG s64Dst = (SLLNG)(*op1) + (SLLNG)(*op2) ;
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
+	s64_st(dst, (SLLNG)(*op1) + (SLLNG)(*op2)) ;
 }
 
 //***************************************************************************
@@ -164,9 +119,7 @@ void _uint64_add_32_32( UQWRD * dst, const ULONG * op1, const ULONG * op2 )
 
 void _sint64_sub_64_32( SQWRD * dst, const SQWRD * op1, const SLONG * op2 )
 {
-	SLLNG s64Dst = (MAKE_INT64(op1->hi, op1->lo)) - (SLLNG)(*op2) ;
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
+	s64_st(dst, s64_sub(s64_ld(op1), (SLLNG)(*op2))) ;
 }
 
 //***************************************************************************
@@ -184,9 +137,7 @@ void _uint64_sub_64_32( UQWRD * dst, const UQWRD * op1, const ULONG * op2 )
 
 void _sint64_sub_32_32( SQWRD * dst, const SLONG * op1, const SLONG * op2 )
 {
-	SLLNG s64Dst = (SLLNG)(*op1) - (SLLNG)(*op2) ;
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
+	s64_st(dst, (SLLNG)(*op1) - (SLLNG)(*op2)) ;
 }
 
 //***************************************************************************
@@ -204,9 +155,7 @@ void _uint64_sub_32_32( UQWRD * dst, const ULONG * op1, const ULONG * op2 )
 
 void _sint64_mul_32_32( SQWRD * dst, const SLONG * op1 , const SLONG * op2 )
 {
-	SLLNG s64Dst = ((SLLNG)(*op1)) * ((SLLNG)(*op2)) ;
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
+	s64_st(dst, s64_mul_32_32(*op1, *op2)) ;
 }
 
 //***************************************************************************
@@ -224,9 +173,7 @@ void _uint64_mul_32_32( UQWRD * dst, const ULONG * op1, const ULONG * op2 )
 
 void _sint64_mul_32_16( SQWRD * dst, const SLONG * op1, const SWORD * op2 )
 {
-	SLLNG s64Dst = ((SLLNG)(*op1)) * ((SLLNG)(*op2)) ;
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
+	s64_st(dst, s64_mul_32_32(*op1, (SLONG)(*op2))) ;
 }
 
 //***************************************************************************
@@ -234,26 +181,7 @@ void _sint64_mul_32_16( SQWRD * dst, const SLONG * op1, const SWORD * op2 )
 
 void _sint64_mul_48_16( SQWRD * dst, const SQWRD * op1, const SWORD * op2 )
 {
-#ifdef _CRS_64FUNCFLOAT_
-	// needed to create single variables, otherwise compiler
-	// create a mess with float cast to macro result
-	SLLNG   s64_op1 = MAKE_INT64(op1->hi, op1->lo) ;
-	FLOAT   flDst = (FLOAT)s64_op1 * (FLOAT)(*op2) ; // use double?
-
-	// saturate to avoid overflow
-	if (flDst >= INT64_MAX_VALUE)
-		flDst = INT64_MAX_VALUE ;
-	else if (flDst <= INT64_MIN_VALUE)
-		flDst = INT64_MIN_VALUE ;
-
-	dst->hi = MAKE_SQWRDHI((SLLNG)flDst) ;
-	dst->lo = MAKE_SQWRDLO((SLLNG)flDst) ;
-#else
-	SLLNG s64Dst = (MAKE_INT64(op1->hi, op1->lo)) * ((SLLNG)(*op2)) ;
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
-#endif
-
+	s64_st(dst, s64_mul_64_16(s64_ld(op1), *op2)) ;
 }
 
 //***************************************************************************
@@ -261,16 +189,7 @@ void _sint64_mul_48_16( SQWRD * dst, const SQWRD * op1, const SWORD * op2 )
 
 SBYTE _sint64_comp( SQWRD * op1, SQWRD * op2 )
 {
-  if (op1->hi > op2->hi)
-    return 1 ;                /* op1 > op2 */
-  else if (op1->hi < op2->hi)
-    return -1 ;               /* op1 < op2 */
-  else if (op1->lo > op2->lo) /* op1.hi = op2.hi => check low part */
-    return 1 ;                /* op1 > op2 */
-  else if (op1->lo < op2->lo)
-    return -1 ;               /* op1 < op2 */
-  else
-    return 0 ;                /* op1 = op2 */
+	return s64_comp(s64_ld(op1), s64_ld(op2)) ;
 }
 
 //***************************************************************************
@@ -372,14 +291,7 @@ SBYTE _sint64_comp( SQWRD * op1, SQWRD * op2 )
 
 SLONG _sint64toSint32(SQWRD * sqVar)
 {
-	SLLNG s64Dst = MAKE_INT64(sqVar->hi, sqVar->lo) ;
-
-	if (s64Dst >= (SLLNG)SLONG_MAX_VALUE)
-		return SLONG_MAX_VALUE ;
-	else if (s64Dst <= (SLLNG)SLONG_MIN_VALUE)
-		return SLONG_MIN_VALUE ;
-	else
-		return (SLONG)s64Dst ;
+	return s64_sat32(s64_ld(sqVar)) ;
 }
 
 //***************************************************************************
@@ -407,29 +319,7 @@ SLONG _sint64toSint32(SQWRD * sqVar)
 void _sint64_shl( SQWRD * var, UWORD cnt )
 {
 	if (cnt != 0)
-	{
-#ifdef _CRS_64FUNCFLOAT_
-		// needed to create single variables, otherwise compiler
-		// create a mess with float cast to macro result
-		SLLNG   s64_op1 = MAKE_INT64(var->hi, var->lo) ;
-		FLOAT   flDst = ((FLOAT)s64_op1) * pow(2.0, cnt) ; // use double?
-
-		// saturate to avoid overflow
-		if (flDst >= INT64_MAX_VALUE)
-			flDst = INT64_MAX_VALUE ;
-		else if (flDst <= INT64_MIN_VALUE)
-			flDst = INT64_MIN_VALUE ;
-
-		var->hi = MAKE_SQWRDHI((SLLNG)flDst) ;
-		var->lo = MAKE_SQWRDLO((SLLNG)flDst) ;
-#else
-		SLLNG s64Dst = (SLLNG)(MAKE_INT64(var->hi, var->lo)) << cnt ;
-		var->hi = MAKE_SQWRDHI(s64Dst) ;
-		var->lo = MAKE_SQWRDLO(s64Dst) ;
-#endif
-	}
-	else
-		return ;
+		s64_st(var, s64_shl(s64_ld(var), cnt)) ;
 }
 
 //***************************************************************************
@@ -438,14 +328,7 @@ void _sint64_shl( SQWRD * var, UWORD cnt )
 void _sint64_shr( SQWRD * var, UWORD cnt )
 {
 	if (cnt != 0)
-	{
-		SLLNG s64Dst = (SLLNG)(MAKE_INT64(var->hi, var->lo)) >> cnt ;
-	
-		var->hi = MAKE_SQWRDHI(s64Dst) ;
-		var->lo = MAKE_SQWRDLO(s64Dst) ;
-	}
-	else
-		return ;
+		s64_st(var, s64_shr(s64_ld(var), cnt)) ;
 }
 
 //***************************************************************************
@@ -489,16 +372,7 @@ void _uint64_shl( UQWRD * var, UWORD cnt )
 
 void _sint64toSint48(SQWRD *sqVar)
 {
-  if (sqVar->hi >= 32767l)
-  { /* positive number: clamp to 0x00007fff_ffffffff */
-    sqVar->hi = 32767l  ;
-    sqVar->lo = (ULONG)0xffffffffUL ;
-  }
-  else if (sqVar->hi <= -32768l)
-  { /* negative number: clamp to 0xffff8000_00000001 */
-    sqVar->hi = -32768l  ;
-    sqVar->lo = (ULONG)0x00000001UL ;
-  }
+	s64_st(sqVar, s64_sat48(s64_ld(sqVar))) ;
 }
 
 //***************************************************************************
@@ -506,25 +380,7 @@ void _sint64toSint48(SQWRD *sqVar)
 
 void _sint64p_scale_32( SQWRD  * val, SLONG scale )
 {
-#ifdef _CRS_64FUNCFLOAT_
-	// needed to create single variables, otherwise compiler
-	// create a mess with float cast to macro result
-	SLLNG   s64_op1 = MAKE_INT64(val->hi, val->lo) ;
-	FLOAT   flDst = (FLOAT)s64_op1 * (FLOAT)scale / 65536.0 ; // use double?
-
-	// saturate to avoid overflow
-	if (flDst >= INT64_MAX_VALUE)
-		flDst = INT64_MAX_VALUE ;
-	else if (flDst <= INT64_MIN_VALUE)
-		flDst = INT64_MIN_VALUE ;
-
-	val->hi = MAKE_SQWRDHI((SLLNG)flDst) ;
-	val->lo = MAKE_SQWRDLO((SLLNG)flDst) ;
-#else
-	SLLNG s64Dst = (SLLNG)((MAKE_INT64(val->hi, val->lo)) * scale) >> 16 ;
-	val->hi = MAKE_SQWRDHI(s64Dst) ;
-	val->lo = MAKE_SQWRDLO(s64Dst) ;
-#endif
+	s64_st(val, s64_scale_q16(s64_ld(val), scale)) ;
 }
 
 //***************************************************************************
@@ -532,10 +388,7 @@ void _sint64p_scale_32( SQWRD  * val, SLONG scale )
 
 void _sint64p_add( SQWRD  * val, ULONG lo, SLONG hi )
 {
-	SLLNG s64Dst = (MAKE_INT64(val->hi, val->lo)) + (MAKE_INT64(hi, lo));
-
-	val->hi = MAKE_SQWRDHI(s64Dst) ;
-	val->lo = MAKE_SQWRDLO(s64Dst) ;
+	s64_st(val, s64_add(s64_ld(val), MAKE_INT64(hi, lo))) ;
 }
 
 //***************************************************************************
@@ -543,10 +396,7 @@ void _sint64p_add( SQWRD  * val, ULONG lo, SLONG hi )
 
 void _sint64p_sub( SQWRD  * val, ULONG lo, SLONG hi )
 {
-	SLLNG s64Dst = (MAKE_INT64(val->hi, val->lo)) - (MAKE_INT64(hi, lo));
-
-	val->hi = MAKE_SQWRDHI(s64Dst) ;
-	val->lo = MAKE_SQWRDLO(s64Dst) ;
+	s64_st(val, s64_sub(s64_ld(val), MAKE_INT64(hi, lo))) ;
 }
 
 //***************************************************************************
@@ -554,8 +404,5 @@ void _sint64p_sub( SQWRD  * val, ULONG lo, SLONG hi )
 
 void _sint64_sub_nosaturation( SQWRD * dst, const SQWRD * op1, const SQWRD * op2 )
 {
-	SLLNG s64Dst = (MAKE_INT64(op1->hi, op1->lo)) - (MAKE_INT64(op2->hi, op2->lo));
-
-	dst->hi = MAKE_SQWRDHI(s64Dst) ;
-	dst->lo = MAKE_SQWRDLO(s64Dst) ;
+	s64_st(dst, s64_sub(s64_ld(op1), s64_ld(op2))) ;
 }
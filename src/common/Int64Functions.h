@@ -102,6 +102,158 @@ void _sint64p_scale_32( SQWRD  * val, SLONG scale ) ;
 void _sint64p_add( SQWRD  * val, ULONG lo, SLONG hi );
 void _sint64p_sub( SQWRD  * val, ULONG lo, SLONG hi );
 
+//***************************************************************************
+// Native 64bit layer
+//
+// Inline operations on SLLNG, for realtime code: load the SQWRD operands
+// once, compute in registers, store the result once. Plain operations wrap
+// on overflow as the SQWRD functions above, the _sat ones saturate.
+// Results are bit-exact with the SQWRD functions, that are implemented
+// on top of this layer.
+
+#define S64_MAX                         ((SLLNG)0x7FFFFFFFFFFFFFFFLL)
+#define S64_MIN                         (-S64_MAX-1)
+
+    // 48bit range used by _sint64toSint48 (hi word +/-32767)
+#define S48_MAX                         ((SLLNG)0x00007FFFFFFFFFFFLL)
+#define S48_MIN                         (-S48_MAX)
+
+// SQWRD <=> SLLNG
+static inline SLLNG s64_ld(const SQWRD * psqSrc)
+{
+    return MAKE_INT64(psqSrc->hi, psqSrc->lo);
+}
+
+static inline void s64_st(SQWRD * psqDst, SLLNG sllVal)
+{
+    psqDst->lo=MAKE_SQWRDLO(sllVal);
+    psqDst->hi=MAKE_SQWRDHI(sllVal);
+}
+
+// Add/sub, wrapping
+static inline SLLNG s64_add(SLLNG sllOp1, SLLNG sllOp2)
+{
+    return (SLLNG)((ULLNG)sllOp1+(ULLNG)sllOp2);
+}
+
+static inline SLLNG s64_sub(SLLNG sllOp1, SLLNG sllOp2)
+{
+    return (SLLNG)((ULLNG)sllOp1-(ULLNG)sllOp2);
+}
+
+// Add/sub, saturating: overflow if operands (add) or minuend and
+// subtrahend (sub) have the sign not matching the result
+static inline SLLNG s64_add_sat(SLLNG sllOp1, SLLNG sllOp2)
+{
+    SLLNG sllRes=s64_add(sllOp1, sllOp2);
+
+    if(((sllOp1^sllRes)&(sllOp2^sllRes))<0)
+        return sllOp1<0 ? S64_MIN : S64_MAX;
+
+    return sllRes;
+}
+
+static inline SLLNG s64_sub_sat(SLLNG sllOp1, SLLNG sllOp2)
+{
+    SLLNG sllRes=s64_sub(sllOp1, sllOp2);
+
+    if(((sllOp1^sllOp2)&(sllOp1^sllRes))<0)
+        return sllOp1<0 ? S64_MIN : S64_MAX;
+
+    return sllRes;
+}
+
+// s32*s32 => s64, single SMULL
+static inline SLLNG s64_mul_32_32(SLONG slOp1, SLONG slOp2)
+{
+#if defined(__arm__) && !defined(_HW_HOSTSIM)
+    SLLNG sllRes;
+
+    __asm__ ("smull %Q0, %R0, %1, %2" : "=&r" (sllRes) : "r" (slOp1), "r" (slOp2));
+    return sllRes;
+#else
+    return (SLLNG)slOp1*(SLLNG)slOp2;
+#endif
+}
+
+// s64+s32*s32 => s64 wrapping, single SMLAL
+static inline SLLNG s64_mac_32_32(SLLNG sllAcc, SLONG slOp1, SLONG slOp2)
+{
+#if defined(__arm__) && !defined(_HW_HOSTSIM)
+    __asm__ ("smlal %Q0, %R0, %1, %2" : "+r" (sllAcc) : "r" (slOp1), "r" (slOp2));
+    return sllAcc;
+#else
+    return s64_add(sllAcc, (SLLNG)slOp1*(SLLNG)slOp2);
+#endif
+}
+
+// s64*s16 => s64, wrapping (as _sint64_mul_48_16, exact for s48 operand)
+static inline SLLNG s64_mul_64_16(SLLNG sllOp1, SWORD swOp2)
+{
+    return (SLLNG)((ULLNG)sllOp1*(ULLNG)(SLLNG)swOp2);
+}
+
+// s64*s32/Q16, wrapping product
+static inline SLLNG s64_scale_q16(SLLNG sllVal, SLONG slScale)
+{
+    return ((SLLNG)((ULLNG)sllVal*(ULLNG)(SLLNG)slScale))>>16;
+}
+
+// Shift, arithmetic right; left wrapping or saturating
+static inline SLLNG s64_shr(SLLNG sllVal, UWORD uwCnt)
+{
+    return sllVal>>uwCnt;
+}
+
+static inline SLLNG s64_shl(SLLNG sllVal, UWORD uwCnt)
+{
+    return (SLLNG)((ULLNG)sllVal<<uwCnt);
+}
+
+static inline SLLNG s64_shl_sat(SLLNG sllVal, UWORD uwCnt)
+{
+    if(sllVal>(S64_MAX>>uwCnt))
+        return S64_MAX;
+    if(sllVal<(S64_MIN>>uwCnt))
+        return S64_MIN;
+
+    return s64_shl(sllVal, uwCnt);
+}
+
+// s64 => s32, saturating
+static inline SLONG s64_sat32(SLLNG sllVal)
+{
+    if(sllVal>=(SLLNG)SLONG_MAX_VALUE)
+        return SLONG_MAX_VALUE;
+    if(sllVal<=(SLLNG)SLONG_MIN_VALUE)
+        return SLONG_MIN_VALUE;
+
+    return (SLONG)sllVal;
+}
+
+// s64 => s48, saturating; thresholds are on the hi word as _sint64toSint48
+static inline SLLNG s64_sat48(SLLNG sllVal)
+{
+    if(sllVal>=((SLLNG)32767l<<32))
+        return S48_MAX;
+    if(sllVal<-((SLLNG)32767l<<32))
+        return S48_MIN;
+
+    return sllVal;
+}
+
+// Bits 16..47, as INT64_MLONG
+static inline SLONG s64_mid32(SLLNG sllVal)
+{
+    return (SLONG)(sllVal>>16);
+}
+
+// op1>op2 => +1, op1==op2 => 0, op1<op2 => -1
+static inline SBYTE s64_comp(SLLNG sllOp1, SLLNG sllOp2)
+{
+    return (SBYTE)((sllOp1>sllOp2)-(sllOp1<sllOp2));
+}
+
 //***************************************************************************
 // constants
 
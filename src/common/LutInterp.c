@@ -0,0 +1,362 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : LutInterp.c                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Packed 1D/2D/3D lookup tables, linear and cubic Hermite    */
+/*               interpolation with power-of-two grid fast path             */
+/*                                                                          */
+/****************************************************************************/
+#pragma GCC optimize (2)
+
+#include "common\CommonDefines.h"
+#include "common\Int64Functions.h"
+#include "common\LutInterp.h"
+
+//***************************************************************************
+// Fractions are Q15 in [0, 32768]
+
+#define FRAC_ONE                32768L
+
+static inline SWORD sat16(SLONG slVal)
+{
+    if(slVal>32767)
+        return 32767;
+    if(slVal<-32768)
+        return -32768;
+    return (SWORD)slVal;
+}
+
+//***************************************************************************
+// Axis location: segment index in [0, uwPoints-2] and fraction within it
+
+static inline SLONG locate(const LUT_AXIS * psAxis, SWORD swX, UWORD * puwIdx)
+{
+    UWORD uwLast=psAxis->uwPoints-1;
+
+    if(psAxis->pswBreak==NULL)
+    {
+            // uniform grid: shift and mask
+        SLONG slD=(SLONG)swX-psAxis->swMin;
+        SLONG slIdx;
+
+        if(slD<=0)
+        {
+            *puwIdx=0;
+            return 0;
+        }
+
+        slIdx=slD>>psAxis->ubShift;
+        if(slIdx>=uwLast)
+        {
+            *puwIdx=uwLast-1;
+            return FRAC_ONE;
+        }
+
+        *puwIdx=(UWORD)slIdx;
+        return (slD&((1L<<psAxis->ubShift)-1))<<(LUT_SHIFT_MAX-psAxis->ubShift);
+    }
+    else
+    {
+            // breakpoints: binary search
+        const SWORD * pswB=psAxis->pswBreak;
+        UWORD uwLo=0,uwHi=uwLast;
+
+        if(swX<=pswB[0])
+        {
+            *puwIdx=0;
+            return 0;
+        }
+        if(swX>=pswB[uwLast])
+        {
+            *puwIdx=uwLast-1;
+            return FRAC_ONE;
+        }
+
+        while(uwHi-uwLo>1)
+        {
+            UWORD uwMid=(uwLo+uwHi)>>1;
+
+            if(swX<pswB[uwMid])
+                uwHi=uwMid;
+            else
+                uwLo=uwMid;
+        }
+
+        *puwIdx=uwLo;
+        return (((SLONG)swX-pswB[uwLo])<<LUT_SHIFT_MAX)/((SLONG)pswB[uwLo+1]-pswB[uwLo]);
+    }
+}
+
+//***************************************************************************
+// Linear and Catmull-Rom kernels; linear values are at most 17bit wide so
+// the product fits 32bit, Hermite sums run on 64bit
+
+static inline SLONG lerp(SLONG slV0, SLONG slV1, SLONG slFrac)
+{
+    return slV0+(((slV1-slV0)*slFrac+(FRAC_ONE>>1))>>LUT_SHIFT_MAX);
+}
+
+static inline SLONG hermite(SLONG slP0, SLONG slP1, SLONG slP2, SLONG slP3, SLONG slFrac)
+{
+    SLLNG sllAcc;
+
+    sllAcc=3*(slP1-slP2)+slP3-slP0;
+    sllAcc=s64_shr(sllAcc*slFrac, LUT_SHIFT_MAX)+(2*slP0-5*slP1+4*slP2-slP3);
+    sllAcc=s64_shr(sllAcc*slFrac, LUT_SHIFT_MAX)+(slP2-slP0);
+    sllAcc=sllAcc*slFrac;
+
+    return slP1+(SLONG)s64_shr(sllAcc+FRAC_ONE, LUT_SHIFT_MAX+1);
+}
+
+    // segment uwIdx of a row; the missing neighbour at the axis ends is
+    // extrapolated linearly so the end segments keep their slope
+static inline SLONG hermiterow(const SWORD * pswRow, UWORD uwIdx, UWORD uwPoints, SLONG slFrac)
+{
+    SLONG slP1=pswRow[uwIdx];
+    SLONG slP2=pswRow[uwIdx+1];
+    SLONG slP0=uwIdx>0 ? pswRow[uwIdx-1] : 2*slP1-slP2;
+    SLONG slP3=uwIdx+2<uwPoints ? pswRow[uwIdx+2] : 2*slP2-slP1;
+
+    return hermite(slP0, slP1, slP2, slP3, slFrac);
+}
+
+//***************************************************************************
+// Single point workers
+
+static inline SWORD eval1(const LUT_TABLE * psLut, SWORD swX)
+{
+    const SWORD * pswD=psLut->pswData;
+    UWORD uwIx;
+    SLONG slFx=locate(&psLut->sAxis[0], swX, &uwIx);
+
+    if(psLut->ubMode==LUT_MODE_HERMITE)
+        return sat16(hermiterow(pswD, uwIx, psLut->sAxis[0].uwPoints, slFx));
+
+    return sat16(lerp(pswD[uwIx], pswD[uwIx+1], slFx));
+}
+
+static inline SWORD eval2(const LUT_TABLE * psLut, SWORD swX, SWORD swY)
+{
+    UWORD uwSx=psLut->sAxis[0].uwPoints;
+    UWORD uwIx,uwIy;
+    SLONG slFx=locate(&psLut->sAxis[0], swX, &uwIx);
+    SLONG slFy=locate(&psLut->sAxis[1], swY, &uwIy);
+
+    if(psLut->ubMode==LUT_MODE_HERMITE)
+    {
+        UWORD uwSy=psLut->sAxis[1].uwPoints;
+        const SWORD * pswRow=&psLut->pswData[(ULONG)uwIy*uwSx];
+        SLONG slR0,slR1,slR2,slR3;
+
+            // rows around the segment, then the same kernel across them
+        slR1=hermiterow(pswRow,      uwIx, uwSx, slFx);
+        slR2=hermiterow(&pswRow[uwSx],uwIx, uwSx, slFx);
+        slR0=uwIy>0 ? hermiterow(&pswRow[-(SLONG)uwSx], uwIx, uwSx, slFx) : 2*slR1-slR2;
+        slR3=uwIy+2<uwSy ? hermiterow(&pswRow[2*uwSx], uwIx, uwSx, slFx) : 2*slR2-slR1;
+
+        return sat16(hermite(slR0, slR1, slR2, slR3, slFy));
+    }
+    else
+    {
+        const SWORD * pswD=&psLut->pswData[(ULONG)uwIy*uwSx+uwIx];
+
+        return sat16(lerp(lerp(pswD[0],   pswD[1],     slFx),
+                          lerp(pswD[uwSx],pswD[uwSx+1],slFx), slFy));
+    }
+}
+
+static inline SWORD eval3(const LUT_TABLE * psLut, SWORD swX, SWORD swY, SWORD swZ)
+{
+    UWORD uwSx=psLut->sAxis[0].uwPoints;
+    ULONG ulSxy=(ULONG)uwSx*psLut->sAxis[1].uwPoints;
+    UWORD uwIx,uwIy,uwIz;
+    SLONG slFx=locate(&psLut->sAxis[0], swX, &uwIx);
+    SLONG slFy=locate(&psLut->sAxis[1], swY, &uwIy);
+    SLONG slFz=locate(&psLut->sAxis[2], swZ, &uwIz);
+    const SWORD * pswD0=&psLut->pswData[uwIz*ulSxy+(ULONG)uwIy*uwSx+uwIx];
+    const SWORD * pswD1=&pswD0[ulSxy];
+    SLONG slV0,slV1;
+
+    slV0=lerp(lerp(pswD0[0],   pswD0[1],     slFx),
+              lerp(pswD0[uwSx],pswD0[uwSx+1],slFx), slFy);
+    slV1=lerp(lerp(pswD1[0],   pswD1[1],     slFx),
+              lerp(pswD1[uwSx],pswD1[uwSx+1],slFx), slFy);
+
+    return sat16(lerp(slV0, slV1, slFz));
+}
+
+//***************************************************************************
+// Descriptor check
+
+BOOL Lut_Check(const LUT_TABLE * psLut)
+{
+    UBYTE ubCt;
+
+    if(psLut->pswData==NULL || psLut->ubDims==0 || psLut->ubDims>LUT_DIMS_MAX)
+        return FALSE;
+
+    if(psLut->ubMode!=LUT_MODE_LINEAR && psLut->ubMode!=LUT_MODE_HERMITE)
+        return FALSE;
+
+    for(ubCt=0;ubCt<psLut->ubDims;ubCt++)
+    {
+        const LUT_AXIS * psAxis=&psLut->sAxis[ubCt];
+
+        if(psAxis->uwPoints<2)
+            return FALSE;
+
+        if(psAxis->pswBreak==NULL)
+        {
+            if(psAxis->ubShift>LUT_SHIFT_MAX)
+                return FALSE;
+        }
+        else
+        {
+            UWORD uwCt;
+
+            for(uwCt=1;uwCt<psAxis->uwPoints;uwCt++)
+                if(psAxis->pswBreak[uwCt]<=psAxis->pswBreak[uwCt-1])
+                    return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Evaluation
+
+SWORD Lut_Eval1(const LUT_TABLE * psLut, SWORD swX)
+{
+    return eval1(psLut, swX);
+}
+
+SWORD Lut_Eval2(const LUT_TABLE * psLut, SWORD swX, SWORD swY)
+{
+    return eval2(psLut, swX, swY);
+}
+
+SWORD Lut_Eval3(const LUT_TABLE * psLut, SWORD swX, SWORD swY, SWORD swZ)
+{
+    return eval3(psLut, swX, swY, swZ);
+}
+
+//***************************************************************************
+// Batch evaluation; the common 1D linear uniform case gets its own loop
+
+void Lut_Eval1Batch(const LUT_TABLE * psLut, const SWORD * pswX, SWORD * pswOut, UWORD uwNum)
+{
+    const LUT_AXIS * psAxis=&psLut->sAxis[0];
+    UWORD uwCt;
+
+    if(psAxis->pswBreak==NULL && psLut->ubMode==LUT_MODE_LINEAR)
+    {
+        const SWORD * pswD=psLut->pswData;
+        SLONG slMax=(SLONG)(psAxis->uwPoints-1)<<psAxis->ubShift;
+        UBYTE ubShift=psAxis->ubShift;
+        UBYTE ubFracShift=LUT_SHIFT_MAX-ubShift;
+        SLONG slMask=(1L<<ubShift)-1;
+
+        for(uwCt=0;uwCt<uwNum;uwCt++)
+        {
+            SLONG slD=(SLONG)pswX[uwCt]-psAxis->swMin;
+            SLONG slIdx;
+
+                // clamp, the top point is reached as the end of the last segment
+            if(slD<0)
+                slD=0;
+            if(slD>=slMax)
+            {
+                pswOut[uwCt]=pswD[psAxis->uwPoints-1];
+                continue;
+            }
+
+            slIdx=slD>>ubShift;
+            pswOut[uwCt]=sat16(lerp(pswD[slIdx], pswD[slIdx+1], (slD&slMask)<<ubFracShift));
+        }
+        return;
+    }
+
+    for(uwCt=0;uwCt<uwNum;uwCt++)
+        pswOut[uwCt]=eval1(psLut, pswX[uwCt]);
+}
+
+void Lut_Eval2Batch(const LUT_TABLE * psLut, const SWORD * pswX, const SWORD * pswY, SWORD * pswOut, UWORD uwNum)
+{
+    UWORD uwCt;
+
+    for(uwCt=0;uwCt<uwNum;uwCt++)
+        pswOut[uwCt]=eval2(psLut, pswX[uwCt], pswY[uwCt]);
+}
+
+void Lut_Eval3Batch(const LUT_TABLE * psLut, const SWORD * pswX, const SWORD * pswY, const SWORD * pswZ, SWORD * pswOut, UWORD uwNum)
+{
+    UWORD uwCt;
+
+    for(uwCt=0;uwCt<uwNum;uwCt++)
+        pswOut[uwCt]=eval3(psLut, pswX[uwCt], pswY[uwCt], pswZ[uwCt]);
+}
+
+//***************************************************************************
+// PLC entry points; the descriptor is built on each call, an invalid table
+// size gives 0
+
+static inline void legacyaxis(LUT_AXIS * psAxis, UWORD uwLinSize)
+{
+    psAxis->pswBreak=NULL;
+    psAxis->swMin=-32768;
+    psAxis->ubShift=(UBYTE)(16-uwLinSize);
+    psAxis->uwPoints=(1<<uwLinSize)+1;
+}
+
+SWORD Lut_PlcHermite1D(const SWORD * pswData, UWORD uwLinSize, SWORD swX)
+{
+    LUT_TABLE sLut;
+
+    if(uwLinSize<1 || uwLinSize>LUT_SHIFT_MAX)
+        return 0;
+
+    sLut.pswData=pswData;
+    sLut.ubDims=1;
+    sLut.ubMode=LUT_MODE_HERMITE;
+    legacyaxis(&sLut.sAxis[0], uwLinSize);
+
+    return eval1(&sLut, swX);
+}
+
+SWORD Lut_PlcHermite2D(const SWORD * pswData, UWORD uwLinSize, SWORD swX, SWORD swY)
+{
+    LUT_TABLE sLut;
+
+    if(uwLinSize<1 || uwLinSize>LUT_SHIFT_MAX)
+        return 0;
+
+    sLut.pswData=pswData;
+    sLut.ubDims=2;
+    sLut.ubMode=LUT_MODE_HERMITE;
+    legacyaxis(&sLut.sAxis[0], uwLinSize);
+    legacyaxis(&sLut.sAxis[1], uwLinSize);
+
+    return eval2(&sLut, swX, swY);
+}
+
+    // breakpoints are not checked here, they must be ascending
+SWORD Lut_PlcInterpBrk1D(const SWORD * pswBreak, const SWORD * pswData, UWORD uwPoints, SWORD swX)
+{
+    LUT_TABLE sLut;
+
+    if(uwPoints<2)
+        return 0;
+
+    sLut.pswData=pswData;
+    sLut.ubDims=1;
+    sLut.ubMode=LUT_MODE_LINEAR;
+    sLut.sAxis[0].pswBreak=pswBreak;
+    sLut.sAxis[0].uwPoints=uwPoints;
+
+    return eval1(&sLut, swX);
+}
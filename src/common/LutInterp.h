@@ -0,0 +1,78 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : LutInterp.h                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Packed 1D/2D/3D lookup tables, linear and cubic Hermite    */
+/*               interpolation with power-of-two grid fast path             */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _LUTINTERP_H
+#define _LUTINTERP_H
+
+#include "common\CommonDefines.h"
+
+//***************************************************************************
+// Table format
+//   values are packed in one SWORD array, axis 0 fastest:
+//     pswData[(z*uwPointsY+y)*uwPointsX+x]
+//   every axis is either a uniform grid with step 2^ubShift starting at
+//   swMin (pswBreak NULL, fast path: shift and mask, no search) or a list of
+//   ascending breakpoints (binary search and one division per axis).
+//   Inputs outside the axis are clamped to the first/last point
+//
+// The legacy _interpNd tables ((2^n+1) points over the full SWORD range)
+// are uniform axes with swMin -32768 and ubShift 16-n
+
+#define LUT_DIMS_MAX            3
+
+#define LUT_MODE_LINEAR         0
+#define LUT_MODE_HERMITE        1   // Catmull-Rom, 1D and 2D; 3D falls back to linear
+
+#define LUT_SHIFT_MAX           15
+
+typedef struct
+{
+    const SWORD * pswBreak;     // ascending breakpoints, NULL for uniform grid
+    SWORD swMin;                // uniform grid: first point
+    UBYTE ubShift;              // uniform grid: step 2^ubShift
+    UWORD uwPoints;             // number of points, at least 2
+} LUT_AXIS;
+
+typedef struct
+{
+    const SWORD * pswData;
+    LUT_AXIS sAxis[LUT_DIMS_MAX];
+    UBYTE ubDims;
+    UBYTE ubMode;
+} LUT_TABLE;
+
+//***************************************************************************
+// Descriptor check, to be called once when a table is set up
+
+BOOL Lut_Check(const LUT_TABLE * psLut);
+
+//***************************************************************************
+// Evaluation; results are rounded and saturated to SWORD
+
+SWORD Lut_Eval1(const LUT_TABLE * psLut, SWORD swX);
+SWORD Lut_Eval2(const LUT_TABLE * psLut, SWORD swX, SWORD swY);
+SWORD Lut_Eval3(const LUT_TABLE * psLut, SWORD swX, SWORD swY, SWORD swZ);
+
+void Lut_Eval1Batch(const LUT_TABLE * psLut, const SWORD * pswX, SWORD * pswOut, UWORD uwNum);
+void Lut_Eval2Batch(const LUT_TABLE * psLut, const SWORD * pswX, const SWORD * pswY, SWORD * pswOut, UWORD uwNum);
+void Lut_Eval3Batch(const LUT_TABLE * psLut, const SWORD * pswX, const SWORD * pswY, const SWORD * pswZ, SWORD * pswOut, UWORD uwNum);
+
+//***************************************************************************
+// PLC entry points: cubic Hermite on legacy mInterp tables ((2^n+1) points
+// per dimension over the SWORD range), linear on a breakpoint table
+
+SWORD Lut_PlcHermite1D(const SWORD * pswData, UWORD uwLinSize, SWORD swX);
+SWORD Lut_PlcHermite2D(const SWORD * pswData, UWORD uwLinSize, SWORD swX, SWORD swY);
+SWORD Lut_PlcInterpBrk1D(const SWORD * pswBreak, const SWORD * pswData, UWORD uwPoints, SWORD swX);
+
+#endif // _LUTINTERP_H
@@ -0,0 +1,312 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : MathBatch.c                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Batched sin/cos, atan2, magnitude and Clarke/Park kernels; */
+/*               NEON vectorised with scalar reference                      */
+/*                                                                          */
+/****************************************************************************/
+#pragma GCC optimize (2)
+
+#include "common\CommonDefines.h"
+#include "common\MathFunctions.h"
+#include "common\MathBatch.h"
+
+#if MATHBATCH_NEON
+ #include <arm_neon.h>
+#endif
+
+//***************************************************************************
+// Scalar helpers
+
+static inline SWORD sat16(SLONG slVal)
+{
+    if(slVal>32767)
+        return 32767;
+    if(slVal<-32768)
+        return -32768;
+    return (SWORD)slVal;
+}
+
+//***************************************************************************
+// Scalar reference
+
+void Sin16Cos16BatchRef(const UWORD * puwAngle, SWORD * pswSin, SWORD * pswCos, UWORD uwNum)
+{
+    UWORD uwCt;
+
+    for(uwCt=0;uwCt<uwNum;uwCt++)
+    {
+        pswSin[uwCt]=Sin16(puwAngle[uwCt]);
+        pswCos[uwCt]=Cos16(puwAngle[uwCt]);
+    }
+}
+
+//***************************************************************************
+//
+void ATan16BatchRef(const SWORD * pswSin, const SWORD * pswCos, UWORD * puwAngle, UWORD uwNum)
+{
+    UWORD uwCt;
+
+    for(uwCt=0;uwCt<uwNum;uwCt++)
+        puwAngle[uwCt]=ATan16(pswSin[uwCt], pswCos[uwCt]);
+}
+
+//***************************************************************************
+//
+void RootOfSquareSum16BatchRef(const SWORD * pswX, const SWORD * pswY, SWORD * pswMag, UWORD uwNum)
+{
+    UWORD uwCt;
+
+    for(uwCt=0;uwCt<uwNum;uwCt++)
+        pswMag[uwCt]=RootOfSquareSum16(pswX[uwCt], pswY[uwCt]);
+}
+
+//***************************************************************************
+//
+void ClarkeBatch16Ref(const SWORD * pswU, const SWORD * pswV, SWORD * pswAlpha, SWORD * pswBeta, UWORD uwNum)
+{
+    UWORD uwCt;
+
+    for(uwCt=0;uwCt<uwNum;uwCt++)
+    {
+        pswBeta[uwCt]=sat16((((SLONG)pswU[uwCt]+2*(SLONG)pswV[uwCt])*MATHBATCH_INVSQRT3)>>15);
+        pswAlpha[uwCt]=pswU[uwCt];
+    }
+}
+
+//***************************************************************************
+//
+void ParkBatch16Ref(const SWORD * pswAlpha, const SWORD * pswBeta, const SWORD * pswSin, const SWORD * pswCos, SWORD * pswD, SWORD * pswQ, UWORD uwNum)
+{
+    UWORD uwCt;
+    SLONG slAlpha, slBeta;
+
+    for(uwCt=0;uwCt<uwNum;uwCt++)
+    {
+        slAlpha=pswAlpha[uwCt];
+        slBeta=pswBeta[uwCt];
+        pswD[uwCt]=sat16((slAlpha*pswCos[uwCt]+slBeta*pswSin[uwCt])>>15);
+        pswQ[uwCt]=sat16((slBeta*pswCos[uwCt]-slAlpha*pswSin[uwCt])>>15);
+    }
+}
+
+#if MATHBATCH_NEON
+
+//***************************************************************************
+// NEON helpers: 4 lane table gather with linear interpolation, same integer
+// steps as the scalar lookup (tab[o] + (tab[o+1]-tab[o])*frac >> shift)
+
+#define GATHER4(vDst, puwTab, vIdx) \
+    vDst=vld1_lane_u16(&(puwTab)[vgetq_lane_u32(vIdx, 0)], vDst, 0); \
+    vDst=vld1_lane_u16(&(puwTab)[vgetq_lane_u32(vIdx, 1)], vDst, 1); \
+    vDst=vld1_lane_u16(&(puwTab)[vgetq_lane_u32(vIdx, 2)], vDst, 2); \
+    vDst=vld1_lane_u16(&(puwTab)[vgetq_lane_u32(vIdx, 3)], vDst, 3)
+
+//***************************************************************************
+// Sin16 of 4 angles (lanes hold the 16bit angle)
+static inline int16x4_t sin16x4(uint32x4_t vAngle)
+{
+    uint16x4_t vTab0=vdup_n_u16(0), vTab1=vdup_n_u16(0);
+    uint32x4_t vQuad, vIdx0, vIdx1, vSin;
+    uint32x4_t vNeg;
+    int32x4_t vSSin;
+
+        // 14 bits quadrant angle, mirrored on odd quadrants
+    vNeg=vtstq_u32(vAngle, vdupq_n_u32(0x8000));
+    vQuad=vandq_u32(vAngle, vdupq_n_u32(0x3FFF));
+    vQuad=vbslq_u32(vtstq_u32(vAngle, vdupq_n_u32(0x4000)), vsubq_u32(vdupq_n_u32(0x4000), vQuad), vQuad);
+
+        // table lookup; the next index is clamped at the last entry (frac is 0 there)
+    vIdx0=vshrq_n_u32(vQuad, 7);
+    vIdx1=vminq_u32(vaddq_u32(vIdx0, vdupq_n_u32(1)), vdupq_n_u32(128));
+    GATHER4(vTab0, wTabSine128, vIdx0);
+    GATHER4(vTab1, wTabSine128, vIdx1);
+
+        // interpolation
+    vSin=vmovl_u16(vTab0);
+    vSin=vsraq_n_u32(vSin, vmulq_u32(vsubq_u32(vmovl_u16(vTab1), vSin), vandq_u32(vQuad, vdupq_n_u32(0x7F))), 7);
+
+        // adjust semiplan
+    vSSin=vreinterpretq_s32_u32(vSin);
+    vSSin=vbslq_s32(vNeg, vnegq_s32(vSSin), vSSin);
+    return vmovn_s32(vSSin);
+}
+
+//***************************************************************************
+// ATan16 of 4 sin/cos pairs; none of the inputs may be -32768
+static inline uint16x4_t atan16x4(int16x4_t vSin16, int16x4_t vCos16)
+{
+    uint16x4_t vTab0=vdup_n_u16(0), vTab1=vdup_n_u16(0);
+    int32x4_t vSin, vCos, vRem;
+    uint32x4_t vNegS, vNegC, vAbsS, vAbsC, vOct, vNum, vDen, vTan, vIdx, vAlpha, vBase, vNeg;
+    float32x4_t vDenF, vRcp;
+
+    vSin=vmovl_s16(vSin16);
+    vCos=vmovl_s16(vCos16);
+    vNegS=vcltq_s32(vSin, vdupq_n_s32(0));
+    vNegC=vcltq_s32(vCos, vdupq_n_s32(0));
+    vAbsS=vreinterpretq_u32_s32(vabsq_s32(vSin));
+    vAbsC=vreinterpretq_u32_s32(vabsq_s32(vCos));
+
+        // octant 1 when SIN >= COS: tangent is the smaller over the larger one
+    vOct=vcgeq_u32(vAbsS, vAbsC);
+    vNum=vshlq_n_u32(vbslq_u32(vOct, vAbsC, vAbsS), 16);
+    vDen=vmaxq_u32(vbslq_u32(vOct, vAbsS, vAbsC), vdupq_n_u32(1));
+
+        // quotient through reciprocal estimate (2 Newton steps), then fixed
+        // to the exact integer division with the remainder
+    vDenF=vcvtq_f32_u32(vDen);
+    vRcp=vrecpeq_f32(vDenF);
+    vRcp=vmulq_f32(vrecpsq_f32(vDenF, vRcp), vRcp);
+    vRcp=vmulq_f32(vrecpsq_f32(vDenF, vRcp), vRcp);
+    vTan=vcvtq_u32_f32(vmulq_f32(vcvtq_f32_u32(vNum), vRcp));
+    vRem=vreinterpretq_s32_u32(vsubq_u32(vNum, vmulq_u32(vTan, vDen)));
+    vTan=vaddq_u32(vTan, vcltq_s32(vRem, vdupq_n_s32(0)));
+    vTan=vsubq_u32(vTan, vcgeq_s32(vRem, vreinterpretq_s32_u32(vDen)));
+    vTan=vbslq_u32(vceqq_u32(vAbsS, vAbsC), vdupq_n_u32(0xFFFF), vTan);
+
+        // table lookup with interpolation
+    vIdx=vshrq_n_u32(vTan, 9);
+    GATHER4(vTab0, wTabArcTan128, vIdx);
+    vIdx=vaddq_u32(vIdx, vdupq_n_u32(1));
+    GATHER4(vTab1, wTabArcTan128, vIdx);
+    vAlpha=vmovl_u16(vTab0);
+    vAlpha=vsraq_n_u32(vAlpha, vmulq_u32(vsubq_u32(vmovl_u16(vTab1), vAlpha), vandq_u32(vTan, vdupq_n_u32(0x1FF))), 9);
+
+        // adjust quadrants: quadrant base is 0x0000/0x4000/0x8000/0xC000 and
+        // the angle is added or mirrored (base + 0x3FFF - alpha)
+    vBase=vorrq_u32(vandq_u32(vNegS, vdupq_n_u32(0x8000)), vandq_u32(veorq_u32(vNegS, vNegC), vdupq_n_u32(0x4000)));
+    vNeg=veorq_u32(veorq_u32(vNegS, vNegC), vOct);
+    vAlpha=vbslq_u32(vNeg, vsubq_u32(vaddq_u32(vBase, vdupq_n_u32(0x3FFF)), vAlpha), vaddq_u32(vBase, vAlpha));
+    return vmovn_u32(vAlpha);
+}
+
+#endif // MATHBATCH_NEON
+
+//***************************************************************************
+// Batch kernels
+
+void Sin16Cos16Batch(const UWORD * puwAngle, SWORD * pswSin, SWORD * pswCos, UWORD uwNum)
+{
+    UWORD uwCt=0;
+#if MATHBATCH_NEON
+    uint32x4_t vAngle;
+
+    for(;uwCt+4<=uwNum;uwCt+=4)
+    {
+        vAngle=vmovl_u16(vld1_u16(&puwAngle[uwCt]));
+        vst1_s16(&pswSin[uwCt], sin16x4(vAngle));
+            // Cos16(a) = Sin16(0x4000 - a)
+        vst1_s16(&pswCos[uwCt], sin16x4(vandq_u32(vsubq_u32(vdupq_n_u32(0x4000), vAngle), vdupq_n_u32(0xFFFF))));
+    }
+#endif
+    Sin16Cos16BatchRef(&puwAngle[uwCt], &pswSin[uwCt], &pswCos[uwCt], uwNum-uwCt);
+}
+
+//***************************************************************************
+//
+void ATan16Batch(const SWORD * pswSin, const SWORD * pswCos, UWORD * puwAngle, UWORD uwNum)
+{
+    UWORD uwCt=0;
+#if MATHBATCH_NEON
+    int16x4_t vSin, vCos;
+    uint16x4_t vMin;
+
+    for(;uwCt+4<=uwNum;uwCt+=4)
+    {
+        vSin=vld1_s16(&pswSin[uwCt]);
+        vCos=vld1_s16(&pswCos[uwCt]);
+
+            // -32768 does not survive the absolute value in ATan16; leave
+            // those groups to the scalar code
+        vMin=vorr_u16(vceq_s16(vSin, vdup_n_s16(-32768)), vceq_s16(vCos, vdup_n_s16(-32768)));
+        if(vget_lane_u64(vreinterpret_u64_u16(vMin), 0))
+            ATan16BatchRef(&pswSin[uwCt], &pswCos[uwCt], &puwAngle[uwCt], 4);
+        else
+            vst1_u16(&puwAngle[uwCt], atan16x4(vSin, vCos));
+    }
+#endif
+    ATan16BatchRef(&pswSin[uwCt], &pswCos[uwCt], &puwAngle[uwCt], uwNum-uwCt);
+}
+
+//***************************************************************************
+// CORDIC vectoring, 12 iterations, 8 lanes
+void RootOfSquareSum16Batch(const SWORD * pswX, const SWORD * pswY, SWORD * pswMag, UWORD uwNum)
+{
+    UWORD uwCt=0;
+#if MATHBATCH_NEON
+    int16x8_t vX, vY, vDx, vDy, vShift;
+    uint16x8_t vPos;
+    SWORD swIt;
+
+    for(;uwCt+8<=uwNum;uwCt+=8)
+    {
+        vX=vld1q_s16(&pswX[uwCt]);
+        vY=vld1q_s16(&pswY[uwCt]);
+        for(swIt=0;swIt<12;swIt++)
+        {
+            vShift=vdupq_n_s16(-swIt);
+            vDx=vshlq_s16(vX, vShift);
+            vDy=vshlq_s16(vY, vShift);
+            vPos=vcgtq_s16(vY, vdupq_n_s16(0));
+            vX=vbslq_s16(vPos, vaddq_s16(vX, vDy), vsubq_s16(vX, vDy));
+            vY=vbslq_s16(vPos, vsubq_s16(vY, vDx), vaddq_s16(vY, vDx));
+        }
+        vst1q_s16(&pswMag[uwCt], vX);
+    }
+#endif
+    RootOfSquareSum16BatchRef(&pswX[uwCt], &pswY[uwCt], &pswMag[uwCt], uwNum-uwCt);
+}
+
+//***************************************************************************
+//
+void ClarkeBatch16(const SWORD * pswU, const SWORD * pswV, SWORD * pswAlpha, SWORD * pswBeta, UWORD uwNum)
+{
+    UWORD uwCt=0;
+#if MATHBATCH_NEON
+    int16x8_t vU, vV;
+    int32x4_t vLo, vHi;
+
+    for(;uwCt+8<=uwNum;uwCt+=8)
+    {
+        vU=vld1q_s16(&pswU[uwCt]);
+        vV=vld1q_s16(&pswV[uwCt]);
+        vLo=vaddq_s32(vmovl_s16(vget_low_s16(vU)), vshlq_n_s32(vmovl_s16(vget_low_s16(vV)), 1));
+        vHi=vaddq_s32(vmovl_s16(vget_high_s16(vU)), vshlq_n_s32(vmovl_s16(vget_high_s16(vV)), 1));
+        vLo=vmulq_n_s32(vLo, MATHBATCH_INVSQRT3);
+        vHi=vmulq_n_s32(vHi, MATHBATCH_INVSQRT3);
+        vst1q_s16(&pswBeta[uwCt], vcombine_s16(vqshrn_n_s32(vLo, 15), vqshrn_n_s32(vHi, 15)));
+        vst1q_s16(&pswAlpha[uwCt], vU);
+    }
+#endif
+    ClarkeBatch16Ref(&pswU[uwCt], &pswV[uwCt], &pswAlpha[uwCt], &pswBeta[uwCt], uwNum-uwCt);
+}
+
+//***************************************************************************
+//
+void ParkBatch16(const SWORD * pswAlpha, const SWORD * pswBeta, const SWORD * pswSin, const SWORD * pswCos, SWORD * pswD, SWORD * pswQ, UWORD uwNum)
+{
+    UWORD uwCt=0;
+#if MATHBATCH_NEON
+    int16x4_t vAlpha, vBeta, vSin, vCos;
+    int32x4_t vD, vQ;
+
+    for(;uwCt+4<=uwNum;uwCt+=4)
+    {
+        vAlpha=vld1_s16(&pswAlpha[uwCt]);
+        vBeta=vld1_s16(&pswBeta[uwCt]);
+        vSin=vld1_s16(&pswSin[uwCt]);
+        vCos=vld1_s16(&pswCos[uwCt]);
+        vD=vmlal_s16(vmull_s16(vAlpha, vCos), vBeta, vSin);
+        vQ=vmlsl_s16(vmull_s16(vBeta, vCos), vAlpha, vSin);
+        vst1_s16(&pswD[uwCt], vqshrn_n_s32(vD, 15));
+        vst1_s16(&pswQ[uwCt], vqshrn_n_s32(vQ, 15));
+    }
+#endif
+    ParkBatch16Ref(&pswAlpha[uwCt], &pswBeta[uwCt], &pswSin[uwCt], &pswCos[uwCt], &pswD[uwCt], &pswQ[uwCt], uwNum-uwCt);
+}
@@ -0,0 +1,65 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : MathBatch.h                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Batched sin/cos, atan2, magnitude and Clarke/Park kernels  */
+/*               over arrays of Q15 samples                                 */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _MATHBATCH_H
+#define _MATHBATCH_H
+
+#include "common\CommonDefines.h"
+
+//***************************************************************************
+// NEON usage: enabled when the unit is compiled with -mfpu=neon-vfpv3 (the
+// Vitis build configurations), otherwise the batch calls run the scalar
+// reference. On host _HOSTSIM_NEON builds the NEON kernels over the plain C
+// intrinsics of hostsim\bsp\arm_neon.h, to cross check them
+
+#if defined(__ARM_NEON) || (defined(_HW_HOSTSIM) && defined(_HOSTSIM_NEON))
+ #define MATHBATCH_NEON         1
+#else
+ #define MATHBATCH_NEON         0
+#endif
+
+//***************************************************************************
+// Batch kernels; results are bit-exact with Sin16/Cos16/ATan16 and
+// RootOfSquareSum16 for every sample, so a channel can move to the batch
+// call without changing its output. Input and output arrays must not overlap
+
+void Sin16Cos16Batch(const UWORD * puwAngle, SWORD * pswSin, SWORD * pswCos, UWORD uwNum);
+void ATan16Batch(const SWORD * pswSin, const SWORD * pswCos, UWORD * puwAngle, UWORD uwNum);
+void RootOfSquareSum16Batch(const SWORD * pswX, const SWORD * pswY, SWORD * pswMag, UWORD uwNum);
+
+//***************************************************************************
+// Clarke: two phase currents (u, v) to alpha/beta, balanced system
+//   alpha = u
+//   beta  = (u + 2v) / sqrt(3)
+// Park: alpha/beta to d/q given sin/cos of the electrical angle, which must
+// stay in [-32767, 32767] (as returned by Sin16Cos16Batch)
+//   d = alpha * cos + beta * sin
+//   q = beta * cos - alpha * sin
+// results are saturated to 16bit
+
+#define MATHBATCH_INVSQRT3      18918   // 32768 / sqrt(3)
+
+void ClarkeBatch16(const SWORD * pswU, const SWORD * pswV, SWORD * pswAlpha, SWORD * pswBeta, UWORD uwNum);
+void ParkBatch16(const SWORD * pswAlpha, const SWORD * pswBeta, const SWORD * pswSin, const SWORD * pswCos, SWORD * pswD, SWORD * pswQ, UWORD uwNum);
+
+//***************************************************************************
+// Scalar reference, one sample at a time; always built, used for the tail
+// of the NEON kernels and to cross check them on host
+
+void Sin16Cos16BatchRef(const UWORD * puwAngle, SWORD * pswSin, SWORD * pswCos, UWORD uwNum);
+void ATan16BatchRef(const SWORD * pswSin, const SWORD * pswCos, UWORD * puwAngle, UWORD uwNum);
+void RootOfSquareSum16BatchRef(const SWORD * pswX, const SWORD * pswY, SWORD * pswMag, UWORD uwNum);
+void ClarkeBatch16Ref(const SWORD * pswU, const SWORD * pswV, SWORD * pswAlpha, SWORD * pswBeta, UWORD uwNum);
+void ParkBatch16Ref(const SWORD * pswAlpha, const SWORD * pswBeta, const SWORD * pswSin, const SWORD * pswCos, SWORD * pswD, SWORD * pswQ, UWORD uwNum);
+
+#endif // _MATHBATCH_H
@@ -18,6 +18,7 @@
 
 
 #include "CommonDefines.h"
+#include "MathFunctions.h"
 
 #ifndef _RD
 //#include "AxM-E-Defines.h"
@@ -809,3 +810,84 @@ SWORD RootOfSquareSum16(SWORD swX, SWORD swY)
   }
   return swX ; 
 }
+
+
+/* ######################################################################### */
+/* CORDIC vectoring: angle and magnitude of (COS, SIN) with shifts and adds  */
+/* only, no division and no table other than the 16 micro rotations.        */
+/* Angle accumulates on 32bit (2^32 = 360deg) and is rounded to 16bit;      */
+/* X/Y carry 14 fractional bits. The number of micro rotations is the       */
+/* accuracy grade (see MATH_GRADE_xxx)                                      */
+static const ULONG ulCordicAtanTbl[16] = { 0x20000000, 0x12E4051E, 0x09FB385B, 0x051111D4,
+                                           0x028B0D43, 0x0145D7E1, 0x00A2F61E, 0x00517C55,
+                                           0x0028BE53, 0x00145F2F, 0x000A2F98, 0x000517CC,
+                                           0x00028BE6, 0x000145F3, 0x0000A2FA, 0x0000517D } ;
+
+#define CORDIC_FRACBITS   14
+#define CORDIC_INVGAIN    39797   /* 65536 / 1.6467602 */
+
+void CordicPolar16(SWORD swSIN, SWORD swCOS, UWORD uwGrade, MATH_POLAR * psPolar)
+{
+  SLONG slX, slY, slTmp, slMask ;
+  ULONG ulZ = 0 ;
+  UWORD uwCount ;
+
+  slX = (SLONG)swCOS << CORDIC_FRACBITS ;
+  slY = (SLONG)swSIN << CORDIC_FRACBITS ;
+
+  /* left half plane: pre-rotate by 180deg, CORDIC converges within +-99deg */
+  if (slX < 0)
+  {
+    slX = -slX ;
+    slY = -slY ;
+    ulZ = 0x80000000 ;
+  }
+
+  if (uwGrade > 16)
+    uwGrade = 16 ;
+
+  /* rotation direction as a mask (0 if Y > 0, -1 otherwise) negating the */
+  /* terms: no data dependent branch, the sign of Y is random on vectors   */
+  for (uwCount = 0U; uwCount < uwGrade; uwCount++)
+  {
+    slMask = (slY - 1) >> 31 ;
+    slTmp = slX ;
+    slX += ((slY >> uwCount) ^ slMask) - slMask ;
+    slY -= ((slTmp >> uwCount) ^ slMask) - slMask ;
+    ulZ += (ulCordicAtanTbl[uwCount] ^ (ULONG)slMask) - (ULONG)slMask ;
+  }
+
+  psPolar->uwAngle = (UWORD)((ulZ + 0x8000) >> 16) ;
+
+  /* remove CORDIC gain; magnitude is returned doubled, same scale as CalculateSquareRoot */
+  ulZ = (ULONG)(((ULLNG)slX * CORDIC_INVGAIN + (1UL << (16 + CORDIC_FRACBITS - 2))) >> (16 + CORDIC_FRACBITS - 1)) ;
+  psPolar->uwMagnitude = (ulZ > 0xFFFF) ? 0xFFFF : (UWORD)ulZ ;
+}
+
+
+/* ######################################################################### */
+/* Angle by accuracy grade: MATH_GRADE_LUT keeps the table version          */
+UWORD ATan16Grade(SWORD swSIN, SWORD swCOS, UWORD uwGrade)
+{
+  MATH_POLAR sPolar ;
+
+  if (uwGrade == MATH_GRADE_LUT)
+    return ATan16(swSIN, swCOS) ;
+
+  CordicPolar16(swSIN, swCOS, uwGrade, &sPolar) ;
+  return sPolar.uwAngle ;
+}
+
+
+/* ######################################################################### */
+/* 2 * SQRT(SIN^2+COS^2) by accuracy grade, same scale as CalculateSquareRoot */
+UWORD Magnitude16Grade(SWORD swSIN, SWORD swCOS, UWORD uwGrade)
+{
+  MATH_POLAR sPolar ;
+
+  if (uwGrade == MATH_GRADE_LUT)
+    return CalculateSquareRoot(swSIN, swCOS) ;
+
+  CordicPolar16(swSIN, swCOS, uwGrade, &sPolar) ;
+  return sPolar.uwMagnitude ;
+}
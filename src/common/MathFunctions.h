@@ -7,9 +7,12 @@
 /////////////////////////////////////////////////////////////////////////////
 //
 
+extern UWORD const wTabArcTan128[];
+extern UWORD const wTabSine128[];
+
 UWORD ATan16( SWORD swSIN, SWORD swCOS );
-SWORD Sin16(  SWORD uwAngle );
-SWORD Cos16(  SWORD uwAngle );
+SWORD Sin16(  UWORD uwAngle );
+SWORD Cos16(  UWORD uwAngle );
 
 
 // UWORD  ComputeAngle( SWORD swSIN, SWORD swCOS, SWORD swMode );
@@ -21,4 +24,24 @@ SWORD _ilog2(ULONG ulArgument) ;  /* return the position of the highest bit set
 UWORD _SquareRoot16_4096(ULONG ulValue) ;
 UWORD CalculateSquareRoot(SWORD swSin, SWORD swCos) ;
 SWORD RootOfSquareSum16(SWORD swX, SWORD swY) ; // SQRT(X^2+Y^2)
+
+// Division free angle/magnitude (CORDIC), selectable per call site by grade:
+// the grade is the number of micro rotations, MATH_GRADE_LUT uses the
+// table versions ATan16/CalculateSquareRoot
+#define MATH_GRADE_LUT      0
+// (angle lsb = 360/65536 deg; magnitude error is < 1 lsb on every CORDIC
+// grade, up to 64 lsb with the table; ATan16 error is up to 2.6 lsb)
+#define MATH_GRADE_COARSE   10  // angle error < 21 lsb (0.12deg)
+#define MATH_GRADE_MEDIUM   13  // angle error < 3.1 lsb
+#define MATH_GRADE_FINE     16  // angle error <= 1 lsb
+
+typedef struct
+{
+    UWORD uwAngle;      // as ATan16
+    UWORD uwMagnitude;  // 2 * SQRT(SIN^2+COS^2), as CalculateSquareRoot
+} MATH_POLAR;
+
+void  CordicPolar16(SWORD swSIN, SWORD swCOS, UWORD uwGrade, MATH_POLAR * psPolar) ;
+UWORD ATan16Grade(SWORD swSIN, SWORD swCOS, UWORD uwGrade) ;
+UWORD Magnitude16Grade(SWORD swSIN, SWORD swCOS, UWORD uwGrade) ;
 #endif // _MATH_FUNCTIONS_H
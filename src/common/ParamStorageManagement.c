@@ -26,6 +26,9 @@
 #endif
 #include "common\CommonUtility.h"
 #include "common\FlashManager.h"
+#ifdef _AXX_SYSAPP
+#include "common\FlashQueue.h"
+#endif
 #include <string.h>
 
 //***************************************************************************
@@ -46,6 +49,14 @@ static OS_MUTEX sParMgmMutex;
 
 #define WAIT_FLASHMGR_LOCK          1500            // msec
 
+    // blocks indexed at parameter load and journal save, if more the index
+    // falls back to scanning the storage area (and journal is compacted)
+#define PARMGM_BLKINDEX_ENTRIES     512
+
+    // internal results of journal save, full save required
+#define PARMGM_B_NOJOURNAL          0x10
+#define PARMGM_B_JOURNALFULL        0x11
+
 //***************************************************************************
 // Data structure
 
@@ -68,6 +79,16 @@ static const BLOCKDEFS sParamStorageBlockDefs[]=
 #define PARAMSTORBLOCKCOUNT     (sizeof(sParamStorageBlockDefs)/sizeof(BLOCKDEFS))
 
 static SWORD uwNextWritableParamBlock=-1;
+
+    // index of the parameter block being loaded or journaled
+static BLKSTOR_INDEX sParMgmIndex;
+static BLKSTOR_INDEX_ENTRY sParMgmIndexEntries[PARMGM_BLKINDEX_ENTRIES];
+
+    // last committed signature, its block and first free location after it
+    // where changed parameters are appended (NULL if journal not possible)
+static PARMGM_ENDSIGNATURE sParMgmLastSignature;
+static SWORD swParMgmJournalBlock=-1;
+static HPVOID hpvParMgmJournalPos=NULL;
 #endif
 
 //***************************************************************************
@@ -75,7 +96,11 @@ static SWORD uwNextWritableParamBlock=-1;
 
 static BOOL _addblock(SWORD swCode, HPVOID fpvSrc, UWORD uwSize, HPVOID * ppvDest, ULONG * pulDestSize, UWORD * puwCRC);
 #ifdef _AXX_SYSAPP
+static BOOL _getsource(const PARMGM_LIST * parptr, HPVOID * phpvSrc, UWORD * puwSize);
+static SWORD _par_verify(void);
+static SWORD _par_load(UBYTE ubOption);
 static SWORD _param_save(void);
+static SWORD _param_journal(void);
 #endif
 
 //***************************************************************************
@@ -146,6 +171,36 @@ static BOOL _addblock(SWORD swCode, HPVOID hpvSrc, UWORD uwSize, HPVOID * ppvDes
 }
 
 #ifdef _AXX_SYSAPP
+//***************************************************************************
+// Get source data and size of a parameter to be saved; return FALSE if the
+// parameter must not be saved
+
+static BOOL _getsource(const PARMGM_LIST * parptr, HPVOID * phpvSrc, UWORD * puwSize)
+{
+    if(parptr->uwFlags&PARMGM_F_RESTOREONLY)
+        return FALSE;
+
+    if(parptr->uwFlags&PARMGM_F_PTRSOURCE)
+    {
+            // retrieve data structure that contain pointer and size to data
+        PARMGM_PTRSOURCE  * hpsPtr=(PARMGM_PTRSOURCE *)parptr->hpvData;
+
+            // if NULL ignore and does not save
+        if(hpsPtr->hpvData==NULL)
+            return FALSE;
+
+        *phpvSrc=hpsPtr->hpvData;
+        *puwSize=hpsPtr->uwDataSize;
+    }
+    else
+    {
+        *phpvSrc=parptr->hpvData;
+        *puwSize=parptr->uwDataSize;
+    }
+
+    return TRUE;
+}
+
 //***************************************************************************
 // initialization
 void parmgm_par_init(void)
@@ -179,15 +234,28 @@ void parmgm_par_default(void)
 
 //***************************************************************************
 // find and verify the validity of a parameter block; it set also the
-// right block for next save parameter
+// right block for next save parameter; blocks are read through the linear
+// address space, then flash queue is held off
 
 SWORD parmgm_par_verify(void)
+{
+    SWORD retval;
+
+    FlashQ_ReadLock();
+    retval=_par_verify();
+    FlashQ_ReadUnlock();
+
+    return retval;
+}
+
+static SWORD _par_verify(void)
 {
 	PARMGM_ENDSIGNATURE lendsign, selsign;
     HPVOID storageptr;
     HPVOID blkptr;
+    HPUBYTE crcptr,sgnend;
     ULONG storagesize;
-    UWORD ct;
+    UWORD ct,crcval;
     SWORD retval,blkcode,selsgnblock;
     BOOL crcok;//,crcerrfound=FALSE;
 
@@ -208,6 +276,8 @@ SWORD parmgm_par_verify(void)
         // invalidate signature block and next writable block
     memset(&sParMgmParamSignature,0,sizeof(sParMgmParamSignature));
     uwNextWritableParamBlock=0;
+    memset(&sParMgmLastSignature,0,sizeof(sParMgmLastSignature));
+    hpvParMgmJournalPos=NULL;
 
         // check if all blocks are erased
     for(ct=0; ct<PARAMSTORBLOCKCOUNT; ct++)
@@ -228,6 +298,8 @@ SWORD parmgm_par_verify(void)
     {
         storageptr=sParamStorageBlockDefs[ct].hpvStart;
         storagesize=sParamStorageBlockDefs[ct].ulSize;
+        crcptr=(HPUBYTE)storageptr;
+        crcval=0;
 
             // seek in the block for signature
         while((blkcode=blkstor_enumvalid(&storageptr, &storagesize, &blkptr)) != BLKSTOR_ERR_NOTFOUND)
@@ -237,7 +309,17 @@ SWORD parmgm_par_verify(void)
 
                 blkstor_getdata(blkptr,0,DATACODE_PARAM_ENDSIGNATURE,&lendsign,sizeof(lendsign));
 
-                crcok=(crc16(0, lendsign.hpvBlockStart, lendsign.uwBlockSize)==lendsign.uwBlockCRC);
+                    // journal signatures follow each other in the block, then
+                    // crc is computed incrementally from the previous one
+                sgnend=&((HPUBYTE)lendsign.hpvBlockStart)[lendsign.uwBlockSize];
+                if(lendsign.hpvBlockStart==sParamStorageBlockDefs[ct].hpvStart && sgnend>=crcptr)
+                {
+                    crcval=crc16(crcval, crcptr, (UWORD)(sgnend-crcptr));
+                    crcptr=sgnend;
+                    crcok=(crcval==lendsign.uwBlockCRC);
+                }
+                else
+                    crcok=(crc16(0, lendsign.hpvBlockStart, lendsign.uwBlockSize)==lendsign.uwBlockCRC);
 
 //                if(!crcok)
 //                    crcerrfound=TRUE;
@@ -259,6 +341,15 @@ SWORD parmgm_par_verify(void)
             // write found signature in global parameter
         sParMgmParamSignature=selsign;
 
+            // journal can continue after the signature if the rest of the
+            // block is erased (no interrupted append)
+        sParMgmLastSignature=selsign;
+        swParMgmJournalBlock=selsgnblock;
+        storageptr=&((UBYTE *)selsign.hpvBlockStart)[selsign.uwBlockSize+sizeof(PARMGM_ENDSIGNATURE)+sizeof(BLKSTOR_HEADER)];
+        storagesize=(ULONG)((UBYTE *)sParamStorageBlockDefs[selsgnblock].hpvStart+sParamStorageBlockDefs[selsgnblock].ulSize-(UBYTE *)storageptr);
+        if(ProgramFlashErasedCheck(storageptr, storagesize)==0)
+            hpvParMgmJournalPos=storageptr;
+
             // and select next block as parameter storage
         selsgnblock++;
         uwNextWritableParamBlock=(selsgnblock>=PARAMSTORBLOCKCOUNT?0:selsgnblock);
@@ -272,22 +363,37 @@ SWORD parmgm_par_verify(void)
 
 //***************************************************************************
 // Parameter load; assume global signature initialized by
-// parmgm_par_verify function
+// parmgm_par_verify function; flash queue held off as verify
 
 SWORD parmgm_par_load(UBYTE ubOption)
+{
+    SWORD retval;
+
+    FlashQ_ReadLock();
+    retval=_par_load(ubOption);
+    FlashQ_ReadUnlock();
+
+    return retval;
+}
+
+static SWORD _par_load(UBYTE ubOption)
 {
     HPVOID storageptr=sParMgmParamSignature.hpvBlockStart;
-    HPVOID pfound;
+    HPVOID pfound,pdata,plast;
     ULONG storagesize=(ULONG)sParMgmParamSignature.uwBlockSize;
+    ULONG enumpos=0;
     SWORD blkcode,ct,retval,datasz;
 
         // check pointer/size
     assert(storageptr && storagesize);
 
+        // validate all blocks once, then enumerate them without crc checking
+    blkstor_index_build(&sParMgmIndex, storageptr, storagesize, sParMgmIndexEntries, PARMGM_BLKINDEX_ENTRIES);
+
     for(;;)
     {
             // analyze each valid block between boundaries
-        blkcode=blkstor_enumvalid(&storageptr,&storagesize,&pfound);
+        blkcode=blkstor_index_enum(&sParMgmIndex,&enumpos,&pfound);
 
             // not found, then end of scan
         if(blkcode==BLKSTOR_ERR_NOTFOUND)
@@ -295,6 +401,13 @@ SWORD parmgm_par_load(UBYTE ubOption)
         if(blkcode<0)
             return PARMGM_B_ERROR;
 
+            // skip blocks superseded by a newer one with same code (journal),
+            // then each parameter is loaded once with its last value
+        if(blkstor_index_read(pfound,NULL,0,&pdata)<0)
+            return PARMGM_B_ERROR;
+        if(blkstor_index_getaddr(&sParMgmIndex,blkcode,&plast)>=0 && plast!=pdata)
+            continue;
+
             // seek found block in the global structure
         for(ct=0; ct<uwParMgmGlobalListSize; ct++)
             if(psParMgmGlobalList[ct].uwDataCode==blkcode && !(psParMgmGlobalList[ct].uwFlags&PARMGM_F_STOREONLY) &&
@@ -303,7 +416,7 @@ SWORD parmgm_par_load(UBYTE ubOption)
                 if(!(psParMgmGlobalList[ct].uwFlags&PARMGM_F_CALLBACK))
                 {
                         // retrieve data
-                    retval=blkstor_getdata(pfound,0,blkcode,psParMgmGlobalList[ct].hpvData,(SWORD)psParMgmGlobalList[ct].uwDataSize);
+                    retval=blkstor_index_read(pfound,psParMgmGlobalList[ct].hpvData,(SWORD)psParMgmGlobalList[ct].uwDataSize,NULL);
 
                     if(retval<0)
                         return PARMGM_B_ERROR;
@@ -311,7 +424,7 @@ SWORD parmgm_par_load(UBYTE ubOption)
                 else
                 {
                         // get data address for the callback
-                    retval=blkstor_getaddr(pfound,0,blkcode,&pfound);
+                    retval=blkstor_index_read(pfound,NULL,0,&pfound);
 
                     if(retval<0)
                         return PARMGM_B_ERROR;
@@ -340,13 +453,25 @@ SWORD parmgm_par_load(UBYTE ubOption)
 }
 
 //***************************************************************************
-// Parameter save entry point: it save two time in order to have at least
-// one valid block
+// Parameter save entry point: changed parameters are appended to the
+// actual block if possible, otherwise it save two time in order to have
+// at least one valid block
 
 SWORD parmgm_par_save(void)
 {
     SWORD retval;
 
+        // journal save
+    retval=_param_journal();
+
+        // actual block full, compact in the other one, the actual one keeps
+        // the previous parameters valid
+    if(retval==PARMGM_B_JOURNALFULL)
+        return _param_save();
+
+    if(retval!=PARMGM_B_NOJOURNAL)
+        return retval;
+
         // first time
     retval=_param_save();
     if(retval!=PARMGM_B_OK)
@@ -364,9 +489,9 @@ static SWORD _param_save(void)
 {
 	static PARMGM_ENDSIGNATURE bsign;
     const PARMGM_LIST * parptr;
-    HPVOID storageptr;
+    HPVOID storageptr,hpvSrc;
     ULONG storagesize;
-	UWORD ct,globalcrc=0;
+	UWORD ct,uwSize,globalcrc=0;
     SWORD retval = 1;
 
     assert(uwNextWritableParamBlock>=0 && uwNextWritableParamBlock<PARAMSTORBLOCKCOUNT);
@@ -394,6 +519,9 @@ static SWORD _param_save(void)
     bsign.hpvBlockStart=storageptr=sParamStorageBlockDefs[uwNextWritableParamBlock].hpvStart;
     storagesize=sParamStorageBlockDefs[uwNextWritableParamBlock].ulSize;
 
+        // journal no more valid until the new signature is written
+    hpvParMgmJournalPos=NULL;
+
         // erase all block
     if(ProgramFlashErase(storageptr, storagesize))
     {
@@ -410,23 +538,9 @@ static SWORD _param_save(void)
 
         // add all param blocks to storage (but the ones with RESTOREONLY flag)
     for(ct=0,parptr=psParMgmGlobalList; ct<uwParMgmGlobalListSize; ct++,parptr++)
-        if(!(parptr->uwFlags&PARMGM_F_RESTOREONLY))
+        if(_getsource(parptr, &hpvSrc, &uwSize))
         {
-            if(parptr->uwFlags&PARMGM_F_PTRSOURCE)
-            {
-                    // retrieve data structure that contain pointer and size to data
-                PARMGM_PTRSOURCE  * hpsPtr=(PARMGM_PTRSOURCE *)parptr->hpvData;
-
-                    // if NULL ignore and does not save
-                if(hpsPtr->hpvData!=NULL)
-                    retval=_addblock(parptr->uwDataCode, hpsPtr->hpvData, hpsPtr->uwDataSize, &storageptr, &storagesize, &globalcrc);
-                else
-                    retval=FALSE;
-            }
-            else
-                retval=_addblock(parptr->uwDataCode, parptr->hpvData, parptr->uwDataSize, &storageptr, &storagesize, &globalcrc);
-
-            if(retval)
+            if(_addblock(parptr->uwDataCode, hpvSrc, uwSize, &storageptr, &storagesize, &globalcrc))
             {
                     // unlock flash manager and return
                 FlashMgrEnd(NULL);
@@ -443,6 +557,10 @@ static SWORD _param_save(void)
     bsign.uwBlockCRC=globalcrc;
     bsign.ulTimeStamp=ulSysTimersTotalPowerOnTime;
 
+        // always newer than last committed one, as verify select the newer
+    if(bsign.ulTimeStamp<=sParMgmLastSignature.ulTimeStamp)
+        bsign.ulTimeStamp=sParMgmLastSignature.ulTimeStamp+1;
+
         // write signature
     if(_addblock(DATACODE_PARAM_ENDSIGNATURE, &bsign, sizeof(bsign), &storageptr, &storagesize, &globalcrc))
     {
@@ -452,8 +570,17 @@ static SWORD _param_save(void)
         goto exit_on_error;
     }
 
-        // unlock flash manager
-    FlashMgrEnd(NULL);
+        // unlock flash manager, cached data are programmed here
+    if(FlashMgrEnd(NULL)!=FLASHMGR_R_OK)
+    {
+        retval=PARMGM_B_ERROR;
+        goto exit_on_error;
+    }
+
+        // next changes are appended after the signature
+    sParMgmLastSignature=bsign;
+    swParMgmJournalBlock=uwNextWritableParamBlock;
+    hpvParMgmJournalPos=storageptr;
 
         // select next block as parameter storage
     uwNextWritableParamBlock=(uwNextWritableParamBlock+1>=PARAMSTORBLOCKCOUNT?0:uwNextWritableParamBlock+1);
@@ -470,6 +597,175 @@ exit_on_error:
     return retval;
 }
 
+//***************************************************************************
+// Parameter journal save: only parameters changed from the last committed
+// values are appended after the last signature of the actual block, then a
+// new signature covering the whole block is written; the new signature is
+// the commit, so an interrupted append leaves the previous one valid and
+// verify/load work as for a full saved block
+
+static SWORD _param_journal(void)
+{
+	static PARMGM_ENDSIGNATURE bsign;
+    const PARMGM_LIST * parptr;
+    HPVOID storageptr,hpvSrc,hpvStored;
+    HPUBYTE hpubStart,hpubSign;
+    ULONG storagesize;
+	UWORD ct,uwSize,globalcrc;
+    SWORD retval;
+    BOOL changed=FALSE,same;
+
+        // if diagnostic mode detected prevent parameters saving in order
+        // to preserve user application parameters
+    if(uwSystemEnterDiagnostic==SYSTEM_ENTERDIAGNOSTIC_KEY)
+        return PARMGM_B_OK;
+
+        // get exclusive access to local module
+    retval=Os_MutexWait(&sParMgmMutex, WAIT_FLASHMGR_LOCK);
+
+    if(retval==OS_MUTEXWAIT_TIMEOUT)
+        return PARMGM_B_LOCKFAILED;
+
+    assert(retval==OS_MUTEXWAIT_SIGNALED);
+
+        // journal only on a block saved by the same application version,
+        // otherwise parameters layout could be different
+    if(hpvParMgmJournalPos==NULL ||
+        sParMgmLastSignature.uwApplicatType!=sSysAppInfo.uwApplicatType ||
+        sParMgmLastSignature.uwVersionMajor!=sSysAppInfo.uwVersionMajor ||
+        sParMgmLastSignature.uwVersionMinor!=sSysAppInfo.uwVersionMinor)
+    {
+        Os_MutexSignal(&sParMgmMutex);
+        return PARMGM_B_NOJOURNAL;
+    }
+
+        // now signal parameter flash writing in progress
+    bSysStatParametersSaving=1;
+
+    hpubStart=(HPUBYTE)sParMgmLastSignature.hpvBlockStart;
+    hpubSign=&hpubStart[sParMgmLastSignature.uwBlockSize];
+    storageptr=hpvParMgmJournalPos;
+    storagesize=(ULONG)((HPUBYTE)sParamStorageBlockDefs[swParMgmJournalBlock].hpvStart+sParamStorageBlockDefs[swParMgmJournalBlock].ulSize-(HPUBYTE)storageptr);
+
+        // index last values of the committed area, too many blocks then
+        // compact; committed area is read with flash queue held off
+    FlashQ_ReadLock();
+    if(blkstor_index_build(&sParMgmIndex, hpubStart, (ULONG)((HPUBYTE)storageptr-hpubStart), sParMgmIndexEntries, PARMGM_BLKINDEX_ENTRIES)<0)
+    {
+        FlashQ_ReadUnlock();
+        retval=PARMGM_B_JOURNALFULL;
+        goto exit_on_error;
+    }
+
+        // continue the crc of the committed area with its last signature
+    globalcrc=crc16(sParMgmLastSignature.uwBlockCRC, hpubSign, (UWORD)((HPUBYTE)storageptr-hpubSign));
+    FlashQ_ReadUnlock();
+
+            // lock flash manager
+    if(FlashMgrBegin(WAIT_FLASHMGR_LOCK)==FLASHMGR_R_LOCKFAILED)
+    {
+        retval=PARMGM_B_LOCKFAILED;
+        goto exit_on_error;
+    }
+
+        // add only changed param blocks (but the ones with RESTOREONLY flag)
+    for(ct=0,parptr=psParMgmGlobalList; ct<uwParMgmGlobalListSize; ct++,parptr++)
+        if(_getsource(parptr, &hpvSrc, &uwSize))
+        {
+                // same as last stored, nothing to do; lock only the
+                // compare, appends are queued and waited
+            FlashQ_ReadLock();
+            same=blkstor_index_getaddr(&sParMgmIndex, parptr->uwDataCode, &hpvStored)==(SWORD)uwSize &&
+                memcmp(hpvStored, hpvSrc, uwSize)==0;
+            FlashQ_ReadUnlock();
+            if(same)
+                continue;
+
+                // block and new signature must fit, otherwise compact
+            if(storagesize <= 2*(ULONG)sizeof(BLKSTOR_HEADER)+uwSize+sizeof(bsign) ||
+                (ULONG)((HPUBYTE)storageptr-hpubStart)+sizeof(BLKSTOR_HEADER)+uwSize > 0xFFFFl)
+            {
+                FlashMgrEnd(NULL);
+                hpvParMgmJournalPos=NULL;
+                retval=PARMGM_B_JOURNALFULL;
+                goto exit_on_error;
+            }
+
+            if(_addblock(parptr->uwDataCode, hpvSrc, uwSize, &storageptr, &storagesize, &globalcrc))
+            {
+                    // unlock flash manager and return
+                FlashMgrEnd(NULL);
+                hpvParMgmJournalPos=NULL;
+                retval=PARMGM_B_NOJOURNAL;
+                goto exit_on_error;
+            }
+
+            changed=TRUE;
+        }
+
+        // nothing changed, last signature still valid
+    if(!changed)
+    {
+        FlashMgrEnd(NULL);
+        retval=PARMGM_B_OK;
+        goto exit_on_error;
+    }
+
+        // fillup signature data structure
+    bsign=sParMgmLastSignature;
+    bsign.uwBlockSize=(UWORD)((HPUBYTE)storageptr-hpubStart);
+    bsign.uwBlockCRC=globalcrc;
+    bsign.ulTimeStamp=ulSysTimersTotalPowerOnTime;
+
+        // always newer than last committed one, as verify select the newer
+    if(bsign.ulTimeStamp<=sParMgmLastSignature.ulTimeStamp)
+        bsign.ulTimeStamp=sParMgmLastSignature.ulTimeStamp+1;
+
+        // write signature
+    if(_addblock(DATACODE_PARAM_ENDSIGNATURE, &bsign, sizeof(bsign), &storageptr, &storagesize, &globalcrc))
+    {
+            // unlock flash manager and return
+        FlashMgrEnd(NULL);
+        hpvParMgmJournalPos=NULL;
+        retval=PARMGM_B_NOJOURNAL;
+        goto exit_on_error;
+    }
+
+        // unlock flash manager, cached data are programmed here
+    if(FlashMgrEnd(NULL)!=FLASHMGR_R_OK)
+    {
+        hpvParMgmJournalPos=NULL;
+        retval=PARMGM_B_NOJOURNAL;
+        goto exit_on_error;
+    }
+
+        // read back appended data and new signature, if wrong then full save
+    FlashQ_ReadLock();
+    same=crc16(sParMgmLastSignature.uwBlockCRC, hpubSign, (UWORD)((HPUBYTE)storageptr-hpubSign))==globalcrc;
+    FlashQ_ReadUnlock();
+    if(!same)
+    {
+        hpvParMgmJournalPos=NULL;
+        retval=PARMGM_B_NOJOURNAL;
+        goto exit_on_error;
+    }
+
+        // next changes are appended after the new signature
+    sParMgmLastSignature=bsign;
+    hpvParMgmJournalPos=storageptr;
+
+    retval=PARMGM_B_OK;
+
+exit_on_error:
+        // reset parameter flash writing in progress
+    bSysStatParametersSaving=0;
+
+        // release local module
+    Os_MutexSignal(&sParMgmMutex);
+
+    return retval;
+}
+
 //***************************************************************************
 // restore default parameters (erase all)
 
@@ -497,6 +793,8 @@ SWORD parmgm_par_restore(void)
         // invalidate signature block and next writable block
     memset(&sParMgmParamSignature,0,sizeof(sParMgmParamSignature));
     uwNextWritableParamBlock=0;
+    memset(&sParMgmLastSignature,0,sizeof(sParMgmLastSignature));
+    hpvParMgmJournalPos=NULL;
 
     retval=PARMGM_B_OK;
 
@@ -15,6 +15,9 @@
 
 #include "common\CommonTypedef.h"
 #include "ProgramFlashHandler.h"
+#ifdef _AXX_SYSAPP
+#include "common\FlashQueue.h"
+#endif
 
 /////////////////////////////////////////////////////////////////////////////
 // Critical sections (if required)
@@ -101,9 +104,7 @@ int ProgramFlashLoadWritePage( unsigned long adr, unsigned char * buf, unsigned
   if ( adr + len > pag + PROGRAMFLASH_PAGE_SIZE )
     return 1;
 
-  FlashWrite(adr, buf, len);
-
-  return 0;
+  return ProgramFlashWrite( (void *)adr, buf, len );
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -207,11 +208,33 @@ int ProgramFlashLoadWritePage( unsigned long adr, unsigned char * buf, unsigned
 //    Parameter:      addr:  Start Address
 //                    len :  Length
 //    Return Value:   0 - OK,  1 - Failed
+//    The application queues the erase and waits yielding, interrupts and
+//    other tasks keep running while the device is busy
 //
 
 int ProgramFlashErase( void * addr, unsigned long len )
 {
+#ifdef _AXX_SYSAPP
+    ULONG ulTicket;
+
+        // power fail save, see ProgramFlashWrite()
+    if(bProgramFlashCritSectBypass)
+    {
+        while(FlashBusy());
+        FlashCmdFailed();
+        FlashErase((u32)(UINTPTR)addr, len);
+        return FlashCmdFailed() ? 1 : 0;
+    }
+
+    if(len==0)
+        return 0;
+    if(FlashQ_Erase((ULONG)addr, len, NULL, NULL, &ulTicket)!=FLASHQ_R_OK)
+        return 1;
+    if(FlashQ_Wait(ulTicket)!=FLASHQ_R_OK)
+        return 1;
+#else
     FlashErase(addr, len);
+#endif
     return 0;
 }
 
@@ -222,11 +245,32 @@ int ProgramFlashErase( void * addr, unsigned long len )
 //                    buf :  Data Bytes
 //                    len :  Length
 //    Return Value:   0 - OK,  1 - Failed
+//    Queued as the erase in the application
 //
 
 int ProgramFlashWrite( void * addr, void * buf, unsigned long len )
 {
+#ifdef _AXX_SYSAPP
+    ULONG ulTicket;
+
+        // power fail save, the queue could be interrupted: wait the
+        // command in progress and program directly; device error flags
+        // are sticky, cleared before and checked after the whole write
+    if(bProgramFlashCritSectBypass)
+    {
+        while(FlashBusy());
+        FlashCmdFailed();
+        FlashWrite((u32)(UINTPTR)addr, buf, len);
+        return FlashCmdFailed() ? 1 : 0;
+    }
+
+    if(FlashQ_Write((ULONG)addr, buf, len, NULL, NULL, &ulTicket)!=FLASHQ_R_OK)
+        return 1;
+    if(FlashQ_Wait(ulTicket)!=FLASHQ_R_OK)
+        return 1;
+#else
     FlashWrite(addr, buf, len);
+#endif
     return 0;
 }
 
@@ -0,0 +1,67 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : Snapshot.c                                                 */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Coherent snapshots of data published by the                */
+/*               realtime task                                              */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\Snapshot.h"
+#include "common\TaskScheduler.h"
+
+/////////////////////////////////////////////////////////////////////////////
+// Compiler Option
+
+#pragma GCC optimize (2)
+
+//***************************************************************************
+// Globals
+
+ATOMIC_SEQLOCK sSnapshotRT={0ul};
+
+//***************************************************************************
+// Reader start: realtime context reads directly
+
+ULONG Snapshot_RTReadBegin(void)
+{
+    if(bTaskSchedRealTimeRunning)
+        return 0ul;
+
+    return seqlock_read_begin(&sSnapshotRT);
+}
+
+//***************************************************************************
+// Reader end: repeat if a tick ran during the read, up to max attempts
+
+BOOL Snapshot_RTReadRetry(ULONG ulSeq, UWORD * puwRetry)
+{
+    if(bTaskSchedRealTimeRunning)
+        return FALSE;
+
+    if(!seqlock_read_retry(&sSnapshotRT, ulSeq))
+        return FALSE;
+
+    return (BOOL)(++(*puwRetry)<ATOMIC_SEQLOCK_RETRIES);
+}
+
+//***************************************************************************
+// Coherent copy
+
+BOOL Snapshot_RTRead(void * pvDst, const void * pvSrc, ULONG ulSize)
+{
+    if(bTaskSchedRealTimeRunning)
+    {
+        memcpy(pvDst, pvSrc, ulSize);
+        return TRUE;
+    }
+
+    return seqlock_read(&sSnapshotRT, pvDst, pvSrc, ulSize);
+}
@@ -0,0 +1,68 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : Snapshot.h                                                 */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Coherent snapshots of data published by the                */
+/*               realtime task                                              */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include "common\CommonDefines.h"
+#include "common\Atomics.h"
+
+//***************************************************************************
+// Usage
+//
+// The realtime scheduler publishes all realtime outputs at once: the tick
+// sequence is odd while the realtime tasks run, even in between. Background
+// readers (SDO, Modbus, tools) copy realtime data, or run a side effect free
+// computation on it, and repeat if a tick started meanwhile; the realtime
+// task is never blocked nor delayed and no interrupt is masked.
+//
+// Copy:        Snapshot_RTRead(&sLocal, &sRTOut, sizeof(sRTOut));
+// Computation: do { s=Snapshot_RTReadBegin(); compute; } while(Snapshot_RTReadRetry(s, &uwRetry));
+//
+// From the realtime task itself (or from an interrupt preempting it) data
+// is already coherent, or cannot be made so, and is read once.
+
+//***************************************************************************
+// Globals
+
+    // realtime tick sequence
+extern ATOMIC_SEQLOCK sSnapshotRT;
+
+//***************************************************************************
+// Publisher, realtime scheduler only: bounds of the realtime tick
+
+static inline void Snapshot_RTPublishBegin(void)
+{
+    seqlock_write_begin(&sSnapshotRT);
+}
+
+static inline void Snapshot_RTPublishEnd(void)
+{
+    seqlock_write_end(&sSnapshotRT);
+}
+
+//***************************************************************************
+// Reader: tick sequence at start, then TRUE from retry if the read must be
+// repeated; *puwRetry (zeroed by the caller) bounds the attempts to
+// ATOMIC_SEQLOCK_RETRIES
+
+ULONG Snapshot_RTReadBegin(void);
+BOOL Snapshot_RTReadRetry(ULONG ulSeq, UWORD * puwRetry);
+
+//***************************************************************************
+// Reader: coherent copy of realtime data, FALSE if it could not be got
+// coherent (pvDst holds the last attempt)
+
+BOOL Snapshot_RTRead(void * pvDst, const void * pvSrc, ULONG ulSize);
+
+#endif
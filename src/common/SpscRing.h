@@ -0,0 +1,223 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : SpscRing.h                                                 */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Wait-free single producer/single consumer rings and        */
+/*               event counters, header only                                */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _SPSCRING_H
+#define _SPSCRING_H
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+
+//***************************************************************************
+// Usage
+//
+// One context only pushes (producer), one context only pops (consumer): e.g.
+// realtime task and a background task, an interrupt and the realtime task,
+// CPU0 and CPU1. No interrupt disabling and no locked instruction is needed,
+// each index is written by one side only. Indexes are free running, slots
+// count must be a power of 2 and all slots are usable.
+//
+// Producer:   p=spscring_reserve(&r); if(p) { fill *p; spscring_commit(&r); }
+// Consumer:   p=spscring_peek(&r);    if(p) { use *p;  spscring_release(&r); }
+
+//***************************************************************************
+// Configuration
+
+    // L1/L2 cache line size of Cortex-A9
+#define SPSCRING_CACHE_LINE             32
+
+//***************************************************************************
+// Memory barrier: slot contents are visible before the index publishing
+// them, and slot reads are done before the index releasing them
+
+#ifdef _HW_HOSTSIM
+    // ordering of the slot accesses against the indexes is all that is
+    // needed, no full fence: only a compiler barrier on x86 hosts
+#define SPSCRING_BARRIER()              __atomic_thread_fence(__ATOMIC_ACQ_REL)
+#else
+#define SPSCRING_BARRIER()              __asm__ __volatile__ ("dmb" ::: "memory")
+#endif
+
+//***************************************************************************
+// Structures
+
+    // Ring; read only part, producer index and consumer index each on its
+    // own cache line, so the two sides never write the same line. Each side
+    // keeps a copy of the other side index, reloaded only when the ring
+    // looks full/empty
+typedef struct
+{
+    HPUBYTE         hpubData;                   // slot storage
+    ULONG           ulMask;                     // no. of slots-1
+    ULONG           ulSlotSize;                 // slot size in bytes
+    UBYTE           ubPad0[SPSCRING_CACHE_LINE-sizeof(HPUBYTE)-2*sizeof(ULONG)];
+
+    volatile ULONG  ulHead;                     // next slot to write, producer only
+    ULONG           ulTailCache;                // consumer index as last seen by producer
+    UBYTE           ubPad1[SPSCRING_CACHE_LINE-2*sizeof(ULONG)];
+
+    volatile ULONG  ulTail;                     // next slot to read, consumer only
+    ULONG           ulHeadCache;                // producer index as last seen by consumer
+    UBYTE           ubPad2[SPSCRING_CACHE_LINE-2*sizeof(ULONG)];
+} __attribute__((aligned(SPSCRING_CACHE_LINE))) SPSCRING;
+
+    // Event counter, the degenerate ring without payload: producer counts
+    // posted events, consumer the taken ones, pending if different. Replaces
+    // a flag set by one context and cleared by another, that would need an
+    // atomic read-modify-write
+typedef struct
+{
+    volatile UBYTE  ubPosted;                   // producer only
+    volatile UBYTE  ubTaken;                    // consumer only
+} SPSCEVENT;
+
+//***************************************************************************
+// Init, before both sides are running; ulSlots power of 2
+
+static inline void spscring_init(SPSCRING * psRing, void * pvData, ULONG ulSlots, ULONG ulSlotSize)
+{
+    memset(psRing, 0, sizeof(SPSCRING));
+    psRing->hpubData=(HPUBYTE)pvData;
+    psRing->ulMask=ulSlots-1;
+    psRing->ulSlotSize=ulSlotSize;
+    SPSCRING_BARRIER();
+}
+
+//***************************************************************************
+// Producer: get free slot to fill in place, NULL if full
+
+static inline void * spscring_reserve(SPSCRING * psRing)
+{
+    ULONG ulHead=psRing->ulHead;
+
+    if(ulHead-psRing->ulTailCache>psRing->ulMask)
+    {
+        psRing->ulTailCache=psRing->ulTail;
+        if(ulHead-psRing->ulTailCache>psRing->ulMask)
+            return NULL;
+    }
+
+    return &psRing->hpubData[(ulHead&psRing->ulMask)*psRing->ulSlotSize];
+}
+
+//***************************************************************************
+// Producer: publish slot got by spscring_reserve
+
+static inline void spscring_commit(SPSCRING * psRing)
+{
+    SPSCRING_BARRIER();
+    psRing->ulHead=psRing->ulHead+1;
+}
+
+//***************************************************************************
+// Producer: copy element into the ring, FALSE if full
+
+static inline BOOL spscring_push(SPSCRING * psRing, const void * pvSrc)
+{
+    void * pvSlot=spscring_reserve(psRing);
+
+    if(pvSlot==NULL)
+        return FALSE;
+
+    memcpy(pvSlot, pvSrc, psRing->ulSlotSize);
+    spscring_commit(psRing);
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Consumer: get oldest slot to use in place, NULL if empty
+
+static inline void * spscring_peek(SPSCRING * psRing)
+{
+    ULONG ulTail=psRing->ulTail;
+
+    if(ulTail==psRing->ulHeadCache)
+    {
+        psRing->ulHeadCache=psRing->ulHead;
+        if(ulTail==psRing->ulHeadCache)
+            return NULL;
+
+            // slot contents not read before index
+        SPSCRING_BARRIER();
+    }
+
+    return &psRing->hpubData[(ulTail&psRing->ulMask)*psRing->ulSlotSize];
+}
+
+//***************************************************************************
+// Consumer: give back slot got by spscring_peek
+
+static inline void spscring_release(SPSCRING * psRing)
+{
+    SPSCRING_BARRIER();
+    psRing->ulTail=psRing->ulTail+1;
+}
+
+//***************************************************************************
+// Consumer: copy out oldest element, FALSE if empty
+
+static inline BOOL spscring_pop(SPSCRING * psRing, void * pvDst)
+{
+    void * pvSlot=spscring_peek(psRing);
+
+    if(pvSlot==NULL)
+        return FALSE;
+
+    memcpy(pvDst, pvSlot, psRing->ulSlotSize);
+    spscring_release(psRing);
+
+    return TRUE;
+}
+
+//***************************************************************************
+// No. of elements in the ring, exact only from one of the two sides
+
+static inline ULONG spscring_count(const SPSCRING * psRing)
+{
+    return psRing->ulHead-psRing->ulTail;
+}
+
+//***************************************************************************
+// Event counter init, from consumer side with producer not running
+
+static inline void spscevent_init(SPSCEVENT * psEvent, BOOL bPending)
+{
+    psEvent->ubTaken=psEvent->ubPosted-(bPending ? 1 : 0);
+}
+
+//***************************************************************************
+// Event counter, producer: post event
+
+static inline void spscevent_post(SPSCEVENT * psEvent)
+{
+    psEvent->ubPosted=psEvent->ubPosted+1;
+}
+
+//***************************************************************************
+// Event counter, consumer: TRUE if at least one event posted since last
+// taken, all pending ones are taken together
+
+static inline BOOL spscevent_take(SPSCEVENT * psEvent)
+{
+    UBYTE ubPosted=psEvent->ubPosted;
+
+    if(ubPosted==psEvent->ubTaken)
+        return FALSE;
+
+    psEvent->ubTaken=ubPosted;
+
+    return TRUE;
+}
+
+#endif
@@ -11,6 +11,8 @@
 /*               realtime)                                                  */
 /*                                                                          */
 /****************************************************************************/
+#include <string.h>
+
 #include "common\CommonDefines.h"
 #include "system\SystemStatus.h"
 
@@ -23,6 +25,8 @@
 #include "common\CommonUtility.h"
 //#include "FatalErrorCodes.h"
 #include "drive\HardwareConfig.h"
+#include "system\SysAppConfig.h"
+#include "common\AmpMailbox.h"
 
 // Compiler Option
 #if defined(_CRS_DBG)
@@ -40,17 +44,32 @@
 // Local prototypes;
 
 static void TaskListNulls(void);
+static UWORD gcd(UWORD, UWORD);
+static BOOL bkgadd(void (*)(void), BOOL (*)(ULONG), UWORD, UWORD, ULONG, UWORD);
+static BOOL bkgrun(TASKSCHEDULER_BKG_SCHEDULER_ENTRY *);
+static void bkgpoll(UWORD, UWORD, TASKSCHEDULER_BKG_SCHEDULER_ENTRY *);
+static void bkgrunclass(UWORD, UWORD);
+static void bkgloopstart(UWORD);
+static void bkgloopend(UWORD);
 
 //***************************************************************************
 // Defines
 
 #define RT_AVG_CALC_NSAMPLES            1024
 
+    // slot period, usec
+#define RT_SLOT_USEC                    (1000000/REALTIME_TASK_FREQ)
+
 //***************************************************************************
 // Locals
 
-    // Background task list, ends with NULL
-static void (* ppfBackgroundList[TASKSCHEDULER_BACKGROUND_MAX_ENTRIES])(void);
+    // Background task list, valid up to no. of entries
+static TASKSCHEDULER_BKG_SCHEDULER_ENTRY sBkgList[TASKSCHEDULER_BACKGROUND_MAX_ENTRIES];
+static volatile UWORD uwBkgEntries;
+static volatile BOOL bBkgStatsReset[TASKSCHEDULER_BKG_CPUS];
+    // free timer at last high priority class poll and loop start, per core
+static UWORD uwBkgPollTimer[TASKSCHEDULER_BKG_CPUS];
+static UWORD uwBkgLoopStart[TASKSCHEDULER_BKG_CPUS];
 
 static UWORD uwRTAvgCalcTimer;
 static UWORD uwRTAvgCalcPrevTimer;
@@ -61,6 +80,7 @@ UWORD uwTaskSchedStatus;
 
 volatile UWORD uwTaskSchedFreeTimer;
 UWORD uwTaskSchedRTMaxTime;
+volatile UWORD uwTaskSchedRTIsrNesting;
 volatile UWORD uwTaskSchedRTLocalMaxTime;
 volatile UWORD uwTaskSchedRTLocalAvgTime;
 
@@ -69,6 +89,31 @@ TASKSCHEDULER_RT_SCHEDULER_ENTRY  tTaskSchedRTList[TASKSCHEDULER_RT_MAX_ENTRIES]
 
 volatile ULONG ulTaskSchedRTLocalTimeSum;
 
+volatile BOOL bTaskSchedRTStatsReset;
+
+volatile UWORD uwTaskSchedRTListGen;
+
+volatile UWORD uwTaskSchedBkgLoopTime[TASKSCHEDULER_BKG_CPUS];
+volatile UWORD uwTaskSchedBkgLoopMaxTime[TASKSCHEDULER_BKG_CPUS];
+
+// Realtime trace ring, out of .bss in order to pass-through reset
+TASKSCHEDULER_RT_TRACE sTaskSchedRTTrace __attribute__((section(".noinit_section")));
+
+// Realtime rate groups; 8kHz group is the slot task list itself, the others
+// run after it within own budget: phases are chosen so that no two groups
+// are due in the same slot, standard time plus budget within max time
+const TASKSCHEDULER_RATE_DEF sTaskSchedRateDefs[TASKSCHEDULER_RATE_GROUPS]=
+{
+        // # slots, phase, budget, deadline, priority
+    {1,  0, TASKSCHEDULER_RT_STD_EXECUTION_TIME, 0, 0},     // 8kHz
+    {2,  0, 40,  1, 1},                                     // 4kHz
+    {8,  1, 60,  4, 2},                                     // 1kHz
+    {64, 3, 100, 32, 3},                                    // 125Hz
+};
+
+TASKSCHEDULER_RATE_GROUP sTaskSchedRateGroup[TASKSCHEDULER_RATE_GROUPS];
+UBYTE ubTaskSchedRateOrder[TASKSCHEDULER_RATE_GROUPS];
+
 //***************************************************************************
 // Nulls all RT and Background task lists
 
@@ -78,9 +123,9 @@ static void TaskListNulls(void)
 
     for(i=0;i<TASKSCHEDULER_RT_MAX_ENTRIES;i++)
         tTaskSchedRTList[i].pfTask=NULL;
+    uwTaskSchedRTListGen++;
 
-    for(i=0;i<TASKSCHEDULER_BACKGROUND_MAX_ENTRIES;i++)
-        ppfBackgroundList[i]=NULL;
+    uwBkgEntries=0;
 }
 
 //***************************************************************************
@@ -88,6 +133,8 @@ static void TaskListNulls(void)
 
 BOOL TaskSched_Init(void)
 {
+    UWORD i,j;
+
     TaskListNulls();
 
     uwTaskSchedStatus=0;
@@ -95,6 +142,34 @@ BOOL TaskSched_Init(void)
     uwTaskSchedRTLocalMaxTime=0;
     uwRTAvgCalcPrevTimer=uwTaskSchedFreeTimer=0;
     uwRTAvgCalcTimer=timer_settimeout(uwTaskSchedFreeTimer,RT_AVG_CALC_NSAMPLES);
+    bTaskSchedRTStatsReset=FALSE;
+    for(i=0;i<TASKSCHEDULER_BKG_CPUS;i++)
+    {
+        bBkgStatsReset[i]=FALSE;
+        uwTaskSchedBkgLoopTime[i]=uwTaskSchedBkgLoopMaxTime[i]=0;
+    }
+
+        // rate groups start at their phase, execution order by priority
+    for(i=0;i<TASKSCHEDULER_RATE_GROUPS;i++)
+    {
+        memset(&sTaskSchedRateGroup[i], 0, sizeof(TASKSCHEDULER_RATE_GROUP));
+        sTaskSchedRateGroup[i].uwSlotCnt=sTaskSchedRateDefs[i].uwPhase+1;
+        sTaskSchedRateGroup[i].sStats.uwMinTime=0xFFFF;
+        for(j=i;j>0 && sTaskSchedRateDefs[ubTaskSchedRateOrder[j-1]].ubPriority>sTaskSchedRateDefs[i].ubPriority;j--)
+            ubTaskSchedRateOrder[j]=ubTaskSchedRateOrder[j-1];
+        ubTaskSchedRateOrder[j]=(UBYTE)i;
+    }
+
+        // keep a frozen trace across reset, otherwise restart it
+    if(sTaskSchedRTTrace.ulMagic!=TASKSCHEDULER_RT_TRACE_MAGIC || sTaskSchedRTTrace.ulMagicInv!=(ULONG)~TASKSCHEDULER_RT_TRACE_MAGIC ||
+       sTaskSchedRTTrace.uwReason>TASKSCHEDULER_RT_TRACE_PLCOVERTIME)
+    {
+        memset(&sTaskSchedRTTrace, 0, sizeof(sTaskSchedRTTrace));
+        sTaskSchedRTTrace.ulMagic=TASKSCHEDULER_RT_TRACE_MAGIC;
+        sTaskSchedRTTrace.ulMagicInv=(ULONG)~TASKSCHEDULER_RT_TRACE_MAGIC;
+    }
+    else if(sTaskSchedRTTrace.uwReason==TASKSCHEDULER_RT_TRACE_RUNNING)
+        sTaskSchedRTTrace.ulHead=0;
 
 #ifndef _APP_XC
     if(sGlbControlBoardParameters.sProductInfo.uwProductRev<200)
@@ -207,8 +282,16 @@ BOOL TaskSched_AddRTTaskEx(BOOL (* pfTask)(ULONG), UBYTE ubFlags, SYSTEMSTATUS u
             tTaskSchedRTList[i].uStatusMask=uStatusMask;
             tTaskSchedRTList[i].uwNSlots=uwNSlots;
             tTaskSchedRTList[i].uwSlotCnt=1;
+            tTaskSchedRTList[i].uwSlotDelay=0;
+            tTaskSchedRTList[i].uwDeferred=0;
+            tTaskSchedRTList[i].ubRate=TASKSCHEDULER_RATE_8KHZ;
             tTaskSchedRTList[i].pfTask=pfTask;
             tTaskSchedRTList[i].uwArg=uwArg;
+            memset(&tTaskSchedRTList[i].sStats, 0, sizeof(TASKSCHEDULER_RT_STATS));
+            tTaskSchedRTList[i].sStats.uwMinTime=0xFFFF;
+
+                // realtime dispatch lists to be compiled again
+            uwTaskSchedRTListGen++;
 
                 // restore previous irq enable status
 //            PSW_IEN=bPrevIen;
@@ -221,17 +304,40 @@ BOOL TaskSched_AddRTTaskEx(BOOL (* pfTask)(ULONG), UBYTE ubFlags, SYSTEMSTATUS u
 }
     
 //***************************************************************************
-// Add background task to scheduler
+// Add realtime task to scheduler at rate group; 8kHz tasks go to the slot
+// task list, the others are run by their group in the group budget
 
-BOOL TaskSched_AddBackgroundTask(void (* pfTask)(void))
+BOOL TaskSched_AddRateTask(BOOL (* pfTask)(ULONG), UWORD uwRate, SYSTEMSTATUS uStatusSelect, SYSTEMSTATUS uStatusMask, ULONG uwArg)
 {
     UWORD i;
 
-    for(i=0;i<TASKSCHEDULER_BACKGROUND_MAX_ENTRIES;i++)
+    if(uwRate>=TASKSCHEDULER_RATE_GROUPS)
+        return FALSE;
+
+    if(uwRate==TASKSCHEDULER_RATE_8KHZ)
+        return TaskSched_AddRTTaskEx(pfTask, TASKSCHEDULER_FLAG_NONE, uStatusSelect, uStatusMask, 1, uwArg);
+
+    for(i=0;i<TASKSCHEDULER_RT_MAX_ENTRIES;i++)
             // first empty slot, use it
-        if(ppfBackgroundList[i]==NULL)
+        if(tTaskSchedRTList[i].pfTask==NULL)
         {
-            ppfBackgroundList[i]=pfTask;
+                // rate set before task pointer, entry is skipped by slot list
+                // until then
+            tTaskSchedRTList[i].ubFlags=TASKSCHEDULER_FLAG_NONE;
+            tTaskSchedRTList[i].uStatusSelect=uStatusSelect;
+            tTaskSchedRTList[i].uStatusMask=uStatusMask;
+            tTaskSchedRTList[i].uwNSlots=sTaskSchedRateDefs[uwRate].uwNSlots;
+            tTaskSchedRTList[i].uwSlotCnt=1;
+            tTaskSchedRTList[i].uwSlotDelay=0;
+            tTaskSchedRTList[i].uwDeferred=0;
+            tTaskSchedRTList[i].ubRate=(UBYTE)uwRate;
+            tTaskSchedRTList[i].uwArg=uwArg;
+            memset(&tTaskSchedRTList[i].sStats, 0, sizeof(TASKSCHEDULER_RT_STATS));
+            tTaskSchedRTList[i].sStats.uwMinTime=0xFFFF;
+            tTaskSchedRTList[i].pfTask=pfTask;
+
+                // realtime dispatch lists to be compiled again
+            uwTaskSchedRTListGen++;
 
             return TRUE;
         }
@@ -241,40 +347,789 @@ BOOL TaskSched_AddBackgroundTask(void (* pfTask)(void))
 }
 
 //***************************************************************************
-// Background task scheduler
+// Add background task entry, entry published by incrementing no. of entries
 
-void TaskSched_BackgroundScheduler(void)
+static BOOL bkgadd(void (* pfTask)(void), BOOL (* pfTaskEx)(ULONG), UWORD uwPriority, UWORD uwDeadline, ULONG ulArg, UWORD uwCpu)
+{
+    TASKSCHEDULER_BKG_SCHEDULER_ENTRY * psEntry;
+    ULONG ulSlots;
+
+    if(uwBkgEntries>=TASKSCHEDULER_BACKGROUND_MAX_ENTRIES || uwPriority>=TASKSCHEDULER_BKG_PRIOS)
+        return FALSE;
+
+        // deadline in slots, within timer compare range
+    ulSlots=(ULONG)uwDeadline*(REALTIME_TASK_FREQ/1000);
+    if(ulSlots>0x7FFFul)
+        ulSlots=0x7FFFul;
+
+    psEntry=&sBkgList[uwBkgEntries];
+    memset(psEntry, 0, sizeof(TASKSCHEDULER_BKG_SCHEDULER_ENTRY));
+    psEntry->pfTask=pfTask;
+    psEntry->pfTaskEx=pfTaskEx;
+    psEntry->ulArg=ulArg;
+    psEntry->ubPriority=(UBYTE)uwPriority;
+    psEntry->ubCpu=(UBYTE)uwCpu;
+    psEntry->uwDeadline=(UWORD)ulSlots;
+    psEntry->uwLastRun=uwTaskSchedFreeTimer;
+
+        // entry visible to the other core before the count
+    AMPMBOX_BARRIER();
+    uwBkgEntries++;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Add background task to scheduler
+
+BOOL TaskSched_AddBackgroundTask(void (* pfTask)(void))
+{
+    return bkgadd(pfTask, NULL, TASKSCHEDULER_BKG_PRIO_NORMAL, 0, 0, TASKSCHEDULER_BKG_CPU0);
+}
+
+//***************************************************************************
+// Add background task to scheduler with priority class and deadline (msec),
+// 0 if none; a task overdue is run at next high priority class poll
+
+BOOL TaskSched_AddBackgroundTaskPrio(void (* pfTask)(void), UWORD uwPriority, UWORD uwDeadline)
+{
+    return bkgadd(pfTask, NULL, uwPriority, uwDeadline, 0, TASKSCHEDULER_BKG_CPU0);
+}
+
+//***************************************************************************
+// Add background task to scheduler, extended: the task returns TRUE to yield
+// a continuation, i.e. it has done a chunk of work and more is pending
+
+BOOL TaskSched_AddBackgroundTaskEx(BOOL (* pfTaskEx)(ULONG), UWORD uwPriority, UWORD uwDeadline, ULONG ulArg)
+{
+    return bkgadd(NULL, pfTaskEx, uwPriority, uwDeadline, ulArg, TASKSCHEDULER_BKG_CPU0);
+}
+
+//***************************************************************************
+// Add extended background task to second core scheduler (AMP mode), to
+// first core one otherwise. Tasks on second core must not use OS services
+// nor rely on first core irq disable for atomicity
+
+BOOL TaskSched_AddBackgroundTaskCpu1(BOOL (* pfTaskEx)(ULONG), UWORD uwPriority, UWORD uwDeadline, ULONG ulArg)
+{
+#if CFG_AMP
+    return bkgadd(NULL, pfTaskEx, uwPriority, uwDeadline, ulArg, TASKSCHEDULER_BKG_CPU1);
+#else
+    return bkgadd(NULL, pfTaskEx, uwPriority, uwDeadline, ulArg, TASKSCHEDULER_BKG_CPU0);
+#endif
+}
+
+//***************************************************************************
+// Fill statistics record from consistent snapshot of live statistics
+
+static void statsrecord(TASKSCHEDULER_RT_STATS * psLive, TASKSCHEDULER_RT_STATS_REC * psRec)
+{
+    TASKSCHEDULER_RT_STATS sStats;
+    ULONG ulCalls;
+    ULONG ulTarget,ulSum;
+    UWORD i;
+
+        // realtime scheduler may update while copying, retry until no
+        // execution happened in the meantime
+    do
+    {
+        ulCalls=((volatile TASKSCHEDULER_RT_STATS *)psLive)->ulCalls;
+        memcpy(&sStats, psLive, sizeof(sStats));
+    }
+    while(ulCalls!=((volatile TASKSCHEDULER_RT_STATS *)psLive)->ulCalls || ulCalls!=sStats.ulCalls);
+
+    psRec->ulCalls=sStats.ulCalls;
+    psRec->ulOverruns=sStats.ulOverruns;
+    psRec->ulMissed=0;
+    psRec->uwMaxTime=sStats.uwMaxTime;
+    memcpy(psRec->ulHisto, sStats.ulHisto, sizeof(psRec->ulHisto));
+
+    if(sStats.ulCalls==0)
+    {
+        psRec->uwMinTime=psRec->uwAvgTime=psRec->uwP99Time=0;
+        return;
+    }
+
+    psRec->uwMinTime=sStats.uwMinTime;
+    psRec->uwAvgTime=(UWORD)(sStats.ullTimeSum/sStats.ulCalls);
+
+        // 99th percentile as upper bound of the bucket holding it, never
+        // above the true max
+    ulTarget=sStats.ulCalls-sStats.ulCalls/100;
+    for(i=0,ulSum=0;i<TASKSCHEDULER_RT_HISTO_BUCKETS-1;i++)
+    {
+        ulSum+=sStats.ulHisto[i];
+        if(ulSum>=ulTarget)
+            break;
+    }
+    if(i<TASKSCHEDULER_RT_HISTO_BUCKETS-1 && ((1ul<<i)-1ul)<(ULONG)sStats.uwMaxTime)
+        psRec->uwP99Time=(UWORD)((1ul<<i)-1ul);
+    else
+        psRec->uwP99Time=sStats.uwMaxTime;
+}
+
+//***************************************************************************
+// Get consistent statistics snapshot of realtime task #
+
+BOOL TaskSched_RTStatsGet(UWORD uwTask, TASKSCHEDULER_RT_STATS_REC * psRec)
+{
+    if(uwTask>=TASKSCHEDULER_RT_MAX_ENTRIES || tTaskSchedRTList[uwTask].pfTask==NULL)
+        return FALSE;
+
+    statsrecord(&tTaskSchedRTList[uwTask].sStats, psRec);
+    psRec->ulTask=(ULONG)tTaskSchedRTList[uwTask].pfTask;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Get consistent statistics snapshot of rate group #: task is the period in
+// slots, overruns are executions over budget
+
+BOOL TaskSched_RateStatsGet(UWORD uwGroup, TASKSCHEDULER_RT_STATS_REC * psRec)
+{
+    if(uwGroup>=TASKSCHEDULER_RATE_GROUPS)
+        return FALSE;
+
+    statsrecord(&sTaskSchedRateGroup[uwGroup].sStats, psRec);
+    psRec->ulTask=sTaskSchedRateDefs[uwGroup].uwNSlots;
+    psRec->ulMissed=sTaskSchedRateGroup[uwGroup].ulMissed;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Request reset of all realtime task statistics
+
+void TaskSched_RTStatsReset(void)
+{
+    bTaskSchedRTStatsReset=TRUE;
+}
+
+//***************************************************************************
+// Parameter hook for realtime task statistics
+
+UWORD TaskSched_RTStatsHook(COMMONPARAMDB_ENTRY * psEntry, UWORD uwFlags, UWORD uwElement, HPVOID hpvBuffer, UWORD * puwBufSize, HPULONG hpulContext)
+{
+    TASKSCHEDULER_RT_STATS_REC sRec;
+    UWORD uwSize;
+    UWORD uwCt;
+
+    (void)psEntry;
+    (void)hpulContext;
+
+        // if abort do nothing
+    if(uwFlags&COMMONPARAMDB_CBFLAG_ABORT)
+        return COMMONPARAMDB_CH_OK;
+
+        // check element access
+    if(uwElement>TASKSCHEDULER_RT_MAX_ENTRIES+TASKSCHEDULER_RATE_GROUPS)
+        return COMMONPARAMDB_CH_INVALID_ELEMENT;
+
+        // calculate element size
+    uwSize=(uwElement?sizeof(TASKSCHEDULER_RT_STATS_REC):sizeof(UWORD));
+
+        // if data read
+    if(uwFlags&COMMONPARAMDB_CBFLAG_RD)
+    {
+        if(uwFlags&COMMONPARAMDB_CBFLAG_INIT)
+        {
+                // data size if requested
+            if(uwFlags&COMMONPARAMDB_CBFLAG_SIZEINQUIRY)
+            {
+                *((HPULONG)hpvBuffer)=uwSize;
+                *puwBufSize=sizeof(ULONG);
+            }
+        }
+        else if(uwFlags&COMMONPARAMDB_CBFLAG_SEGMENT)
+        {
+            if(*puwBufSize<uwSize)
+                return COMMONPARAMDB_CH_WRONGLENGTH;
+
+                // rate group record
+            if(uwElement>TASKSCHEDULER_RT_MAX_ENTRIES)
+            {
+                TaskSched_RateStatsGet(uwElement-TASKSCHEDULER_RT_MAX_ENTRIES-1, &sRec);
+                memcpy(hpvBuffer, &sRec, sizeof(sRec));
+            }
+
+                // task record, unused entries read as zero
+            else if(uwElement)
+            {
+                if(!TaskSched_RTStatsGet(uwElement-1, &sRec))
+                    memset(&sRec, 0, sizeof(sRec));
+                memcpy(hpvBuffer, &sRec, sizeof(sRec));
+            }
+
+                // no. of tasks
+            else
+            {
+                for(uwCt=0;uwCt<TASKSCHEDULER_RT_MAX_ENTRIES && tTaskSchedRTList[uwCt].pfTask;uwCt++);
+                memcpy(hpvBuffer, &uwCt, sizeof(UWORD));
+            }
+
+            for(uwCt=uwSize;uwCt<*puwBufSize;uwCt++)
+                ((HPUBYTE)hpvBuffer)[uwCt]=0;
+            *puwBufSize=uwSize;
+        }
+    }
+
+        // if data write, any value on element 0 reset statistics
+    if(uwFlags&COMMONPARAMDB_CBFLAG_WR)
+    {
+        if(uwElement)
+            return COMMONPARAMDB_CH_NO_WRITE_ACCESS;
+
+        if(uwFlags&COMMONPARAMDB_CBFLAG_SEGMENT)
+            TaskSched_RTStatsReset();
+    }
+
+    return COMMONPARAMDB_CH_OK;
+}
+
+//***************************************************************************
+// Get consistent statistics snapshot of background task #
+
+BOOL TaskSched_BkgStatsGet(UWORD uwTask, TASKSCHEDULER_BKG_STATS_REC * psRec)
+{
+    TASKSCHEDULER_BKG_SCHEDULER_ENTRY * psEntry;
+    TASKSCHEDULER_BKG_STATS sStats;
+    ULONG ulCalls;
+
+    if(uwTask>=uwBkgEntries)
+        return FALSE;
+    psEntry=&sBkgList[uwTask];
+
+        // background scheduler may update while copying, retry until no
+        // execution happened in the meantime
+    do
+    {
+        ulCalls=((volatile TASKSCHEDULER_BKG_STATS *)&psEntry->sStats)->ulCalls;
+        memcpy(&sStats, &psEntry->sStats, sizeof(sStats));
+    }
+    while(ulCalls!=((volatile TASKSCHEDULER_BKG_STATS *)&psEntry->sStats)->ulCalls || ulCalls!=sStats.ulCalls);
+
+    psRec->ulTask=psEntry->pfTask?(ULONG)psEntry->pfTask:(ULONG)psEntry->pfTaskEx;
+    psRec->ulCalls=sStats.ulCalls;
+    psRec->ulYields=sStats.ulYields;
+    psRec->ulMissed=sStats.ulMissed;
+    psRec->ulMaxTime=sStats.ulMaxTime;
+    psRec->ulAvgTime=sStats.ulCalls?(ULONG)(sStats.ullTimeSum/sStats.ulCalls):0ul;
+    psRec->uwMaxLatency=sStats.uwMaxLatency;
+    psRec->uwDeadline=psEntry->uwDeadline;
+    psRec->uwPriority=psEntry->ubPriority;
+    psRec->uwCpu=psEntry->ubCpu;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Request reset of all background task statistics and max loop time
+
+void TaskSched_BkgStatsReset(void)
+{
+    UWORD i;
+
+    for(i=0;i<TASKSCHEDULER_BKG_CPUS;i++)
+        bBkgStatsReset[i]=TRUE;
+}
+
+//***************************************************************************
+// Parameter hook: element 0 no. of tasks (write to reset), element # task
+// statistics record
+
+UWORD TaskSched_BkgStatsHook(COMMONPARAMDB_ENTRY * psEntry, UWORD uwFlags, UWORD uwElement, HPVOID hpvBuffer, UWORD * puwBufSize, HPULONG hpulContext)
+{
+    TASKSCHEDULER_BKG_STATS_REC sRec;
+    UWORD uwSize;
+    UWORD uwCt;
+
+    (void)psEntry;
+    (void)hpulContext;
+
+        // if abort do nothing
+    if(uwFlags&COMMONPARAMDB_CBFLAG_ABORT)
+        return COMMONPARAMDB_CH_OK;
+
+        // check element access
+    if(uwElement>TASKSCHEDULER_BACKGROUND_MAX_ENTRIES)
+        return COMMONPARAMDB_CH_INVALID_ELEMENT;
+
+        // calculate element size
+    uwSize=(uwElement?sizeof(TASKSCHEDULER_BKG_STATS_REC):sizeof(UWORD));
+
+        // if data read
+    if(uwFlags&COMMONPARAMDB_CBFLAG_RD)
+    {
+        if(uwFlags&COMMONPARAMDB_CBFLAG_INIT)
+        {
+                // data size if requested
+            if(uwFlags&COMMONPARAMDB_CBFLAG_SIZEINQUIRY)
+            {
+                *((HPULONG)hpvBuffer)=uwSize;
+                *puwBufSize=sizeof(ULONG);
+            }
+        }
+        else if(uwFlags&COMMONPARAMDB_CBFLAG_SEGMENT)
+        {
+            if(*puwBufSize<uwSize)
+                return COMMONPARAMDB_CH_WRONGLENGTH;
+
+                // task record, unused entries read as zero
+            if(uwElement)
+            {
+                if(!TaskSched_BkgStatsGet(uwElement-1, &sRec))
+                    memset(&sRec, 0, sizeof(sRec));
+                memcpy(hpvBuffer, &sRec, sizeof(sRec));
+            }
+
+                // no. of tasks
+            else
+            {
+                uwCt=uwBkgEntries;
+                memcpy(hpvBuffer, &uwCt, sizeof(UWORD));
+            }
+
+            for(uwCt=uwSize;uwCt<*puwBufSize;uwCt++)
+                ((HPUBYTE)hpvBuffer)[uwCt]=0;
+            *puwBufSize=uwSize;
+        }
+    }
+
+        // if data write, any value on element 0 reset statistics
+    if(uwFlags&COMMONPARAMDB_CBFLAG_WR)
+    {
+        if(uwElement)
+            return COMMONPARAMDB_CH_NO_WRITE_ACCESS;
+
+        if(uwFlags&COMMONPARAMDB_CBFLAG_SEGMENT)
+            TaskSched_BkgStatsReset();
+    }
+
+    return COMMONPARAMDB_CH_OK;
+}
+
+//***************************************************************************
+// Get consistent copy of trace tick, 0 is the newest one; lock-free, if
+// the ring is running and the tick is overwritten while copying then retry
+
+BOOL TaskSched_RTTraceGet(UWORD uwAge, TASKSCHEDULER_RT_TRACE_TICK * psTick)
+{
+    ULONG ulHead;
+
+    if(uwAge>=TASKSCHEDULER_RT_TRACE_TICKS)
+        return FALSE;
+
+    do
+    {
+        ulHead=sTaskSchedRTTrace.ulHead;
+        if(ulHead<=uwAge)
+            return FALSE;
+
+        memcpy(psTick, &sTaskSchedRTTrace.sTick[(ulHead-1-uwAge)&(TASKSCHEDULER_RT_TRACE_TICKS-1)], sizeof(TASKSCHEDULER_RT_TRACE_TICK));
+    }
+    while(sTaskSchedRTTrace.ulHead-ulHead>(ULONG)(TASKSCHEDULER_RT_TRACE_TICKS-1-uwAge));
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Restart trace recording after a freeze
+
+void TaskSched_RTTraceRearm(void)
+{
+    if(sTaskSchedRTTrace.uwReason==TASKSCHEDULER_RT_TRACE_RUNNING)
+        return;
+
+        // head first, ring is not written while frozen
+    sTaskSchedRTTrace.ulHead=0;
+    sTaskSchedRTTrace.uwReason=TASKSCHEDULER_RT_TRACE_RUNNING;
+}
+
+//***************************************************************************
+// Greatest common divisor
+
+static UWORD gcd(UWORD uwA, UWORD uwB)
+{
+    UWORD uwTmp;
+
+    while(uwB)
+    {
+        uwTmp=uwA%uwB;
+        uwA=uwB;
+        uwB=uwTmp;
+    }
+
+    return uwA;
+}
+
+//***************************************************************************
+// Spread phases of every # slots tasks in order to flatten the per slot
+// load; cost of each task is its max measured execute time, longest tasks
+// are placed first on the phase with min resulting peak. Shifts are applied
+// by realtime scheduler at next reload of each task; return TRUE if some
+// phase has been changed
+
+BOOL TaskSched_RTBalance(void)
+{
+    TASKSCHEDULER_RT_SCHEDULER_ENTRY * psEntry;
+    UBYTE pubTask[TASKSCHEDULER_RT_MAX_ENTRIES];
+    UWORD puwPhase[TASKSCHEDULER_RT_MAX_ENTRIES];
+    UWORD puwNewPhase[TASKSCHEDULER_RT_MAX_ENTRIES];
+    UWORD puwSlots[TASKSCHEDULER_RT_MAX_ENTRIES];
+    ULONG pulCost[TASKSCHEDULER_RT_MAX_ENTRIES];
+    ULONG pulLoad[TASKSCHEDULER_RT_BALANCE_PERIOD];
+    ULONG ulPeak,ulNewPeak,ulPhasePeak,ulBestPeak;
+    UWORD uwTasks,uwPeriod,uwN,uwStep,uwFree,uwNext;
+    UWORD i,j,uwSlot;
+    BOOL bOdd;
+    BOOL bChanged=FALSE;
+
+        // collect active tasks and their actual phases, slot downcounters are
+        // read consistently with the free timer and the phase
+    do
+    {
+        uwFree=uwTaskSchedFreeTimer;
+        bOdd=bTaskSchedRTExecutingOddPhase;
+        uwTasks=0;
+        uwPeriod=1;
+
+        for(i=0;i<TASKSCHEDULER_RT_MAX_ENTRIES && tTaskSchedRTList[i].pfTask;i++)
+        {
+            psEntry=&tTaskSchedRTList[i];
+
+            if((psEntry->ubFlags&(TASKSCHEDULER_FLAG_EXEEVERYNSLOTS|TASKSCHEDULER_FLAG_FIXEDPHASE))!=TASKSCHEDULER_FLAG_EXEEVERYNSLOTS || psEntry->uwNSlots<2)
+                continue;
+            if(psEntry->uStatusSelect != (psEntry->uStatusMask&ulSystemStatus))
+                continue;
+
+                // previous shift not yet applied or carried over, try later
+            if(psEntry->uwSlotDelay || psEntry->uwDeferred)
+                return FALSE;
+
+                // odd or even phase task downcounts every other slot: period
+                // is twice # slots and next run is on its first phase slot
+            if(psEntry->ubFlags&(TASKSCHEDULER_FLAG_EXECUTEODD|TASKSCHEDULER_FLAG_EXECUTEEVEN))
+            {
+                uwStep=2;
+                uwNext=2*psEntry->uwSlotCnt;
+                if(!(psEntry->ubFlags&TASKSCHEDULER_FLAG_EXECUTEODD)==bOdd)
+                    uwNext--;
+            }
+            else
+            {
+                uwStep=1;
+                uwNext=psEntry->uwSlotCnt;
+            }
+            uwN=psEntry->uwNSlots*uwStep;
+
+                // out of balanced hyperperiod
+            if((ULONG)uwPeriod/gcd(uwPeriod,uwN)*uwN>TASKSCHEDULER_RT_BALANCE_PERIOD)
+                continue;
+            uwPeriod=uwPeriod/gcd(uwPeriod,uwN)*uwN;
+
+            pubTask[uwTasks]=(UBYTE)i;
+            puwPhase[uwTasks]=(UWORD)(((ULONG)uwFree+uwNext)%uwN);
+            puwSlots[uwTasks]=uwN;
+            pulCost[uwTasks]=psEntry->sStats.uwMaxTime;
+            uwTasks++;
+        }
+    }
+    while(uwFree!=uwTaskSchedFreeTimer);
+
+    if(uwTasks<2)
+        return FALSE;
+
+        // sort by cost, longest first
+    for(i=1;i<uwTasks;i++)
+        for(j=i;j>0 && pulCost[j]>pulCost[j-1];j--)
+        {
+            UBYTE ubTask=pubTask[j];
+            UWORD uwPhase=puwPhase[j];
+            UWORD uwSlots=puwSlots[j];
+            ULONG ulCost=pulCost[j];
+
+            pubTask[j]=pubTask[j-1];
+            puwPhase[j]=puwPhase[j-1];
+            puwSlots[j]=puwSlots[j-1];
+            pulCost[j]=pulCost[j-1];
+            pubTask[j-1]=ubTask;
+            puwPhase[j-1]=uwPhase;
+            puwSlots[j-1]=uwSlots;
+            pulCost[j-1]=ulCost;
+        }
+
+        // actual peak
+    memset(pulLoad, 0, sizeof(pulLoad));
+    for(i=0;i<uwTasks;i++)
+        for(uwSlot=puwPhase[i];uwSlot<uwPeriod;uwSlot+=puwSlots[i])
+            pulLoad[uwSlot]+=pulCost[i];
+    for(ulPeak=0,uwSlot=0;uwSlot<uwPeriod;uwSlot++)
+        if(pulLoad[uwSlot]>ulPeak)
+            ulPeak=pulLoad[uwSlot];
+
+        // new placement, on same peak actual phase is preferred; odd or even
+        // phase tasks are moved by whole periods of their phase
+    memset(pulLoad, 0, sizeof(pulLoad));
+    for(ulNewPeak=0,i=0;i<uwTasks;i++)
+    {
+        uwN=puwSlots[i];
+        uwStep=uwN/tTaskSchedRTList[pubTask[i]].uwNSlots;
+        puwNewPhase[i]=puwPhase[i];
+        ulBestPeak=0xFFFFFFFFul;
+
+        for(j=puwPhase[i]%uwStep;j<uwN;j+=uwStep)
+        {
+            for(ulPhasePeak=0,uwSlot=j;uwSlot<uwPeriod;uwSlot+=uwN)
+                if(pulLoad[uwSlot]+pulCost[i]>ulPhasePeak)
+                    ulPhasePeak=pulLoad[uwSlot]+pulCost[i];
+
+            if(ulPhasePeak<ulBestPeak || (ulPhasePeak==ulBestPeak && j==puwPhase[i]))
+            {
+                ulBestPeak=ulPhasePeak;
+                puwNewPhase[i]=j;
+            }
+        }
+
+        for(uwSlot=puwNewPhase[i];uwSlot<uwPeriod;uwSlot+=uwN)
+            pulLoad[uwSlot]+=pulCost[i];
+        if(ulBestPeak>ulNewPeak)
+            ulNewPeak=ulBestPeak;
+    }
+
+        // apply only if better
+    if(ulNewPeak>=ulPeak)
+        return FALSE;
+
+    for(i=0;i<uwTasks;i++)
+        if(puwNewPhase[i]!=puwPhase[i])
+        {
+            uwN=puwSlots[i];
+            uwStep=uwN/tTaskSchedRTList[pubTask[i]].uwNSlots;
+            tTaskSchedRTList[pubTask[i]].uwSlotDelay=(UWORD)((puwNewPhase[i]+uwN-puwPhase[i])%uwN/uwStep);
+            bChanged=TRUE;
+        }
+
+    return bChanged;
+}
+
+//***************************************************************************
+// Run background task, accounting latency and execute time; return TRUE if
+// the task yields a continuation
+
+static BOOL bkgrun(TASKSCHEDULER_BKG_SCHEDULER_ENTRY * psEntry)
+{
+    TASKSCHEDULER_BKG_STATS * psStats=&psEntry->sStats;
+    UWORD uwStart;
+    UWORD uwProfiler;
+    UWORD uwSlots;
+    ULONG ulTime;
+    BOOL bYield;
+
+    uwStart=uwTaskSchedFreeTimer;
+    uwProfiler=timer_profiler_start(uwSysTimers100ns);
+
+        // latency from previous execution, late if past deadline
+    uwSlots=(UWORD)(uwStart-psEntry->uwLastRun);
+    if(uwSlots>psStats->uwMaxLatency)
+        psStats->uwMaxLatency=uwSlots;
+    if(psEntry->uwDeadline && uwSlots>psEntry->uwDeadline)
+        psStats->ulMissed++;
+    psEntry->uwLastRun=uwStart;
+
+    if(psEntry->pfTask)
+    {
+        (*psEntry->pfTask)();
+        bYield=FALSE;
+    }
+    else
+        bYield=(*psEntry->pfTaskEx)(psEntry->ulArg);
+    psEntry->bYield=bYield;
+
+        // execute time, wall clock including preemption
+    uwSlots=(UWORD)(uwTaskSchedFreeTimer-uwStart);
+    if(uwSlots<TASKSCHEDULER_BKG_PROFILER_SLOTS)
+        ulTime=(ULONG)timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwProfiler))/10;
+    else
+        ulTime=(ULONG)uwSlots*RT_SLOT_USEC;
+
+    psStats->ullTimeSum+=ulTime;
+    if(ulTime>psStats->ulMaxTime)
+        psStats->ulMaxTime=ulTime;
+    if(bYield)
+        psStats->ulYields++;
+        // last, as consistency marker for readers
+    psStats->ulCalls++;
+
+    return bYield;
+}
+
+//***************************************************************************
+// Poll high priority class between lower priority tasks, at most once per
+// slot; lower priority tasks overdue are run too. An overdue task still to
+// be run by the current pass is marked, so the pass skips it once; the task
+// about to run is left to the pass
+
+static void bkgpoll(UWORD uwCpu, UWORD uwPriority, TASKSCHEDULER_BKG_SCHEDULER_ENTRY * psCurrent)
+{
+    TASKSCHEDULER_BKG_SCHEDULER_ENTRY * psEntry;
+    TASKSCHEDULER_BKG_SCHEDULER_ENTRY * psEnd=&sBkgList[uwBkgEntries];
+    UWORD uwNow=uwTaskSchedFreeTimer;
+
+    if(uwNow==uwBkgPollTimer[uwCpu])
+        return;
+    uwBkgPollTimer[uwCpu]=uwNow;
+
+    for(psEntry=sBkgList;psEntry<psEnd;psEntry++)
+        if(psEntry->ubCpu==uwCpu && psEntry!=psCurrent && (psEntry->ubPriority==TASKSCHEDULER_BKG_PRIO_HIGH ||
+           (psEntry->uwDeadline && timer_istimedout(uwNow,(UWORD)(psEntry->uwLastRun+psEntry->uwDeadline)))))
+        {
+            bkgrun(psEntry);
+            if(psEntry->ubPriority>uwPriority || (psEntry->ubPriority==uwPriority && psEntry>psCurrent))
+                psEntry->bRunAhead=TRUE;
+        }
+}
+
+//***************************************************************************
+// Run background tasks of priority class, then their continuations within
+// the continuation slice
+
+static void bkgrunclass(UWORD uwCpu, UWORD uwPriority)
+{
+    TASKSCHEDULER_BKG_SCHEDULER_ENTRY * psEntry;
+    TASKSCHEDULER_BKG_SCHEDULER_ENTRY * psEnd=&sBkgList[uwBkgEntries];
+    UWORD uwSliceEnd=timer_settimeout(uwTaskSchedFreeTimer,TASKSCHEDULER_BKG_CONTINUATION_SLOTS);
+    BOOL bYield;
+    BOOL bContinuation=FALSE;
+
+    do
+    {
+        bYield=FALSE;
+        for(psEntry=sBkgList;psEntry<psEnd;psEntry++)
+        {
+            if(psEntry->ubCpu!=uwCpu || psEntry->ubPriority!=uwPriority)
+                continue;
+
+                // yet run by poll in this round, its continuation is left
+                // to next round
+            if(psEntry->bRunAhead)
+            {
+                psEntry->bRunAhead=FALSE;
+                bYield|=psEntry->bYield;
+                continue;
+            }
+            if(bContinuation && !psEntry->bYield)
+                continue;
+
+                // bounded latency of high priority class
+            if(uwPriority!=TASKSCHEDULER_BKG_PRIO_HIGH)
+                bkgpoll(uwCpu, uwPriority, psEntry);
+
+            bYield|=bkgrun(psEntry);
+        }
+        bContinuation=TRUE;
+    }
+    while(bYield && !timer_istimedout(uwTaskSchedFreeTimer,uwSliceEnd));
+}
+
+//***************************************************************************
+// Background loop start: serve statistics reset request, then run priority
+// classes in order
+
+static void bkgloopstart(UWORD uwCpu)
+{
+    TASKSCHEDULER_BKG_SCHEDULER_ENTRY * psEntry;
+    UWORD uwPriority;
+
+    if(bBkgStatsReset[uwCpu])
+    {
+        for(psEntry=sBkgList;psEntry<&sBkgList[uwBkgEntries];psEntry++)
+            if(psEntry->ubCpu==uwCpu)
+            {
+                memset(&psEntry->sStats, 0, sizeof(TASKSCHEDULER_BKG_STATS));
+                psEntry->uwLastRun=uwTaskSchedFreeTimer;
+            }
+        uwTaskSchedBkgLoopMaxTime[uwCpu]=0;
+        bBkgStatsReset[uwCpu]=FALSE;
+    }
+
+    for(uwPriority=0;uwPriority<TASKSCHEDULER_BKG_PRIOS;uwPriority++)
+        bkgrunclass(uwCpu, uwPriority);
+}
+
+//***************************************************************************
+// Background loop end: loop time, from start to start
+
+static void bkgloopend(UWORD uwCpu)
+{
+    UWORD uwLoopTime;
+
+    uwLoopTime=(UWORD)(uwTaskSchedFreeTimer-uwBkgLoopStart[uwCpu]);
+    uwBkgLoopStart[uwCpu]+=uwLoopTime;
+    uwTaskSchedBkgLoopTime[uwCpu]=uwLoopTime;
+    if(uwLoopTime>uwTaskSchedBkgLoopMaxTime[uwCpu])
+        uwTaskSchedBkgLoopMaxTime[uwCpu]=uwLoopTime;
+}
+
+//***************************************************************************
+// Background loop: priority classes in order, high priority class polled
+// also between lower priority tasks
+
+void TaskSched_BackgroundLoop(void)
 {
-    void (** ppfList)(void);
     ULONG ulSum;
     UWORD uwNSample;
 
-    for(;;)
+    bkgloopstart(TASKSCHEDULER_BKG_CPU0);
+
+        // rt task timing measurements
+    if(uwTaskSchedRTLocalMaxTime>uwTaskSchedRTMaxTime)
+        uwTaskSchedRTMaxTime=uwTaskSchedRTLocalMaxTime;
+
+    if(timer_istimedout(uwTaskSchedFreeTimer,uwRTAvgCalcTimer))
     {
-    	ppfList = ppfBackgroundList;
+//        DISABLE_IRQ();
+        ulSum=ulTaskSchedRTLocalTimeSum;
+        uwNSample=uwTaskSchedFreeTimer;
+        ulTaskSchedRTLocalTimeSum=0l;
+//        RESTORE_IRQ();
 
-		while(*ppfList)
-			(*ppfList++)();
+        uwTaskSchedRTLocalAvgTime=(UWORD)(ulSum/((UWORD)(uwNSample-uwRTAvgCalcPrevTimer)));
+        uwRTAvgCalcPrevTimer=uwNSample;
 
-			// rt task timing measurements
-		if(uwTaskSchedRTLocalMaxTime>uwTaskSchedRTMaxTime)
-			uwTaskSchedRTMaxTime=uwTaskSchedRTLocalMaxTime;
+        uwRTAvgCalcTimer=timer_settimeout(uwTaskSchedFreeTimer,RT_AVG_CALC_NSAMPLES);
 
-		if(timer_istimedout(uwTaskSchedFreeTimer,uwRTAvgCalcTimer))
-		{
-	//        DISABLE_IRQ();
-			ulSum=ulTaskSchedRTLocalTimeSum;
-			uwNSample=uwTaskSchedFreeTimer;
-			ulTaskSchedRTLocalTimeSum=0l;
-	//        RESTORE_IRQ();
+            // spread every # slots tasks with updated execute times
+        TaskSched_RTBalance();
+    }
 
-			uwTaskSchedRTLocalAvgTime=(UWORD)(ulSum/((UWORD)(uwNSample-uwRTAvgCalcPrevTimer)));
-			uwRTAvgCalcPrevTimer=uwNSample;
+    vTaskDelay(0);
 
-			uwRTAvgCalcTimer=timer_settimeout(uwTaskSchedFreeTimer,RT_AVG_CALC_NSAMPLES);
-		}
+    bkgloopend(TASKSCHEDULER_BKG_CPU0);
+}
 
-		vTaskDelay(0);
-    }
+//***************************************************************************
+// Background task scheduler
 
+void TaskSched_BackgroundScheduler(void)
+{
+    uwBkgLoopStart[TASKSCHEDULER_BKG_CPU0]=uwBkgPollTimer[TASKSCHEDULER_BKG_CPU0]=uwTaskSchedFreeTimer;
+
+    for(;;)
+        TaskSched_BackgroundLoop();
+}
+
+//***************************************************************************
+// Background task scheduler of second core (AMP mode): no OS there, it
+// loops on its own tasks only
+
+void TaskSched_BackgroundSchedulerCpu1(void)
+{
+    uwBkgLoopStart[TASKSCHEDULER_BKG_CPU1]=uwBkgPollTimer[TASKSCHEDULER_BKG_CPU1]=uwTaskSchedFreeTimer;
+
+    for(;;)
+    {
+        bkgloopstart(TASKSCHEDULER_BKG_CPU1);
+        bkgloopend(TASKSCHEDULER_BKG_CPU1);
+    }
 }
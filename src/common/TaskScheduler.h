@@ -16,6 +16,7 @@
 
 #include "DefineExternals.h"
 #include "system\SystemStatus.h"
+#include "common\CommonParamDB.h"
 //***************************************************************************
 // Tasks flags
 
@@ -24,7 +25,10 @@
 
     // immediately reiterate the task if return TRUE
 #define TASKSCHEDULER_FLAG_REITERATEIFREQ       0x01
-    // optional if no time left in realtime slot
+    // optional if no time left in realtime slot: carried over to next
+    // slots, within its period if every # slots, otherwise forced after
+    // TASKSCHEDULER_RT_OPTIONAL_DEADLINE slots; if reiterated, iterations
+    // stop at standard execution time and go on at next slot
 #define TASKSCHEDULER_FLAG_OPTIONAL             0X02
     // execute in the odd phase of realtime slot
 #define TASKSCHEDULER_FLAG_EXECUTEODD           0X04
@@ -32,6 +36,24 @@
 #define TASKSCHEDULER_FLAG_EXECUTEEVEN          0X08
     // execute every # realtime slot
 #define TASKSCHEDULER_FLAG_EXEEVERYNSLOTS       0X10
+    // every # realtime slot task phase kept as at insertion, not balanced
+#define TASKSCHEDULER_FLAG_FIXEDPHASE           0X20
+
+//***************************************************************************
+// Background tasks priorities
+
+    // communication facing, also polled between lower priority tasks
+#define TASKSCHEDULER_BKG_PRIO_HIGH             0
+    // default for plain background tasks
+#define TASKSCHEDULER_BKG_PRIO_NORMAL           1
+    // housekeeping, checks
+#define TASKSCHEDULER_BKG_PRIO_LOW              2
+#define TASKSCHEDULER_BKG_PRIOS                 3
+
+    // background schedulers, one per core (second one in AMP mode only)
+#define TASKSCHEDULER_BKG_CPU0                  0
+#define TASKSCHEDULER_BKG_CPU1                  1
+#define TASKSCHEDULER_BKG_CPUS                  2
 
 //***************************************************************************
 // Configuration
@@ -39,11 +61,55 @@
 #define TASKSCHEDULER_RT_MAX_ENTRIES            32
 #define TASKSCHEDULER_BACKGROUND_MAX_ENTRIES    64
 
+    // background continuations are run again within # slots from the start
+    // of their priority class pass, then left to next loop
+#define TASKSCHEDULER_BKG_CONTINUATION_SLOTS    8
+    // background task execute time measured by 100nsec timer up to # slots,
+    // by slot timer above
+#define TASKSCHEDULER_BKG_PROFILER_SLOTS        32
+
 #define TASKSCHEDULER_RT_STD_EXECUTION_TIME     1100        // * 100nsec
 #define TASKSCHEDULER_RT_MAX_EXECUTION_TIME     1200        // * 100nsec
 #define TASKSCHEDULER_RT_PEAK_EXECUTION_TIME    1240        // * 100nsec
 #define TASKSCHEDULER_RT_MAX_ALLOWED_SLOTS      4
 
+    // optional task, not every # slots, carried over for # slots at most
+#define TASKSCHEDULER_RT_OPTIONAL_DEADLINE      8
+
+    // realtime task list compiled into per phase dispatch lists of the tasks
+    // selected by system status, again when tasks are added or on edges of
+    // status bits in some task mask; a status changed by a task compiles
+    // again the rest of the list in the slot. Otherwise status and flags
+    // are interpreted every slot
+#define TASKSCHEDULER_RT_PRECOMPILED            1
+
+    // N slots tasks phases are spread by measured execute time, balancing
+    // tasks whose periods hyperperiod fits into # slots
+#define TASKSCHEDULER_RT_BALANCE_PERIOD         64
+
+    // per task execution time histogram, bucket n counts times in
+    // [2^(n-1),2^n) * 100nsec, last bucket collects all longer times
+#define TASKSCHEDULER_RT_HISTO_BUCKETS          16
+
+    // realtime trace ring, last # ticks (power of 2) with per task enter/exit
+    // times; frozen on overtime, it survives reset for post-mortem reading
+#define TASKSCHEDULER_RT_TRACE_TICKS            8
+#define TASKSCHEDULER_RT_TRACE_MAGIC            0x52545452ul
+
+    // realtime trace freeze reasons
+#define TASKSCHEDULER_RT_TRACE_RUNNING          0
+#define TASKSCHEDULER_RT_TRACE_SYSOVERTIME      1
+#define TASKSCHEDULER_RT_TRACE_PLCOVERTIME      2
+
+    // realtime rate groups: modules declare the rate they run at, the
+    // scheduler runs each group after the slot task list with own budget,
+    // carry over deadline, priority and execute time profiling
+#define TASKSCHEDULER_RATE_8KHZ                 0
+#define TASKSCHEDULER_RATE_4KHZ                 1
+#define TASKSCHEDULER_RATE_1KHZ                 2
+#define TASKSCHEDULER_RATE_125HZ                3
+#define TASKSCHEDULER_RATE_GROUPS               4
+
 //***************************************************************************
 // Structures
 
@@ -57,6 +123,116 @@ typedef struct
 #endif
 } TASKSCHEDULER_TASK_INIT;
 
+    // Realtime task statistics, updated by the realtime scheduler
+typedef struct
+{
+    ULONG           ulCalls;                    // no. of executions
+    ULONG           ulOverruns;                 // slots overran while executing
+    ULLNG           ullTimeSum;                 // sum of execute times
+    UWORD           uwMinTime;                  // min execute time
+    UWORD           uwMaxTime;                  // max execute time
+    ULONG           ulHisto[TASKSCHEDULER_RT_HISTO_BUCKETS];
+} TASKSCHEDULER_RT_STATS;
+
+    // Realtime task statistics record, as read by fieldbus/tools
+typedef struct
+{
+    ULONG           ulTask;                     // task entry point address
+    UWORD           uwMinTime;                  // min execute time
+    UWORD           uwMaxTime;                  // max execute time
+    UWORD           uwP99Time;                  // 99th percentile (bucket resolution)
+    UWORD           uwAvgTime;                  // average execute time
+    ULONG           ulCalls;                    // no. of executions
+    ULONG           ulOverruns;                 // slots overran while executing
+    ULONG           ulHisto[TASKSCHEDULER_RT_HISTO_BUCKETS];
+    ULONG           ulMissed;                   // rate group deadlines missed
+} TASKSCHEDULER_RT_STATS_REC;
+
+    // Realtime trace tick, times are * 100nsec from slot start
+typedef struct
+{
+    UWORD           uwTick;                     // scheduler free timer
+    UWORD           uwTime;                     // slot execute time
+    ULONG           ulRunMask;                  // tasks run, bit # is task #
+    UWORD           uwEnter[TASKSCHEDULER_RT_MAX_ENTRIES];
+    UWORD           uwExit[TASKSCHEDULER_RT_MAX_ENTRIES];
+} TASKSCHEDULER_RT_TRACE_TICK;
+
+    // Realtime trace ring, single writer (realtime scheduler), validated at
+    // init by magic pair as it's not cleared by reset
+typedef struct
+{
+    ULONG           ulMagic;
+    volatile ULONG  ulHead;                     // ticks written, next is ulHead%TICKS
+    ULONG           ulFreezeCnt;                // no. of freeze events
+    ULONG           ulAbsoluteTime;             // power on time at freeze
+    volatile UWORD  uwReason;                   // freeze reason, 0 if running
+    UWORD           uwTasks;                    // no. of tasks at freeze
+    TASKSCHEDULER_RT_TRACE_TICK sTick[TASKSCHEDULER_RT_TRACE_TICKS];
+    ULONG           ulMagicInv;
+} TASKSCHEDULER_RT_TRACE;
+
+    // Realtime rate group definition
+typedef struct
+{
+    UWORD           uwNSlots;                   // period, slots
+    UWORD           uwPhase;                    // first slot of period
+    UWORD           uwBudget;                   // execute time budget, * 100nsec
+    UWORD           uwDeadline;                 // max slots carried over for lack of time
+    UBYTE           ubPriority;                 // execution order in slot, 0 first
+} TASKSCHEDULER_RATE_DEF;
+
+    // Realtime rate group runtime, updated by the realtime scheduler
+typedef struct
+{
+    UWORD           uwSlotCnt;                  // slot downcounter
+    UWORD           uwDeferred;                 // slots carried over
+    ULONG           ulMissed;                   // run forced past deadline
+    TASKSCHEDULER_RT_STATS sStats;              // group execute time statistics,
+                                                // overruns are budget overruns
+} TASKSCHEDULER_RATE_GROUP;
+
+    // Background task statistics, updated by the background scheduler
+typedef struct
+{
+    ULONG           ulCalls;                    // no. of executions
+    ULONG           ulYields;                   // executions yielding a continuation
+    ULONG           ulMissed;                   // executions started past deadline
+    ULONG           ulMaxTime;                  // max execute time, usec
+    ULLNG           ullTimeSum;                 // sum of execute times, usec
+    UWORD           uwMaxLatency;               // max time between executions, slots
+} TASKSCHEDULER_BKG_STATS;
+
+    // Background task statistics record, as read by fieldbus/tools
+typedef struct
+{
+    ULONG           ulTask;                     // task entry point address
+    ULONG           ulCalls;                    // no. of executions
+    ULONG           ulYields;                   // executions yielding a continuation
+    ULONG           ulMissed;                   // executions started past deadline
+    ULONG           ulMaxTime;                  // max execute time, usec
+    ULONG           ulAvgTime;                  // average execute time, usec
+    UWORD           uwMaxLatency;               // max time between executions, slots
+    UWORD           uwDeadline;                 // max time allowed between executions, slots
+    UWORD           uwPriority;                 // priority class
+    UWORD           uwCpu;                      // core running the task
+} TASKSCHEDULER_BKG_STATS_REC;
+
+    // Background scheduler structure
+typedef struct
+{
+    void            (* pfTask)( void );         // plain task, or
+    BOOL            (* pfTaskEx)( ULONG );      // task returning TRUE to yield a continuation
+    ULONG           ulArg;                      // extended task argument
+    UBYTE           ubPriority;                 // priority class
+    UBYTE           ubCpu;                      // core running the task
+    BOOL            bYield;                     // continuation pending
+    BOOL            bRunAhead;                  // run by poll before its turn in the pass
+    UWORD           uwDeadline;                 // max slots between executions, 0 if none
+    UWORD           uwLastRun;                  // free timer at last execution
+    TASKSCHEDULER_BKG_STATS sStats;             // execute time statistics
+} TASKSCHEDULER_BKG_SCHEDULER_ENTRY;
+
     // Realtime scheduler structure
 typedef struct
 {
@@ -66,8 +242,12 @@ typedef struct
     SYSTEMSTATUS    uStatusMask;                // check for execution
     UWORD           uwNSlots;                   // exe every # slots (realtime)
     UWORD           uwSlotCnt;                  // slot downcounter
+    UWORD           uwSlotDelay;                // phase shift request, applied at next reload
+    UWORD           uwDeferred;                 // slots optional execution carried over
+    UBYTE           ubRate;                     // rate group, 8kHz is the slot task list
     ULONG           uwArg;                      // task argument
     UWORD           uwExeTime;                  // task execute time
+    TASKSCHEDULER_RT_STATS sStats;              // execute time statistics
 } TASKSCHEDULER_RT_SCHEDULER_ENTRY;
 
 //***************************************************************************
@@ -98,6 +278,10 @@ extern UWORD uwTaskSchedStatus;
 
 extern volatile UWORD uwTaskSchedFreeTimer;
 extern UWORD uwTaskSchedRTMaxTime;
+
+    // interrupt nesting level the realtime scheduler runs at, interrupts
+    // nested into it run above
+extern volatile UWORD uwTaskSchedRTIsrNesting;
 extern volatile UWORD uwTaskSchedRTLocalMaxTime;
 extern volatile UWORD uwTaskSchedRTLocalAvgTime;
 
@@ -106,6 +290,24 @@ extern TASKSCHEDULER_RT_SCHEDULER_ENTRY  tTaskSchedRTList[TASKSCHEDULER_RT_MAX_E
 
 extern volatile ULONG ulTaskSchedRTLocalTimeSum;
 
+    // statistics reset request, served by realtime scheduler at next slot
+extern volatile BOOL bTaskSchedRTStatsReset;
+
+    // realtime task list generation, changes at each task insertion
+extern volatile UWORD uwTaskSchedRTListGen;
+
+    // realtime trace ring, placed in not initialized OCM
+extern TASKSCHEDULER_RT_TRACE sTaskSchedRTTrace;
+
+    // background loop time per core, last and max, * slots
+extern volatile UWORD uwTaskSchedBkgLoopTime[TASKSCHEDULER_BKG_CPUS];
+extern volatile UWORD uwTaskSchedBkgLoopMaxTime[TASKSCHEDULER_BKG_CPUS];
+
+    // realtime rate groups definitions, runtime and execution order
+extern const TASKSCHEDULER_RATE_DEF sTaskSchedRateDefs[TASKSCHEDULER_RATE_GROUPS];
+extern TASKSCHEDULER_RATE_GROUP sTaskSchedRateGroup[TASKSCHEDULER_RATE_GROUPS];
+extern UBYTE ubTaskSchedRateOrder[TASKSCHEDULER_RATE_GROUPS];
+
 //***************************************************************************
 // Scheduler Initialization
 
@@ -121,16 +323,81 @@ BOOL TaskSched_AddRTTask(BOOL (*)(void), UBYTE, SYSTEMSTATUS, SYSTEMSTATUS, UWOR
 // Add realtime task to scheduler, extended
 BOOL TaskSched_AddRTTaskEx(BOOL (*)(ULONG), UBYTE, SYSTEMSTATUS, SYSTEMSTATUS, UWORD, ULONG);
 
+// Add realtime task to scheduler at rate group
+BOOL TaskSched_AddRateTask(BOOL (*)(ULONG), UWORD, SYSTEMSTATUS, SYSTEMSTATUS, ULONG);
+
 // Add background task to scheduler
 BOOL TaskSched_AddBackgroundTask(void (*)(void));
 
+// Add background task to scheduler with priority class and deadline (msec)
+BOOL TaskSched_AddBackgroundTaskPrio(void (*)(void), UWORD, UWORD);
+
+// Add background task to scheduler, extended: it may yield a continuation
+BOOL TaskSched_AddBackgroundTaskEx(BOOL (*)(ULONG), UWORD, UWORD, ULONG);
+
+// Add extended background task to second core scheduler (AMP mode), to
+// first core one otherwise. Tasks on second core must not use OS services
+// nor rely on first core irq disable for atomicity; data shared with first
+// core goes through mailboxes (AmpMailbox.h)
+BOOL TaskSched_AddBackgroundTaskCpu1(BOOL (*)(ULONG), UWORD, UWORD, ULONG);
+
+//***************************************************************************
+// Realtime statistics
+
+// Get consistent statistics snapshot of realtime task #
+BOOL TaskSched_RTStatsGet(UWORD, TASKSCHEDULER_RT_STATS_REC *);
+
+// Get consistent statistics snapshot of rate group #
+BOOL TaskSched_RateStatsGet(UWORD, TASKSCHEDULER_RT_STATS_REC *);
+
+// Request reset of all realtime task statistics
+void TaskSched_RTStatsReset(void);
+
+// Parameter hook: element 0 no. of tasks (write to reset), element # task
+// statistics record, elements past max tasks rate groups statistics records
+UWORD TaskSched_RTStatsHook(COMMONPARAMDB_ENTRY *, UWORD, UWORD, HPVOID, UWORD *, HPULONG);
+
+//***************************************************************************
+// Background statistics
+
+// Get consistent statistics snapshot of background task #
+BOOL TaskSched_BkgStatsGet(UWORD, TASKSCHEDULER_BKG_STATS_REC *);
+
+// Request reset of all background task statistics and max loop time
+void TaskSched_BkgStatsReset(void);
+
+// Parameter hook: element 0 no. of tasks (write to reset), element # task
+// statistics record
+UWORD TaskSched_BkgStatsHook(COMMONPARAMDB_ENTRY *, UWORD, UWORD, HPVOID, UWORD *, HPULONG);
+
+//***************************************************************************
+// Realtime trace
+
+// Get consistent copy of trace tick, 0 is the newest one
+BOOL TaskSched_RTTraceGet(UWORD, TASKSCHEDULER_RT_TRACE_TICK *);
+
+// Restart trace recording after a freeze
+void TaskSched_RTTraceRearm(void);
+
+//***************************************************************************
+// Realtime load balancing
+
+// Spread N slots tasks phases to flatten slot load, TRUE if changed
+BOOL TaskSched_RTBalance(void);
+
 //***************************************************************************
 // Scheduler RunTime
 
 // Realtime task scheduler
 void TaskSched_RTScheduler(void);
 
-// Background task scheduler
+// Background task scheduler, never returns
 void TaskSched_BackgroundScheduler(void);
 
+// Single background loop, for callers owning the loop (host simulation)
+void TaskSched_BackgroundLoop(void);
+
+// Background task scheduler of second core (AMP mode), never returns
+void TaskSched_BackgroundSchedulerCpu1(void);
+
 #endif
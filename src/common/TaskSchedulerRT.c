@@ -11,6 +11,8 @@
 /*                                                                          */
 /****************************************************************************/
 
+#include <string.h>
+
 #include "common\CommonDefines.h"
 #include "common\CommonUtility.h"
 #include "system\SystemStatus.h"
@@ -22,6 +24,8 @@
 #include "system\GlobalResetCodes.h"
 #include "drive\AxM-E-Defines.h"
 #include "system\SysLogManagement.h"
+#include "system\Os.h"
+#include "common\Snapshot.h"
     
 /////////////////////////////////////////////////////////////////////////////
 // Compiler Option
@@ -32,6 +36,354 @@
 
 static UWORD uwTaskSchedLocRstButCnt=0;
 
+    // trace tick written while trace ring is frozen
+static TASKSCHEDULER_RT_TRACE_TICK sTraceDiscard;
+
+#if TASKSCHEDULER_RT_PRECOMPILED
+    // dispatch lists per phase (even, odd) of the tasks selected by system
+    // status, NULL terminated, with the list generation and the status they
+    // are compiled for; only bits in some task mask make them stale
+static TASKSCHEDULER_RT_SCHEDULER_ENTRY * ppsRTDispatch[2][TASKSCHEDULER_RT_MAX_ENTRIES+1];
+static UWORD uwRTDispatchGen=0xFFFF;
+static SYSTEMSTATUS uRTDispatchStatus;
+static SYSTEMSTATUS uRTDispatchMask;
+    // lists partially compiled again in the slot for a status changed by a task
+static BOOL bRTDispatchStale;
+    // dispatch lists per rate group, 8kHz one unused as in the phase lists
+static TASKSCHEDULER_RT_SCHEDULER_ENTRY * ppsRateDispatch[TASKSCHEDULER_RATE_GROUPS][TASKSCHEDULER_RT_MAX_ENTRIES+1];
+#endif
+
+//***************************************************************************
+// Update task statistics with last execute time
+
+static inline void rtstatsupdate(TASKSCHEDULER_RT_STATS * psStats, UWORD uwTime)
+{
+    UWORD uwBucket;
+
+    psStats->ulCalls++;
+    psStats->ullTimeSum+=uwTime;
+    if(uwTime>psStats->uwMaxTime)
+        psStats->uwMaxTime=uwTime;
+    if(uwTime<psStats->uwMinTime)
+        psStats->uwMinTime=uwTime;
+
+        // log2 bucket, single CLZ instruction
+    uwBucket=uwTime?(UWORD)(32-__builtin_clz((ULONG)uwTime)):0;
+    if(uwBucket>=TASKSCHEDULER_RT_HISTO_BUCKETS)
+        uwBucket=TASKSCHEDULER_RT_HISTO_BUCKETS-1;
+    psStats->ulHisto[uwBucket]++;
+}
+
+//***************************************************************************
+// Reset task statistics
+
+static inline void rtstatsreset(TASKSCHEDULER_RT_STATS * psStats)
+{
+    memset(psStats, 0, sizeof(TASKSCHEDULER_RT_STATS));
+    psStats->uwMinTime=0xFFFF;
+}
+
+//***************************************************************************
+// Freeze trace ring, first event wins until rearmed
+
+static inline void rttracefreeze(UWORD uwReason)
+{
+    UWORD uwCt;
+
+    if(sTaskSchedRTTrace.uwReason!=TASKSCHEDULER_RT_TRACE_RUNNING)
+        return;
+
+    for(uwCt=0;uwCt<TASKSCHEDULER_RT_MAX_ENTRIES && tTaskSchedRTList[uwCt].pfTask;uwCt++);
+
+    sTaskSchedRTTrace.ulAbsoluteTime=ulSysTimersTotalPowerOnTime;
+    sTaskSchedRTTrace.uwTasks=uwCt;
+    sTaskSchedRTTrace.ulFreezeCnt++;
+    sTaskSchedRTTrace.uwReason=uwReason;
+}
+
+//***************************************************************************
+// Update boolean image of system status, just changed bits
+
+static inline void rtstatusunpack(void)
+{
+    static SYSTEMSTATUS uPrevStatus=0ul;
+    static SYSTEMSTATUS uPrevStatus2=0ul;
+    SYSTEMSTATUS uStatus=ulSystemStatus;
+    SYSTEMSTATUS uEdges;
+    UWORD uwBit;
+
+    uEdges=uStatus^uPrevStatus;
+    uPrevStatus=uStatus;
+    while(uEdges)
+    {
+        uwBit=(UWORD)(31-__builtin_clz(uEdges));
+        uEdges&=~SYSTEMSTATUS_MASK(uwBit);
+        sSystemStatus.b[uwBit]=(uStatus&SYSTEMSTATUS_MASK(uwBit))!=0ul;
+    }
+
+    uStatus=ulSystemStatus2;
+    uEdges=uStatus^uPrevStatus2;
+    uPrevStatus2=uStatus;
+    while(uEdges)
+    {
+        uwBit=(UWORD)(31-__builtin_clz(uEdges));
+        uEdges&=~SYSTEMSTATUS_MASK(uwBit);
+        sSystemStatus2.b[uwBit]=(uStatus&SYSTEMSTATUS_MASK(uwBit))!=0ul;
+    }
+}
+
+//***************************************************************************
+// Reload every # slots task downcounter, keeping phase if execution has been
+// carried over and applying phase shift requested by balancing
+
+static inline void rtslotreload(TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList)
+{
+    psList->uwSlotCnt=psList->uwNSlots-psList->uwDeferred+psList->uwSlotDelay;
+    psList->uwDeferred=0;
+    psList->uwSlotDelay=0;
+}
+
+//***************************************************************************
+// Optional task execution carried over to next slot: every # slots task is
+// retried at next slot and if carried over for the whole period then it's
+// dropped, next slot is the due one; other tasks count slots carried over
+
+static inline void rtcarryover(TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList, UBYTE ubFlags)
+{
+    if(ubFlags&TASKSCHEDULER_FLAG_EXEEVERYNSLOTS)
+    {
+        psList->uwSlotCnt=1;
+        if(++psList->uwDeferred>=psList->uwNSlots)
+            psList->uwDeferred=0;
+    }
+    else if(psList->uwDeferred<TASKSCHEDULER_RT_OPTIONAL_DEADLINE)
+        psList->uwDeferred++;
+}
+
+//***************************************************************************
+// Execute task with flags other than phase selection, return TRUE if run;
+// optional task is run if slot time is within standard time, a carried
+// over one is forced at its deadline, and reiterations stop at standard
+// time going on at next slot
+
+static inline BOOL rtexeflagged(TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList, UBYTE ubFlags, UWORD uwProfiler)
+{
+    BOOL bOptional=(ubFlags&TASKSCHEDULER_FLAG_OPTIONAL)!=0;
+
+    if(ubFlags&TASKSCHEDULER_FLAG_EXEEVERYNSLOTS)
+        if(--psList->uwSlotCnt)
+            return FALSE;
+
+    if(bOptional && timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwProfiler))>=TASKSCHEDULER_RT_STD_EXECUTION_TIME &&
+       ((ubFlags&TASKSCHEDULER_FLAG_EXEEVERYNSLOTS) || psList->uwDeferred<TASKSCHEDULER_RT_OPTIONAL_DEADLINE))
+    {
+        rtcarryover(psList, ubFlags);
+        return FALSE;
+    }
+
+    if(ubFlags&TASKSCHEDULER_FLAG_REITERATEIFREQ)
+    {
+        while((*psList->pfTask)(psList->uwArg))
+            if(bOptional && timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwProfiler))>=TASKSCHEDULER_RT_STD_EXECUTION_TIME)
+            {
+                    // every # slots task goes on at next slot, others
+                    // are run again anyway
+                if(ubFlags&TASKSCHEDULER_FLAG_EXEEVERYNSLOTS)
+                    rtcarryover(psList, ubFlags);
+                else
+                    psList->uwDeferred=0;
+                return TRUE;
+            }
+    }
+    else
+        (*psList->pfTask)(psList->uwArg);
+
+    if(ubFlags&TASKSCHEDULER_FLAG_EXEEVERYNSLOTS)
+        rtslotreload(psList);
+    else
+        psList->uwDeferred=0;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Task execute time accounting: statistics and trace, overrun is charged
+// to the task crossing the max time
+
+static inline void rtaccount(TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList, BOOL bRun, UWORD uwTaskTime, UWORD uwProfiler,
+    UWORD * puwSlotTime, TASKSCHEDULER_RT_TRACE_TICK * psTrace)
+{
+    UWORD uwTask;
+
+    psList->uwExeTime=timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwTaskTime));
+
+    if(bRun)
+    {
+        rtstatsupdate(&psList->sStats, psList->uwExeTime);
+        if(*puwSlotTime<=TASKSCHEDULER_RT_MAX_EXECUTION_TIME && *puwSlotTime+psList->uwExeTime>TASKSCHEDULER_RT_MAX_EXECUTION_TIME)
+            psList->sStats.ulOverruns++;
+
+            // trace enter/exit from slot start
+        uwTask=(UWORD)(psList-tTaskSchedRTList);
+        uwTaskTime=timer_100nscorrect(timer_profiler_end(uwTaskTime,uwProfiler));
+        psTrace->ulRunMask|=1ul<<uwTask;
+        psTrace->uwEnter[uwTask]=uwTaskTime;
+        psTrace->uwExit[uwTask]=uwTaskTime+psList->uwExeTime;
+    }
+
+    *puwSlotTime+=psList->uwExeTime;
+}
+
+#if TASKSCHEDULER_RT_PRECOMPILED
+//***************************************************************************
+// Compile into dispatch list the tasks of rate group from given entry on,
+// selected by status and not excluded by phase flags, keeping list order
+
+static TASKSCHEDULER_RT_SCHEDULER_ENTRY ** rtdispatchbuild(TASKSCHEDULER_RT_SCHEDULER_ENTRY ** ppsDispatch, TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList,
+    UWORD uwRate, UBYTE ubPhaseExclude, SYSTEMSTATUS uStatus)
+{
+    for(;psList<&tTaskSchedRTList[TASKSCHEDULER_RT_MAX_ENTRIES] && psList->pfTask;psList++)
+        if(psList->ubRate==uwRate && !(psList->ubFlags&ubPhaseExclude) && psList->uStatusSelect==(psList->uStatusMask&uStatus))
+            *ppsDispatch++=psList;
+    *ppsDispatch=NULL;
+
+    return ppsDispatch;
+}
+
+//***************************************************************************
+// Compile realtime task list for current system status into per phase
+// dispatch lists (even, odd) and per rate group lists, keeping list order
+
+static void rtdispatchcompile(void)
+{
+    TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList;
+    SYSTEMSTATUS uMask=0ul;
+    UWORD i;
+
+        // take generation first, a task added while compiling forces a new compile
+    uwRTDispatchGen=uwTaskSchedRTListGen;
+    uRTDispatchStatus=ulSystemStatus;
+    bRTDispatchStale=FALSE;
+
+    for(psList=tTaskSchedRTList;psList<&tTaskSchedRTList[TASKSCHEDULER_RT_MAX_ENTRIES] && psList->pfTask;psList++)
+        uMask|=psList->uStatusMask;
+    uRTDispatchMask=uMask;
+
+    rtdispatchbuild(ppsRTDispatch[0], tTaskSchedRTList, TASKSCHEDULER_RATE_8KHZ, TASKSCHEDULER_FLAG_EXECUTEODD, uRTDispatchStatus);
+    rtdispatchbuild(ppsRTDispatch[1], tTaskSchedRTList, TASKSCHEDULER_RATE_8KHZ, TASKSCHEDULER_FLAG_EXECUTEEVEN, uRTDispatchStatus);
+    for(i=0;i<TASKSCHEDULER_RATE_GROUPS;i++)
+        if(i!=TASKSCHEDULER_RATE_8KHZ)
+            rtdispatchbuild(ppsRateDispatch[i], tTaskSchedRTList, i, 0, uRTDispatchStatus);
+}
+
+//***************************************************************************
+// System status changed by the task just run: the rest of the list being
+// dispatched is compiled again for the new status, the whole lists are
+// compiled again at next use
+
+static inline void rtdispatchedge(TASKSCHEDULER_RT_SCHEDULER_ENTRY ** ppsDispatch, TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList,
+    UWORD uwRate, UBYTE ubPhaseExclude)
+{
+    if(!((ulSystemStatus^uRTDispatchStatus)&uRTDispatchMask))
+        return;
+
+    uRTDispatchStatus=ulSystemStatus;
+    bRTDispatchStale=TRUE;
+    rtdispatchbuild(ppsDispatch, psList+1, uwRate, ubPhaseExclude, uRTDispatchStatus);
+}
+
+//***************************************************************************
+// Compile dispatch lists again if tasks have been added or system status
+// changed on bits selecting some task
+
+static inline void rtdispatchcheck(void)
+{
+    if(uwRTDispatchGen!=uwTaskSchedRTListGen || bRTDispatchStale || ((ulSystemStatus^uRTDispatchStatus)&uRTDispatchMask))
+        rtdispatchcompile();
+}
+#endif
+
+//***************************************************************************
+// Run due rate groups in priority order after the slot task list; a group
+// not fitting its budget in the slot time left is carried over to next
+// slots up to its deadline, then it's forced and counted as missed
+
+static inline void rtrategroups(UWORD uwProfiler, UWORD * puwSlotTime, TASKSCHEDULER_RT_TRACE_TICK * psTrace)
+{
+    const TASKSCHEDULER_RATE_DEF * psDef;
+    TASKSCHEDULER_RATE_GROUP * psGroup;
+    TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList;
+#if TASKSCHEDULER_RT_PRECOMPILED
+    TASKSCHEDULER_RT_SCHEDULER_ENTRY ** ppsDispatch;
+#endif
+    UWORD uwOrder;
+    UWORD uwGroup;
+    UWORD uwGroupTime;
+    UWORD uwTaskTime;
+
+        // slot task list is the 8kHz group
+    uwGroupTime=timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwProfiler));
+    psGroup=&sTaskSchedRateGroup[TASKSCHEDULER_RATE_8KHZ];
+    rtstatsupdate(&psGroup->sStats, uwGroupTime);
+    if(uwGroupTime>sTaskSchedRateDefs[TASKSCHEDULER_RATE_8KHZ].uwBudget)
+        psGroup->sStats.ulOverruns++;
+
+    for(uwOrder=0;uwOrder<TASKSCHEDULER_RATE_GROUPS;uwOrder++)
+    {
+        uwGroup=ubTaskSchedRateOrder[uwOrder];
+        if(uwGroup==TASKSCHEDULER_RATE_8KHZ)
+            continue;
+        psDef=&sTaskSchedRateDefs[uwGroup];
+        psGroup=&sTaskSchedRateGroup[uwGroup];
+
+        if(--psGroup->uwSlotCnt)
+            continue;
+
+            // not enough time left in slot, carry over or force if deadline
+        if(timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwProfiler))+psDef->uwBudget>TASKSCHEDULER_RT_MAX_EXECUTION_TIME)
+        {
+            if(psGroup->uwDeferred<psDef->uwDeadline)
+            {
+                psGroup->uwSlotCnt=1;
+                psGroup->uwDeferred++;
+                continue;
+            }
+            psGroup->ulMissed++;
+        }
+
+        uwGroupTime=timer_profiler_start(uwSysTimers100ns);
+#if TASKSCHEDULER_RT_PRECOMPILED
+            // status may have been changed by slot tasks or previous groups
+        rtdispatchcheck();
+        ppsDispatch=ppsRateDispatch[uwGroup];
+        while((psList=*ppsDispatch++)!=NULL)
+        {
+#else
+        for(psList=tTaskSchedRTList;psList<&tTaskSchedRTList[TASKSCHEDULER_RT_MAX_ENTRIES] && psList->pfTask;psList++)
+        {
+            if(psList->ubRate!=uwGroup || psList->uStatusSelect != (psList->uStatusMask&ulSystemStatus))
+                continue;
+#endif
+            uwTaskTime=timer_profiler_start(uwSysTimers100ns);
+            (*psList->pfTask)(psList->uwArg);
+            rtaccount(psList, TRUE, uwTaskTime, uwProfiler, puwSlotTime, psTrace);
+#if TASKSCHEDULER_RT_PRECOMPILED
+            rtdispatchedge(ppsDispatch, psList, uwGroup, 0);
+#endif
+        }
+
+            // group profiling, overruns are budget overruns
+        uwGroupTime=timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwGroupTime));
+        rtstatsupdate(&psGroup->sStats, uwGroupTime);
+        if(uwGroupTime>psDef->uwBudget)
+            psGroup->sStats.ulOverruns++;
+
+            // keep phase if carried over
+        psGroup->uwSlotCnt=psDef->uwNSlots-psGroup->uwDeferred;
+        psGroup->uwDeferred=0;
+    }
+}
+
 //***************************************************************************
 // Realtime task scheduler; if defined TASKSCHED_REALTIME_IV the scheduler
 // will be invoked as interrupt
@@ -45,69 +397,95 @@ void TaskSched_RTScheduler(void)
 {
     static UWORD uwOverTimeSlotCnt=0;
     static BOOL bTempDisableOverTimeCheck=FALSE;
-    TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList=tTaskSchedRTList;
+    TASKSCHEDULER_RT_SCHEDULER_ENTRY * psList;
     UWORD uwProfiler;
     UWORD uwTaskTime;
+    UWORD uwSlotTime=0;
+    UWORD uwGroup;
+    BOOL bStatsReset=bTaskSchedRTStatsReset;
+    BOOL bRun;
+    TASKSCHEDULER_RT_TRACE_TICK * psTrace;
+#if TASKSCHEDULER_RT_PRECOMPILED
+    TASKSCHEDULER_RT_SCHEDULER_ENTRY ** ppsDispatch;
+#endif
 
         // restore default MAC settings as SAVEMAC does not
 //    OS_SETDEFAULT_ALU();
 
-    for(UWORD i=0;i<32;i++)
-    {
-    	sSystemStatus.b[i]  = (ulSystemStatus&(1<<i))==(1<<i); //sSystemStatus.l[i] = (ulSystemStatus&(1<<i))==(1<<i);
-    	sSystemStatus2.b[i] = (ulSystemStatus2&(1<<i))==(1<<i);
-    }
+        // realtime outputs are being updated until the end of the tick
+    Snapshot_RTPublishBegin();
+
+    rtstatusunpack();
 
     uwProfiler=timer_profiler_start(uwSysTimers100ns);
+    uwTaskSchedRTIsrNesting=Os_IsrNesting();
     bTaskSchedRealTimeRunning=TRUE;
     uwTaskSchedFreeTimer++;
     bTaskSchedRTExecutingOddPhase=!bTaskSchedRTExecutingOddPhase;
 
-    while(psList->pfTask)
+        // statistics reset, for all tasks even if not selected
+    if(bStatsReset)
+        for(psList=tTaskSchedRTList;psList<&tTaskSchedRTList[TASKSCHEDULER_RT_MAX_ENTRIES] && psList->pfTask;psList++)
+            rtstatsreset(&psList->sStats);
+    if(bStatsReset)
+        for(uwGroup=0;uwGroup<TASKSCHEDULER_RATE_GROUPS;uwGroup++)
+        {
+            rtstatsreset(&sTaskSchedRateGroup[uwGroup].sStats);
+            sTaskSchedRateGroup[uwGroup].ulMissed=0;
+        }
+
+        // trace tick to be filled, discarded if ring is frozen
+    if(sTaskSchedRTTrace.uwReason==TASKSCHEDULER_RT_TRACE_RUNNING)
+        psTrace=&sTaskSchedRTTrace.sTick[sTaskSchedRTTrace.ulHead&(TASKSCHEDULER_RT_TRACE_TICKS-1)];
+    else
+        psTrace=&sTraceDiscard;
+    psTrace->ulRunMask=0ul;
+
+#if TASKSCHEDULER_RT_PRECOMPILED
+        // phase, rate and status are yet resolved
+    rtdispatchcheck();
+    ppsDispatch=ppsRTDispatch[bTaskSchedRTExecutingOddPhase];
+    while((psList=*ppsDispatch++)!=NULL)
     {
+        UBYTE ubFlags=psList->ubFlags&~(TASKSCHEDULER_FLAG_EXECUTEODD|TASKSCHEDULER_FLAG_EXECUTEEVEN|TASKSCHEDULER_FLAG_FIXEDPHASE);
+
         uwTaskTime=timer_profiler_start(uwSysTimers100ns);
-        if(psList->ubFlags==TASKSCHEDULER_FLAG_NONE)
+        if(ubFlags==TASKSCHEDULER_FLAG_NONE)
         {
-            if(psList->uStatusSelect == (psList->uStatusMask&ulSystemStatus))
-                (*psList->pfTask)(psList->uwArg);
+            (*psList->pfTask)(psList->uwArg);
+            bRun=TRUE;
         }
         else
+            bRun=rtexeflagged(psList, ubFlags, uwProfiler);
+
+        rtaccount(psList, bRun, uwTaskTime, uwProfiler, &uwSlotTime, psTrace);
+        rtdispatchedge(ppsDispatch, psList, TASKSCHEDULER_RATE_8KHZ,
+            bTaskSchedRTExecutingOddPhase?TASKSCHEDULER_FLAG_EXECUTEEVEN:TASKSCHEDULER_FLAG_EXECUTEODD);
+    }
+#else
+    for(psList=tTaskSchedRTList;psList->pfTask;psList++)
+    {
+        bRun=FALSE;
+        uwTaskTime=timer_profiler_start(uwSysTimers100ns);
+        if(psList->ubRate==TASKSCHEDULER_RATE_8KHZ && psList->uStatusSelect == (psList->uStatusMask&ulSystemStatus))
         {
             UBYTE ubFlags=psList->ubFlags;
 
-            if(ubFlags&TASKSCHEDULER_FLAG_EXEEVERYNSLOTS)
+            if(ubFlags==TASKSCHEDULER_FLAG_NONE)
             {
-                if(--psList->uwSlotCnt)
-                    continue;
-                else
-                    psList->uwSlotCnt=psList->uwNSlots;
-            }
-
-            if(psList->uStatusSelect == (psList->uStatusMask&ulSystemStatus))
-            {
-                if(((ubFlags&TASKSCHEDULER_FLAG_EXECUTEODD) && !bTaskSchedRTExecutingOddPhase) || \
-                   ((ubFlags&TASKSCHEDULER_FLAG_EXECUTEEVEN) && bTaskSchedRTExecutingOddPhase))
-                    continue;
-
-                if(ubFlags&TASKSCHEDULER_FLAG_REITERATEIFREQ)
-                {
-                    do
-                    {
-                        if((ubFlags&TASKSCHEDULER_FLAG_OPTIONAL) && (timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwProfiler))>=TASKSCHEDULER_RT_STD_EXECUTION_TIME))
-                            continue;
-                    }
-                    while((*psList->pfTask)(psList->uwArg));
-                }
-
-                else
-                    if(!(ubFlags&TASKSCHEDULER_FLAG_OPTIONAL) || (timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwProfiler))<TASKSCHEDULER_RT_STD_EXECUTION_TIME))
-                        (*psList->pfTask)(psList->uwArg);
+                (*psList->pfTask)(psList->uwArg);
+                bRun=TRUE;
             }
+            else if(!((ubFlags&TASKSCHEDULER_FLAG_EXECUTEODD) && !bTaskSchedRTExecutingOddPhase) &&
+                    !((ubFlags&TASKSCHEDULER_FLAG_EXECUTEEVEN) && bTaskSchedRTExecutingOddPhase))
+                bRun=rtexeflagged(psList, ubFlags&~(TASKSCHEDULER_FLAG_EXECUTEODD|TASKSCHEDULER_FLAG_EXECUTEEVEN|TASKSCHEDULER_FLAG_FIXEDPHASE), uwProfiler);
         }
-        psList->uwExeTime = timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwTaskTime));
 
-        psList++;
+        rtaccount(psList, bRun, uwTaskTime, uwProfiler, &uwSlotTime, psTrace);
     }
+#endif
+
+    rtrategroups(uwProfiler, &uwSlotTime, psTrace);
 
 // SAIETTA don't have RESET button input, update on REV101
 #ifndef _HW_AXS
@@ -139,14 +517,26 @@ void TaskSched_RTScheduler(void)
 #endif
 #endif
 
+    if(bStatsReset)
+        bTaskSchedRTStatsReset=FALSE;
+
         // profiling
     uwProfiler=timer_100nscorrect(timer_profiler_end(uwSysTimers100ns,uwProfiler));
     if(uwProfiler>uwTaskSchedRTLocalMaxTime)
         uwTaskSchedRTLocalMaxTime=uwProfiler;
     ulTaskSchedRTLocalTimeSum+=(ULONG)uwProfiler;
 
+        // close trace tick, then publish it
+    psTrace->uwTick=uwTaskSchedFreeTimer;
+    psTrace->uwTime=uwProfiler;
+    if(psTrace!=&sTraceDiscard)
+        sTaskSchedRTTrace.ulHead++;
+
     bTaskSchedRealTimeRunning=FALSE;
 
+        // realtime outputs coherent again
+    Snapshot_RTPublishEnd();
+
         // recovery from plc overtime alarm
     if(bTempDisableOverTimeCheck)
     {
@@ -166,6 +556,7 @@ void TaskSched_RTScheduler(void)
                 // if PLC enabled then call PLC handler
             if(bSysStatPlcRunning)
             {
+                rttracefreeze(TASKSCHEDULER_RT_TRACE_PLCOVERTIME);
                 PlcRTOvertime();
                     // temporary disable check at next cycle
                 bTempDisableOverTimeCheck=TRUE;
@@ -175,6 +566,7 @@ void TaskSched_RTScheduler(void)
                 // otherwise overtime is only due to system, then fatal
             else
             {
+                rttracefreeze(TASKSCHEDULER_RT_TRACE_SYSOVERTIME);
 #if (defined(_DEBUG_TRACES))
     	      xil_printf("TaskSchedulerRT::TaskSched_RTScheduler() : FATAL_ERROR_RT_OVERTIME\r\n");
 #endif
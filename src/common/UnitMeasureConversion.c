@@ -86,52 +86,103 @@ static BOOL ShiftSelection(SWORD * pswShift, UWORD * puwSelection)
     return FALSE;
 }
 
+//***************************************************************************
+// Fused shift of the runtime conversion for selection and selected shift,
+// same as the original per call selection
+
+static SWORD ShiftFuse16to32(SWORD swShift, UWORD uwSelection)
+{
+    switch(uwSelection)
+    {
+        case 1:  return -swShift+16;
+        case 2:  return -swShift;
+        case 3:  return swShift;
+        default: return swShift-8;
+    }
+}
+
+static SWORD ShiftFuse32to16(SWORD swShift, UWORD uwSelection)
+{
+    switch(uwSelection)
+    {
+        case 1:  return swShift+16;
+        case 2:  return swShift;
+        case 3:  return -swShift;
+        default: return -swShift-8;
+    }
+}
+
 //***************************************************************************
 // Data structure initialization
 
 BOOL UmConv_Init_32to32(UMCONV_CONV32TO32 * sConvDS, DOUBL dbRatio)
 {
-    if(UmConv_MultShiftCalc(dbRatio, &sConvDS->slMult, &sConvDS->swShift, 32))
+    SWORD swShift, swSelShift;
+    UWORD uwSelection;
+
+    if(UmConv_MultShiftCalc(dbRatio, &sConvDS->slMult, &swShift, 32))
         return TRUE;
 
-    if(ShiftSelection(&sConvDS->swShift, &sConvDS->uwSelection))
+        // range check only, 64bit product is scaled back in one shift
+    swSelShift=swShift;
+    if(ShiftSelection(&swSelShift, &uwSelection))
         return TRUE;
 
+    sConvDS->ubRShift=(UBYTE)(32-swShift);
+
     return FALSE;
 }
 
 BOOL UmConv_Init_16to32(UMCONV_CONV16TO32 * sConvDS, DOUBL dbRatio)
 {
+    SWORD swShift;
+    UWORD uwSelection;
 
-    if(UmConv_MultShiftCalc(dbRatio, &sConvDS->slMult, &sConvDS->swShift, 32))
+    if(UmConv_MultShiftCalc(dbRatio, &sConvDS->slMult, &swShift, 32))
         return TRUE;
 
-    sConvDS->swShift-=16;
+    swShift-=16;
 
-    if(ShiftSelection(&sConvDS->swShift, &sConvDS->uwSelection))
+    if(ShiftSelection(&swShift, &uwSelection))
         return TRUE;
 
-    if(sConvDS->uwSelection>4)
+    if(uwSelection>4)
         return TRUE;
 
+    sConvDS->ubRShift=(UBYTE)(16-ShiftFuse16to32(swShift, uwSelection));
+
     return FALSE;
 }
 
 BOOL UmConv_Init_32to16(UMCONV_CONV32TO16 * sConvDS, DOUBL dbRatio)
 {
     SLONG slMult;
+    SWORD swShift;
+    UWORD uwSelection;
 
-    if(UmConv_MultShiftCalc(dbRatio, &slMult, &sConvDS->swShift, 16))
+    if(UmConv_MultShiftCalc(dbRatio, &slMult, &swShift, 16))
         return TRUE;
 
     sConvDS->swMult=(SWORD)(slMult&0xffff);
 
-    if(ShiftSelection(&sConvDS->swShift, &sConvDS->uwSelection))
+    if(ShiftSelection(&swShift, &uwSelection))
         return TRUE;
 
-    if(sConvDS->uwSelection>4)
+    if(uwSelection>4)
         return TRUE;
 
+    swShift=ShiftFuse32to16(swShift, uwSelection);
+    if(swShift>=0)
+    {
+        sConvDS->ubPreLShift=0;
+        sConvDS->ubPreRShift=(UBYTE)swShift;
+    }
+    else
+    {
+        sConvDS->ubPreLShift=(UBYTE)-swShift;
+        sConvDS->ubPreRShift=0;
+    }
+
     return FALSE;
 }
 
@@ -17,35 +17,35 @@
 #include "CommonDefines.h"
 
 //***************************************************************************
-// Conversion data structure
+// Conversion data structure: multiplier and shifts are fused at init time,
+// so that the runtime conversion is one multiply and one shift, with no
+// selection
 
 typedef struct _umconv_32to32
 {
     SLONG slMult;
-    SWORD swShift;
-    UWORD uwSelection;
+    UBYTE ubRShift;     // right shift of 64bit product
 } UMCONV_CONV32TO32;
 
 typedef struct _umconv_16to32
 {
     SLONG slMult;
-    SWORD swShift;
-    UWORD uwSelection;
+    UBYTE ubRShift;     // right shift of 48bit product
 } UMCONV_CONV16TO32;
 
 typedef struct _umconv_32to16
 {
     SWORD swMult;
-    SWORD swShift;
-    UWORD uwSelection;
+    UBYTE ubPreLShift;  // input prescaling before the multiply,
+    UBYTE ubPreRShift;  // at most one of them is not zero
 } UMCONV_CONV32TO16;
 
 //***************************************************************************
 // Macros for conversion
 
-#define UMCONV_CONVERT_32TO32(ds,val)  (UmConv_Convert_32to32((ds)->slMult, (ds)->swShift, (val), (ds)->uwSelection))
-#define UMCONV_CONVERT_16TO32(ds,val)  (UmConv_Convert_16to32((ds)->slMult, (ds)->swShift, (val), (ds)->uwSelection))
-#define UMCONV_CONVERT_32TO16(ds,val)  (UmConv_Convert_32to16((ds)->swMult, (ds)->swShift, (val), (ds)->uwSelection))
+#define UMCONV_CONVERT_32TO32(ds,val)  (UmConv_Convert_32to32((ds), (val)))
+#define UMCONV_CONVERT_16TO32(ds,val)  (UmConv_Convert_16to32((ds), (val)))
+#define UMCONV_CONVERT_32TO16(ds,val)  (UmConv_Convert_32to16((ds), (val)))
 
 //***************************************************************************
 // Data structure initialization: fill-up the conversion data structure
@@ -70,9 +70,35 @@ BOOL UmConv_Init_16to32_Rev(UMCONV_CONV16TO32 *, UMCONV_CONV32TO16 *, DOUBL);
 // Conversion modules, not to be called directly but via
 // UMCONV_CONVERT_* macros
 
-SLONG UmConv_Convert_32to32(SLONG mult, SWORD shift, SLONG value, UWORD sel);
-SLONG UmConv_Convert_16to32(SLONG mult, SWORD shift, SWORD value, UWORD sel);
-SWORD UmConv_Convert_32to16(SWORD mult, SWORD shift, SLONG value, UWORD sel);
+static inline SLONG UmConv_Convert_32to32(const UMCONV_CONV32TO32 * psConv, SLONG slValue)
+{
+    SLLNG sllRes=((SLLNG)slValue*psConv->slMult)>>psConv->ubRShift;
+
+    if(sllRes>SLONG_MAX_VALUE)
+        return SLONG_MAX_VALUE;
+    if(sllRes<SLONG_MIN_VALUE)
+        return SLONG_MIN_VALUE;
+    return (SLONG)sllRes;
+}
+
+// Value_32 = ((Value_16 * 2^shift) * mult) / 65536
+static inline SLONG UmConv_Convert_16to32(const UMCONV_CONV16TO32 * psConv, SWORD swValue)
+{
+    return (SLONG)(((SLLNG)swValue*psConv->slMult)>>psConv->ubRShift);
+}
+
+// Value_16 = ((Value_32 / 2^shift) * mult) / 65536
+static inline SWORD UmConv_Convert_32to16(const UMCONV_CONV32TO16 * psConv, SLONG slValue)
+{
+    return (SWORD)(((((SLLNG)slValue<<psConv->ubPreLShift)>>psConv->ubPreRShift)*psConv->swMult)>>16);
+}
+
+//***************************************************************************
+// Bulk conversion of whole arrays with the same conversion data structure
+
+void UmConv_Convert_32to32_Bulk(const UMCONV_CONV32TO32 * psConv, SLONG * pslDst, const SLONG * pslSrc, UWORD uwNum);
+void UmConv_Convert_16to32_Bulk(const UMCONV_CONV16TO32 * psConv, SLONG * pslDst, const SWORD * pswSrc, UWORD uwNum);
+void UmConv_Convert_32to16_Bulk(const UMCONV_CONV32TO16 * psConv, SWORD * pswDst, const SLONG * pslSrc, UWORD uwNum);
 
 //***************************************************************************
 // Multiplier and scaler computing
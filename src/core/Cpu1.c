@@ -0,0 +1,182 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : Cpu1.c                                                     */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Second Cortex-A9 core start (AMP)                           */
+/*                                                                          */
+/****************************************************************************/
+
+#include "xil_io.h"
+#include "xil_cache.h"
+
+#include "common\CommonDefines.h"
+#include "core\Cpu1.h"
+
+//***************************************************************************
+// Defines
+
+    // Boot data passed to CPU1 start code, read with MMU and caches off
+typedef struct
+{
+    ULONG ulTtbr0;                              // translation table base
+    ULONG ulDacr;                               // domain access control
+    ULONG ulSctlr;                              // system control (MMU, caches)
+    ULONG ulStack;                              // stack top
+    ULONG ulMain;                               // entry point
+    ULONG ulExcStack;                           // exception modes stack top
+    volatile ULONG ulFault;                     // vector offset + 1 of exception CPU1 stopped on, 0 if running
+    volatile ULONG ulFaultLr;                   // and its return address
+} CPU1_BOOT;
+
+//***************************************************************************
+// Globals
+
+    // referenced by name from CPU1 start code
+CPU1_BOOT sCpu1Boot;
+
+//***************************************************************************
+// Locals
+
+static ULLNG ullCpu1Stack[CPU1_STACK_SIZE/sizeof(ULLNG)];
+static ULLNG ullCpu1ExcStack[CPU1_EXC_STACK_SIZE/sizeof(ULLNG)];
+
+    // set before release, CPU1 reads it already set
+static volatile BOOL bCpu1Started;
+
+//***************************************************************************
+// CPU1 exception: record it in boot data for the debugger and stop the
+// core, as no handler is installed there
+
+static void __attribute__((used)) cpu1fault(ULONG ulVector, ULONG ulLr)
+{
+    sCpu1Boot.ulFaultLr=ulLr;
+    sCpu1Boot.ulFault=ulVector+1;
+    __asm__ __volatile__ ("dsb" ::: "memory");
+
+    for(;;)
+        __asm__ __volatile__ ("wfe");
+}
+
+//***************************************************************************
+// CPU1 start code: own stack, L1 data cache invalidate (content is undefined
+// after reset), SMP coherency, then CPU0 translation table, domains and
+// system control, then own vectors with exception modes stack, VFP/NEON
+// access, then entry point
+
+static void __attribute__((naked)) cpu1entry(void)
+{
+    __asm__ __volatile__ (
+        "   cpsid   if                      \n"
+        "   ldr     r4, =sCpu1Boot          \n"
+        "   ldr     sp, [r4, #12]           \n"
+        "   bl      Xil_L1DCacheInvalidate  \n"
+        "   mrc     p15, 0, r0, c1, c0, 1   \n"
+        "   orr     r0, r0, #0x41           \n"      // ACTLR: SMP, FW
+        "   mcr     p15, 0, r0, c1, c0, 1   \n"
+        "   ldr     r0, [r4, #0]            \n"
+        "   mcr     p15, 0, r0, c2, c0, 0   \n"      // TTBR0
+        "   ldr     r0, [r4, #4]            \n"
+        "   mcr     p15, 0, r0, c3, c0, 0   \n"      // DACR
+        "   mov     r0, #0                  \n"
+        "   mcr     p15, 0, r0, c8, c7, 0   \n"      // TLB invalidate
+        "   mcr     p15, 0, r0, c7, c5, 0   \n"      // I-cache invalidate
+        "   dsb                             \n"
+        "   isb                             \n"
+        "   ldr     r0, [r4, #8]            \n"
+        "   bic     r0, r0, #0x2000         \n"      // SCTLR.V: vectors at VBAR
+        "   mcr     p15, 0, r0, c1, c0, 0   \n"      // SCTLR
+        "   isb                             \n"
+        "   adr     r0, .Lcpu1vectors       \n"
+        "   mcr     p15, 0, r0, c12, c0, 0  \n"      // VBAR
+        "   ldr     r0, [r4, #20]           \n"
+        "   cps     #0x1b                   \n"      // undefined
+        "   mov     sp, r0                  \n"
+        "   cps     #0x17                   \n"      // abort
+        "   mov     sp, r0                  \n"
+        "   cps     #0x12                   \n"      // IRQ
+        "   mov     sp, r0                  \n"
+        "   cps     #0x11                   \n"      // FIQ
+        "   mov     sp, r0                  \n"
+        "   cps     #0x13                   \n"      // back to supervisor
+        "   mrc     p15, 0, r0, c1, c0, 2   \n"
+        "   orr     r0, r0, #0x00f00000     \n"      // CPACR: cp10, cp11 full access
+        "   mcr     p15, 0, r0, c1, c0, 2   \n"
+        "   isb                             \n"
+        "   mov     r0, #0x40000000         \n"
+        "   vmsr    fpexc, r0               \n"      // FPEXC.EN
+        "   ldr     r0, [r4, #16]           \n"
+        "   blx     r0                      \n"
+        "1: wfe                             \n"
+        "   b       1b                      \n"
+        "   .ltorg                          \n"
+        "   .align  5                       \n"      // VBAR alignment
+        ".Lcpu1vectors:                     \n"
+        "   b       .Lcpu1reset             \n"
+        "   b       .Lcpu1undef             \n"
+        "   b       .Lcpu1svc               \n"
+        "   b       .Lcpu1pabort            \n"
+        "   b       .Lcpu1dabort            \n"
+        "   b       .Lcpu1reserved          \n"
+        "   b       .Lcpu1irq               \n"
+        "   b       .Lcpu1fiq               \n"
+        ".Lcpu1reset:    mov r0, #0x00      \n"
+        "   b       .Lcpu1trap              \n"
+        ".Lcpu1undef:    mov r0, #0x04      \n"
+        "   b       .Lcpu1trap              \n"
+        ".Lcpu1svc:      mov r0, #0x08      \n"
+        "   b       .Lcpu1trap              \n"
+        ".Lcpu1pabort:   mov r0, #0x0c      \n"
+        "   b       .Lcpu1trap              \n"
+        ".Lcpu1dabort:   mov r0, #0x10      \n"
+        "   b       .Lcpu1trap              \n"
+        ".Lcpu1reserved: mov r0, #0x14      \n"
+        "   b       .Lcpu1trap              \n"
+        ".Lcpu1irq:      mov r0, #0x18      \n"
+        "   b       .Lcpu1trap              \n"
+        ".Lcpu1fiq:      mov r0, #0x1c      \n"
+        ".Lcpu1trap:                        \n"
+        "   mov     r1, lr                  \n"
+        "   b       cpu1fault               \n");
+}
+
+//***************************************************************************
+// Start second core at entry point, with CPU0 translation table and caches
+// setup; entry point never returns
+
+void Cpu1_Start(void (* pfMain)(void))
+{
+    ULONG ulReg;
+
+    __asm__ __volatile__ ("mrc p15, 0, %0, c2, c0, 0" : "=r" (ulReg));
+    sCpu1Boot.ulTtbr0=ulReg;
+    __asm__ __volatile__ ("mrc p15, 0, %0, c3, c0, 0" : "=r" (ulReg));
+    sCpu1Boot.ulDacr=ulReg;
+    __asm__ __volatile__ ("mrc p15, 0, %0, c1, c0, 0" : "=r" (ulReg));
+    sCpu1Boot.ulSctlr=ulReg;
+    sCpu1Boot.ulStack=(ULONG)&ullCpu1Stack[CPU1_STACK_SIZE/sizeof(ULLNG)];
+    sCpu1Boot.ulMain=(ULONG)pfMain;
+    sCpu1Boot.ulExcStack=(ULONG)&ullCpu1ExcStack[CPU1_EXC_STACK_SIZE/sizeof(ULLNG)];
+    sCpu1Boot.ulFault=sCpu1Boot.ulFaultLr=0;
+    bCpu1Started=TRUE;
+
+        // CPU1 reads boot data and writes its stack with caches off
+    Xil_DCacheFlushRange((INTPTR)&sCpu1Boot, sizeof(sCpu1Boot));
+    Xil_DCacheFlushRange((INTPTR)ullCpu1Stack, sizeof(ullCpu1Stack));
+
+        // release CPU1 from the FSBL wait loop
+    Xil_Out32(CPU1_START_ADDR, (ULONG)&cpu1entry);
+    Xil_DCacheFlushRange((INTPTR)CPU1_START_ADDR, sizeof(ULONG));
+    __asm__ __volatile__ ("dsb\n sev" ::: "memory");
+}
+
+//***************************************************************************
+// TRUE once second core started
+
+BOOL Cpu1_IsStarted(void)
+{
+    return bCpu1Started;
+}
@@ -0,0 +1,38 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : Cpu1.h                                                     */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Second Cortex-A9 core start (AMP)                           */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _CPU1_H
+#define _CPU1_H
+
+//****************************************************************************
+// Defines
+
+    // CPU1 start address register polled by the FSBL wait loop
+#define CPU1_START_ADDR                 0xFFFFFFF0ul
+
+    // CPU1 own stack, bytes
+#define CPU1_STACK_SIZE                 4096
+
+    // CPU1 exception modes stack, shared as any exception stops the core
+#define CPU1_EXC_STACK_SIZE             256
+
+//****************************************************************************
+// Globals functions
+
+// Start second core at entry point, with CPU0 translation table and caches
+// setup; entry point never returns
+void Cpu1_Start(void (*)(void));
+
+// TRUE once second core started, from both cores
+BOOL Cpu1_IsStarted(void);
+
+#endif
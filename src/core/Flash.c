@@ -43,6 +43,9 @@
 #define WRITE_DISABLE_CMD       0x04
 #define WRITE_ENABLE_CMD        0x06
 #define READ_STATUS_CMD         0x05
+#define READ_FLAG_STATUS_CMD    0x70 // Micron
+#define CLEAR_FLAG_STATUS_CMD   0x50 // Micron
+#define CLEAR_STATUS_CMD        0x30 // Spansion
 #define FAST_READ_CMD           0x0B
 #define DUAL_READ_CMD           0x3B
 #define QUAD_READ_CMD           0x6B
@@ -413,103 +416,250 @@ u32 FlashLinearRead(u32 Address, u8 * hpdata, u32 ByteCount)
 /*****************************************************************************/
 /**
 *
-* This function writes to the  serial FLASH connected to the QSPI interface.
-* All the data put into the buffer must be in the same page of the device with
-* page boundaries being on 256 byte boundaries.
+* This function starts a page program of the serial FLASH connected to the
+* QSPI interface and returns without waiting for its completion, that must
+* be checked with FlashBusy(). All the data must be in the same page of the
+* device, with page boundaries being on 256 byte boundaries.
 *
 * @param	Address contains the address to write data to in the FLASH.
+* @param	hpdata contains the data to write.
 * @param	ByteCount contains the number of bytes to write.
-* @param	Command is the command used to write data to the flash. QSPI
-*		device supports only Page Program command to write data to the
-*		flash.
 *
 * @return	None.
 *
-* @note		None.
+* @note		The controller is back in linear mode on return, but linear
+*		reads return undefined data until the device is busy.
 *
 ******************************************************************************/
-void FlashWrite(u32 Address, u8 *hpdata, u32 ByteCount)
+void FlashProgramStart(u32 Address, const u8 *hpdata, u32 ByteCount)
 {
     u8 WriteEnableCmd = { WRITE_ENABLE_CMD };
-    u8 ReadStatusCmd[] = { READ_STATUS_CMD, 0 };  /* must send 2 bytes */
-    u8 FlashStatus[2];
-    u32 BaseAddress,StartAddress,NextAddress;
-    u32 LeftSize,WriteSize;
-
-    BaseAddress=StartAddress=Address;
-    LeftSize=ByteCount;
 
     if(QspiInstancePtr == NULL)
         QspiInstancePtr = &QspiInstance;
 
     FlashCmdMode();
 
-    while(LeftSize>0)
-    {
-        // Calculate start address and write size
-        NextAddress = (StartAddress/PAGE_SIZE + 1)*PAGE_SIZE;
-        WriteSize = LeftSize;
-        if(StartAddress + WriteSize > NextAddress) // if write beyond the end of the current page
-            WriteSize = NextAddress - StartAddress;
+    /*
+     * Setup the write command with the specified address and data for the
+     * FLASH
+     */
+    WriteBuffer[COMMAND_OFFSET]   = WRITE_CMD;
+    WriteBuffer[ADDRESS_1_OFFSET] = (u8)((Address & 0xFF0000) >> 16);
+    WriteBuffer[ADDRESS_2_OFFSET] = (u8)((Address & 0xFF00) >> 8);
+    WriteBuffer[ADDRESS_3_OFFSET] = (u8)(Address & 0xFF);
 
-        /*
-         * Setup the write command with the specified address and data for the
-         * FLASH
-         */
-        WriteBuffer[COMMAND_OFFSET]   = WRITE_CMD;
-        WriteBuffer[ADDRESS_1_OFFSET] = (u8)((StartAddress & 0xFF0000) >> 16);
-        WriteBuffer[ADDRESS_2_OFFSET] = (u8)((StartAddress & 0xFF00) >> 8);
-        WriteBuffer[ADDRESS_3_OFFSET] = (u8)(StartAddress & 0xFF);
+    // Copy write data
+    memcpy(&WriteBuffer[OVERHEAD_SIZE],hpdata,ByteCount);
+
+    /*
+     * Send the write enable command to the FLASH so that it can be
+     * written to, this needs to be sent as a separate transfer before
+     * the write
+     */
+    XQspiPs_PolledTransfer(QspiInstancePtr, &WriteEnableCmd, NULL,
+                sizeof(WriteEnableCmd));
 
-        // Copy write data
-        memcpy(&WriteBuffer[OVERHEAD_SIZE],&hpdata[StartAddress-BaseAddress],WriteSize);
+    /*
+     * Send the write command, address, and data to the FLASH to be
+     * written, no receive buffer is specified since there is nothing to
+     * receive
+     */
+    XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, NULL, ByteCount + OVERHEAD_SIZE);
 
+    FlashLinearMode();
+}
+
+/*****************************************************************************/
+/**
+*
+* This function starts the erase of one erase unit of the serial FLASH
+* connected to the QSPI interface and returns without waiting for its
+* completion, that must be checked with FlashBusy().
+*
+* @param	Address contains the address of the unit to be erased.
+* @param	EraseSize selects the unit: SUBSECTOR_SIZE, SECTOR_SIZE or
+*		the total size of the flash (bulk erase).
+*
+* @return	None.
+*
+* @note		As FlashProgramStart().
+*
+******************************************************************************/
+void FlashEraseStart(u32 Address, u32 EraseSize)
+{
+    u8 WriteEnableCmd = { WRITE_ENABLE_CMD };
+
+    if(QspiInstancePtr == NULL)
+        QspiInstancePtr = &QspiInstance;
+
+    FlashCmdMode();
+
+    /*
+     * Send the write enable command to the FLASH so that it can be
+     * written to, this needs to be sent as a separate transfer
+     * before the erase
+     */
+    XQspiPs_PolledTransfer(QspiInstancePtr, &WriteEnableCmd, NULL,
+              sizeof(WriteEnableCmd));
+
+    if (EraseSize == (NUM_SECTORS * SECTOR_SIZE)) {
         /*
-         * Send the write enable command to the FLASH so that it can be
-         * written to, this needs to be sent as a separate transfer before
-         * the write
+         * Send the bulk erase command; no receive buffer is specified
+         * since there is nothing to receive
          */
-        XQspiPs_PolledTransfer(QspiInstancePtr, &WriteEnableCmd, NULL,
-                    sizeof(WriteEnableCmd));
+        WriteBuffer[COMMAND_OFFSET]   = BULK_ERASE_CMD;
 
+        XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, NULL,
+                    BULK_ERASE_SIZE);
+    }
+    else {
         /*
-         * Send the write command, address, and data to the FLASH to be
-         * written, no receive buffer is specified since there is nothing to
-         * receive
+         * Send the sector erase command and address; no receive buffer
+         * is specified since there is nothing to receive
          */
-        XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, NULL, WriteSize + OVERHEAD_SIZE);
+        WriteBuffer[COMMAND_OFFSET]   = EraseSize>SUBSECTOR_SIZE ? SEC_ERASE_CMD : SUBSEC_ERASE_CMD;
+        WriteBuffer[ADDRESS_1_OFFSET] = (u8)(Address >> 16);
+        WriteBuffer[ADDRESS_2_OFFSET] = (u8)(Address >> 8);
+        WriteBuffer[ADDRESS_3_OFFSET] = (u8)(Address & 0xFF);
+
+        XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, NULL,
+                    SEC_ERASE_SIZE);
+    }
+
+    FlashLinearMode();
+}
+
+/*****************************************************************************/
+/**
+*
+* This function reads once the status register of the serial FLASH
+* connected to the QSPI interface.
+*
+* @param	None.
+*
+* @return	1 if a program or erase operation is in progress, 0 otherwise.
+*
+* @note		If a value of 0xFF in the status byte is read from the device
+*		the device slave select is possibly incorrect such that the
+*		device status is not being read, and the device is always busy.
+*
+******************************************************************************/
+u32 FlashBusy(void)
+{
+    u8 ReadStatusCmd[] = { READ_STATUS_CMD, 0 };  /* must send 2 bytes */
+    u8 FlashStatus[2];
 
-        StartAddress += WriteSize;
-        LeftSize -= WriteSize;
+    if(QspiInstancePtr == NULL)
+        QspiInstancePtr = &QspiInstance;
+
+    FlashCmdMode();
+
+    XQspiPs_PolledTransfer(QspiInstancePtr, ReadStatusCmd, FlashStatus,
+                sizeof(ReadStatusCmd));
+
+    FlashLinearMode();
+
+    FlashStatus[1] |= FlashStatus[0];
+
+    return (FlashStatus[1] & 0x01);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function reads and clears the error flags of the last program or
+* erase command of the serial FLASH connected to the QSPI interface, to be
+* called once FlashBusy() returns 0.
+*
+* @param	None.
+*
+* @return	1 if the last program or erase command failed (e.g. protected
+*		area, worn out block), 0 otherwise.
+*
+* @note		Only Micron and Spansion devices report failures, the others
+*		always return 0.
+*
+******************************************************************************/
+u32 FlashCmdFailed(void)
+{
+    u8 ReadStatusCmd[] = { 0, 0 };  /* must send 2 bytes */
+    u8 FlashStatus[2];
+    u8 ClearStatusCmd;
+    u8 FailMask;
+
+    if (QspiFlashMake == MICRON_ID) {
+        ReadStatusCmd[0] = READ_FLAG_STATUS_CMD;
+        ClearStatusCmd = CLEAR_FLAG_STATUS_CMD;
+        FailMask = 0x32;    /* erase, program, protection */
+    } else if (QspiFlashMake == SPANSION_ID) {
+        ReadStatusCmd[0] = READ_STATUS_CMD;
+        ClearStatusCmd = CLEAR_STATUS_CMD;
+        FailMask = 0x60;    /* P_ERR, E_ERR */
+    } else {
+        return 0;
+    }
+
+    if(QspiInstancePtr == NULL)
+        QspiInstancePtr = &QspiInstance;
+
+    FlashCmdMode();
+
+    XQspiPs_PolledTransfer(QspiInstancePtr, ReadStatusCmd, FlashStatus,
+                sizeof(ReadStatusCmd));
+
+    FlashStatus[1] |= FlashStatus[0];
+
+    if (FlashStatus[1] & FailMask) {
+        XQspiPs_PolledTransfer(QspiInstancePtr, &ClearStatusCmd, NULL,
+                    sizeof(ClearStatusCmd));
+    }
+
+    FlashLinearMode();
+
+    return ((FlashStatus[1] & FailMask) ? 1 : 0);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function writes to the  serial FLASH connected to the QSPI interface
+* and waits for the completion, page by page.
+*
+* @param	Address contains the address to write data to in the FLASH.
+* @param	hpdata contains the data to write.
+* @param	ByteCount contains the number of bytes to write.
+*
+* @return	None.
+*
+* @note		Busy waiting, used at boot; the application uses the
+*		request queue of common\FlashQueue.c instead.
+*
+******************************************************************************/
+void FlashWrite(u32 Address, u8 *hpdata, u32 ByteCount)
+{
+    u32 NextAddress,WriteSize;
+
+    while(ByteCount>0)
+    {
+        // Calculate write size up to the end of the current page
+        NextAddress = (Address/PAGE_SIZE + 1)*PAGE_SIZE;
+        WriteSize = ByteCount;
+        if(Address + WriteSize > NextAddress)
+            WriteSize = NextAddress - Address;
+
+        FlashProgramStart(Address, hpdata, WriteSize);
+
+        hpdata += WriteSize;
+        Address += WriteSize;
+        ByteCount -= WriteSize;
 
         /*
          * Wait for the write command to the FLASH to be completed, it takes
          * some time for the data to be written
          */
-        while (1) {
-            /*
-             * Poll the status register of the FLASH to determine when it
-             * completes, by sending a read status command and receiving the
-             * status byte
-             */
-            XQspiPs_PolledTransfer(QspiInstancePtr, ReadStatusCmd, FlashStatus,
-                        sizeof(ReadStatusCmd));
-
-            /*
-             * If the status indicates the write is done, then stop waiting,
-             * if a value of 0xFF in the status byte is read from the
-             * device and this loop never exits, the device slave select is
-             * possibly incorrect such that the device status is not being
-             * read
-             */
-            FlashStatus[1] |= FlashStatus[0];
-            if ((FlashStatus[1] & 0x01) == 0) {
-                break;
-            }
-        }
+        while (FlashBusy());
     }
-
-    FlashLinearMode();
 }
 
 #pragma GCC push_options
@@ -518,7 +668,7 @@ void FlashWrite(u32 Address, u8 *hpdata, u32 ByteCount)
 /**
 *
 * This function erases the sectors in the  serial FLASH connected to the
-* QSPI interface.
+* QSPI interface and waits for the completion.
 *
 * @param	Address contains the address of the first sector which needs to
 *		be erased.
@@ -526,69 +676,22 @@ void FlashWrite(u32 Address, u8 *hpdata, u32 ByteCount)
 *
 * @return	None.
 *
-* @note		None.
+* @note		Busy waiting, as FlashWrite().
 *
 ******************************************************************************/
 void FlashErase(u32 Address, u32 ByteCount)
 {
-    u8 WriteEnableCmd = { WRITE_ENABLE_CMD };
-    u8 ReadStatusCmd[] = { READ_STATUS_CMD, 0 };  /* must send 2 bytes */
-    u8 FlashStatus[2];
     int Sector;
 
-    if(QspiInstancePtr == NULL)
-        QspiInstancePtr = &QspiInstance;
-
-    FlashCmdMode();
-
     /*
      * If erase size is same as the total size of the flash, use bulk erase
      * command
      */
     if (ByteCount == (NUM_SECTORS * SECTOR_SIZE)) {
-        /*
-         * Send the write enable command to the FLASH so that it can be
-         * written to, this needs to be sent as a separate transfer
-         * before the erase
-         */
-        XQspiPs_PolledTransfer(QspiInstancePtr, &WriteEnableCmd, NULL,
-                  sizeof(WriteEnableCmd));
-
-        /* Setup the bulk erase command*/
-        WriteBuffer[COMMAND_OFFSET]   = BULK_ERASE_CMD;
-
-        /*
-         * Send the bulk erase command; no receive buffer is specified
-         * since there is nothing to receive
-         */
-        XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, NULL,
-                    BULK_ERASE_SIZE);
+        FlashEraseStart(Address, ByteCount);
 
         /* Wait for the erase command to the FLASH to be completed*/
-        while (1) {
-            /*
-             * Poll the status register of the device to determine
-             * when it completes, by sending a read status command
-             * and receiving the status byte
-             */
-            XQspiPs_PolledTransfer(QspiInstancePtr, ReadStatusCmd,
-                        FlashStatus,
-                        sizeof(ReadStatusCmd));
-
-            /*
-             * If the status indicates the write is done, then stop
-             * waiting; if a value of 0xFF in the status byte is
-             * read from the device and this loop never exits, the
-             * device slave select is possibly incorrect such that
-             * the device status is not being read
-             */
-            FlashStatus[1] |= FlashStatus[0];
-            if ((FlashStatus[1] & 0x01) == 0) {
-                break;
-            }
-        }
-
-        FlashLinearMode();
+        while (FlashBusy());
         return;
     }
 
@@ -597,62 +700,16 @@ void FlashErase(u32 Address, u32 ByteCount)
      * sector erase command
      */
     for (Sector = 0; Sector < (((ByteCount-1) / SECTOR_SIZE) + 1); Sector++) {
-        /*
-         * Send the write enable command to the SEEPOM so that it can be
-         * written to, this needs to be sent as a separate transfer
-         * before the write
-         */
-        XQspiPs_PolledTransfer(QspiInstancePtr, &WriteEnableCmd, NULL,
-                  sizeof(WriteEnableCmd));
-
-        /*
-         * Setup the write command with the specified address and data
-         * for the FLASH
-         */
-        WriteBuffer[COMMAND_OFFSET]   = ByteCount>SUBSECTOR_SIZE ? SEC_ERASE_CMD : SUBSEC_ERASE_CMD;
-
-        WriteBuffer[ADDRESS_1_OFFSET] = (u8)(Address >> 16);
-        WriteBuffer[ADDRESS_2_OFFSET] = (u8)(Address >> 8);
-        WriteBuffer[ADDRESS_3_OFFSET] = (u8)(Address & 0xFF);
-
-        /*
-         * Send the sector erase command and address; no receive buffer
-         * is specified since there is nothing to receive
-         */
-        XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, NULL,
-                    SEC_ERASE_SIZE);
+        FlashEraseStart(Address, ByteCount>SUBSECTOR_SIZE ? SECTOR_SIZE : SUBSECTOR_SIZE);
 
         /*
          * Wait for the sector erse command to the
          * FLASH to be completed
          */
-        while (1) {
-            /*
-             * Poll the status register of the device to determine
-             * when it completes, by sending a read status command
-             * and receiving the status byte
-             */
-            XQspiPs_PolledTransfer(QspiInstancePtr, ReadStatusCmd,
-                        FlashStatus,
-                        sizeof(ReadStatusCmd));
-
-            /*
-             * If the status indicates the write is done, then stop
-             * waiting, if a value of 0xFF in the status byte is
-             * read from the device and this loop never exits, the
-             * device slave select is possibly incorrect such that
-             * the device status is not being read
-             */
-            FlashStatus[1] |= FlashStatus[0];
-            if ((FlashStatus[1] & 0x01) == 0) {
-                break;
-            }
-        }
+        while (FlashBusy());
 
         Address += SECTOR_SIZE;
     }
-
-    FlashLinearMode();
 }
 #pragma GCC pop_options
 
@@ -86,6 +86,10 @@ void FlashRead(u32 Address, u8 * hpdata, u32 ByteCount);
 u32  FlashLinearRead(u32 Address, u8 * hpdata, u32 ByteCount);
 void FlashWrite(u32 Address, u8 * hpdata, u32 ByteCount);
 u32  FlashErasedCheck( void * addr, u32 len );
+void FlashProgramStart(u32 Address, const u8 * hpdata, u32 ByteCount);
+void FlashEraseStart(u32 Address, u32 EraseSize);
+u32  FlashBusy(void);
+u32  FlashCmdFailed(void);
 
 /************************** Variable Definitions *****************************/
 extern u32 QspiFlashSize;
@@ -195,7 +195,7 @@ BOOL Biss_Init(UWORD uwChannelSel, ENCMGR_SPACEFEEDBACK * psFeedback, SBYTE * ps
     }
 
         // install rt task       
-    if(!TaskSched_AddRTTaskEx((BOOL (*)(UWORD))&task8kHz, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING)|ulRTDisMask, 0, (UWORD)&sRuntime[uwChannelSel]))
+    if(!TaskSched_AddRTTaskEx((BOOL (*)(ULONG))&task8kHz, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING)|ulRTDisMask, 0, (ULONG)&sRuntime[uwChannelSel]))
         return FALSE;
 
         // module valid
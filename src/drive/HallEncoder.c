@@ -121,7 +121,7 @@ BOOL Hl_Init(ENCMGR_SPACEFEEDBACK * psFeedback, SBYTE * psbEncMgrFault, ULONG ul
     return FALSE ;
   }
 
-  return TaskSched_AddRTTaskEx((BOOL (*)(UWORD))&HallEnc8KHz, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING)|ulRTDisMask, 0, (UWORD)&sHallRun) ; /* install 8KHz function */
+  return TaskSched_AddRTTaskEx((BOOL (*)(ULONG))&HallEnc8KHz, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING)|ulRTDisMask, 0, (ULONG)&sHallRun) ; /* install 8KHz function */
 }
 
 /* ######################################################################### */
@@ -276,7 +276,7 @@ BOOL Ic_EncoderInit(UWORD uwChannelSel, ENCMGR_SPACEFEEDBACK * psFeedback, SBYTE
       else
         rtf = &IncEnc8KHzPlcOnly;
 
-      if(!TaskSched_AddRTTaskEx((BOOL (*)(UWORD))rtf, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), 0, (UWORD)&sIncEncMainRun))
+      if(!TaskSched_AddRTTaskEx((BOOL (*)(ULONG))rtf, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), 0, (ULONG)&sIncEncMainRun))
         return FALSE;
 
       break;
@@ -295,7 +295,7 @@ BOOL Ic_EncoderInit(UWORD uwChannelSel, ENCMGR_SPACEFEEDBACK * psFeedback, SBYTE
       else
         rtf = &IncEnc8KHzPlcOnly;
 
-      if(!TaskSched_AddRTTaskEx((BOOL (*)(UWORD))rtf, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), 0, (UWORD)&sIncEncAuxRun))
+      if(!TaskSched_AddRTTaskEx((BOOL (*)(ULONG))rtf, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), 0, (ULONG)&sIncEncAuxRun))
         return FALSE;
 
       /* enable remdisp command switch */
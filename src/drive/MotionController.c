@@ -1476,9 +1476,7 @@ static UBYTE motCtrl402OmProfileCSTorqueSetup(void)
 // Statusword bit in profile position 
 static void motCtrl402OmProfilePosition8KHz(void)
 {
-    SWORD   swTgtPosWindowMax, swTgtPosWindowMin ;
-    SWORD   swFollowingErrMax, swFollowingErrMin ;
-    SQWRD   sqDeltaPos64 ;
+    SLLNG   sllDeltaPos64, sllPosErr ;
     UWORD   uwLocCntrlWord = sMotCtrl_In.psMotCtrl_In->uwControlWord;
 
     // #######################################################################
@@ -1541,12 +1539,9 @@ static void motCtrl402OmProfilePosition8KHz(void)
     // ############# check if target position is in 'the window' #############
     // #######################################################################
     // DeltaPos(64) = RefPos(64) - Fbk2CntrLoopPos(64)
-    _sint64_sub(&sqDeltaPos64, &sMotCtrlRun.sqOldTargetPostn, &sMotCtrl_In.psFbk2CntrLoop->sEncData.sqPostn) ;
+    sllDeltaPos64 = s64_sub(s64_ld(&sMotCtrlRun.sqOldTargetPostn), s64_ld(&sMotCtrl_In.psFbk2CntrLoop->sEncData.sqPostn)) ;
 
-    swTgtPosWindowMax = _sint64_comp(&sqDeltaPos64, &sMotCtrlRun.sqPosWindowLimitMax) ; 
-    swTgtPosWindowMin = _sint64_comp(&sqDeltaPos64, &sMotCtrlRun.sqPosWindowLimitMin) ; 
-
-    if((swTgtPosWindowMax == 1) || (swTgtPosWindowMin == -1))
+    if((sllDeltaPos64 > s64_ld(&sMotCtrlRun.sqPosWindowLimitMax)) || (sllDeltaPos64 < s64_ld(&sMotCtrlRun.sqPosWindowLimitMin)))
     {   // sono fuori dalla finestra
         sMotCtrl_Out.uwStatusWord &= ~MOTCTRL_402_SF_TARGETREACHED ; // azzero il bit nella statusword
         sMotCtrlRFlags.b.bTgtReachedTimerSet = FALSE ;            // ricarico il timeout 
@@ -1573,10 +1568,9 @@ static void motCtrl402OmProfilePosition8KHz(void)
     // #######################################################################
     // ############# check if following error is in 'the window' #############
     // #######################################################################
-    swFollowingErrMax = _sint64_comp(&sMotCtrl_In.psPoOut->sqPosErr, &sMotCtrlRun.sqFollowingErrLimMax) ; 
-    swFollowingErrMin = _sint64_comp(&sMotCtrl_In.psPoOut->sqPosErr, &sMotCtrlRun.sqFollowingErrLimMin) ; 
+    sllPosErr = s64_ld(&sMotCtrl_In.psPoOut->sqPosErr) ;
 
-    if((swFollowingErrMax == 1) || (swFollowingErrMin == -1))         
+    if((sllPosErr > s64_ld(&sMotCtrlRun.sqFollowingErrLimMax)) || (sllPosErr < s64_ld(&sMotCtrlRun.sqFollowingErrLimMin)))
     {   // sono fuori dal limite
         if (!(sMotCtrl_Out.uwStatusWord & MOTCTRL_402_SF_PP_FOLLOWINGERR))
         {   // Following Error bit non ancora settato                
@@ -1603,8 +1597,8 @@ static void motCtrl402OmProfilePosition8KHz(void)
 // Statusword bit in interpolated mode
 static void motCtrl402OmProfileInterpolated8KHz(void)
 {
-    SWORD swFollowingErrMax, swFollowingErrMin;
     SQWRD sqDelta;
+    SLLNG sllDelta, sllPosErr;
     SLONG slDelta;
     UWORD uwLocCntrlWord = sMotCtrl_In.psMotCtrl_In->uwControlWord;
 
@@ -1644,45 +1638,42 @@ static void motCtrl402OmProfileInterpolated8KHz(void)
             sMotCtrlRun.swIPCycleCnt=sMotCtrlRun.swIPNumCycle;
 
                 // take new quota
+            _sint64_atomic_copy(&sqDelta, &sMotCtrl_In.psMotCtrl_In->sqIPQuota) ;
+            sllDelta=s64_ld(&sqDelta);
             if(sMotCtrl_In.psFbk2CntrLoop->ubStatus & ENCMGR_ABSMECHTURN_VALID)
-                _uint64_sub((UQWRD *)&sqDelta, (UQWRD *)&sMotCtrl_In.psMotCtrl_In->sqIPQuota, (UQWRD *)&sMotCtrl_In.psFbk2CntrLoop->sqMechAbsPosOffset);
-            else
-                _sint64_atomic_copy(&sqDelta, &sMotCtrl_In.psMotCtrl_In->sqIPQuota) ;
-            _uint64_sub((UQWRD *)&sqDelta, (UQWRD *)&sqDelta, (UQWRD *)&sMotCtrl_Out.sqUserOffset);
+                sllDelta=s64_sub(sllDelta, s64_ld(&sMotCtrl_In.psFbk2CntrLoop->sqMechAbsPosOffset));
+            sllDelta=s64_sub(sllDelta, s64_ld(&sMotCtrl_Out.sqUserOffset));
 
                 // delta between actual ip quota (demand pos) and next quota to be reached
 				// if SRamp enabled, it mut be taken the linear ramp
 			if(sPo_PostnerOut.flags.b.bSRampEnabled)								 
-	        	_sint64_sub(&sqDelta, &sqDelta, &sPo_PostnerOut.sLocDemand.sqPostn);
+	        	sllDelta=s64_sub(sllDelta, s64_ld(&sPo_PostnerOut.sLocDemand.sqPostn));
 			else
-        		_sint64_sub(&sqDelta, &sqDelta, &sPo_PostnerOut.sDemand.sqPostn);
+        		sllDelta=s64_sub(sllDelta, s64_ld(&sPo_PostnerOut.sDemand.sqPostn));
 
                 // limit to 32bit
-            slDelta=_sint64toSint32(&sqDelta);
+            slDelta=s64_sat32(sllDelta);
 
                 // apply multiplication timing factor and limit result to 48bit
-            _sint64_mul_32_32(&sqDelta, &slDelta, &sMotCtrlRun.slIPScaling);
-            _sint64toSint48(&sqDelta);
+            sllDelta=s64_sat48(s64_mul_32_32(slDelta, sMotCtrlRun.slIPScaling));
 
                 // save previous speed
             slDelta=sPo_UsrPostnerIn.slLocalSpeed;
 
                 // center part is new speed
-            sPo_UsrPostnerIn.slLocalSpeed=sMotCtrlRun.slIPTgtSpeed=INT64_MLONG(sqDelta);
+            sPo_UsrPostnerIn.slLocalSpeed=sMotCtrlRun.slIPTgtSpeed=s64_mid32(sllDelta);
 
                 // lo part is the fractional part (remainder)
-            sMotCtrlRun.uwIPSpeedFract=INT64_WORD0(sqDelta);
+            sMotCtrlRun.uwIPSpeedFract=(UWORD)sllDelta;
 
                 // calculate acceleration, spread on all cycles
             slDelta=sPo_UsrPostnerIn.slLocalSpeed-slDelta;
     
                 // apply multiplication timing factor and limit result to 48bit
-            _sint64_mul_32_32(&sqDelta, &slDelta, &sMotCtrlRun.slIPScaling);
-            _sint64toSint48(&sqDelta);
+            sllDelta=s64_sat48(s64_mul_32_32(slDelta, sMotCtrlRun.slIPScaling));
     
                 // calc next interpolation period acceleration
-            _sint64_shr(&sqDelta,4);
-            sPo_UsrPostnerIn.slLocalAcc=INT64_LLONG(sqDelta);
+            sPo_UsrPostnerIn.slLocalAcc=(SLONG)s64_shr(sllDelta,4);
     
                 // reset integral part
             sMotCtrlRun.slIPSpeedSum=0l;
@@ -1702,10 +1693,9 @@ static void motCtrl402OmProfileInterpolated8KHz(void)
         }
     
             // following error check
-        swFollowingErrMax = _sint64_comp(&sMotCtrl_In.psPoOut->sqPosErr, &sMotCtrlRun.sqFollowingErrLimMax) ; 
-        swFollowingErrMin = _sint64_comp(&sMotCtrl_In.psPoOut->sqPosErr, &sMotCtrlRun.sqFollowingErrLimMin) ; 
-    
-        if((swFollowingErrMax == 1) || (swFollowingErrMin == -1))         
+        sllPosErr = s64_ld(&sMotCtrl_In.psPoOut->sqPosErr) ;
+
+        if((sllPosErr > s64_ld(&sMotCtrlRun.sqFollowingErrLimMax)) || (sllPosErr < s64_ld(&sMotCtrlRun.sqFollowingErrLimMin)))
         {   // sono fuori dal limite
             if (!(sMotCtrl_Out.uwStatusWord & MOTCTRL_402_SF_PP_FOLLOWINGERR))
             {   // Following Error bit non ancora settato                
@@ -1984,8 +1974,8 @@ static void motCtrl402OmProfileTorque8KHz(void)
 //***************************************************************************
 static void motCtrl402OmProfileCSPosition8KHz(void)
 {
-    SWORD swFollowingErrMax, swFollowingErrMin;
     SQWRD sqDelta;
+    SLLNG sllDelta, sllPosErr;
     SLONG slDelta;
 
         // add fractional part
@@ -2004,45 +1994,42 @@ static void motCtrl402OmProfileCSPosition8KHz(void)
         sMotCtrlRun.swIPCycleCnt=sMotCtrlRun.swIPNumCycle;
 
             // take new quota
+        _sint64_atomic_copy(&sqDelta, &sMotCtrl_In.psMotCtrl_In->sqTargetPostn) ;
+        sllDelta=s64_ld(&sqDelta);
         if(sMotCtrl_In.psFbk2CntrLoop->ubStatus & ENCMGR_ABSMECHTURN_VALID)
-            _uint64_sub((UQWRD *)&sqDelta, (UQWRD *)&sMotCtrl_In.psMotCtrl_In->sqTargetPostn, (UQWRD *)&sMotCtrl_In.psFbk2CntrLoop->sqMechAbsPosOffset);
-        else
-            _sint64_atomic_copy(&sqDelta, &sMotCtrl_In.psMotCtrl_In->sqTargetPostn) ;
-        _uint64_sub((UQWRD *)&sqDelta, (UQWRD *)&sqDelta, (UQWRD *)&sMotCtrl_Out.sqUserOffset);
+            sllDelta=s64_sub(sllDelta, s64_ld(&sMotCtrl_In.psFbk2CntrLoop->sqMechAbsPosOffset));
+        sllDelta=s64_sub(sllDelta, s64_ld(&sMotCtrl_Out.sqUserOffset));
 
             // delta between actual ip quota (demand pos) and next quota to be reached
 			// if SRamp enabled, it mut be taken the linear ramp
 		if(sPo_PostnerOut.flags.b.bSRampEnabled)								 
-        	_sint64_sub(&sqDelta, &sqDelta, &sPo_PostnerOut.sLocDemand.sqPostn);
+        	sllDelta=s64_sub(sllDelta, s64_ld(&sPo_PostnerOut.sLocDemand.sqPostn));
 		else
-        	_sint64_sub(&sqDelta, &sqDelta, &sPo_PostnerOut.sDemand.sqPostn);
+        	sllDelta=s64_sub(sllDelta, s64_ld(&sPo_PostnerOut.sDemand.sqPostn));
 
             // limit to 32bit
-        slDelta=_sint64toSint32(&sqDelta);
+        slDelta=s64_sat32(sllDelta);
 
             // apply multiplication timing factor and limit result to 48bit
-        _sint64_mul_32_32(&sqDelta, &slDelta, &sMotCtrlRun.slIPScaling);
-        _sint64toSint48(&sqDelta);
+        sllDelta=s64_sat48(s64_mul_32_32(slDelta, sMotCtrlRun.slIPScaling));
 
             // save previous speed
         slDelta=sPo_UsrPostnerIn.slLocalSpeed;
 
             // center part is new speed
-        sPo_UsrPostnerIn.slLocalSpeed=sMotCtrlRun.slIPTgtSpeed=INT64_MLONG(sqDelta);
+        sPo_UsrPostnerIn.slLocalSpeed=sMotCtrlRun.slIPTgtSpeed=s64_mid32(sllDelta);
 
             // lo part is the fractional part (remainder)
-        sMotCtrlRun.uwIPSpeedFract=INT64_WORD0(sqDelta);
+        sMotCtrlRun.uwIPSpeedFract=(UWORD)sllDelta;
 
             // calculate acceleration, spread on all cycles
         slDelta=sPo_UsrPostnerIn.slLocalSpeed-slDelta;
 
             // apply multiplication timing factor and limit result to 48bit
-        _sint64_mul_32_32(&sqDelta, &slDelta, &sMotCtrlRun.slIPScaling);
-        _sint64toSint48(&sqDelta);
+        sllDelta=s64_sat48(s64_mul_32_32(slDelta, sMotCtrlRun.slIPScaling));
 
             // calc next interpolation period acceleration
-        _sint64_shr(&sqDelta,4);
-        sPo_UsrPostnerIn.slLocalAcc=INT64_LLONG(sqDelta);
+        sPo_UsrPostnerIn.slLocalAcc=(SLONG)s64_shr(sllDelta,4);
 
             // reset integral part
         sMotCtrlRun.slIPSpeedSum=0l;
@@ -2050,10 +2037,9 @@ static void motCtrl402OmProfileCSPosition8KHz(void)
     else
         // following error management, executed only out of SYNC for rt task time saving
     {
-        swFollowingErrMax = _sint64_comp(&sMotCtrl_In.psPoOut->sqPosErr, &sMotCtrlRun.sqFollowingErrLimMax) ; 
-        swFollowingErrMin = _sint64_comp(&sMotCtrl_In.psPoOut->sqPosErr, &sMotCtrlRun.sqFollowingErrLimMin) ; 
-    
-        if((swFollowingErrMax == 1) || (swFollowingErrMin == -1))         
+        sllPosErr = s64_ld(&sMotCtrl_In.psPoOut->sqPosErr) ;
+
+        if((sllPosErr > s64_ld(&sMotCtrlRun.sqFollowingErrLimMax)) || (sllPosErr < s64_ld(&sMotCtrlRun.sqFollowingErrLimMin)))
         {
             if (!(sMotCtrl_Out.uwStatusWord & MOTCTRL_402_SF_PP_FOLLOWINGERR))
             {
@@ -2098,7 +2084,7 @@ static void motCtrl402OmProfileCSPosition8KHz(void)
 //***************************************************************************
 static void motCtrl402OmProfileCSVelocity8KHz(void)
 {
-    SQWRD sqDelta;
+    SLLNG sllDelta;
     SLONG slDelta;
 
         // add fractional part
@@ -2120,18 +2106,16 @@ static void motCtrl402OmProfileCSVelocity8KHz(void)
         slDelta=sPo_UsrPostnerIn.slTargetSpeed-sPo_UsrPostnerIn.slLocalSpeed;
 
             // apply multiplication timing factor and limit result to 48bit
-        _sint64_mul_32_32(&sqDelta, &slDelta, &sMotCtrlRun.slIPScaling);
-        _sint64toSint48(&sqDelta);
+        sllDelta=s64_sat48(s64_mul_32_32(slDelta, sMotCtrlRun.slIPScaling));
 
             // center part is new speed step
-        sMotCtrlRun.slIPTgtSpeed=INT64_MLONG(sqDelta);
+        sMotCtrlRun.slIPTgtSpeed=s64_mid32(sllDelta);
 
             // lo part is the fractional part (remainder)
-        sMotCtrlRun.uwIPSpeedFract=INT64_WORD0(sqDelta);
+        sMotCtrlRun.uwIPSpeedFract=(UWORD)sllDelta;
 
             // calc next interpolation period acceleration
-        _sint64_shr(&sqDelta,4);
-        sPo_UsrPostnerIn.slLocalAcc=INT64_LLONG(sqDelta);
+        sPo_UsrPostnerIn.slLocalAcc=(SLONG)s64_shr(sllDelta,4);
 
             // reset integral part
         sMotCtrlRun.slIPSpeedSum=0l;
@@ -2158,7 +2142,7 @@ static void motCtrl402OmProfileCSVelocity8KHz(void)
 //***************************************************************************
 static void motCtrl402OmProfileCSTorque8KHz(void)
 {
-    SQWRD sqDelta;
+    SLLNG sllDelta;
     SLONG slDelta,slNewTgt;
 
         // add fractional part
@@ -2183,14 +2167,13 @@ static void motCtrl402OmProfileCSTorque8KHz(void)
         slDelta=slNewTgt-sMotCtrl_Out.sIRefs.slIqRef;
 
             // apply multiplication timing factor and limit result to 48bit
-        _sint64_mul_32_32(&sqDelta, &slDelta, &sMotCtrlRun.slIPScaling);
-        _sint64toSint48(&sqDelta);
+        sllDelta=s64_sat48(s64_mul_32_32(slDelta, sMotCtrlRun.slIPScaling));
 
             // center part is new speed step
-        sMotCtrlRun.slIPTgtSpeed=INT64_MLONG(sqDelta);
+        sMotCtrlRun.slIPTgtSpeed=s64_mid32(sllDelta);
 
             // lo part is the fractional part (remainder)
-        sMotCtrlRun.uwIPSpeedFract=INT64_WORD0(sqDelta);
+        sMotCtrlRun.uwIPSpeedFract=(UWORD)sllDelta;
 
             // reset integral part
         sMotCtrlRun.slIPSpeedSum=0l;
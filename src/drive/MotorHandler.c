@@ -29,6 +29,7 @@
 #include "system\SysLogManagement.h"
 #include "common\MathFunctions.h"
 #include "common\Int64Functions.h"
+#include "common\DspFilter.h"
 #include "fpga\FpgaHandler.h"
 #include "fpga\FpgaIRegs.h"
 #include "fpga\AnProcessor.h"
@@ -82,6 +83,8 @@ const SWORD RADICE_TRE_QUARTI = 28377 ;
 #define DEFAULT_BRAKELOW        720 // [V]
 #define DEFAULT_BRAKEHIGH       750 // [V]
 
+#define BACKEMF_POLAR_GRADE     MATH_GRADE_MEDIUM // back EMF angle/magnitude, one CORDIC pass
+
 #ifdef _INFINEON_
 #define SAFETORQUEOFF_IN_L      P9_IN_P5
 #define SAFETORQUEOFF_IN_H      P9_IN_P7
@@ -1389,10 +1392,10 @@ static BOOL Mh_MotorDataFromFpgaInit(void)
   sAInDef.uwDstIntAvg=ANPROC_ADR_DISABLE;
 
   // feedback Id and Iq
+  sMotorHandlerRun.flRatioI_EQ_RMS = flRatioI_EQ_RMS ;
   if (sMotorHandlerRun.flags.b.bDSPAdvance)
   {
     sRGODef.ubOpt=ANPROC_OF_DST_SHORT;
-    sMotorHandlerRun.flRatioI_EQ_RMS = flRatioI_EQ_RMS ;
     sRGODef.flScale=1.0;
 
     sRGODef.pvDst=&sMotorHandlerRun.swIdFb;
@@ -1637,7 +1640,7 @@ static BOOL Mh_MotorDataFromFpgaInit(void)
   }
 
   {
-    HPUWORD hpuwDat=(HPUWORD)RGAD_CPUH_DATRAM_BASEADDR;
+    HPUWORD hpuwDat=(HPUWORD)FPGA_CPUH_DRAM_BASE;
     UWORD uwCt;
 
     for(uwCt=0;uwCt<100;uwCt++)
@@ -2983,7 +2986,7 @@ void Mh_MotorBackEMF(BOOL bATanEnabled)
   SWORD swRxIu, swRxIv, swLxdIudT, swLxdIvdT ;
   SWORD swEmfU, swEmfV ;
 
-  UWORD uwEmfSQRoot ;
+  MATH_POLAR sEmfPolar ;
 
   // ===================================
   // ============== R * I ==============
@@ -3050,11 +3053,13 @@ void Mh_MotorBackEMF(BOOL bATanEnabled)
   sMh_MotorDataOut.sBackEmfData.swAlpha = (SWORD)(((SLONG)swEmfU * RADICE_TRE_QUARTI) >> 16) ; /* Back EMF Alpha */
   sMh_MotorDataOut.sBackEmfData.swBeta  = (swEmfU / 4) + (swEmfV / 2) ;                        /* Back EMF Beta  */
 
+  /* angle and magnitude from the same vector, no division */
+  CordicPolar16(sMh_MotorDataOut.sBackEmfData.swBeta, sMh_MotorDataOut.sBackEmfData.swAlpha, BACKEMF_POLAR_GRADE, &sEmfPolar) ;
+
   if(bATanEnabled)
-    sMh_MotorDataOut.sBackEmfData.uwAtanAngle = 0x8000 + ATan16(sMh_MotorDataOut.sBackEmfData.swBeta, sMh_MotorDataOut.sBackEmfData.swAlpha) ;
+    sMh_MotorDataOut.sBackEmfData.uwAtanAngle = 0x8000 + sEmfPolar.uwAngle ;
 
-  uwEmfSQRoot = CalculateSquareRoot(sMh_MotorDataOut.sBackEmfData.swBeta, sMh_MotorDataOut.sBackEmfData.swAlpha) ;
-  sMotorHandlerRun.ulEmfSQRootFiltered = (7 * sMotorHandlerRun.ulEmfSQRootFiltered + 1024 * (ULONG)uwEmfSQRoot) / 8 ; // uwVmotor e' il valore di picco concatenato (filtro)
+  sMotorHandlerRun.ulEmfSQRootFiltered = (7 * sMotorHandlerRun.ulEmfSQRootFiltered + 1024 * (ULONG)sEmfPolar.uwMagnitude) / 8 ; // uwVmotor e' il valore di picco concatenato (filtro)
   sMh_MotorDataOut.sBackEmfData.uwVmotor = (UWORD)(sMotorHandlerRun.ulEmfSQRootFiltered / 512) ; /* 512 = 256 * 2 -> since the result from SquareRoot has to be divided by 2 (originale) */
   sMh_MotorDataOut.sPowerStageSts.b.bBackEMFDataValid = TRUE;
 }
@@ -3179,67 +3184,25 @@ BOOL Mh_SetIqFilter(UBYTE ubFiltNum, HPSWORD hpswSrcV)
 
 static BOOL CalcFilterConstants(UBYTE ubType, FLOAT flFreqMain, FLOAT flDampMain, FLOAT flFreqSec, FLOAT flDampSec, HPSWORD hpswDstV)
 {
-    FLOAT flDv,flPw;
-    SWORD swSum;
+    DSPFLT_BIQUAD_Q15 sQCoef;
     UWORD uwCt;
 
-    switch(ubType)
-    {
-        case MH_FILTER_NONE:
-            hpswDstV[0]=MH_FILTER_INTNORM;
-            hpswDstV[1]=0;
-            hpswDstV[2]=0;
-            hpswDstV[3]=0;
-            hpswDstV[4]=0;
-                // skip constants refining and checking
-            return TRUE;
-
-        case MH_FILTER_NOTCH:
-            flPw=pow(RT_TASK_PERIOD*flFreqMain,2.0);
-    		flDv=4+2*flFreqMain*flDampMain*RT_TASK_PERIOD+flPw;
-            flDv=(FLOAT)MH_FILTER_INTNORM/flDv;
-
-    		hpswDstV[0]=(SWORD)(0.5+flDv*(4+flPw));
-    		hpswDstV[1]=(SWORD)(0.5+flDv*(2*flPw-8));
-    		hpswDstV[2]=(SWORD)(0.5+flDv*(4+flPw));
-    		hpswDstV[3]=(SWORD)(0.5+flDv*-(2*flPw-8));
-    		hpswDstV[4]=(SWORD)(0.5+flDv*-(4-2*RT_TASK_PERIOD*flFreqMain*flDampMain+flPw));
-            break;
-
-        case MH_FILTER_BIQUAD:
-            flPw=pow(RT_TASK_PERIOD*flFreqMain,2.0);
-    		flDv=4*flFreqMain*flFreqMain+4*flDampSec*flFreqMain*flFreqMain*flFreqSec*RT_TASK_PERIOD+pow(RT_TASK_PERIOD*flFreqMain*flFreqSec,2.0);
-            flDv=(FLOAT)MH_FILTER_INTNORM/flDv;
-
-    		hpswDstV[0]=(SWORD)(0.5+flDv*flFreqSec*flFreqSec*(4+4*flDampMain*flFreqMain*RT_TASK_PERIOD+flPw));
-    		hpswDstV[1]=(SWORD)(0.5+flDv*flFreqSec*flFreqSec*(2*flPw-8));
-    		hpswDstV[2]=(SWORD)(0.5+flDv*flFreqSec*flFreqSec*(4-4*flDampMain*flFreqMain*RT_TASK_PERIOD+flPw));
-    		hpswDstV[3]=(SWORD)(0.5+flDv*-(flFreqMain*flFreqMain*(2*pow(RT_TASK_PERIOD*flFreqSec,2.0)-8)));
-    		hpswDstV[4]=(SWORD)(0.5+flDv*-(4*flFreqMain*flFreqMain-4*flDampSec*flFreqMain*flFreqMain*flFreqSec*RT_TASK_PERIOD+pow(RT_TASK_PERIOD*flFreqMain*flFreqSec,2.0)));
-            break;
-
-        case MH_FILTER_LOWPASS:
-            flPw=pow(RT_TASK_PERIOD*flFreqMain,2.0);
-    		flDv=4+4*flFreqMain*flDampMain*RT_TASK_PERIOD+flPw;
-            flDv=(FLOAT)MH_FILTER_INTNORM/flDv;
-
-    		hpswDstV[0]=(SWORD)(0.5+flDv*flPw);
-    		hpswDstV[1]=(SWORD)(0.5+flDv*2*flPw);
-    		hpswDstV[2]=(SWORD)(0.5+flDv*flPw);
-    		hpswDstV[3]=(SWORD)(0.5+flDv*-(2*flPw-8));
-    		hpswDstV[4]=(SWORD)(0.5+flDv*-(4-4*flFreqMain*flDampMain*RT_TASK_PERIOD+flPw));
-            break;
-
-        default:
-            return FALSE;
-
-	}
+    if(!DspFlt_DesignSosQ15(ubType, flFreqMain, flDampMain, flFreqSec, flDampSec, RT_TASK_PERIOD, MH_FILTER_INTSHIFT, &sQCoef))
+        return FALSE;
 
         // adjust values across approx in order to keep unity gain
-	for(uwCt=0,swSum=0;uwCt<5;uwCt++)
-        swSum+=hpswDstV[uwCt];
+    if(ubType!=MH_FILTER_NONE)
+        DspFlt_TrimDcQ15(&sQCoef);
 
-	hpswDstV[1]+=MH_FILTER_INTNORM-swSum;
+    hpswDstV[0]=sQCoef.swB0;
+    hpswDstV[1]=sQCoef.swB1;
+    hpswDstV[2]=sQCoef.swB2;
+    hpswDstV[3]=sQCoef.swA1;
+    hpswDstV[4]=sQCoef.swA2;
+
+        // skip constants checking for void filter
+    if(ubType==MH_FILTER_NONE)
+        return TRUE;
 
         // if quantization is below minimum limit then filter is not valid
 	for(uwCt=0;uwCt<5;uwCt++)
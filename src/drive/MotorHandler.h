@@ -46,7 +46,8 @@
 #define MH_FILTER_NOTCH             2
 #define MH_FILTER_BIQUAD            3
 
-#define MH_FILTER_INTNORM           8192
+#define MH_FILTER_INTSHIFT          13
+#define MH_FILTER_INTNORM           (1<<MH_FILTER_INTSHIFT)
 
 #define MH_DSPDB_IEC_WS             433
 
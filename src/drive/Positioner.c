@@ -310,16 +310,18 @@ static BOOL Po_ModeOfFunction8KHz(void)
 static void Positioner8KHz(void)
 {
   SWORD swDeltaPosSign ;
+  SLLNG sllDeltaPos ;
   SQWRD sqDeltaPosCorrected ; /* = sqDeltaPos + DemandSpeed_1/2 */
   SLONG slAbsValDecSva, slHalfDemandSpeed ;
   SLONG slEndVel ;
 
   if(!sPo_PostnerOut.flags.b.bTgtPosReached)
   { /* determino quanto manca rispetto alla sqTargetPostn: DeltaPos = sqTargetPostn - sqDemandPostn_1 */
-    _sint64_sub(&sPostnerRun.sqDeltaPos, &sPostnerRun.sqTgtPos2Use, &sPostnerRun.psDemand->sqPostn) ;
+    sllDeltaPos = s64_sub(s64_ld(&sPostnerRun.sqTgtPos2Use), s64_ld(&sPostnerRun.psDemand->sqPostn)) ;
+    s64_st(&sPostnerRun.sqDeltaPos, sllDeltaPos) ;
   
     /* guardo il segno del Delta di posizione:  */
-    swDeltaPosSign = _sint64_comp(&sPostnerRun.sqDeltaPos, &sqZero64bit) ;
+    swDeltaPosSign = s64_comp(sllDeltaPos, 0) ;
  
     /* se primo passaggio (inizio posizionamento) tengo conto della direzione per la end_velocity */
     if(sPostnerRun.flags.b.bPrevTgtPosReached)
@@ -347,7 +349,7 @@ static void Positioner8KHz(void)
     /* calcolo sPo_PostnerOut.slDemandSpeed/2 (mi serve per fare la '64+32') */
     slHalfDemandSpeed = sPostnerRun.psDemand->slSpeed >> 1 ; 
 
-    _sint64_add_64_32(&sqDeltaPosCorrected, &sPostnerRun.sqDeltaPos, &slHalfDemandSpeed) ; /* sqDeltaPosCorrected = sqDeltaPos + DemandSpeed_1/2 */
+    s64_st(&sqDeltaPosCorrected, s64_add(sllDeltaPos, slHalfDemandSpeed)) ; /* sqDeltaPosCorrected = sqDeltaPos + DemandSpeed_1/2 */
 
     /* AbsValDec2UseCalculated = (DemandSpeed_1^2 - SpeedEnd^2)/(2 * (PostnEnd - sqDemandPosition_1 + DemandSpeed_1/2)) */
     slAbsValDecSva = _sva_evaluation(sPostnerRun.psDemand->slSpeed, slEndVel, &sqDeltaPosCorrected) ;          
@@ -472,7 +474,7 @@ static void SpeedRamp8KHz(void)
             ulAbsValDmndSpd = labs(sPostnerRun.psDemand->slSpeed) ;
             ulAbsDltSpdEndVel32 = labs(sPostnerRun.psDemand->slSpeed - (sPostnerRun.flags.b.bPostnerNegative?-sPo_PostnerParam.slEndVelocity:sPo_PostnerParam.slEndVelocity));
             ulAbsDeltaSpd32 = labs(sPostnerRun.psDemand->slSpeed - sPostnerRun.slTgtSpd2Use) ;
-            ulAbsDeltaPos32 = labs(_sint64toSint32(&sPostnerRun.sqDeltaPos)) ; /* riduco sqDeltaPos da 64bit a 32bit e ne faccio il valore assoluto */
+            ulAbsDeltaPos32 = labs(s64_sat32(s64_ld(&sPostnerRun.sqDeltaPos))) ; /* riduco sqDeltaPos da 64bit a 32bit e ne faccio il valore assoluto */
 
             sPostnerRun.flags.b.bEnableAntiWindupPosErr = TRUE ; /* abilito l'antiwindup sul PosErrMax */
         
@@ -527,8 +529,7 @@ static void SpeedRamp8KHz(void)
 /* ######################################################################### */
 static void PositionIntegrate8KHz(void)
 {
-    SQWRD sqDemandPostn, sqPosErr_1, sqPosErrMax2Use, sqPosErrMin2Use ;
-    SWORD swPosErrMax, swPosErrMin ;
+    SLLNG sllFeedBack, sllPosErr, sllPosErr_1, sllPosErrMax2Use, sllPosErrMin2Use ;
     BOOL bBlocked = FALSE;
     BOOL bPosErrInLimitMax = FALSE ;
     BOOL bPosErrInLimitMin = FALSE ;
@@ -551,65 +552,59 @@ static void PositionIntegrate8KHz(void)
     }
     sPostnerRun.flags.b.bDisSpeedUpdate = FALSE;
 
-    _sint64_add_64_32(&sqDemandPostn, &sPostnerRun.psDemand->sqPostn, &sPostnerRun.psDemand->slSpeed) ; /* DemandPostn = DemandPostn_1 + DemandSpeed */
+    sllFeedBack = s64_ld(&psPo_InFeedBack->sqPostn) ;
 
     /* salvo l'errore di posizione al campione precedente */
-    _sint64_atomic_copy(&sqPosErr_1, sPostnerRun.psqPosErr) ;
+    sllPosErr_1 = s64_ld(sPostnerRun.psqPosErr) ;
 
-    /* calcolo l'errore di posizione aggiornato: Error(64) = DemandPosition(64) - FeedbackPosition(64) */
-    _sint64_sub(sPostnerRun.psqPosErr, &sqDemandPostn, &psPo_InFeedBack->sqPostn) ;      
+    /* calcolo l'errore di posizione aggiornato: Error(64) = DemandPosition(64) - FeedbackPosition(64), con DemandPostn = DemandPostn_1 + DemandSpeed */
+    sllPosErr = s64_sub(s64_add(s64_ld(&sPostnerRun.psDemand->sqPostn), sPostnerRun.psDemand->slSpeed), sllFeedBack) ;
  
     if (sPostnerRun.flags.b.bEnableAntiWindupPosErr)
     {   /* limito l'errore solo quando non sono in controllo di posizione */   
          if ((psPo_ILimitActive->b.bIqMax || psPo_ILimitActive->b.bIqMin) && (!sPo_PlcWorks.flags.b.bRampInSaturation))
          {  /* sono in limite di corrente: decido quali limiti usare */
-            if (sqPosErr_1.hi & 0x80000000)
+            if (sllPosErr_1 < 0)
             {   /* l'errore e' negativo: impongo che il limite negativo sia uguale al valore dell'errore al campione precedente */
-                _sint64_atomic_copy(&sqPosErrMax2Use, &sPostnerRun.sqPstnErrMax) ;
-                _sint64_atomic_copy(&sqPosErrMin2Use, &sqPosErr_1) ;
+                sllPosErrMax2Use = s64_ld(&sPostnerRun.sqPstnErrMax) ;
+                sllPosErrMin2Use = sllPosErr_1 ;
             }
             else
             {   /* l'errore e' positivo: impongo che il limite positivo sia uguale al valore dell'errore al campione precedente */
-                _sint64_atomic_copy(&sqPosErrMax2Use, &sqPosErr_1) ;
-                _sint64_atomic_copy(&sqPosErrMin2Use, &sPostnerRun.sqPstnErrMin) ;
+                sllPosErrMax2Use = sllPosErr_1 ;
+                sllPosErrMin2Use = s64_ld(&sPostnerRun.sqPstnErrMin) ;
             }
             bBlocked = TRUE;
          }
          else
          {  /* NON sono in limite di corrente: uso i valori utente */
-            _sint64_atomic_copy(&sqPosErrMax2Use, &sPostnerRun.sqPstnErrMax) ;
-            _sint64_atomic_copy(&sqPosErrMin2Use, &sPostnerRun.sqPstnErrMin) ;
+            sllPosErrMax2Use = s64_ld(&sPostnerRun.sqPstnErrMax) ;
+            sllPosErrMin2Use = s64_ld(&sPostnerRun.sqPstnErrMin) ;
          }
 
-        swPosErrMax = _sint64_comp(sPostnerRun.psqPosErr, &sqPosErrMax2Use) ; 
-        swPosErrMin = _sint64_comp(sPostnerRun.psqPosErr, &sqPosErrMin2Use) ; 
-        
-        // PosErr > PosErrMax => +1; PosErr = PosErrMax => 0; PosErr < PosErrErrMax => -1
-        // PosErr > PosErrMin => +1; PosErr = PosErrMin => 0; PosErr < PosErrErrMin => -1   
-        if ((swPosErrMax == 1) && (swPosErrMin != -1))
+        if ((sllPosErr > sllPosErrMax2Use) && (sllPosErr >= sllPosErrMin2Use))
         {
-           _sint64_atomic_copy(sPostnerRun.psqPosErr, &sqPosErrMax2Use) ; /* Limit to max position error */
+            sllPosErr = sllPosErrMax2Use ; /* Limit to max position error */
             bPosErrInLimitMax = TRUE ;
         }
-        else if ((swPosErrMax != 1) && (swPosErrMin == -1))
+        else if ((sllPosErr <= sllPosErrMax2Use) && (sllPosErr < sllPosErrMin2Use))
         {
-           _sint64_atomic_copy(sPostnerRun.psqPosErr, &sqPosErrMin2Use) ; /* Limit to min position error */
+            sllPosErr = sllPosErrMin2Use ; /* Limit to min position error */
             bPosErrInLimitMin = TRUE ;
         }
     }
     else
     {
         // se zero disabilito controllo
-        if(_sint64_comp(&sqZero64bit, &sPo_PostnerParam.sqPstnErrMax))
+        sllPosErrMax2Use = s64_ld(&sPo_PostnerParam.sqPstnErrMax) ;
+        if(sllPosErrMax2Use != 0)
         {
-            _sint64_sub(&sqPosErrMin2Use, &sqZero64bit, &sPo_PostnerParam.sqPstnErrMax) ;
-    
             // se sono in errore di inseguimento
-            if(_sint64_comp(sPostnerRun.psqPosErr, &sqPosErrMin2Use) < 0 ||
-               _sint64_comp(sPostnerRun.psqPosErr, &sPo_PostnerParam.sqPstnErrMax) > 0)
+            if(sllPosErr < s64_sub(0, sllPosErrMax2Use) || sllPosErr > sllPosErrMax2Use)
                bBlocked = TRUE;
         }
     }
+    s64_st(sPostnerRun.psqPosErr, sllPosErr) ;
 
     // motor blocked timeout management
     if(bBlocked)
@@ -634,7 +629,7 @@ static void PositionIntegrate8KHz(void)
         sPostnerRun.swMotBlockTout = sPo_PostnerParam.swMotBlockTout ;
     }
 
-    _sint64_add(&sPostnerRun.psDemand->sqPostn, sPostnerRun.psqPosErr, &psPo_InFeedBack->sqPostn) ; /* 'limited' DemandPostn */
+    s64_st(&sPostnerRun.psDemand->sqPostn, s64_add(sllPosErr, sllFeedBack)) ; /* 'limited' DemandPostn */
 
     if (sPo_PlcWorks.flags.b.bRampInSaturation)
     {
@@ -678,24 +673,17 @@ static void PositionIntegrate8KHz(void)
 /* ######################################################################### */
 static void Interpolation8KHz(void)
 {
-    SQWRD sqDelta;
     SLONG slDelta,slNewAcc;
 
         // if new IP quota
     if(psPo_PostnerIn->flags.b.bNewTarget)
     {
             // delta between actual ip quota (demand pos) and next quota to be reached
-        _sint64_sub(&sqDelta, &sPostnerRun.sqTgtPos2Use, &sPostnerRun.psDemand->sqPostn);
-    
             // limit to 32bit
-        slDelta=_sint64toSint32(&sqDelta);
+        slDelta=s64_sat32(s64_sub(s64_ld(&sPostnerRun.sqTgtPos2Use), s64_ld(&sPostnerRun.psDemand->sqPostn)));
     
-            // apply multiplication timing factor
-        _sint64_mul_32_32(&sqDelta, &slDelta, &psPo_PostnerIn->slIPScaling);
-
-            // center part is new speed
-        _sint64toSint48(&sqDelta);
-        slDelta=INT64_MLONG(sqDelta);
+            // apply multiplication timing factor, center part is new speed
+        slDelta=s64_mid32(s64_sat48(s64_mul_32_32(slDelta, psPo_PostnerIn->slIPScaling)));
 
             // calc acceleration
         slNewAcc=labs(slDelta-sPostnerRun.psDemand->slSpeed);
@@ -841,83 +829,75 @@ static void CalculateAccDec(void)
 /* ######################################################################### */    
 static void SRamp8kHz(void)
 {
-    SWORD swPosErrMax, swPosErrMin ;
-    SQWRD sqTemp64, sqFilterIn, sqSpd48, sqPostnUnlimited64 ;
+    SLLNG sllTemp64, sllFilterIn, sllSpd48, sllFeedBack, sllPosErr, sllPosErrMax, sllPosErrMin ;
     SLONG slRGDeltaPos_1 ;
     BOOL bPosErrSRampInLimitMax = FALSE ;
     BOOL bPosErrSRampInLimitMin = FALSE ;
-    SQWRD sqTemp64_1;
 
     // calcolo la differenza tra la traiettoria del generatore di rampe lineari e la traiettoria del generatore di rampe S
-    _sint64_sub_nosaturation(&sqTemp64, &sPo_PostnerOut.sLocDemand.sqPostn, &sPo_PostnerOut.sDemand.sqPostn) ;
-
-    _sint64_atomic_copy(&sqTemp64_1,&sqTemp64);
-    _sint64_shr(&sqTemp64_1,8);
+    sllTemp64 = s64_sub(s64_ld(&sPo_PostnerOut.sLocDemand.sqPostn), s64_ld(&sPo_PostnerOut.sDemand.sqPostn)) ;
 
     slRGDeltaPos_1 = sPostnerRun.sSRamp.slRGDeltaPos ;
-    sPostnerRun.sSRamp.slRGDeltaPos = (SLONG)sqTemp64_1.lo ;
+    sPostnerRun.sSRamp.slRGDeltaPos = (SLONG)s64_shr(sllTemp64, 8) ;
 
     if (!psPo_PostnerIn->flags.b.bDirectSpeed && !sPo_PostnerOut.flags.b.bInRamp && 
         ((sPostnerRun.sSRamp.slRGDeltaPos > 0) != (slRGDeltaPos_1 > 0)))
     {   // non sono in rampa lineare ED il segno del delta di posizione tra rampa lineare e rampa S 
         // e' cambiato: solo una volta ricopio DemandPos su SRampPos e resetto i vari stati integrali
-        INT64_ASSIGN(sqTemp64, 0L, 0UL) ;
+        sllTemp64 = 0 ;
         INT64_ASSIGN(sPostnerRun.sSRamp.sqFilterStatus64, 0L, 0UL) ;
         INT64_ASSIGN(sPostnerRun.sSRamp.sqIntegralStatus64Spd, 0L, 0UL) ;
 
         _sint64_atomic_copy(&sPo_PostnerOut.sDemand.sqPostn, &sPo_PostnerOut.sLocDemand.sqPostn) ; 
     }
 
-    _sint64_sub_nosaturation(&sqFilterIn, &sqTemp64, &sPostnerRun.sSRamp.sqFilterStatus64) ;
+    sllFilterIn = s64_sub(sllTemp64, s64_ld(&sPostnerRun.sSRamp.sqFilterStatus64)) ;
 
     /* calcolo la 'S' demand acceleration  */ 
-    _sint64_atomic_copy(&sqTemp64, &sqFilterIn) ; 
     if (sPostnerRun.sSRamp.sw1_K1 > 0)
     {   // shift positivo = shift left
-        _sint64_shl(&sqTemp64, (UWORD)sPostnerRun.sSRamp.sw1_K1) ;
+        sllTemp64 = s64_shl(sllFilterIn, (UWORD)sPostnerRun.sSRamp.sw1_K1) ;
     }
     else if (sPostnerRun.sSRamp.sw1_K1 < 0)
     {   // shift negativo = shift right
-        _sint64_shr(&sqTemp64, (UWORD)(-sPostnerRun.sSRamp.sw1_K1)) ;
+        sllTemp64 = s64_shr(sllFilterIn, (UWORD)(-sPostnerRun.sSRamp.sw1_K1)) ;
     }
-    sPo_PostnerOut.sDemand.slAccel = _sint64toSint32(&sqTemp64) ;
+    else
+        sllTemp64 = sllFilterIn ;
+    sPo_PostnerOut.sDemand.slAccel = s64_sat32(sllTemp64) ;
 
     /* calcolo la 'S' demand speed */ 
-    _sint64_add(&sqTemp64, &sqFilterIn, &sPostnerRun.sSRamp.sqIntegralStatus64Spd) ;
-    _sint64_atomic_copy(&sPostnerRun.sSRamp.sqIntegralStatus64Spd, &sqTemp64) ;
-    _sint64_atomic_copy(&sqSpd48, &sqTemp64) ; /* mi serve per calcolare la regresessione dello stato del filtro */
-    _sint64_shr(&sqTemp64, sPostnerRun.sSRamp.uwAbsK1) ;
-    sPo_PostnerOut.sDemand.slSpeed = _sint64toSint32(&sqTemp64) ;
-
-    /* calcolo la 'S' demand position: sqPostn64 = sqPostnOut64_1 + Speed32 */
-    _sint64_add_64_32(&sqPostnUnlimited64, &sPo_PostnerOut.sDemand.sqPostn, &sPo_PostnerOut.sDemand.slSpeed) ;
+    sllSpd48 = s64_add(sllFilterIn, s64_ld(&sPostnerRun.sSRamp.sqIntegralStatus64Spd)) ; /* mi serve per calcolare la regresessione dello stato del filtro */
+    s64_st(&sPostnerRun.sSRamp.sqIntegralStatus64Spd, sllSpd48) ;
+    sPo_PostnerOut.sDemand.slSpeed = s64_sat32(s64_shr(sllSpd48, sPostnerRun.sSRamp.uwAbsK1)) ;
 
     //TEMPFLAG(14);
 
-    /* calcolo l'errore di posizione aggiornato: Error(64) = SRampUnlimitedDemandPosition(64) - FeedbackPosition(64) */
-    _sint64_sub(&sPo_PostnerOut.sqPosErr, &sqPostnUnlimited64, &psPo_InFeedBack->sqPostn) ; 
+    /* calcolo l'errore di posizione aggiornato: Error(64) = SRampUnlimitedDemandPosition(64) - FeedbackPosition(64),
+       con SRampUnlimitedDemandPosition(64) = sqPostnOut64_1 + Speed32 */
+    sllFeedBack = s64_ld(&psPo_InFeedBack->sqPostn) ;
+    sllPosErr = s64_sub(s64_add(s64_ld(&sPo_PostnerOut.sDemand.sqPostn), sPo_PostnerOut.sDemand.slSpeed), sllFeedBack) ;
 
     if (sPostnerRun.flags.b.bEnableAntiWindupPosErr)
     {   /* limito l'errore al valore utente */
-        swPosErrMax = _sint64_comp(&sPo_PostnerOut.sqPosErr, &sPostnerRun.sqSRampPstnErrMax) ; 
-        swPosErrMin = _sint64_comp(&sPo_PostnerOut.sqPosErr, &sPostnerRun.sqSRampPstnErrMin) ; 
+        sllPosErrMax = s64_ld(&sPostnerRun.sqSRampPstnErrMax) ;
+        sllPosErrMin = s64_ld(&sPostnerRun.sqSRampPstnErrMin) ;
         
-        // PosErr > PosErrMax => +1; PosErr = PosErrMax => 0; PosErr < PosErrErrMax => -1
-        // PosErr > PosErrMin => +1; PosErr = PosErrMin => 0; PosErr < PosErrErrMin => -1   
-        if ((swPosErrMax == 1) && (swPosErrMin != -1))
+        if ((sllPosErr > sllPosErrMax) && (sllPosErr >= sllPosErrMin))
         {  /* Limit to max position error */
-           _sint64_atomic_copy(&sPo_PostnerOut.sqPosErr, &sPostnerRun.sqSRampPstnErrMax) ; 
+           sllPosErr = sllPosErrMax ;
            bPosErrSRampInLimitMax = TRUE ;
         }
-        else if ((swPosErrMax != 1) && (swPosErrMin == -1))
+        else if ((sllPosErr <= sllPosErrMax) && (sllPosErr < sllPosErrMin))
         {  /* Limit to min position error */
-           _sint64_atomic_copy(&sPo_PostnerOut.sqPosErr, &sPostnerRun.sqSRampPstnErrMin) ; 
+           sllPosErr = sllPosErrMin ;
            bPosErrSRampInLimitMin = TRUE ;
         }
     }
+    s64_st(&sPo_PostnerOut.sqPosErr, sllPosErr) ;
 
     /* 'limited' DemandPostn  = regressione dello stato dell'integrale */
-    _sint64_add(&sPo_PostnerOut.sDemand.sqPostn, &sPo_PostnerOut.sqPosErr, &psPo_InFeedBack->sqPostn) ; 
+    s64_st(&sPo_PostnerOut.sDemand.sqPostn, s64_add(sllPosErr, sllFeedBack)) ; 
 
 
     /* se e' attiva la flag di saturazione delle rampe e se sono in limite di PosErr (Max o Min),  
@@ -941,20 +921,20 @@ static void SRamp8kHz(void)
     }
 
     /* calcolo la regressione dello stato del filtro */
-    _sint64toSint48(&sqSpd48) ;
-    _sint64_mul_48_16(&sPostnerRun.sSRamp.sqFilterStatus64, &sqSpd48, &sPostnerRun.sSRamp.swK2) ;
-    _sint64_shr(&sPostnerRun.sSRamp.sqFilterStatus64, sPostnerRun.sSRamp.uwAbsK1) ;
+    s64_st(&sPostnerRun.sSRamp.sqFilterStatus64, s64_shr(s64_mul_64_16(s64_sat48(sllSpd48), sPostnerRun.sSRamp.swK2), sPostnerRun.sSRamp.uwAbsK1)) ;
     if (sPo_PlcWorks.flags.b.bSRampInSaturation)
     {
-        if ((psPo_ILimitActive->b.bIqMax || psPo_ILimitActive->b.bIqMin) && (sPo_PostnerOut.sqPosErr.hi & 0x80000000))
+        if ((psPo_ILimitActive->b.bIqMax || psPo_ILimitActive->b.bIqMin) && (sllPosErr < 0))
         {             
-            _sint64_add(&sPostnerRun.psDemand->sqPostn, &sSS_CntrLoopOut.sqFitPErrMin, &psPo_InFeedBack->sqPostn) ;  /* Position error is set to AutoPosErr*/
-            _sint64_add(&sPo_PostnerOut.sDemand.sqPostn, &sSS_CntrLoopOut.sqFitPErrMin, &psPo_InFeedBack->sqPostn) ;  /* Position error is set to AutoPosErr*/
+            sllTemp64 = s64_add(s64_ld(&sSS_CntrLoopOut.sqFitPErrMin), sllFeedBack) ;  /* Position error is set to AutoPosErr*/
+            s64_st(&sPostnerRun.psDemand->sqPostn, sllTemp64) ;
+            s64_st(&sPo_PostnerOut.sDemand.sqPostn, sllTemp64) ;
         }
         else if (psPo_ILimitActive->b.bIqMax || psPo_ILimitActive->b.bIqMin)
         { 
-            _sint64_add(&sPostnerRun.psDemand->sqPostn, &sSS_CntrLoopOut.sqFitPErrMax, &psPo_InFeedBack->sqPostn) ;  /* Position error is set to AutoPosErr*/
-            _sint64_add(&sPo_PostnerOut.sDemand.sqPostn, &sSS_CntrLoopOut.sqFitPErrMax, &psPo_InFeedBack->sqPostn) ;  /* Position error is set to AutoPosErr*/
+            sllTemp64 = s64_add(s64_ld(&sSS_CntrLoopOut.sqFitPErrMax), sllFeedBack) ;  /* Position error is set to AutoPosErr*/
+            s64_st(&sPostnerRun.psDemand->sqPostn, sllTemp64) ;
+            s64_st(&sPo_PostnerOut.sDemand.sqPostn, sllTemp64) ;
         }    
         else
         {
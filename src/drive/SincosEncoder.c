@@ -34,6 +34,7 @@
 
 /* ================================ #define ================================ */
 #define SINCOSALARMCOUNTERMAX   5
+#define SINCOSATANGRADE         MATH_GRADE_FINE   // encoder angle, division free
 
 
 /* ============================== structures =============================== */
@@ -286,9 +287,9 @@ static BOOL SinCosEnc8KHz(SINCOS_RUNTIME *pSinCosRun)
   uwEncAngle_1 = pSinCosRun->uwEncAngle ; /* previous encoder angle */
 
   if(pSinCosRun->flags.b.bReverseSignals)
-    pSinCosRun->uwEncAngle = 0xffff - ATan16(sSc_DataOut.swSinChannel, sSc_DataOut.swCosChannel) ;
+    pSinCosRun->uwEncAngle = 0xffff - ATan16Grade(sSc_DataOut.swSinChannel, sSc_DataOut.swCosChannel, SINCOSATANGRADE) ;
   else 
-    pSinCosRun->uwEncAngle = ATan16(sSc_DataOut.swSinChannel, sSc_DataOut.swCosChannel) ;
+    pSinCosRun->uwEncAngle = ATan16Grade(sSc_DataOut.swSinChannel, sSc_DataOut.swCosChannel, SINCOSATANGRADE) ;
 
   if ( (            uwEncAngle_1 & 0x8000) &&  (            uwEncAngle_1 & 0x4000) &&
       !(pSinCosRun->uwEncAngle   & 0x8000) && !(pSinCosRun->uwEncAngle   & 0x4000)   ) 
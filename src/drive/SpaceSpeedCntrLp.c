@@ -60,6 +60,17 @@
 #define FLOAT_2PI_IU                   (10000.0 * 2.0 * FLOAT_PI)
 
 /* ============================== structures =============================== */
+/* float gains paired to each SS_RT_PARAMS image, already referred to the
+   output: IqRef = Kp * input (no global/position/acceleration shifts) */
+typedef struct {
+  FLOAT flPostnKp ;
+  FLOAT flSpdKpRef ;
+  FLOAT flSpdKpFbk ;
+  FLOAT flAccKpRef ;
+  FLOAT flAccKpFbk ;
+  FLOAT flKi ;       /* per tick, on the proportional output */
+} SS_RT_FLGAINS ;
+
 typedef struct {
   /* Flags */
   union {
@@ -86,6 +97,13 @@ typedef struct {
   SQWRD sqIntegral_1 ; /* necessary to add here in order to reset the regression */
   SQWRD sqPosErr64 ; /* Position Error = PosRef - PosFbk */
   SWORD swGlobalGainShift_1 ;
+
+  /* float loop */
+  BOOL bFloatLoop ;    /* in use */
+  BOOL bFloatLoopReq ; /* requested, taken over by the next tick */
+  SS_RT_FLGAINS sFlGains[2] ; /* same index as sPars */
+  SS_RT_FLGAINS sFlGainsUsr ;
+  FLOAT flIntegral_1 ;
 } SS_RUNTIME ;
 
 SS__INPUT sSS_CntrLoopIn  ;
@@ -125,6 +143,8 @@ static SS_PAR_GAINS sShadowFloatGains ;
 
 /* =============================== functions =============================== */
 static BOOL Ss_ControlLoop8KHz(void) ;
+static BOOL ssloopfixed(void) ;
+static BOOL ssloopfloat(void) ;
 static void Ss_ControlLoopBkGd(void) ;
 static BOOL copyandcheckparameters(void);
 
@@ -134,6 +154,8 @@ static SWORD CheckSWordParam(SWORD swParamVal, SWORD swPositiveLimit, SWORD swNe
 static SBYTE NBitsFloat(FLOAT flInValue) ;
 static BOOL CtrLpGainsInternalUnits2EngineeringUnits(void) ;
 static void AutoMaxPosError(void) ;
+static SS_RT_FLGAINS * FlGains(const SS_RT_PARAMS * psParRT) ;
+static void RtGains2FlGains(const SS_RT_PARAMS * psParRT, SS_RT_FLGAINS * psFlGains) ;
 
 /* ######################################################################### */
 static UWORD CheckUWordParam(UWORD uwParamVal, UWORD uwLimit) 
@@ -161,6 +183,7 @@ static SWORD CheckSWordParam(SWORD swParamVal, SWORD swPositiveLimit, SWORD swNe
 BOOL Ss_ControlLoopInit(void)
 {
   sSpaceSpeedRun.bParUsr = FALSE;
+  sSpaceSpeedRun.bFloatLoop = sSpaceSpeedRun.bFloatLoopReq = SS_FLOAT_LOOP ;
 
   // initialize parameters pointer
   sSpaceSpeedRun.psParStd = &sSpaceSpeedRun.sPars[1];
@@ -180,6 +203,7 @@ BOOL Ss_ControlLoopInit(void)
     
   /* ====================== reset the integral ====================== */  
   INT64_ASSIGN(sSpaceSpeedRun.sqIntegral_1, 0L, 0UL) ;
+  sSpaceSpeedRun.flIntegral_1 = 0.0f ;
 
   // switch parameters to valid
   sSpaceSpeedRun.psParStd = &sSpaceSpeedRun.sPars[0];
@@ -226,7 +250,32 @@ static BOOL copyandcheckparameters(void)
 }
 
 /* ######################################################################### */
+/* arithmetic selection; the integral is carried to the loop taking over,
+   so the torque does not step: the fixed point integral is referred to the
+   global shift of its last run, IqRef = X / 2^(GlobalShift_1+16) */
 static BOOL Ss_ControlLoop8KHz(void)
+{
+  BOOL bFloatLoop = sSpaceSpeedRun.bFloatLoopReq ;
+  SWORD swOutShift = sSpaceSpeedRun.swGlobalGainShift_1 + 16 ;
+
+  if (bFloatLoop != sSpaceSpeedRun.bFloatLoop)
+  {
+    if (bFloatLoop)
+      sSpaceSpeedRun.flIntegral_1 = ldexpf((FLOAT)s64_ld(&sSpaceSpeedRun.sqIntegral_1), -swOutShift) ;
+    else
+      s64_st(&sSpaceSpeedRun.sqIntegral_1, (SLLNG)ldexpf(sSpaceSpeedRun.flIntegral_1, swOutShift)) ;
+    sSpaceSpeedRun.bFloatLoop = bFloatLoop ;
+  }
+
+  if (bFloatLoop)
+    return ssloopfloat() ;
+
+  return ssloopfixed() ;
+}
+
+
+/* ######################################################################### */
+static BOOL ssloopfixed(void)
 {
   SS_RT_PARAMS * psParRT;
   BOOL  bIntegralReset ;
@@ -386,6 +435,113 @@ static BOOL Ss_ControlLoop8KHz(void)
 }
 
 
+/* ######################################################################### */
+/* same structure as the fixed point loop, all terms referred to IqRef:
+   no 48bit clipping of the contributes and no integral rescale on global
+   shift change; the output saturates instead of wrapping */
+static BOOL ssloopfloat(void)
+{
+  SS_RT_PARAMS * psParRT;
+  SS_RT_FLGAINS * psGains;
+  BOOL  bIntegralReset ;
+
+  FLOAT flPropOutValue, flIntegralOutValue, flIqRef ;
+  FLOAT flMax, flMin ;
+
+  // data selection
+  if(sSpaceSpeedRun.bParUsr)
+    psParRT = &sSpaceSpeedRun.sParUsr;
+  else
+    psParRT = sSpaceSpeedRun.psParStd;
+  psGains = FlGains(psParRT);
+
+  // keep integral reset until full power is enabled, or Ki = 0
+  if (sSS_CntrLoopIn.psMotCtrlStatus->b.bPID_IntegralEnable)
+      bIntegralReset = (psGains->flKi == 0.0f) ;
+  else
+      bIntegralReset = TRUE ;
+
+  /* ======= Position proportional contribute ======= */
+  /* error kept 64bit (48bit clipped) for background and max error check */
+  s64_st(&sSpaceSpeedRun.sqPosErr64, s64_sat48(s64_sub(s64_ld(&sSS_CntrLoopIn.psRef->sqPostn), s64_ld(&sSS_CntrLoopIn.psFbk->sEncData.sqPostn)))) ;
+  flPropOutValue = psGains->flPostnKp * (FLOAT)s64_ld(&sSpaceSpeedRun.sqPosErr64) ;
+
+  /* ======= Speed proportional contribute ======= */
+  flPropOutValue += psGains->flSpdKpRef * (FLOAT)sSS_CntrLoopIn.psRef->slSpeed ;
+  flPropOutValue -= psGains->flSpdKpFbk * (FLOAT)sSS_CntrLoopIn.psFbk->sEncData.slSpeed ;
+
+  /* ======= Acceleration proportional contribute ======= */
+  if (sSS_CntrLoopParam.sPars.flags.b.bFilterAccRef)
+  { // filter acc ref
+    sSS_CntrLoopOut.slAccRefFiltered32 = _sint32_scale_16(sSS_CntrLoopOut.slAccRefFiltered32, sSS_CntrLoopParam.sPars.swAccKFilter) + 
+                                         _sint32_scale_16(sSS_CntrLoopIn.psRef->slAccel,     (32767-sSS_CntrLoopParam.sPars.swAccKFilter)) ;
+  }
+  else
+  { // keep acc ref filter status updated
+    sSS_CntrLoopOut.slAccRefFiltered32 = sSS_CntrLoopIn.psRef->slAccel ; 
+  }
+
+  flPropOutValue += psGains->flAccKpRef * (FLOAT)sSS_CntrLoopOut.slAccRefFiltered32 ;
+  flPropOutValue -= psGains->flAccKpFbk * (FLOAT)sSS_CntrLoopIn.psFbk->sEncData.slAccel ;
+
+  /* ======= Integral contribute ======= */
+  if(bIntegralReset)
+    sSpaceSpeedRun.flIntegral_1 = 0.0f ;
+
+  flIntegralOutValue = sSpaceSpeedRun.flIntegral_1 + flPropOutValue * psGains->flKi ;
+
+  /* limit integral contribute to the current limits computed in background */
+  flMax = (FLOAT)sSpaceSpeedRun.slILimMax ;
+  flMin = (FLOAT)sSpaceSpeedRun.slILimMin ;
+
+  if ((flIntegralOutValue > flMax) && (flIntegralOutValue < flMin))
+    flIntegralOutValue = 0.0f ;
+  else if (flIntegralOutValue > flMax)
+    flIntegralOutValue = flMax ;
+  else if (flIntegralOutValue < flMin)
+    flIntegralOutValue = flMin ;
+
+  sSpaceSpeedRun.flIntegral_1 = flIntegralOutValue ;
+
+  /* ======= OutValue ======= */
+  flIqRef = flPropOutValue + flIntegralOutValue ;
+  if (flIqRef >= (FLOAT)SLONG_MAX_VALUE)
+    sSS_CntrLoopOut.sIRef.slIqRef = SLONG_MAX_VALUE ;
+  else if (flIqRef <= (FLOAT)SLONG_MIN_VALUE)
+    sSS_CntrLoopOut.sIRef.slIqRef = SLONG_MIN_VALUE ;
+  else
+    sSS_CntrLoopOut.sIRef.slIqRef = (SLONG)flIqRef ;
+  sSS_CntrLoopOut.sIRef.slIdRef = sSS_CntrLoopIn.psCurrentRefs->slIdRef;
+
+  return TRUE ;
+}
+
+/* ######################################################################### */
+/* float gains paired to a runtime parameter image */
+static SS_RT_FLGAINS * FlGains(const SS_RT_PARAMS * psParRT)
+{
+  if (psParRT == &sSpaceSpeedRun.sParUsr)
+    return &sSpaceSpeedRun.sFlGainsUsr ;
+
+  return &sSpaceSpeedRun.sFlGains[psParRT - sSpaceSpeedRun.sPars] ;
+}
+
+/* ######################################################################### */
+/* float gains from integer gains and shifts (user images set by plc):
+   IqRef = X / 2^(GlobalShift+16) of the fixed point loop */
+static void RtGains2FlGains(const SS_RT_PARAMS * psParRT, SS_RT_FLGAINS * psFlGains)
+{
+  SWORD swOutShift = -(psParRT->swGlobalGainShift + 16) ;
+
+  psFlGains->flPostnKp  = ldexpf((FLOAT)psParRT->swPostnKp,  swOutShift - (SWORD)psParRT->uwPosGainShift) ;
+  psFlGains->flSpdKpRef = ldexpf((FLOAT)psParRT->swSpdKpRef, swOutShift) ;
+  psFlGains->flSpdKpFbk = ldexpf((FLOAT)psParRT->swSpdKpFbk, swOutShift) ;
+  psFlGains->flAccKpRef = ldexpf((FLOAT)psParRT->swAccKpRef, swOutShift + (SWORD)psParRT->uwAccGainShift) ;
+  psFlGains->flAccKpFbk = ldexpf((FLOAT)psParRT->swAccKpFbk, swOutShift + (SWORD)psParRT->uwAccGainShift) ;
+  psFlGains->flKi       = ldexpf((FLOAT)psParRT->swKi, -16) ;
+}
+
+
 /* ######################################################################### */
 static void Ss_ControlLoopBkGd(void)
 {
@@ -418,6 +574,7 @@ static void Ss_ControlLoopBkGd(void)
     if(sSpaceSpeedRun.flags.b.bInvElecAngleDetect)
     {
         _sint64_atomic_copy(&sSpaceSpeedRun.sqIntegral_1, &sqZero64bit) ;
+        sSpaceSpeedRun.flIntegral_1 = 0.0f ;
         fast_atomic_clear_flag(sSpaceSpeedRun.flags.b.bInvElecAngleDetect);
     }
 
@@ -553,6 +710,7 @@ BOOL PlcCtrLpGainsCompute(SS_PAR_GAINS * pfSrc, SS_RT_PARAMS * pvDst)
         {
             // prima di uscire ricopio in update i valori attuali
             hmemcpy(sSpaceSpeedRun.psParUpd, sSpaceSpeedRun.psParStd, sizeof(SS_RT_PARAMS));
+            *FlGains(sSpaceSpeedRun.psParUpd) = *FlGains(sSpaceSpeedRun.psParStd);
             return bRetVal;
         }
 #else // _infineon_
@@ -560,6 +718,7 @@ BOOL PlcCtrLpGainsCompute(SS_PAR_GAINS * pfSrc, SS_RT_PARAMS * pvDst)
         {
             // prima di uscire ricopio in update i valori attuali
             memcpy(sSpaceSpeedRun.psParUpd, sSpaceSpeedRun.psParStd, sizeof(SS_RT_PARAMS));
+            *FlGains(sSpaceSpeedRun.psParUpd) = *FlGains(sSpaceSpeedRun.psParStd);
             return bRetVal;
         }
 #endif // _infineon_
@@ -764,6 +923,23 @@ BOOL PlcCtrLpGainsCompute(SS_PAR_GAINS * pfSrc, SS_RT_PARAMS * pvDst)
       _sint64_shr(&u.sqTmp, (UWORD)(-swGlobalGainShift2Use));
     INT64_COPY(pvDst->sqIntegralMinLimit, u.sqTmp);
 
+    // float gains straight from engineering units (no shift ranges) for own images
+    if(pvDst == sSpaceSpeedRun.psParUpd)
+    {
+        SS_RT_FLGAINS * psFlGains = FlGains(pvDst);
+        FLOAT flKi = pfSrc->flKi * CONVFACT_INTEGRALGAIN ;
+
+        psFlGains->flPostnKp  = pfSrc->flPosKp    * (FLOAT)(CONVFACT_POSGAIN   / 65536.0) ;
+        psFlGains->flSpdKpRef = pfSrc->flSpdKpRef * (FLOAT)(CONVFACT_SPEEDGAIN / 65536.0) ;
+        if(sSS_CntrLoopParam.sPars.flags.b.bUseDifferentKp)
+          psFlGains->flSpdKpFbk = pfSrc->flSpdKpFbk * (FLOAT)(CONVFACT_SPEEDGAIN / 65536.0) ;
+        else
+          psFlGains->flSpdKpFbk = psFlGains->flSpdKpRef ;
+        psFlGains->flAccKpRef = pfSrc->flAccKpRef * (FLOAT)(CONVFACT_ACCELGAIN / 65536.0) ;
+        psFlGains->flAccKpFbk = pfSrc->flAccKpFbk * (FLOAT)(CONVFACT_ACCELGAIN / 65536.0) ;
+        psFlGains->flKi       = (flKi > 0.0f ? flKi : 0.0f) * (FLOAT)(1.0 / 65536.0) ;
+    }
+
     return bRetVal;  
 }
 
@@ -969,8 +1145,19 @@ BOOL PlcCtrLpGainsSelect(SS_RT_PARAMS * pvSrc)
 #else // _infineon_
         memcpy(&sSpaceSpeedRun.sParUsr, pvSrc, sizeof(SS_RT_PARAMS));
 #endif // _infineon_
+        RtGains2FlGains(&sSpaceSpeedRun.sParUsr, &sSpaceSpeedRun.sFlGainsUsr);
         sSpaceSpeedRun.bParUsr = TRUE;
     }
     
     return TRUE;
 }
+
+//***************************************************************************
+// Loop arithmetic selector: FALSE 64bit fixed point, TRUE float; taken
+// over by the next tick, which carries the integral across
+BOOL PlcCtrLpSelectFloat(BOOL bFloat)
+{
+    sSpaceSpeedRun.bFloatLoopReq = bFloat ? TRUE : FALSE ;
+
+    return TRUE;
+}
@@ -20,6 +20,14 @@
  
 /* ================================ #define ================================ */
 
+/* Loop arithmetic at startup: 0 = 64bit fixed point with gain shifts
+   (default), 1 = single precision float on the VFP; both loops are built
+   and PlcCtrLpSelectFloat switches at runtime. Gains, shifts and PLC
+   interface are the same for both */
+#ifndef SS_FLOAT_LOOP
+ #define SS_FLOAT_LOOP 0
+#endif
+
 /* ========================== old structures =============================== */
 
 typedef struct {
@@ -169,6 +177,7 @@ SWORD Ss_GetV15Params(SS_V15_PARAMS * pvSrc, UWORD uwSize);
 BOOL PlcCtrLpGainsCompute(SS_PAR_GAINS * pfSrc, SS_RT_PARAMS * pvDst);
 BOOL PlcCtrLpGainsSelect(SS_RT_PARAMS * pvSrc);   
 #endif // _infineon_
+BOOL PlcCtrLpSelectFloat(BOOL bFloat);
 
 #endif // _SS_H
 /* EOF */
@@ -24,7 +24,7 @@
 
 #include "drive\ThermalModel.h"
 #include "common\MathFunctions.h"
-#include "common\Int64Functions.h" /* to use 64bit operations (BiQuad) */
+#include "common\DspFilter.h" /* BiQuad */
 
 #ifdef _INFINEON_
 #include "AlteraFpgaHandler.h" /* to manage the FAN */
@@ -117,6 +117,10 @@
 #define MIN_UPDATE_PERIOD           (16 * 8) // msec
 #define MAX_UPDATE_PERIOD           (20 * 8) // msec
 
+    // "8KHz" sampling stage runs every # realtime slots with a balanced
+    // phase; counts stay in 125us ticks, sums are scaled to ticks on hand over
+#define TM_RT_NSLOTS                2
+
 #ifdef _INFINEON_
 #define FAN_DRIVE_STATUS            (getfanstatus())
 #define FAN_DRIVE_SET(x)            {setfanstatus(x);}
@@ -155,6 +159,7 @@
 #define BIQUAD_COEFF_B0     15566 
 #define BIQUAD_COEFF_B1    -31934 
 #define BIQUAD_COEFF_B2     16384 
+#define BIQUAD_COEFF_SHIFT  14      // log2(BIQUAD_COEFF_B2)
 
 #define MOTOR_I2T_IU2ARMS_SQUARED 0.00000001  // (i.u.->Arms)^2 = (1.0 / 10000.0)^2
 
@@ -284,12 +289,7 @@ typedef struct {
 } THERMAL_MODEL_SLOW_TASK_VARIABLES ;
 
 
-typedef struct {
-    SWORD swX_1 ;
-    SWORD swX_2 ;
-    SLONG slY_1 ;
-    SLONG slY_2 ;
-} THERMAL_MODEL_BIQUAD ;
+typedef DSPFLT_BIQUAD_Q31_STATE THERMAL_MODEL_BIQUAD ;
 
 typedef struct {
     union {
@@ -999,7 +999,7 @@ BOOL Tm_ThermalModelInit(void)
   sMediumTaskHandle = Os_TaskCreateEx(&Tm_ThermalModelMediumTask,512,"TmMediumTask");
 
   /* install 8KHz function */
-  return TaskSched_AddRTTask(&Tm_ThermalModel8KHz, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), 0) ; 
+  return TaskSched_AddRTTask(&Tm_ThermalModel8KHz, TASKSCHEDULER_FLAG_EXEEVERYNSLOTS, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), TM_RT_NSLOTS) ; 
 }
 
 
@@ -1171,7 +1171,8 @@ static BOOL Tm_ThermalModel8KHz(void)
     if (FPGA_PWM_STATUS_BRAKE_ACTIVE(FPGA_PWM_STATUS))
         sThModRun_sServoMediumTask.uwRBrakeON++ ; /* in this servo, RBrake is ON */ 
 
-    if ( ++sThModRun_sServoMediumTask.uwCnts >= MIN_UPDATE_PERIOD)
+    sThModRun_sServoMediumTask.uwCnts += TM_RT_NSLOTS ;
+    if (sThModRun_sServoMediumTask.uwCnts >= MIN_UPDATE_PERIOD)
     {
         if (!sThModRun.flags.b.bTaskRunning) 
         {   // thermal model task IS NOT running
@@ -1180,31 +1181,31 @@ static BOOL Tm_ThermalModel8KHz(void)
                 
                 // update data to slow task
                 sThModRun.sImageMediumTask.uwCnts     = sThModRun_sServoMediumTask.uwCnts ;
-                sThModRun.sImageMediumTask.uwRBrakeON = sThModRun_sServoMediumTask.uwRBrakeON ;
-                sThModRun.sImageMediumTask.slDcBus    = sThModRun_sServoMediumTask.slDcBus ;
-                sThModRun.sImageMediumTask.slIuPkHi   = sThModRun_sServoMediumTask.slIuPkHi ; 
-                sThModRun.sImageMediumTask.slIvPkHi   = sThModRun_sServoMediumTask.slIvPkHi ; 
-                sThModRun.sImageMediumTask.slIwPkHi   = sThModRun_sServoMediumTask.slIwPkHi ; 
-                sThModRun.sImageMediumTask.slIuPkLo   = sThModRun_sServoMediumTask.slIuPkLo ; 
-                sThModRun.sImageMediumTask.slIvPkLo   = sThModRun_sServoMediumTask.slIvPkLo ; 
-                sThModRun.sImageMediumTask.slIwPkLo   = sThModRun_sServoMediumTask.slIwPkLo ; 
+                sThModRun.sImageMediumTask.uwRBrakeON = sThModRun_sServoMediumTask.uwRBrakeON * TM_RT_NSLOTS ;
+                sThModRun.sImageMediumTask.slDcBus    = sThModRun_sServoMediumTask.slDcBus * TM_RT_NSLOTS ;
+                sThModRun.sImageMediumTask.slIuPkHi   = sThModRun_sServoMediumTask.slIuPkHi * TM_RT_NSLOTS ; 
+                sThModRun.sImageMediumTask.slIvPkHi   = sThModRun_sServoMediumTask.slIvPkHi * TM_RT_NSLOTS ; 
+                sThModRun.sImageMediumTask.slIwPkHi   = sThModRun_sServoMediumTask.slIwPkHi * TM_RT_NSLOTS ; 
+                sThModRun.sImageMediumTask.slIuPkLo   = sThModRun_sServoMediumTask.slIuPkLo * TM_RT_NSLOTS ; 
+                sThModRun.sImageMediumTask.slIvPkLo   = sThModRun_sServoMediumTask.slIvPkLo * TM_RT_NSLOTS ; 
+                sThModRun.sImageMediumTask.slIwPkLo   = sThModRun_sServoMediumTask.slIwPkLo * TM_RT_NSLOTS ; 
 #ifndef _INFINEON_
                 sThModRun.sImageSlowTask.uwSBoardTemp  = sTm_ThModIn.psAdcIoData->uwSBoardTemp ;
                 sThModRun.sImageSlowTask.flSOnchipTemp = sTm_ThModIn.psAdcIoData->fSOnchipTemp ;
 #endif // _infineon_
 
-                sThModRun.sImageSlowTask.ulNtc = sThModRun_sServoSlowTask.ulNtc ;
+                sThModRun.sImageSlowTask.ulNtc = sThModRun_sServoSlowTask.ulNtc * TM_RT_NSLOTS ;
 #ifndef _HW_DC
                 sThModRun.sImageSlowTask.uwMotorTemp = sTm_ThModIn.psAdcIoData->uwSMotorTemp ; // no filtering (present value)
 #else
-                sThModRun.sImageSlowTask.ulBr1Ntc    = sThModRun_sServoSlowTask.ulBr1Ntc ;
-                sThModRun.sImageSlowTask.ulBr2Ntc    = sThModRun_sServoSlowTask.ulBr2Ntc ;
+                sThModRun.sImageSlowTask.ulBr1Ntc    = sThModRun_sServoSlowTask.ulBr1Ntc * TM_RT_NSLOTS ;
+                sThModRun.sImageSlowTask.ulBr2Ntc    = sThModRun_sServoSlowTask.ulBr2Ntc * TM_RT_NSLOTS ;
 
                 sThModRun.sImageSlowTask.uwMotorPTC  = sTm_ThModIn.psAdcIoData->uwSMotorPTCTemp ;
                 sThModRun.sImageSlowTask.uwMotorKTY  = sTm_ThModIn.psAdcIoData->uwSMotorKTYTemp ;
 #endif // _hw_dc
 #ifdef _HW_CT
-                sThModRun.sImageSlowTask.ulBrdNtc    = sThModRun_sServoSlowTask.ulBrdNtc ;
+                sThModRun.sImageSlowTask.ulBrdNtc    = sThModRun_sServoSlowTask.ulBrdNtc * TM_RT_NSLOTS ;
 #endif // _hw_ct
 
                 // execute slow task
@@ -1743,42 +1744,27 @@ static void BrdTNtc(void)
 
 /* ========================================================================= */
 /* Output = (A0 * Input + A1 * Input_1 + A2 * Input_2 - B1 * Output_1 - B0 * Output_2 ) / B2 */
+/* Output is kept Q16 (Input * 65536) in the filter state                   */
+static const DSPFLT_BIQUAD_Q31 sBiQuadCoeff =
+{
+    BIQUAD_COEFF_A0 << 16,
+    BIQUAD_COEFF_A1 << 16,
+    BIQUAD_COEFF_A2 << 16,
+    -BIQUAD_COEFF_B1,
+    -BIQUAD_COEFF_B0,
+    BIQUAD_COEFF_SHIFT
+} ;
+
 #ifdef _INFINEON_
 static SWORD BiQuadFilter48Bit(SWORD swInputVal, THERMAL_MODEL_BIQUAD huge * psFilterStatus)
 #else
 static SWORD BiQuadFilter48Bit(SWORD swInputVal, THERMAL_MODEL_BIQUAD * psFilterStatus)
 #endif // _infineon_
 {
-    SQWRD sqInput48, sqOutput48 ;
-    SQWRD sqTmp48_0, sqTmp48_1, sqTmp48_2 ;
-    SLONG slInput32 ;
-    SWORD swTmp ;
-    SLONG slTmp ;
+    SLONG slInputVal = swInputVal ;
     SLONG slOutputVal ;
 
-    // input (sempre positivo perche' e' una potenza)
-    slInput32 = BIQUAD_COEFF_A0 * (SLONG)swInputVal + BIQUAD_COEFF_A1 * (SLONG)psFilterStatus->swX_1 + BIQUAD_COEFF_A2 * (SLONG)psFilterStatus->swX_2 ;
-    INT64_ASSIGN(sqInput48, slInput32>>16, (ULONG)slInput32<<16) ; // Input48 = Input32 * 65536    
-
-    //outputs
-    slTmp = psFilterStatus->slY_1;
-    swTmp = BIQUAD_COEFF_B1 ;
-    _sint64_mul_32_16(&sqTmp48_1, &slTmp, &swTmp) ; // Tmp48_1 = Output32_1 * Coeff16_B1
-    slTmp = psFilterStatus->slY_2;
-    swTmp = BIQUAD_COEFF_B0 ;
-    _sint64_mul_32_16(&sqTmp48_0, &slTmp, &swTmp) ; // Tmp48_0 = Output32_2 * Coeff16_B0
-
-    _sint64_add(&sqTmp48_2, &sqTmp48_1, &sqTmp48_0) ;  // sqTmp48_2  = sqTmp48_1 + sqTmp48_0
-    _sint64_sub(&sqOutput48, &sqInput48, &sqTmp48_2) ; // sqOutput48 = sqInput48 - sqTmp48_2
-    _sint64_shr(&sqOutput48, 14) ;                     // sqOutput48 / Coeff16_B2
-    slOutputVal = (SLONG)INT64_LLONG(sqOutput48) ;     // stato del filtro: sono i 32 bit piu' bassi
-
-    // regressioni
-    psFilterStatus->swX_2 = psFilterStatus->swX_1 ; // sample i-2
-    psFilterStatus->swX_1 = swInputVal ;            // sample i-1
-
-    psFilterStatus->slY_2 = psFilterStatus->slY_1 ;
-    psFilterStatus->slY_1 = slOutputVal ; 
+    DspFlt_BiquadQ31(&sBiQuadCoeff, 1, psFilterStatus, &slInputVal, &slOutputVal, 1, 1) ;
 
     return (SWORD)(slOutputVal * 10 / 65536) ; // 1e-1 W
 }
@@ -437,7 +437,7 @@ BOOL UserIO_Init(UWORD w)
 
     assert(pfUsrIOAnInpProcessing);
 
-    if(!TaskSched_AddRTTask(&UserIO_RT_task, TASKSCHEDULER_FLAG_NONE, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), 0))
+    if(!TaskSched_AddRTTask(&UserIO_RT_task, TASKSCHEDULER_FLAG_EXEEVERYNSLOTS, 0, SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING), USRIO_RT_NSLOTS))
         return FALSE;
 
         // refresh values
@@ -38,6 +38,9 @@ extern SWORD swUsrIOAnalogOut0Offset;
 extern UMCONV_CONV32TO16 sUsrIOAnalogOut1Conv;
 extern SWORD swUsrIOAnalogOut1Offset;
 
+    // realtime task runs every # slots, phase balanced by the scheduler
+#define USRIO_RT_NSLOTS     2
+
 extern void (* pfUsrIOAnInpProcessing)(void);
 extern void (* pfUsrIOIOExpProcess)(void);
 
@@ -19,6 +19,7 @@
 #include "xgpiops.h"
 
 #include "system\SysAppGlobals.h"
+#include "common\Crc.h"
 
 #include "core\Gpio.h"
 
@@ -321,21 +322,11 @@ STGAP4S_CONFIG_REGISTER_PARAMS stgap4sCONFIG_VALUES;
 /// CRC-8/ROHC : x^8 + x^2 + x^1 + 1
 ///</summary>
 //
-#define CRC8_POLYNOMIAL 	0x07
 #define CRC8_INTIALSEED 	0xff
 //
 static u8 __crc8(u8 crc, u8 dat)
 {
-	crc = crc ^ dat;
-
-	for (u8 i=0; i<8; i++)
-	{
-		if (crc & 0x80)
-			crc = (crc << 1) ^ CRC8_POLYNOMIAL;
-		else
-			crc = (crc << 1);
-	}
-	return crc;
+	return Crc8_Update(crc, &dat, 1);
 }
 
 
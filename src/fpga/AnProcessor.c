@@ -21,6 +21,8 @@
 #include "fpga\FpgaHandler.h"
 #include "common\UnitMeasureConversion.h"
 
+#include <string.h>
+
 /////////////////////////////////////////////////////////////////////////////
 // Compiler Option
 #pragma GCC optimize (2)
@@ -88,6 +90,7 @@ static AN_SCALER    hpsScalerSetup[CHANSETUP_SIZE*4];
 static UWORD        uwShortSz=0;
 static UWORD        uwLongSz=0;
 static ANPROC_TABLE hpsRefreshTable[CHANEXT_SIZE];
+static UBYTE        hpubExtSlot[CHANSETUP_SIZE*4];
 
 //****************************************************************************
 // Local functions
@@ -113,6 +116,7 @@ BOOL AnProc_Init(UWORD uwTaskParam)
                 hpsRgOutSetup[i].pvDst=NULL;
             for(i=0;i<CHANEXT_SIZE;i++)
                 hpsRefreshTable[i].pvDst=NULL;
+            memset(hpubExtSlot, ANPROC_EXTSLOT_NONE, sizeof(hpubExtSlot));
 
                 // install reader before any other drive and I/O task
             return TaskSched_AddRTTask(&AnProc_ForceRefresh, TASKSCHEDULER_FLAG_NONE, 0, 0, 0);
@@ -181,6 +185,40 @@ BOOL AnProc_RGOutSet(UBYTE ubSrcTag, ANPROC_RGOUT * hpsRgOut)
     return TRUE;
 }
 
+//***************************************************************************
+// Get actual channel output setup
+
+BOOL AnProc_RGOutGet(UBYTE ubSrcTag, ANPROC_RGOUT * hpsRgOut)
+{
+        // assert tag validity
+    assert(ubSrcTag>=ANPROC_RGO_TAGOFFSET && ubSrcTag<ANPROC_RGO_TAGOFFSET+CHANSETUP_SIZE*2);
+
+        // and get from store
+    ubSrcTag-=CHANSETUP_SIZE*2;
+    memcpy(hpsRgOut, &hpsRgOutSetup[ubSrcTag], sizeof(ANPROC_RGOUT));
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Get external buffer slot assigned by the compiler to a firmware destination
+// (immediate channel tag, ANPROC_AVG_TAGOFFSET + channel tag for average, or
+// channel output tag), FALSE if the destination is not in use
+
+BOOL AnProc_GetExtSlot(UBYTE ubSrcTag, UWORD * puwSlot, BOOL * pbLong)
+{
+        // assert tag validity
+    assert(ubSrcTag<CHANSETUP_SIZE*4);
+
+    if(hpubExtSlot[ubSrcTag]==ANPROC_EXTSLOT_NONE)
+        return FALSE;
+
+    *puwSlot=hpubExtSlot[ubSrcTag];
+    *pbLong=(*puwSlot>=uwShortSz);
+
+    return TRUE;
+}
+
 //***************************************************************************
 // Remove channel setup from local list
 
@@ -232,6 +270,7 @@ static BOOL compiler()
         // reset istruction list arrays
     memset(hpsPreSetup, 0, sizeof(hpsPreSetup));
     memset(hpsScalerSetup, 0, sizeof(hpsScalerSetup));
+    memset(hpubExtSlot, ANPROC_EXTSLOT_NONE, sizeof(hpubExtSlot));
 
         // count ext ptr short/long destinations
     for(i=0,uwShortSz=uwLongSz=0;i<CHANSETUP_SIZE;i++)
@@ -373,6 +412,7 @@ static BOOL compiler()
                 k=uwShortIdx++;
 
 //            psExtPtr[k]=hpsChanSetup[i].pvDstExtImm;
+            hpubExtSlot[i]=(UBYTE)k;
             rawset(1, SCA_EXTENABLE, sScal);
             rawset(k, SCA_EXTADDRESS, sScal);
         }
@@ -398,6 +438,7 @@ static BOOL compiler()
                 k=uwShortIdx++;
 
 //            psExtPtr[k]=hpsChanSetup[i].pvDstExtAvg;
+            hpubExtSlot[CHANSETUP_SIZE+i]=(UBYTE)k;
             rawset(1, SCA_EXTENABLE, sScal);
             rawset(k, SCA_EXTADDRESS, sScal);
         }
@@ -429,6 +470,7 @@ static BOOL compiler()
             k=uwShortIdx++;
 
 //        psExtPtr[k]=hpsRgOutSetup[i].pvDst;
+        hpubExtSlot[CHANSETUP_SIZE*2+i]=(UBYTE)k;
         rawset(1, SCA_EXTENABLE, sScal);
         rawset(k, SCA_EXTADDRESS, sScal);
 
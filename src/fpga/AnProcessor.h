@@ -35,7 +35,9 @@
 #define ANPROC_INIT_RUN                 2
 
 #define ANPROC_CHANNEL_SIZE             32
+#define ANPROC_AVG_TAGOFFSET            (ANPROC_CHANNEL_SIZE)
 #define ANPROC_RGO_TAGOFFSET            (ANPROC_CHANNEL_SIZE*2)
+#define ANPROC_EXTSLOT_NONE             0xFF
 
 //***************************************************************************
 // Data structures
@@ -72,6 +74,8 @@ BOOL AnProc_Init(UWORD uwSequence);
 BOOL AnProc_Set(UBYTE ubSrcTag, ANPROC_CHAN  * hpsChannel);
 BOOL AnProc_Get(UBYTE ubSrcTag, ANPROC_CHAN  * hpsChannel);
 BOOL AnProc_RGOutSet(UBYTE ubSrcTag, ANPROC_RGOUT  * hpsRgOut);
+BOOL AnProc_RGOutGet(UBYTE ubSrcTag, ANPROC_RGOUT  * hpsRgOut);
+BOOL AnProc_GetExtSlot(UBYTE ubSrcTag, UWORD * puwSlot, BOOL * pbLong);
 BOOL AnProc_UnSet(UBYTE ubSrcTag);
 BOOL AnProc_AdjustOffset(UBYTE ubSrcTag, UWORD uwOffset);
 BOOL AnProc_ReloadOffsets(void);
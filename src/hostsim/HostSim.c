@@ -0,0 +1,250 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSim.c                                                  */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host-native (x86-64 Linux) execution of the drive core     */
+/*               with simulated FPGA register file, clock and OS            */
+/*                                                                          */
+/****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "common\CommonDefines.h"
+#include "common\AppIdentTypes.h"
+#include "drive\AxM-E-Defines.h"
+#include "core\Gpio.h"
+#include "core\Interrupt.h"
+#include "system\Os.h"
+#include "fpga\FpgaHandler.h"
+#include "xtime_l.h"
+#include "HostSimHal.h"
+
+//***************************************************************************
+// Globals
+
+    // simulated MIO/EMIO pin levels
+UBYTE ubHostSimGpioPins[XGPIOPS_MAX_PINS];
+
+    // simulated global timer register
+volatile ULONG ulHostSimGlobalTimer;
+
+HOSTSIM_STATS sHostSimStats;
+
+    // driver instances normally defined by core\Gpio.c and core\Interrupt.c
+XGpioPs Gpio;
+XScuGic xInterruptController;
+
+//***************************************************************************
+// Locals
+
+static UBYTE ubHostSimClock;
+static BOOL bHostSimMapped;
+static ULLNG ullHostSimVirtualTime;
+static ULLNG ullHostSimHostOrigin;
+static UWORD uwHostSimOsTickCnt;
+
+static HOSTSIM_TICKHOOK pfHostSimPreTick;
+static HOSTSIM_TICKHOOK pfHostSimPostTick;
+
+//***************************************************************************
+// Host monotonic clock in 100nsec ticks
+
+static ULLNG HostClockNow(void)
+{
+    struct timespec sTs;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTs);
+
+    return (ULLNG)sTs.tv_sec*HOSTSIM_TIMER_TICKS_PER_SECOND+(ULLNG)sTs.tv_nsec/100;
+}
+
+//***************************************************************************
+// Map one simulated area at its fixed address
+
+static void MapArea(UINTPTR ulAddress, size_t ulSize)
+{
+    void * pvArea;
+
+    pvArea=mmap((void *)ulAddress, ulSize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+
+        // address is a hint only, do not overlap anything of the process
+    if(pvArea!=(void *)ulAddress)
+    {
+        fprintf(stderr, "hostsim: cannot map 0x%08lx-0x%08lx\n", (unsigned long)ulAddress, (unsigned long)(ulAddress+ulSize-1));
+        exit(EXIT_FAILURE);
+    }
+}
+
+//***************************************************************************
+// Map the simulated address areas (once)
+
+void HostSim_MapMemory(void)
+{
+    if(bHostSimMapped)
+        return;
+
+    MapArea(XPAR_AXI_ADAPTER_0_S00_AXI_BASEADDR, HOSTSIM_FPGA_REGFILE_SIZE);
+    MapArea(XPAR_AXI_ETHERCAT_0_BASEADDR, HOSTSIM_ESC_SIZE);
+    MapArea(XPS_QSPI_LINEAR_BASEADDR, HOSTSIM_FLASH_SIZE);
+
+    bHostSimMapped=TRUE;
+}
+
+//***************************************************************************
+// Init, reset register file, pins and clock
+
+void HostSim_Init(UBYTE ubClock)
+{
+    HostSim_MapMemory();
+
+    memset(uwHostSimFpgaRegFile, 0, HOSTSIM_FPGA_REGFILE_SIZE);
+    memset(ubHostSimEsc, 0, HOSTSIM_ESC_SIZE);
+
+        // identification of the standard application, type and build are
+        // zero as the control board FPGA type is unknown
+    FPGA_BUILD_APP=IDENT_FPGA_STANDARD;
+
+        // all inputs idle high, as reset button and power fail are low active
+    memset(ubHostSimGpioPins, 1, sizeof(ubHostSimGpioPins));
+
+    memset(&sHostSimStats, 0, sizeof(sHostSimStats));
+
+    ubHostSimClock=ubClock;
+    ullHostSimVirtualTime=0;
+    ullHostSimHostOrigin=HostClockNow();
+    uwHostSimOsTickCnt=0;
+
+    pfHostSimPreTick=NULL;
+    pfHostSimPostTick=NULL;
+}
+
+//***************************************************************************
+// Setup the hooks called before (inputs) and after (outputs) each tick
+
+void HostSim_SetTickHooks(HOSTSIM_TICKHOOK pfPreTick, HOSTSIM_TICKHOOK pfPostTick)
+{
+    pfHostSimPreTick=pfPreTick;
+    pfHostSimPostTick=pfPostTick;
+}
+
+//***************************************************************************
+// Clock source selected at init
+
+UBYTE HostSim_GetClock(void)
+{
+    return ubHostSimClock;
+}
+
+//***************************************************************************
+// Simulated clock in 100nsec ticks
+
+ULLNG HostSim_GetTime(void)
+{
+    if(ubHostSimClock==HOSTSIM_CLOCK_HOST)
+        return HostClockNow()-ullHostSimHostOrigin;
+
+    return ullHostSimVirtualTime;
+}
+
+//***************************************************************************
+// Consume simulated time (HOSTSIM_CLOCK_VIRTUAL only)
+
+void HostSim_Consume(ULONG ulTime100ns)
+{
+    ullHostSimVirtualTime+=ulTime100ns;
+}
+
+//***************************************************************************
+// Run # realtime ticks, return number of overruns
+
+ULONG HostSim_RunTicks(ULONG ulTicks)
+{
+    ULONG ulOverruns=0;
+    ULLNG ullSlotStart;
+    ULLNG ullTime;
+
+    while(ulTicks--)
+    {
+        ullSlotStart=HostSim_GetTime();
+        ulHostSimGlobalTimer=(ULONG)(ullSlotStart*(COUNTS_PER_SECOND/100000ul)/100ul);
+
+            // plant and stimuli update the register file before the tick
+        if(pfHostSimPreTick)
+            (*pfHostSimPreTick)(sHostSimStats.ulTicks);
+
+            // realtime interrupt
+        ullTime=HostSim_GetTime();
+        HostSimTimer_SlotStart(ullTime);
+        HostSimTimer_Fire();
+        ullTime=HostSim_GetTime()-ullTime;
+
+            // and consume the outputs
+        if(pfHostSimPostTick)
+            (*pfHostSimPostTick)(sHostSimStats.ulTicks);
+
+            // tick statistics
+        sHostSimStats.ulTicks++;
+        sHostSimStats.uwLastTime=(UWORD)min(ullTime,0xFFFFull);
+        sHostSimStats.ullSumTime+=ullTime;
+        if(sHostSimStats.uwLastTime>sHostSimStats.uwMaxTime)
+            sHostSimStats.uwMaxTime=sHostSimStats.uwLastTime;
+        if(ullTime>HOSTSIM_TIMER_TICKS_PER_RTSLOT)
+        {
+            sHostSimStats.ulOverruns++;
+            ulOverruns++;
+        }
+
+            // Os 1kHz tick
+        if(++uwHostSimOsTickCnt>=REALTIME_TASK_FREQ/configTICK_RATE_HZ)
+        {
+            uwHostSimOsTickCnt=0;
+            vApplicationTickHook();
+        }
+
+            // virtual clock moves to the next slot, unless the tick overran it
+        if(ubHostSimClock==HOSTSIM_CLOCK_VIRTUAL)
+        {
+            ullSlotStart+=HOSTSIM_TIMER_TICKS_PER_RTSLOT;
+            if(ullHostSimVirtualTime<ullSlotStart)
+                ullHostSimVirtualTime=ullSlotStart;
+        }
+    }
+
+    return ulOverruns;
+}
+
+//***************************************************************************
+// Simulated GPIO bank read
+
+u32 XGpioPs_Read(XGpioPs *InstancePtr, u8 Bank)
+{
+    static const UBYTE ubBankBase[]={MIO_BANK0_BASE, MIO_BANK1_BASE, MIO_BANK2_BASE, MIO_BANK3_BASE, XGPIOPS_MAX_PINS};
+    u32 ulData=0;
+    UWORD i;
+
+    (void)InstancePtr;
+    if(Bank>=sizeof(ubBankBase)-1)
+        return 0;
+
+    for(i=ubBankBase[Bank];i<ubBankBase[Bank+1];i++)
+        if(ubHostSimGpioPins[i])
+            ulData|=1ul<<(i-ubBankBase[Bank]);
+
+    return ulData;
+}
+
+//***************************************************************************
+// Simulated global timer
+
+void XTime_GetTime(XTime *Xtime_Global)
+{
+    *Xtime_Global=(XTime)(HostSim_GetTime()*(COUNTS_PER_SECOND/100000ul)/100ul);
+}
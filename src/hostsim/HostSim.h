@@ -0,0 +1,141 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSim.h                                                  */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host-native (x86-64 Linux) execution of the drive core     */
+/*               with simulated FPGA register file, clock and OS            */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_H
+#define _HOSTSIM_H
+
+//***************************************************************************
+// Build configuration
+//
+// The host target is selected by the _HW_HOSTSIM symbol, used together with
+// the usual application symbols (_AXX_SYSAPP, _APP_XC, USE_STDINT_FOR_MISRA_C).
+// The CMake project at the repository root builds it (hostsim\CMakeLists.txt):
+//      src\hostsim\bsp     stand-ins for the Xilinx BSP and FreeRTOS headers
+//      src                 firmware sources
+// Sources are src\common, src\drive, src\bus, src\plc, src\system (but
+// system\Os.c and SysAppStartup.c) and src\hostsim; src\core is not built,
+// as the hardware layer is replaced by the stubs in hostsim\HostSimOs.c,
+// HostSimTimer.c and HostSimHal.c. Backslash includes are resolved by
+// forwarding headers generated at configure time.
+// The build is native 64 bit, but firmware code stores addresses into ULONG:
+// it is linked without PIE, so code, data and heap stay below 4GB, and the
+// FPGA register file, ESC and QSPI linear window are mapped at their Zynq
+// addresses (HostSim_MapMemory()), then xparameters.h base addresses stay
+// compile time constants.
+// The PLC runtime core is delivered as ARM library and its area tables keep
+// addresses as uint32_t: hostsim\HostSimPlc.c replaces them with an empty
+// PLC (no program loaded).
+// With CFG_AMP the second core is a host thread (link with -pthread), so
+// mailboxes and background scheduler partitioning run on two threads.
+//
+// Typical driver:
+//      HostSim_Init(HOSTSIM_CLOCK_HOST);
+//      ... same init task collections as SysAppStartup.c ...
+//      HostSimPlant_DefaultParams(&sHostSimPlantParams);
+//      HostSimPlant_Reset(0.0);
+//      HostSimPlant_Attach();                  closed-loop plant (optional)
+//      Timer_Init(REALTIME_TASK_FREQ, TaskSched_RTScheduler);
+//      HostSim_RunTicks(REALTIME_TASK_FREQ);
+
+#include "common\CommonDefines.h"
+#include "xparameters.h"
+
+//***************************************************************************
+// Configuration
+
+    // simulated FPGA register file size (covers standard, custom app and
+    // CPUH areas)
+#define HOSTSIM_FPGA_REGFILE_SIZE               0x4000      // bytes
+
+    // simulated EtherCAT slave controller address space
+#define HOSTSIM_ESC_SIZE                        0x10000     // bytes
+
+    // simulated free running timer resolution
+#define HOSTSIM_TIMER_TICKS_PER_SECOND          10000000ul  // 100nsec
+#define HOSTSIM_TIMER_TICKS_PER_RTSLOT          (HOSTSIM_TIMER_TICKS_PER_SECOND/REALTIME_TASK_FREQ)
+
+    // simulated time taken by a background read of a free running timer, so
+    // that busy waits elapse as the timer interrupt would run on target
+#define HOSTSIM_TIMER_POLL_TIME                 10          // 100nsec
+
+//***************************************************************************
+// Clock sources
+
+    // deterministic clock: time moves only by the realtime slot period and
+    // by HostSim_Consume(), profilers report the consumed time
+#define HOSTSIM_CLOCK_VIRTUAL                   0
+
+    // host monotonic clock: profilers report the real execution time on the
+    // host, used for the cycle budget benchmarks
+#define HOSTSIM_CLOCK_HOST                      1
+
+//***************************************************************************
+// Structures
+
+    // hook called around each realtime tick (plant models, stimuli, probes)
+typedef void (* HOSTSIM_TICKHOOK)(ULONG);
+
+    // tick statistics
+typedef struct
+{
+    ULONG   ulTicks;                    // executed realtime ticks
+    ULONG   ulOverruns;                 // ticks longer than the slot period
+    UWORD   uwLastTime;                 // last tick time [100nsec]
+    UWORD   uwMaxTime;                  // max tick time [100nsec]
+    ULLNG   ullSumTime;                 // sum of tick times [100nsec]
+} HOSTSIM_STATS;
+
+//***************************************************************************
+// Globals
+
+    // simulated register files, mapped at their Zynq addresses
+#define uwHostSimFpgaRegFile                    ((HPUWORD)(UINTPTR)XPAR_AXI_ADAPTER_0_S00_AXI_BASEADDR)
+#define ubHostSimEsc                            ((HPUBYTE)(UINTPTR)XPAR_AXI_ETHERCAT_0_BASEADDR)
+
+extern UBYTE ubHostSimGpioPins[];
+
+extern HOSTSIM_STATS sHostSimStats;
+
+    // interrupt nesting level, raised around simulated interrupt handlers;
+    // tests raise it to simulate a nested interrupt
+extern volatile ULONG ulHostSimIsrNesting;
+
+//***************************************************************************
+// Prototypes
+
+// Map the simulated address areas (once)
+void HostSim_MapMemory(void);
+
+// Init, reset register file, pins and clock
+void HostSim_Init(UBYTE ubClock);
+
+// Setup the hooks called before (inputs) and after (outputs) each tick
+void HostSim_SetTickHooks(HOSTSIM_TICKHOOK pfPreTick, HOSTSIM_TICKHOOK pfPostTick);
+
+// Run # realtime ticks, return number of overruns
+ULONG HostSim_RunTicks(ULONG ulTicks);
+
+// Clock source selected at init
+UBYTE HostSim_GetClock(void);
+
+// Simulated clock in 100nsec ticks
+ULLNG HostSim_GetTime(void);
+
+// Consume simulated time (HOSTSIM_CLOCK_VIRTUAL only)
+void HostSim_Consume(ULONG ulTime100ns);
+
+// Timer stub interface (hostsim\HostSimTimer.c)
+void HostSimTimer_Fire(void);
+void HostSimTimer_SlotStart(ULLNG ullTime);
+
+#endif
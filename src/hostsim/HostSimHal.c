@@ -0,0 +1,471 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimHal.c                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stubs of the src\core hardware layer:      */
+/*               RAM backed QSPI flash, ADC, GPIO, serial ports, system     */
+/*               reset and second core (host thread)                        */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+#include <pthread.h>
+
+#include "common\CommonDefines.h"
+#include "core\Adc.h"
+#include "core\Cpu1.h"
+#include "core\Flash.h"
+#include "core\Gpio.h"
+#include "core\Interrupt.h"
+#include "core\SerialPorts.h"
+#include "core\SystemReset.h"
+#include "HostSimHal.h"
+
+//***************************************************************************
+// Globals
+
+u32 QspiFlashSize=HOSTSIM_FLASH_SIZE;
+u32 QspiFlashMake=MICRON_ID;
+
+HOSTSIM_FLASH_STATS sHostSimFlashStats;
+
+UWORD uwHostSimFlashTimeScale=100;
+
+ULONG ulHostSimFlashFailCmds;
+ULONG ulHostSimFlashPowerCut;
+
+//***************************************************************************
+// Locals
+
+    // end of the flash command in progress, simulated clock
+static ULLNG ullHostSimFlashReady;
+
+    // error flag of the last commands, cleared by FlashCmdFailed()
+static BOOL bHostSimFlashFailed;
+
+//***************************************************************************
+// Flash
+
+u32 Flash_Init(void)
+{
+    HostSim_MapMemory();
+
+    memset(ubHostSimFlash, 0xFF, HOSTSIM_FLASH_SIZE);
+    memset(&sHostSimFlashStats, 0, sizeof(sHostSimFlashStats));
+    ullHostSimFlashReady=0;
+    bHostSimFlashFailed=FALSE;
+
+    return XST_SUCCESS;
+}
+
+u32 FlashReadID(void)
+{
+    return XST_SUCCESS;
+}
+
+void FlashRead(u32 Address, u8 * hpdata, u32 ByteCount)
+{
+    Address&=HOSTSIM_FLASH_SIZE-1;
+    if(Address+ByteCount>HOSTSIM_FLASH_SIZE)
+        ByteCount=HOSTSIM_FLASH_SIZE-Address;
+
+    memcpy(hpdata, &ubHostSimFlash[Address], ByteCount);
+}
+
+u32 FlashLinearRead(u32 Address, u8 * hpdata, u32 ByteCount)
+{
+    FlashRead(Address, hpdata, ByteCount);
+
+    return XST_SUCCESS;
+}
+
+    // device busy until the end of the command in progress, then polling
+    // loops see realistic program and erase times on the simulated clock
+static void flashbusyfor(ULONG ulTime)
+{
+    ullHostSimFlashReady=HostSim_GetTime()+(ULLNG)ulTime*uwHostSimFlashTimeScale/100;
+}
+
+    // injected failure of the command being started
+static BOOL flashcmdfails(void)
+{
+    if(!ulHostSimFlashFailCmds)
+        return FALSE;
+
+    ulHostSimFlashFailCmds--;
+    sHostSimFlashStats.ulFailedCmds++;
+    bHostSimFlashFailed=TRUE;
+
+    return TRUE;
+}
+
+    // power cut during the command being started, the device stays off
+static BOOL flashcmdcut(void)
+{
+    if(!ulHostSimFlashPowerCut || --ulHostSimFlashPowerCut)
+        return FALSE;
+
+    ulHostSimFlashFailCmds=0xFFFFFFFFul;
+    sHostSimFlashStats.ulFailedCmds++;
+    bHostSimFlashFailed=TRUE;
+
+    return TRUE;
+}
+
+    // page program, data can only clear bits as on the real device and wrap
+    // at the end of the page; data are applied at once, as flash content is
+    // undefined until the device is busy
+void FlashProgramStart(u32 Address, const u8 * hpdata, u32 ByteCount)
+{
+    u32 PageAddress;
+
+    Address&=HOSTSIM_FLASH_SIZE-1;
+    PageAddress=Address&~(PAGE_SIZE-1);
+
+    if(flashcmdfails())
+        ByteCount=0;
+    else if(flashcmdcut())
+        ByteCount/=2;
+
+    while(ByteCount--)
+    {
+        ubHostSimFlash[Address]&=*hpdata++;
+        Address=PageAddress+((Address+1)&(PAGE_SIZE-1));
+    }
+
+    sHostSimFlashStats.ulPagePrograms++;
+    flashbusyfor(HOSTSIM_FLASH_PROGRAM_TIME);
+}
+
+void FlashEraseStart(u32 Address, u32 EraseSize)
+{
+    if(flashcmdfails())
+    {
+        flashbusyfor(HOSTSIM_FLASH_SUBERASE_TIME);
+        return;
+    }
+
+    if(flashcmdcut())
+    {
+        Address&=(HOSTSIM_FLASH_SIZE-1)&~(EraseSize-1);
+        memset(&ubHostSimFlash[Address], 0xFF, EraseSize/2);
+        flashbusyfor(HOSTSIM_FLASH_SUBERASE_TIME);
+        return;
+    }
+
+    if(EraseSize==NUM_SECTORS*SECTOR_SIZE)
+    {
+        memset(ubHostSimFlash, 0xFF, HOSTSIM_FLASH_SIZE);
+        sHostSimFlashStats.ulSectorErases+=HOSTSIM_FLASH_SIZE/SECTOR_SIZE;
+        flashbusyfor(HOSTSIM_FLASH_BULKERASE_TIME);
+        return;
+    }
+
+    Address&=(HOSTSIM_FLASH_SIZE-1)&~(EraseSize-1);
+    memset(&ubHostSimFlash[Address], 0xFF, EraseSize);
+    sHostSimFlashStats.ulSectorErases++;
+    flashbusyfor(EraseSize>SUBSECTOR_SIZE ? HOSTSIM_FLASH_ERASE_TIME : HOSTSIM_FLASH_SUBERASE_TIME);
+}
+
+    // each status read takes time, so polling loops move the virtual clock
+u32 FlashBusy(void)
+{
+    HostSim_Consume(HOSTSIM_FLASH_STATUS_TIME);
+    sHostSimFlashStats.ulStatusReads++;
+
+    if(HostSim_GetTime()<ullHostSimFlashReady)
+    {
+        sHostSimFlashStats.ulBusyStatusReads++;
+        return 1;
+    }
+
+    return 0;
+}
+
+    // sticky error flag, read and clear
+u32 FlashCmdFailed(void)
+{
+    BOOL bFailed=bHostSimFlashFailed;
+
+    HostSim_Consume(HOSTSIM_FLASH_STATUS_TIME);
+    bHostSimFlashFailed=FALSE;
+
+    return bFailed ? 1 : 0;
+}
+
+    // busy waiting, as core\Flash.c
+void FlashWrite(u32 Address, u8 * hpdata, u32 ByteCount)
+{
+    u32 WriteSize;
+
+    while(ByteCount>0)
+    {
+        WriteSize=PAGE_SIZE-(Address&(PAGE_SIZE-1));
+        if(WriteSize>ByteCount)
+            WriteSize=ByteCount;
+
+        FlashProgramStart(Address, hpdata, WriteSize);
+        while(FlashBusy());
+
+        hpdata+=WriteSize;
+        Address+=WriteSize;
+        ByteCount-=WriteSize;
+    }
+}
+
+    // same granularity as core\Flash.c: sub-sector if size fits one
+    // sub-sector, otherwise whole sectors
+void FlashErase(u32 Address, u32 ByteCount)
+{
+    u32 ulSectors;
+
+    if(ByteCount==0)
+        return;
+
+    if(ByteCount==NUM_SECTORS*SECTOR_SIZE)
+    {
+        FlashEraseStart(Address, ByteCount);
+        while(FlashBusy());
+        return;
+    }
+
+    for(ulSectors=(ByteCount-1)/SECTOR_SIZE+1;ulSectors>0;ulSectors--)
+    {
+        FlashEraseStart(Address, ByteCount>SUBSECTOR_SIZE ? SECTOR_SIZE : SUBSECTOR_SIZE);
+        while(FlashBusy());
+        Address+=SECTOR_SIZE;
+    }
+}
+
+u32 FlashErasedCheck( void * addr, u32 len )
+{
+    u8 * ptr=(u8 *)addr;
+
+    while(len--)
+        if((*ptr++) != 0xFF)
+            return 1;
+
+    return 0;
+}
+
+//***************************************************************************
+// Gpio, levels are in ubHostSimGpioPins[]
+
+u32 Gpio_Init(void)
+{
+    return XST_SUCCESS;
+}
+
+void Gpio_SetMode(u32 Pin, u32 Direction)
+{
+    (void)Pin;
+    (void)Direction;
+}
+
+void Gpio_Write(u8 Bank, u32 Mask, u32 Data)
+{
+    static const UBYTE ubBankBase[]={MIO_BANK0_BASE, MIO_BANK1_BASE, MIO_BANK2_BASE, MIO_BANK3_BASE};
+    UWORD i;
+
+    if(Bank>=sizeof(ubBankBase))
+        return;
+
+    for(i=0;i<32 && ubBankBase[Bank]+i<XGPIOPS_MAX_PINS;i++)
+        if(Mask&(1ul<<i))
+            ubHostSimGpioPins[ubBankBase[Bank]+i]=(Data&(1ul<<i))!=0;
+}
+
+//***************************************************************************
+// Interrupt controller
+
+void Intr_Init(void)
+{
+    xInterruptController.IsReady=XIL_COMPONENT_IS_READY;
+}
+
+//***************************************************************************
+// Adc, nominal supply readings
+
+u32 Adc_Init(void)
+{
+    return XST_SUCCESS;
+}
+
+UWORD Adc_GetVPVNData(void)
+{
+    return 0;
+}
+
+UWORD Adc_GetAuxData(UBYTE ubChnId)
+{
+    (void)ubChnId;
+    return 0;
+}
+
+FLOAT Adc_GetOnChipTemperature(void)
+{
+    return 40.0f;
+}
+
+FLOAT Adc_GetVccPint(void)
+{
+    return 1.0f;
+}
+
+FLOAT Adc_GetVccPaux(void)
+{
+    return 1.8f;
+}
+
+FLOAT Adc_GetVccPdro(void)
+{
+    return 1.0f;
+}
+
+//***************************************************************************
+// Serial ports, no line connected: nothing received, everything sent
+
+SWORD SerialPortsInit( void )
+{
+    return 0;
+}
+
+SWORD SerialPortOpen( UWORD uwPortNumber, ULONG ulBaudRate, UWORD uwDataBits, UWORD uwParityMode, UWORD uwStopBits, UWORD uwPortMode, UWORD uwWriteDelay, SERIAL_PORT_CALLBACK pfnRxCallback, SERIAL_PORT_CALLBACK pfnTxCallback )
+{
+    (void)uwPortNumber; (void)ulBaudRate; (void)uwDataBits; (void)uwParityMode; (void)uwStopBits;
+    (void)uwPortMode; (void)uwWriteDelay; (void)pfnRxCallback; (void)pfnTxCallback;
+    return 0;
+}
+
+void SerialPortReceiverOn( UWORD uwPortNumber )
+{
+    (void)uwPortNumber;
+}
+
+void SerialPortReceiverOff( UWORD uwPortNumber )
+{
+    (void)uwPortNumber;
+}
+
+SWORD SerialPortRxStatus( UWORD uwPortNumber )
+{
+    (void)uwPortNumber;
+    return 0;
+}
+
+SWORD SerialPortRxFlush( UWORD uwPortNumber )
+{
+    (void)uwPortNumber;
+    return 0;
+}
+
+SWORD SerialPortRead( UWORD uwPortNumber, HPUBYTE hpubBuffer, UWORD uwLength )
+{
+    (void)uwPortNumber; (void)hpubBuffer; (void)uwLength;
+    return 0;
+}
+
+SWORD SerialPortWrite( UWORD uwPortNumber, HPUBYTE hpubuffer, UWORD uwLength, UWORD uwBuffering )
+{
+    (void)uwPortNumber; (void)hpubuffer; (void)uwBuffering;
+    return (SWORD)uwLength;
+}
+
+SWORD SerialPortClose( UWORD uwPortNumber )
+{
+    (void)uwPortNumber;
+    return 0;
+}
+
+void SerialPortForce422485( BOOL bForce )
+{
+    (void)bForce;
+}
+
+void * SerialPortGetTimingSetup( ULONG ulBaudRate )
+{
+    (void)ulBaudRate;
+    return NULL;
+}
+
+//***************************************************************************
+// System reset, recorded for the test driver
+
+UWORD uwHostSimResetCount;
+
+    // reset parameters kept across a reset
+volatile UWORD uwSysResParam0;
+volatile UWORD uwSysResParam1;
+
+void SysRes_Recovery(void)
+{
+}
+
+void SysRes_ExecuteReset(UWORD uwPar0, UWORD uwPar1)
+{
+    uwSysResParam0=uwPar0;
+    uwSysResParam1=uwPar1;
+    uwHostSimResetCount++;
+}
+
+void SysRes_ModifyMultiBoot(ULONG ulAddrOffset)
+{
+    (void)ulAddrOffset;
+}
+
+UBYTE SysRes_RebootReason(void)
+{
+    return 0;
+}
+
+void SysRes_RebootStateSet(UBYTE ubMark)
+{
+    (void)ubMark;
+}
+
+UBYTE SysRes_RebootStateGet(void)
+{
+    return 0;
+}
+
+void SysRes_RebootPorClr(void)
+{
+}
+
+void resetsystemrecovery(UWORD uwPar0, UWORD uwPar1)
+{
+    SysRes_ExecuteReset(uwPar0, uwPar1);
+}
+
+void resetpoweronreset(void)
+{
+    uwHostSimResetCount++;
+}
+
+//***************************************************************************
+// Second core, a host thread running the entry point
+
+static pthread_t sHostSimCpu1Thread;
+static volatile BOOL bHostSimCpu1Started;
+
+static void * cpu1thread(void * pvMain)
+{
+    (*(void (*)(void))pvMain)();
+
+    return NULL;
+}
+
+void Cpu1_Start(void (* pfMain)(void))
+{
+    bHostSimCpu1Started=TRUE;
+    (void)pthread_create(&sHostSimCpu1Thread, NULL, &cpu1thread, (void *)pfMain);
+}
+
+BOOL Cpu1_IsStarted(void)
+{
+    return bHostSimCpu1Started;
+}
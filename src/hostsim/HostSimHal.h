@@ -0,0 +1,68 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimHal.h                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stubs of the src\core hardware layer       */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIMHAL_H
+#define _HOSTSIMHAL_H
+
+#include "common\CommonDefines.h"
+#include "core\Flash.h"
+#include "HostSim.h"
+
+//***************************************************************************
+// Configuration
+
+#define HOSTSIM_FLASH_SIZE                      FLASH_SIZE_128M     // 16MB, whole layout of SysAppZYNQ.lin
+
+    // device busy times, typical datasheet values [100nsec]
+#define HOSTSIM_FLASH_PROGRAM_TIME              5000ul          // page program, 0.5ms
+#define HOSTSIM_FLASH_SUBERASE_TIME             2500000ul       // 4KB sub-sector erase, 0.25s
+#define HOSTSIM_FLASH_ERASE_TIME                7000000ul       // 64KB sector erase, 0.7s
+#define HOSTSIM_FLASH_BULKERASE_TIME            1700000000ul    // bulk erase, 170s
+#define HOSTSIM_FLASH_STATUS_TIME               10ul            // status register read, 1usec
+
+//***************************************************************************
+// Structures
+
+    // flash wear and activity counters
+typedef struct
+{
+    ULONG   ulPagePrograms;
+    ULONG   ulSectorErases;
+    ULONG   ulStatusReads;              // status register reads
+    ULONG   ulBusyStatusReads;          // of which with device busy
+    ULONG   ulFailedCmds;               // program or erase commands failed
+} HOSTSIM_FLASH_STATS;
+
+//***************************************************************************
+// Globals
+
+    // RAM backed flash image, mapped on the QSPI linear window, NOR
+    // semantic: erase sets to 0xFF, program can only clear bits
+#define ubHostSimFlash                          ((HPUBYTE)(UINTPTR)XPS_QSPI_LINEAR_BASEADDR)
+
+extern HOSTSIM_FLASH_STATS sHostSimFlashStats;
+
+    // busy times scale, percent of the typical values (0 completes at once)
+extern UWORD uwHostSimFlashTimeScale;
+
+    // fault injection: no. of next program or erase commands failing, they
+    // leave the flash content unchanged and set the error flag
+extern ULONG ulHostSimFlashFailCmds;
+
+    // power cut: if not zero, the Nth next program or erase command is
+    // interrupted (a page program clears only the first half of its data,
+    // an erase sets only the first half of its range), then all the next
+    // ones fail as with ulHostSimFlashFailCmds
+extern ULONG ulHostSimFlashPowerCut;
+extern UWORD uwHostSimResetCount;
+
+#endif
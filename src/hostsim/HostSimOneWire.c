@@ -0,0 +1,292 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimOneWire.c                                           */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation 1-Wire buses: virtual identification       */
+/*               chips replacing drive\OneWireHandler.c                     */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\BlockStorage.h"
+#include "drive\HardwareParameters.h"
+#include "drive\OneWireHandler.h"
+#include "fpga\FpgaHandler.h"
+#include "system\SysAppDataCodes.h"
+#include "HostSimOneWire.h"
+
+//***************************************************************************
+// Defines
+
+    // serial number of the device on each bus, ROM code is family, serial
+    // (6 bytes, little endian) and crc8
+#define ONEWIRE_SERIAL_BASE         0x00000A5A0000ul
+
+    // default drive: full scale of current [A peak] and DC bus [V] A/D
+#define ONEWIRE_DEF_CURRENT_FS      40.0
+#define ONEWIRE_DEF_DCBUS_FS        1000.0
+
+//***************************************************************************
+// Structures
+
+typedef struct
+{
+    BOOL    bPresent;
+    UBYTE   ubRomNo[8];
+    UWORD   uwUsed;                     // bytes of memory holding blocks
+    UBYTE   ubMemory[OW_DS2433_DATA_LENGTH];
+} HOSTSIM_OW_DEVICE;
+
+//***************************************************************************
+// Locals
+
+static HOSTSIM_OW_DEVICE sOwDevice[OW_MAX_BUS_SEGMENTS];
+
+//***************************************************************************
+// Dallas crc8 (x^8+x^5+x^4+1, reflected)
+
+static UBYTE crc8(const UBYTE * pubData, int iLength)
+{
+    UBYTE ubCrc=0;
+    int i,j;
+
+    for(i=0;i<iLength;i++)
+    {
+        ubCrc^=pubData[i];
+        for(j=0;j<8;j++)
+            ubCrc=(ubCrc&1) ? (UBYTE)((ubCrc>>1)^0x8C) : (UBYTE)(ubCrc>>1);
+    }
+
+    return ubCrc;
+}
+
+//***************************************************************************
+// Device lookup
+
+static HOSTSIM_OW_DEVICE * getdevice(int bus)
+{
+    if(bus<0 || bus>=OW_MAX_BUS_SEGMENTS || !sOwDevice[bus].bPresent)
+        return NULL;
+
+    return &sOwDevice[bus];
+}
+
+//***************************************************************************
+// Setup
+
+void HostSimOneWire_Clear(void)
+{
+    memset(sOwDevice,0,sizeof(sOwDevice));
+}
+
+BOOL HostSimOneWire_AddBlock(int bus, SWORD swCode, const void * pvData, UWORD uwSize)
+{
+    HOSTSIM_OW_DEVICE * psDev;
+    BLKSTOR_HEADER sHeader;
+    ULONG ulSerial;
+    int i;
+
+    if(bus<0 || bus>=OW_MAX_BUS_SEGMENTS)
+        return FALSE;
+
+    psDev=&sOwDevice[bus];
+
+        // blocks are searched on word boundaries, keep next one aligned
+    if((ULONG)psDev->uwUsed+sizeof(sHeader)+((uwSize+1u)&~1u)>sizeof(psDev->ubMemory))
+        return FALSE;
+
+    if(blkstor_createheader(swCode,(volatile void *)pvData,uwSize,&sHeader)<0)
+        return FALSE;
+
+    if(!psDev->bPresent)
+    {
+        ulSerial=ONEWIRE_SERIAL_BASE+(ULONG)bus;
+
+        psDev->ubRomNo[0]=OW_DS2433_FAMILY_CODE;
+        for(i=1;i<7;i++)
+            psDev->ubRomNo[i]=(UBYTE)(ulSerial>>(8*(i-1)));
+        psDev->ubRomNo[7]=crc8(psDev->ubRomNo,7);
+
+        psDev->bPresent=TRUE;
+    }
+
+    memcpy(&psDev->ubMemory[psDev->uwUsed],&sHeader,sizeof(sHeader));
+    memcpy(&psDev->ubMemory[psDev->uwUsed+sizeof(sHeader)],pvData,uwSize);
+    psDev->uwUsed+=(UWORD)(sizeof(sHeader)+((uwSize+1u)&~1u));
+
+    return TRUE;
+}
+
+void HostSimOneWire_DefaultDrive(void)
+{
+    HWPRM_CNTRL_BOARD sCtrl;
+    HWPRM_POWER_BOARD_AXM_AXP_AC_V2 sPwr;
+
+    HostSimOneWire_Clear();
+
+        // control board, rev 6.00, unity calibration on all channels
+    memset(&sCtrl,0,sizeof(sCtrl));
+    sCtrl.sProductInfo.uwProductCode=HWPRM_PCODE_CONTROL_BOARD_AXM_II_ZYNQ;
+    sCtrl.sProductInfo.uwProductRev=600;
+    sCtrl.sCurrentPhaseU.uwOffst=FPGA_ADCDEF_GENERIC_OFF;
+    sCtrl.sCurrentPhaseU.swScale=FPGA_ADCDEF_GENERIC_MUL;
+    sCtrl.sCurrentPhaseV=sCtrl.sCurrentPhaseU;
+    sCtrl.sVoltageDcLink=sCtrl.sCurrentPhaseU;
+    sCtrl.uwHwConfig=HWPRM_CTRLBRD_HWCONFIG_FULL;
+
+    HostSimOneWire_AddBlock(OW_INTERNAL_BUS,DATACODE_HW_CNTRL_BOARD,&sCtrl,sizeof(sCtrl));
+
+        // AxM AC power board, rev 1.00, standard U-V-W bridge with U and V
+        // current sensors, 2usec deadtime
+    memset(&sPwr,0,sizeof(sPwr));
+    sPwr.sProductInfo.uwProductCode=HWPRM_PCODE_POWER_BOARD_AXM_AC;
+    sPwr.sProductInfo.uwProductRev=100;
+
+    sPwr.sBridgeParams.sBridgeCurrentLayout.sBridge.ubPhaseU=1;
+    sPwr.sBridgeParams.sBridgeCurrentLayout.sBridge.ubPhaseV=2;
+    sPwr.sBridgeParams.sBridgeCurrentLayout.sBridge.ubPhaseW=3;
+    sPwr.sBridgeParams.sBridgeCurrentLayout.sCurrent.ubCurrentU=1;
+    sPwr.sBridgeParams.sBridgeCurrentLayout.sCurrent.ubCurrentV=2;
+    sPwr.sBridgeParams.uwSwitchDeadTime=200;
+
+    sPwr.sBridgeParams.sOperativeLimits.slOverCurrent=300000;
+    sPwr.sBridgeParams.sOperativeLimits.slCurrentLimit=200000;
+    sPwr.sBridgeParams.sOperativeLimits.swOverVoltage=8000;
+
+    sPwr.sBridgeParams.sThermalModel.uwModuleMaxTJunction=150;
+    sPwr.sBridgeParams.sThermalModel.uwNtc2JunctionThResist=1;
+    sPwr.sBridgeParams.sThermalModel.uwHsnk2NtcThResCoolingON=1;
+    sPwr.sBridgeParams.sThermalModel.uwHsnk2NtcThResCoolingOFF=2;
+    sPwr.sBridgeParams.sThermalModel.uwIgbtVceSat=2;
+    sPwr.sBridgeParams.sThermalModel.uwNtcVDividerResistor=10000;
+    sPwr.sBridgeParams.sThermalModel.uwNtc25DegreeResistance=5000;
+    sPwr.sBridgeParams.sThermalModel.uwNtcMaterialConstant=3375;
+    sPwr.sBridgeParams.sThermalModel.uwIgbtThCapacitance=1;
+    sPwr.sBridgeParams.sThermalModel.uwHsnkThCapacitance=100;
+    sPwr.sBridgeParams.sThermalModel.uwCommutationLosses=1;
+    sPwr.sBridgeParams.sThermalModel.uwIValueLosses=20;
+    sPwr.sBridgeParams.sThermalModel.uwIgbtMaximumTemp=125;
+    sPwr.sBridgeParams.sThermalModel.uwHsnkMaximumTemp=90;
+    sPwr.sBridgeParams.uwTempSensorType=HWPRM_POWER_BOARD_TEMPSENSOR_NTC;
+    sPwr.sBridgeParams.sTempSensorCalibr.uwOffst=FPGA_ADCDEF_GENERIC_OFF;
+    sPwr.sBridgeParams.sTempSensorCalibr.swScale=FPGA_ADCDEF_GENERIC_MUL;
+
+    sPwr.sVoltageDcLink.swScale=FPGA_ADCDEF_GENERIC_MUL;
+    sPwr.sCurrentPhaseU.uwOffst=FPGA_ADCDEF_GENERIC_OFF;
+    sPwr.sCurrentPhaseU.swScale=FPGA_ADCDEF_GENERIC_MUL;
+    sPwr.sCurrentPhaseV=sPwr.sCurrentPhaseU;
+
+        // 70 Ohm 100W brake resistor
+    sPwr.sBrakeCircuit.uwResistorValue=700;
+    sPwr.sBrakeCircuit.uwResistorPower=1000;
+    sPwr.sBrakeCircuit.ulRBrakeMaxEnergy=1000;
+
+    sPwr.uwCoolingType=HWPRM_POWER_BOARD_COOLING_FAN_2WIRE;
+
+        // [1e-4A] and [1e-1V] per A/D unit
+    sPwr.flCurrentScale=(FLOAT)(ONEWIRE_DEF_CURRENT_FS*10000.0/32768.0);
+    sPwr.flDCVoltageScale=(FLOAT)(ONEWIRE_DEF_DCBUS_FS*10.0/32768.0);
+
+    HostSimOneWire_AddBlock(OW_EXTERNAL_BUS,DATACODE_HW_POWER_BOARD_AXM_AXP_AC_V2,&sPwr,sizeof(sPwr));
+}
+
+//***************************************************************************
+// drive\OneWireHandler.h
+
+int OWHandlerInit( void )
+{
+    return 0;
+}
+
+int OWReset( int bus )
+{
+    return getdevice(bus)!=NULL;
+}
+
+void OWWriteBit( int bus, int val )
+{
+}
+
+int OWReadBit( int bus )
+{
+        // pulled-up idle line
+    return 1;
+}
+
+void OWWriteByte( int bus, int data )
+{
+}
+
+int OWReadByte( int bus )
+{
+    return 0xFF;
+}
+
+int OWTouchByte( int bus, int data )
+{
+    return 0xFF;
+}
+
+void OWBlock( int bus, unsigned char * data, int length, void (* yield)(void) )
+{
+    memset(data,0xFF,length);
+}
+
+    // one device per bus: the search state just records that the device
+    // was already returned
+int OWSearchFirst( int bus, OW_SEARCH_STATE  * state, void (* yield)(void) )
+{
+    state->LastDiscrepancy=0;
+    state->LastFamilyDiscrepancy=0;
+    state->LastDeviceFlag=FALSE;
+
+    return OWSearchNext(bus,state,yield);
+}
+
+int OWSearchNext( int bus, OW_SEARCH_STATE  * state, void (* yield)(void) )
+{
+    HOSTSIM_OW_DEVICE * psDev=getdevice(bus);
+
+    if(psDev==NULL || state->LastDeviceFlag)
+    {
+        state->LastDiscrepancy=0;
+        state->LastFamilyDiscrepancy=0;
+        state->LastDeviceFlag=FALSE;
+        return FALSE;
+    }
+
+    memcpy(state->ROM_NO,psDev->ubRomNo,sizeof(state->ROM_NO));
+    state->crc8=0;
+    state->LastDeviceFlag=TRUE;
+
+    if(yield)
+        (*yield)();
+
+    return TRUE;
+}
+
+int OWReadMemory( int bus, unsigned char * romno, unsigned char * buffer, int length, void (* yield)(void) )
+{
+    HOSTSIM_OW_DEVICE * psDev=getdevice(bus);
+
+    if(psDev==NULL || memcmp(romno,psDev->ubRomNo,sizeof(psDev->ubRomNo))!=0)
+        return FALSE;
+
+    if(length>OW_DS2433_DATA_LENGTH)
+        length=OW_DS2433_DATA_LENGTH;
+
+        // unprogrammed EEPROM reads as 0xFF
+    memset(buffer,0xFF,length);
+    memcpy(buffer,psDev->ubMemory,psDev->uwUsed<length ? psDev->uwUsed : length);
+
+    if(yield)
+        (*yield)();
+
+    return TRUE;
+}
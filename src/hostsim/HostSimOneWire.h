@@ -0,0 +1,44 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimOneWire.h                                           */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation 1-Wire buses: virtual identification       */
+/*               chips replacing drive\OneWireHandler.c                     */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIMONEWIRE_H
+#define _HOSTSIMONEWIRE_H
+
+//***************************************************************************
+// Model
+//
+// Each bus carries at most one DS2433 (family 0x23, 512 bytes) whose memory
+// is an image of block storage records, as written by the production
+// programming station: the drive\HardwareConfig.c scan is the real one.
+// The bit level functions see an idle bus, search and read memory work on
+// the device list; no GPIO is touched.
+
+#include "common\CommonDefines.h"
+#include "drive\OneWireHandler.h"
+
+//***************************************************************************
+// Prototypes
+
+// Remove all virtual devices, every bus answers with no presence
+void HostSimOneWire_Clear(void);
+
+// Append a data block to the device of bus, the device is created with the
+// first block; FALSE if bus is invalid or the memory is full
+BOOL HostSimOneWire_AddBlock(int bus, SWORD swCode, const void * pvData, UWORD uwSize);
+
+// Identity of a commissioned drive: Zynq control board on the internal bus,
+// AxM AC power board (version 2 block) on the external one. To be called
+// before HwConfGetAndCheck
+void HostSimOneWire_DefaultDrive(void);
+
+#endif
@@ -0,0 +1,323 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimOs.c                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stub of system\Os.c: the simulation        */
+/*               driver owns the only thread, mutexes and queues are        */
+/*               plain memory objects, critical sections are empty          */
+/*                                                                          */
+/****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "system\Os.h"
+#include "HostSim.h"
+
+//***************************************************************************
+// Kernel objects
+
+struct tagHOSTSIM_TASK
+{
+    void (* pEntryPoint)(void);
+    const char * pName;
+    BOOL bSuspended;
+};
+
+struct tagHOSTSIM_QUEUE
+{
+    UWORD uwIn,uwOut;
+    UWORD uwSize;
+    UWORD uwItemSize;
+    UBYTE * pubElements;
+};
+
+//***************************************************************************
+// Globals
+
+volatile UWORD uwOsFreeRunTimer1kHz;
+volatile ULONG ulOsTimer1Hz;
+
+volatile ULONG ulHostSimIsrNesting;
+
+#if (OS_MEASURESTACKSIZE)
+UWORD uwOsSysStackFree;
+UWORD uwOsUsrStackFree;
+
+UWORD uwOsMinStackFreePerTask[OS_MAXTASKSALLOWED];
+#endif
+
+//***************************************************************************
+// Locals
+
+#define ISTASKHANDLERVALID(handle)          ((handle)<OS_MAXTASKSALLOWED && sTasks[handle].pEntryPoint)
+
+static struct tagHOSTSIM_TASK sTasks[OS_MAXTASKSALLOWED];
+
+static UWORD uwCritSectCounter;
+
+//***************************************************************************
+// Os initialization, to be called before any other Os function
+
+BOOL Os_Init(void)
+{
+    memset(sTasks, 0, sizeof(sTasks));
+    uwCritSectCounter=0;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Task creation, tasks are only recorded as the simulation driver runs the
+// realtime ticks in the caller thread
+
+OS_TASKHANDLE Os_TaskCreate(void (*pTaskPointer)(void))
+{
+    return Os_TaskCreateEx(pTaskPointer,OS_DEFAULTUSRSTATICSTACK,NULL);
+}
+
+OS_TASKHANDLE Os_TaskCreateEx(void (*pTaskPointer)(void), UWORD uwResUsrStack, const char * const pTaskName)
+{
+    UWORD uwHandle;
+
+    (void)uwResUsrStack;
+
+    for(uwHandle=0;uwHandle<OS_MAXTASKSALLOWED;uwHandle++)
+        if(sTasks[uwHandle].pEntryPoint==NULL)
+        {
+            sTasks[uwHandle].pEntryPoint=pTaskPointer;
+            sTasks[uwHandle].pName=pTaskName;
+            sTasks[uwHandle].bSuspended=FALSE;
+
+            return (OS_TASKHANDLE)uwHandle;
+        }
+
+    return 0;
+}
+
+//***************************************************************************
+// 1kHz tick, to be called by the simulation driver every 1msec
+
+void vApplicationTickHook( void )
+{
+    static int count=0;
+
+    if(count == configTICK_RATE_HZ-1)
+    {
+        count = 0;
+        ulOsTimer1Hz++;
+    }
+    else
+        count++;
+
+    uwOsFreeRunTimer1kHz++;
+}
+
+//***************************************************************************
+// Task resume and suspend
+
+BOOL Os_TaskResume(OS_TASKHANDLE hTask)
+{
+    if(!ISTASKHANDLERVALID(hTask))
+        return FALSE;
+
+    sTasks[hTask].bSuspended=FALSE;
+    return TRUE;
+}
+
+BOOL Os_TaskSuspend(OS_TASKHANDLE hTask)
+{
+    if(!ISTASKHANDLERVALID(hTask))
+        return FALSE;
+
+    sTasks[hTask].bSuspended=TRUE;
+    return TRUE;
+}
+
+//***************************************************************************
+// Task event notification, nothing to wake up
+
+BOOL Os_TaskEventNotify(OS_TASKHANDLE TaskHandle)
+{
+    return ISTASKHANDLERVALID(TaskHandle);
+}
+
+void Os_TaskEventNotifyWait(void)
+{
+}
+
+//***************************************************************************
+// Sleep, no other task to switch to
+
+void Os_Sleep(UWORD uwMilliSeconds)
+{
+    (void)uwMilliSeconds;
+}
+
+//***************************************************************************
+// Mutex management, a single thread can always take a free mutex, a taken
+// one will never be released while waiting then timeout
+
+SWORD Os_MutexWait(OS_MUTEX * psMutex, UWORD uwMilliSeconds)
+{
+    (void)uwMilliSeconds;
+
+    if(*psMutex==NULL || (*psMutex)->uwIn)
+        return OS_MUTEXWAIT_TIMEOUT;
+
+    (*psMutex)->uwIn=1;
+    return OS_MUTEXWAIT_SIGNALED;
+}
+
+BOOL Os_MutexSignal(OS_MUTEX * psMutex)
+{
+    if(*psMutex==NULL || !(*psMutex)->uwIn)
+        return FALSE;
+
+    (*psMutex)->uwIn=0;
+    return TRUE;
+}
+
+//***************************************************************************
+// Post a message on the queue
+
+BOOL Os_QueuePost(OS_QUEUE sQueue, HPULONG pulInMessage)
+{
+    UWORD uwNextPos;
+
+    if(sQueue==NULL)
+        return FALSE;
+
+    uwNextPos=sQueue->uwIn+1;
+    if(uwNextPos>=sQueue->uwSize)
+        uwNextPos=0;
+
+        // if next In position equal actual Out position, queue is full
+    if(uwNextPos==sQueue->uwOut)
+        return FALSE;
+
+    memcpy(&sQueue->pubElements[(ULONG)sQueue->uwIn*sQueue->uwItemSize], pulInMessage, sQueue->uwItemSize);
+    sQueue->uwIn=uwNextPos;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Get a message from the queue, never waits
+
+SWORD Os_QueueGet(OS_QUEUE sQueue, HPULONG pulOutMessage, UWORD uwMilliSeconds)
+{
+    UWORD uwNextPos;
+
+    (void)uwMilliSeconds;
+
+    if(sQueue==NULL || sQueue->uwOut==sQueue->uwIn)
+        return FALSE;
+
+    memcpy(pulOutMessage, &sQueue->pubElements[(ULONG)sQueue->uwOut*sQueue->uwItemSize], sQueue->uwItemSize);
+
+    uwNextPos=sQueue->uwOut+1;
+    if(uwNextPos>=sQueue->uwSize)
+        uwNextPos=0;
+    sQueue->uwOut=uwNextPos;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Get status of the queue, return immediately
+
+SWORD Os_QueueStatus(OS_QUEUE Queue)
+{
+    if(Queue==NULL || Queue->uwOut==Queue->uwIn)
+        return OS_QUEUESTATUS_EMPTY;
+    else
+        return OS_QUEUESTATUS_VALID;
+}
+
+//***************************************************************************
+// Critical sections, only nesting is tracked
+
+void Os_BeginCriticalSection(UWORD uwType)
+{
+    (void)uwType;
+    uwCritSectCounter++;
+}
+
+void Os_EndCriticalSection(UWORD uwType)
+{
+    (void)uwType;
+    if(uwCritSectCounter)
+        uwCritSectCounter--;
+}
+
+//***************************************************************************
+// Check current runnning level
+
+BOOL Os_IsInBackground(void)
+{
+    return TRUE;
+}
+
+//***************************************************************************
+// Interrupt nesting level, as FreeRTOS port counter
+
+UWORD Os_IsrNesting(void)
+{
+    return (UWORD)ulHostSimIsrNesting;
+}
+
+//***************************************************************************
+// No scheduler, single thread: waiting loops must serve themselves
+
+BOOL Os_IsSchedulerRunning(void)
+{
+    return FALSE;
+}
+
+//***************************************************************************
+// FreeRTOS subset used outside Os.c
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    (void)xTicksToDelay;
+}
+
+void vTaskStartScheduler(void)
+{
+}
+
+void vPortInstallFreeRTOSVectorTable(void)
+{
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return (SemaphoreHandle_t)calloc(1, sizeof(struct tagHOSTSIM_QUEUE));
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+    struct tagHOSTSIM_QUEUE * psQueue;
+
+    psQueue=(struct tagHOSTSIM_QUEUE *)calloc(1, sizeof(struct tagHOSTSIM_QUEUE));
+    if(psQueue==NULL)
+        return NULL;
+
+        // one more element, full is detected as next In equal to Out
+    psQueue->uwSize=(UWORD)uxQueueLength+1;
+    psQueue->uwItemSize=(UWORD)uxItemSize;
+    psQueue->pubElements=(UBYTE *)calloc(psQueue->uwSize, uxItemSize);
+    if(psQueue->pubElements==NULL)
+    {
+        free(psQueue);
+        return NULL;
+    }
+
+    return psQueue;
+}
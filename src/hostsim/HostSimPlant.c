@@ -0,0 +1,360 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimPlant.c                                             */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation closed-loop plant: PMSM, DC bus, mechanics, */
+/*               encoder and FPGA current loop                              */
+/*                                                                          */
+/****************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "drive\AxM-E-Defines.h"
+#include "drive\MotorParameters.h"
+#include "drive\MotorHandler.h"
+#include "drive\MotorHandlerRT.h"
+#include "drive\EncoderManager.h"
+#include "drive\IncrementalEncoder.h"
+#include "fpga\FpgaHandler.h"
+#include "fpga\FpgaIRegs.h"
+#include "fpga\AnProcessor.h"
+#include "HostSim.h"
+#include "HostSimPlant.h"
+
+//***************************************************************************
+// Defines
+
+#define PLANT_TWOPI                 (2.0*3.14159265358979323846)
+#define PLANT_ANGLE2RAD             (PLANT_TWOPI/65536.0)
+#define PLANT_SQRT2                 1.4142135623730950488
+#define PLANT_SQRT3                 1.7320508075688772935
+#define PLANT_SQRT6                 2.4494897427831780982
+
+    // firmware internal units: current [1e-4 Arms], voltage [0.1V]
+#define PLANT_IU_PER_AMPERE         10000.0
+#define PLANT_IU_PER_VOLT           10.0
+
+    // below this speed coulomb friction may stick the rotor [rad/sec]
+#define PLANT_STICTION_SPEED        1e-3
+
+    // access to RGURAM, read counterpart of FPGA_CPUH_URAM_WR_SW
+#define PLANT_URAM_RD_SW(a)         (((HPSWORD)(((a)<<3)+FPGA_CPUH_URAM_BASE+RGAD_CPUH_RGURAM_SIZE/2))[1])
+
+//***************************************************************************
+// Globals
+
+HOSTSIM_PLANT_PARAMS sHostSimPlantParams;
+HOSTSIM_PLANT_STATE  sHostSimPlant;
+
+//***************************************************************************
+// Locals
+
+    // firmware frame (electrical angle written to SCGEN) at end of last step
+static DOUBL dbPlantCtrlAngle;
+    // firmware frame voltage references [Vrms]
+static DOUBL dbPlantCtrlVd;
+static DOUBL dbPlantCtrlVq;
+
+//***************************************************************************
+// Rotate dq vector by angle
+
+static void rotate(DOUBL dbAngle, DOUBL * pdbD, DOUBL * pdbQ)
+{
+    DOUBL dbC=cos(dbAngle);
+    DOUBL dbS=sin(dbAngle);
+    DOUBL dbD=*pdbD;
+
+    *pdbD=dbD*dbC-*pdbQ*dbS;
+    *pdbQ=dbD*dbS+*pdbQ*dbC;
+}
+
+//***************************************************************************
+// Write value to the analog processor external buffer slot of a destination,
+// as done by the FPGA scaler
+
+static void extwrite(UBYTE ubTag, DOUBL dbValue)
+{
+    UWORD uwSlot;
+    BOOL  bLong;
+    SLONG slValue;
+
+    if(!AnProc_GetExtSlot(ubTag, &uwSlot, &bLong))
+        return;
+
+    if(bLong)
+    {
+        if(dbValue>2147483647.0)
+            dbValue=2147483647.0;
+        else if(dbValue<-2147483648.0)
+            dbValue=-2147483648.0;
+        slValue=(SLONG)dbValue;
+
+        ((HPULONG)FPGA_ANSCALE_EXTBUF_1W_BASE)[uwSlot*2]=LOWORD(slValue);
+        ((HPULONG)FPGA_ANSCALE_EXTBUF_1W_BASE)[uwSlot*2+1]=HIWORD(slValue);
+    }
+    else
+    {
+        if(dbValue>32767.0)
+            dbValue=32767.0;
+        else if(dbValue<-32768.0)
+            dbValue=-32768.0;
+        slValue=(SLONG)dbValue;
+
+        ((HPULONG)FPGA_ANSCALE_EXTBUF_2W_BASE)[uwSlot]=LOWORD(slValue);
+    }
+}
+
+//***************************************************************************
+// Write DSPH register group output (value in FPGA units)
+
+static void rgowrite(UBYTE ubTag, DOUBL dbValue)
+{
+    ANPROC_RGOUT sRgOut;
+
+    AnProc_RGOutGet(ubTag, &sRgOut);
+    if(sRgOut.pvDst)
+        extwrite(ubTag, dbValue*sRgOut.flScale);
+}
+
+//***************************************************************************
+// Fill parameters from motor plate and main encoder setup
+
+void HostSimPlant_DefaultParams(HOSTSIM_PLANT_PARAMS * psParams)
+{
+    memset(psParams, 0, sizeof(HOSTSIM_PLANT_PARAMS));
+
+    psParams->dbRs=sGlbMotorParameters.flResistance>0.0f?sGlbMotorParameters.flResistance:1.0;
+    psParams->dbLq=sGlbMotorParameters.flInductance>0.0f?sGlbMotorParameters.flInductance:5e-3;
+    psParams->dbLd=sGlbMotorParameters.flDirectInductance>0.0f?sGlbMotorParameters.flDirectInductance:psParams->dbLq;
+    psParams->dbKt=sGlbMotorParameters.flKT>0.0f?sGlbMotorParameters.flKT:1.0;
+    psParams->uwPolePairs=sGlbMotorParameters.uwPoleNumbers>=2?sGlbMotorParameters.uwPoleNumbers/2:4;
+    psParams->dbInertia=sGlbMotorParameters.flMotorInertia>0.0f?sGlbMotorParameters.flMotorInertia:1e-3;
+
+        // current loop at 1/8 of the realtime frequency, as standard DSPH tuning
+    psParams->dbCurrBandwidth=PLANT_TWOPI*REALTIME_TASK_FREQ/8.0;
+
+        // quadrature counts
+    psParams->ulEncCounts=sIc_IncEncParams[INCREMENTAL_SEL_MAIN].ulLineCounts?
+                          sIc_IncEncParams[INCREMENTAL_SEL_MAIN].ulLineCounts*4ul:10000ul;
+
+    psParams->dbVdcSource=560.0;
+    psParams->dbCdc=1e-3;
+    psParams->dbVdcTrip=800.0;
+}
+
+//***************************************************************************
+// Reset state with rotor at standstill in given mechanical position
+
+void HostSimPlant_Reset(DOUBL dbPosition)
+{
+    memset(&sHostSimPlant, 0, sizeof(sHostSimPlant));
+
+    sHostSimPlant.dbPosition=dbPosition;
+    sHostSimPlant.dbVdc=sHostSimPlantParams.dbVdcSource;
+
+    dbPlantCtrlAngle=0.0;
+    dbPlantCtrlVd=dbPlantCtrlVq=0.0;
+}
+
+//***************************************************************************
+// Install plant as HostSim tick hooks
+
+void HostSimPlant_Attach(void)
+{
+    HostSim_SetTickHooks(HostSimPlant_PreTick, HostSimPlant_PostTick);
+}
+
+//***************************************************************************
+// Publish plant outputs to the register file before the realtime tick
+
+void HostSimPlant_PreTick(ULONG ulTick)
+{
+    DOUBL dbRatioI=sMotorHandlerRun.flRatioI_EQ_RMS;
+    DOUBL dbRatioV=sMotorHandlerRun.flRatioV_DC_PEAK;
+    DOUBL dbElecAngle;
+    DOUBL dbId,dbIq;
+    UWORD uwStatus;
+
+        // main encoder, wraps as the FPGA counter
+    sHostSimPlant.ulEncCounter=(ULONG)(SLLNG)floor(sHostSimPlant.dbPosition/PLANT_TWOPI*(DOUBL)sHostSimPlantParams.ulEncCounts);
+    FPGA_BASEOFF_16(FPGA_DIGENC_BASEADDR, FPGA_INCENC_CNT_LSW)=LOWORD(sHostSimPlant.ulEncCounter);
+    FPGA_BASEOFF_16(FPGA_DIGENC_BASEADDR, FPGA_INCENC_CNT_MSW)=HIWORD(sHostSimPlant.ulEncCounter);
+    FPGA_BASEOFF_16(FPGA_DIGENC_BASEADDR, FPGA_INCENC_STATUS)=0;
+    FPGA_BASEOFF_16(FPGA_DIGENC_BASEADDR, FPGA_INCENC_M_PERIOD)=0;
+
+        // DC bus, both immediate and averaged where routed to firmware
+    extwrite(FPGA_ADTAGS_PWI_DCBUS, sHostSimPlant.dbVdc*PLANT_IU_PER_VOLT);
+    extwrite(FPGA_ADTAGS_PWI_DCBUS+ANPROC_AVG_TAGOFFSET, sHostSimPlant.dbVdc*PLANT_IU_PER_VOLT);
+    extwrite(FPGA_ADTAGS_PWB_DCBUS, sHostSimPlant.dbVdc*PLANT_IU_PER_VOLT);
+    extwrite(FPGA_ADTAGS_PWB_DCBUS+ANPROC_AVG_TAGOFFSET, sHostSimPlant.dbVdc*PLANT_IU_PER_VOLT);
+
+        // current feedbacks in the firmware frame
+    if(dbRatioI>0.0)
+    {
+        dbElecAngle=sHostSimPlantParams.uwPolePairs*sHostSimPlant.dbPosition+sHostSimPlant.dbElecOffset;
+        dbId=sHostSimPlant.dbId;
+        dbIq=sHostSimPlant.dbIq;
+        rotate(dbElecAngle-dbPlantCtrlAngle, &dbId, &dbIq);
+
+        rgowrite(FPGAIR_RGO_IFB_AD, dbId*PLANT_IU_PER_AMPERE/dbRatioI);
+        rgowrite(FPGAIR_RGO_IFB_AQ, dbIq*PLANT_IU_PER_AMPERE/dbRatioI);
+    }
+    if(dbRatioV>0.0)
+    {
+        rgowrite(FPGAIR_RGO_VOUT_D, dbPlantCtrlVd*PLANT_IU_PER_VOLT/dbRatioV);
+        rgowrite(FPGAIR_RGO_VOUT_Q, dbPlantCtrlVq*PLANT_IU_PER_VOLT/dbRatioV);
+    }
+
+        // power stage status, selected frequency is applied immediately
+    uwStatus=(UWORD)(((FPGA_PWM_SETEX&FPGA_PWM_B_SETEX_EN_FREQSEL_MASK)>>FPGA_PWM_B_SETEX_EN_FREQSEL_BASE)<<FPGA_PWM_STATUS_B_FREQSEL_BASE);
+    if(sHostSimPlant.bPwmOn)
+        uwStatus|=(1u<<1)|(1u<<2);          // enabled, fully active
+    if(sHostSimPlant.bOverVoltage)
+        uwStatus|=(1u<<0)|(1u<<4);          // fault, over voltage
+    FPGA_PWM_STATUS=uwStatus;
+}
+
+//***************************************************************************
+// Read firmware references after the realtime tick and integrate one slot
+
+void HostSimPlant_PostTick(ULONG ulTick)
+{
+    const HOSTSIM_PLANT_PARAMS * psPar=&sHostSimPlantParams;
+    HOSTSIM_PLANT_STATE * psSt=&sHostSimPlant;
+    DOUBL dbDt=1.0/(DOUBL)REALTIME_TASK_FREQ/HOSTSIM_PLANT_SUBSTEPS;
+    DOUBL dbRatioI=sMotorHandlerRun.flRatioI_EQ_RMS;
+    DOUBL dbPsi=psPar->dbKt/(3.0*psPar->uwPolePairs);
+    DOUBL dbIdRef,dbIqRef,dbCtrlBase;
+    DOUBL dbIdC,dbIqC,dbErrD,dbErrQ,dbVd,dbVq,dbVmax,dbVmod;
+    DOUBL dbWe,dbElecAngle,dbDid,dbDiq,dbTnet,dbPdc,dbIal,dbIbe;
+    BOOL  bEnable;
+    UWORD uwStep;
+
+        // power enable from firmware, trip latched until disable
+    bEnable=(FPGA_PWM_SET>>FPGA_PWM_B_SETUP_ENABLE)&1u;
+    if(!bEnable)
+        psSt->bOverVoltage=FALSE;
+    bEnable=bEnable && !psSt->bOverVoltage;
+
+        // references from DSPH inputs
+    dbIdRef=dbIqRef=0.0;
+    if(dbRatioI>0.0)
+    {
+        dbIdRef=(DOUBL)PLANT_URAM_RD_SW(FPGAIR_IREF_D)*dbRatioI/PLANT_IU_PER_AMPERE;
+        dbIqRef=(DOUBL)(SWORD)FPGA_IQFLT_IQREF*dbRatioI/PLANT_IU_PER_AMPERE;
+    }
+    dbCtrlBase=(DOUBL)FPGA_SCGEN_ANGLEBASE*PLANT_ANGLE2RAD;
+
+        // on enable align rotor frame to firmware angle, and restart loop
+    if(bEnable && !psSt->bPwmOn)
+    {
+        psSt->dbElecOffset=dbCtrlBase-psPar->uwPolePairs*psSt->dbPosition+
+                           (DOUBL)psPar->swElecAngleErr*PLANT_ANGLE2RAD;
+        psSt->dbIntD=psSt->dbIntQ=0.0;
+    }
+    psSt->bPwmOn=bEnable;
+
+    for(uwStep=0;uwStep<HOSTSIM_PLANT_SUBSTEPS;uwStep++)
+    {
+        dbWe=psPar->uwPolePairs*psSt->dbSpeed;
+        dbElecAngle=psPar->uwPolePairs*psSt->dbPosition+psSt->dbElecOffset;
+            // SCGEN extrapolates the firmware angle during the slot
+        dbPlantCtrlAngle=dbCtrlBase+dbWe*dbDt*uwStep;
+
+        if(psSt->bPwmOn)
+        {
+                // currents in firmware frame
+            dbIdC=psSt->dbId;
+            dbIqC=psSt->dbIq;
+            rotate(dbElecAngle-dbPlantCtrlAngle, &dbIdC, &dbIqC);
+
+                // PI, Kp=L*wc Ki=R*wc
+            dbErrD=dbIdRef-dbIdC;
+            dbErrQ=dbIqRef-dbIqC;
+            dbVd=psSt->dbIntD+psPar->dbLd*psPar->dbCurrBandwidth*dbErrD;
+            dbVq=psSt->dbIntQ+psPar->dbLq*psPar->dbCurrBandwidth*dbErrQ;
+
+                // SVPWM limit Vdc/sqrt(3) peak, integrals frozen in saturation
+            dbVmax=psSt->dbVdc/PLANT_SQRT6;
+            dbVmod=sqrt(dbVd*dbVd+dbVq*dbVq);
+            if(dbVmod>dbVmax)
+            {
+                dbVd*=dbVmax/dbVmod;
+                dbVq*=dbVmax/dbVmod;
+            }
+            else
+            {
+                psSt->dbIntD+=psPar->dbRs*psPar->dbCurrBandwidth*dbErrD*dbDt;
+                psSt->dbIntQ+=psPar->dbRs*psPar->dbCurrBandwidth*dbErrQ*dbDt;
+            }
+            dbPlantCtrlVd=dbVd;
+            dbPlantCtrlVq=dbVq;
+
+                // to rotor frame
+            rotate(dbPlantCtrlAngle-dbElecAngle, &dbVd, &dbVq);
+            psSt->dbVd=dbVd;
+            psSt->dbVq=dbVq;
+
+                // electrical, semi-implicit on resistance
+            dbDid=(dbVd+dbWe*psPar->dbLq*psSt->dbIq)/psPar->dbLd;
+            dbDiq=(dbVq-dbWe*(psPar->dbLd*psSt->dbId+dbPsi))/psPar->dbLq;
+            psSt->dbId=(psSt->dbId+dbDid*dbDt)/(1.0+psPar->dbRs/psPar->dbLd*dbDt);
+            psSt->dbIq=(psSt->dbIq+dbDiq*dbDt)/(1.0+psPar->dbRs/psPar->dbLq*dbDt);
+        }
+        else
+        {
+                // bridge off: no diode conduction modeled, currents decay
+            dbPlantCtrlVd=dbPlantCtrlVq=0.0;
+            psSt->dbVd=psSt->dbVq=0.0;
+            psSt->dbId=psSt->dbIq=0.0;
+        }
+
+            // DC link
+        dbPdc=3.0*(psSt->dbVd*psSt->dbId+psSt->dbVq*psSt->dbIq);
+        if(psPar->dbRdcSource>0.0 && psPar->dbCdc>0.0)
+        {
+            psSt->dbVdc+=((psPar->dbVdcSource-psSt->dbVdc)/psPar->dbRdcSource-
+                          (psSt->dbVdc>1.0?dbPdc/psSt->dbVdc:0.0))/psPar->dbCdc*dbDt;
+            if(psSt->dbVdc<0.0)
+                psSt->dbVdc=0.0;
+        }
+        else
+            psSt->dbVdc=psPar->dbVdcSource;
+
+        if(psPar->dbVdcTrip>0.0 && psSt->dbVdc>psPar->dbVdcTrip)
+        {
+            psSt->bOverVoltage=TRUE;
+            psSt->bPwmOn=FALSE;
+        }
+
+            // mechanics
+        psSt->dbTe=3.0*psPar->uwPolePairs*(dbPsi*psSt->dbIq+(psPar->dbLd-psPar->dbLq)*psSt->dbId*psSt->dbIq);
+        dbTnet=psSt->dbTe-psPar->dbLoadTorque-psPar->dbViscous*psSt->dbSpeed;
+        if(fabs(psSt->dbSpeed)<PLANT_STICTION_SPEED && fabs(dbTnet)<=psPar->dbCoulomb)
+            psSt->dbSpeed=0.0;
+        else
+        {
+            if(psSt->dbSpeed>0.0 || (psSt->dbSpeed==0.0 && dbTnet>0.0))
+                dbTnet-=psPar->dbCoulomb;
+            else
+                dbTnet+=psPar->dbCoulomb;
+            psSt->dbSpeed+=dbTnet/psPar->dbInertia*dbDt;
+        }
+        psSt->dbPosition+=psSt->dbSpeed*dbDt;
+    }
+
+        // phase currents for probes
+    dbElecAngle=psPar->uwPolePairs*psSt->dbPosition+psSt->dbElecOffset;
+    dbIal=psSt->dbId;
+    dbIbe=psSt->dbIq;
+    rotate(dbElecAngle, &dbIal, &dbIbe);
+    psSt->dbIu=PLANT_SQRT2*dbIal;
+    psSt->dbIv=PLANT_SQRT2*(-0.5*dbIal+PLANT_SQRT3/2.0*dbIbe);
+    psSt->dbIw=-psSt->dbIu-psSt->dbIv;
+}
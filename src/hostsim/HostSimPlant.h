@@ -0,0 +1,121 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimPlant.h                                             */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation closed-loop plant: PMSM, DC bus, mechanics, */
+/*               encoder and FPGA current loop                              */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIMPLANT_H
+#define _HOSTSIMPLANT_H
+
+//***************************************************************************
+// Model
+//
+// The plant takes the place of the FPGA power section: it reads the current
+// references and the electrical angle written by Mh_MotorDataToFpga8KHz,
+// closes the dq current loop like the DSPH (PI with voltage saturation at
+// Vdc/sqrt(3) peak), integrates the motor and feeds back through the same
+// register file the firmware reads:
+//      Id/Iq and Vd/Vq feedbacks       analog processor external buffers
+//      DC bus voltage                  analog processor external buffers
+//      power stage status              FPGA_PWM_STATUS
+//      main incremental encoder        FPGA_DIGENC_BASEADDR counters
+//
+// Quantities are in the firmware dq convention (vector modulus = phase RMS):
+//      vd = Rs*id + Ld*did/dt - we*Lq*iq
+//      vq = Rs*iq + Lq*diq/dt + we*(Ld*id + Psi)       Psi = Kt/(3*pp)
+//      Te = 3*pp*(Psi*iq + (Ld-Lq)*id*iq)
+//      J*dwm/dt = Te - Tload - B*wm - Tc*sign(wm)
+//      C*dVdc/dt = (Vsrc-Vdc)/Rsrc - 3*(vd*id+vq*iq)/Vdc
+//
+// Integration is fixed step (HOSTSIM_PLANT_SUBSTEPS per realtime slot) with
+// no host dependency, the same inputs always give the same trajectory.
+// The rotor frame is aligned to the firmware electrical angle at every power
+// enable (as a commissioned motor), plus swElecAngleErr to test wrong phasing.
+
+#include "common\CommonDefines.h"
+#include "HostSim.h"
+
+//***************************************************************************
+// Configuration
+
+    // integration steps per realtime slot
+#define HOSTSIM_PLANT_SUBSTEPS                  16
+
+//***************************************************************************
+// Structures
+
+    // plant parameters (SI units)
+typedef struct
+{
+    DOUBL   dbRs;                       // phase resistance [Ohm]
+    DOUBL   dbLd;                       // direct inductance [H]
+    DOUBL   dbLq;                       // quadrature inductance [H]
+    DOUBL   dbKt;                       // torque constant [Nm/Arms]
+    UWORD   uwPolePairs;                // pole pairs
+    SWORD   swElecAngleErr;             // rotor to firmware angle error [65536=360deg]
+    DOUBL   dbInertia;                  // motor + load inertia [kg*m^2]
+    DOUBL   dbViscous;                  // viscous friction [Nm/(rad/sec)]
+    DOUBL   dbCoulomb;                  // coulomb friction [Nm]
+    DOUBL   dbLoadTorque;               // external load torque [Nm]
+    DOUBL   dbCurrBandwidth;            // emulated FPGA current loop bandwidth [rad/sec]
+    ULONG   ulEncCounts;                // main encoder counts per revolution
+    DOUBL   dbVdcSource;                // DC source voltage [V]
+    DOUBL   dbRdcSource;                // DC source resistance [Ohm], 0 = stiff bus
+    DOUBL   dbCdc;                      // DC link capacitance [F]
+    DOUBL   dbVdcTrip;                  // over voltage trip level [V]
+} HOSTSIM_PLANT_PARAMS;
+
+    // plant state, readable by probes
+typedef struct
+{
+    DOUBL   dbId;                       // rotor frame currents [Arms]
+    DOUBL   dbIq;
+    DOUBL   dbIu;                       // phase currents [A]
+    DOUBL   dbIv;
+    DOUBL   dbIw;
+    DOUBL   dbVd;                       // rotor frame voltages [Vrms]
+    DOUBL   dbVq;
+    DOUBL   dbVdc;                      // DC link voltage [V]
+    DOUBL   dbTe;                       // electromagnetic torque [Nm]
+    DOUBL   dbSpeed;                    // mechanical speed [rad/sec]
+    DOUBL   dbPosition;                 // mechanical position [rad]
+    DOUBL   dbElecOffset;               // rotor to firmware angle offset [rad]
+    DOUBL   dbIntD;                     // emulated current loop integrals [V]
+    DOUBL   dbIntQ;
+    ULONG   ulEncCounter;               // last encoder counter written
+    BOOL    bPwmOn;                     // bridge modulating
+    BOOL    bOverVoltage;               // latched trip, reset by power disable
+} HOSTSIM_PLANT_STATE;
+
+//***************************************************************************
+// Globals
+
+extern HOSTSIM_PLANT_PARAMS sHostSimPlantParams;
+extern HOSTSIM_PLANT_STATE  sHostSimPlant;
+
+//***************************************************************************
+// Prototypes
+
+// Fill parameters from motor plate and main encoder setup (call after the
+// drive init collections), missing data are replaced by safe defaults
+void HostSimPlant_DefaultParams(HOSTSIM_PLANT_PARAMS * psParams);
+
+// Reset state with rotor at standstill in given mechanical position
+void HostSimPlant_Reset(DOUBL dbPosition);
+
+// Install plant as HostSim tick hooks
+void HostSimPlant_Attach(void);
+
+// Tick hooks, to be called by custom hooks when the plant is combined with
+// other stimuli: inputs before the realtime tick, integration after it
+void HostSimPlant_PreTick(ULONG ulTick);
+void HostSimPlant_PostTick(ULONG ulTick);
+
+#endif
@@ -0,0 +1,59 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimPlc.c                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the PLC runtime core and      */
+/*               address tables: no PLC program is loaded                   */
+/*                                                                          */
+/****************************************************************************/
+
+//***************************************************************************
+// plc\AlPlcRuntime2\AlPlcAreaDef.c (runtime core), plc\AlPlcUserTabs.c and
+// plc\PlcBuildInfo.c keep addresses as uint32_t in static initializers,
+// which a 64 bit host cannot relocate. They are not built: the runtime
+// reports no valid program, so plc\Plc.c runs with the PLC stopped and the
+// datablock search finds nothing.
+
+#include "common\CommonDefines.h"
+#include "plc\PlcRT.h"
+#include "AlPlcRuntime2\AlPlcAreaDef.h"
+
+//***************************************************************************
+// Tables
+
+    // ids never used by PLC programs, so no datablock is found
+PLC_ATTR_PLCIEC_DBREC plcDataBlocks[PLC_NUM_DB]=
+{
+    [0 ... PLC_NUM_DB-1]={.dbId=0xFFFF}
+};
+
+const PLC_BUILDINFO sPlcDiagBuildInfo=
+{
+    0,
+    PLCD_RT_CODE_START,
+    PLCD_RT_CODE_SIZE,
+    0,
+    0,
+};
+
+//***************************************************************************
+// Runtime entry points
+
+bool_t InitPlcRuntime(void)
+{
+    bPlcProgramOk=FALSE;
+    return TRUE;
+}
+
+bool_t LoadPlc(void)
+{
+    return FALSE;
+}
+
+void ManagePLCState(void)
+{
+}
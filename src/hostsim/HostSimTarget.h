@@ -0,0 +1,35 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimTarget.h                                            */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation forced include (-include), for the         */
+/*               definitions that cannot come from the include path         */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIMTARGET_H
+#define _HOSTSIMTARGET_H
+
+#include <stdint.h>
+
+//***************************************************************************
+// PLC runtime data types
+//
+// plc\AlPlcRuntime2 is the ARM delivery: its AlPlcMisraC.h defines uint32_t
+// as unsigned long, which is 64 bit on the host and clashes with
+// <stdint.h>. The header is found next to AlPlcCDefs.h before any include
+// path, then it is replaced here by the USE_STDINT_FOR_MISRA_C definitions
+// of plc\AlPlcRuntime5.
+
+#define _ALPLCMISRAC_H_
+
+typedef char                char_t;
+typedef float               float32_t;
+typedef double              float64_t;
+typedef unsigned char       bool_t;
+
+#endif
@@ -0,0 +1,229 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimTimer.c                                             */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stub of core\Timer.c: realtime task        */
+/*               callback, free running and capture/compare timers          */
+/*               driven by the simulated clock                              */
+/*                                                                          */
+/****************************************************************************/
+
+#include "common\CommonDefines.h"
+#include "core\Timer.h"
+#include "HostSim.h"
+
+//***************************************************************************
+// Defines
+
+#define HOSTSIM_TIMER_CCUNITS                   4
+
+    // capture/compare unit state
+typedef struct
+{
+    void (* pfCallback)(const void *, u32);
+    XTtcPs * psTimer;
+    BOOL bStarted;
+} HOSTSIM_CCUNIT;
+
+//***************************************************************************
+// Locals
+
+static void (* pfHostSimRTTask)();
+static ULONG ulHostSimRTFreq=kFrequency8KHz;
+static ULLNG ullHostSimSlotStart;
+static UWORD uwHostSimMatchTime;
+static UWORD uw1msCount;
+static ULLNG ullHostSim1msOrigin;
+
+static HOSTSIM_CCUNIT sHostSimCCUnits[HOSTSIM_TIMER_CCUNITS]=
+{
+    { NULL, &xTimer2, FALSE },
+    { NULL, &xTimer3, FALSE },
+    { NULL, &xTimer4, FALSE },
+    { NULL, &xTimer5, FALSE },
+};
+
+//***************************************************************************
+// Globals
+
+XTtcPs xTimer0,xTimer1,xTimer2;
+XTtcPs xTimer3,xTimer4,xTimer5;
+
+volatile UWORD uwXTTCTimers1ms;
+volatile UWORD uwXTTCTimersTask;
+
+//***************************************************************************
+// Timer Initialization
+
+void Timer_Init( ULONG ulFreq, void (*callback)() )
+{
+    uwXTTCTimers1ms=0;
+    uwXTTCTimersTask=0;
+    uw1msCount=0;
+    ullHostSim1msOrigin=HostSim_GetTime();
+
+    ulHostSimRTFreq=ulFreq;
+    pfHostSimRTTask=callback;
+
+        // interval of the realtime timer in TTC counts, as done by
+        // XTtcPs_CalcIntervalFromFreq() with prescaler disabled
+    xTimer0.Config.InputClockHz=XPAR_PS7_TTC_0_TTC_CLK_FREQ_HZ;
+    xTimer0.Interval=(u16)(XPAR_PS7_TTC_0_TTC_CLK_FREQ_HZ/ulFreq);
+    uwHostSimMatchTime=xTimer0.Interval/2;
+}
+
+//***************************************************************************
+// Set Real Time Task Handler
+
+void Timer_SetRTask( void (*callback)() )
+{
+    pfHostSimRTTask=callback;
+}
+
+//***************************************************************************
+// Capture/Compare Unit Functions
+
+void Timer_CCSet(UWORD uwTimerID, UBYTE ubPriority, void *callback)
+{
+    (void)ubPriority;
+
+    if(uwTimerID>=TIMER_CCU0_ID && uwTimerID<TIMER_CCU0_ID+HOSTSIM_TIMER_CCUNITS)
+        sHostSimCCUnits[uwTimerID-TIMER_CCU0_ID].pfCallback=(void (*)(const void *, u32))callback;
+}
+
+void Timer_CCStart(UWORD uwTimerID, UWORD uwMatchTime)
+{
+    if(uwTimerID>=TIMER_CCU0_ID && uwTimerID<TIMER_CCU0_ID+HOSTSIM_TIMER_CCUNITS)
+    {
+        sHostSimCCUnits[uwTimerID-TIMER_CCU0_ID].psTimer->Match=uwMatchTime;
+        sHostSimCCUnits[uwTimerID-TIMER_CCU0_ID].bStarted=TRUE;
+    }
+}
+
+void Timer_CCStop(UWORD uwTimerID)
+{
+    if(uwTimerID>=TIMER_CCU0_ID && uwTimerID<TIMER_CCU0_ID+HOSTSIM_TIMER_CCUNITS)
+        sHostSimCCUnits[uwTimerID-TIMER_CCU0_ID].bStarted=FALSE;
+}
+
+BOOL Timer_CCStatus(UWORD uwTimerID)
+{
+    if(uwTimerID>=TIMER_CCU0_ID && uwTimerID<TIMER_CCU0_ID+HOSTSIM_TIMER_CCUNITS)
+        return sHostSimCCUnits[uwTimerID-TIMER_CCU0_ID].bStarted;
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Sync manager reload registers
+
+void Timer_SetMatchTime(UWORD uwMatchTime)
+{
+    uwHostSimMatchTime=uwMatchTime;
+}
+
+UWORD Timer_GetMatchTime(void)
+{
+    return uwHostSimMatchTime;
+}
+
+void Timer_SetIntervalTime(UWORD Interval)
+{
+    xTimer0.Interval=Interval;
+}
+
+UWORD Timer_GetIntervalTime(void)
+{
+    return xTimer0.Interval;
+}
+
+//***************************************************************************
+// Background read of a free running timer: with the virtual clock nothing
+// else moves the time while the background polls, then each read takes
+// its share; reads from the interrupts leave the slot profile untouched
+
+static void backgroundpoll(void)
+{
+    if(ulHostSimIsrNesting==0)
+        HostSim_Consume(HOSTSIM_TIMER_POLL_TIME);
+}
+
+//***************************************************************************
+// Counter value as seen from the firmware
+
+u16 HostSim_TtcGetCounterValue(XTtcPs *InstancePtr)
+{
+    ULLNG ullElapsed;
+
+        // realtime timer is decrementing from the interval at slot start
+    if(InstancePtr==&xTimer0)
+    {
+        ullElapsed=(HostSim_GetTime()-ullHostSimSlotStart)*(XPAR_PS7_TTC_0_TTC_CLK_FREQ_HZ/1000ul)/(HOSTSIM_TIMER_TICKS_PER_SECOND/1000ul);
+        return (u16)(xTimer0.Interval-(u16)ullElapsed);
+    }
+
+        // 100nsec free running timers
+    if(InstancePtr==&xTimer2 || InstancePtr==&xTimer3 || InstancePtr==&xTimer4 || InstancePtr==&xTimer5)
+    {
+        backgroundpoll();
+        return (u16)HostSim_GetTime();
+    }
+
+    return 0;
+}
+
+//***************************************************************************
+// 1msec free running timer as seen from the firmware: with the virtual
+// clock it follows the simulated time since Timer_Init(), so that it runs
+// also before the first tick and under background busy waits
+
+u16 HostSim_Timers1ms(void)
+{
+    backgroundpoll();
+
+    if(HostSim_GetClock()==HOSTSIM_CLOCK_VIRTUAL)
+        return (u16)((HostSim_GetTime()-ullHostSim1msOrigin)/(HOSTSIM_TIMER_TICKS_PER_SECOND/1000ul));
+
+    return uwXTTCTimers1ms;
+}
+
+//***************************************************************************
+// Start of a realtime slot, base task timers update (TTC 1 handler)
+
+void HostSimTimer_SlotStart(ULLNG ullTime)
+{
+    ullHostSimSlotStart=ullTime;
+
+    uwXTTCTimersTask++;
+    if(++uw1msCount==ulHostSimRTFreq/kFrequency1KHz)
+    {
+        uw1msCount=0;
+        uwXTTCTimers1ms++;
+    }
+}
+
+//***************************************************************************
+// Realtime interrupt (TTC 0 handler), then the armed capture/compare units
+// are served once as lower priority interrupts; as on target the handlers
+// disarm themselves by Timer_CCStop() when needed
+
+void HostSimTimer_Fire(void)
+{
+    HOSTSIM_CCUNIT * psUnit;
+    UWORD i;
+
+    ulHostSimIsrNesting++;
+
+    if(pfHostSimRTTask)
+        pfHostSimRTTask();
+
+    for(i=0,psUnit=sHostSimCCUnits;i<HOSTSIM_TIMER_CCUNITS;i++,psUnit++)
+        if(psUnit->bStarted && psUnit->pfCallback)
+            (*psUnit->pfCallback)(psUnit->psTimer, XTTCPS_IXR_MATCH_0_MASK);
+
+    ulHostSimIsrNesting--;
+}
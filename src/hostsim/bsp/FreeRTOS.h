@@ -0,0 +1,61 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : FreeRTOS.h                                                 */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the FreeRTOS kernel; the      */
+/*               whole process is one task, objects are implemented in      */
+/*               hostsim\HostSimOs.c                                        */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_FREERTOS_H
+#define _HOSTSIM_FREERTOS_H
+
+#include "xil_types.h"
+
+//***************************************************************************
+// Configuration
+
+#define configTICK_RATE_HZ                      1000
+#define configMINIMAL_STACK_SIZE                200
+#define configMAX_PRIORITIES                    8
+
+#define tskIDLE_PRIORITY                        0
+
+#define pdFALSE                                 0
+#define pdTRUE                                  1
+#define pdPASS                                  (pdTRUE)
+#define pdFAIL                                  (pdFALSE)
+
+#define portMAX_DELAY                           ((TickType_t)0xffffffffUL)
+
+    // GIC priority field alignment, as the Cortex-A9 port (32 levels)
+#define portPRIORITY_SHIFT                      3
+#define configMAX_API_CALL_INTERRUPT_PRIORITY   18
+
+//***************************************************************************
+// Types
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef u32 TickType_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef struct tagHOSTSIM_TASK * TaskHandle_t;
+typedef struct tagHOSTSIM_QUEUE * QueueHandle_t;
+typedef struct tagHOSTSIM_QUEUE * SemaphoreHandle_t;
+
+//***************************************************************************
+// Kernel subset used outside system\Os.c
+
+void vTaskDelay(const TickType_t xTicksToDelay);
+void vTaskStartScheduler(void);
+void vPortInstallFreeRTOSVectorTable(void);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize);
+
+#endif
@@ -0,0 +1,22 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : Xil_assert.h                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP asserts        */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XIL_ASSERT_H
+#define _HOSTSIM_XIL_ASSERT_H
+
+#include <assert.h>
+
+#define Xil_AssertVoid(Expression)          assert(Expression)
+#define Xil_AssertNonvoid(Expression)       assert(Expression)
+#define Xil_AssertVoidAlways()              assert(0)
+
+#endif
@@ -0,0 +1,174 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : arm_neon.h                                                 */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the ARM NEON                  */
+/*               intrinsics used by the firmware, plain C lanes             */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_ARM_NEON_H
+#define _HOSTSIM_ARM_NEON_H
+
+#include <stdint.h>
+#include <string.h>
+
+//***************************************************************************
+// Vector types; lane semantics follow the ARM architecture (wrapping
+// integer arithmetic, all ones comparison masks, truncating narrow)
+
+typedef struct { uint16_t v[4]; } uint16x4_t;
+typedef struct { int16_t  v[4]; } int16x4_t;
+typedef struct { uint16_t v[8]; } uint16x8_t;
+typedef struct { int16_t  v[8]; } int16x8_t;
+typedef struct { uint32_t v[4]; } uint32x4_t;
+typedef struct { int32_t  v[4]; } int32x4_t;
+typedef struct { float    v[4]; } float32x4_t;
+typedef struct { uint64_t v[1]; } uint64x1_t;
+
+    // lane loop helper
+#define NEON_LANES(n, expr)     { int i; for(i=0;i<(n);i++) { expr; } }
+
+//***************************************************************************
+// Load, store, lanes
+
+static inline uint16x4_t vld1_u16(const uint16_t * p)   { uint16x4_t r; memcpy(r.v, p, sizeof(r.v)); return r; }
+static inline int16x4_t  vld1_s16(const int16_t * p)    { int16x4_t r;  memcpy(r.v, p, sizeof(r.v)); return r; }
+static inline int16x8_t  vld1q_s16(const int16_t * p)   { int16x8_t r;  memcpy(r.v, p, sizeof(r.v)); return r; }
+static inline void vst1_u16(uint16_t * p, uint16x4_t a) { memcpy(p, a.v, sizeof(a.v)); }
+static inline void vst1_s16(int16_t * p, int16x4_t a)   { memcpy(p, a.v, sizeof(a.v)); }
+static inline void vst1q_s16(int16_t * p, int16x8_t a)  { memcpy(p, a.v, sizeof(a.v)); }
+
+static inline uint16x4_t vld1_lane_u16(const uint16_t * p, uint16x4_t a, int n) { a.v[n]=*p; return a; }
+static inline uint32_t vgetq_lane_u32(uint32x4_t a, int n)  { return a.v[n]; }
+static inline uint64_t vget_lane_u64(uint64x1_t a, int n)   { return a.v[n]; }
+
+static inline uint16x4_t vdup_n_u16(uint16_t x)         { uint16x4_t r; NEON_LANES(4, r.v[i]=x); return r; }
+static inline int16x4_t  vdup_n_s16(int16_t x)          { int16x4_t r;  NEON_LANES(4, r.v[i]=x); return r; }
+static inline int16x8_t  vdupq_n_s16(int16_t x)         { int16x8_t r;  NEON_LANES(8, r.v[i]=x); return r; }
+static inline uint32x4_t vdupq_n_u32(uint32_t x)        { uint32x4_t r; NEON_LANES(4, r.v[i]=x); return r; }
+static inline int32x4_t  vdupq_n_s32(int32_t x)         { int32x4_t r;  NEON_LANES(4, r.v[i]=x); return r; }
+
+static inline int16x4_t vget_low_s16(int16x8_t a)       { int16x4_t r; memcpy(r.v, &a.v[0], sizeof(r.v)); return r; }
+static inline int16x4_t vget_high_s16(int16x8_t a)      { int16x4_t r; memcpy(r.v, &a.v[4], sizeof(r.v)); return r; }
+static inline int16x8_t vcombine_s16(int16x4_t a, int16x4_t b)
+    { int16x8_t r; memcpy(&r.v[0], a.v, sizeof(a.v)); memcpy(&r.v[4], b.v, sizeof(b.v)); return r; }
+
+static inline int32x4_t  vreinterpretq_s32_u32(uint32x4_t a) { int32x4_t r;  memcpy(r.v, a.v, sizeof(r.v)); return r; }
+static inline uint32x4_t vreinterpretq_u32_s32(int32x4_t a)  { uint32x4_t r; memcpy(r.v, a.v, sizeof(r.v)); return r; }
+static inline uint64x1_t vreinterpret_u64_u16(uint16x4_t a)  { uint64x1_t r; memcpy(r.v, a.v, sizeof(r.v)); return r; }
+
+//***************************************************************************
+// Widen, narrow
+
+static inline uint32x4_t vmovl_u16(uint16x4_t a)        { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]); return r; }
+static inline int32x4_t  vmovl_s16(int16x4_t a)         { int32x4_t r;  NEON_LANES(4, r.v[i]=a.v[i]); return r; }
+static inline uint16x4_t vmovn_u32(uint32x4_t a)        { uint16x4_t r; NEON_LANES(4, r.v[i]=(uint16_t)a.v[i]); return r; }
+static inline int16x4_t  vmovn_s32(int32x4_t a)         { int16x4_t r;  NEON_LANES(4, r.v[i]=(int16_t)(uint16_t)(uint32_t)a.v[i]); return r; }
+
+static inline int16x4_t vqshrn_n_s32(int32x4_t a, int n)
+{
+    int16x4_t r;
+    int32_t x;
+
+    NEON_LANES(4, x=a.v[i]>>n; r.v[i]=(int16_t)(x>32767?32767:(x<-32768?-32768:x)));
+    return r;
+}
+
+//***************************************************************************
+// Integer arithmetic
+
+static inline int16x8_t  vaddq_s16(int16x8_t a, int16x8_t b)    { int16x8_t r;  NEON_LANES(8, r.v[i]=(int16_t)(uint16_t)(a.v[i]+b.v[i])); return r; }
+static inline int16x8_t  vsubq_s16(int16x8_t a, int16x8_t b)    { int16x8_t r;  NEON_LANES(8, r.v[i]=(int16_t)(uint16_t)(a.v[i]-b.v[i])); return r; }
+static inline uint32x4_t vaddq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]+b.v[i]); return r; }
+static inline uint32x4_t vsubq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]-b.v[i]); return r; }
+static inline uint32x4_t vmulq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]*b.v[i]); return r; }
+static inline int32x4_t  vaddq_s32(int32x4_t a, int32x4_t b)    { int32x4_t r;  NEON_LANES(4, r.v[i]=(int32_t)((uint32_t)a.v[i]+(uint32_t)b.v[i])); return r; }
+static inline int32x4_t  vmulq_n_s32(int32x4_t a, int32_t b)    { int32x4_t r;  NEON_LANES(4, r.v[i]=(int32_t)((uint32_t)a.v[i]*(uint32_t)b)); return r; }
+static inline int32x4_t  vnegq_s32(int32x4_t a)                 { int32x4_t r;  NEON_LANES(4, r.v[i]=(int32_t)(0u-(uint32_t)a.v[i])); return r; }
+static inline int32x4_t  vabsq_s32(int32x4_t a)                 { int32x4_t r;  NEON_LANES(4, r.v[i]=a.v[i]<0?(int32_t)(0u-(uint32_t)a.v[i]):a.v[i]); return r; }
+static inline uint32x4_t vminq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]<b.v[i]?a.v[i]:b.v[i]); return r; }
+static inline uint32x4_t vmaxq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]>b.v[i]?a.v[i]:b.v[i]); return r; }
+
+static inline int32x4_t vmull_s16(int16x4_t a, int16x4_t b)
+    { int32x4_t r; NEON_LANES(4, r.v[i]=(int32_t)a.v[i]*b.v[i]); return r; }
+static inline int32x4_t vmlal_s16(int32x4_t c, int16x4_t a, int16x4_t b)
+    { int32x4_t r; NEON_LANES(4, r.v[i]=(int32_t)((uint32_t)c.v[i]+(uint32_t)((int32_t)a.v[i]*b.v[i]))); return r; }
+static inline int32x4_t vmlsl_s16(int32x4_t c, int16x4_t a, int16x4_t b)
+    { int32x4_t r; NEON_LANES(4, r.v[i]=(int32_t)((uint32_t)c.v[i]-(uint32_t)((int32_t)a.v[i]*b.v[i]))); return r; }
+
+//***************************************************************************
+// Shifts; register shift takes the signed low byte of each lane, right
+// shift if negative
+
+static inline uint32x4_t vshlq_n_u32(uint32x4_t a, int n)   { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]<<n); return r; }
+static inline int32x4_t  vshlq_n_s32(int32x4_t a, int n)    { int32x4_t r;  NEON_LANES(4, r.v[i]=(int32_t)((uint32_t)a.v[i]<<n)); return r; }
+static inline uint32x4_t vshrq_n_u32(uint32x4_t a, int n)   { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]>>n); return r; }
+static inline uint32x4_t vsraq_n_u32(uint32x4_t a, uint32x4_t b, int n)
+    { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]+(b.v[i]>>n)); return r; }
+
+static inline int16x8_t vshlq_s16(int16x8_t a, int16x8_t b)
+{
+    int16x8_t r;
+    int8_t s;
+
+    NEON_LANES(8, s=(int8_t)b.v[i];
+        r.v[i]=s>=0?(s>=16?0:(int16_t)(uint16_t)((uint16_t)a.v[i]<<s)):(int16_t)(a.v[i]>>(s<=-16?15:-s)));
+    return r;
+}
+
+//***************************************************************************
+// Logic, comparisons, bitwise select
+
+static inline uint16x4_t vorr_u16(uint16x4_t a, uint16x4_t b)   { uint16x4_t r; NEON_LANES(4, r.v[i]=a.v[i]|b.v[i]); return r; }
+static inline uint32x4_t vandq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]&b.v[i]); return r; }
+static inline uint32x4_t vorrq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]|b.v[i]); return r; }
+static inline uint32x4_t veorq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]^b.v[i]); return r; }
+
+static inline uint16x4_t vceq_s16(int16x4_t a, int16x4_t b)     { uint16x4_t r; NEON_LANES(4, r.v[i]=a.v[i]==b.v[i]?0xFFFF:0); return r; }
+static inline uint16x8_t vcgtq_s16(int16x8_t a, int16x8_t b)    { uint16x8_t r; NEON_LANES(8, r.v[i]=a.v[i]>b.v[i]?0xFFFF:0); return r; }
+static inline uint32x4_t vceqq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]==b.v[i]?~0u:0u); return r; }
+static inline uint32x4_t vcgeq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]>=b.v[i]?~0u:0u); return r; }
+static inline uint32x4_t vcgeq_s32(int32x4_t a, int32x4_t b)    { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]>=b.v[i]?~0u:0u); return r; }
+static inline uint32x4_t vcltq_s32(int32x4_t a, int32x4_t b)    { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]<b.v[i]?~0u:0u); return r; }
+static inline uint32x4_t vtstq_u32(uint32x4_t a, uint32x4_t b)  { uint32x4_t r; NEON_LANES(4, r.v[i]=(a.v[i]&b.v[i])?~0u:0u); return r; }
+
+static inline uint32x4_t vbslq_u32(uint32x4_t m, uint32x4_t a, uint32x4_t b)
+    { uint32x4_t r; NEON_LANES(4, r.v[i]=(m.v[i]&a.v[i])|(~m.v[i]&b.v[i])); return r; }
+static inline int32x4_t vbslq_s32(uint32x4_t m, int32x4_t a, int32x4_t b)
+    { int32x4_t r; NEON_LANES(4, r.v[i]=(int32_t)((m.v[i]&(uint32_t)a.v[i])|(~m.v[i]&(uint32_t)b.v[i]))); return r; }
+static inline int16x8_t vbslq_s16(uint16x8_t m, int16x8_t a, int16x8_t b)
+    { int16x8_t r; NEON_LANES(8, r.v[i]=(int16_t)((m.v[i]&(uint16_t)a.v[i])|(~m.v[i]&(uint16_t)b.v[i]))); return r; }
+
+//***************************************************************************
+// Float; conversion to unsigned truncates and saturates, reciprocal
+// estimate is the architecture 8 bit table (FPRecipEstimate), normal
+// positive inputs only as in the firmware use
+
+static inline float32x4_t vcvtq_f32_u32(uint32x4_t a)   { float32x4_t r; NEON_LANES(4, r.v[i]=(float)a.v[i]); return r; }
+static inline uint32x4_t vcvtq_u32_f32(float32x4_t a)
+    { uint32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]<=0.0f?0u:(a.v[i]>=4294967296.0f?~0u:(uint32_t)a.v[i])); return r; }
+static inline float32x4_t vmulq_f32(float32x4_t a, float32x4_t b)   { float32x4_t r; NEON_LANES(4, r.v[i]=a.v[i]*b.v[i]); return r; }
+static inline float32x4_t vrecpsq_f32(float32x4_t a, float32x4_t b) { float32x4_t r; NEON_LANES(4, r.v[i]=2.0f-a.v[i]*b.v[i]); return r; }
+
+static inline float32x4_t vrecpeq_f32(float32x4_t a)
+{
+    float32x4_t r;
+    uint32_t ulBits, ulScaled, ulEst;
+
+    NEON_LANES(4,
+        memcpy(&ulBits, &a.v[i], sizeof(ulBits));
+        ulScaled=0x100u|((ulBits>>15)&0xFFu);
+        ulEst=((1u<<19)/(ulScaled*2u+1u)+1u)>>1;
+        ulBits=(ulBits&0x80000000u)|((253u-((ulBits>>23)&0xFFu))<<23)|((ulEst&0xFFu)<<15);
+        memcpy(&r.v[i], &ulBits, sizeof(ulBits)));
+    return r;
+}
+
+#undef NEON_LANES
+
+#endif
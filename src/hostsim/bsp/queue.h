@@ -0,0 +1,18 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : queue.h                                                    */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the FreeRTOS kernel           */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_QUEUE_H
+#define _HOSTSIM_QUEUE_H
+
+#include "FreeRTOS.h"
+
+#endif
@@ -0,0 +1,21 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : sleep.h                                                    */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP delays         */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_SLEEP_H
+#define _HOSTSIM_SLEEP_H
+
+    // hardware settling delays have no meaning against the simulated
+    // register file, and sleeping would spoil the benchmark timing
+#define usleep(useconds)            ((void)(useconds),0)
+#define sleep(seconds)              ((void)(seconds),0)
+
+#endif
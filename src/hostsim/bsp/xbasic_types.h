@@ -0,0 +1,19 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xbasic_types.h                                             */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP basic types    */
+/*               (legacy header)                                            */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XBASIC_TYPES_H
+#define _HOSTSIM_XBASIC_TYPES_H
+
+#include "xil_types.h"
+
+#endif
@@ -0,0 +1,70 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xcanps.h                                                   */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx CAN driver; no     */
+/*               controller is configured, frames are dropped               */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XCANPS_H
+#define _HOSTSIM_XCANPS_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#define XCANPS_MODE_CONFIG          0x00000001U
+#define XCANPS_MODE_NORMAL          0x00000002U
+
+#define XCANPS_SR_NORMAL_MASK       0x00000008U
+#define XCANPS_SR_ESTAT_MASK        0x00000180U
+#define XCANPS_SR_ERRWRN_MASK       0x00000800U
+
+#define XCANPS_IXR_TXOK_MASK        0x00000002U
+#define XCANPS_IXR_RXOK_MASK        0x00000010U
+#define XCANPS_IXR_RXNEMP_MASK      0x00000080U
+#define XCANPS_IXR_ALL              0x00007FFFU
+
+#define XCANPS_HANDLER_SEND         1U
+#define XCANPS_HANDLER_RECV         2U
+
+typedef struct
+{
+    u16 DeviceId;
+    UINTPTR BaseAddr;
+} XCanPs_Config;
+
+typedef struct
+{
+    XCanPs_Config CanConfig;
+    u32 IsReady;
+    u32 Mode;
+} XCanPs;
+
+    // frame fields, as the Xilinx driver
+#define XCanPs_CreateIdValue(StandardId,SubRemoteTransReq,IdExtension,ExtendedId,RemoteTransReq) \
+            ((((StandardId)<<21)&0xFFE00000U)|(((SubRemoteTransReq)<<20)&0x00100000U)| \
+             (((IdExtension)<<19)&0x00080000U)|(((ExtendedId)<<1)&0x0007FFFEU)|((RemoteTransReq)&0x00000001U))
+#define XCanPs_CreateDlcValue(DataLengCode)                     (((DataLengCode)<<28)&0xF0000000U)
+
+#define XCanPs_LookupConfig(DeviceId)                           ((XCanPs_Config *)NULL)
+#define XCanPs_CfgInitialize(InstancePtr,ConfigPtr,EffAddr)     ((InstancePtr)->IsReady=XIL_COMPONENT_IS_READY,XST_SUCCESS)
+#define XCanPs_SelfTest(InstancePtr)                            (XST_SUCCESS)
+#define XCanPs_EnterMode(InstancePtr,OperationMode)             ((InstancePtr)->Mode=(OperationMode))
+#define XCanPs_GetMode(InstancePtr)                             ((InstancePtr)->Mode)
+#define XCanPs_GetStatus(InstancePtr)                           ((InstancePtr)->Mode==XCANPS_MODE_NORMAL ? XCANPS_SR_NORMAL_MASK : 0U)
+#define XCanPs_SetBaudRatePrescaler(InstancePtr,Prescaler)      (XST_SUCCESS)
+#define XCanPs_SetBitTiming(InstancePtr,SyncJumpWidth,TimeSegment2,TimeSegment1)    (XST_SUCCESS)
+#define XCanPs_SetHandler(InstancePtr,HandlerType,CallBackFunc,CallBackRef)
+#define XCanPs_IntrEnable(InstancePtr,Mask)
+#define XCanPs_IntrDisable(InstancePtr,Mask)
+#define XCanPs_IntrHandler                                      NULL
+#define XCanPs_IsTxFifoFull(InstancePtr)                        (FALSE)
+#define XCanPs_Send(InstancePtr,FramePtr)                       (XST_SUCCESS)
+#define XCanPs_Recv(InstancePtr,FramePtr)                       (XST_FAILURE)
+
+#endif
@@ -0,0 +1,52 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xgpiops.h                                                  */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx GPIO driver,       */
+/*               pins are backed by the simulated pin array                 */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XGPIOPS_H
+#define _HOSTSIM_XGPIOPS_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#define XGPIOPS_MAX_PINS            118
+
+#define XGPIOPS_BANK0               0x00U
+#define XGPIOPS_BANK1               0x01U
+#define XGPIOPS_BANK2               0x02U
+#define XGPIOPS_BANK3               0x03U
+
+typedef struct
+{
+    u16 DeviceId;
+    u32 BaseAddr;
+} XGpioPs_Config;
+
+typedef struct
+{
+    XGpioPs_Config GpioConfig;
+    u32 IsReady;
+} XGpioPs;
+
+    // pin levels, see hostsim\HostSim.c
+extern u8 ubHostSimGpioPins[XGPIOPS_MAX_PINS];
+
+#define XGpioPs_LookupConfig(DeviceId)                          ((XGpioPs_Config *)NULL)
+#define XGpioPs_CfgInitialize(InstancePtr,ConfigPtr,EffAddr)    ((InstancePtr)->IsReady=XIL_COMPONENT_IS_READY,XST_SUCCESS)
+#define XGpioPs_SetDirectionPin(InstancePtr,Pin,Direction)
+#define XGpioPs_SetOutputEnablePin(InstancePtr,Pin,OpEnable)
+#define XGpioPs_WritePin(InstancePtr,Pin,Data)                  (ubHostSimGpioPins[(Pin)]=(u8)((Data)!=0))
+#define XGpioPs_ReadPin(InstancePtr,Pin)                        ((u32)ubHostSimGpioPins[(Pin)])
+
+u32 XGpioPs_Read(XGpioPs *InstancePtr, u8 Bank);
+#define XGpioPs_WriteReg(BaseAddr,RegOffset,Data)
+
+#endif
@@ -0,0 +1,23 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xil_cache.h                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP cache          */
+/*               maintenance                                                */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XIL_CACHE_H
+#define _HOSTSIM_XIL_CACHE_H
+
+#include "xil_types.h"
+
+#define Xil_DCacheFlushRange(adr,len)
+#define Xil_DCacheInvalidateRange(adr,len)
+#define Xil_ICacheInvalidateRange(adr,len)
+
+#endif
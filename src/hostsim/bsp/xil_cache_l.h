@@ -0,0 +1,23 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xil_cache_l.h                                              */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx L1/L2 cache        */
+/*               maintenance                                                */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XIL_CACHE_L_H
+#define _HOSTSIM_XIL_CACHE_L_H
+
+#include "xil_types.h"
+
+#define Xil_L1DCacheFlush()
+#define Xil_L1DCacheInvalidate()
+#define Xil_L1ICacheInvalidate()
+
+#endif
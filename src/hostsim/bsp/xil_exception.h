@@ -0,0 +1,28 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xil_exception.h                                            */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP exception      */
+/*               handling                                                   */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XIL_EXCEPTION_H
+#define _HOSTSIM_XIL_EXCEPTION_H
+
+#include "xil_types.h"
+
+typedef void (*Xil_ExceptionHandler)(void *data);
+
+#define XIL_EXCEPTION_ID_INT                                    5U
+#define XIL_EXCEPTION_ID_IRQ_INT                                5U
+
+#define Xil_ExceptionRegisterHandler(Exception_id,Handler,Data)
+#define Xil_ExceptionEnable()
+#define Xil_ExceptionDisable()
+
+#endif
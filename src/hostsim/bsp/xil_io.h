@@ -0,0 +1,26 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xil_io.h                                                   */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP register       */
+/*               access, plain memory load/store                            */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XIL_IO_H
+#define _HOSTSIM_XIL_IO_H
+
+#include "xil_types.h"
+
+static inline u8  Xil_In8(UINTPTR Addr)             { return *(volatile u8 *)Addr; }
+static inline u16 Xil_In16(UINTPTR Addr)            { return *(volatile u16 *)Addr; }
+static inline u32 Xil_In32(UINTPTR Addr)            { return *(volatile u32 *)Addr; }
+static inline void Xil_Out8(UINTPTR Addr, u8 Val)   { *(volatile u8 *)Addr=Val; }
+static inline void Xil_Out16(UINTPTR Addr, u16 Val) { *(volatile u16 *)Addr=Val; }
+static inline void Xil_Out32(UINTPTR Addr, u32 Val) { *(volatile u32 *)Addr=Val; }
+
+#endif
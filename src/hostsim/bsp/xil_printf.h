@@ -0,0 +1,20 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xil_printf.h                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP console output */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XIL_PRINTF_H
+#define _HOSTSIM_XIL_PRINTF_H
+
+#include <stdio.h>
+
+#define xil_printf                  printf
+
+#endif
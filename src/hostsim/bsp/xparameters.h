@@ -0,0 +1,59 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xparameters.h                                              */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP hardware       */
+/*               parameters; the FPGA AXI adapter is mapped on the          */
+/*               simulated register file                                    */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XPARAMETERS_H
+#define _HOSTSIM_XPARAMETERS_H
+
+#include "xil_types.h"
+
+//***************************************************************************
+// Simulated address map (see hostsim\HostSim.c)
+//
+// Firmware keeps addresses into ULONG, also in static initializers, so the
+// simulated areas must have constant addresses below 4GB: HostSim_Init()
+// maps them at the same addresses as on the Zynq.
+
+#define XPAR_AXI_ADAPTER_0_S00_AXI_BASEADDR     0x43C00000U     // FPGA register file
+#define XPAR_AXI_ETHERCAT_0_BASEADDR            0x43C40000U     // EtherCAT slave controller
+#define XPS_QSPI_LINEAR_BASEADDR                0xFC000000U     // QSPI flash linear window
+
+//***************************************************************************
+// Processing system peripherals
+
+#define XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ     666666687
+#define XPAR_PS7_TTC_0_TTC_CLK_FREQ_HZ          111111115
+
+#define XPAR_XTTCPS_NUM_INSTANCES               6
+#define XPAR_XTTCPS_0_DEVICE_ID                 0
+#define XPAR_XTTCPS_1_DEVICE_ID                 1
+#define XPAR_XTTCPS_2_DEVICE_ID                 2
+#define XPAR_XTTCPS_3_DEVICE_ID                 3
+#define XPAR_XTTCPS_4_DEVICE_ID                 4
+#define XPAR_XTTCPS_5_DEVICE_ID                 5
+#define XPAR_XTTCPS_0_INTR                      42
+#define XPAR_XTTCPS_1_INTR                      43
+#define XPAR_XTTCPS_2_INTR                      44
+#define XPAR_XTTCPS_3_INTR                      69
+#define XPAR_XTTCPS_4_INTR                      70
+#define XPAR_XTTCPS_5_INTR                      71
+
+#define XPAR_SCUGIC_0_DEVICE_ID                 0
+#define XPAR_SCUGIC_SINGLE_DEVICE_ID            0
+#define XPAR_XGPIOPS_0_DEVICE_ID                0
+#define XPAR_XCANPS_0_DEVICE_ID                 0
+#define XPAR_XCANPS_1_DEVICE_ID                 1
+#define XPS_CAN0_INT_ID                         60
+#define XPS_CAN1_INT_ID                         83
+
+#endif
@@ -0,0 +1,27 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xplatform_info.h                                           */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP platform       */
+/*               identification                                             */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XPLATFORM_INFO_H
+#define _HOSTSIM_XPLATFORM_INFO_H
+
+#include "xil_types.h"
+
+#define XPLAT_ZYNQ_ULTRA_MP         0x1
+#define XPLAT_ZYNQ_ULTRA_MPVEL      0x2
+#define XPLAT_ZYNQ_ULTRA_MPQEMU     0x3
+#define XPLAT_ZYNQ                  0x4
+#define XPLAT_MICROBLAZE            0x5
+
+#define XGetPlatform_Info()         ((u32)XPLAT_ZYNQ)
+
+#endif
@@ -0,0 +1,19 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xqspips_hw.h                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx QSPI register      */
+/*               definitions                                                */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XQSPIPS_HW_H
+#define _HOSTSIM_XQSPIPS_HW_H
+
+#include "xil_types.h"
+
+#endif
@@ -0,0 +1,44 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xscugic.h                                                  */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx interrupt          */
+/*               controller driver, no interrupt source is wired            */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XSCUGIC_H
+#define _HOSTSIM_XSCUGIC_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+typedef void (*Xil_InterruptHandler)(void *data);
+
+typedef struct
+{
+    u16 DeviceId;
+    u32 CpuBaseAddress;
+    u32 DistBaseAddress;
+} XScuGic_Config;
+
+typedef struct
+{
+    XScuGic_Config *Config;
+    u32 IsReady;
+} XScuGic;
+
+#define XScuGic_LookupConfig(DeviceId)                          ((XScuGic_Config *)NULL)
+#define XScuGic_CfgInitialize(InstancePtr,ConfigPtr,EffAddr)    ((InstancePtr)->IsReady=XIL_COMPONENT_IS_READY,XST_SUCCESS)
+#define XScuGic_SelfTest(InstancePtr)                           (XST_SUCCESS)
+#define XScuGic_Connect(InstancePtr,Int_Id,Handler,CallBackRef) (XST_SUCCESS)
+#define XScuGic_Enable(InstancePtr,Int_Id)
+#define XScuGic_Disable(InstancePtr,Int_Id)
+#define XScuGic_SetPriorityTriggerType(InstancePtr,Int_Id,Priority,Trigger)
+#define XScuGic_InterruptHandler                                NULL
+
+#endif
@@ -0,0 +1,33 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xscutimer.h                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx SCU private timer  */
+/*               driver, only the types are provided                        */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XSCUTIMER_H
+#define _HOSTSIM_XSCUTIMER_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+typedef struct
+{
+    u16 DeviceId;
+    u32 BaseAddr;
+} XScuTimer_Config;
+
+typedef struct
+{
+    XScuTimer_Config Config;
+    u32 IsReady;
+    u32 IsStarted;
+} XScuTimer;
+
+#endif
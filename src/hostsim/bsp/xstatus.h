@@ -0,0 +1,19 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xstatus.h                                                  */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP status codes   */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XSTATUS_H
+#define _HOSTSIM_XSTATUS_H
+
+#define XST_SUCCESS                 0L
+#define XST_FAILURE                 1L
+
+#endif
@@ -0,0 +1,28 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xtime_l.h                                                  */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx BSP global timer   */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XTIME_L_H
+#define _HOSTSIM_XTIME_L_H
+
+#include "xil_types.h"
+#include "xparameters.h"
+
+typedef u64 XTime;
+
+#define GLOBAL_TMR_BASEADDR         ((UINTPTR)&ulHostSimGlobalTimer)
+#define COUNTS_PER_SECOND           (XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ/2)
+
+extern volatile u32 ulHostSimGlobalTimer;
+
+void XTime_GetTime(XTime *Xtime_Global);
+
+#endif
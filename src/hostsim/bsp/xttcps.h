@@ -0,0 +1,50 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : xttcps.h                                                   */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host simulation stand-in for the Xilinx triple timer       */
+/*               counter driver, counters follow the simulated clock        */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIM_XTTCPS_H
+#define _HOSTSIM_XTTCPS_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xparameters.h"
+
+typedef struct
+{
+    u16 DeviceId;
+    UINTPTR BaseAddress;
+    u32 InputClockHz;
+} XTtcPs_Config;
+
+typedef struct
+{
+    XTtcPs_Config Config;
+    u32 IsReady;
+    u16 Interval;
+    u16 Match;
+} XTtcPs;
+
+typedef void (*XTtcPs_StatusHandler) (const void *CallBackRef, u32 StatusEvent);
+
+#define XTTCPS_IXR_MATCH_0_MASK     0x00000002U
+#define XTTCPS_IXR_INTERVAL_MASK    0x00000001U
+
+    // counter value as seen from the firmware, computed from the simulated
+    // clock (see hostsim\HostSimTimer.c)
+#define XTtcPs_GetCounterValue(InstancePtr)     HostSim_TtcGetCounterValue(InstancePtr)
+
+u16 HostSim_TtcGetCounterValue(XTtcPs *InstancePtr);
+
+    // 1msec free running timer, read by the firmware as uwSysTimers1ms
+u16 HostSim_Timers1ms(void);
+
+#endif
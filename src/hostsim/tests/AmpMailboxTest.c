@@ -0,0 +1,195 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : AmpMailboxTest.c                                           */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Two thread test of the CPU0/CPU1 mailboxes: ordering,      */
+/*               payload integrity, full and oversize handling              */
+/*                                                                          */
+/****************************************************************************/
+
+#include <sched.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\AmpMailbox.h"
+#include "common\TaskScheduler.h"
+#include "core\Cpu1.h"
+#include "HostSim.h"
+#include "HostSimHal.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // messages exchanged by the two threads
+#define AMPMBOXTEST_MESSAGES            200000
+    // message codes
+#define AMPMBOXTEST_CODE_REQ            1
+#define AMPMBOXTEST_CODE_UNKNOWN        7
+
+//***************************************************************************
+// Locals
+
+    // CPU1 thread side, written by CPU1 only
+static volatile ULONG ulMboxTestCpu1Served;
+static volatile ULONG ulMboxTestCpu1Errors;
+static ULONG ulMboxTestCpu1Expected;
+    // CPU1 thread control
+static volatile BOOL bMboxTestStop;
+static volatile BOOL bMboxTestCpu1Done;
+
+//***************************************************************************
+// Payload pattern of message #, size varies with it
+
+static UWORD mboxtestfill(ULONG ulSeq, UBYTE * pubData)
+{
+    UWORD uwSize, i;
+
+    uwSize=(UWORD)(sizeof(ULONG)+ulSeq%(AMPMBOX_PAYLOAD_SIZE-sizeof(ULONG)+1));
+    memcpy(pubData, &ulSeq, sizeof(ULONG));
+    for(i=sizeof(ULONG);i<uwSize;i++)
+        pubData[i]=(UBYTE)(ulSeq*31+i);
+
+    return uwSize;
+}
+
+//***************************************************************************
+// CPU1 request handler: check sequence and payload, echo sequence to CPU0
+
+static void mboxtestrequest(const AMPMBOX_MSG * psMsg)
+{
+    UBYTE ubRef[AMPMBOX_PAYLOAD_SIZE];
+    ULONG ulSeq;
+    UWORD uwSize;
+
+    memcpy(&ulSeq, psMsg->ubData, sizeof(ULONG));
+    uwSize=mboxtestfill(ulMboxTestCpu1Expected, ubRef);
+    if(ulSeq!=ulMboxTestCpu1Expected || psMsg->uwSize!=uwSize || memcmp(psMsg->ubData, ubRef, uwSize)!=0)
+        ulMboxTestCpu1Errors++;
+    ulMboxTestCpu1Expected=ulSeq+1;
+
+        // CPU0 drains replies while posting, no deadlock; the host may
+        // have a single core, leave it to the other thread while waiting
+    while(!AmpMbox_Post(AMPMBOX_TOCPU0, AMPMBOXTEST_CODE_REQ, &ulSeq, sizeof(ULONG)))
+        sched_yield();
+    ulMboxTestCpu1Served++;
+}
+
+//***************************************************************************
+// CPU1 main: serve requests until stopped
+
+static void mboxtestcpu1(void)
+{
+    while(!bMboxTestStop)
+        if(AmpMbox_Serve(AMPMBOX_TOCPU1)==0)
+            sched_yield();
+
+    bMboxTestCpu1Done=TRUE;
+}
+
+//***************************************************************************
+// Fetch replies on CPU0, check order; return no. fetched
+
+static ULONG mboxtestreplies(ULONG * pulExpected, ULONG * pulErrors)
+{
+    AMPMBOX_MSG sMsg;
+    ULONG ulSeq, ulCnt=0;
+
+    while(AmpMbox_Fetch(AMPMBOX_TOCPU0, &sMsg))
+    {
+        memcpy(&ulSeq, sMsg.ubData, sizeof(ULONG));
+        if(sMsg.uwCode!=AMPMBOXTEST_CODE_REQ || sMsg.uwSize!=sizeof(ULONG) || ulSeq!=*pulExpected)
+            (*pulErrors)++;
+        *pulExpected=ulSeq+1;
+        ulCnt++;
+    }
+
+    return ulCnt;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    AMPMBOX_MSG sMsg;
+    UBYTE ubData[AMPMBOX_PAYLOAD_SIZE+1];
+    ULONG ulSeq, ulReplies, ulExpected, ulErrors, ulCnt;
+    UWORD uwSize, i;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+    HOSTSIMTEST_CHECK(TaskSched_Init());
+    HOSTSIMTEST_CHECK(AmpMbox_Init());
+    HOSTSIMTEST_CHECK(AmpMbox_SetHandler(AMPMBOX_TOCPU1, AMPMBOXTEST_CODE_REQ, &mboxtestrequest));
+    HOSTSIMTEST_CHECK(!AmpMbox_SetHandler(AMPMBOX_TOCPU1, AMPMBOX_CODES, &mboxtestrequest));
+    HOSTSIMTEST_CHECK(!AmpMbox_SetHandler(AMPMBOX_COUNT, AMPMBOXTEST_CODE_REQ, &mboxtestrequest));
+
+        // single thread: oversize payload rejected, full mailbox refuses posts
+    memset(ubData, 0x5A, sizeof(ubData));
+    HOSTSIMTEST_CHECK(!AmpMbox_Post(AMPMBOX_TOCPU1, AMPMBOXTEST_CODE_UNKNOWN, ubData, AMPMBOX_PAYLOAD_SIZE+1));
+    HOSTSIMTEST_CHECK(AmpMbox_Pending(AMPMBOX_TOCPU1)==0);
+    for(i=0;i<AMPMBOX_SLOTS;i++)
+        HOSTSIMTEST_CHECK(AmpMbox_Post(AMPMBOX_TOCPU1, AMPMBOXTEST_CODE_UNKNOWN, ubData, AMPMBOX_PAYLOAD_SIZE));
+    HOSTSIMTEST_CHECK(!AmpMbox_Post(AMPMBOX_TOCPU1, AMPMBOXTEST_CODE_UNKNOWN, ubData, 0));
+    HOSTSIMTEST_CHECK(AmpMbox_Pending(AMPMBOX_TOCPU1)==AMPMBOX_SLOTS);
+
+        // messages without handler are dropped, one mailbox round per call
+    HOSTSIMTEST_CHECK(AmpMbox_Serve(AMPMBOX_TOCPU1)==AMPMBOX_SLOTS);
+    HOSTSIMTEST_CHECK(AmpMbox_Pending(AMPMBOX_TOCPU1)==0);
+    HOSTSIMTEST_CHECK(!AmpMbox_Fetch(AMPMBOX_TOCPU1, &sMsg));
+    HOSTSIMTEST_CHECK(AmpMbox_Serve(AMPMBOX_TOCPU1)==0);
+
+        // payload round trip through a wrapped ring
+    for(ulSeq=0;ulSeq<3*AMPMBOX_SLOTS;ulSeq++)
+    {
+        uwSize=mboxtestfill(ulSeq, ubData);
+        HOSTSIMTEST_CHECK(AmpMbox_Post(AMPMBOX_TOCPU0, AMPMBOXTEST_CODE_UNKNOWN, ubData, uwSize));
+        HOSTSIMTEST_CHECK(AmpMbox_Fetch(AMPMBOX_TOCPU0, &sMsg));
+        HOSTSIMTEST_CHECK(sMsg.uwCode==AMPMBOXTEST_CODE_UNKNOWN && sMsg.uwSize==uwSize);
+        HOSTSIMTEST_CHECK(memcmp(sMsg.ubData, ubData, uwSize)==0);
+    }
+
+        // two threads: CPU1 serves requests and echoes them while CPU0 posts
+    Cpu1_Start(&mboxtestcpu1);
+    ulReplies=0;
+    ulExpected=0;
+    ulErrors=0;
+    for(ulSeq=0;ulSeq<AMPMBOXTEST_MESSAGES;ulSeq++)
+    {
+        uwSize=mboxtestfill(ulSeq, ubData);
+        while(!AmpMbox_Post(AMPMBOX_TOCPU1, AMPMBOXTEST_CODE_REQ, ubData, uwSize))
+        {
+            ulCnt=mboxtestreplies(&ulExpected, &ulErrors);
+            if(ulCnt==0)
+                sched_yield();
+            ulReplies+=ulCnt;
+        }
+        ulReplies+=mboxtestreplies(&ulExpected, &ulErrors);
+    }
+    while(ulReplies<AMPMBOXTEST_MESSAGES)
+    {
+        ulCnt=mboxtestreplies(&ulExpected, &ulErrors);
+        if(ulCnt==0)
+            sched_yield();
+        ulReplies+=ulCnt;
+    }
+
+    bMboxTestStop=TRUE;
+    while(!bMboxTestCpu1Done)
+        sched_yield();
+
+    HOSTSIMTEST_CHECK(ulReplies==AMPMBOXTEST_MESSAGES);
+    HOSTSIMTEST_CHECK(ulErrors==0);
+    HOSTSIMTEST_CHECK(ulExpected==AMPMBOXTEST_MESSAGES);
+    HOSTSIMTEST_CHECK(ulMboxTestCpu1Served==AMPMBOXTEST_MESSAGES);
+    HOSTSIMTEST_CHECK(ulMboxTestCpu1Errors==0);
+    HOSTSIMTEST_CHECK(AmpMbox_Pending(AMPMBOX_TOCPU0)==0 && AmpMbox_Pending(AMPMBOX_TOCPU1)==0);
+
+    printf("AmpMailboxTest: %lu round trips\n", (unsigned long)ulReplies);
+
+    return HOSTSIMTEST_RESULT("AmpMailboxTest");
+}
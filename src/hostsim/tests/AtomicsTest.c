@@ -0,0 +1,344 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : AtomicsTest.c                                              */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Atomics: seqlock and 64bit race detection with a writer    */
+/*               thread, bit writes, atomic_* copies, access cost           */
+/*                                                                          */
+/****************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\Atomics.h"
+#include "common\CommonUtility.h"
+#include "system\Os.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // words of the seqlock protected record
+#define ATOMTEST_WORDS                  16
+    // race: reads, reads between reader yields in the middle of a copy,
+    // writes between writer yields in the middle of a write
+#define ATOMTEST_READS                  2000000ul
+#define ATOMTEST_READER_YIELD           16
+#define ATOMTEST_WRITER_YIELD           4
+    // bit write race: writes per thread and yield period
+#define ATOMTEST_BITWRITES              200000ul
+#define ATOMTEST_BITWRITE_YIELD         64
+    // benchmark
+#define ATOMTEST_BENCH_LOOPS            1000000ul
+#define ATOMTEST_BENCH_RUNS             5
+
+//***************************************************************************
+// Structures
+
+typedef struct
+{
+    ULLNG   ullStamp;                   // value | ~value<<32, atomic_st64
+    ULONG   ulWord[ATOMTEST_WORDS];     // all equal to the write count
+} ATOMTEST_RECORD;
+
+//***************************************************************************
+// Locals
+
+static ATOMIC_SEQLOCK sAtomTestLock;
+static volatile ATOMTEST_RECORD sAtomTestShared __attribute__((aligned(8)));
+static volatile BOOL bAtomTestStop;
+static volatile ULONG ulAtomTestWrites;
+static volatile ULONG ulAtomTestBits;
+static ULONG ulAtomTestLost[2];
+static volatile ULONG ulAtomTestSink;
+
+//***************************************************************************
+// Writer thread: seqlock protected record, yielding in the middle of some
+// writes so that readers run against a half written record
+
+static void * atomtestwriter(void * pvArg)
+{
+    ULONG ulVal=0;
+    UWORD i;
+
+    (void)pvArg;
+    while(!bAtomTestStop)
+    {
+        ulVal++;
+        seqlock_write_begin(&sAtomTestLock);
+        for(i=0;i<ATOMTEST_WORDS/2;i++)
+            sAtomTestShared.ulWord[i]=ulVal;
+        if((ulVal%ATOMTEST_WRITER_YIELD)==0)
+            sched_yield();
+        for(;i<ATOMTEST_WORDS;i++)
+            sAtomTestShared.ulWord[i]=ulVal;
+        atomic_st64(&sAtomTestShared.ullStamp, ulVal|((ULLNG)~ulVal<<32));
+        seqlock_write_end(&sAtomTestLock);
+        ulAtomTestWrites=ulVal;
+        sched_yield();
+    }
+
+    return NULL;
+}
+
+//***************************************************************************
+// Reader copy, yielding in the middle if asked
+
+static void atomtestcopy(ULONG * pulDst, BOOL bYield)
+{
+    UWORD i;
+
+    for(i=0;i<ATOMTEST_WORDS/2;i++)
+        pulDst[i]=sAtomTestShared.ulWord[i];
+    if(bYield)
+        sched_yield();
+    for(;i<ATOMTEST_WORDS;i++)
+        pulDst[i]=sAtomTestShared.ulWord[i];
+}
+
+//***************************************************************************
+// Torn copy
+
+static BOOL atomtesttorn(const ULONG * pulWord)
+{
+    UWORD i;
+
+    for(i=1;i<ATOMTEST_WORDS;i++)
+        if(pulWord[i]!=pulWord[0])
+            return TRUE;
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Bit writer thread: own half word of a shared word, read back after each
+// write, a lost update shows as a different value
+
+static void * atomtestbitwriter(void * pvArg)
+{
+    ULONG ulIdx=(ULONG)(UINTPTR)pvArg;
+    ULONG ulShift=ulIdx*16;
+    ULONG ulMask=0xFFFFul<<ulShift;
+    ULONG ulCt, ulVal;
+
+    for(ulCt=0;ulCt<ATOMTEST_BITWRITES;ulCt++)
+    {
+        ulVal=(ulCt&0xFFFFul)<<ulShift;
+        atomic_wrbits32(&ulAtomTestBits, ulVal, ulMask);
+        if((ulAtomTestBits&ulMask)!=ulVal)
+            ulAtomTestLost[ulIdx]++;
+        if((ulCt%ATOMTEST_BITWRITE_YIELD)==0)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+//***************************************************************************
+// Single thread semantics of the atomic_* copies and bit writes
+
+static void atomtestcopies(void)
+{
+    static const UWORD uwSizes[]={ 1, 2, 3, 4, 5, 8 };
+    UBYTE ubSrc[32] __attribute__((aligned(8)));
+    UBYTE ubDst[32] __attribute__((aligned(8)));
+    UBYTE ubRef[32];
+    UWORD i, uwSize, uwOffset;
+    ULONG ulWord;
+    UWORD uwWord;
+    UBYTE ubByte;
+
+    for(i=0;i<sizeof(ubSrc);i++)
+        ubSrc[i]=(UBYTE)(i*37+11);
+
+        // aligned and misaligned, all sizes
+    for(uwSize=0;uwSize<sizeof(uwSizes)/sizeof(uwSizes[0]);uwSize++)
+        for(uwOffset=0;uwOffset<8;uwOffset++)
+        {
+            memset(ubDst, 0xA5, sizeof(ubDst));
+            memcpy(ubRef, ubDst, sizeof(ubRef));
+            memcpy(&ubRef[uwOffset], &ubSrc[8], uwSizes[uwSize]);
+            atomic_read(&ubDst[uwOffset], &ubSrc[8], uwSizes[uwSize]);
+            HOSTSIMTEST_CHECK(memcmp(ubDst, ubRef, sizeof(ubDst))==0);
+
+            memset(ubDst, 0xA5, sizeof(ubDst));
+            memcpy(&ubRef[uwOffset], &ubSrc[uwOffset], uwSizes[uwSize]);
+            atomic_write(&ubDst[uwOffset], &ubSrc[uwOffset], uwSizes[uwSize]);
+            HOSTSIMTEST_CHECK(memcmp(ubDst, ubRef, sizeof(ubDst))==0);
+
+            memset(ubDst, 0xA5, sizeof(ubDst));
+            memcpy(ubRef, ubDst, sizeof(ubRef));
+            memcpy(&ubRef[8], &ubSrc[uwOffset], uwSizes[uwSize]);
+            atomic_move(&ubDst[8], &ubSrc[uwOffset], uwSizes[uwSize]);
+            HOSTSIMTEST_CHECK(memcmp(ubDst, ubRef, sizeof(ubDst))==0);
+        }
+
+    memset(ubDst, 0, sizeof(ubDst));
+    atomic_read_chunk16(&ubDst[3], &ubSrc[5]);
+    HOSTSIMTEST_CHECK(memcmp(&ubDst[3], &ubSrc[5], ATOMIC_CHUCK16_SIZE)==0 && ubDst[2]==0 && ubDst[19]==0);
+
+        // bit writes return the new value, other bits untouched
+    ulWord=0x12345678ul;
+    HOSTSIMTEST_CHECK(atomic_long_set_bits(&ulWord, 0x80000001ul)==0x92345679ul && ulWord==0x92345679ul);
+    HOSTSIMTEST_CHECK(atomic_long_clear_bits(&ulWord, 0x12000008ul)==0x80345671ul && ulWord==0x80345671ul);
+    uwWord=0xF0F0;
+    HOSTSIMTEST_CHECK(atomic_write_bits(&uwWord, 0x0FFF, 0x00FF)==0xF0FF && uwWord==0xF0FF);
+    ubByte=0x5A;
+    HOSTSIMTEST_CHECK(atomic_byte_write_bits(&ubByte, 0x0F, 0x3C)==0x4E && ubByte==0x4E);
+}
+
+//***************************************************************************
+// Benchmark: best ns per read of the record, seqlock against memcpy in a
+// critical section, and of a 64bit value, atomic_read against the same
+
+static void atomtestbench(void)
+{
+    ATOMTEST_RECORD sCopy;
+    ULLNG ullVal=0, ullStart, ullTime;
+    double dSeq=1e30, dCrit=1e30, dRead64=1e30, dCrit64=1e30;
+    ULONG ulCt;
+    UWORD uwRun;
+
+    for(uwRun=0;uwRun<ATOMTEST_BENCH_RUNS;uwRun++)
+    {
+        ullStart=HostSim_GetTime();
+        for(ulCt=0;ulCt<ATOMTEST_BENCH_LOOPS;ulCt++)
+        {
+            seqlock_read(&sAtomTestLock, &sCopy, (const void *)&sAtomTestShared, sizeof(sCopy));
+            ulAtomTestSink+=sCopy.ulWord[0];
+        }
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime*100.0/ATOMTEST_BENCH_LOOPS<dSeq)
+            dSeq=ullTime*100.0/ATOMTEST_BENCH_LOOPS;
+
+        ullStart=HostSim_GetTime();
+        for(ulCt=0;ulCt<ATOMTEST_BENCH_LOOPS;ulCt++)
+        {
+            Os_BeginCriticalSection(OS_CRITSECT_GLOBAL);
+            memcpy(&sCopy, (const void *)&sAtomTestShared, sizeof(sCopy));
+            Os_EndCriticalSection(OS_CRITSECT_GLOBAL);
+            ulAtomTestSink+=sCopy.ulWord[0];
+        }
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime*100.0/ATOMTEST_BENCH_LOOPS<dCrit)
+            dCrit=ullTime*100.0/ATOMTEST_BENCH_LOOPS;
+
+        ullStart=HostSim_GetTime();
+        for(ulCt=0;ulCt<ATOMTEST_BENCH_LOOPS;ulCt++)
+        {
+            atomic_read(&ullVal, (HPVOID)&sAtomTestShared.ullStamp, sizeof(ullVal));
+            ulAtomTestSink+=(ULONG)ullVal;
+        }
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime*100.0/ATOMTEST_BENCH_LOOPS<dRead64)
+            dRead64=ullTime*100.0/ATOMTEST_BENCH_LOOPS;
+
+        ullStart=HostSim_GetTime();
+        for(ulCt=0;ulCt<ATOMTEST_BENCH_LOOPS;ulCt++)
+        {
+            Os_BeginCriticalSection(OS_CRITSECT_GLOBAL);
+            memcpy(&ullVal, (const void *)&sAtomTestShared.ullStamp, sizeof(ullVal));
+            Os_EndCriticalSection(OS_CRITSECT_GLOBAL);
+            ulAtomTestSink+=(ULONG)ullVal;
+        }
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime*100.0/ATOMTEST_BENCH_LOOPS<dCrit64)
+            dCrit64=ullTime*100.0/ATOMTEST_BENCH_LOOPS;
+    }
+
+    printf("AtomicsTest: record %.2f ns seqlock, %.2f ns critical section; 64bit %.2f ns atomic_read, %.2f ns critical section\n",
+        dSeq, dCrit, dRead64, dCrit64);
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    pthread_t sThread[2];
+    ULONG ulCopy[ATOMTEST_WORDS];
+    ATOMTEST_RECORD sCopy;
+    ULONG ulRead, ulSeq, ulRetries, ulTorn, ulTornPlain, ulFailed, ulStamp;
+    BOOL bYield;
+    ULLNG ullStamp;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+    atomtestcopies();
+
+        // sequence: a write during the read, or running, asks a retry
+    seqlock_init(&sAtomTestLock);
+    ulSeq=seqlock_read_begin(&sAtomTestLock);
+    HOSTSIMTEST_CHECK(!seqlock_read_retry(&sAtomTestLock, ulSeq));
+    seqlock_write_begin(&sAtomTestLock);
+    HOSTSIMTEST_CHECK(seqlock_read_retry(&sAtomTestLock, ulSeq));
+    HOSTSIMTEST_CHECK(seqlock_read_retry(&sAtomTestLock, seqlock_read_begin(&sAtomTestLock)));
+    HOSTSIMTEST_CHECK(!seqlock_read(&sAtomTestLock, &sCopy, (const void *)&sAtomTestShared, sizeof(sCopy)));
+    seqlock_write_end(&sAtomTestLock);
+    HOSTSIMTEST_CHECK(seqlock_read_retry(&sAtomTestLock, ulSeq));
+    HOSTSIMTEST_CHECK(seqlock_read(&sAtomTestLock, &sCopy, (const void *)&sAtomTestShared, sizeof(sCopy)));
+
+        // race against the writer thread: seqlock copies are never torn,
+        // plain copies are (the race is real), 64bit stamps never
+    seqlock_init(&sAtomTestLock);
+    bAtomTestStop=FALSE;
+    HOSTSIMTEST_CHECK(pthread_create(&sThread[0], NULL, &atomtestwriter, NULL)==0);
+    ulRetries=ulTorn=ulTornPlain=ulFailed=ulStamp=0;
+    for(ulRead=0;ulRead<ATOMTEST_READS;ulRead++)
+    {
+            // the writer runs in the middle of the first attempt only, the
+            // retries yield before the copy to let a pending write complete
+        bYield=((ulRead%ATOMTEST_READER_YIELD)==0);
+        do
+        {
+            ulSeq=seqlock_read_begin(&sAtomTestLock);
+            atomtestcopy(ulCopy, bYield);
+            if(!seqlock_read_retry(&sAtomTestLock, ulSeq))
+                break;
+            ulRetries++;
+            bYield=FALSE;
+            sched_yield();
+        }
+        while(TRUE);
+        ulTorn+=atomtesttorn(ulCopy);
+
+        atomtestcopy(ulCopy, (ulRead%ATOMTEST_READER_YIELD)==1);
+        ulTornPlain+=atomtesttorn(ulCopy);
+
+        if(seqlock_read(&sAtomTestLock, &sCopy, (const void *)&sAtomTestShared, sizeof(sCopy)))
+            ulTorn+=atomtesttorn(sCopy.ulWord);
+        else
+            ulFailed++;
+
+        ullStamp=atomic_ld64(&sAtomTestShared.ullStamp);
+        ulStamp+=((ULONG)(ullStamp>>32)!=(ULONG)~(ULONG)ullStamp && ullStamp!=0);
+    }
+    bAtomTestStop=TRUE;
+    pthread_join(sThread[0], NULL);
+
+    printf("AtomicsTest: %lu reads, %lu writes, %lu retries, %lu torn plain copies, %lu bounded reads given up\n",
+        (unsigned long)ATOMTEST_READS, (unsigned long)ulAtomTestWrites, (unsigned long)ulRetries,
+        (unsigned long)ulTornPlain, (unsigned long)ulFailed);
+    HOSTSIMTEST_CHECK(ulTorn==0);
+    HOSTSIMTEST_CHECK(ulStamp==0);
+    HOSTSIMTEST_CHECK(ulRetries>0 && ulTornPlain>0);
+
+        // two threads writing their half of the same word
+    ulAtomTestBits=0;
+    HOSTSIMTEST_CHECK(pthread_create(&sThread[0], NULL, &atomtestbitwriter, (void *)0)==0);
+    HOSTSIMTEST_CHECK(pthread_create(&sThread[1], NULL, &atomtestbitwriter, (void *)1)==0);
+    pthread_join(sThread[0], NULL);
+    pthread_join(sThread[1], NULL);
+    HOSTSIMTEST_CHECK(ulAtomTestLost[0]==0 && ulAtomTestLost[1]==0);
+    HOSTSIMTEST_CHECK(ulAtomTestBits==(((ATOMTEST_BITWRITES-1)&0xFFFFul)*0x10001ul));
+
+    atomtestbench();
+
+    return HOSTSIMTEST_RESULT("AtomicsTest");
+}
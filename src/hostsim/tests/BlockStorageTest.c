@@ -0,0 +1,312 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : BlockStorageTest.c                                         */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Block storage index: RAM image with head and tail blocks,  */
+/*               corrupted and truncated blocks, appends, lookup speed      */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\BlockStorage.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // image size, blocks, codes and max data size (bytes, even)
+#define BLKTEST_IMAGE_WORDS             32768
+#define BLKTEST_BLOCKS                  600
+#define BLKTEST_CODES                   150
+#define BLKTEST_DATA_MAX                200
+    // every n-th block is corrupted (one data byte), every n-th is a tail
+    // block, every n-th is followed by erased words
+#define BLKTEST_CORRUPT_EVERY           37
+#define BLKTEST_TAIL_EVERY              5
+#define BLKTEST_GAP_EVERY               11
+    // undersized index table
+#define BLKTEST_SMALL_ENTRIES           64
+    // benchmark runs
+#define BLKTEST_BENCH_RUNS              5
+
+//***************************************************************************
+// Structures
+
+    // block as stored, valid ones in storage order
+typedef struct
+{
+    UWORD * puwHead;                    // header
+    UBYTE * pubData;                    // data
+    UWORD   uwSize;                     // data size
+    SWORD   swCode;
+} BLKTEST_BLOCK;
+
+//***************************************************************************
+// Locals
+
+static UWORD uwBlkTestImage[BLKTEST_IMAGE_WORDS];
+static ULONG ulBlkTestCursor;               // words
+static ULONG ulBlkTestSeed=0x13579BDFul;
+
+static BLKTEST_BLOCK sBlkTestValid[BLKTEST_BLOCKS+4];
+static UWORD uwBlkTestValid;
+    // last valid block of each code, index in sBlkTestValid (0xFFFF none)
+static UWORD uwBlkTestLast[BLKTEST_CODES+1];
+    // last valid block of code 1 before the truncated one
+static UWORD uwBlkTestLastTrunc;
+
+static BLKSTOR_INDEX_ENTRY sBlkTestEntries[BLKTEST_BLOCKS+4];
+static BLKSTOR_INDEX_ENTRY sBlkTestSmall[BLKTEST_SMALL_ENTRIES];
+static UBYTE ubBlkTestBuf[BLKTEST_DATA_MAX];
+static volatile SLONG slBlkTestSink;
+
+//***************************************************************************
+// Random
+
+static ULONG blktestrand(void)
+{
+    ulBlkTestSeed=ulBlkTestSeed*1664525ul+1013904223ul;
+
+    return ulBlkTestSeed>>8;
+}
+
+//***************************************************************************
+// Block data: random words, none equal to a block signature
+
+static void blktestfill(UWORD * puwData, UWORD uwSize)
+{
+    UWORD i, uwVal;
+
+    for(i=0;i<uwSize/sizeof(UWORD);i++)
+    {
+        do
+            uwVal=(UWORD)blktestrand();
+        while(uwVal==BLKSTOR_SIGN_HEAD || uwVal==BLKSTOR_SIGN_TAIL);
+        puwData[i]=uwVal;
+    }
+}
+
+//***************************************************************************
+// Append a block at the cursor, head (header+data) or tail (data+header);
+// a valid one is recorded, header pointer returned
+
+static UWORD * blktestappend(SWORD swCode, UWORD uwSize, BOOL bTail, BOOL bValid)
+{
+    BLKSTOR_HEADER sHead;
+    UWORD * puwHead;
+    UWORD * puwData;
+    UWORD uwWords=sizeof(BLKSTOR_HEADER)/sizeof(UWORD);
+
+    if(bTail)
+    {
+        puwData=&uwBlkTestImage[ulBlkTestCursor];
+        puwHead=&puwData[uwSize/sizeof(UWORD)];
+        blktestfill(puwData, uwSize);
+        blkstor_tail_begin(&sHead, swCode);
+        blkstor_tail_addata(&sHead, puwData, uwSize/2);
+        blkstor_tail_addata(&sHead, (UBYTE *)puwData+uwSize/2, uwSize-uwSize/2);
+        blkstor_tail_end(&sHead);
+    }
+    else
+    {
+        puwHead=&uwBlkTestImage[ulBlkTestCursor];
+        puwData=&puwHead[uwWords];
+        blktestfill(puwData, uwSize);
+        blkstor_createheader(swCode, puwData, uwSize, &sHead);
+    }
+    memcpy(puwHead, &sHead, sizeof(sHead));
+    ulBlkTestCursor+=uwWords+uwSize/sizeof(UWORD);
+
+    if(bValid)
+    {
+        sBlkTestValid[uwBlkTestValid].puwHead=puwHead;
+        sBlkTestValid[uwBlkTestValid].pubData=(UBYTE *)puwData;
+        sBlkTestValid[uwBlkTestValid].uwSize=uwSize;
+        sBlkTestValid[uwBlkTestValid].swCode=swCode;
+        uwBlkTestLast[swCode]=uwBlkTestValid++;
+    }
+    else
+        ((UBYTE *)puwData)[uwSize/2]^=0x40;
+
+    return puwHead;
+}
+
+//***************************************************************************
+// Image: head and tail blocks, duplicated codes, corrupted blocks and
+// erased gaps; the last block is truncated by the returned area size
+
+static ULONG blktestimage(void)
+{
+    UWORD uwBlk, uwSize;
+    SWORD swCode;
+
+    memset(uwBlkTestImage, 0xFF, sizeof(uwBlkTestImage));
+    memset(uwBlkTestLast, 0xFF, sizeof(uwBlkTestLast));
+    ulBlkTestCursor=0;
+    uwBlkTestValid=0;
+
+    for(uwBlk=1;uwBlk<=BLKTEST_BLOCKS;uwBlk++)
+    {
+        swCode=(SWORD)(1+blktestrand()%BLKTEST_CODES);
+        uwSize=(UWORD)(2+2*(blktestrand()%(BLKTEST_DATA_MAX/2)));
+        blktestappend(swCode, uwSize, (uwBlk%BLKTEST_TAIL_EVERY)==0, (uwBlk%BLKTEST_CORRUPT_EVERY)!=0);
+        if((uwBlk%BLKTEST_GAP_EVERY)==0)
+            ulBlkTestCursor+=1+blktestrand()%8;
+    }
+
+        // truncated: a sound block with header and half of the data inside
+        // the area, recorded as the last valid one of the whole image
+    uwBlkTestLastTrunc=uwBlkTestLast[1];
+    blktestappend(1, BLKTEST_DATA_MAX, FALSE, TRUE);
+
+    return (ulBlkTestCursor*sizeof(UWORD))-BLKTEST_DATA_MAX/2;
+}
+
+//***************************************************************************
+// Index against the image: enumeration in storage order, last block of
+// each code, missing codes
+
+static void blktestcheck(const BLKSTOR_INDEX * psIndex)
+{
+    ULONG ulPos=0;
+    void * pvBlk;
+    void * pvData;
+    UWORD i, uwMismatch=0;
+    SWORD swCode, swSize;
+
+    for(i=0;i<uwBlkTestValid;i++)
+    {
+        swCode=blkstor_index_enum(psIndex, &ulPos, &pvBlk);
+        uwMismatch+=(swCode!=sBlkTestValid[i].swCode || pvBlk!=(void *)sBlkTestValid[i].puwHead);
+        swSize=blkstor_index_read(pvBlk, ubBlkTestBuf, sizeof(ubBlkTestBuf), &pvData);
+        uwMismatch+=(swSize!=(SWORD)sBlkTestValid[i].uwSize || pvData!=(void *)sBlkTestValid[i].pubData);
+    }
+    HOSTSIMTEST_CHECK(blkstor_index_enum(psIndex, &ulPos, &pvBlk)==BLKSTOR_ERR_NOTFOUND && pvBlk==NULL);
+    HOSTSIMTEST_CHECK(uwMismatch==0);
+
+    for(swCode=1;swCode<=BLKTEST_CODES;swCode++)
+    {
+        if(uwBlkTestLast[swCode]==0xFFFF)
+        {
+            uwMismatch+=(blkstor_index_getdata(psIndex, swCode, ubBlkTestBuf, sizeof(ubBlkTestBuf))!=BLKSTOR_ERR_NOTFOUND);
+            continue;
+        }
+
+        i=uwBlkTestLast[swCode];
+        swSize=blkstor_index_getdata(psIndex, swCode, ubBlkTestBuf, sizeof(ubBlkTestBuf));
+        uwMismatch+=(swSize!=(SWORD)sBlkTestValid[i].uwSize || memcmp(ubBlkTestBuf, sBlkTestValid[i].pubData, sBlkTestValid[i].uwSize)!=0);
+        swSize=blkstor_index_getaddr(psIndex, swCode, &pvData);
+        uwMismatch+=(swSize!=(SWORD)sBlkTestValid[i].uwSize || pvData!=(void *)sBlkTestValid[i].pubData);
+    }
+    HOSTSIMTEST_CHECK(uwMismatch==0);
+    HOSTSIMTEST_CHECK(blkstor_index_getdata(psIndex, BLKTEST_CODES+1, NULL, 0)==BLKSTOR_ERR_NOTFOUND);
+    HOSTSIMTEST_CHECK(blkstor_index_getdata(psIndex, 0, NULL, 0)==BLKSTOR_ERR_INVALIDSELBLK);
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    BLKSTOR_INDEX sIndex, sSmall;
+    void * pvStor;
+    void * pvBlk;
+    ULONG ulImage, ulLeft;
+    UWORD * puwHead;
+    UWORD i, uwCorrupt, uwLastTrunc;
+    SWORD swCode, swSize, swBig=0;
+    ULLNG ullStart, ullScan, ullIndex, ullBuild;
+    UWORD uwRun;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+    ulImage=blktestimage();
+
+        // truncated block out of the reference up to the appends
+    uwBlkTestValid--;
+    uwLastTrunc=uwBlkTestLast[1];
+    uwBlkTestLast[1]=uwBlkTestLastTrunc;
+
+        // legacy walk sees the same valid blocks in the same order
+    pvStor=uwBlkTestImage;
+    ulLeft=ulImage;
+    for(i=0;(swCode=blkstor_enumvalid(&pvStor, &ulLeft, &pvBlk))>0;i++)
+        HOSTSIMTEST_CHECK(i<uwBlkTestValid && swCode==sBlkTestValid[i].swCode && pvBlk==(void *)sBlkTestValid[i].puwHead);
+    HOSTSIMTEST_CHECK(i==uwBlkTestValid);
+    uwCorrupt=BLKTEST_BLOCKS-uwBlkTestValid;
+    HOSTSIMTEST_CHECK(uwCorrupt==BLKTEST_BLOCKS/BLKTEST_CORRUPT_EVERY);
+
+        // index
+    HOSTSIMTEST_CHECK(blkstor_index_build(&sIndex, uwBlkTestImage, ulImage, sBlkTestEntries, BLKTEST_BLOCKS+4)==(SWORD)uwBlkTestValid);
+    blktestcheck(&sIndex);
+
+        // size checks: destination smaller than the block
+    for(swCode=1;swCode<=BLKTEST_CODES;swCode++)
+        if(uwBlkTestLast[swCode]!=0xFFFF && sBlkTestValid[uwBlkTestLast[swCode]].uwSize>2)
+        {
+            swBig=swCode;
+            break;
+        }
+    HOSTSIMTEST_CHECK(swBig>0 && blkstor_index_getdata(&sIndex, swBig, ubBlkTestBuf, 2)==BLKSTOR_ERR_INVALIDSIZE);
+
+        // appends into the erased end of an index built on the whole
+        // area, where the truncated block is complete: a head and a tail
+        // block, a corrupted one is rejected
+    uwBlkTestValid++;
+    uwBlkTestLast[1]=uwLastTrunc;
+    HOSTSIMTEST_CHECK(blkstor_index_build(&sIndex, uwBlkTestImage, sizeof(uwBlkTestImage), sBlkTestEntries, BLKTEST_BLOCKS+4)==(SWORD)uwBlkTestValid);
+    ulBlkTestCursor=(ulImage+BLKTEST_DATA_MAX/2)/sizeof(UWORD);
+    puwHead=blktestappend(7, 40, FALSE, TRUE);
+    HOSTSIMTEST_CHECK(blkstor_index_add(&sIndex, puwHead)==7);
+    puwHead=blktestappend(BLKTEST_CODES, 60, TRUE, TRUE);
+    HOSTSIMTEST_CHECK(blkstor_index_add(&sIndex, puwHead)==BLKTEST_CODES);
+    puwHead=blktestappend(9, 20, FALSE, FALSE);
+    HOSTSIMTEST_CHECK(blkstor_index_add(&sIndex, puwHead)<0);
+    HOSTSIMTEST_CHECK(blkstor_index_add(&sIndex, &uwBlkTestImage[BLKTEST_IMAGE_WORDS-1])==BLKSTOR_ERR_NOTFOUND);
+    ulImage=ulBlkTestCursor*sizeof(UWORD);
+    blktestcheck(&sIndex);
+
+        // rebuilt on the used part of the area: same content
+    HOSTSIMTEST_CHECK(blkstor_index_build(&sIndex, uwBlkTestImage, ulImage, sBlkTestEntries, BLKTEST_BLOCKS+4)==(SWORD)uwBlkTestValid);
+    blktestcheck(&sIndex);
+
+        // undersized table: reported, lookups and enumeration still right
+    HOSTSIMTEST_CHECK(blkstor_index_build(&sSmall, uwBlkTestImage, ulImage, sBlkTestSmall, BLKTEST_SMALL_ENTRIES)==BLKSTOR_ERR_INDEXFULL);
+    HOSTSIMTEST_CHECK(sSmall.bOverflow);
+    blktestcheck(&sSmall);
+
+        // benchmark: all codes by area scan, by index, and index build
+    ullScan=ullIndex=ullBuild=~0ull;
+    for(uwRun=0;uwRun<BLKTEST_BENCH_RUNS;uwRun++)
+    {
+        ullStart=HostSim_GetTime();
+        for(swCode=1;swCode<=BLKTEST_CODES;swCode++)
+            slBlkTestSink+=blkstor_getdata(uwBlkTestImage, ulImage, swCode, ubBlkTestBuf, sizeof(ubBlkTestBuf));
+        if(HostSim_GetTime()-ullStart<ullScan)
+            ullScan=HostSim_GetTime()-ullStart;
+
+        ullStart=HostSim_GetTime();
+        for(swCode=1;swCode<=BLKTEST_CODES;swCode++)
+            slBlkTestSink+=blkstor_index_getdata(&sIndex, swCode, ubBlkTestBuf, sizeof(ubBlkTestBuf));
+        if(HostSim_GetTime()-ullStart<ullIndex)
+            ullIndex=HostSim_GetTime()-ullStart;
+
+        ullStart=HostSim_GetTime();
+        swSize=blkstor_index_build(&sIndex, uwBlkTestImage, ulImage, sBlkTestEntries, BLKTEST_BLOCKS+4);
+        if(HostSim_GetTime()-ullStart<ullBuild)
+            ullBuild=HostSim_GetTime()-ullStart;
+        slBlkTestSink+=swSize;
+    }
+    printf("BlockStorageTest: %u blocks (%u corrupted, 1 truncated), %lu bytes; %u lookups %.1f us by scan, %.1f us by index, build %.1f us\n",
+        (unsigned)uwBlkTestValid, (unsigned)uwCorrupt, (unsigned long)ulImage, (unsigned)BLKTEST_CODES,
+        ullScan/10.0, ullIndex/10.0, ullBuild/10.0);
+    HOSTSIMTEST_CHECK(ullBuild+ullIndex<ullScan);
+
+    return HOSTSIMTEST_RESULT("BlockStorageTest");
+}
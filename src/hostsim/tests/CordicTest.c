@@ -0,0 +1,182 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : CordicTest.c                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Division free angle/magnitude grades: error against        */
+/*               atan2/hypot and cycles against the table versions          */
+/*                                                                          */
+/****************************************************************************/
+
+#include <math.h>
+
+#include "common\CommonDefines.h"
+#include "common\MathFunctions.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // random vectors
+#define CORDICTEST_VECTORS              2000000ul
+    // benchmark vectors and runs
+#define CORDICTEST_BENCH_VECTORS        4096
+#define CORDICTEST_BENCH_RUNS           20
+    // grades under test
+#define CORDICTEST_GRADES               4
+
+//***************************************************************************
+// Locals
+
+static const UWORD uwCordicTestGrade[CORDICTEST_GRADES]=
+{
+    MATH_GRADE_LUT, MATH_GRADE_COARSE, MATH_GRADE_MEDIUM, MATH_GRADE_FINE
+};
+static const char * const pcCordicTestGradeName[CORDICTEST_GRADES]=
+{
+    "LUT", "COARSE", "MEDIUM", "FINE"
+};
+
+    // documented errors, angle and magnitude in lsb
+static const double dCordicTestAngleTol[CORDICTEST_GRADES]={ 2.6, 21.0, 3.1, 1.0 };
+static const double dCordicTestMagTol[CORDICTEST_GRADES]={ 64.0, 1.0, 1.0, 1.0 };
+
+static ULONG ulCordicTestSeed=0x2545F491ul;
+
+static SWORD swCordicTestSin[CORDICTEST_BENCH_VECTORS];
+static SWORD swCordicTestCos[CORDICTEST_BENCH_VECTORS];
+static volatile ULONG ulCordicTestSink;
+
+//***************************************************************************
+// Random vector, amplitude spread from a few lsb to full scale as a sin/cos
+// encoder signal with gain drift
+
+static void cordictestvector(SWORD * pswSin, SWORD * pswCos)
+{
+    double dAngle, dAmp;
+
+    ulCordicTestSeed=ulCordicTestSeed*1664525ul+1013904223ul;
+    dAngle=(double)ulCordicTestSeed*2.0*M_PI/4294967296.0;
+    ulCordicTestSeed=ulCordicTestSeed*1664525ul+1013904223ul;
+    dAmp=32767.0*pow(2.0, -8.0*(double)(ulCordicTestSeed>>16)/65536.0);
+
+    *pswSin=(SWORD)lround(dAmp*sin(dAngle));
+    *pswCos=(SWORD)lround(dAmp*cos(dAngle));
+}
+
+//***************************************************************************
+// Benchmark: best ns per call of angle and of angle plus magnitude; the
+// host divides in hardware, the Cortex-A9 calls the library division, so
+// the table version is favoured here
+
+static void cordictestbench(UWORD uwGrade, double * pdAngle, double * pdPolar)
+{
+    MATH_POLAR sPolar;
+    ULLNG ullStart, ullAngle, ullPolar, ullTime;
+    UWORD i, uwRun;
+
+    ullAngle=ullPolar=~0ull;
+    for(uwRun=0;uwRun<CORDICTEST_BENCH_RUNS;uwRun++)
+    {
+        ullStart=HostSim_GetTime();
+        for(i=0;i<CORDICTEST_BENCH_VECTORS;i++)
+            ulCordicTestSink+=ATan16Grade(swCordicTestSin[i], swCordicTestCos[i], uwGrade);
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullAngle)
+            ullAngle=ullTime;
+
+        ullStart=HostSim_GetTime();
+        if(uwGrade==MATH_GRADE_LUT)
+            for(i=0;i<CORDICTEST_BENCH_VECTORS;i++)
+                ulCordicTestSink+=ATan16(swCordicTestSin[i], swCordicTestCos[i])+CalculateSquareRoot(swCordicTestSin[i], swCordicTestCos[i]);
+        else
+            for(i=0;i<CORDICTEST_BENCH_VECTORS;i++)
+            {
+                CordicPolar16(swCordicTestSin[i], swCordicTestCos[i], uwGrade, &sPolar);
+                ulCordicTestSink+=sPolar.uwAngle+sPolar.uwMagnitude;
+            }
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullPolar)
+            ullPolar=ullTime;
+    }
+
+    *pdAngle=(double)ullAngle*100.0/CORDICTEST_BENCH_VECTORS;
+    *pdPolar=(double)ullPolar*100.0/CORDICTEST_BENCH_VECTORS;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    MATH_POLAR sPolar;
+    SWORD swSin, swCos;
+    UWORD uwAngle, uwMag, uwGrade;
+    double dRefAngle, dRefMag, dErr, dAngleNs, dPolarNs;
+    double dMaxAngle[CORDICTEST_GRADES], dMaxMag[CORDICTEST_GRADES];
+    ULONG ulVec, ulMismatch;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+
+        // error of every grade on the same vectors
+    for(uwGrade=0;uwGrade<CORDICTEST_GRADES;uwGrade++)
+        dMaxAngle[uwGrade]=dMaxMag[uwGrade]=0.0;
+    ulMismatch=0;
+    for(ulVec=0;ulVec<CORDICTEST_VECTORS;ulVec++)
+    {
+        cordictestvector(&swSin, &swCos);
+        dRefAngle=atan2((double)swSin, (double)swCos)*65536.0/(2.0*M_PI);
+        dRefMag=2.0*hypot((double)swSin, (double)swCos);
+        if(dRefMag>65535.0)
+            dRefMag=65535.0;
+
+        for(uwGrade=0;uwGrade<CORDICTEST_GRADES;uwGrade++)
+        {
+            uwAngle=ATan16Grade(swSin, swCos, uwCordicTestGrade[uwGrade]);
+            uwMag=Magnitude16Grade(swSin, swCos, uwCordicTestGrade[uwGrade]);
+
+                // angle error modulo one turn
+            dErr=fmod(fabs((double)uwAngle-dRefAngle), 65536.0);
+            if(dErr>32768.0)
+                dErr=65536.0-dErr;
+            if(dErr>dMaxAngle[uwGrade])
+                dMaxAngle[uwGrade]=dErr;
+
+            dErr=fabs((double)uwMag-dRefMag);
+            if(dErr>dMaxMag[uwGrade])
+                dMaxMag[uwGrade]=dErr;
+
+                // one pass gives both, as the two single calls
+            if(uwCordicTestGrade[uwGrade]!=MATH_GRADE_LUT)
+            {
+                CordicPolar16(swSin, swCos, uwCordicTestGrade[uwGrade], &sPolar);
+                ulMismatch+=(sPolar.uwAngle!=uwAngle || sPolar.uwMagnitude!=uwMag);
+            }
+        }
+    }
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+    HOSTSIMTEST_CHECK(ATan16Grade(0, 1000, MATH_GRADE_FINE)==0);
+    HOSTSIMTEST_CHECK(ATan16Grade(1000, 0, MATH_GRADE_FINE)==0x4000);
+    HOSTSIMTEST_CHECK(ATan16Grade(0, -1000, MATH_GRADE_FINE)==0x8000);
+    HOSTSIMTEST_CHECK(ATan16Grade(-1000, 0, MATH_GRADE_FINE)==0xC000);
+
+        // cycles on vectors of the same population
+    for(ulVec=0;ulVec<CORDICTEST_BENCH_VECTORS;ulVec++)
+        cordictestvector(&swCordicTestSin[ulVec], &swCordicTestCos[ulVec]);
+
+    for(uwGrade=0;uwGrade<CORDICTEST_GRADES;uwGrade++)
+    {
+        HOSTSIMTEST_CHECK(dMaxAngle[uwGrade]<=dCordicTestAngleTol[uwGrade]);
+        HOSTSIMTEST_CHECK(dMaxMag[uwGrade]<=dCordicTestMagTol[uwGrade]);
+
+        cordictestbench(uwCordicTestGrade[uwGrade], &dAngleNs, &dPolarNs);
+        printf("CordicTest: %-6s angle %5.2f lsb, magnitude %5.2f lsb, angle %5.1f ns, angle+magnitude %5.1f ns\n",
+            pcCordicTestGradeName[uwGrade], dMaxAngle[uwGrade], dMaxMag[uwGrade], dAngleNs, dPolarNs);
+    }
+
+    return HOSTSIMTEST_RESULT("CordicTest");
+}
@@ -0,0 +1,225 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : CrcTest.c                                                  */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : CRC module: bit-identical output against the legacy and    */
+/*               reference routines, streaming against one shot, speed      */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\CommonUtility.h"
+#include "common\Crc.h"
+#include "bus\modbus\ModbusOverSerial.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // random buffers, up to the max length, at every alignment
+#define CRCTEST_BUFFERS                 4000
+#define CRCTEST_MAXLEN                  1100
+    // benchmark: parameter image size and runs
+#define CRCTEST_BENCH_SIZE              65536ul
+#define CRCTEST_BENCH_RUNS              10
+    // minimum speed-up of crc16() on the byte table loop it replaced
+#define CRCTEST_BENCH_MINGAIN           2.0
+
+//***************************************************************************
+// Locals
+
+static ULONG ulCrcTestSeed=0xC0FFEE11ul;
+static UBYTE ubCrcTestBuf[CRCTEST_MAXLEN+8];
+static UBYTE ubCrcTestImage[CRCTEST_BENCH_SIZE];
+static UWORD uwCrcTestTable16[256];
+static volatile ULONG ulCrcTestSink;
+
+    // standard check input
+static const UBYTE ubCrcTestCheck[]="123456789";
+
+//***************************************************************************
+// Reference routines: the legacy bit by bit CRC-8 of the ESC info and
+// STGAP4S, bit by bit reflected CRC-16 and CRC-32
+
+static UBYTE crctestref8(UBYTE ubCrc, const UBYTE * pubData, ULONG ulLen)
+{
+    ULONG i, j, selbit, crc=ubCrc;
+
+    for(i=0;i<ulLen;i++)
+        for(j=0x80;j;j>>=1)
+        {
+            selbit=crc&0x80;
+            crc<<=1;
+            if(pubData[i]&j)
+                selbit^=0x80;
+            if(selbit)
+                crc^=0x07;
+        }
+
+    return (UBYTE)crc;
+}
+
+static UWORD crctestref16(UWORD uwCrc, const UBYTE * pubData, ULONG ulLen)
+{
+    ULONG i;
+    UWORD j;
+
+    for(i=0;i<ulLen;i++)
+    {
+        uwCrc^=pubData[i];
+        for(j=0;j<8;j++)
+            uwCrc=(uwCrc&1) ? (UWORD)((uwCrc>>1)^0xA001) : (UWORD)(uwCrc>>1);
+    }
+
+    return uwCrc;
+}
+
+static ULONG crctestref32(ULONG ulCrc, const UBYTE * pubData, ULONG ulLen)
+{
+    ULONG i;
+    UWORD j;
+
+    for(i=0;i<ulLen;i++)
+    {
+        ulCrc^=pubData[i];
+        for(j=0;j<8;j++)
+            ulCrc=(ulCrc&1) ? (ulCrc>>1)^0xEDB88320ul : ulCrc>>1;
+    }
+
+    return ulCrc;
+}
+
+//***************************************************************************
+// Legacy crc16(): one table lookup per byte
+
+static UWORD crctestlegacy16(UWORD uwCrc, const UBYTE * pubData, ULONG ulLen)
+{
+    while(ulLen--)
+        uwCrc=(uwCrc>>8)^uwCrcTestTable16[(uwCrc^*pubData++)&0xFF];
+
+    return uwCrc;
+}
+
+//***************************************************************************
+// Random byte
+
+static UBYTE crctestrand(void)
+{
+    ulCrcTestSeed=ulCrcTestSeed*1664525ul+1013904223ul;
+
+    return (UBYTE)(ulCrcTestSeed>>24);
+}
+
+//***************************************************************************
+// Streaming in random chunks against one shot; return no. of mismatches
+
+static ULONG crcteststream(UWORD uwType, const UBYTE * pubData, ULONG ulLen, ULONG ulOneShot)
+{
+    CRC_CTX sCtx;
+    ULONG ulPos, ulChunk;
+
+    Crc_Init(&sCtx, uwType);
+    for(ulPos=0;ulPos<ulLen;ulPos+=ulChunk)
+    {
+        ulChunk=crctestrand()%24;
+        if(ulChunk>ulLen-ulPos)
+            ulChunk=ulLen-ulPos;
+        Crc_Update(&sCtx, &pubData[ulPos], ulChunk);
+    }
+
+    return Crc_Final(&sCtx)!=ulOneShot;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    ULLNG ullStart, ullLegacy, ullNew, ullTime;
+    ULONG ulBuf, ulLen, ulOfs, ulMismatch, ulCrc32;
+    UWORD uwCrc16, uwModbus, i, j;
+    UBYTE ubCrc8;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+
+        // legacy crc16() table, poly 0x8005 reflected
+    for(i=0;i<256;i++)
+    {
+        uwCrc16=i;
+        for(j=0;j<8;j++)
+            uwCrc16=(uwCrc16&1) ? (UWORD)((uwCrc16>>1)^0xA001) : (UWORD)(uwCrc16>>1);
+        uwCrcTestTable16[i]=uwCrc16;
+    }
+
+        // catalogue check values
+    HOSTSIMTEST_CHECK(Crc16Arc_Update(CRC16ARC_INIT, ubCrcTestCheck, 9)==0xBB3D);
+    HOSTSIMTEST_CHECK(Crc16Modbus_Update(CRC16MODBUS_INIT, ubCrcTestCheck, 9)==0x4B37);
+    HOSTSIMTEST_CHECK(CRC32_FINAL(Crc32_Update(CRC32_INIT, ubCrcTestCheck, 9))==0xCBF43926ul);
+    HOSTSIMTEST_CHECK(Crc8_Update(0x00, ubCrcTestCheck, 9)==0xF4);
+    HOSTSIMTEST_CHECK(crc16(CRC16ARC_INIT, ubCrcTestCheck, 9)==0xBB3D);
+    HOSTSIMTEST_CHECK(ModBusOverSerCRC16(CRC16MODBUS_INIT, (HPUBYTE)ubCrcTestCheck, 9)==0x4B37);
+
+        // random buffers, lengths and alignments: all engines and the legacy
+        // entry points bit-identical with the references
+    ulMismatch=0;
+    for(ulBuf=0;ulBuf<CRCTEST_BUFFERS;ulBuf++)
+    {
+        ulOfs=ulBuf%8;
+        ulLen=ulBuf<64 ? ulBuf : (ULONG)((crctestrand()<<8)|crctestrand())%CRCTEST_MAXLEN;
+        for(i=0;i<ulLen;i++)
+            ubCrcTestBuf[ulOfs+i]=crctestrand();
+
+        ubCrc8=Crc8_Update(CRC8_INIT, &ubCrcTestBuf[ulOfs], ulLen);
+        ulMismatch+=(ubCrc8!=crctestref8(CRC8_INIT, &ubCrcTestBuf[ulOfs], ulLen));
+
+        uwCrc16=Crc16Arc_Update(CRC16ARC_INIT, &ubCrcTestBuf[ulOfs], ulLen);
+        ulMismatch+=(uwCrc16!=crctestref16(CRC16ARC_INIT, &ubCrcTestBuf[ulOfs], ulLen));
+        ulMismatch+=(uwCrc16!=crctestlegacy16(CRC16ARC_INIT, &ubCrcTestBuf[ulOfs], ulLen));
+        ulMismatch+=(uwCrc16!=crc16(CRC16ARC_INIT, &ubCrcTestBuf[ulOfs], (UWORD)ulLen));
+
+        uwModbus=Crc16Modbus_Update(CRC16MODBUS_INIT, &ubCrcTestBuf[ulOfs], ulLen);
+        ulMismatch+=(uwModbus!=crctestref16(CRC16MODBUS_INIT, &ubCrcTestBuf[ulOfs], ulLen));
+        ulMismatch+=(uwModbus!=ModBusOverSerCRC16(CRC16MODBUS_INIT, &ubCrcTestBuf[ulOfs], (UWORD)ulLen));
+
+        ulCrc32=CRC32_FINAL(Crc32_Update(CRC32_INIT, &ubCrcTestBuf[ulOfs], ulLen));
+        ulMismatch+=(ulCrc32!=~crctestref32(CRC32_INIT, &ubCrcTestBuf[ulOfs], ulLen));
+
+            // streaming contexts
+        ulMismatch+=crcteststream(CRC_TYPE_CRC8, &ubCrcTestBuf[ulOfs], ulLen, ubCrc8);
+        ulMismatch+=crcteststream(CRC_TYPE_CRC16ARC, &ubCrcTestBuf[ulOfs], ulLen, uwCrc16);
+        ulMismatch+=crcteststream(CRC_TYPE_CRC16MODBUS, &ubCrcTestBuf[ulOfs], ulLen, uwModbus);
+        ulMismatch+=crcteststream(CRC_TYPE_CRC32, &ubCrcTestBuf[ulOfs], ulLen, ulCrc32);
+    }
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+
+        // parameter image: crc16() against the byte table loop it replaced
+    for(ulOfs=0;ulOfs<CRCTEST_BENCH_SIZE;ulOfs++)
+        ubCrcTestImage[ulOfs]=crctestrand();
+    ullLegacy=ullNew=~0ull;
+    for(i=0;i<CRCTEST_BENCH_RUNS;i++)
+    {
+        ullStart=HostSim_GetTime();
+        ulCrcTestSink+=crctestlegacy16(CRC16ARC_INIT, ubCrcTestImage, CRCTEST_BENCH_SIZE);
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullLegacy)
+            ullLegacy=ullTime;
+
+        ullStart=HostSim_GetTime();
+        ulCrcTestSink+=Crc16Arc_Update(CRC16ARC_INIT, ubCrcTestImage, CRCTEST_BENCH_SIZE);
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullNew)
+            ullNew=ullTime;
+    }
+    HOSTSIMTEST_CHECK((double)ullLegacy>=CRCTEST_BENCH_MINGAIN*(double)ullNew);
+    printf("CrcTest: CRC-16 over %lu bytes, %.1f us byte table, %.1f us slice-by-8 (x%.1f)\n",
+        (unsigned long)CRCTEST_BENCH_SIZE, (double)ullLegacy/10.0, (double)ullNew/10.0, (double)ullLegacy/(double)ullNew);
+
+    return HOSTSIMTEST_RESULT("CrcTest");
+}
@@ -0,0 +1,235 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : DrivePlantTest.c                                           */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host test: whole drive booted on the closed-loop           */
+/*               plant, profile velocity step and position move             */
+/*                                                                          */
+/****************************************************************************/
+
+#include <math.h>
+
+#include "common\CommonDefines.h"
+#include "common\TaskScheduler.h"
+#include "common\ParamStorageManagement.h"
+#include "common\FlashManager.h"
+#include "core\Flash.h"
+#include "core\Timer.h"
+#include "system\SysAppGlobals.h"
+#include "system\SysAppTaskCollection.h"
+#include "system\SysAppHwOptReq.h"
+#include "drive\AxM-E-Defines.h"
+#include "drive\HardwareConfig.h"
+#include "drive\MotorHandler.h"
+#include "drive\EncoderManager.h"
+#include "drive\IncrementalEncoder.h"
+#include "drive\MotionController.h"
+#include "drive\Positioner.h"
+#include "fpga\FpgaHandler.h"
+#include "HostSim.h"
+#include "HostSimPlant.h"
+#include "HostSimOneWire.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // realtime ticks between statusword polls, 10msec
+#define DPTEST_POLL_TICKS               (REALTIME_TASK_FREQ/100)
+    // time limit of each state change or motion, ticks
+#define DPTEST_TIMEOUT_TICKS            (10*REALTIME_TASK_FREQ)
+    // time the drive is kept at target before the checks, ticks
+#define DPTEST_SETTLE_TICKS             (REALTIME_TASK_FREQ/2)
+
+    // main incremental encoder lines, 65536 counts per revolution
+#define DPTEST_ENC_LINES                16384
+
+    // profile velocity target [rev/sec] and settled speed tolerance [rad/sec]
+#define DPTEST_PV_SPEED                 10
+#define DPTEST_PV_SPEED_TOL             0.05
+    // profile position relative move [rev] and settled tolerance [rad]
+#define DPTEST_PP_MOVE                  2
+#define DPTEST_PP_POS_TOL               (DPTEST_TWOPI*16/(4*DPTEST_ENC_LINES))
+
+#define DPTEST_TWOPI                    (2.0*3.14159265358979323846)
+
+    // dsp402 words and modes of operation, as in drive\MotionController.c
+#define DPTEST_CW_SHUTDOWN              0x0006
+#define DPTEST_CW_SWITCHON              0x0007
+#define DPTEST_CW_ENABLEOPERATION       0x000F
+#define DPTEST_CW_PP_NEWSETPOINT        0x0010
+#define DPTEST_CW_PP_RELATIVE           0x0040
+
+#define DPTEST_SW_STATEMACHINE          0x006F
+#define DPTEST_SW_SWITCHONDISABLED      0x0040
+#define DPTEST_SW_READYTOSWITCHON       0x0021
+#define DPTEST_SW_SWITCHEDON            0x0023
+#define DPTEST_SW_OPERATIONENABLED      0x0027
+#define DPTEST_SW_TARGETREACHED         0x0400
+#define DPTEST_SW_PP_SETPOINTACK        0x1000
+
+#define DPTEST_OM_PROFILEPOSITION       1
+#define DPTEST_OM_PROFILEVELOCITY       3
+
+//***************************************************************************
+// Locals
+
+    // realtime overruns of the whole run
+static ULONG ulDpTestOverruns;
+
+//***************************************************************************
+// Drive boot, the SysAppStartup sequence on the virtual identification chips
+
+static BOOL dptestboot(void)
+{
+    ULONG ulBytes;
+    BOOL bOk=TRUE;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    Flash_Init();
+    FlashMgrInit();
+    Globals_Init();
+    bSysStatBooting=1;
+
+    HostSimOneWire_DefaultDrive();
+    bOk&=HwConfGetAndCheck(NULL);
+
+    TaskSched_Init();
+    parmgm_par_init();
+    parmgm_par_default();
+
+        // main feedback from the plant incremental encoder only
+    sEm_EncMngrParam.uwMainAbsSel=ENCODER_TYPE_NULL;
+    sEm_EncMngrParam.uwMainRelSel=ENCODER_TYPE_REL_INCREMENTAL;
+    sEm_EncMngrParam.flags.b.bDisableEPlate=TRUE;
+    sIc_IncEncParams[INCREMENTAL_SEL_MAIN].ulLineCounts=DPTEST_ENC_LINES;
+
+    HwOptReqCollect();
+    bOk&=HwConfGlobalOptions();
+
+    FpgaInit();
+    bOk&=(FpgaLoad(&ulBytes, NULL)==0);
+    bOk&=FpgaIdentVerify();
+
+    Intr_Init();
+    Os_Init();
+    bOk&=(TaskSched_InitializeAll((TASKSCHEDULER_TASK_INIT *)psSysAppTaskCollection)==0);
+
+    FpgaSafeUnLock(0);
+        // power on self test, no failure
+    bOk&=(Mh_POSTExecute()==0);
+
+    return bOk;
+}
+
+//***************************************************************************
+// Run realtime ticks, with a background loop after each of them
+
+static void dptestrun(ULONG ulTicks)
+{
+    while(ulTicks--)
+    {
+        ulDpTestOverruns+=HostSim_RunTicks(1);
+        TaskSched_BackgroundLoop();
+    }
+}
+
+//***************************************************************************
+// Run until statusword bits match, FALSE on timeout
+
+static BOOL dptestwait(UWORD uwMask, UWORD uwValue)
+{
+    ULONG ulTicks;
+
+    for(ulTicks=0;ulTicks<DPTEST_TIMEOUT_TICKS;ulTicks+=DPTEST_POLL_TICKS)
+    {
+        if((sMotCtrl_Out.uwStatusWord&uwMask)==uwValue)
+            return TRUE;
+        dptestrun(DPTEST_POLL_TICKS);
+    }
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    DOUBL dbStart;
+
+    HOSTSIMTEST_CHECK(dptestboot());
+
+        // the plant takes the place of the power section before the first
+        // tick, the end of boot starts the dsp402 state machine
+    HostSimPlant_DefaultParams(&sHostSimPlantParams);
+    HostSimPlant_Reset(0.0);
+    HostSimPlant_Attach();
+    Timer_Init(REALTIME_TASK_FREQ, TaskSched_RTScheduler);
+    bSysStatBooting=0;
+    dptestrun(DPTEST_SETTLE_TICKS);
+    HOSTSIMTEST_CHECK((sMotCtrl_Out.uwStatusWord&DPTEST_SW_STATEMACHINE)==DPTEST_SW_SWITCHONDISABLED);
+    HOSTSIMTEST_CHECK(ulSystemAlarms==0);
+
+        // commissioned motor: the incremental encoder has no commutation
+        // reference before the index, give it one as phasing would
+    Ic_EncoderSetElecAngle(0);
+
+        // enable in profile velocity
+    sMotCtrlParameters.ubModeOfOperation=DPTEST_OM_PROFILEVELOCITY;
+    sMotCtrl_UsrControl.uwControlWord=DPTEST_CW_SHUTDOWN;
+    HOSTSIMTEST_CHECK(dptestwait(DPTEST_SW_STATEMACHINE, DPTEST_SW_READYTOSWITCHON));
+    sMotCtrl_UsrControl.uwControlWord=DPTEST_CW_SWITCHON;
+    HOSTSIMTEST_CHECK(dptestwait(DPTEST_SW_STATEMACHINE, DPTEST_SW_SWITCHEDON));
+    sMotCtrl_UsrControl.uwControlWord=DPTEST_CW_ENABLEOPERATION;
+    HOSTSIMTEST_CHECK(dptestwait(DPTEST_SW_STATEMACHINE, DPTEST_SW_OPERATIONENABLED));
+    HOSTSIMTEST_CHECK(bSysStatPowerReady && bSysStatPowerEnabled);
+    HOSTSIMTEST_CHECK(sHostSimPlant.bPwmOn);
+
+        // speed step, units 2^32 per revolution per realtime slot
+    sPo_UsrPostnerIn.slTargetSpeed=(SLONG)((DOUBL)DPTEST_PV_SPEED*4294967296.0/REALTIME_TASK_FREQ);
+    dptestrun(DPTEST_POLL_TICKS);
+    HOSTSIMTEST_CHECK(!(sMotCtrl_Out.uwStatusWord&DPTEST_SW_TARGETREACHED));
+    HOSTSIMTEST_CHECK(dptestwait(DPTEST_SW_TARGETREACHED, DPTEST_SW_TARGETREACHED));
+    dptestrun(DPTEST_SETTLE_TICKS);
+    printf("pv: plant speed %.4f rad/sec, encoder %ld\n", (double)sHostSimPlant.dbSpeed,
+        (long)sEm_Fbk2CntrLoop.sEncData.slSpeed);
+    HOSTSIMTEST_CHECK(sMotCtrl_Out.uwStatusWord&DPTEST_SW_TARGETREACHED);
+    HOSTSIMTEST_CHECK_NEAR(sHostSimPlant.dbSpeed, DPTEST_TWOPI*DPTEST_PV_SPEED, DPTEST_PV_SPEED_TOL);
+
+        // stop, then relative move in profile position
+    sPo_UsrPostnerIn.slTargetSpeed=0;
+    dptestrun(DPTEST_POLL_TICKS);
+    HOSTSIMTEST_CHECK(dptestwait(DPTEST_SW_TARGETREACHED, DPTEST_SW_TARGETREACHED));
+    dptestrun(DPTEST_SETTLE_TICKS);
+    HOSTSIMTEST_CHECK_NEAR(sHostSimPlant.dbSpeed, 0.0, DPTEST_PV_SPEED_TOL);
+
+    sMotCtrlParameters.ubModeOfOperation=DPTEST_OM_PROFILEPOSITION;
+    dptestrun(DPTEST_POLL_TICKS);
+    HOSTSIMTEST_CHECK(sMotCtrl_Out.ubModeOfOperationDisplay==DPTEST_OM_PROFILEPOSITION);
+
+    dbStart=sHostSimPlant.dbPosition;
+    sMotCtrl_UsrControl.sqTargetPostn.hi=DPTEST_PP_MOVE;
+    sMotCtrl_UsrControl.sqTargetPostn.lo=0;
+    sMotCtrl_UsrControl.uwControlWord=DPTEST_CW_ENABLEOPERATION|DPTEST_CW_PP_NEWSETPOINT|DPTEST_CW_PP_RELATIVE;
+    HOSTSIMTEST_CHECK(dptestwait(DPTEST_SW_PP_SETPOINTACK, DPTEST_SW_PP_SETPOINTACK));
+    sMotCtrl_UsrControl.uwControlWord=DPTEST_CW_ENABLEOPERATION|DPTEST_CW_PP_RELATIVE;
+    HOSTSIMTEST_CHECK(dptestwait(DPTEST_SW_TARGETREACHED, DPTEST_SW_TARGETREACHED));
+    dptestrun(DPTEST_SETTLE_TICKS);
+    printf("pp: plant move %.5f rad, speed %.4f rad/sec\n", (double)(sHostSimPlant.dbPosition-dbStart),
+        (double)sHostSimPlant.dbSpeed);
+    HOSTSIMTEST_CHECK(sMotCtrl_Out.uwStatusWord&DPTEST_SW_TARGETREACHED);
+    HOSTSIMTEST_CHECK_NEAR(sHostSimPlant.dbPosition-dbStart, DPTEST_TWOPI*DPTEST_PP_MOVE, DPTEST_PP_POS_TOL);
+    HOSTSIMTEST_CHECK_NEAR(sHostSimPlant.dbSpeed, 0.0, DPTEST_PV_SPEED_TOL);
+
+        // no fault along the way, realtime slots kept
+    HOSTSIMTEST_CHECK((sMotCtrl_Out.uwStatusWord&DPTEST_SW_STATEMACHINE)==DPTEST_SW_OPERATIONENABLED);
+    HOSTSIMTEST_CHECK(ulSystemAlarms==0);
+    HOSTSIMTEST_CHECK(ulDpTestOverruns==0);
+
+    return HOSTSIMTEST_RESULT("DrivePlantTest");
+}
@@ -0,0 +1,384 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : DspFilterTest.c                                            */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Filter engine: frequency response of the designed sections */
+/*               and of FIR filters, multichannel calls, FIR exactness      */
+/*                                                                          */
+/****************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\DspFilter.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // sample rate of the realtime task
+#define DSPTEST_FS                      8000
+    // settling and measuring time, one second each: integer periods of
+    // every test frequency
+#define DSPTEST_SETTLE                  DSPTEST_FS
+#define DSPTEST_MEASURE                 DSPTEST_FS
+    // test frequencies, one channel each
+#define DSPTEST_CHANNELS                7
+    // fixed point formats
+#define DSPTEST_Q15_SHIFT               13              // as the Iq filter
+#define DSPTEST_Q15_AMPL                12000.0         // room for gain 2.25
+#define DSPTEST_Q31_SHIFT               28
+#define DSPTEST_Q31_AMPL                268435456.0     // 2^28
+    // FIR taps
+#define DSPTEST_FIR_TAPS                31
+
+    // gain error against design, absolute: float and Q31 rounding only,
+    // Q15 adds coefficient quantization and output truncation
+#define DSPTEST_TOL_F                   1e-5
+#define DSPTEST_TOL_Q31                 1e-5
+#define DSPTEST_TOL_Q15                 2e-3
+
+//***************************************************************************
+// Structures
+
+    // Section under test and its analog prototype; Q15 coefficients are in
+// Q13 as the Iq filter, so gains stay below 4 at every frequency
+typedef struct
+{
+    const char *    pcName;
+    UBYTE           ubType;
+    FLOAT           flFreqMain;                 // Hz
+    FLOAT           flDampMain;
+    FLOAT           flFreqSec;                  // Hz
+    FLOAT           flDampSec;
+} DSPTEST_SOS;
+
+//***************************************************************************
+// Locals
+
+static const double dDspTestFreq[DSPTEST_CHANNELS]={ 50.0, 200.0, 500.0, 1000.0, 1500.0, 2000.0, 3000.0 };
+
+static const DSPTEST_SOS sDspTestSos[]=
+{
+    { "lowpass 500Hz", DSPFLT_SOS_LOWPASS, 500.0f, 0.7f, 0.0f, 0.0f },
+    { "notch 1kHz", DSPFLT_SOS_NOTCH, 1000.0f, 0.5f, 0.0f, 0.0f },
+    { "biquad 400/600Hz", DSPFLT_SOS_BIQUAD, 400.0f, 0.2f, 600.0f, 0.7f }
+};
+#define DSPTEST_SOSCOUNT                (sizeof(sDspTestSos)/sizeof(sDspTestSos[0]))
+
+static FLOAT flDspTestIn[(DSPTEST_SETTLE+DSPTEST_MEASURE)*DSPTEST_CHANNELS];
+static FLOAT flDspTestOut[(DSPTEST_SETTLE+DSPTEST_MEASURE)*DSPTEST_CHANNELS];
+static SWORD swDspTestIn[(DSPTEST_SETTLE+DSPTEST_MEASURE)*DSPTEST_CHANNELS];
+static SWORD swDspTestOut[(DSPTEST_SETTLE+DSPTEST_MEASURE)*DSPTEST_CHANNELS];
+static SWORD swDspTestOut1[DSPTEST_SETTLE+DSPTEST_MEASURE];
+static SLONG slDspTestIn[(DSPTEST_SETTLE+DSPTEST_MEASURE)*DSPTEST_CHANNELS];
+static SLONG slDspTestOut[(DSPTEST_SETTLE+DSPTEST_MEASURE)*DSPTEST_CHANNELS];
+
+//***************************************************************************
+// Gain of the analog prototype at the frequency the bilinear transform
+// maps to f (no prewarping)
+
+static double dsptestdesigngain(const DSPTEST_SOS * psSos, double dFreq)
+{
+    double dW, dWm, dWs, dNumRe, dNumIm, dDenRe, dDenIm, dScale;
+
+    dW=2.0*DSPTEST_FS*tan(M_PI*dFreq/DSPTEST_FS);
+    dWm=2.0*M_PI*psSos->flFreqMain;
+    dWs=2.0*M_PI*psSos->flFreqSec;
+
+    switch(psSos->ubType)
+    {
+        case DSPFLT_SOS_LOWPASS:
+            dNumRe=dWm*dWm;
+            dNumIm=0.0;
+            dDenRe=dWm*dWm-dW*dW;
+            dDenIm=2.0*psSos->flDampMain*dWm*dW;
+            dScale=1.0;
+            break;
+
+        case DSPFLT_SOS_NOTCH:
+            dNumRe=dWm*dWm-dW*dW;
+            dNumIm=0.0;
+            dDenRe=dWm*dWm-dW*dW;
+            dDenIm=psSos->flDampMain*dWm*dW;
+            dScale=1.0;
+            break;
+
+        default:
+            dNumRe=dWm*dWm-dW*dW;
+            dNumIm=2.0*psSos->flDampMain*dWm*dW;
+            dDenRe=dWs*dWs-dW*dW;
+            dDenIm=2.0*psSos->flDampSec*dWs*dW;
+            dScale=dWs*dWs/(dWm*dWm);
+            break;
+    }
+
+    return dScale*hypot(dNumRe, dNumIm)/hypot(dDenRe, dDenIm);
+}
+
+//***************************************************************************
+// Gain of FIR taps at frequency
+
+static double dsptestfirgain(const double * pdTaps, double dFreq)
+{
+    double dRe=0.0, dIm=0.0;
+    UWORD k;
+
+    for(k=0;k<DSPTEST_FIR_TAPS;k++)
+    {
+        dRe+=pdTaps[k]*cos(2.0*M_PI*dFreq*k/DSPTEST_FS);
+        dIm-=pdTaps[k]*sin(2.0*M_PI*dFreq*k/DSPTEST_FS);
+    }
+
+    return hypot(dRe, dIm);
+}
+
+//***************************************************************************
+// Input: one sine per channel, interleaved
+
+static void dsptestinput(void)
+{
+    ULONG n;
+    UWORD uwCh;
+    double dSin;
+
+    for(n=0;n<DSPTEST_SETTLE+DSPTEST_MEASURE;n++)
+        for(uwCh=0;uwCh<DSPTEST_CHANNELS;uwCh++)
+        {
+            dSin=sin(2.0*M_PI*dDspTestFreq[uwCh]*n/DSPTEST_FS);
+            flDspTestIn[n*DSPTEST_CHANNELS+uwCh]=(FLOAT)dSin;
+            swDspTestIn[n*DSPTEST_CHANNELS+uwCh]=(SWORD)lround(DSPTEST_Q15_AMPL*dSin);
+            slDspTestIn[n*DSPTEST_CHANNELS+uwCh]=(SLONG)lround(DSPTEST_Q31_AMPL*dSin);
+        }
+}
+
+//***************************************************************************
+// Measured gain of channel: output correlated with the input sine and
+// cosine over the measuring second, DC and truncation noise drop out
+
+#define DSPTEST_MEASUREGAIN(name, type)                                     \
+static double name(const type * pOut, UWORD uwCh, UWORD uwStride, double dAmpl) \
+{                                                                           \
+    double dRe=0.0, dIm=0.0, dPh;                                           \
+    ULONG n;                                                                \
+                                                                            \
+    for(n=DSPTEST_SETTLE;n<DSPTEST_SETTLE+DSPTEST_MEASURE;n++)              \
+    {                                                                       \
+        dPh=2.0*M_PI*dDspTestFreq[uwCh]*n/DSPTEST_FS;                       \
+        dRe+=(double)pOut[n*uwStride+uwCh]*sin(dPh);                        \
+        dIm+=(double)pOut[n*uwStride+uwCh]*cos(dPh);                        \
+    }                                                                       \
+                                                                            \
+    return 2.0*hypot(dRe, dIm)/(DSPTEST_MEASURE*dAmpl);                     \
+}
+
+DSPTEST_MEASUREGAIN(dsptestgainf, FLOAT)
+DSPTEST_MEASUREGAIN(dsptestgainq15, SWORD)
+DSPTEST_MEASUREGAIN(dsptestgainq31, SLONG)
+
+//***************************************************************************
+// Frequency response of a designed section on all engines, all test
+// frequencies as channels of one call; return max gain errors
+
+static void dsptestsos(const DSPTEST_SOS * psSos, double * pdErrF, double * pdErrQ15, double * pdErrQ31)
+{
+    DSPFLT_BIQUAD_F sCoefF;
+    DSPFLT_BIQUAD_Q15 sCoefQ15;
+    DSPFLT_BIQUAD_Q31 sCoefQ31;
+    DSPFLT_BIQUAD_F_STATE sStF[DSPTEST_CHANNELS];
+    DSPFLT_BIQUAD_Q15_STATE sStQ15[DSPTEST_CHANNELS];
+    DSPFLT_BIQUAD_Q15_STATE sStQ15One;
+    DSPFLT_BIQUAD_Q31_STATE sStQ31[DSPTEST_CHANNELS];
+    double dRef, dErr;
+    ULONG n;
+    UWORD uwCh;
+    BOOL bSame;
+
+    HOSTSIMTEST_CHECK(DspFlt_DesignSos(psSos->ubType, (FLOAT)(2.0*M_PI*psSos->flFreqMain), psSos->flDampMain,
+        (FLOAT)(2.0*M_PI*psSos->flFreqSec), psSos->flDampSec, 1.0/DSPTEST_FS, &sCoefF));
+    HOSTSIMTEST_CHECK(DspFlt_DesignSosQ15(psSos->ubType, (FLOAT)(2.0*M_PI*psSos->flFreqMain), psSos->flDampMain,
+        (FLOAT)(2.0*M_PI*psSos->flFreqSec), psSos->flDampSec, 1.0/DSPTEST_FS, DSPTEST_Q15_SHIFT, &sCoefQ15));
+    DspFlt_TrimDcQ15(&sCoefQ15);
+    HOSTSIMTEST_CHECK(sCoefQ15.swB0+sCoefQ15.swB1+sCoefQ15.swB2+sCoefQ15.swA1+sCoefQ15.swA2==(1<<DSPTEST_Q15_SHIFT));
+
+    sCoefQ31.slB0=(SLONG)lround(sCoefF.flB0*DSPTEST_Q31_AMPL);
+    sCoefQ31.slB1=(SLONG)lround(sCoefF.flB1*DSPTEST_Q31_AMPL);
+    sCoefQ31.slB2=(SLONG)lround(sCoefF.flB2*DSPTEST_Q31_AMPL);
+    sCoefQ31.slA1=(SLONG)lround(sCoefF.flA1*DSPTEST_Q31_AMPL);
+    sCoefQ31.slA2=(SLONG)lround(sCoefF.flA2*DSPTEST_Q31_AMPL);
+    sCoefQ31.ubShift=DSPTEST_Q31_SHIFT;
+
+    memset(sStF, 0, sizeof(sStF));
+    memset(sStQ15, 0, sizeof(sStQ15));
+    memset(sStQ31, 0, sizeof(sStQ31));
+    DspFlt_BiquadF(&sCoefF, 1, sStF, flDspTestIn, flDspTestOut, DSPTEST_CHANNELS, DSPTEST_SETTLE+DSPTEST_MEASURE);
+    DspFlt_BiquadQ15(&sCoefQ15, 1, sStQ15, swDspTestIn, swDspTestOut, DSPTEST_CHANNELS, DSPTEST_SETTLE+DSPTEST_MEASURE);
+    DspFlt_BiquadQ31(&sCoefQ31, 1, sStQ31, slDspTestIn, slDspTestOut, DSPTEST_CHANNELS, DSPTEST_SETTLE+DSPTEST_MEASURE);
+
+    *pdErrF=*pdErrQ15=*pdErrQ31=0.0;
+    bSame=TRUE;
+    for(uwCh=0;uwCh<DSPTEST_CHANNELS;uwCh++)
+    {
+        dRef=dsptestdesigngain(psSos, dDspTestFreq[uwCh]);
+
+        dErr=fabs(dsptestgainf(flDspTestOut, uwCh, DSPTEST_CHANNELS, 1.0)-dRef);
+        if(dErr>*pdErrF)
+            *pdErrF=dErr;
+        dErr=fabs(dsptestgainq15(swDspTestOut, uwCh, DSPTEST_CHANNELS, DSPTEST_Q15_AMPL)-dRef);
+        if(dErr>*pdErrQ15)
+            *pdErrQ15=dErr;
+        dErr=fabs(dsptestgainq31(slDspTestOut, uwCh, DSPTEST_CHANNELS, DSPTEST_Q31_AMPL)-dRef);
+        if(dErr>*pdErrQ31)
+            *pdErrQ31=dErr;
+
+            // channel of a multichannel call equals the channel alone, one
+            // sample per call as the realtime task
+        memset(&sStQ15One, 0, sizeof(sStQ15One));
+        for(n=0;n<DSPTEST_SETTLE+DSPTEST_MEASURE;n++)
+            DspFlt_BiquadQ15(&sCoefQ15, 1, &sStQ15One, &swDspTestIn[n*DSPTEST_CHANNELS+uwCh], &swDspTestOut1[n], 1, 1);
+        for(n=0;n<DSPTEST_SETTLE+DSPTEST_MEASURE;n++)
+            bSame&=(swDspTestOut1[n]==swDspTestOut[n*DSPTEST_CHANNELS+uwCh]);
+    }
+    HOSTSIMTEST_CHECK(bSame);
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    DSPFLT_BIQUAD_F sCascade[2];
+    DSPFLT_BIQUAD_F_STATE sStCascade[2*DSPTEST_CHANNELS];
+    DSPFLT_FIR_F sFirF;
+    DSPFLT_FIR_Q15 sFirQ15;
+    DSPFLT_FIR_Q31 sFirQ31;
+    DSPFLT_FIR_F_STATE sStFirF[DSPTEST_CHANNELS];
+    DSPFLT_FIR_Q15_STATE sStFirQ15[DSPTEST_CHANNELS];
+    DSPFLT_FIR_Q31_STATE sStFirQ31[DSPTEST_CHANNELS];
+    static FLOAT flDelayF[DSPTEST_CHANNELS][DSPFLT_FIR_DELAYSIZE(DSPTEST_FIR_TAPS)];
+    static SWORD swDelayQ15[DSPTEST_CHANNELS][DSPFLT_FIR_DELAYSIZE(DSPTEST_FIR_TAPS)];
+    static SLONG slDelayQ31[DSPTEST_CHANNELS][DSPFLT_FIR_DELAYSIZE(DSPTEST_FIR_TAPS)];
+    FLOAT flTaps[DSPTEST_FIR_TAPS];
+    SWORD swTaps[DSPTEST_FIR_TAPS];
+    SLONG slTaps[DSPTEST_FIR_TAPS];
+    double dTaps[DSPTEST_FIR_TAPS], dTapsQ15[DSPTEST_FIR_TAPS], dTapsQ31[DSPTEST_FIR_TAPS];
+    double dErrF, dErrQ15, dErrQ31, dRef, dErr, dX;
+    SLLNG sllAcc;
+    ULONG n, ulMismatch;
+    UWORD i, k, uwCh;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    dsptestinput();
+
+        // designed sections on the three engines
+    for(i=0;i<DSPTEST_SOSCOUNT;i++)
+    {
+        dsptestsos(&sDspTestSos[i], &dErrF, &dErrQ15, &dErrQ31);
+        HOSTSIMTEST_CHECK(dErrF<=DSPTEST_TOL_F);
+        HOSTSIMTEST_CHECK(dErrQ15<=DSPTEST_TOL_Q15);
+        HOSTSIMTEST_CHECK(dErrQ31<=DSPTEST_TOL_Q31);
+        printf("DspFilterTest: %-16s max gain error float %.1e, Q15 %.1e, Q31 %.1e\n",
+            sDspTestSos[i].pcName, dErrF, dErrQ15, dErrQ31);
+    }
+
+        // notch depth and lowpass roll-off from the design; no prewarping,
+        // the notch falls a bit below its analog frequency
+    HOSTSIMTEST_CHECK(dsptestdesigngain(&sDspTestSos[1], DSPTEST_FS/M_PI*atan(M_PI*1000.0/DSPTEST_FS))<1e-6);
+    HOSTSIMTEST_CHECK(dsptestdesigngain(&sDspTestSos[0], 3000.0)<0.05);
+
+        // cascade of lowpass and notch: gain is the product
+    HOSTSIMTEST_CHECK(DspFlt_DesignSos(DSPFLT_SOS_LOWPASS, (FLOAT)(2.0*M_PI*500.0), 0.7f, 0.0f, 0.0f, 1.0/DSPTEST_FS, &sCascade[0]));
+    HOSTSIMTEST_CHECK(DspFlt_DesignSos(DSPFLT_SOS_NOTCH, (FLOAT)(2.0*M_PI*1000.0), 0.5f, 0.0f, 0.0f, 1.0/DSPTEST_FS, &sCascade[1]));
+    memset(sStCascade, 0, sizeof(sStCascade));
+    DspFlt_BiquadF(sCascade, 2, sStCascade, flDspTestIn, flDspTestOut, DSPTEST_CHANNELS, DSPTEST_SETTLE+DSPTEST_MEASURE);
+    dErrF=0.0;
+    for(uwCh=0;uwCh<DSPTEST_CHANNELS;uwCh++)
+    {
+        dRef=dsptestdesigngain(&sDspTestSos[0], dDspTestFreq[uwCh])*dsptestdesigngain(&sDspTestSos[1], dDspTestFreq[uwCh]);
+        dErr=fabs(dsptestgainf(flDspTestOut, uwCh, DSPTEST_CHANNELS, 1.0)-dRef);
+        if(dErr>dErrF)
+            dErrF=dErr;
+    }
+    HOSTSIMTEST_CHECK(dErrF<=DSPTEST_TOL_F);
+
+        // FIR: Hamming windowed sinc lowpass at 1kHz, unity DC gain
+    dX=0.0;
+    for(k=0;k<DSPTEST_FIR_TAPS;k++)
+    {
+        dRef=k-(DSPTEST_FIR_TAPS-1)/2.0;
+        dTaps[k]=(dRef==0.0 ? 2.0*1000.0/DSPTEST_FS : sin(2.0*M_PI*1000.0*dRef/DSPTEST_FS)/(M_PI*dRef))*
+            (0.54-0.46*cos(2.0*M_PI*k/(DSPTEST_FIR_TAPS-1)));
+        dX+=dTaps[k];
+    }
+    for(k=0;k<DSPTEST_FIR_TAPS;k++)
+    {
+        dTaps[k]/=dX;
+        flTaps[k]=(FLOAT)dTaps[k];
+        swTaps[k]=(SWORD)lround(dTaps[k]*32768.0);
+        slTaps[k]=(SLONG)lround(dTaps[k]*1073741824.0);
+        dTapsQ15[k]=swTaps[k]/32768.0;
+        dTapsQ31[k]=slTaps[k]/1073741824.0;
+    }
+    sFirF.pflTaps=flTaps;
+    sFirF.uwTaps=DSPTEST_FIR_TAPS;
+    sFirQ15.pswTaps=swTaps;
+    sFirQ15.uwTaps=DSPTEST_FIR_TAPS;
+    sFirQ15.ubShift=15;
+    sFirQ31.pslTaps=slTaps;
+    sFirQ31.uwTaps=DSPTEST_FIR_TAPS;
+    sFirQ31.ubShift=30;
+    for(uwCh=0;uwCh<DSPTEST_CHANNELS;uwCh++)
+    {
+        DspFlt_FirFInit(&sStFirF[uwCh], flDelayF[uwCh], DSPTEST_FIR_TAPS);
+        DspFlt_FirQ15Init(&sStFirQ15[uwCh], swDelayQ15[uwCh], DSPTEST_FIR_TAPS);
+        DspFlt_FirQ31Init(&sStFirQ31[uwCh], slDelayQ31[uwCh], DSPTEST_FIR_TAPS);
+    }
+    DspFlt_FirF(&sFirF, sStFirF, flDspTestIn, flDspTestOut, DSPTEST_CHANNELS, DSPTEST_SETTLE+DSPTEST_MEASURE);
+    DspFlt_FirQ15(&sFirQ15, sStFirQ15, swDspTestIn, swDspTestOut, DSPTEST_CHANNELS, DSPTEST_SETTLE+DSPTEST_MEASURE);
+    DspFlt_FirQ31(&sFirQ31, sStFirQ31, slDspTestIn, slDspTestOut, DSPTEST_CHANNELS, DSPTEST_SETTLE+DSPTEST_MEASURE);
+
+        // FIR response against the taps, fixed point against the direct
+        // convolution (64bit sum, floor shift, saturation)
+    dErrF=dErrQ15=dErrQ31=0.0;
+    ulMismatch=0;
+    for(uwCh=0;uwCh<DSPTEST_CHANNELS;uwCh++)
+    {
+        dErr=fabs(dsptestgainf(flDspTestOut, uwCh, DSPTEST_CHANNELS, 1.0)-dsptestfirgain(dTaps, dDspTestFreq[uwCh]));
+        if(dErr>dErrF)
+            dErrF=dErr;
+        dErr=fabs(dsptestgainq15(swDspTestOut, uwCh, DSPTEST_CHANNELS, DSPTEST_Q15_AMPL)-dsptestfirgain(dTapsQ15, dDspTestFreq[uwCh]));
+        if(dErr>dErrQ15)
+            dErrQ15=dErr;
+        dErr=fabs(dsptestgainq31(slDspTestOut, uwCh, DSPTEST_CHANNELS, DSPTEST_Q31_AMPL)-dsptestfirgain(dTapsQ31, dDspTestFreq[uwCh]));
+        if(dErr>dErrQ31)
+            dErrQ31=dErr;
+
+        for(n=0;n<DSPTEST_SETTLE+DSPTEST_MEASURE;n++)
+        {
+            sllAcc=0;
+            for(k=0;k<DSPTEST_FIR_TAPS && k<=n;k++)
+                sllAcc+=(SLLNG)swTaps[k]*swDspTestIn[(n-k)*DSPTEST_CHANNELS+uwCh];
+            sllAcc>>=15;
+            sllAcc=sllAcc>32767 ? 32767 : (sllAcc<-32768 ? -32768 : sllAcc);
+            ulMismatch+=(swDspTestOut[n*DSPTEST_CHANNELS+uwCh]!=(SWORD)sllAcc);
+
+            sllAcc=0;
+            for(k=0;k<DSPTEST_FIR_TAPS && k<=n;k++)
+                sllAcc+=(SLLNG)slTaps[k]*slDspTestIn[(n-k)*DSPTEST_CHANNELS+uwCh];
+            ulMismatch+=(slDspTestOut[n*DSPTEST_CHANNELS+uwCh]!=(SLONG)(sllAcc>>30));
+        }
+    }
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+    HOSTSIMTEST_CHECK(dErrF<=DSPTEST_TOL_F);
+    HOSTSIMTEST_CHECK(dErrQ15<=DSPTEST_TOL_Q15);
+    HOSTSIMTEST_CHECK(dErrQ31<=DSPTEST_TOL_Q31);
+    printf("DspFilterTest: %-16s max gain error float %.1e, Q15 %.1e, Q31 %.1e\n", "FIR 31 taps 1kHz", dErrF, dErrQ15, dErrQ31);
+
+    return HOSTSIMTEST_RESULT("DspFilterTest");
+}
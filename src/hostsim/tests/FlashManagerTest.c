@@ -0,0 +1,295 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : FlashManagerTest.c                                         */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Flash manager page cache: scattered sessions, rewrites,    */
+/*               write back order under power cut, page program counts      */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\FlashManager.h"
+#include "core\Flash.h"
+#include "HostSim.h"
+#include "HostSimHal.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // test area, device address, erased by sub-sectors
+#define FLMTEST_BASE                    0xE00000ul
+#define FLMTEST_LINEAR(offs)            ((HPVOID)(UINTPTR)(XPS_QSPI_LINEAR_BASEADDR+FLMTEST_BASE+(offs)))
+    // scattered sessions: pages (more than cached), max write size
+#define FLMTEST_SCATTER_PAGES           8
+#define FLMTEST_SCATTER_SESSIONS        200
+#define FLMTEST_WRITE_MAX               300
+    // rewrites of a few cached pages
+#define FLMTEST_REWRITE_PAGES           3
+#define FLMTEST_REWRITES                500
+    // write back order sessions, pages within the cache size
+#define FLMTEST_ORDER_PAGES             4
+#define FLMTEST_ORDER_SESSIONS          50
+    // streams: bytes per write, writes per stream
+#define FLMTEST_STREAM_WRITE            16
+#define FLMTEST_STREAM_WRITES           5000
+#define FLMTEST_STREAM_BYTES            (FLMTEST_STREAM_WRITE*FLMTEST_STREAM_WRITES)
+#define FLMTEST_STREAM_AREA             0x40000ul
+
+//***************************************************************************
+// Structures
+
+    // session write, source is the pattern at the same offset
+typedef struct
+{
+    UWORD   uwOffset;
+    UWORD   uwSize;
+} FLMTEST_WRITE;
+
+//***************************************************************************
+// Locals
+
+static UBYTE ubFlmTestPattern[2*FLMTEST_STREAM_BYTES];
+static UBYTE ubFlmTestRef[FLMTEST_SCATTER_PAGES*PAGE_SIZE];
+
+static FLMTEST_WRITE sFlmTestWrites[FLMTEST_SCATTER_PAGES*PAGE_SIZE];
+static UWORD uwFlmTestWrites;
+
+static ULONG ulFlmTestSeed=0x0F1E2D3Cul;
+
+//***************************************************************************
+// Random
+
+static ULONG flmtestrand(void)
+{
+    ulFlmTestSeed=ulFlmTestSeed*1664525ul+1013904223ul;
+
+    return ulFlmTestSeed>>8;
+}
+
+//***************************************************************************
+// Erase the test area, device back on
+
+static void flmtesterase(ULONG ulSize)
+{
+    ulHostSimFlashPowerCut=0;
+    ulHostSimFlashFailCmds=0;
+    FlashCmdFailed();
+    FlashErase(FLMTEST_BASE, ulSize);
+}
+
+//***************************************************************************
+// Session of non overlapping writes covering the pages in random order
+
+static void flmtestsession(UWORD uwPages)
+{
+    FLMTEST_WRITE sTmp;
+    UWORD uwOffset,uwSize,ct,ctSwap;
+
+    uwFlmTestWrites=0;
+    for(uwOffset=0;uwOffset<uwPages*PAGE_SIZE;uwOffset+=uwSize)
+    {
+        uwSize=(UWORD)(1+flmtestrand()%FLMTEST_WRITE_MAX);
+        if(uwSize>uwPages*PAGE_SIZE-uwOffset)
+            uwSize=(UWORD)(uwPages*PAGE_SIZE-uwOffset);
+        sFlmTestWrites[uwFlmTestWrites].uwOffset=uwOffset;
+        sFlmTestWrites[uwFlmTestWrites++].uwSize=uwSize;
+    }
+
+    for(ct=uwFlmTestWrites-1;ct>0;ct--)
+    {
+        ctSwap=(UWORD)(flmtestrand()%(ct+1));
+        sTmp=sFlmTestWrites[ct];
+        sFlmTestWrites[ct]=sFlmTestWrites[ctSwap];
+        sFlmTestWrites[ctSwap]=sTmp;
+    }
+}
+
+static UWORD flmtestreplay(void)
+{
+    UWORD ct;
+
+    if(FlashMgrBegin(0)!=FLASHMGR_R_OK)
+        return FLASHMGR_R_LOCKFAILED;
+
+    for(ct=0;ct<uwFlmTestWrites;ct++)
+        FlashMgrWriteData(FLMTEST_LINEAR(sFlmTestWrites[ct].uwOffset),
+            &ubFlmTestPattern[sFlmTestWrites[ct].uwOffset], sFlmTestWrites[ct].uwSize);
+
+    return FlashMgrEnd(NULL);
+}
+
+//***************************************************************************
+// Page programs of the previous single page buffer: one at each change of
+// destination page and one at the end
+
+static ULONG flmtestlegacy(ULONG ulPrograms, ULONG * pulLastPage, ULONG ulAddress, ULONG ulSize)
+{
+    ULONG ulPage;
+
+    while(ulSize)
+    {
+        ulPage=ulAddress/PAGE_SIZE;
+        if(ulPage!=*pulLastPage)
+        {
+            if(*pulLastPage!=0xFFFFFFFFul)
+                ulPrograms++;
+            *pulLastPage=ulPage;
+        }
+        ulSize-=min(ulSize, PAGE_SIZE-ulAddress%PAGE_SIZE);
+        ulAddress=(ulPage+1)*PAGE_SIZE;
+    }
+
+    return ulPrograms;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    UWORD uwPageOrder[FLMTEST_ORDER_PAGES];
+    UWORD uwPageLast[FLMTEST_ORDER_PAGES];
+    ULONG ulSession,ulPrograms,ulLegacy,ulLastPage,ulOffset,ulCut;
+    ULONG ulSeqPrograms,ulSeqLegacy,ulMixPrograms,ulMixLegacy;
+    HPVOID hpvNext;
+    UWORD ct,uwPage,uwOffset,uwSize;
+    BOOL bOk;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    FlashMgrInit();
+    uwHostSimFlashTimeScale=0;
+    for(ulOffset=0;ulOffset<2*FLMTEST_STREAM_BYTES;ulOffset++)
+        ubFlmTestPattern[ulOffset]=(UBYTE)(flmtestrand()|1);
+
+        // lock held: second session refused
+    HOSTSIMTEST_CHECK(FlashMgrBegin(0)==FLASHMGR_R_OK);
+    HOSTSIMTEST_CHECK(FlashMgrBegin(0)==FLASHMGR_R_LOCKFAILED);
+    HOSTSIMTEST_CHECK(FlashMgrEnd(&hpvNext)==FLASHMGR_R_OK);
+    HOSTSIMTEST_CHECK(hpvNext==NULL);
+
+        // scattered sessions over more pages than cached: content, at most
+        // one program per page and eviction
+    for(ulSession=0,bOk=TRUE;ulSession<FLMTEST_SCATTER_SESSIONS;ulSession++)
+    {
+        flmtesterase(SUBSECTOR_SIZE);
+        flmtestsession(FLMTEST_SCATTER_PAGES);
+        ulPrograms=sHostSimFlashStats.ulPagePrograms;
+        bOk=bOk && flmtestreplay()==FLASHMGR_R_OK;
+        bOk=bOk && memcmp(&ubHostSimFlash[FLMTEST_BASE], ubFlmTestPattern, FLMTEST_SCATTER_PAGES*PAGE_SIZE)==0;
+        bOk=bOk && sHostSimFlashStats.ulPagePrograms-ulPrograms>=FLMTEST_SCATTER_PAGES;
+        bOk=bOk && sHostSimFlashStats.ulPagePrograms-ulPrograms<=uwFlmTestWrites+FLMTEST_SCATTER_PAGES;
+    }
+    HOSTSIMTEST_CHECK(bOk);
+
+        // rewrites of cached pages: last value, one program of the dirty
+        // range of each page, next location after the last written page
+    flmtesterase(SUBSECTOR_SIZE);
+    memset(ubFlmTestRef, 0xFF, sizeof(ubFlmTestRef));
+    ulPrograms=sHostSimFlashStats.ulPagePrograms;
+    HOSTSIMTEST_CHECK(FlashMgrBegin(0)==FLASHMGR_R_OK);
+    for(ct=0;ct<FLMTEST_REWRITES;ct++)
+    {
+        uwOffset=(UWORD)(16+flmtestrand()%(FLMTEST_REWRITE_PAGES*PAGE_SIZE-16-FLMTEST_WRITE_MAX));
+        uwSize=(UWORD)(1+flmtestrand()%FLMTEST_WRITE_MAX);
+        ulOffset=flmtestrand()%(FLMTEST_STREAM_BYTES-FLMTEST_WRITE_MAX);
+        HOSTSIMTEST_CHECK(FlashMgrWriteData(FLMTEST_LINEAR(uwOffset), &ubFlmTestPattern[ulOffset], uwSize)==FLASHMGR_R_OK);
+        memcpy(&ubFlmTestRef[uwOffset], &ubFlmTestPattern[ulOffset], uwSize);
+    }
+    uwPage=(UWORD)((uwOffset+uwSize-1)/PAGE_SIZE);
+    HOSTSIMTEST_CHECK(FlashMgrEnd(&hpvNext)==FLASHMGR_R_OK);
+    HOSTSIMTEST_CHECK(hpvNext==FLMTEST_LINEAR((uwPage+1)*PAGE_SIZE));
+    HOSTSIMTEST_CHECK(sHostSimFlashStats.ulPagePrograms-ulPrograms==FLMTEST_REWRITE_PAGES);
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLMTEST_BASE], ubFlmTestRef, FLMTEST_REWRITE_PAGES*PAGE_SIZE)==0);
+
+        // write back in order of last write: power cut at the n-th program,
+        // the pages written back before are complete, the next ones dropped
+    for(ulSession=0,bOk=TRUE;ulSession<FLMTEST_ORDER_SESSIONS;ulSession++)
+    {
+        flmtestsession(FLMTEST_ORDER_PAGES);
+        for(ct=0;ct<uwFlmTestWrites;ct++)
+        {
+            uwPage=(UWORD)((sFlmTestWrites[ct].uwOffset+sFlmTestWrites[ct].uwSize-1)/PAGE_SIZE);
+            for(uwOffset=(UWORD)(sFlmTestWrites[ct].uwOffset/PAGE_SIZE);uwOffset<=uwPage;uwOffset++)
+                uwPageLast[uwOffset]=ct;
+        }
+            // pages sorted by their last write
+        for(ct=0;ct<FLMTEST_ORDER_PAGES;ct++)
+            uwPageOrder[ct]=ct;
+        for(ct=1;ct<FLMTEST_ORDER_PAGES;ct++)
+            for(uwPage=ct;uwPage>0 && uwPageLast[uwPageOrder[uwPage-1]]>uwPageLast[uwPageOrder[uwPage]];uwPage--)
+            {
+                uwOffset=uwPageOrder[uwPage];
+                uwPageOrder[uwPage]=uwPageOrder[uwPage-1];
+                uwPageOrder[uwPage-1]=uwOffset;
+            }
+
+        for(ulCut=1;ulCut<=FLMTEST_ORDER_PAGES;ulCut++)
+        {
+            flmtesterase(SUBSECTOR_SIZE);
+            ulHostSimFlashPowerCut=ulCut;
+            bOk=bOk && flmtestreplay()==FLASHMGR_R_FLASHERROR;
+            for(ct=0;ct<FLMTEST_ORDER_PAGES;ct++)
+            {
+                uwOffset=(UWORD)(uwPageOrder[ct]*PAGE_SIZE);
+                if(ct+1<ulCut)
+                    bOk=bOk && memcmp(&ubHostSimFlash[FLMTEST_BASE+uwOffset], &ubFlmTestPattern[uwOffset], PAGE_SIZE)==0;
+                else if(ct+1>ulCut)
+                    bOk=bOk && ubHostSimFlash[FLMTEST_BASE+uwOffset]==0xFF &&
+                        memcmp(&ubHostSimFlash[FLMTEST_BASE+uwOffset], &ubHostSimFlash[FLMTEST_BASE+uwOffset+1], PAGE_SIZE-1)==0;
+            }
+        }
+    }
+    HOSTSIMTEST_CHECK(bOk);
+    flmtesterase(SUBSECTOR_SIZE);
+
+        // sequential stream, then two interleaved streams: page programs
+        // against the single page buffer
+    flmtesterase(FLMTEST_STREAM_AREA);
+    ulPrograms=sHostSimFlashStats.ulPagePrograms;
+    ulLastPage=0xFFFFFFFFul;
+    ulLegacy=0;
+    HOSTSIMTEST_CHECK(FlashMgrBegin(0)==FLASHMGR_R_OK);
+    for(ulOffset=0;ulOffset<FLMTEST_STREAM_BYTES;ulOffset+=FLMTEST_STREAM_WRITE)
+    {
+        FlashMgrWriteData(FLMTEST_LINEAR(ulOffset), &ubFlmTestPattern[ulOffset], FLMTEST_STREAM_WRITE);
+        ulLegacy=flmtestlegacy(ulLegacy, &ulLastPage, FLMTEST_BASE+ulOffset, FLMTEST_STREAM_WRITE);
+    }
+    HOSTSIMTEST_CHECK(FlashMgrEnd(NULL)==FLASHMGR_R_OK);
+    ulSeqPrograms=sHostSimFlashStats.ulPagePrograms-ulPrograms;
+    ulSeqLegacy=ulLegacy+1;
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLMTEST_BASE], ubFlmTestPattern, FLMTEST_STREAM_BYTES)==0);
+    HOSTSIMTEST_CHECK(ulSeqPrograms==ulSeqLegacy);
+
+    flmtesterase(FLMTEST_STREAM_AREA);
+    ulPrograms=sHostSimFlashStats.ulPagePrograms;
+    ulLastPage=0xFFFFFFFFul;
+    ulLegacy=0;
+    HOSTSIMTEST_CHECK(FlashMgrBegin(0)==FLASHMGR_R_OK);
+    for(ulOffset=0;ulOffset<FLMTEST_STREAM_BYTES;ulOffset+=FLMTEST_STREAM_WRITE)
+    {
+        FlashMgrWriteData(FLMTEST_LINEAR(ulOffset), &ubFlmTestPattern[ulOffset], FLMTEST_STREAM_WRITE);
+        ulLegacy=flmtestlegacy(ulLegacy, &ulLastPage, FLMTEST_BASE+ulOffset, FLMTEST_STREAM_WRITE);
+        FlashMgrWriteData(FLMTEST_LINEAR(FLMTEST_STREAM_AREA/2+ulOffset), &ubFlmTestPattern[FLMTEST_STREAM_BYTES+ulOffset], FLMTEST_STREAM_WRITE);
+        ulLegacy=flmtestlegacy(ulLegacy, &ulLastPage, FLMTEST_BASE+FLMTEST_STREAM_AREA/2+ulOffset, FLMTEST_STREAM_WRITE);
+    }
+    HOSTSIMTEST_CHECK(FlashMgrEnd(NULL)==FLASHMGR_R_OK);
+    ulMixPrograms=sHostSimFlashStats.ulPagePrograms-ulPrograms;
+    ulMixLegacy=ulLegacy+1;
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLMTEST_BASE], ubFlmTestPattern, FLMTEST_STREAM_BYTES)==0);
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLMTEST_BASE+FLMTEST_STREAM_AREA/2], &ubFlmTestPattern[FLMTEST_STREAM_BYTES], FLMTEST_STREAM_BYTES)==0);
+    HOSTSIMTEST_CHECK(ulMixPrograms==2*ulSeqPrograms);
+    HOSTSIMTEST_CHECK(ulMixPrograms*10<ulMixLegacy);
+
+    printf("FlashManagerTest: streams of %u bytes in %u byte writes: sequential %lu page programs (single page buffer %lu), two interleaved %lu (%lu)\n",
+        (unsigned)FLMTEST_STREAM_BYTES, (unsigned)FLMTEST_STREAM_WRITE, (unsigned long)ulSeqPrograms, (unsigned long)ulSeqLegacy,
+        (unsigned long)ulMixPrograms, (unsigned long)ulMixLegacy);
+
+    return HOSTSIMTEST_RESULT("FlashManagerTest");
+}
@@ -0,0 +1,211 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : FlashQueueAmpTest.c                                        */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Flash queue served by the second core thread: mailbox      */
+/*               requests, completions on CPU0, boot handover, read lock    */
+/*                                                                          */
+/****************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\AmpMailbox.h"
+#include "common\FlashQueue.h"
+#include "common\TaskScheduler.h"
+#include "core\Cpu1.h"
+#include "core\Flash.h"
+#include "HostSim.h"
+#include "HostSimHal.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // test area, device address (two sectors, not used by the firmware)
+#define FLQAMPTEST_BASE                 0xE00000ul
+    // pages written through the second core, more than the queue holds
+#define FLQAMPTEST_PAGES                48
+    // read locks taken while they are served
+#define FLQAMPTEST_LOCKS                200
+    // CPU0 background passes before giving up
+#define FLQAMPTEST_MAX_POLLS            20000000ul
+
+//***************************************************************************
+// Locals
+
+static UBYTE ubFlqAmpTestData[FLQAMPTEST_PAGES*PAGE_SIZE];
+static UBYTE ubFlqAmpTestSnap[FLQAMPTEST_PAGES*PAGE_SIZE];
+
+    // completed tickets in callback order, callbacks off the CPU0 thread
+static ULONG ulFlqAmpTestDone[2*FLQAMPTEST_PAGES];
+static volatile UWORD uwFlqAmpTestDoneCount;
+static ULONG ulFlqAmpTestForeign;
+static pthread_t sFlqAmpTestCpu0;
+
+//***************************************************************************
+// Completion callback: record the ticket and the calling thread
+
+static void flqamptestdone(HPVOID hpvContext, ULONG ulTicket)
+{
+    (void)hpvContext;
+
+    if(!pthread_equal(pthread_self(), sFlqAmpTestCpu0))
+        ulFlqAmpTestForeign++;
+    if(uwFlqAmpTestDoneCount<sizeof(ulFlqAmpTestDone)/sizeof(ULONG))
+        ulFlqAmpTestDone[uwFlqAmpTestDoneCount]=ulTicket;
+    uwFlqAmpTestDoneCount++;
+}
+
+//***************************************************************************
+// CPU0 background pass, serving the completions, until # callbacks seen;
+// FALSE on timeout
+
+static BOOL flqamptestrun(UWORD uwCallbacks)
+{
+    ULONG ulPolls;
+
+    for(ulPolls=0;ulPolls<FLQAMPTEST_MAX_POLLS;ulPolls++)
+    {
+        TaskSched_BackgroundLoop();
+        if(!FlashQ_Busy() && uwFlqAmpTestDoneCount>=uwCallbacks)
+            return TRUE;
+        sched_yield();
+    }
+
+    return FALSE;
+}
+
+//***************************************************************************
+// TRUE if flash range is erased
+
+static BOOL flqamptesterased(ULONG ulAddress, ULONG ulSize)
+{
+    while(ulSize--)
+        if(ubHostSimFlash[ulAddress++]!=0xFF)
+            return FALSE;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    ULONG ulTicket[FLQAMPTEST_PAGES+2];
+    ULONG ulReads,ulPrograms,ulErases,ulFull;
+    UWORD ct,uwQueued,uwLocks;
+    BOOL bOrder,bStill,bSame;
+    SWORD swRes;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    Flash_Init();
+    sFlqAmpTestCpu0=pthread_self();
+    for(ct=0;ct<sizeof(ubFlqAmpTestData)/sizeof(UWORD);ct++)
+        ((UWORD *)ubFlqAmpTestData)[ct]=(UWORD)(ct*7919+13);
+
+    HOSTSIMTEST_CHECK(TaskSched_Init());
+    HOSTSIMTEST_CHECK(AmpMbox_Init());
+    HOSTSIMTEST_CHECK(FlashQ_Init());
+
+        // boot, second core not started: served by the waiting task, as
+        // on a single core, callback from the tick
+    HOSTSIMTEST_CHECK(!Cpu1_IsStarted());
+    HOSTSIMTEST_CHECK(FlashQ_Erase(FLQAMPTEST_BASE, 2*SECTOR_SIZE, flqamptestdone, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Wait(ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(uwFlqAmpTestDoneCount==1 && ulFlqAmpTestDone[0]==ulTicket[0]);
+    HOSTSIMTEST_CHECK(flqamptesterased(FLQAMPTEST_BASE, 2*SECTOR_SIZE));
+
+        // request queued at boot, left to the second core
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQAMPTEST_BASE, ubFlqAmpTestData, 3*PAGE_SIZE, flqamptestdone, NULL, &ulTicket[1])==FLASHQ_R_OK);
+    FlashQ_Tick();
+    HOSTSIMTEST_CHECK(!FlashQ_IsDone(ulTicket[1]));
+
+    Cpu1_Start(&TaskSched_BackgroundSchedulerCpu1);
+    HOSTSIMTEST_CHECK(Cpu1_IsStarted());
+
+        // CPU0 tick no longer touches the device
+    ulReads=sHostSimFlashStats.ulStatusReads;
+    HOSTSIMTEST_CHECK(flqamptestrun(2));
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[1])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(ulFlqAmpTestDone[1]==ulTicket[1]);
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQAMPTEST_BASE], ubFlqAmpTestData, 3*PAGE_SIZE)==0);
+    HOSTSIMTEST_CHECK(sHostSimFlashStats.ulStatusReads!=ulReads);
+    ulReads=sHostSimFlashStats.ulStatusReads;
+    for(ct=0;ct<100;ct++)
+        FlashQ_Tick();
+    HOSTSIMTEST_CHECK(sHostSimFlashStats.ulStatusReads==ulReads);
+
+        // more pages than the queue holds: full queue refused, callbacks in
+        // ticket order on CPU0, data as written
+    HOSTSIMTEST_CHECK(FlashQ_Erase(FLQAMPTEST_BASE, 2*SECTOR_SIZE, NULL, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Wait(ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(flqamptesterased(FLQAMPTEST_BASE, 2*SECTOR_SIZE));
+    uwFlqAmpTestDoneCount=0;
+    ulFull=0;
+    for(uwQueued=0;uwQueued<FLQAMPTEST_PAGES;)
+    {
+        swRes=FlashQ_Write(FLQAMPTEST_BASE+uwQueued*PAGE_SIZE, &ubFlqAmpTestData[uwQueued*PAGE_SIZE], PAGE_SIZE, flqamptestdone, NULL, &ulTicket[uwQueued]);
+        if(swRes==FLASHQ_R_OK)
+            uwQueued++;
+        else
+        {
+            HOSTSIMTEST_CHECK(swRes==FLASHQ_R_QUEUEFULL);
+            ulFull++;
+            TaskSched_BackgroundLoop();
+            sched_yield();
+        }
+    }
+    HOSTSIMTEST_CHECK(flqamptestrun(FLQAMPTEST_PAGES));
+    HOSTSIMTEST_CHECK(ulFull>0);
+    HOSTSIMTEST_CHECK(uwFlqAmpTestDoneCount==FLQAMPTEST_PAGES);
+    for(ct=0,bOrder=TRUE;ct<FLQAMPTEST_PAGES;ct++)
+        bOrder=bOrder && ulFlqAmpTestDone[ct]==ulTicket[ct] && (ct==0 || ulTicket[ct]==ulTicket[ct-1]+1);
+    HOSTSIMTEST_CHECK(bOrder);
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[FLQAMPTEST_PAGES-1])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQAMPTEST_BASE], ubFlqAmpTestData, FLQAMPTEST_PAGES*PAGE_SIZE)==0);
+    HOSTSIMTEST_CHECK(ulFlqAmpTestForeign==0);
+
+        // failed command result back through the shared history
+    ulHostSimFlashFailCmds=1;
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQAMPTEST_BASE+SECTOR_SIZE, ubFlqAmpTestData, PAGE_SIZE, NULL, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Wait(ulTicket[0])==FLASHQ_R_FLASHFAIL);
+    HOSTSIMTEST_CHECK(flqamptesterased(FLQAMPTEST_BASE+SECTOR_SIZE, PAGE_SIZE));
+
+        // read lock while CPU1 serves erase and programs: no command
+        // starts or runs while held, the content read stays the same
+    HOSTSIMTEST_CHECK(FlashQ_Erase(FLQAMPTEST_BASE, 2*SECTOR_SIZE, NULL, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    for(ct=0;ct<FLASHQ_MAX_REQUESTS-1;ct++)
+        HOSTSIMTEST_CHECK(FlashQ_Write(FLQAMPTEST_BASE+ct*4*PAGE_SIZE, &ubFlqAmpTestData[ct*4*PAGE_SIZE], 4*PAGE_SIZE, NULL, NULL, &ulTicket[ct+1])==FLASHQ_R_OK);
+    for(uwLocks=0,bStill=TRUE,bSame=TRUE;uwLocks<FLQAMPTEST_LOCKS && FlashQ_Busy();uwLocks++)
+    {
+        FlashQ_ReadLock();
+        ulPrograms=sHostSimFlashStats.ulPagePrograms;
+        ulErases=sHostSimFlashStats.ulSectorErases;
+        memcpy(ubFlqAmpTestSnap, &ubHostSimFlash[FLQAMPTEST_BASE], sizeof(ubFlqAmpTestSnap));
+        for(ct=0;ct<20;ct++)
+            sched_yield();
+        bStill=bStill && sHostSimFlashStats.ulPagePrograms==ulPrograms && sHostSimFlashStats.ulSectorErases==ulErases;
+        bSame=bSame && memcmp(ubFlqAmpTestSnap, &ubHostSimFlash[FLQAMPTEST_BASE], sizeof(ubFlqAmpTestSnap))==0;
+        FlashQ_ReadUnlock();
+        sched_yield();
+    }
+    HOSTSIMTEST_CHECK(bStill && bSame);
+    HOSTSIMTEST_CHECK(flqamptestrun(0));
+    for(ct=0;ct<FLASHQ_MAX_REQUESTS;ct++)
+        HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[ct])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQAMPTEST_BASE], ubFlqAmpTestData, (FLASHQ_MAX_REQUESTS-1)*4*PAGE_SIZE)==0);
+    HOSTSIMTEST_CHECK(AmpMbox_Pending(AMPMBOX_TOCPU0)==0 && AmpMbox_Pending(AMPMBOX_TOCPU1)==0);
+
+    printf("FlashQueueAmpTest: %u pages served on CPU1, %lu full queue retries, %u read locks\n",
+        (unsigned)FLQAMPTEST_PAGES, (unsigned long)ulFull, (unsigned)uwLocks);
+
+    return HOSTSIMTEST_RESULT("FlashQueueAmpTest");
+}
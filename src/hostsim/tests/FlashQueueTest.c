@@ -0,0 +1,284 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : FlashQueueTest.c                                           */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Flash queue: tickets, callbacks, erase bounds, failure     */
+/*               results, read lock, background service with realtime ticks */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\FlashQueue.h"
+#include "common\ProgramFlashHandler.h"
+#include "common\TaskScheduler.h"
+#include "core\Flash.h"
+#include "core\Timer.h"
+#include "drive\AxM-E-Defines.h"
+#include "HostSim.h"
+#include "HostSimHal.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // test area, device address (two sectors, not used by the firmware)
+#define FLQTEST_BASE                    0xE00000ul
+    // data written across pages
+#define FLQTEST_DATA_SIZE               (3*PAGE_SIZE+40)
+    // pages written while realtime ticks run, max ticks to serve them
+#define FLQTEST_BKG_PAGES               16
+#define FLQTEST_BKG_MAX_TICKS           (2*REALTIME_TASK_FREQ)
+
+//***************************************************************************
+// Locals
+
+static UBYTE ubFlqTestData[4*PAGE_SIZE];
+static UBYTE ubFlqTestZero[2*SUBSECTOR_SIZE];
+
+    // completed tickets in callback order, ticket queued from a callback
+static ULONG ulFlqTestDone[32];
+static UWORD uwFlqTestDoneCount;
+static ULONG ulFlqTestChained;
+
+    // background service: realtime calls, worst tick time and status reads
+static ULONG ulFlqTestRTCalls;
+static ULLNG ullFlqTestMaxTick;
+static ULONG ulFlqTestMaxReads;
+
+//***************************************************************************
+// Completion callback: record the ticket, with a context queue another
+// request (the completed one is already free)
+
+static void flqtestdone(HPVOID hpvContext, ULONG ulTicket)
+{
+    if(uwFlqTestDoneCount<sizeof(ulFlqTestDone)/sizeof(ULONG))
+        ulFlqTestDone[uwFlqTestDoneCount++]=ulTicket;
+
+    if(hpvContext)
+        FlashQ_Write(FLQTEST_BASE+0x3000, ubFlqTestData, 16, flqtestdone, NULL, &ulFlqTestChained);
+}
+
+//***************************************************************************
+// Serve the queue until empty, the device status reads move the clock
+
+static void flqtestrun(void)
+{
+    while(FlashQ_Busy())
+        FlashQ_Tick();
+}
+
+//***************************************************************************
+// TRUE if flash range is erased
+
+static BOOL flqtesterased(ULONG ulAddress, ULONG ulSize)
+{
+    while(ulSize--)
+        if(ubHostSimFlash[ulAddress++]!=0xFF)
+            return FALSE;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Realtime task and background tick after each slot
+
+static BOOL flqtestrttask(void)
+{
+    ulFlqTestRTCalls++;
+
+    return TRUE;
+}
+
+static void flqtestbkg(ULONG ulTick)
+{
+    ULLNG ullStart=HostSim_GetTime();
+    ULONG ulReads=sHostSimFlashStats.ulStatusReads;
+
+    (void)ulTick;
+    FlashQ_Tick();
+
+    if(HostSim_GetTime()-ullStart>ullFlqTestMaxTick)
+        ullFlqTestMaxTick=HostSim_GetTime()-ullStart;
+    if(sHostSimFlashStats.ulStatusReads-ulReads>ulFlqTestMaxReads)
+        ulFlqTestMaxReads=sHostSimFlashStats.ulStatusReads-ulReads;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    ULONG ulTicket[FLASHQ_MAX_REQUESTS+1];
+    ULONG ulFailed,ulPrograms,ulErases,ulTicks;
+    ULLNG ullStart,ullQueued,ullBlocking;
+    UWORD ct;
+    BOOL bOrder;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    Flash_Init();
+    for(ct=0;ct<sizeof(ubFlqTestData);ct++)
+        ubFlqTestData[ct]=(UBYTE)(ct*13+5);
+
+        // ordered tickets and callbacks, chained request, data across
+        // pages, sector and sub-sector erase bounds
+    FlashWrite(FLQTEST_BASE+0x10000, ubFlqTestZero, sizeof(ubFlqTestZero));
+    FlashWrite(FLQTEST_BASE+0x100, ubFlqTestZero, 16);
+    ulErases=sHostSimFlashStats.ulSectorErases;
+    HOSTSIMTEST_CHECK(FlashQ_Erase(FLQTEST_BASE, SECTOR_SIZE, flqtestdone, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+8, ubFlqTestData, FLQTEST_DATA_SIZE, flqtestdone, NULL, &ulTicket[1])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+0x2000-5, ubFlqTestData, 10, flqtestdone, &ulFlqTestChained, &ulTicket[2])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Erase(FLQTEST_BASE+0x10000, 100, flqtestdone, NULL, &ulTicket[3])==FLASHQ_R_OK);
+    for(ct=1;ct<4;ct++)
+        HOSTSIMTEST_CHECK(ulTicket[ct]==ulTicket[ct-1]+1);
+    HOSTSIMTEST_CHECK(FlashQ_Busy());
+    HOSTSIMTEST_CHECK(!FlashQ_IsDone(ulTicket[0]));
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[0])==FLASHQ_R_PENDING);
+    flqtestrun();
+    HOSTSIMTEST_CHECK(uwFlqTestDoneCount==5);
+    for(ct=0,bOrder=TRUE;ct<4;ct++)
+    {
+        bOrder=bOrder && ulFlqTestDone[ct]==ulTicket[ct];
+        HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[ct])==FLASHQ_R_OK);
+    }
+    HOSTSIMTEST_CHECK(bOrder);
+    HOSTSIMTEST_CHECK(ulFlqTestDone[4]==ulFlqTestChained && ulFlqTestChained==ulTicket[3]+1);
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulFlqTestChained)==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(sHostSimFlashStats.ulSectorErases-ulErases==2);
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQTEST_BASE+8], ubFlqTestData, FLQTEST_DATA_SIZE)==0);
+    HOSTSIMTEST_CHECK(flqtesterased(FLQTEST_BASE, 8));
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQTEST_BASE+0x2000-5], ubFlqTestData, 10)==0);
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQTEST_BASE+0x3000], ubFlqTestData, 16)==0);
+    HOSTSIMTEST_CHECK(flqtesterased(FLQTEST_BASE+0x10000, SUBSECTOR_SIZE));
+    HOSTSIMTEST_CHECK(ubHostSimFlash[FLQTEST_BASE+0x10000+SUBSECTOR_SIZE]==0x00);
+
+        // erase over a sector boundary: both sectors
+    ulErases=sHostSimFlashStats.ulSectorErases;
+    HOSTSIMTEST_CHECK(FlashQ_Erase(FLQTEST_BASE, SECTOR_SIZE+1, NULL, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Wait(ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(sHostSimFlashStats.ulSectorErases-ulErases==2);
+    HOSTSIMTEST_CHECK(flqtesterased(FLQTEST_BASE, 2*SECTOR_SIZE));
+
+        // queue full, invalid size
+    for(ct=0;ct<FLASHQ_MAX_REQUESTS;ct++)
+        HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+ct*16, ubFlqTestData, 4, NULL, NULL, &ulTicket[ct])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+0x800, ubFlqTestData, 4, NULL, NULL, &ulTicket[ct])==FLASHQ_R_QUEUEFULL);
+    HOSTSIMTEST_CHECK(FlashQ_Erase(FLQTEST_BASE, 0, NULL, NULL, NULL)==FLASHQ_R_INVALIDSIZE);
+    flqtestrun();
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[FLASHQ_MAX_REQUESTS-1])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(flqtesterased(FLQTEST_BASE+0x800, 4));
+
+        // failed command: rest of the request dropped, next request fine
+    ulFailed=sHostSimFlashStats.ulFailedCmds;
+    ulPrograms=sHostSimFlashStats.ulPagePrograms;
+    ulHostSimFlashFailCmds=1;
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+0x1000, ubFlqTestData, 3*PAGE_SIZE, NULL, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+0x2000, ubFlqTestData, PAGE_SIZE, NULL, NULL, &ulTicket[1])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[1]+1)==FLASHQ_R_PENDING);
+    flqtestrun();
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[0])==FLASHQ_R_FLASHFAIL);
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[1])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(sHostSimFlashStats.ulFailedCmds-ulFailed==1);
+    HOSTSIMTEST_CHECK(sHostSimFlashStats.ulPagePrograms-ulPrograms==2);
+    HOSTSIMTEST_CHECK(flqtesterased(FLQTEST_BASE+0x1000, 3*PAGE_SIZE));
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQTEST_BASE+0x2000], ubFlqTestData, PAGE_SIZE)==0);
+
+        // failed erase, then its result expires after the history
+    ulHostSimFlashFailCmds=1;
+    HOSTSIMTEST_CHECK(FlashQ_Erase(FLQTEST_BASE, SUBSECTOR_SIZE, NULL, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Wait(ulTicket[0])==FLASHQ_R_FLASHFAIL);
+    HOSTSIMTEST_CHECK(!flqtesterased(FLQTEST_BASE+0x2000, 4));
+    for(ct=0;ct<FLASHQ_RESULT_HISTORY-1;ct++)
+    {
+        HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+0x4000+ct*4, ubFlqTestData, 4, NULL, NULL, &ulTicket[1])==FLASHQ_R_OK);
+        flqtestrun();
+    }
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[0])==FLASHQ_R_FLASHFAIL);
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+0x4000+ct*4, ubFlqTestData, 4, NULL, NULL, &ulTicket[1])==FLASHQ_R_OK);
+    flqtestrun();
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[0])==FLASHQ_R_EXPIRED);
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[1])==FLASHQ_R_OK);
+
+        // program flash handler results, queued and power fail bypass
+    for(ct=0;ct<2;ct++)
+    {
+        bProgramFlashCritSectBypass=(BOOL)ct;
+        HOSTSIMTEST_CHECK(ProgramFlashErase((void *)(XPS_QSPI_LINEAR_BASEADDR+FLQTEST_BASE+0x8000), SUBSECTOR_SIZE)==0);
+        HOSTSIMTEST_CHECK(ProgramFlashWrite((void *)(XPS_QSPI_LINEAR_BASEADDR+FLQTEST_BASE+0x8000), ubFlqTestData, PAGE_SIZE)==0);
+        HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQTEST_BASE+0x8000], ubFlqTestData, PAGE_SIZE)==0);
+        ulHostSimFlashFailCmds=1;
+        HOSTSIMTEST_CHECK(ProgramFlashWrite((void *)(XPS_QSPI_LINEAR_BASEADDR+FLQTEST_BASE+0x8100), ubFlqTestData, PAGE_SIZE)==1);
+        ulHostSimFlashFailCmds=1;
+        HOSTSIMTEST_CHECK(ProgramFlashErase((void *)(XPS_QSPI_LINEAR_BASEADDR+FLQTEST_BASE+0x8000), SUBSECTOR_SIZE)==1);
+        HOSTSIMTEST_CHECK(!flqtesterased(FLQTEST_BASE+0x8000, PAGE_SIZE));
+    }
+    bProgramFlashCritSectBypass=FALSE;
+
+        // read lock: queued request held off, also by nested locks
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+0x5000, ubFlqTestData, PAGE_SIZE, NULL, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    FlashQ_ReadLock();
+    FlashQ_ReadLock();
+    for(ct=0;ct<100;ct++)
+        FlashQ_Tick();
+    FlashQ_ReadUnlock();
+    for(ct=0;ct<100;ct++)
+        FlashQ_Tick();
+    HOSTSIMTEST_CHECK(!FlashQ_IsDone(ulTicket[0]));
+    HOSTSIMTEST_CHECK(flqtesterased(FLQTEST_BASE+0x5000, PAGE_SIZE));
+    FlashQ_ReadUnlock();
+    flqtestrun();
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQTEST_BASE+0x5000], ubFlqTestData, PAGE_SIZE)==0);
+
+        // read lock: request in progress completed, next one held off
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+0x6000, ubFlqTestData, 3*PAGE_SIZE, NULL, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+0x7000, ubFlqTestData, PAGE_SIZE, NULL, NULL, &ulTicket[1])==FLASHQ_R_OK);
+    FlashQ_Tick();
+    HOSTSIMTEST_CHECK(!FlashQ_IsDone(ulTicket[0]));
+    FlashQ_ReadLock();
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQTEST_BASE+0x6000], ubFlqTestData, 3*PAGE_SIZE)==0);
+    HOSTSIMTEST_CHECK(!FlashQ_IsDone(ulTicket[1]));
+    HOSTSIMTEST_CHECK(flqtesterased(FLQTEST_BASE+0x7000, PAGE_SIZE));
+    FlashQ_ReadUnlock();
+    flqtestrun();
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[1])==FLASHQ_R_OK);
+
+        // background service while realtime ticks run: sector erase and
+        // page programs, one status read per tick, no overrun
+    HOSTSIMTEST_CHECK(TaskSched_Init());
+    HOSTSIMTEST_CHECK(TaskSched_AddRTTask(&flqtestrttask, TASKSCHEDULER_FLAG_NONE, 0, 0, 0));
+    Timer_Init(REALTIME_TASK_FREQ, TaskSched_RTScheduler);
+    HostSim_SetTickHooks(NULL, flqtestbkg);
+    HOSTSIMTEST_CHECK(FlashQ_Erase(FLQTEST_BASE+SECTOR_SIZE, SECTOR_SIZE, NULL, NULL, &ulTicket[0])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+SECTOR_SIZE, ubFlqTestData, FLQTEST_BKG_PAGES*PAGE_SIZE/4, NULL, NULL, &ulTicket[1])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(FlashQ_Write(FLQTEST_BASE+SECTOR_SIZE+FLQTEST_BKG_PAGES*PAGE_SIZE/4, ubFlqTestZero, FLQTEST_BKG_PAGES*PAGE_SIZE*3/4, NULL, NULL, &ulTicket[2])==FLASHQ_R_OK);
+    ullStart=HostSim_GetTime();
+    for(ulTicks=0;ulTicks<FLQTEST_BKG_MAX_TICKS && FlashQ_Busy();ulTicks++)
+        HOSTSIMTEST_CHECK(HostSim_RunTicks(1)==0);
+    ullQueued=HostSim_GetTime()-ullStart;
+    HOSTSIMTEST_CHECK(!FlashQ_Busy());
+    HOSTSIMTEST_CHECK(FlashQ_Result(ulTicket[2])==FLASHQ_R_OK);
+    HOSTSIMTEST_CHECK(ulFlqTestRTCalls==ulTicks);
+    HOSTSIMTEST_CHECK(sHostSimStats.ulOverruns==0);
+    HOSTSIMTEST_CHECK(ulFlqTestMaxReads<=1);
+    HOSTSIMTEST_CHECK(ullFlqTestMaxTick<=2*HOSTSIM_FLASH_STATUS_TIME);
+    HOSTSIMTEST_CHECK(memcmp(&ubHostSimFlash[FLQTEST_BASE+SECTOR_SIZE], ubFlqTestData, FLQTEST_BKG_PAGES*PAGE_SIZE/4)==0);
+        // device time, plus at most one slot per command
+    HOSTSIMTEST_CHECK(ullQueued>=HOSTSIM_FLASH_ERASE_TIME+FLQTEST_BKG_PAGES*HOSTSIM_FLASH_PROGRAM_TIME);
+    HOSTSIMTEST_CHECK(ullQueued<=HOSTSIM_FLASH_ERASE_TIME+FLQTEST_BKG_PAGES*HOSTSIM_FLASH_PROGRAM_TIME+(FLQTEST_BKG_PAGES+2)*HOSTSIM_TIMER_TICKS_PER_RTSLOT);
+
+        // same erase blocking the caller
+    ullStart=HostSim_GetTime();
+    FlashErase(FLQTEST_BASE+SECTOR_SIZE, SECTOR_SIZE);
+    ullBlocking=HostSim_GetTime()-ullStart;
+
+    printf("FlashQueueTest: erase and %u pages served in %lu ticks (%.1f ms), background tick max %.1f us; blocking erase %.1f ms\n",
+        (unsigned)FLQTEST_BKG_PAGES, (unsigned long)ulTicks, ullQueued/10000.0, ullFlqTestMaxTick/10.0, ullBlocking/10000.0);
+
+    return HOSTSIMTEST_RESULT("FlashQueueTest");
+}
@@ -0,0 +1,81 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimSmokeTest.c                                         */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host target smoke test: realtime ticks, simulated          */
+/*               register file and QSPI linear window                       */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\TaskScheduler.h"
+#include "core\Flash.h"
+#include "core\Timer.h"
+#include "drive\AxM-E-Defines.h"
+#include "fpga\FpgaHandler.h"
+#include "HostSim.h"
+#include "HostSimHal.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Locals
+
+static ULONG ulSmokeRTCalls;
+
+//***************************************************************************
+// Realtime task
+
+static BOOL smokertask(void)
+{
+    ulSmokeRTCalls++;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    UBYTE ubData[PAGE_SIZE+16];
+    UWORD i;
+    ULONG ulOverruns;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    Flash_Init();
+
+        // the firmware sees the register file at its Zynq address
+    HOSTSIMTEST_CHECK(sizeof(ULONG)==4);
+    HOSTSIMTEST_CHECK((UINTPTR)uwHostSimFpgaRegFile==FPGA_REGISTER_BASE_ADDRESS);
+    FPGA_REGISTER_16(0x10)=0x1234;
+    HOSTSIMTEST_CHECK(uwHostSimFpgaRegFile[0x10/sizeof(UWORD)]==0x1234);
+
+        // programmed data visible through the linear window, NOR semantics
+    for(i=0;i<sizeof(ubData);i++)
+        ubData[i]=(UBYTE)(i*7+1);
+    FlashErase(0x10000, SUBSECTOR_SIZE);
+    FlashWrite(0x10000+8, ubData, sizeof(ubData));
+    HOSTSIMTEST_CHECK(memcmp((void *)(UINTPTR)(XPS_QSPI_LINEAR_BASEADDR+0x10000+8), ubData, sizeof(ubData))==0);
+    HOSTSIMTEST_CHECK(ubHostSimFlash[0x10000+7]==0xFF);
+    ubData[0]=0xFF;
+    FlashWrite(0x10000+8, ubData, 1);
+    HOSTSIMTEST_CHECK(ubHostSimFlash[0x10000+8]==1);
+
+        // one second of realtime ticks with a single task
+    HOSTSIMTEST_CHECK(TaskSched_Init());
+    HOSTSIMTEST_CHECK(TaskSched_AddRTTask(&smokertask, TASKSCHEDULER_FLAG_NONE, 0, 0, 0));
+    Timer_Init(REALTIME_TASK_FREQ, TaskSched_RTScheduler);
+    ulOverruns=HostSim_RunTicks(REALTIME_TASK_FREQ);
+
+    HOSTSIMTEST_CHECK(ulOverruns==0);
+    HOSTSIMTEST_CHECK(sHostSimStats.ulTicks==REALTIME_TASK_FREQ);
+    HOSTSIMTEST_CHECK(ulSmokeRTCalls==REALTIME_TASK_FREQ);
+
+    return HOSTSIMTEST_RESULT("HostSimSmokeTest");
+}
@@ -0,0 +1,56 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : HostSimTest.h                                              */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Host test suites: check macros and result                  */
+/*               reporting                                                  */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _HOSTSIMTEST_H
+#define _HOSTSIMTEST_H
+
+#include <stdio.h>
+
+//***************************************************************************
+// Globals
+
+    // failed checks of the running suite
+static ULONG ulHostSimTestFailures;
+
+//***************************************************************************
+// Macros
+
+    // check a condition, report file and line on failure and go on
+#define HOSTSIMTEST_CHECK(cond)                                             \
+    do {                                                                    \
+        if(!(cond))                                                         \
+        {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ulHostSimTestFailures++;                                        \
+        }                                                                   \
+    } while(0)
+
+    // check a value within tolerance
+#define HOSTSIMTEST_CHECK_NEAR(val, ref, tol)                               \
+    do {                                                                    \
+        double dVal=(double)(val), dRef=(double)(ref);                      \
+        if(!(dVal>=dRef-(tol) && dVal<=dRef+(tol)))                         \
+        {                                                                   \
+            printf("%s:%d: check failed: %s=%g, expected %g +/-%g\n",       \
+                __FILE__, __LINE__, #val, dVal, dRef, (double)(tol));       \
+            ulHostSimTestFailures++;                                        \
+        }                                                                   \
+    } while(0)
+
+    // suite result, to be returned by main
+#define HOSTSIMTEST_RESULT(name)                                            \
+    (printf("%s: %s (%lu failed checks)\n", name,                           \
+        ulHostSimTestFailures ? "FAILED" : "passed",                        \
+        (unsigned long)ulHostSimTestFailures), ulHostSimTestFailures ? 1 : 0)
+
+#endif
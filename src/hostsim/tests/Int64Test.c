@@ -0,0 +1,366 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : Int64Test.c                                                */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Native int64 layer and SQWRD functions: exactness against  */
+/*               the previous implementation, saturation and cycles         */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\Int64Functions.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // random operand pairs per operation
+#define INT64TEST_RANDOM                200000
+    // benchmark loops and runs
+#define INT64TEST_BENCH_LOOPS           1000000
+#define INT64TEST_BENCH_RUNS            5
+
+//***************************************************************************
+// Locals
+
+static ULLNG ullInt64TestSeed=0x9E3779B97F4A7C15ull;
+static volatile SLLNG sllInt64TestSink;
+
+    // edge operands: zero, unit, 32 and 48 bit limits, 64 bit limits
+static const SLLNG sllInt64TestEdge[]=
+{
+    0, 1, -1, 2, -2,
+    SLONG_MAX_VALUE, (SLLNG)SLONG_MAX_VALUE+1, SLONG_MIN_VALUE, (SLLNG)SLONG_MIN_VALUE-1,
+    0xFFFFFFFFll, 0x100000000ll, -0x100000000ll,
+    (SLLNG)32767<<32, ((SLLNG)32767<<32)-1, -((SLLNG)32767<<32), -((SLLNG)32767<<32)-1,
+    -((SLLNG)32768<<32), S48_MAX, S48_MIN,
+    S64_MAX, S64_MAX-1, S64_MIN, S64_MIN+1
+};
+#define INT64TEST_EDGES                 (sizeof(sllInt64TestEdge)/sizeof(sllInt64TestEdge[0]))
+
+//***************************************************************************
+// Previous implementation, on the SQWRD halves, not optimized as it was
+// built; signed overflow written as the wrapping it compiled to
+
+#define INT64TEST_REF                   static __attribute__((noinline, optimize(0)))
+
+INT64TEST_REF void refadd(SQWRD * dst, const SQWRD * op1, const SQWRD * op2)
+{
+    ULLNG u64Dst=(ULLNG)MAKE_INT64(op1->hi, op1->lo)+(ULLNG)MAKE_INT64(op2->hi, op2->lo);
+    dst->hi=MAKE_SQWRDHI(u64Dst);
+    dst->lo=MAKE_SQWRDLO(u64Dst);
+}
+
+INT64TEST_REF void refsub(SQWRD * dst, const SQWRD * op1, const SQWRD * op2)
+{
+    ULLNG u64Dst=(ULLNG)MAKE_INT64(op1->hi, op1->lo)-(ULLNG)MAKE_INT64(op2->hi, op2->lo);
+    dst->hi=MAKE_SQWRDHI(u64Dst);
+    dst->lo=MAKE_SQWRDLO(u64Dst);
+}
+
+INT64TEST_REF void refmul3232(SQWRD * dst, const SLONG * op1, const SLONG * op2)
+{
+    SLLNG s64Dst=((SLLNG)(*op1))*((SLLNG)(*op2));
+    dst->hi=MAKE_SQWRDHI(s64Dst);
+    dst->lo=MAKE_SQWRDLO(s64Dst);
+}
+
+INT64TEST_REF void refmul4816(SQWRD * dst, const SQWRD * op1, const SWORD * op2)
+{
+    ULLNG u64Dst=(ULLNG)MAKE_INT64(op1->hi, op1->lo)*(ULLNG)(SLLNG)(*op2);
+    dst->hi=MAKE_SQWRDHI(u64Dst);
+    dst->lo=MAKE_SQWRDLO(u64Dst);
+}
+
+INT64TEST_REF SBYTE refcomp(SQWRD * op1, SQWRD * op2)
+{
+    if(op1->hi>op2->hi)
+        return 1;
+    else if(op1->hi<op2->hi)
+        return -1;
+    else if(op1->lo>op2->lo)
+        return 1;
+    else if(op1->lo<op2->lo)
+        return -1;
+    else
+        return 0;
+}
+
+INT64TEST_REF SLONG reftosint32(SQWRD * sqVar)
+{
+    SLLNG s64Dst=MAKE_INT64(sqVar->hi, sqVar->lo);
+
+    if(s64Dst>=(SLLNG)SLONG_MAX_VALUE)
+        return SLONG_MAX_VALUE;
+    else if(s64Dst<=(SLLNG)SLONG_MIN_VALUE)
+        return SLONG_MIN_VALUE;
+    else
+        return (SLONG)s64Dst;
+}
+
+INT64TEST_REF void reftosint48(SQWRD * sqVar)
+{
+    if(sqVar->hi>=32767l)
+    {
+        sqVar->hi=32767l;
+        sqVar->lo=(ULONG)0xffffffffUL;
+    }
+    else if(sqVar->hi<=-32768l)
+    {
+        sqVar->hi=-32768l;
+        sqVar->lo=(ULONG)0x00000001UL;
+    }
+}
+
+INT64TEST_REF void refshl(SQWRD * var, UWORD cnt)
+{
+    ULLNG u64Dst;
+
+    if(cnt!=0)
+    {
+        u64Dst=(ULLNG)MAKE_INT64(var->hi, var->lo)<<cnt;
+        var->hi=MAKE_SQWRDHI(u64Dst);
+        var->lo=MAKE_SQWRDLO(u64Dst);
+    }
+}
+
+INT64TEST_REF void refshr(SQWRD * var, UWORD cnt)
+{
+    SLLNG s64Dst;
+
+    if(cnt!=0)
+    {
+        s64Dst=MAKE_INT64(var->hi, var->lo)>>cnt;
+        var->hi=MAKE_SQWRDHI(s64Dst);
+        var->lo=MAKE_SQWRDLO(s64Dst);
+    }
+}
+
+INT64TEST_REF void refscale32(SQWRD * val, SLONG scale)
+{
+    SLLNG s64Dst=(SLLNG)((ULLNG)MAKE_INT64(val->hi, val->lo)*(ULLNG)(SLLNG)scale)>>16;
+    val->hi=MAKE_SQWRDHI(s64Dst);
+    val->lo=MAKE_SQWRDLO(s64Dst);
+}
+
+//***************************************************************************
+// Random operand, with magnitudes spread over all bit lengths
+
+static SLLNG int64testrand(void)
+{
+    ullInt64TestSeed^=ullInt64TestSeed<<13;
+    ullInt64TestSeed^=ullInt64TestSeed>>7;
+    ullInt64TestSeed^=ullInt64TestSeed<<17;
+
+    return (SLLNG)ullInt64TestSeed>>(ullInt64TestSeed%64);
+}
+
+//***************************************************************************
+// Same bits in SQWRD pair
+
+static BOOL int64testeq(const SQWRD * psq1, const SQWRD * psq2)
+{
+    return psq1->hi==psq2->hi && psq1->lo==psq2->lo;
+}
+
+//***************************************************************************
+// Compare one operand pair on all operations; return no. of mismatches
+
+static ULONG int64testpair(SLLNG sllA, SLLNG sllB)
+{
+    SQWRD sqA, sqB, sqRef, sqRes;
+    SLONG slA, slB;
+    SWORD swB;
+    SLLNG sllRef;
+    UWORD uwCnt;
+    ULONG ulErr=0;
+
+    s64_st(&sqA, sllA);
+    s64_st(&sqB, sllB);
+    slA=(SLONG)sllA;
+    slB=(SLONG)sllB;
+    swB=(SWORD)sllB;
+    uwCnt=(UWORD)((ULLNG)sllB%64);
+
+        // load/store round trip
+    ulErr+=(s64_ld(&sqA)!=sllA);
+
+        // add, sub: wrapping as before, saturating against builtin overflow
+    refadd(&sqRef, &sqA, &sqB);
+    _sint64_add(&sqRes, &sqA, &sqB);
+    ulErr+=!int64testeq(&sqRes, &sqRef);
+    ulErr+=(s64_add(sllA, sllB)!=s64_ld(&sqRef));
+    if(__builtin_add_overflow(sllA, sllB, &sllRef))
+        sllRef=sllA<0 ? S64_MIN : S64_MAX;
+    ulErr+=(s64_add_sat(sllA, sllB)!=sllRef);
+
+    refsub(&sqRef, &sqA, &sqB);
+    _sint64_sub(&sqRes, &sqA, &sqB);
+    ulErr+=!int64testeq(&sqRes, &sqRef);
+    _sint64_sub_nosaturation(&sqRes, &sqA, &sqB);
+    ulErr+=!int64testeq(&sqRes, &sqRef);
+    ulErr+=(s64_sub(sllA, sllB)!=s64_ld(&sqRef));
+    if(__builtin_sub_overflow(sllA, sllB, &sllRef))
+        sllRef=sllA<0 ? S64_MIN : S64_MAX;
+    ulErr+=(s64_sub_sat(sllA, sllB)!=sllRef);
+
+        // multiply and multiply-accumulate
+    refmul3232(&sqRef, &slA, &slB);
+    _sint64_mul_32_32(&sqRes, &slA, &slB);
+    ulErr+=!int64testeq(&sqRes, &sqRef);
+    ulErr+=(s64_mul_32_32(slA, slB)!=s64_ld(&sqRef));
+    ulErr+=(s64_mac_32_32(sllA, slA, slB)!=s64_add(sllA, s64_ld(&sqRef)));
+
+    refmul4816(&sqRef, &sqA, &swB);
+    _sint64_mul_48_16(&sqRes, &sqA, &swB);
+    ulErr+=!int64testeq(&sqRes, &sqRef);
+    ulErr+=(s64_mul_64_16(sllA, swB)!=s64_ld(&sqRef));
+
+    sqRef=sqA;
+    refscale32(&sqRef, slB);
+    sqRes=sqA;
+    _sint64p_scale_32(&sqRes, slB);
+    ulErr+=!int64testeq(&sqRes, &sqRef);
+    ulErr+=(s64_scale_q16(sllA, slB)!=s64_ld(&sqRef));
+
+        // compare
+    ulErr+=(_sint64_comp(&sqA, &sqB)!=refcomp(&sqA, &sqB));
+    ulErr+=(s64_comp(sllA, sllB)!=refcomp(&sqA, &sqB));
+
+        // shifts, saturating left shift against the wrapped one shifted back
+    sqRef=sqA;
+    refshl(&sqRef, uwCnt);
+    sqRes=sqA;
+    _sint64_shl(&sqRes, uwCnt);
+    ulErr+=!int64testeq(&sqRes, &sqRef);
+    ulErr+=(s64_shl(sllA, uwCnt)!=s64_ld(&sqRef));
+    sllRef=s64_shr(s64_ld(&sqRef), uwCnt)==sllA ? s64_ld(&sqRef) : (sllA<0 ? S64_MIN : S64_MAX);
+    ulErr+=(s64_shl_sat(sllA, uwCnt)!=sllRef);
+
+    sqRef=sqA;
+    refshr(&sqRef, uwCnt);
+    sqRes=sqA;
+    _sint64_shr(&sqRes, uwCnt);
+    ulErr+=!int64testeq(&sqRes, &sqRef);
+    ulErr+=(s64_shr(sllA, uwCnt)!=s64_ld(&sqRef));
+
+        // 32 and 48 bit saturation, middle 32 bits
+    ulErr+=(_sint64toSint32(&sqA)!=reftosint32(&sqA));
+    ulErr+=(s64_sat32(sllA)!=reftosint32(&sqA));
+    sqRef=sqA;
+    reftosint48(&sqRef);
+    sqRes=sqA;
+    _sint64toSint48(&sqRes);
+    ulErr+=!int64testeq(&sqRes, &sqRef);
+    ulErr+=(s64_sat48(sllA)!=s64_ld(&sqRef));
+    ulErr+=(s64_mid32(sllA)!=(SLONG)INT64_MLONG(sqA));
+
+    return ulErr;
+}
+
+//***************************************************************************
+// Benchmark: position integration step of the 8 kHz paths, previous
+// implementation through SQWRD calls
+
+static ULLNG int64testbenchref(void)
+{
+    SQWRD sqPos, sqDelta, sqTmp;
+    SLONG slSpeed, slTime;
+    ULLNG ullStart;
+    ULONG i;
+
+    s64_st(&sqPos, 0);
+    slTime=125;
+    ullStart=HostSim_GetTime();
+    for(i=0;i<INT64TEST_BENCH_LOOPS;i++)
+    {
+        slSpeed=(SLONG)(i*2654435761ul)>>8;
+        refmul3232(&sqDelta, &slSpeed, &slTime);
+        refadd(&sqTmp, &sqPos, &sqDelta);
+        reftosint48(&sqTmp);
+        sqPos=sqTmp;
+        sllInt64TestSink+=reftosint32(&sqPos);
+    }
+
+    return HostSim_GetTime()-ullStart;
+}
+
+//***************************************************************************
+// Benchmark: same step on the native layer
+
+static ULLNG int64testbenchnative(void)
+{
+    SLLNG sllPos;
+    SLONG slSpeed;
+    ULLNG ullStart;
+    ULONG i;
+
+    sllPos=0;
+    ullStart=HostSim_GetTime();
+    for(i=0;i<INT64TEST_BENCH_LOOPS;i++)
+    {
+        slSpeed=(SLONG)(i*2654435761ul)>>8;
+        sllPos=s64_sat48(s64_mac_32_32(sllPos, slSpeed, 125));
+        sllInt64TestSink+=s64_sat32(sllPos);
+    }
+
+    return HostSim_GetTime()-ullStart;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    ULLNG ullRef, ullNative, ullTime;
+    ULONG ulErr, i, j;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+
+        // all edge pairs
+    ulErr=0;
+    for(i=0;i<INT64TEST_EDGES;i++)
+        for(j=0;j<INT64TEST_EDGES;j++)
+            ulErr+=int64testpair(sllInt64TestEdge[i], sllInt64TestEdge[j]);
+    HOSTSIMTEST_CHECK(ulErr==0);
+
+        // random pairs
+    ulErr=0;
+    for(i=0;i<INT64TEST_RANDOM;i++)
+        ulErr+=int64testpair(int64testrand(), int64testrand());
+    HOSTSIMTEST_CHECK(ulErr==0);
+
+        // saturation limits
+    HOSTSIMTEST_CHECK(s64_add_sat(S64_MAX, 1)==S64_MAX);
+    HOSTSIMTEST_CHECK(s64_add_sat(S64_MIN, -1)==S64_MIN);
+    HOSTSIMTEST_CHECK(s64_sub_sat(S64_MIN, 1)==S64_MIN);
+    HOSTSIMTEST_CHECK(s64_sub_sat(0, S64_MIN)==S64_MAX);
+    HOSTSIMTEST_CHECK(s64_shl_sat(1, 63)==S64_MAX);
+    HOSTSIMTEST_CHECK(s64_shl_sat(-1, 63)==S64_MIN);
+    HOSTSIMTEST_CHECK(s64_sat48(S64_MAX)==S48_MAX && s64_sat48(S64_MIN)==S48_MIN);
+    HOSTSIMTEST_CHECK(s64_sat32(S48_MAX)==SLONG_MAX_VALUE && s64_sat32(S48_MIN)==SLONG_MIN_VALUE);
+
+        // cycles per 8 kHz integration step, best of runs
+    ullRef=ullNative=~0ull;
+    for(i=0;i<INT64TEST_BENCH_RUNS;i++)
+    {
+        ullTime=int64testbenchref();
+        if(ullTime<ullRef)
+            ullRef=ullTime;
+        ullTime=int64testbenchnative();
+        if(ullTime<ullNative)
+            ullNative=ullTime;
+    }
+    HOSTSIMTEST_CHECK(ullNative<ullRef);
+    printf("Int64Test: integration step %.2f ns previous, %.2f ns native\n",
+        (double)ullRef*100.0/INT64TEST_BENCH_LOOPS, (double)ullNative*100.0/INT64TEST_BENCH_LOOPS);
+
+    return HOSTSIMTEST_RESULT("Int64Test");
+}
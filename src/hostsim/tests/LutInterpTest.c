@@ -0,0 +1,336 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : LutInterpTest.c                                            */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : LUT interpolation: agreement with the legacy _interpNd,    */
+/*               Hermite accuracy, breakpoint axes, PLC entry points, speed */
+/*                                                                          */
+/****************************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\DspFunctions.h"
+#include "common\LutInterp.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // legacy table size: (2^n+1) points per dimension
+#define LUTTEST_LINSIZE                 5
+#define LUTTEST_POINTS                  ((1<<LUTTEST_LINSIZE)+1)
+    // random inputs of the 2D/3D checks
+#define LUTTEST_RANDOM                  200000
+    // benchmark: inputs per batch and runs
+#define LUTTEST_BENCH_INPUTS            4096
+#define LUTTEST_BENCH_RUNS              20
+    // linear path against legacy, lsb: rounded here, floored there, once
+    // per dimension
+#define LUTTEST_LEGACY_TOL              3
+    // Hermite error on the smooth maps as a fraction of the linear one;
+    // in 2D the bicubic shares the error of the tensor product
+#define LUTTEST_HERMITE_1D              0.5
+#define LUTTEST_HERMITE_2D              0.6
+    // breakpoint axis against the exact segment, lsb: Q15 fraction
+    // truncated on a 28000 lsb step plus the output rounding
+#define LUTTEST_BREAK_TOL               1.5
+
+//***************************************************************************
+// Locals
+
+static SWORD swLutTest1D[LUTTEST_POINTS];
+static SWORD swLutTest2D[LUTTEST_POINTS*LUTTEST_POINTS];
+static SWORD swLutTest3D[LUTTEST_POINTS*LUTTEST_POINTS*LUTTEST_POINTS];
+static SWORD swLutTestX[LUTTEST_BENCH_INPUTS];
+static SWORD swLutTestY[LUTTEST_BENCH_INPUTS];
+static SWORD swLutTestZ[LUTTEST_BENCH_INPUTS];
+static SWORD swLutTestOut[LUTTEST_BENCH_INPUTS];
+static ULONG ulLutTestSeed=0x0BADCAFEul;
+static volatile SLONG slLutTestSink;
+
+//***************************************************************************
+// Smooth maps sampled by the tables
+
+static double luttestmap1(double dX)
+{
+    return 30000.0*sin(dX*M_PI/43000.0);
+}
+
+static double luttestmap2(double dX, double dY)
+{
+    return 15000.0*sin(dX*M_PI/50000.0)+12000.0*cos(dY*M_PI/40000.0);
+}
+
+static double luttestmap3(double dX, double dY, double dZ)
+{
+    return 10000.0*sin(dX*M_PI/50000.0)+10000.0*cos(dY*M_PI/40000.0)+8000.0*sin(dZ*M_PI/60000.0);
+}
+
+//***************************************************************************
+// Legacy axis point #
+
+static double luttestpoint(UWORD uwIdx)
+{
+    return -32768.0+(double)uwIdx*(1<<(16-LUTTEST_LINSIZE));
+}
+
+//***************************************************************************
+// Random input
+
+static SWORD luttestrand(void)
+{
+    ulLutTestSeed=ulLutTestSeed*1664525ul+1013904223ul;
+
+    return (SWORD)(ulLutTestSeed>>16);
+}
+
+//***************************************************************************
+// Descriptor of the legacy tables
+
+static void luttestlegacy(LUT_TABLE * psLut, const SWORD * pswData, UBYTE ubDims, UBYTE ubMode)
+{
+    UBYTE ubCt;
+
+    memset(psLut, 0, sizeof(LUT_TABLE));
+    psLut->pswData=pswData;
+    psLut->ubDims=ubDims;
+    psLut->ubMode=ubMode;
+    for(ubCt=0;ubCt<ubDims;ubCt++)
+    {
+        psLut->sAxis[ubCt].swMin=-32768;
+        psLut->sAxis[ubCt].ubShift=16-LUTTEST_LINSIZE;
+        psLut->sAxis[ubCt].uwPoints=LUTTEST_POINTS;
+    }
+}
+
+//***************************************************************************
+// Benchmark: best ns per input of the legacy calls and the new ones
+
+static void luttestbench(const LUT_TABLE * psLin1, const LUT_TABLE * psLin2)
+{
+    ULLNG ullStart, ullTime, ullLegacy1, ullBatch1, ullLegacy2, ullNew2;
+    UWORD i, uwRun;
+
+    ullLegacy1=ullBatch1=ullLegacy2=ullNew2=~0ull;
+    for(uwRun=0;uwRun<LUTTEST_BENCH_RUNS;uwRun++)
+    {
+        ullStart=HostSim_GetTime();
+        for(i=0;i<LUTTEST_BENCH_INPUTS;i++)
+            swLutTestOut[i]=_interp1d(swLutTest1D, LUTTEST_LINSIZE, swLutTestX[i]);
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullLegacy1)
+            ullLegacy1=ullTime;
+        slLutTestSink+=swLutTestOut[0];
+
+        ullStart=HostSim_GetTime();
+        Lut_Eval1Batch(psLin1, swLutTestX, swLutTestOut, LUTTEST_BENCH_INPUTS);
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullBatch1)
+            ullBatch1=ullTime;
+        slLutTestSink+=swLutTestOut[0];
+
+        ullStart=HostSim_GetTime();
+        for(i=0;i<LUTTEST_BENCH_INPUTS;i++)
+            swLutTestOut[i]=_interp2d(swLutTest2D, LUTTEST_LINSIZE, swLutTestX[i], swLutTestY[i]);
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullLegacy2)
+            ullLegacy2=ullTime;
+        slLutTestSink+=swLutTestOut[0];
+
+        ullStart=HostSim_GetTime();
+        for(i=0;i<LUTTEST_BENCH_INPUTS;i++)
+            swLutTestOut[i]=Lut_Eval2(psLin2, swLutTestX[i], swLutTestY[i]);
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullNew2)
+            ullNew2=ullTime;
+        slLutTestSink+=swLutTestOut[0];
+    }
+
+    printf("LutInterpTest: 1D %.2f ns legacy, %.2f ns batch; 2D %.2f ns legacy, %.2f ns new\n",
+        (double)ullLegacy1*100.0/LUTTEST_BENCH_INPUTS, (double)ullBatch1*100.0/LUTTEST_BENCH_INPUTS,
+        (double)ullLegacy2*100.0/LUTTEST_BENCH_INPUTS, (double)ullNew2*100.0/LUTTEST_BENCH_INPUTS);
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    static const SWORD swBreak[6]={ -30000, -12000, -2000, 0, 500, 20000 };
+    static const SWORD swBreakData[6]={ 1000, -5000, 3000, 3000, 8000, -20000 };
+    LUT_TABLE sLin1, sHerm1, sLin2, sHerm2, sLin3, sBrk, sBad;
+    ULONG ulCt, ulMismatch;
+    SLONG slIn, slLegacyMax, slDiff;
+    SWORD swX, swY, swZ, swOut;
+    double dErrLin, dErrHerm, dErr2Lin, dErr2Herm, dErr;
+    UWORD i, j, k;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+
+        // legacy tables sampling the maps
+    for(i=0;i<LUTTEST_POINTS;i++)
+        swLutTest1D[i]=(SWORD)lround(luttestmap1(luttestpoint(i)));
+    for(j=0;j<LUTTEST_POINTS;j++)
+        for(i=0;i<LUTTEST_POINTS;i++)
+            swLutTest2D[j*LUTTEST_POINTS+i]=(SWORD)lround(luttestmap2(luttestpoint(i), luttestpoint(j)));
+    for(k=0;k<LUTTEST_POINTS;k++)
+        for(j=0;j<LUTTEST_POINTS;j++)
+            for(i=0;i<LUTTEST_POINTS;i++)
+                swLutTest3D[(k*LUTTEST_POINTS+j)*LUTTEST_POINTS+i]=(SWORD)lround(luttestmap3(luttestpoint(i), luttestpoint(j), luttestpoint(k)));
+
+    luttestlegacy(&sLin1, swLutTest1D, 1, LUT_MODE_LINEAR);
+    luttestlegacy(&sHerm1, swLutTest1D, 1, LUT_MODE_HERMITE);
+    luttestlegacy(&sLin2, swLutTest2D, 2, LUT_MODE_LINEAR);
+    luttestlegacy(&sHerm2, swLutTest2D, 2, LUT_MODE_HERMITE);
+    luttestlegacy(&sLin3, swLutTest3D, 3, LUT_MODE_LINEAR);
+    HOSTSIMTEST_CHECK(Lut_Check(&sLin1) && Lut_Check(&sHerm1) && Lut_Check(&sLin2) && Lut_Check(&sHerm2) && Lut_Check(&sLin3));
+
+        // invalid descriptors
+    sBad=sLin1;
+    sBad.sAxis[0].uwPoints=1;
+    HOSTSIMTEST_CHECK(!Lut_Check(&sBad));
+    sBad=sLin1;
+    sBad.sAxis[0].ubShift=LUT_SHIFT_MAX+1;
+    HOSTSIMTEST_CHECK(!Lut_Check(&sBad));
+    sBad=sLin1;
+    sBad.ubDims=LUT_DIMS_MAX+1;
+    HOSTSIMTEST_CHECK(!Lut_Check(&sBad));
+    sBad=sLin1;
+    sBad.ubMode=LUT_MODE_HERMITE+1;
+    HOSTSIMTEST_CHECK(!Lut_Check(&sBad));
+
+        // 1D, every input: linear agrees with _interp1d, Hermite error on
+        // the smooth map lower than linear
+    slLegacyMax=0;
+    dErrLin=dErrHerm=0.0;
+    ulMismatch=0;
+    for(slIn=-32768;slIn<=32767;slIn++)
+    {
+        swX=(SWORD)slIn;
+        swOut=Lut_Eval1(&sLin1, swX);
+        slDiff=labs((SLONG)swOut-_interp1d(swLutTest1D, LUTTEST_LINSIZE, swX));
+        if(slDiff>slLegacyMax)
+            slLegacyMax=slDiff;
+
+        dErr=fabs(swOut-luttestmap1(swX));
+        if(dErr>dErrLin)
+            dErrLin=dErr;
+        swOut=Lut_Eval1(&sHerm1, swX);
+        dErr=fabs(swOut-luttestmap1(swX));
+        if(dErr>dErrHerm)
+            dErrHerm=dErr;
+
+        ulMismatch+=(Lut_PlcHermite1D(swLutTest1D, LUTTEST_LINSIZE, swX)!=swOut);
+    }
+    HOSTSIMTEST_CHECK(slLegacyMax<=1);
+    HOSTSIMTEST_CHECK(dErrHerm<=LUTTEST_HERMITE_1D*dErrLin);
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+
+        // table points are hit exactly
+    for(i=0;i<LUTTEST_POINTS-1;i++)
+    {
+        swX=(SWORD)luttestpoint(i);
+        HOSTSIMTEST_CHECK(Lut_Eval1(&sLin1, swX)==swLutTest1D[i] && Lut_Eval1(&sHerm1, swX)==swLutTest1D[i]);
+    }
+
+        // 2D and 3D on random inputs
+    dErr2Lin=dErr2Herm=0.0;
+    ulMismatch=0;
+    for(ulCt=0;ulCt<LUTTEST_RANDOM;ulCt++)
+    {
+        swX=luttestrand();
+        swY=luttestrand();
+        swZ=luttestrand();
+
+        swOut=Lut_Eval2(&sLin2, swX, swY);
+        slDiff=labs((SLONG)swOut-_interp2d(swLutTest2D, LUTTEST_LINSIZE, swX, swY));
+        if(slDiff>slLegacyMax)
+            slLegacyMax=slDiff;
+        dErr=fabs(swOut-luttestmap2(swX, swY));
+        if(dErr>dErr2Lin)
+            dErr2Lin=dErr;
+
+        swOut=Lut_Eval2(&sHerm2, swX, swY);
+        dErr=fabs(swOut-luttestmap2(swX, swY));
+        if(dErr>dErr2Herm)
+            dErr2Herm=dErr;
+        ulMismatch+=(Lut_PlcHermite2D(swLutTest2D, LUTTEST_LINSIZE, swX, swY)!=swOut);
+
+        swOut=Lut_Eval3(&sLin3, swX, swY, swZ);
+        slDiff=labs((SLONG)swOut-_interp3d(swLutTest3D, LUTTEST_LINSIZE, swX, swY, swZ));
+        if(slDiff>slLegacyMax)
+            slLegacyMax=slDiff;
+    }
+    HOSTSIMTEST_CHECK(slLegacyMax<=LUTTEST_LEGACY_TOL);
+    HOSTSIMTEST_CHECK(dErr2Herm<=LUTTEST_HERMITE_2D*dErr2Lin);
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+    HOSTSIMTEST_CHECK(Lut_PlcHermite1D(swLutTest1D, 0, 0)==0 && Lut_PlcHermite2D(swLutTest2D, LUT_SHIFT_MAX+1, 0, 0)==0);
+
+        // batch equal to single point
+    for(i=0;i<LUTTEST_BENCH_INPUTS;i++)
+    {
+        swLutTestX[i]=luttestrand();
+        swLutTestY[i]=luttestrand();
+        swLutTestZ[i]=luttestrand();
+    }
+    ulMismatch=0;
+    Lut_Eval1Batch(&sLin1, swLutTestX, swLutTestOut, LUTTEST_BENCH_INPUTS);
+    for(i=0;i<LUTTEST_BENCH_INPUTS;i++)
+        ulMismatch+=(swLutTestOut[i]!=Lut_Eval1(&sLin1, swLutTestX[i]));
+    Lut_Eval1Batch(&sHerm1, swLutTestX, swLutTestOut, LUTTEST_BENCH_INPUTS);
+    for(i=0;i<LUTTEST_BENCH_INPUTS;i++)
+        ulMismatch+=(swLutTestOut[i]!=Lut_Eval1(&sHerm1, swLutTestX[i]));
+    Lut_Eval2Batch(&sHerm2, swLutTestX, swLutTestY, swLutTestOut, LUTTEST_BENCH_INPUTS);
+    for(i=0;i<LUTTEST_BENCH_INPUTS;i++)
+        ulMismatch+=(swLutTestOut[i]!=Lut_Eval2(&sHerm2, swLutTestX[i], swLutTestY[i]));
+    Lut_Eval3Batch(&sLin3, swLutTestX, swLutTestY, swLutTestZ, swLutTestOut, LUTTEST_BENCH_INPUTS);
+    for(i=0;i<LUTTEST_BENCH_INPUTS;i++)
+        ulMismatch+=(swLutTestOut[i]!=Lut_Eval3(&sLin3, swLutTestX[i], swLutTestY[i], swLutTestZ[i]));
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+
+        // breakpoint axis: points hit exactly, clamped outside, linear
+        // between, as the PLC entry point
+    memset(&sBrk, 0, sizeof(sBrk));
+    sBrk.pswData=swBreakData;
+    sBrk.ubDims=1;
+    sBrk.ubMode=LUT_MODE_LINEAR;
+    sBrk.sAxis[0].pswBreak=swBreak;
+    sBrk.sAxis[0].uwPoints=6;
+    HOSTSIMTEST_CHECK(Lut_Check(&sBrk));
+    for(i=0;i<6;i++)
+        HOSTSIMTEST_CHECK(Lut_Eval1(&sBrk, swBreak[i])==swBreakData[i]);
+    HOSTSIMTEST_CHECK(Lut_Eval1(&sBrk, -32768)==swBreakData[0] && Lut_Eval1(&sBrk, 32767)==swBreakData[5]);
+    dErr=0.0;
+    ulMismatch=0;
+    for(slIn=-32768;slIn<=32767;slIn++)
+    {
+        swX=(SWORD)slIn;
+        swOut=Lut_Eval1(&sBrk, swX);
+        ulMismatch+=(Lut_PlcInterpBrk1D(swBreak, swBreakData, 6, swX)!=swOut);
+        for(i=0;i<5 && !(swX>=swBreak[i] && swX<=swBreak[i+1]);i++)
+            ;
+        if(i<5 && fabs(swOut-(swBreakData[i]+(double)(swBreakData[i+1]-swBreakData[i])*(swX-swBreak[i])/(swBreak[i+1]-swBreak[i])))>dErr)
+            dErr=fabs(swOut-(swBreakData[i]+(double)(swBreakData[i+1]-swBreakData[i])*(swX-swBreak[i])/(swBreak[i+1]-swBreak[i])));
+    }
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+    HOSTSIMTEST_CHECK(dErr<=LUTTEST_BREAK_TOL);
+    HOSTSIMTEST_CHECK(Lut_PlcInterpBrk1D(swBreak, swBreakData, 1, 0)==0);
+    sBad=sBrk;
+    sBad.sAxis[0].pswBreak=swBreakData;
+    HOSTSIMTEST_CHECK(!Lut_Check(&sBad));
+
+    printf("LutInterpTest: legacy max diff %ld lsb; 1D error %.1f linear, %.1f Hermite; 2D %.1f linear, %.1f Hermite\n",
+        (long)slLegacyMax, dErrLin, dErrHerm, dErr2Lin, dErr2Herm);
+
+    luttestbench(&sLin1, &sLin2);
+
+    return HOSTSIMTEST_RESULT("LutInterpTest");
+}
@@ -0,0 +1,342 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : MathBatchTest.c                                            */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Batch math kernels: equality with the scalar functions and */
+/*               reference, Clarke/Park against the formulas, throughput    */
+/*                                                                          */
+/****************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\MathFunctions.h"
+#include "common\MathBatch.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // built again with _HOSTSIM_NEON over the NEON kernels
+#ifdef _HOSTSIM_NEON
+ #define MATHBATCHTEST_NAME             "MathBatchNeonTest"
+#else
+ #define MATHBATCHTEST_NAME             "MathBatchTest"
+#endif
+
+    // samples per batch call, as several channels of a tick
+#define MATHBATCHTEST_BATCH             256
+    // random batches
+#define MATHBATCHTEST_BATCHES           2000
+    // benchmark runs
+#define MATHBATCHTEST_BENCH_RUNS        5
+
+    // table sin/cos error, in Q15 lsb
+#define MATHBATCHTEST_SINCOS_TOL        2.0
+    // Clarke/Park error against the exact formula, in lsb: truncating shift,
+    // plus 1/sqrt(3) constant error on Clarke (0.6/32768 of |u+2v|)
+#define MATHBATCHTEST_CLARKE_TOL        3.0
+#define MATHBATCHTEST_PARK_TOL          1.0
+    // Park of a rotating vector at its own angle, in lsb: sin/cos error
+    // times amplitude, plus truncation
+#define MATHBATCHTEST_ROTATE_TOL        4.0
+
+//***************************************************************************
+// Locals
+
+static ULONG ulMathBatchTestSeed=0x12345678ul;
+
+static UWORD uwMathBatchTestAngle[MATHBATCHTEST_BATCH];
+static SWORD swMathBatchTestA[MATHBATCHTEST_BATCH];
+static SWORD swMathBatchTestB[MATHBATCHTEST_BATCH];
+static SWORD swMathBatchTestSin[MATHBATCHTEST_BATCH];
+static SWORD swMathBatchTestCos[MATHBATCHTEST_BATCH];
+static SWORD swMathBatchTestOut1[MATHBATCHTEST_BATCH];
+static SWORD swMathBatchTestOut2[MATHBATCHTEST_BATCH];
+static UWORD uwMathBatchTestOut[MATHBATCHTEST_BATCH];
+static SWORD swMathBatchTestRef1[MATHBATCHTEST_BATCH];
+static SWORD swMathBatchTestRef2[MATHBATCHTEST_BATCH];
+static UWORD uwMathBatchTestRef[MATHBATCHTEST_BATCH];
+static volatile SLONG slMathBatchTestSink;
+
+//***************************************************************************
+// Random 16 bit sample
+
+static SWORD mathbatchtestrand(void)
+{
+    ulMathBatchTestSeed=ulMathBatchTestSeed*1664525ul+1013904223ul;
+
+    return (SWORD)(ulMathBatchTestSeed>>16);
+}
+
+//***************************************************************************
+// Reference formula result, saturated as the kernels
+
+static double mathbatchtestsat(double dVal)
+{
+    if(dVal>32767.0)
+        return 32767.0;
+    if(dVal<-32768.0)
+        return -32768.0;
+
+    return dVal;
+}
+
+//***************************************************************************
+// Batch kernels against the scalar reference on random lengths, so the
+// vector loops and their tails are both covered; full range inputs with
+// -32768 for atan2, right half plane for the magnitude. Mismatches
+
+static ULONG mathbatchtestref(void)
+{
+    ULONG ulMismatch=0, ulBatch;
+    UWORD i, uwNum;
+
+    for(ulBatch=0;ulBatch<MATHBATCHTEST_BATCHES;ulBatch++)
+    {
+        uwNum=(UWORD)((ULONG)(UWORD)mathbatchtestrand()%(MATHBATCHTEST_BATCH+1));
+        for(i=0;i<uwNum;i++)
+        {
+            uwMathBatchTestAngle[i]=(UWORD)mathbatchtestrand();
+            swMathBatchTestA[i]=(i&15)==3?-32768:mathbatchtestrand();
+            swMathBatchTestB[i]=(i&15)==9?-32768:mathbatchtestrand()>>(i&7);
+            swMathBatchTestSin[i]=mathbatchtestrand();
+            swMathBatchTestCos[i]=mathbatchtestrand();
+        }
+
+        Sin16Cos16Batch(uwMathBatchTestAngle, swMathBatchTestOut1, swMathBatchTestOut2, uwNum);
+        Sin16Cos16BatchRef(uwMathBatchTestAngle, swMathBatchTestRef1, swMathBatchTestRef2, uwNum);
+        ulMismatch+=memcmp(swMathBatchTestOut1, swMathBatchTestRef1, uwNum*sizeof(SWORD))!=0;
+        ulMismatch+=memcmp(swMathBatchTestOut2, swMathBatchTestRef2, uwNum*sizeof(SWORD))!=0;
+
+        ATan16Batch(swMathBatchTestA, swMathBatchTestB, uwMathBatchTestOut, uwNum);
+        ATan16BatchRef(swMathBatchTestA, swMathBatchTestB, uwMathBatchTestRef, uwNum);
+        ulMismatch+=memcmp(uwMathBatchTestOut, uwMathBatchTestRef, uwNum*sizeof(UWORD))!=0;
+
+        ClarkeBatch16(swMathBatchTestA, swMathBatchTestB, swMathBatchTestOut1, swMathBatchTestOut2, uwNum);
+        ClarkeBatch16Ref(swMathBatchTestA, swMathBatchTestB, swMathBatchTestRef1, swMathBatchTestRef2, uwNum);
+        ulMismatch+=memcmp(swMathBatchTestOut1, swMathBatchTestRef1, uwNum*sizeof(SWORD))!=0;
+        ulMismatch+=memcmp(swMathBatchTestOut2, swMathBatchTestRef2, uwNum*sizeof(SWORD))!=0;
+
+            // sin/cos in [-32767, 32767] as required by Park
+        for(i=0;i<uwNum;i++)
+        {
+            if(swMathBatchTestSin[i]==-32768)
+                swMathBatchTestSin[i]=-32767;
+            if(swMathBatchTestCos[i]==-32768)
+                swMathBatchTestCos[i]=-32767;
+        }
+        ParkBatch16(swMathBatchTestA, swMathBatchTestB, swMathBatchTestSin, swMathBatchTestCos, swMathBatchTestOut1, swMathBatchTestOut2, uwNum);
+        ParkBatch16Ref(swMathBatchTestA, swMathBatchTestB, swMathBatchTestSin, swMathBatchTestCos, swMathBatchTestRef1, swMathBatchTestRef2, uwNum);
+        ulMismatch+=memcmp(swMathBatchTestOut1, swMathBatchTestRef1, uwNum*sizeof(SWORD))!=0;
+        ulMismatch+=memcmp(swMathBatchTestOut2, swMathBatchTestRef2, uwNum*sizeof(SWORD))!=0;
+
+        for(i=0;i<uwNum;i++)
+        {
+            swMathBatchTestA[i]=(SWORD)((mathbatchtestrand()&0x7FFF)>>2);
+            swMathBatchTestB[i]=(SWORD)(mathbatchtestrand()>>2);
+        }
+        RootOfSquareSum16Batch(swMathBatchTestA, swMathBatchTestB, swMathBatchTestOut1, uwNum);
+        RootOfSquareSum16BatchRef(swMathBatchTestA, swMathBatchTestB, swMathBatchTestRef1, uwNum);
+        ulMismatch+=memcmp(swMathBatchTestOut1, swMathBatchTestRef1, uwNum*sizeof(SWORD))!=0;
+    }
+
+    return ulMismatch;
+}
+
+//***************************************************************************
+// Benchmark: ns per sample of sin/cos, atan2 and Park; per sample calls
+// against batch calls
+
+static void mathbatchtestbench(void)
+{
+    ULLNG ullStart, ullScalar, ullBatch, ullTime;
+    UWORD i, uwRun;
+
+    ullScalar=ullBatch=~0ull;
+    for(uwRun=0;uwRun<MATHBATCHTEST_BENCH_RUNS;uwRun++)
+    {
+        ullStart=HostSim_GetTime();
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+        {
+            swMathBatchTestSin[i]=Sin16(uwMathBatchTestAngle[i]);
+            swMathBatchTestCos[i]=Cos16(uwMathBatchTestAngle[i]);
+            uwMathBatchTestOut[i]=ATan16(swMathBatchTestSin[i], swMathBatchTestCos[i]);
+        }
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullScalar)
+            ullScalar=ullTime;
+        slMathBatchTestSink+=uwMathBatchTestOut[MATHBATCHTEST_BATCH-1];
+
+        ullStart=HostSim_GetTime();
+        Sin16Cos16Batch(uwMathBatchTestAngle, swMathBatchTestSin, swMathBatchTestCos, MATHBATCHTEST_BATCH);
+        ATan16Batch(swMathBatchTestSin, swMathBatchTestCos, uwMathBatchTestOut, MATHBATCHTEST_BATCH);
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullBatch)
+            ullBatch=ullTime;
+        slMathBatchTestSink+=uwMathBatchTestOut[MATHBATCHTEST_BATCH-1];
+    }
+
+    printf("MathBatchTest: sin/cos+atan2 %.1f ns per sample scalar, %.1f ns batch\n",
+        (double)ullScalar*100.0/MATHBATCHTEST_BATCH, (double)ullBatch*100.0/MATHBATCHTEST_BATCH);
+
+    ullBatch=~0ull;
+    for(uwRun=0;uwRun<MATHBATCHTEST_BENCH_RUNS;uwRun++)
+    {
+        ullStart=HostSim_GetTime();
+        ClarkeBatch16(swMathBatchTestA, swMathBatchTestB, swMathBatchTestOut1, swMathBatchTestOut2, MATHBATCHTEST_BATCH);
+        ParkBatch16(swMathBatchTestOut1, swMathBatchTestOut2, swMathBatchTestSin, swMathBatchTestCos, swMathBatchTestA, swMathBatchTestB, MATHBATCHTEST_BATCH);
+        ullTime=HostSim_GetTime()-ullStart;
+        if(ullTime<ullBatch)
+            ullBatch=ullTime;
+        slMathBatchTestSink+=swMathBatchTestA[0];
+    }
+
+    printf("MathBatchTest: Clarke+Park %.1f ns per sample\n", (double)ullBatch*100.0/MATHBATCHTEST_BATCH);
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    double dRef, dErr, dMaxSin, dMaxClarke, dMaxPark, dMaxRot, dAngle, dSin, dCos;
+    ULONG ulMismatch, ulAngle, ulBatch;
+    UWORD i;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+
+        // sin/cos: every angle, batch equal to scalar, table error bounded
+    ulMismatch=0;
+    dMaxSin=0.0;
+    for(ulAngle=0;ulAngle<65536ul;ulAngle+=MATHBATCHTEST_BATCH)
+    {
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+            uwMathBatchTestAngle[i]=(UWORD)(ulAngle+i);
+        Sin16Cos16Batch(uwMathBatchTestAngle, swMathBatchTestSin, swMathBatchTestCos, MATHBATCHTEST_BATCH);
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+        {
+            ulMismatch+=(swMathBatchTestSin[i]!=Sin16(uwMathBatchTestAngle[i]));
+            ulMismatch+=(swMathBatchTestCos[i]!=Cos16(uwMathBatchTestAngle[i]));
+            dAngle=(double)uwMathBatchTestAngle[i]*2.0*M_PI/65536.0;
+            dErr=fabs(swMathBatchTestSin[i]-32767.0*sin(dAngle));
+            if(dErr>dMaxSin)
+                dMaxSin=dErr;
+            dErr=fabs(swMathBatchTestCos[i]-32767.0*cos(dAngle));
+            if(dErr>dMaxSin)
+                dMaxSin=dErr;
+        }
+    }
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+    HOSTSIMTEST_CHECK(dMaxSin<=MATHBATCHTEST_SINCOS_TOL);
+
+        // atan2 and magnitude: random vectors, batch equal to scalar
+    ulMismatch=0;
+    for(ulBatch=0;ulBatch<MATHBATCHTEST_BATCHES;ulBatch++)
+    {
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+        {
+            swMathBatchTestA[i]=mathbatchtestrand();
+            swMathBatchTestB[i]=mathbatchtestrand()>>(i&7);
+        }
+        ATan16Batch(swMathBatchTestA, swMathBatchTestB, uwMathBatchTestOut, MATHBATCHTEST_BATCH);
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+            ulMismatch+=(uwMathBatchTestOut[i]!=ATan16(swMathBatchTestA[i], swMathBatchTestB[i]));
+
+            // CORDIC magnitude of the right half plane, as used by the callers
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+        {
+            swMathBatchTestA[i]=(SWORD)((mathbatchtestrand()&0x7FFF)>>2);
+            swMathBatchTestB[i]=(SWORD)(mathbatchtestrand()>>2);
+        }
+        RootOfSquareSum16Batch(swMathBatchTestA, swMathBatchTestB, swMathBatchTestOut1, MATHBATCHTEST_BATCH);
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+            ulMismatch+=(swMathBatchTestOut1[i]!=RootOfSquareSum16(swMathBatchTestA[i], swMathBatchTestB[i]));
+    }
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+
+        // Clarke and Park against the formulas, full range with saturation
+    dMaxClarke=0.0;
+    dMaxPark=0.0;
+    ulMismatch=0;
+    for(ulBatch=0;ulBatch<MATHBATCHTEST_BATCHES;ulBatch++)
+    {
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+        {
+            swMathBatchTestA[i]=mathbatchtestrand();
+            swMathBatchTestB[i]=mathbatchtestrand();
+            uwMathBatchTestAngle[i]=(UWORD)mathbatchtestrand();
+        }
+        Sin16Cos16Batch(uwMathBatchTestAngle, swMathBatchTestSin, swMathBatchTestCos, MATHBATCHTEST_BATCH);
+
+        ClarkeBatch16(swMathBatchTestA, swMathBatchTestB, swMathBatchTestOut1, swMathBatchTestOut2, MATHBATCHTEST_BATCH);
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+        {
+            ulMismatch+=(swMathBatchTestOut1[i]!=swMathBatchTestA[i]);
+            dRef=mathbatchtestsat((swMathBatchTestA[i]+2.0*swMathBatchTestB[i])/sqrt(3.0));
+            dErr=fabs(swMathBatchTestOut2[i]-dRef);
+            if(dErr>dMaxClarke)
+                dMaxClarke=dErr;
+        }
+
+        ParkBatch16(swMathBatchTestA, swMathBatchTestB, swMathBatchTestSin, swMathBatchTestCos, swMathBatchTestOut1, swMathBatchTestOut2, MATHBATCHTEST_BATCH);
+        for(i=0;i<MATHBATCHTEST_BATCH;i++)
+        {
+            dSin=swMathBatchTestSin[i]/32768.0;
+            dCos=swMathBatchTestCos[i]/32768.0;
+            dRef=mathbatchtestsat(swMathBatchTestA[i]*dCos+swMathBatchTestB[i]*dSin);
+            dErr=fabs(swMathBatchTestOut1[i]-dRef);
+            if(dErr>dMaxPark)
+                dMaxPark=dErr;
+            dRef=mathbatchtestsat(swMathBatchTestB[i]*dCos-swMathBatchTestA[i]*dSin);
+            dErr=fabs(swMathBatchTestOut2[i]-dRef);
+            if(dErr>dMaxPark)
+                dMaxPark=dErr;
+        }
+    }
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+    HOSTSIMTEST_CHECK(dMaxClarke<=MATHBATCHTEST_CLARKE_TOL);
+    HOSTSIMTEST_CHECK(dMaxPark<=MATHBATCHTEST_PARK_TOL);
+
+        // vector rotating at the Park angle is seen still: d its amplitude,
+        // q zero
+    dMaxRot=0.0;
+    for(i=0;i<MATHBATCHTEST_BATCH;i++)
+    {
+        uwMathBatchTestAngle[i]=(UWORD)(i*257u);
+        dAngle=(double)uwMathBatchTestAngle[i]*2.0*M_PI/65536.0;
+        swMathBatchTestA[i]=(SWORD)lround(20000.0*cos(dAngle));
+        swMathBatchTestB[i]=(SWORD)lround(20000.0*sin(dAngle));
+    }
+    Sin16Cos16Batch(uwMathBatchTestAngle, swMathBatchTestSin, swMathBatchTestCos, MATHBATCHTEST_BATCH);
+    ParkBatch16(swMathBatchTestA, swMathBatchTestB, swMathBatchTestSin, swMathBatchTestCos, swMathBatchTestOut1, swMathBatchTestOut2, MATHBATCHTEST_BATCH);
+    for(i=0;i<MATHBATCHTEST_BATCH;i++)
+    {
+        dErr=fabs(swMathBatchTestOut1[i]-20000.0);
+        if(dErr>dMaxRot)
+            dMaxRot=dErr;
+        dErr=fabs((double)swMathBatchTestOut2[i]);
+        if(dErr>dMaxRot)
+            dMaxRot=dErr;
+    }
+    HOSTSIMTEST_CHECK(dMaxRot<=MATHBATCHTEST_ROTATE_TOL);
+
+    printf("MathBatchTest: max error sin/cos %.2f, Clarke %.2f, Park %.2f, rotating %.2f lsb\n",
+        dMaxSin, dMaxClarke, dMaxPark, dMaxRot);
+
+        // batch kernels bit exact with the scalar reference
+    HOSTSIMTEST_CHECK(mathbatchtestref()==0);
+
+        // NEON kernels on host run over the C lanes, no figure to compare
+#ifndef _HOSTSIM_NEON
+    mathbatchtestbench();
+#endif
+
+    return HOSTSIMTEST_RESULT(MATHBATCHTEST_NAME);
+}
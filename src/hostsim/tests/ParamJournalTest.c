@@ -0,0 +1,263 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : ParamJournalTest.c                                         */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Parameter journal: power cut at each flash command of the  */
+/*               save cycles, recovery of the last committed parameters     */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\ParamStorageManagement.h"
+#include "common\FlashManager.h"
+#include "system\SysAppGlobals.h"
+#include "HostSim.h"
+#include "HostSimHal.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // save cycles, each one changes 1 to n parameter structures
+#define PARJRTEST_CYCLES                1200
+#define PARJRTEST_CHANGES               3
+    // room for the parameter values (bytes)
+#define PARJRTEST_SNAP_SIZE             0x20000
+    // parameter storage blocks, contiguous
+#define PARJRTEST_AREA_START            PARAMSTOR_BLK0_START
+#define PARJRTEST_AREA_SIZE             (PARAMSTOR_BLK0_SIZE+PARAMSTOR_BLK1_SIZE)
+
+//***************************************************************************
+// Locals
+
+    // parameters saved and loaded as plain data
+static UWORD uwParJrTestPlain[256];
+static UWORD uwParJrTestPlainCount;
+static ULONG ulParJrTestSnapSize;
+
+    // committed and new values, storage blocks at cycle start
+static UBYTE ubParJrTestOld[PARJRTEST_SNAP_SIZE];
+static UBYTE ubParJrTestNew[PARJRTEST_SNAP_SIZE];
+static UBYTE ubParJrTestArea[PARJRTEST_AREA_SIZE];
+
+static ULONG ulParJrTestSeed=0x2468ACE1ul;
+
+//***************************************************************************
+// Random
+
+static ULONG parjrtestrand(void)
+{
+    ulParJrTestSeed=ulParJrTestSeed*1664525ul+1013904223ul;
+
+    return ulParJrTestSeed>>8;
+}
+
+//***************************************************************************
+// Select the parameters stored as plain data, loaded back as they are
+
+static void parjrtestselect(void)
+{
+    const PARMGM_LIST * parptr;
+    UWORD ct;
+
+    for(ct=0,parptr=psParMgmGlobalList; ct<uwParMgmGlobalListSize; ct++,parptr++)
+        if(!(parptr->uwFlags&(PARMGM_F_RESTOREONLY|PARMGM_F_STOREONLY|PARMGM_F_CALLBACK|PARMGM_F_PTRSOURCE)) &&
+            parptr->uwDataSize>=sizeof(ULONG))
+        {
+            uwParJrTestPlain[uwParJrTestPlainCount++]=ct;
+            ulParJrTestSnapSize+=parptr->uwDataSize;
+        }
+}
+
+//***************************************************************************
+// Copy parameter values to/from a snapshot, compare with a snapshot
+
+static void parjrtestsnap(UBYTE * pubSnap)
+{
+    const PARMGM_LIST * parptr;
+    UWORD ct;
+
+    for(ct=0; ct<uwParJrTestPlainCount; ct++)
+    {
+        parptr=&psParMgmGlobalList[uwParJrTestPlain[ct]];
+        memcpy(pubSnap, parptr->hpvData, parptr->uwDataSize);
+        pubSnap+=parptr->uwDataSize;
+    }
+}
+
+static void parjrtestset(const UBYTE * pubSnap)
+{
+    const PARMGM_LIST * parptr;
+    UWORD ct;
+
+    for(ct=0; ct<uwParJrTestPlainCount; ct++)
+    {
+        parptr=&psParMgmGlobalList[uwParJrTestPlain[ct]];
+        memcpy(parptr->hpvData, pubSnap, parptr->uwDataSize);
+        pubSnap+=parptr->uwDataSize;
+    }
+}
+
+static BOOL parjrtestequal(const UBYTE * pubSnap)
+{
+    const PARMGM_LIST * parptr;
+    UWORD ct;
+
+    for(ct=0; ct<uwParJrTestPlainCount; ct++)
+    {
+        parptr=&psParMgmGlobalList[uwParJrTestPlain[ct]];
+        if(memcmp(parptr->hpvData, pubSnap, parptr->uwDataSize))
+            return FALSE;
+        pubSnap+=parptr->uwDataSize;
+    }
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Change one word of 1 to n parameter structures
+
+static void parjrtestchange(void)
+{
+    const PARMGM_LIST * parptr;
+    ULONG * pulWord;
+    UWORD ct,uwChanges;
+
+    uwChanges=(UWORD)(1+parjrtestrand()%PARJRTEST_CHANGES);
+    for(ct=0; ct<uwChanges; ct++)
+    {
+        parptr=&psParMgmGlobalList[uwParJrTestPlain[parjrtestrand()%uwParJrTestPlainCount]];
+        pulWord=&((ULONG *)parptr->hpvData)[parjrtestrand()%(parptr->uwDataSize/sizeof(ULONG))];
+        *pulWord^=parjrtestrand()|1;
+    }
+}
+
+//***************************************************************************
+// Power up: device back on, defaults, then verify and load as at boot
+
+static SWORD parjrtestreboot(void)
+{
+    SWORD swResult;
+
+    ulHostSimFlashPowerCut=0;
+    ulHostSimFlashFailCmds=0;
+    FlashCmdFailed();
+
+    parmgm_par_default();
+
+    swResult=parmgm_par_verify();
+    if(swResult!=PARMGM_B_OK)
+        return swResult;
+
+    return parmgm_par_load(PARMGM_LOAD_FULL);
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    ULONG ulCycle,ulCut,ulPrograms,ulErases;
+    ULONG ulCuts=0,ulMaxCmds=0;
+    ULONG ulJournals=0,ulJournalPrograms=0;
+    ULONG ulCompacts=0,ulCompactPrograms=0;
+    ULONG ulFullPrograms;
+    SWORD swResult;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    FlashMgrInit();
+    parmgm_par_init();
+    uwHostSimFlashTimeScale=0;
+
+    parjrtestselect();
+    HOSTSIMTEST_CHECK(uwParJrTestPlainCount>=8);
+    HOSTSIMTEST_CHECK(ulParJrTestSnapSize<=PARJRTEST_SNAP_SIZE);
+    if(ulParJrTestSnapSize>PARJRTEST_SNAP_SIZE)
+        return HOSTSIMTEST_RESULT("ParamJournalTest");
+
+        // erased storage: nothing to load, first save is a full double save
+    HOSTSIMTEST_CHECK(parmgm_par_verify()==PARMGM_B_ERASED);
+    parmgm_par_default();
+    ulOsTimer1Hz=1;
+    HOSTSIMTEST_CHECK(parmgm_par_save()==PARMGM_B_OK);
+    ulFullPrograms=sHostSimFlashStats.ulPagePrograms;
+    HOSTSIMTEST_CHECK(sHostSimFlashStats.ulSectorErases==2);
+    parjrtestsnap(ubParJrTestOld);
+    HOSTSIMTEST_CHECK(parjrtestreboot()==PARMGM_B_OK);
+    HOSTSIMTEST_CHECK(parjrtestequal(ubParJrTestOld));
+
+    for(ulCycle=0; ulCycle<PARJRTEST_CYCLES; ulCycle++)
+    {
+            // committed values and storage at cycle start, then the change
+        parjrtestsnap(ubParJrTestOld);
+        memcpy(ubParJrTestArea, (HPVOID)PARJRTEST_AREA_START, PARJRTEST_AREA_SIZE);
+        parjrtestchange();
+        parjrtestsnap(ubParJrTestNew);
+
+            // power cut at the n-th command of the save, until the save
+            // completes with no cut
+        for(ulCut=1;;ulCut++)
+        {
+            memcpy((HPVOID)PARJRTEST_AREA_START, ubParJrTestArea, PARJRTEST_AREA_SIZE);
+            HOSTSIMTEST_CHECK(parjrtestreboot()==PARMGM_B_OK);
+            parjrtestset(ubParJrTestNew);
+
+            ulPrograms=sHostSimFlashStats.ulPagePrograms;
+            ulErases=sHostSimFlashStats.ulSectorErases;
+            ulOsTimer1Hz=2+ulCycle;
+            ulHostSimFlashPowerCut=ulCut;
+            swResult=parmgm_par_save();
+
+            if(ulHostSimFlashPowerCut)
+                break;
+
+                // interrupted: failure reported, previous values loaded
+            ulCuts++;
+            HOSTSIMTEST_CHECK(swResult!=PARMGM_B_OK);
+            HOSTSIMTEST_CHECK(parjrtestreboot()==PARMGM_B_OK);
+            HOSTSIMTEST_CHECK(parjrtestequal(ubParJrTestOld));
+
+                // and the save repeated after power up is loaded
+            parjrtestset(ubParJrTestNew);
+            HOSTSIMTEST_CHECK(parmgm_par_save()==PARMGM_B_OK);
+            HOSTSIMTEST_CHECK(parjrtestreboot()==PARMGM_B_OK);
+            HOSTSIMTEST_CHECK(parjrtestequal(ubParJrTestNew));
+        }
+
+            // completed save: new values loaded
+        ulHostSimFlashPowerCut=0;
+        HOSTSIMTEST_CHECK(swResult==PARMGM_B_OK);
+        if(ulCut-1>ulMaxCmds)
+            ulMaxCmds=ulCut-1;
+        ulPrograms=sHostSimFlashStats.ulPagePrograms-ulPrograms;
+        if(sHostSimFlashStats.ulSectorErases==ulErases)
+        {
+            ulJournals++;
+            ulJournalPrograms+=ulPrograms;
+        }
+        else
+        {
+            ulCompacts++;
+            ulCompactPrograms+=ulPrograms;
+        }
+        HOSTSIMTEST_CHECK(parjrtestreboot()==PARMGM_B_OK);
+        HOSTSIMTEST_CHECK(parjrtestequal(ubParJrTestNew));
+    }
+
+    printf("ParamJournalTest: %u parameters, %lu bytes; %lu cycles: %lu journal appends (%.1f page programs), %lu compactions (%.1f), %lu cuts (max %lu commands/save); full double save %lu page programs\n",
+        (unsigned)uwParJrTestPlainCount, (unsigned long)ulParJrTestSnapSize, (unsigned long)PARJRTEST_CYCLES,
+        (unsigned long)ulJournals, ulJournals ? (double)ulJournalPrograms/ulJournals : 0.0,
+        (unsigned long)ulCompacts, ulCompacts ? (double)ulCompactPrograms/ulCompacts : 0.0,
+        (unsigned long)ulCuts, (unsigned long)ulMaxCmds, (unsigned long)ulFullPrograms);
+    HOSTSIMTEST_CHECK(ulJournals>0 && ulCompacts>0);
+    HOSTSIMTEST_CHECK(ulJournals+ulCompacts==PARJRTEST_CYCLES);
+    HOSTSIMTEST_CHECK(ulJournalPrograms*4<ulJournals*ulFullPrograms);
+
+    return HOSTSIMTEST_RESULT("ParamJournalTest");
+}
@@ -0,0 +1,318 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : SpaceSpeedFloatTest.c                                      */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Space/speed control loop: float against 64bit fixed point  */
+/*               on the same scenario, cost per realtime tick               */
+/*                                                                          */
+/****************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\Int64Functions.h"
+#include "common\TaskScheduler.h"
+#include "core\Timer.h"
+#include "drive\AxM-E-Defines.h"
+#include "drive\SpaceSpeedCntrLp.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // scenario: reversing speed ramp, period in ticks and peak speed
+#define SSFLTEST_TICKS                  (2*REALTIME_TASK_FREQ)
+#define SSFLTEST_RAMP_PERIOD            4000
+#define SSFLTEST_SPEED_PEAK             400000000.0
+    // feedback: delay in ticks and noise amplitudes
+#define SSFLTEST_FBK_DELAY              8
+#define SSFLTEST_NOISE_POS              20000
+#define SSFLTEST_NOISE_SPEED            200000
+#define SSFLTEST_NOISE_ACCEL            2000000
+    // integral limits
+#define SSFLTEST_ILIMIT                 1000000000l
+    // same quantized gains: max difference, fraction of the scenario peak
+#define SSFLTEST_TOL_SAMEGAINS          3e-5
+    // engineering gains: rms difference, fraction of the scenario rms,
+    // given by the fixed point gain quantization; with the global shift
+    // set by the speed gains the acceleration gains keep 5 bits here
+#define SSFLTEST_TOL_ENGGAINS           2e-2
+    // benchmark runs
+#define SSFLTEST_BENCH_RUNS             5
+
+//***************************************************************************
+// Locals
+
+static GLB_KINEMATIC_DATA sSsFlTestRef;
+static ENCMGR_SPACEFEEDBACK sSsFlTestFbk;
+static GLB_TORQUE_LIMIT sSsFlTestIqLimit;
+static GLB_IREF sSsFlTestIRef;
+static MOTCTRL_STATUS sSsFlTestStatus;
+static MH_CURLIMITFLAGS sSsFlTestILimitActive;
+
+    // reference history for the delayed feedback
+static SLLNG sllSsFlTestPos[SSFLTEST_FBK_DELAY+1];
+static SLONG slSsFlTestSpeed[SSFLTEST_FBK_DELAY+1];
+static ULONG ulSsFlTestSeed;
+    // tick and arithmetic of the runtime switch
+static ULONG ulSsFlTestSwitchTick;
+static BOOL bSsFlTestSwitchFloat=TRUE;
+
+static SLONG slSsFlTestIq[SSFLTEST_TICKS];
+static SLONG slSsFlTestIqRef[SSFLTEST_TICKS];
+
+static const SS_PAR_GAINS sSsFlTestGains=
+{
+    200.0,      // flKi
+    50.0,       // flPosKp
+    0.2,        // flSpdKpRef
+    0.25,       // flSpdKpFbk
+    2e-4,       // flAccKpRef
+    1e-4        // flAccKpFbk
+};
+
+//***************************************************************************
+// Feedback noise
+
+static SLONG ssfltestnoise(SLONG slAmpl)
+{
+    ulSsFlTestSeed=ulSsFlTestSeed*1664525ul+1013904223ul;
+
+    return (SLONG)(((SLLNG)(SLONG)ulSsFlTestSeed*slAmpl)>>31);
+}
+
+//***************************************************************************
+// Scenario restart
+
+static void ssfltestreset(void)
+{
+    memset(&sSsFlTestRef, 0, sizeof(sSsFlTestRef));
+    memset(&sSsFlTestFbk, 0, sizeof(sSsFlTestFbk));
+    memset(sllSsFlTestPos, 0, sizeof(sllSsFlTestPos));
+    memset(slSsFlTestSpeed, 0, sizeof(slSsFlTestSpeed));
+    ulSsFlTestSeed=0x5EED1234ul;
+    ulSsFlTestSwitchTick=0xFFFFFFFFul;
+}
+
+//***************************************************************************
+// Pre tick: reference and delayed noisy feedback
+
+static void ssfltestpretick(ULONG ulTick)
+{
+    ULONG ulPhase=ulTick%SSFLTEST_RAMP_PERIOD;
+    double dSpeed, dAccel;
+    SLLNG sllPos;
+    UWORD i;
+
+    if(ulTick==ulSsFlTestSwitchTick)
+        PlcCtrLpSelectFloat(bSsFlTestSwitchFloat);
+
+        // triangle speed, reversing twice per period
+    if(ulPhase<SSFLTEST_RAMP_PERIOD/2)
+    {
+        dSpeed=SSFLTEST_SPEED_PEAK*(4.0*ulPhase/SSFLTEST_RAMP_PERIOD-1.0);
+        dAccel=4.0*SSFLTEST_SPEED_PEAK/SSFLTEST_RAMP_PERIOD;
+    }
+    else
+    {
+        dSpeed=SSFLTEST_SPEED_PEAK*(3.0-4.0*ulPhase/SSFLTEST_RAMP_PERIOD);
+        dAccel=-4.0*SSFLTEST_SPEED_PEAK/SSFLTEST_RAMP_PERIOD;
+    }
+
+    sllPos=s64_ld(&sSsFlTestRef.sqPostn)+(SLLNG)dSpeed;
+    s64_st(&sSsFlTestRef.sqPostn, sllPos);
+    sSsFlTestRef.slSpeed=(SLONG)dSpeed;
+    sSsFlTestRef.slAccel=(SLONG)(dAccel*1000.0);
+
+    for(i=SSFLTEST_FBK_DELAY;i>0;i--)
+    {
+        sllSsFlTestPos[i]=sllSsFlTestPos[i-1];
+        slSsFlTestSpeed[i]=slSsFlTestSpeed[i-1];
+    }
+    sllSsFlTestPos[0]=sllPos;
+    slSsFlTestSpeed[0]=sSsFlTestRef.slSpeed;
+
+    s64_st(&sSsFlTestFbk.sEncData.sqPostn, sllSsFlTestPos[SSFLTEST_FBK_DELAY]+ssfltestnoise(SSFLTEST_NOISE_POS));
+    sSsFlTestFbk.sEncData.slSpeed=slSsFlTestSpeed[SSFLTEST_FBK_DELAY]+ssfltestnoise(SSFLTEST_NOISE_SPEED);
+    sSsFlTestFbk.sEncData.slAccel=sSsFlTestRef.slAccel+ssfltestnoise(SSFLTEST_NOISE_ACCEL);
+}
+
+//***************************************************************************
+// Post tick: record IqRef
+
+static void ssfltestposttick(ULONG ulTick)
+{
+    slSsFlTestIq[ulTick%SSFLTEST_TICKS]=sSS_CntrLoopOut.sIRef.slIqRef;
+}
+
+//***************************************************************************
+// Empty realtime task, scheduler cost baseline
+
+static BOOL ssfltestidle(void)
+{
+    return TRUE;
+}
+
+//***************************************************************************
+// Loop restart with the given arithmetic and gain image (NULL: own image
+// from the engineering gains)
+
+static BOOL ssfltestinit(BOOL bFloat, SS_RT_PARAMS * psUsr)
+{
+    if(!TaskSched_Init())
+        return FALSE;
+
+    sSS_CntrLoopIn.psRef=&sSsFlTestRef;
+    sSS_CntrLoopIn.psFbk=&sSsFlTestFbk;
+    sSS_CntrLoopIn.psIqLimit=&sSsFlTestIqLimit;
+    sSS_CntrLoopIn.psCurrentRefs=&sSsFlTestIRef;
+    sSS_CntrLoopIn.psMotCtrlStatus=&sSsFlTestStatus;
+    sSS_CntrLoopIn.psILimitActive=&sSsFlTestILimitActive;
+    sSS_CntrLoopParam.sPars.sGains=sSsFlTestGains;
+    sSS_CntrLoopParam.sPars.flags.b.bUseDifferentKp=TRUE;
+    sSS_CntrLoopParam.sPars.flags.b.bFilterAccRef=FALSE;
+    sSsFlTestIqLimit.slMax=SSFLTEST_ILIMIT;
+    sSsFlTestIqLimit.slMin=-SSFLTEST_ILIMIT;
+    sSsFlTestStatus.b.bPID_IntegralEnable=TRUE;
+
+    if(!Ss_ControlLoopInit())
+        return FALSE;
+    PlcCtrLpSelectFloat(bFloat);
+    if(psUsr!=NULL)
+        PlcCtrLpGainsSelect(psUsr);
+
+    ssfltestreset();
+    sHostSimStats.ulTicks=0;
+    sHostSimStats.ullSumTime=0;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Max and rms difference against the recorded reference, peak and rms of it
+
+static void ssfltestcompare(double * pdMax, double * pdRms, double * pdPeak, double * pdRef)
+{
+    double dDiff, dSum=0.0, dSumRef=0.0;
+    ULONG i;
+
+    *pdMax=*pdPeak=0.0;
+    for(i=0;i<SSFLTEST_TICKS;i++)
+    {
+        dDiff=fabs((double)slSsFlTestIq[i]-slSsFlTestIqRef[i]);
+        if(dDiff>*pdMax)
+            *pdMax=dDiff;
+        if(fabs((double)slSsFlTestIqRef[i])>*pdPeak)
+            *pdPeak=fabs((double)slSsFlTestIqRef[i]);
+        dSum+=dDiff*dDiff;
+        dSumRef+=(double)slSsFlTestIqRef[i]*slSsFlTestIqRef[i];
+    }
+    *pdRms=sqrt(dSum/SSFLTEST_TICKS);
+    *pdRef=sqrt(dSumRef/SSFLTEST_TICKS);
+}
+
+//***************************************************************************
+// Benchmark: best realtime tick time of the loop, scheduler excluded [ns]
+
+static double ssfltestbench(BOOL bFloat)
+{
+    double dBest=1e30, dIdle=1e30, dTime;
+    UWORD uwRun;
+
+    for(uwRun=0;uwRun<SSFLTEST_BENCH_RUNS;uwRun++)
+    {
+        TaskSched_Init();
+        TaskSched_AddRTTask(&ssfltestidle, TASKSCHEDULER_FLAG_NONE, 0, 0, 0);
+        ssfltestreset();
+        sHostSimStats.ulTicks=0;
+        sHostSimStats.ullSumTime=0;
+        HostSim_RunTicks(SSFLTEST_TICKS);
+        dTime=(double)sHostSimStats.ullSumTime*100.0/sHostSimStats.ulTicks;
+        if(dTime<dIdle)
+            dIdle=dTime;
+
+        ssfltestinit(bFloat, NULL);
+        HostSim_RunTicks(SSFLTEST_TICKS);
+        dTime=(double)sHostSimStats.ullSumTime*100.0/sHostSimStats.ulTicks;
+        if(dTime<dBest)
+            dBest=dTime;
+    }
+
+    return dBest-dIdle;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    SS_RT_PARAMS sUsr;
+    double dMax, dRms, dPeak, dRef, dFixed, dFloat;
+    UWORD i;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+    Timer_Init(REALTIME_TASK_FREQ, TaskSched_RTScheduler);
+    HostSim_SetTickHooks(ssfltestpretick, ssfltestposttick);
+
+        // same quantized gains: PLC image of the engineering gains
+    HOSTSIMTEST_CHECK(ssfltestinit(FALSE, NULL));
+    memset(&sUsr, 0, sizeof(sUsr));
+    HOSTSIMTEST_CHECK(PlcCtrLpGainsCompute((SS_PAR_GAINS *)&sSsFlTestGains, &sUsr));
+    HOSTSIMTEST_CHECK(sUsr.swKi!=0 && sUsr.swAccKpFbk!=0);
+
+    HOSTSIMTEST_CHECK(ssfltestinit(FALSE, &sUsr));
+    HostSim_RunTicks(SSFLTEST_TICKS);
+    memcpy(slSsFlTestIqRef, slSsFlTestIq, sizeof(slSsFlTestIqRef));
+    HOSTSIMTEST_CHECK(ssfltestinit(TRUE, &sUsr));
+    HostSim_RunTicks(SSFLTEST_TICKS);
+    ssfltestcompare(&dMax, &dRms, &dPeak, &dRef);
+    printf("SpaceSpeedFloatTest: same gains, peak %.0f, max diff %.0f (%.2e), rms diff %.1f\n",
+        dPeak, dMax, dMax/dPeak, dRms);
+    HOSTSIMTEST_CHECK(dPeak>1e7 && dPeak<SSFLTEST_ILIMIT);
+    HOSTSIMTEST_CHECK(dMax<=SSFLTEST_TOL_SAMEGAINS*dPeak);
+
+        // engineering gains: own images, float gains not quantized
+    HOSTSIMTEST_CHECK(ssfltestinit(FALSE, NULL));
+    HostSim_RunTicks(SSFLTEST_TICKS);
+    memcpy(slSsFlTestIqRef, slSsFlTestIq, sizeof(slSsFlTestIqRef));
+    HOSTSIMTEST_CHECK(ssfltestinit(TRUE, NULL));
+    HostSim_RunTicks(SSFLTEST_TICKS);
+    ssfltestcompare(&dMax, &dRms, &dPeak, &dRef);
+    printf("SpaceSpeedFloatTest: engineering gains, rms %.0f, rms diff %.0f (%.2e)\n",
+        dRef, dRms, dRms/dRef);
+    HOSTSIMTEST_CHECK(dRms<=SSFLTEST_TOL_ENGGAINS*dRef);
+
+        // switch at runtime, both ways: the next tick takes over carrying
+        // the integral, so from there on the output follows the loop it
+        // switched to as within the same gains comparison
+    for(i=0;i<2;i++)
+    {
+        HOSTSIMTEST_CHECK(ssfltestinit(i==0, &sUsr));
+        HostSim_RunTicks(SSFLTEST_TICKS);
+        memcpy(slSsFlTestIqRef, slSsFlTestIq, sizeof(slSsFlTestIqRef));
+        HOSTSIMTEST_CHECK(ssfltestinit(i!=0, &sUsr));
+        ulSsFlTestSwitchTick=SSFLTEST_TICKS/2;
+        bSsFlTestSwitchFloat=(i==0);
+        HostSim_RunTicks(SSFLTEST_TICKS);
+        ssfltestcompare(&dMax, &dRms, &dPeak, &dRef);
+        printf("SpaceSpeedFloatTest: switch to %s, max diff %.0f (%.2e)\n",
+            i==0 ? "float" : "fixed point", dMax, dMax/dPeak);
+        HOSTSIMTEST_CHECK(dMax<=SSFLTEST_TOL_SAMEGAINS*dPeak);
+    }
+    bSsFlTestSwitchFloat=TRUE;
+
+        // cost per tick
+    HostSim_SetTickHooks(ssfltestpretick, NULL);
+    dFixed=ssfltestbench(FALSE);
+    dFloat=ssfltestbench(TRUE);
+    printf("SpaceSpeedFloatTest: %.1f ns fixed point, %.1f ns float per tick\n", dFixed, dFloat);
+    HOSTSIMTEST_CHECK(dFloat<dFixed);
+
+    return HOSTSIMTEST_RESULT("SpaceSpeedFloatTest");
+}
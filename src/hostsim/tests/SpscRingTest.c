@@ -0,0 +1,280 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : SpscRingTest.c                                             */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : SPSC ring and event counter: wrap, full/empty, two thread  */
+/*               race and cost against the OS queue path it replaces        */
+/*                                                                          */
+/****************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\SpscRing.h"
+#include "common\ProgramFlashHandler.h"
+#include "system\Os.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // elements passed by the two thread race
+#define SPSCTEST_ELEMENTS               1000000
+    // events posted by the two thread race
+#define SPSCTEST_EVENTS                 200000
+    // slots of the rings under test
+#define SPSCTEST_SLOTS                  16
+    // benchmark: element size as realtime alarms, loops and runs
+#define SPSCTEST_BENCH_SIZE             PROGRAMFLASH_PAGE_SIZE
+#define SPSCTEST_BENCH_LOOPS            200000
+#define SPSCTEST_BENCH_RUNS             5
+
+//***************************************************************************
+// Structures
+
+    // Race element, payload derived from sequence
+typedef struct
+{
+    ULONG           ulSeq;
+    ULONG           ulData[7];
+} SPSCTEST_ELEM;
+
+//***************************************************************************
+// Locals
+
+static SPSCRING sSpscTestRing;
+static SPSCTEST_ELEM sSpscTestSlots[SPSCTEST_SLOTS];
+
+static SPSCEVENT sSpscTestEvent;
+static volatile ULONG ulSpscTestEventData;
+
+static UBYTE ubSpscTestBench[SPSCTEST_SLOTS][SPSCTEST_BENCH_SIZE];
+static volatile ULONG ulSpscTestSink;
+
+//***************************************************************************
+// Race producer: elements filled in place
+
+static void * spsctestproducer(void * pvArg)
+{
+    SPSCTEST_ELEM * psElem;
+    ULONG ulSeq, i;
+
+    (void)pvArg;
+    for(ulSeq=0;ulSeq<SPSCTEST_ELEMENTS;ulSeq++)
+    {
+        while((psElem=(SPSCTEST_ELEM *)spscring_reserve(&sSpscTestRing))==NULL)
+            sched_yield();
+        psElem->ulSeq=ulSeq;
+        for(i=0;i<7;i++)
+            psElem->ulData[i]=ulSeq*(i+3);
+        spscring_commit(&sSpscTestRing);
+    }
+
+    return NULL;
+}
+
+//***************************************************************************
+// Race producer: data published before each event
+
+static void * spsctesteventproducer(void * pvArg)
+{
+    ULONG ulSeq;
+
+    (void)pvArg;
+    for(ulSeq=1;ulSeq<=SPSCTEST_EVENTS;ulSeq++)
+    {
+        ulSpscTestEventData=ulSeq;
+        SPSCRING_BARRIER();
+        spscevent_post(&sSpscTestEvent);
+        if((ulSeq&0xFF)==0)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+//***************************************************************************
+// Benchmark, ring: alarm header built in place, slot used in place
+
+static ULLNG spsctestbenchring(void)
+{
+    SPSCRING sRing;
+    HPUBYTE hpubSlot;
+    ULLNG ullStart;
+    ULONG i;
+
+    spscring_init(&sRing, ubSpscTestBench, SPSCTEST_SLOTS, SPSCTEST_BENCH_SIZE);
+    ullStart=HostSim_GetTime();
+    for(i=0;i<SPSCTEST_BENCH_LOOPS;i++)
+    {
+        hpubSlot=(HPUBYTE)spscring_reserve(&sRing);
+        memcpy(hpubSlot, &i, sizeof(i));
+        spscring_commit(&sRing);
+
+        hpubSlot=(HPUBYTE)spscring_peek(&sRing);
+        ulSpscTestSink+=hpubSlot[0];
+        spscring_release(&sRing);
+    }
+
+    return HostSim_GetTime()-ullStart;
+}
+
+//***************************************************************************
+// Benchmark, replaced path: page built aside, copied into the queue under
+// critical section and copied out
+
+static ULLNG spsctestbenchqueue(OS_QUEUE sQueue)
+{
+    ULONG ulPage[SPSCTEST_BENCH_SIZE/sizeof(ULONG)];
+    ULONG ulOut[SPSCTEST_BENCH_SIZE/sizeof(ULONG)];
+    ULLNG ullStart;
+    ULONG i;
+
+    memset(ulPage, 0, sizeof(ulPage));
+    ullStart=HostSim_GetTime();
+    for(i=0;i<SPSCTEST_BENCH_LOOPS;i++)
+    {
+        ulPage[0]=i;
+        Os_BeginCriticalSection(OS_CRITSECT_GLOBAL);
+        Os_QueuePost(sQueue, ulPage);
+        Os_EndCriticalSection(OS_CRITSECT_GLOBAL);
+
+        Os_QueueGet(sQueue, ulOut, 0);
+        ulSpscTestSink+=ulOut[0];
+    }
+
+    return HostSim_GetTime()-ullStart;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    SPSCTEST_ELEM sElem;
+    SPSCTEST_ELEM * psElem;
+    pthread_t sThread;
+    OS_QUEUE sQueue;
+    ULLNG ullRing, ullQueue, ullTime;
+    ULONG ulSeq, ulExpected, ulErrors, ulSeen, ulTakes, i;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+
+        // all slots usable, full and empty detected
+    spscring_init(&sSpscTestRing, sSpscTestSlots, SPSCTEST_SLOTS, sizeof(SPSCTEST_ELEM));
+    HOSTSIMTEST_CHECK(spscring_peek(&sSpscTestRing)==NULL);
+    memset(&sElem, 0, sizeof(sElem));
+    for(i=0;i<SPSCTEST_SLOTS;i++)
+    {
+        sElem.ulSeq=i;
+        HOSTSIMTEST_CHECK(spscring_push(&sSpscTestRing, &sElem));
+    }
+    HOSTSIMTEST_CHECK(spscring_count(&sSpscTestRing)==SPSCTEST_SLOTS);
+    HOSTSIMTEST_CHECK(spscring_reserve(&sSpscTestRing)==NULL);
+    HOSTSIMTEST_CHECK(!spscring_push(&sSpscTestRing, &sElem));
+    for(i=0;i<SPSCTEST_SLOTS;i++)
+        HOSTSIMTEST_CHECK(spscring_pop(&sSpscTestRing, &sElem) && sElem.ulSeq==i);
+    HOSTSIMTEST_CHECK(!spscring_pop(&sSpscTestRing, &sElem));
+    HOSTSIMTEST_CHECK(spscring_count(&sSpscTestRing)==0);
+
+        // free running indexes across the 32 bit wrap
+    sSpscTestRing.ulHead=sSpscTestRing.ulTailCache=0xFFFFFFF8ul;
+    sSpscTestRing.ulTail=sSpscTestRing.ulHeadCache=0xFFFFFFF8ul;
+    for(ulSeq=0;ulSeq<4*SPSCTEST_SLOTS;ulSeq++)
+    {
+        sElem.ulSeq=ulSeq;
+        HOSTSIMTEST_CHECK(spscring_push(&sSpscTestRing, &sElem));
+        if(ulSeq&1)
+        {
+            HOSTSIMTEST_CHECK(spscring_pop(&sSpscTestRing, &sElem) && sElem.ulSeq==ulSeq-1);
+            HOSTSIMTEST_CHECK(spscring_pop(&sSpscTestRing, &sElem) && sElem.ulSeq==ulSeq);
+        }
+    }
+    HOSTSIMTEST_CHECK(spscring_count(&sSpscTestRing)==0);
+    for(i=0;i<SPSCTEST_SLOTS;i++)
+        HOSTSIMTEST_CHECK(spscring_push(&sSpscTestRing, &sElem));
+    HOSTSIMTEST_CHECK(!spscring_push(&sSpscTestRing, &sElem));
+
+        // event counter: pending ones taken together, init as pending or not
+    spscevent_init(&sSpscTestEvent, FALSE);
+    HOSTSIMTEST_CHECK(!spscevent_take(&sSpscTestEvent));
+    spscevent_post(&sSpscTestEvent);
+    spscevent_post(&sSpscTestEvent);
+    HOSTSIMTEST_CHECK(spscevent_take(&sSpscTestEvent));
+    HOSTSIMTEST_CHECK(!spscevent_take(&sSpscTestEvent));
+    spscevent_init(&sSpscTestEvent, TRUE);
+    HOSTSIMTEST_CHECK(spscevent_take(&sSpscTestEvent));
+    HOSTSIMTEST_CHECK(!spscevent_take(&sSpscTestEvent));
+
+        // two thread race, elements in order, none lost or torn
+    spscring_init(&sSpscTestRing, sSpscTestSlots, SPSCTEST_SLOTS, sizeof(SPSCTEST_ELEM));
+    HOSTSIMTEST_CHECK(pthread_create(&sThread, NULL, &spsctestproducer, NULL)==0);
+    ulErrors=0;
+    for(ulExpected=0;ulExpected<SPSCTEST_ELEMENTS;ulExpected++)
+    {
+        while((psElem=(SPSCTEST_ELEM *)spscring_peek(&sSpscTestRing))==NULL)
+            sched_yield();
+        if(psElem->ulSeq!=ulExpected)
+            ulErrors++;
+        for(i=0;i<7;i++)
+            if(psElem->ulData[i]!=psElem->ulSeq*(i+3))
+                ulErrors++;
+        spscring_release(&sSpscTestRing);
+    }
+    pthread_join(sThread, NULL);
+    HOSTSIMTEST_CHECK(ulErrors==0);
+    HOSTSIMTEST_CHECK(spscring_peek(&sSpscTestRing)==NULL);
+
+        // two thread event race: data seen on take is never older than the
+        // one seen before, the last event is never lost
+    spscevent_init(&sSpscTestEvent, FALSE);
+    ulSpscTestEventData=0;
+    HOSTSIMTEST_CHECK(pthread_create(&sThread, NULL, &spsctesteventproducer, NULL)==0);
+    ulErrors=0;
+    ulSeen=0;
+    ulTakes=0;
+    while(ulSeen<SPSCTEST_EVENTS)
+    {
+        if(!spscevent_take(&sSpscTestEvent))
+        {
+            sched_yield();
+            continue;
+        }
+        SPSCRING_BARRIER();
+        if(ulSpscTestEventData<ulSeen || ulSpscTestEventData==0)
+            ulErrors++;
+        ulSeen=ulSpscTestEventData;
+        ulTakes++;
+    }
+    pthread_join(sThread, NULL);
+    HOSTSIMTEST_CHECK(ulErrors==0);
+    HOSTSIMTEST_CHECK(ulTakes>0 && ulTakes<=SPSCTEST_EVENTS);
+    HOSTSIMTEST_CHECK(!spscevent_take(&sSpscTestEvent));
+
+        // cost against the queue path, best of runs; the host queue has no
+        // interrupt disabling, so only the page copies are compared
+    OS_CREATEPUREQUEUE(sQueue, SPSCTEST_SLOTS, SPSCTEST_BENCH_SIZE);
+    HOSTSIMTEST_CHECK(sQueue!=NULL);
+    ullRing=ullQueue=~0ull;
+    for(i=0;i<SPSCTEST_BENCH_RUNS;i++)
+    {
+        ullTime=spsctestbenchring();
+        if(ullTime<ullRing)
+            ullRing=ullTime;
+        ullTime=spsctestbenchqueue(sQueue);
+        if(ullTime<ullQueue)
+            ullQueue=ullTime;
+    }
+    HOSTSIMTEST_CHECK(ullRing<ullQueue);
+    printf("SpscRingTest: ring %.1f ns, queue %.1f ns per %u byte element\n",
+        (double)ullRing*100.0/SPSCTEST_BENCH_LOOPS, (double)ullQueue*100.0/SPSCTEST_BENCH_LOOPS, (unsigned)SPSCTEST_BENCH_SIZE);
+
+    return HOSTSIMTEST_RESULT("SpscRingTest");
+}
@@ -0,0 +1,418 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : SysLogRingTest.c                                           */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Syslog record ring: append, seek, wear, power cuts         */
+/*               mid-program and mid-erase, alarm storm                     */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\BlockStorage.h"
+#include "common\FlashQueue.h"
+#include "core\Flash.h"
+#include "system\SysAppDataCodes.h"
+#include "system\SysLogData.h"
+#include "system\SysLogRing.h"
+#include "HostSim.h"
+#include "HostSimHal.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // pool, device address, sub-sectors of 15 records for many rotations
+#define SLRTEST_BASE                    0xE00000ul
+#define SLRTEST_SECTORS                 SYSLOGRING_MAX_SECTORS
+#define SLRTEST_SECTOR_PAGES            (SUBSECTOR_SIZE/SYSLOGRING_PAGE_SIZE)
+    // max records kept as reference per stream
+#define SLRTEST_MAX_SEQ                 16384
+    // appends of the fill phase, one clock every 4 records
+#define SLRTEST_FILL_RECORDS            3000
+    // power cuts: random command, mid-erase and mid-header ones
+#define SLRTEST_CUTS                    120
+#define SLRTEST_CUT_MAX_CMDS            40
+    // seek probes per check
+#define SLRTEST_SEEKS                   50
+    // alarm storm, posted at once and written behind
+#define SLRTEST_STORM_ALARMS            1000
+#define SLRTEST_STORM_TIMESCALE         100
+
+    // reference record state
+#define SLRTEST_NONE                    0
+#define SLRTEST_FAILED                  1
+#define SLRTEST_COMMITTED               2
+
+//***************************************************************************
+// Structures
+
+    // record page, stream record filling the whole page so that an
+    // interrupted program leaves it not valid
+typedef struct
+{
+    BLKSTOR_HEADER sHeader;
+    ULONG   ulTime;
+    ULONG   ulSeq;
+    UBYTE   ubFill[SYSLOGRING_PAGE_SIZE-sizeof(BLKSTOR_HEADER)-2*sizeof(ULONG)];
+} SLRTEST_RECORD;
+
+//***************************************************************************
+// Locals
+
+static SYSLOGRING_SECTORDEF sSlrTestSectors[SLRTEST_SECTORS];
+
+static ULONG ulSlrTestTime[SYSLOGRING_STREAMS][SLRTEST_MAX_SEQ];
+static UBYTE ubSlrTestState[SYSLOGRING_STREAMS][SLRTEST_MAX_SEQ];
+static ULONG ulSlrTestHead[SYSLOGRING_STREAMS];
+
+    // pages being written, one per queue slot
+static SLRTEST_RECORD sSlrTestPage[FLASHQ_MAX_REQUESTS];
+static UWORD uwSlrTestPageSel;
+static SLRTEST_RECORD sSlrTestExpected;
+
+static const SWORD swSlrTestCode[SYSLOGRING_STREAMS]=
+{
+    DATACODE_SYSLOG_CLOCK,
+    DATACODE_SYSLOG_ALARMS,
+};
+
+static const ULONG ulSlrTestMinRecords[SYSLOGRING_STREAMS]=
+{
+    1,
+    SYSLOGDATA_ALARMS_MAX_ENTRIES,
+};
+
+static ULONG ulSlrTestClock;
+static ULONG ulSlrTestSeed=0x5A17C0DEul;
+
+//***************************************************************************
+// Random
+
+static ULONG slrtestrand(void)
+{
+    ulSlrTestSeed=ulSlrTestSeed*1664525ul+1013904223ul;
+
+    return ulSlrTestSeed>>8;
+}
+
+//***************************************************************************
+// Build the record page of a sequence
+
+static void slrtestrecord(SLRTEST_RECORD * psRec, UWORD uwStream, ULONG ulSeq, ULONG ulTime)
+{
+    UWORD ct;
+
+    psRec->ulTime=ulTime;
+    psRec->ulSeq=ulSeq;
+    for(ct=0;ct<sizeof(psRec->ubFill);ct++)
+        psRec->ubFill[ct]=(UBYTE)(ulSeq*31+ct*7+uwStream);
+    blkstor_createheader(swSlrTestCode[uwStream], &psRec->ulTime, sizeof(*psRec)-sizeof(BLKSTOR_HEADER), &psRec->sHeader);
+}
+
+//***************************************************************************
+// Queue the next record of a stream, reference kept by sequence
+
+static SWORD slrtestqueue(UWORD uwStream, ULONG * pulSeq, ULONG * pulTicket)
+{
+    SLRTEST_RECORD * psRec=&sSlrTestPage[uwSlrTestPageSel];
+    ULONG seq=SysLogRing_Head(uwStream);
+    SWORD ret;
+
+    slrtestrecord(psRec, uwStream, seq, ulSlrTestClock+1+slrtestrand()%4);
+
+    ret=SysLogRing_Append(uwStream, psRec, pulTicket);
+    if(ret!=SYSLOGRING_R_OK)
+        return ret;
+
+    ulSlrTestClock=psRec->ulTime;
+    ulSlrTestTime[uwStream][seq]=psRec->ulTime;
+    ubSlrTestState[uwStream][seq]=SLRTEST_NONE;
+    ulSlrTestHead[uwStream]=seq+1;
+    uwSlrTestPageSel=(uwSlrTestPageSel+1)%FLASHQ_MAX_REQUESTS;
+    *pulSeq=seq;
+
+    return SYSLOGRING_R_OK;
+}
+
+//***************************************************************************
+// Append a record and wait for it, TRUE if committed to flash
+
+static BOOL slrtestappend(UWORD uwStream)
+{
+    ULONG seq,ticket;
+
+    if(!SysLogRing_WaitReady(uwStream) || slrtestqueue(uwStream, &seq, &ticket)!=SYSLOGRING_R_OK)
+        return FALSE;
+
+    ubSlrTestState[uwStream][seq]=(FlashQ_Wait(ticket)==FLASHQ_R_OK ? SLRTEST_COMMITTED : SLRTEST_FAILED);
+
+    return ubSlrTestState[uwStream][seq]==SLRTEST_COMMITTED;
+}
+
+//***************************************************************************
+// Power back on: pending requests fail, device recovered, pool mounted
+
+static BOOL slrtestreboot(void)
+{
+    while(FlashQ_Busy())
+        FlashQ_Tick();
+
+    ulHostSimFlashPowerCut=0;
+    ulHostSimFlashFailCmds=0;
+    FlashCmdFailed();
+
+    return SysLogRing_Init(sSlrTestSectors, SLRTEST_SECTORS);
+}
+
+//***************************************************************************
+// Check the ring against the reference: committed records valid with their
+// content, times increasing, newest committed records kept, seek by time
+// as a linear scan
+
+static BOOL slrtestverify(UWORD uwStream)
+{
+    ULONG first,head,seq,time,prev,tfirst,kept,probe,linear;
+    HPVOID hpvPage;
+    BOOL bOk=TRUE, bValid;
+    UWORD ct;
+
+    first=SysLogRing_First(uwStream);
+    head=SysLogRing_Head(uwStream);
+        // the next sector is prepared before the last page of the active one
+        // is written, if power is cut meanwhile that page is skipped
+    bOk=bOk && first<=head && head<=ulSlrTestHead[uwStream]+1;
+
+    for(seq=first,prev=0,tfirst=0;seq<head;seq++)
+    {
+        bValid=SysLogRing_GetRecordTime(uwStream, seq, &time);
+        bOk=bOk && (bValid || ubSlrTestState[uwStream][seq]!=SLRTEST_COMMITTED);
+        if(!bValid)
+            continue;
+
+        bOk=bOk && time==ulSlrTestTime[uwStream][seq] && time>prev;
+        if(prev==0)
+            tfirst=time;
+        prev=time;
+
+        hpvPage=SysLogRing_GetRecord(uwStream, seq);
+        slrtestrecord(&sSlrTestExpected, uwStream, seq, time);
+        FlashQ_ReadLock();
+        bOk=bOk && hpvPage && memcmp(hpvPage, &sSlrTestExpected, sizeof(sSlrTestExpected))==0;
+        FlashQ_ReadUnlock();
+    }
+
+        // newest committed records, up to the ones the stream keeps
+    for(seq=ulSlrTestHead[uwStream],kept=0;seq>0 && kept<ulSlrTestMinRecords[uwStream];)
+        if(ubSlrTestState[uwStream][--seq]==SLRTEST_COMMITTED)
+        {
+            bOk=bOk && seq>=first && seq<head;
+            kept++;
+        }
+
+        // seek from before the first record to after the last one
+    for(ct=0;ct<SLRTEST_SEEKS && prev;ct++)
+    {
+        time=tfirst-2+slrtestrand()%(prev-tfirst+4);
+        for(linear=first;linear<head && !(SysLogRing_GetRecordTime(uwStream, linear, &probe) && probe>=time);linear++);
+        bOk=bOk && SysLogRing_SeekTime(uwStream, time)==linear;
+    }
+
+    return bOk;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    ULONG ulTicket;
+    ULONG ulPending[FLASHQ_MAX_REQUESTS];
+    ULONG ulPrograms,ulErases,ulRecords,ulMin,ulMax,ulSeq,ulReads,ulMaxReads,ulStart;
+    ULONG ulCutCmds,ulCutErase,ulCutHeader,ulPosted,ulDone,ulQueued;
+    UWORD ct,uwStream,uwPage;
+    BOOL bOk;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    Flash_Init();
+    uwHostSimFlashTimeScale=0;
+    for(ct=0;ct<SLRTEST_SECTORS;ct++)
+    {
+        sSlrTestSectors[ct].hpvStart=(HPVOID)(UINTPTR)(XPS_QSPI_LINEAR_BASEADDR+SLRTEST_BASE+ct*SUBSECTOR_SIZE);
+        sSlrTestSectors[ct].ulSize=SUBSECTOR_SIZE;
+    }
+
+        // erased pool: no records, first sectors prepared on demand; the
+        // clock sector erase fails, the clock stream is not extended, the
+        // alarm one goes on
+    HOSTSIMTEST_CHECK(!SysLogRing_Init(sSlrTestSectors, SYSLOGRING_MAX_SECTORS+1));
+    HOSTSIMTEST_CHECK(SysLogRing_Init(sSlrTestSectors, SLRTEST_SECTORS));
+    HOSTSIMTEST_CHECK(SysLogRing_Head(SYSLOGRING_CLOCK)==0 && SysLogRing_Head(SYSLOGRING_ALARM)==0);
+    HOSTSIMTEST_CHECK(SysLogRing_NextFree(SYSLOGRING_ALARM)==NULL);
+    ulHostSimFlashFailCmds=1;
+    HOSTSIMTEST_CHECK(!SysLogRing_WaitReady(SYSLOGRING_CLOCK));
+    HOSTSIMTEST_CHECK(SysLogRing_Failed());
+    HOSTSIMTEST_CHECK(SysLogRing_Append(SYSLOGRING_CLOCK, &sSlrTestPage[0], &ulTicket)==SYSLOGRING_R_NOTREADY);
+    HOSTSIMTEST_CHECK(slrtestappend(SYSLOGRING_ALARM));
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_ALARM));
+
+        // fresh pool again
+    Flash_Init();
+    memset(ulSlrTestHead, 0, sizeof(ulSlrTestHead));
+    HOSTSIMTEST_CHECK(slrtestreboot());
+    HOSTSIMTEST_CHECK(!SysLogRing_Failed());
+
+        // fill: one page program per record, plus erase and header of each
+        // prepared sector (of both streams at the first append); records
+        // found by sequence and by time
+    ulPrograms=sHostSimFlashStats.ulPagePrograms;
+    ulErases=sHostSimFlashStats.ulSectorErases;
+    for(ulRecords=0,bOk=TRUE;ulRecords<SLRTEST_FILL_RECORDS;ulRecords++)
+    {
+        ulStart=sHostSimFlashStats.ulPagePrograms;
+        bOk=slrtestappend(slrtestrand()%4==0 ? SYSLOGRING_CLOCK : SYSLOGRING_ALARM) && bOk;
+        bOk=bOk && sHostSimFlashStats.ulPagePrograms-ulStart<=1+SYSLOGRING_STREAMS;
+    }
+    HOSTSIMTEST_CHECK(bOk);
+    ulErases=sHostSimFlashStats.ulSectorErases-ulErases;
+    ulPrograms=sHostSimFlashStats.ulPagePrograms-ulPrograms;
+    HOSTSIMTEST_CHECK(ulPrograms==SLRTEST_FILL_RECORDS+ulErases);
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_CLOCK));
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_ALARM));
+    SysLogRing_GetWear(&ulMin, &ulMax);
+    HOSTSIMTEST_CHECK(ulMax-ulMin<=1);
+    HOSTSIMTEST_CHECK(ulMin*SLRTEST_SECTORS*(SLRTEST_SECTOR_PAGES-1)>=SLRTEST_FILL_RECORDS/2);
+    printf("SysLogRingTest: %u records in %u sectors of %u pages: %lu page programs, %lu erases, erase counts %lu..%lu\n",
+        (unsigned)SLRTEST_FILL_RECORDS, (unsigned)SLRTEST_SECTORS, (unsigned)SLRTEST_SECTOR_PAGES,
+        (unsigned long)ulPrograms, (unsigned long)ulErases, (unsigned long)ulMin, (unsigned long)ulMax);
+
+        // mount of the written pool finds the same records
+    ulSeq=SysLogRing_First(SYSLOGRING_ALARM);
+    HOSTSIMTEST_CHECK(slrtestreboot());
+    HOSTSIMTEST_CHECK(SysLogRing_First(SYSLOGRING_ALARM)==ulSeq);
+    HOSTSIMTEST_CHECK(SysLogRing_Head(SYSLOGRING_CLOCK)==ulSlrTestHead[SYSLOGRING_CLOCK]);
+    HOSTSIMTEST_CHECK(SysLogRing_Head(SYSLOGRING_ALARM)==ulSlrTestHead[SYSLOGRING_ALARM]);
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_CLOCK));
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_ALARM));
+
+        // power cuts: at a random command, or on the last page of a sector
+        // at the erase or at the header write of the next one; after the
+        // reboot the committed records are there
+    ulCutCmds=ulCutErase=ulCutHeader=0;
+    for(ct=0,bOk=TRUE;ct<SLRTEST_CUTS;ct++)
+    {
+        uwStream=(UWORD)(slrtestrand()%2);
+        if(ct%3==0)
+        {
+            ulHostSimFlashPowerCut=1+slrtestrand()%SLRTEST_CUT_MAX_CMDS;
+            ulCutCmds++;
+        }
+        else
+        {
+                // up to the page before the last one of the active sector
+            do
+            {
+                bOk=SysLogRing_WaitReady(uwStream) && bOk;
+                uwPage=(UWORD)(((UINTPTR)SysLogRing_NextFree(uwStream)-XPS_QSPI_LINEAR_BASEADDR-SLRTEST_BASE)%SUBSECTOR_SIZE/SYSLOGRING_PAGE_SIZE);
+            } while(bOk && uwPage!=SLRTEST_SECTOR_PAGES-2 && slrtestappend(uwStream));
+
+                // record, erase, header
+            ulHostSimFlashPowerCut=(ct%3==1 ? 2 : 3);
+            if(ct%3==1)
+                ulCutErase++;
+            else
+                ulCutHeader++;
+        }
+
+        while(slrtestappend(uwStream))
+            uwStream=(UWORD)(slrtestrand()%4==0 ? SYSLOGRING_CLOCK : SYSLOGRING_ALARM);
+        bOk=bOk && ulHostSimFlashPowerCut==0;
+
+        bOk=slrtestreboot() && bOk;
+        for(uwStream=0;uwStream<SYSLOGRING_STREAMS;uwStream++)
+        {
+            bOk=slrtestverify(uwStream) && bOk;
+            ulSlrTestHead[uwStream]=SysLogRing_Head(uwStream);
+        }
+    }
+    HOSTSIMTEST_CHECK(bOk);
+    SysLogRing_GetWear(&ulMin, &ulMax);
+    HOSTSIMTEST_CHECK(ulMax-ulMin<=1);
+    printf("SysLogRingTest: %u power cuts (%lu random, %lu mid-erase, %lu mid-header), records kept, erase counts %lu..%lu\n",
+        (unsigned)SLRTEST_CUTS, (unsigned long)ulCutCmds, (unsigned long)ulCutErase, (unsigned long)ulCutHeader,
+        (unsigned long)ulMin, (unsigned long)ulMax);
+
+        // alarm storm at device timing, posted at once: each background
+        // pass ticks the queue and the ring and appends while the queue
+        // takes records, with at most one status read; none dropped
+    uwHostSimFlashTimeScale=SLRTEST_STORM_TIMESCALE;
+    ulSeq=SysLogRing_Head(SYSLOGRING_ALARM);
+    ulStart=sHostSimFlashStats.ulStatusReads;
+    ulErases=sHostSimFlashStats.ulSectorErases;
+    ulPosted=ulDone=ulQueued=ulMaxReads=0;
+    for(bOk=TRUE;bOk && ulDone<SLRTEST_STORM_ALARMS;)
+    {
+        ulReads=sHostSimFlashStats.ulStatusReads;
+
+        FlashQ_Tick();
+        SysLogRing_Tick();
+
+        while(ulQueued && FlashQ_IsDone(ulPending[ulDone%FLASHQ_MAX_REQUESTS]))
+        {
+            bOk=bOk && FlashQ_Result(ulPending[ulDone%FLASHQ_MAX_REQUESTS])==FLASHQ_R_OK;
+            ubSlrTestState[SYSLOGRING_ALARM][ulSeq+ulDone]=SLRTEST_COMMITTED;
+            ulDone++;
+            ulQueued--;
+        }
+
+        while(ulPosted<SLRTEST_STORM_ALARMS && ulQueued<FLASHQ_MAX_REQUESTS &&
+            slrtestqueue(SYSLOGRING_ALARM, &ulRecords, &ulPending[ulPosted%FLASHQ_MAX_REQUESTS])==SYSLOGRING_R_OK)
+        {
+            bOk=bOk && ulRecords==ulSeq+ulPosted;
+            ulPosted++;
+            ulQueued++;
+        }
+
+        ulReads=sHostSimFlashStats.ulStatusReads-ulReads;
+        if(ulReads>ulMaxReads)
+            ulMaxReads=ulReads;
+    }
+    HOSTSIMTEST_CHECK(bOk);
+    HOSTSIMTEST_CHECK(ulDone==SLRTEST_STORM_ALARMS);
+    HOSTSIMTEST_CHECK(ulMaxReads<=1);
+    HOSTSIMTEST_CHECK(SysLogRing_Head(SYSLOGRING_ALARM)==ulSeq+SLRTEST_STORM_ALARMS);
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_ALARM));
+    HOSTSIMTEST_CHECK(slrtestreboot());
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_CLOCK));
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_ALARM));
+
+        // the active sector of the idle clock stream is not erased, the
+        // others share the storm erases
+    ulErases=sHostSimFlashStats.ulSectorErases-ulErases;
+    SysLogRing_GetWear(&ulMin, &ulMax);
+    HOSTSIMTEST_CHECK(ulMax-ulMin<=ulErases/(SLRTEST_SECTORS-1)+2);
+    printf("SysLogRingTest: storm of %u alarms written behind in %lu ms, at most %lu status read per pass, erase counts %lu..%lu\n",
+        (unsigned)SLRTEST_STORM_ALARMS, (unsigned long)((sHostSimFlashStats.ulStatusReads-ulStart)/1000), (unsigned long)ulMaxReads,
+        (unsigned long)ulMin, (unsigned long)ulMax);
+
+        // mixed records again: the lagging sector is taken first whenever
+        // it can be reclaimed, the spread does not grow
+    ulStart=ulMax-ulMin;
+    uwHostSimFlashTimeScale=0;
+    for(ulRecords=0,bOk=TRUE;ulRecords<SLRTEST_FILL_RECORDS;ulRecords++)
+        bOk=slrtestappend(slrtestrand()%4==0 ? SYSLOGRING_CLOCK : SYSLOGRING_ALARM) && bOk;
+    HOSTSIMTEST_CHECK(bOk);
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_CLOCK));
+    HOSTSIMTEST_CHECK(slrtestverify(SYSLOGRING_ALARM));
+    SysLogRing_GetWear(&ulMin, &ulMax);
+    HOSTSIMTEST_CHECK(ulMax-ulMin<ulStart);
+    printf("SysLogRingTest: %u mixed records after the storm, erase counts %lu..%lu\n",
+        (unsigned)SLRTEST_FILL_RECORDS, (unsigned long)ulMin, (unsigned long)ulMax);
+
+    return HOSTSIMTEST_RESULT("SysLogRingTest");
+}
@@ -0,0 +1,264 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : TaskSchedBkgTest.c                                         */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Background scheduler: classes under load, continuations, */
+/*               deadlines, latency and starvation statistics               */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\CommonParamDB.h"
+#include "common\TaskScheduler.h"
+#include "core\Timer.h"
+#include "drive\AxM-E-Defines.h"
+#include "system\SystemStatus.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // tasks, in insertion order
+#define TSBTEST_HIGH                    0           // high priority class
+#define TSBTEST_LOAD1                   1           // normal class, loaded
+#define TSBTEST_LOAD2                   2           // normal class, loaded
+#define TSBTEST_LOW                     3           // low class, with deadline
+#define TSBTEST_CONT                    4           // normal class, continuations
+#define TSBTEST_TASKS                   5
+    // low class task deadline, msec and slots
+#define TSBTEST_DEADLINE_MS             1
+#define TSBTEST_DEADLINE                (TSBTEST_DEADLINE_MS*(REALTIME_TASK_FREQ/1000))
+    // loaded tasks cost in slots: loop within the deadline, then past it
+#define TSBTEST_LOAD                    3
+#define TSBTEST_LOAD_STARVING           6
+    // loops per scenario
+#define TSBTEST_LOOPS                   50
+    // continuation work units, one slot each
+#define TSBTEST_UNITS                   20
+    // execution log
+#define TSBTEST_LOG_SIZE                64
+
+//***************************************************************************
+// Locals
+
+    // loaded tasks cost, continuation work left and done
+static UWORD uwTsbTestLoad;
+static UWORD uwTsbTestUnitsLeft;
+static UWORD uwTsbTestUnitsDone;
+    // execution log of the last loop
+static UWORD uwTsbTestLog[TSBTEST_LOG_SIZE];
+static UWORD uwTsbTestLogLen;
+
+//***************************************************************************
+// Log execution of task #
+
+static void tsbtestlog(ULONG ulTask)
+{
+    if(uwTsbTestLogLen<TSBTEST_LOG_SIZE)
+        uwTsbTestLog[uwTsbTestLogLen++]=(UWORD)ulTask;
+}
+
+//***************************************************************************
+// Plain task: log only; loaded task: the realtime ticks elapsing while it
+// runs
+
+static BOOL tsbtesttask(ULONG ulTask)
+{
+    tsbtestlog(ulTask);
+
+    return FALSE;
+}
+
+static BOOL tsbtestload(ULONG ulTask)
+{
+    tsbtestlog(ulTask);
+    HostSim_RunTicks(uwTsbTestLoad);
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Continuation task: one work unit per call, TRUE while more is pending
+
+static BOOL tsbtestcont(ULONG ulTask)
+{
+    tsbtestlog(ulTask);
+    if(uwTsbTestUnitsLeft==0)
+        return FALSE;
+
+    HostSim_RunTicks(1);
+    uwTsbTestUnitsDone++;
+
+    return --uwTsbTestUnitsLeft!=0;
+}
+
+//***************************************************************************
+// One background loop, logged
+
+static void tsbtestloop(void)
+{
+    uwTsbTestLogLen=0;
+    TaskSched_BackgroundLoop();
+}
+
+//***************************************************************************
+// Position of first execution of task # in the last loop log, log length
+// if not run
+
+static UWORD tsbtestfirst(UWORD uwTask)
+{
+    UWORD i;
+
+    for(i=0;i<uwTsbTestLogLen && uwTsbTestLog[i]!=uwTask;i++);
+
+    return i;
+}
+
+//***************************************************************************
+// Executions of task # in the last loop
+
+static UWORD tsbtestcount(UWORD uwTask)
+{
+    UWORD i,uwCnt=0;
+
+    for(i=0;i<uwTsbTestLogLen;i++)
+        if(uwTsbTestLog[i]==uwTask)
+            uwCnt++;
+
+    return uwCnt;
+}
+
+//***************************************************************************
+// Statistics hook read/write of element #
+
+static UWORD tsbtestread(UWORD uwElement, HPVOID hpvBuffer, UWORD uwBufSize)
+{
+    UWORD uwSize=uwBufSize;
+
+    return TaskSched_BkgStatsHook(NULL, COMMONPARAMDB_CBFLAG_RD|COMMONPARAMDB_CBFLAG_SEGMENT, uwElement, hpvBuffer, &uwSize, NULL);
+}
+
+static UWORD tsbtestwrite(UWORD uwElement, UWORD uwValue)
+{
+    UWORD uwSize=sizeof(uwValue);
+
+    return TaskSched_BkgStatsHook(NULL, COMMONPARAMDB_CBFLAG_WR|COMMONPARAMDB_CBFLAG_SEGMENT, uwElement, &uwValue, &uwSize, NULL);
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    TASKSCHEDULER_BKG_STATS_REC sHigh,sLow,sRec;
+    UBYTE ubBuf[sizeof(TASKSCHEDULER_BKG_STATS_REC)];
+    UWORD uwLoop,uwPolls,uwTasks,uwMaxLoop,uwLowLatency;
+    ULONG ulLowMissed;
+    BOOL bHighFirst,bLowLast;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    ulSystemStatus=SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING);
+    HOSTSIMTEST_CHECK(TaskSched_Init());
+    Timer_Init(REALTIME_TASK_FREQ, TaskSched_RTScheduler);
+
+        // low class added first: list order is not execution order
+    HOSTSIMTEST_CHECK(TaskSched_AddBackgroundTaskEx(&tsbtesttask, TASKSCHEDULER_BKG_PRIO_HIGH, 0, TSBTEST_HIGH));
+    HOSTSIMTEST_CHECK(TaskSched_AddBackgroundTaskEx(&tsbtestload, TASKSCHEDULER_BKG_PRIO_NORMAL, 0, TSBTEST_LOAD1));
+    HOSTSIMTEST_CHECK(TaskSched_AddBackgroundTaskEx(&tsbtestload, TASKSCHEDULER_BKG_PRIO_NORMAL, 0, TSBTEST_LOAD2));
+    HOSTSIMTEST_CHECK(TaskSched_AddBackgroundTaskEx(&tsbtesttask, TASKSCHEDULER_BKG_PRIO_LOW, TSBTEST_DEADLINE_MS, TSBTEST_LOW));
+    HOSTSIMTEST_CHECK(TaskSched_AddBackgroundTaskEx(&tsbtestcont, TASKSCHEDULER_BKG_PRIO_NORMAL, 0, TSBTEST_CONT));
+    HOSTSIMTEST_CHECK(!TaskSched_AddBackgroundTaskEx(&tsbtesttask, TASKSCHEDULER_BKG_PRIOS, 0, 0));
+
+        // idle: each task once, classes in order
+    tsbtestloop();
+    HOSTSIMTEST_CHECK(uwTsbTestLogLen==TSBTEST_TASKS);
+    HOSTSIMTEST_CHECK(uwTsbTestLog[0]==TSBTEST_HIGH && uwTsbTestLog[1]==TSBTEST_LOAD1 && uwTsbTestLog[2]==TSBTEST_LOAD2);
+    HOSTSIMTEST_CHECK(uwTsbTestLog[3]==TSBTEST_CONT && uwTsbTestLog[4]==TSBTEST_LOW);
+
+        // load within the deadline: high class first in each loop and polled
+    // between loaded tasks, low class last and on time
+    TaskSched_BkgStatsReset();
+    uwTsbTestLoad=TSBTEST_LOAD;
+    for(uwLoop=0,uwPolls=0,bHighFirst=bLowLast=TRUE;uwLoop<TSBTEST_LOOPS;uwLoop++)
+    {
+        tsbtestloop();
+        bHighFirst=bHighFirst && tsbtestfirst(TSBTEST_HIGH)==0;
+        bLowLast=bLowLast && tsbtestfirst(TSBTEST_LOW)==uwTsbTestLogLen-1;
+        uwPolls+=tsbtestcount(TSBTEST_HIGH)-1;
+    }
+    HOSTSIMTEST_CHECK(bHighFirst && bLowLast);
+    HOSTSIMTEST_CHECK(uwPolls>=TSBTEST_LOOPS);
+    HOSTSIMTEST_CHECK(TaskSched_BkgStatsGet(TSBTEST_HIGH, &sHigh));
+    HOSTSIMTEST_CHECK(TaskSched_BkgStatsGet(TSBTEST_LOW, &sLow));
+    HOSTSIMTEST_CHECK(uwTaskSchedBkgLoopMaxTime[TASKSCHEDULER_BKG_CPU0]>=2*TSBTEST_LOAD);
+    HOSTSIMTEST_CHECK(sHigh.uwMaxLatency<=TSBTEST_LOAD);
+    HOSTSIMTEST_CHECK(sLow.uwMaxLatency>=2*TSBTEST_LOAD && sLow.uwMaxLatency<=TSBTEST_DEADLINE);
+    HOSTSIMTEST_CHECK(sLow.ulMissed==0 && sLow.ulCalls==TSBTEST_LOOPS);
+    HOSTSIMTEST_CHECK(sLow.uwDeadline==TSBTEST_DEADLINE && sLow.uwPriority==TASKSCHEDULER_BKG_PRIO_LOW);
+    HOSTSIMTEST_CHECK(sLow.uwCpu==TASKSCHEDULER_BKG_CPU0 && sLow.ulTask==(ULONG)&tsbtesttask);
+    HOSTSIMTEST_CHECK(sHigh.ulCalls==TSBTEST_LOOPS+uwPolls && sHigh.ulYields==0);
+
+        // loop past the deadline: the overdue low class task is run by the
+        // polls ahead of its turn, once per loop; late starts are counted
+    TaskSched_BkgStatsReset();
+    uwTsbTestLoad=TSBTEST_LOAD_STARVING;
+    for(uwLoop=0,bHighFirst=TRUE;uwLoop<TSBTEST_LOOPS;uwLoop++)
+    {
+        tsbtestloop();
+        bHighFirst=bHighFirst && tsbtestfirst(TSBTEST_HIGH)==0;
+        HOSTSIMTEST_CHECK(tsbtestcount(TSBTEST_LOW)==1);
+    }
+    HOSTSIMTEST_CHECK(bHighFirst);
+    uwMaxLoop=uwTaskSchedBkgLoopMaxTime[TASKSCHEDULER_BKG_CPU0];
+    HOSTSIMTEST_CHECK(TaskSched_BkgStatsGet(TSBTEST_HIGH, &sHigh));
+    HOSTSIMTEST_CHECK(TaskSched_BkgStatsGet(TSBTEST_LOW, &sLow));
+    HOSTSIMTEST_CHECK(uwMaxLoop>=2*TSBTEST_LOAD_STARVING && uwMaxLoop>TSBTEST_DEADLINE);
+    HOSTSIMTEST_CHECK(sHigh.uwMaxLatency<=TSBTEST_LOAD_STARVING);
+    HOSTSIMTEST_CHECK(sLow.ulCalls==TSBTEST_LOOPS && sLow.ulMissed>0);
+    HOSTSIMTEST_CHECK(sLow.uwMaxLatency>TSBTEST_DEADLINE && sLow.uwMaxLatency<=TSBTEST_DEADLINE+TSBTEST_LOAD_STARVING);
+    HOSTSIMTEST_CHECK(tsbtestfirst(TSBTEST_LOW)<tsbtestfirst(TSBTEST_CONT));
+    uwLowLatency=sLow.uwMaxLatency;
+    ulLowMissed=sLow.ulMissed;
+
+        // continuation: run again within the slice of its class, resumed at
+        // next loop, high class polled in between
+    TaskSched_BkgStatsReset();
+    uwTsbTestLoad=0;
+    uwTsbTestUnitsLeft=TSBTEST_UNITS;
+    uwTsbTestUnitsDone=0;
+    tsbtestloop();
+    HOSTSIMTEST_CHECK(uwTsbTestUnitsDone>1 && uwTsbTestUnitsDone<TSBTEST_UNITS);
+    HOSTSIMTEST_CHECK(uwTsbTestUnitsDone<=TASKSCHEDULER_BKG_CONTINUATION_SLOTS+1);
+    HOSTSIMTEST_CHECK(tsbtestcount(TSBTEST_HIGH)>1);
+    HOSTSIMTEST_CHECK(tsbtestfirst(TSBTEST_LOW)==uwTsbTestLogLen-1);
+    for(uwLoop=0;uwLoop<TSBTEST_UNITS && uwTsbTestUnitsLeft;uwLoop++)
+        tsbtestloop();
+    HOSTSIMTEST_CHECK(uwTsbTestUnitsDone==TSBTEST_UNITS);
+    HOSTSIMTEST_CHECK(uwLoop<=TSBTEST_UNITS/(TASKSCHEDULER_BKG_CONTINUATION_SLOTS-1));
+    HOSTSIMTEST_CHECK(TaskSched_BkgStatsGet(TSBTEST_CONT, &sRec));
+    HOSTSIMTEST_CHECK(sRec.ulCalls==TSBTEST_UNITS && sRec.ulYields==TSBTEST_UNITS-1);
+    HOSTSIMTEST_CHECK(TaskSched_BkgStatsGet(TSBTEST_HIGH, &sHigh) && sHigh.uwMaxLatency<=1);
+
+        // parameter hook: no. of tasks, records as the snapshot, reset by
+        // a write to element 0 at next loop start
+    HOSTSIMTEST_CHECK(tsbtestread(0, &uwTasks, sizeof(uwTasks))==COMMONPARAMDB_CH_OK && uwTasks==TSBTEST_TASKS);
+    HOSTSIMTEST_CHECK(tsbtestread(TSBTEST_CONT+1, ubBuf, sizeof(ubBuf))==COMMONPARAMDB_CH_OK);
+    HOSTSIMTEST_CHECK(memcmp(ubBuf, &sRec, sizeof(sRec))==0);
+    HOSTSIMTEST_CHECK(tsbtestwrite(0, 0)==COMMONPARAMDB_CH_OK);
+    tsbtestloop();
+    HOSTSIMTEST_CHECK(TaskSched_BkgStatsGet(TSBTEST_CONT, &sRec) && sRec.ulCalls==1 && sRec.ulYields==0);
+    HOSTSIMTEST_CHECK(TaskSched_BkgStatsGet(TSBTEST_LOW, &sLow) && sLow.ulCalls==1 && sLow.ulMissed==0);
+    HOSTSIMTEST_CHECK(uwTaskSchedBkgLoopMaxTime[TASKSCHEDULER_BKG_CPU0]==0);
+
+    printf("TaskSchedBkgTest: high class polled %u times in %u loops; starving loop %u slots, low class latency %u/%u slots, %lu late\n",
+        (unsigned)uwPolls, (unsigned)TSBTEST_LOOPS, (unsigned)uwMaxLoop, (unsigned)uwLowLatency, (unsigned)TSBTEST_DEADLINE, (unsigned long)ulLowMissed);
+
+    return HOSTSIMTEST_RESULT("TaskSchedBkgTest");
+}
@@ -0,0 +1,270 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : TaskSchedDispatchTest.c                                    */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Realtime scheduler dispatch lists against the              */
+/*               interpreted list semantics                                 */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\TaskScheduler.h"
+#include "core\Timer.h"
+#include "drive\AxM-E-Defines.h"
+#include "system\SystemStatus.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // scenario length in realtime ticks, tick a task is added at
+#define TSDTEST_TICKS                   4000
+#define TSDTEST_ADD_TICK                (TSDTEST_TICKS/2)
+    // slot tasks, tasks per rate group (4kHz, 1kHz, 125Hz), added task
+#define TSDTEST_SLOT_TASKS              21
+#define TSDTEST_GROUP_TASKS             2
+#define TSDTEST_TASKS                   (TSDTEST_SLOT_TASKS+(TASKSCHEDULER_RATE_GROUPS-1)*TSDTEST_GROUP_TASKS+1)
+    // status bits selecting the tasks, not used by the scheduler itself
+#define TSDTEST_STATUS_FIRST            SYSTEMSTATUS_BIT_PDOMGR_LOCKCONFIG
+#define TSDTEST_STATUS_BITS             6
+    // status bit in no task mask
+#define TSDTEST_STATUS_UNUSED           SYSTEMSTATUS_BIT_ECATPDOMGR_LOCKCONFIG
+    // id of the status changes outside the scheduler, log tick marker
+#define TSDTEST_ID_EXTERNAL             0xFF
+#define TSDTEST_LOG_TICK                0xFFFF
+#define TSDTEST_LOG_SIZE                (TSDTEST_TICKS*(TSDTEST_TASKS+1))
+
+//***************************************************************************
+// Structures
+
+    // synthetic task
+typedef struct
+{
+    UBYTE           ubFlags;
+    UWORD           uwRate;
+    SYSTEMSTATUS    uSelect;
+    SYSTEMSTATUS    uMask;
+} TSDTEST_TASK;
+
+    // execution log, task ids with tick markers
+typedef struct
+{
+    ULONG           ulLen;
+    UWORD           uwId[TSDTEST_LOG_SIZE];
+} TSDTEST_LOG;
+
+//***************************************************************************
+// Locals
+
+static TSDTEST_TASK sTsdTestTask[TSDTEST_TASKS];
+static TSDTEST_LOG sTsdTestRun;
+static TSDTEST_LOG sTsdTestRef;
+static ULONG ulTsdTestTick;
+static ULONG ulTsdTestSeed;
+    // status changes made by tasks in the reference
+static ULONG ulTsdTestEdges;
+
+//***************************************************************************
+// Random numbers
+
+static ULONG tsdtestrand(void)
+{
+    ulTsdTestSeed=ulTsdTestSeed*1664525ul+1013904223ul;
+
+    return ulTsdTestSeed>>8;
+}
+
+//***************************************************************************
+// Status bits toggled by task # run at tick, same for run and reference
+
+static SYSTEMSTATUS tsdtestaction(ULONG ulId, ULONG ulTick)
+{
+    ULONG ulHash=ulId*2654435761ul^ulTick*40503ul;
+    SYSTEMSTATUS uToggle=0ul;
+
+    ulHash^=ulHash>>13;
+    ulHash*=0x5BD1E995ul;
+    ulHash^=ulHash>>15;
+
+    if((ulHash&7)==0)
+        uToggle|=SYSTEMSTATUS_MASK(TSDTEST_STATUS_FIRST+(ulHash>>3)%TSDTEST_STATUS_BITS);
+    if(((ulHash>>8)&15)==0)
+        uToggle|=SYSTEMSTATUS_MASK(TSDTEST_STATUS_UNUSED);
+
+    return uToggle;
+}
+
+//***************************************************************************
+// Log task #
+
+static void tsdtestlog(TSDTEST_LOG * psLog, UWORD uwId)
+{
+    if(psLog->ulLen<TSDTEST_LOG_SIZE)
+        psLog->uwId[psLog->ulLen++]=uwId;
+}
+
+//***************************************************************************
+// Realtime task: log and change status
+
+static BOOL tsdtesttask(ULONG ulId)
+{
+    tsdtestlog(&sTsdTestRun, (UWORD)ulId);
+    ulSystemStatus^=tsdtestaction(ulId, ulTsdTestTick);
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Add task # to scheduler
+
+static BOOL tsdtestadd(UWORD uwId)
+{
+    TSDTEST_TASK * psTask=&sTsdTestTask[uwId];
+
+    if(psTask->uwRate==TASKSCHEDULER_RATE_8KHZ)
+        return TaskSched_AddRTTaskEx(&tsdtesttask, psTask->ubFlags, psTask->uSelect, psTask->uMask, 0, uwId);
+
+    return TaskSched_AddRateTask(&tsdtesttask, psTask->uwRate, psTask->uSelect, psTask->uMask, uwId);
+}
+
+//***************************************************************************
+// Pre tick: status changed outside the scheduler, task added
+
+static void tsdtestpretick(ULONG ulTick)
+{
+    ulSystemStatus^=tsdtestaction(TSDTEST_ID_EXTERNAL, ulTsdTestTick);
+    if(ulTsdTestTick==TSDTEST_ADD_TICK)
+        tsdtestadd(TSDTEST_TASKS-1);
+}
+
+//***************************************************************************
+// Post tick: close tick in log
+
+static void tsdtestposttick(ULONG ulTick)
+{
+    tsdtestlog(&sTsdTestRun, TSDTEST_LOG_TICK);
+    ulTsdTestTick++;
+}
+
+//***************************************************************************
+// Random task set: status mask and selection among the test bits, phase
+// flags for slot tasks, the last one added while running
+
+static void tsdtesttasks(void)
+{
+    TSDTEST_TASK * psTask;
+    UWORD i;
+
+    for(i=0;i<TSDTEST_TASKS;i++)
+    {
+        psTask=&sTsdTestTask[i];
+        psTask->uMask=(SYSTEMSTATUS)(tsdtestrand()&((1ul<<TSDTEST_STATUS_BITS)-1))<<TSDTEST_STATUS_FIRST;
+        psTask->uSelect=(SYSTEMSTATUS)(tsdtestrand()<<TSDTEST_STATUS_FIRST)&psTask->uMask;
+        psTask->ubFlags=TASKSCHEDULER_FLAG_NONE;
+        psTask->uwRate=TASKSCHEDULER_RATE_8KHZ;
+        if(i>=TSDTEST_SLOT_TASKS && i<TSDTEST_TASKS-1)
+            psTask->uwRate=(UWORD)(1+(i-TSDTEST_SLOT_TASKS)/TSDTEST_GROUP_TASKS);
+        else if(tsdtestrand()%3==1)
+            psTask->ubFlags=TASKSCHEDULER_FLAG_EXECUTEODD;
+        else if(tsdtestrand()%2==1)
+            psTask->ubFlags=TASKSCHEDULER_FLAG_EXECUTEEVEN;
+    }
+}
+
+//***************************************************************************
+// Reference: list interpreted task by task with the status of the moment,
+// rate groups after the slot tasks in priority order
+
+static void tsdtestreference(void)
+{
+    TSDTEST_TASK * psTask;
+    SYSTEMSTATUS uStatus=0ul;
+    SYSTEMSTATUS uToggle;
+    UWORD uwSlotCnt[TASKSCHEDULER_RATE_GROUPS];
+    BOOL bOdd=FALSE;
+    ULONG ulTick;
+    UWORD uwOrder, uwGroup, uwTasks, i;
+
+    for(i=0;i<TASKSCHEDULER_RATE_GROUPS;i++)
+        uwSlotCnt[i]=sTaskSchedRateDefs[i].uwPhase+1;
+
+    for(ulTick=0;ulTick<TSDTEST_TICKS;ulTick++)
+    {
+        uStatus^=tsdtestaction(TSDTEST_ID_EXTERNAL, ulTick);
+        uwTasks=ulTick>=TSDTEST_ADD_TICK?TSDTEST_TASKS:TSDTEST_TASKS-1;
+        bOdd=!bOdd;
+
+        for(uwOrder=0;uwOrder<TASKSCHEDULER_RATE_GROUPS;uwOrder++)
+        {
+            uwGroup=ubTaskSchedRateOrder[uwOrder];
+            if(uwGroup!=TASKSCHEDULER_RATE_8KHZ)
+            {
+                if(--uwSlotCnt[uwGroup])
+                    continue;
+                uwSlotCnt[uwGroup]=sTaskSchedRateDefs[uwGroup].uwNSlots;
+            }
+
+            for(i=0;i<uwTasks;i++)
+            {
+                psTask=&sTsdTestTask[i];
+                if(psTask->uwRate!=uwGroup || psTask->uSelect!=(psTask->uMask&uStatus))
+                    continue;
+                if(((psTask->ubFlags&TASKSCHEDULER_FLAG_EXECUTEODD) && !bOdd) || ((psTask->ubFlags&TASKSCHEDULER_FLAG_EXECUTEEVEN) && bOdd))
+                    continue;
+
+                tsdtestlog(&sTsdTestRef, i);
+                uToggle=tsdtestaction(i, ulTick);
+                if(uToggle&~SYSTEMSTATUS_MASK(TSDTEST_STATUS_UNUSED))
+                    ulTsdTestEdges++;
+                uStatus^=uToggle;
+            }
+        }
+        tsdtestlog(&sTsdTestRef, TSDTEST_LOG_TICK);
+    }
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    ULONG ulSet, i;
+    BOOL bOk=TRUE;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    HostSim_SetTickHooks(tsdtestpretick, tsdtestposttick);
+    ulTsdTestSeed=0x7A5C0001ul;
+
+        // task sets with status changed by tasks in the slot and by others
+    for(ulSet=0;ulSet<8;ulSet++)
+    {
+        tsdtesttasks();
+        HOSTSIMTEST_CHECK(TaskSched_Init());
+        for(i=0;i<TSDTEST_TASKS-1;i++)
+            bOk=tsdtestadd((UWORD)i) && bOk;
+        ulSystemStatus=0ul;
+        sTsdTestRun.ulLen=sTsdTestRef.ulLen=0;
+        ulTsdTestTick=0;
+        ulTsdTestEdges=0;
+
+        Timer_Init(REALTIME_TASK_FREQ, TaskSched_RTScheduler);
+        HostSim_RunTicks(TSDTEST_TICKS);
+        tsdtestreference();
+
+        printf("TaskSchedDispatchTest: set %lu, %lu executions, %lu status changes by tasks\n",
+            ulSet, sTsdTestRef.ulLen-TSDTEST_TICKS, ulTsdTestEdges);
+        bOk=bOk && ulTsdTestEdges>100;
+        bOk=bOk && sTsdTestRun.ulLen==sTsdTestRef.ulLen &&
+            memcmp(sTsdTestRun.uwId, sTsdTestRef.uwId, sTsdTestRef.ulLen*sizeof(UWORD))==0;
+    }
+    HOSTSIMTEST_CHECK(bOk);
+
+    return HOSTSIMTEST_RESULT("TaskSchedDispatchTest");
+}
@@ -0,0 +1,222 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : TaskSchedOptionalTest.c                                    */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Realtime scheduler optional tasks: slot budget,            */
+/*               reiteration and carry over                                 */
+/*                                                                          */
+/****************************************************************************/
+
+#include "common\CommonDefines.h"
+#include "common\TaskScheduler.h"
+#include "core\Timer.h"
+#include "drive\AxM-E-Defines.h"
+#include "system\SystemStatus.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // reiterated task: iterations per request and cost of each [100nsec]
+#define TSOTEST_ITERATIONS              64
+#define TSOTEST_ITERATION_TIME          30
+    // slot load before the optional task: light, heavy but within standard
+    // time, over standard time [100nsec]
+#define TSOTEST_LOAD_LIGHT              100
+#define TSOTEST_LOAD_HEAVY              1000
+#define TSOTEST_LOAD_OVER               1150
+    // every # slots task period
+#define TSOTEST_NSLOTS                  4
+    // status bit of the pending reiterated work, as the PLC image copy
+#define TSOTEST_STATUS_BIT              SYSTEMSTATUS_BIT_PNLMGR_PACKETRECEIVED
+
+//***************************************************************************
+// Locals
+
+static UWORD uwTsoTestLoad;
+static ULONG ulTsoTestTick;
+    // reiterated task: iterations left, run per slot, slot of completion
+static UWORD uwTsoTestLeft;
+static UWORD uwTsoTestSlotRuns;
+static UWORD uwTsoTestMaxSlotRuns;
+static ULONG ulTsoTestDoneTick;
+    // plain optional task: runs and ticks of last run
+static ULONG ulTsoTestRuns;
+static ULONG ulTsoTestLastTick;
+static ULONG ulTsoTestMaxGap;
+    // every # slots task: tick of each run
+static ULONG ulTsoTestRunTick[64];
+
+//***************************************************************************
+// Slot load ahead of the optional tasks
+
+static BOOL tsotestload(void)
+{
+    HostSim_Consume(uwTsoTestLoad);
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Reiterated task: one iteration per call, TRUE while more is pending;
+// status cleared when done
+
+static BOOL tsotestreiterate(void)
+{
+    HostSim_Consume(TSOTEST_ITERATION_TIME);
+    uwTsoTestSlotRuns++;
+    if(--uwTsoTestLeft)
+        return TRUE;
+
+    ulSystemStatus&=~SYSTEMSTATUS_MASK(TSOTEST_STATUS_BIT);
+    ulTsoTestDoneTick=ulTsoTestTick;
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Plain optional task
+
+static BOOL tsotestoptional(void)
+{
+    if(ulTsoTestRuns && ulTsoTestTick-ulTsoTestLastTick>ulTsoTestMaxGap)
+        ulTsoTestMaxGap=ulTsoTestTick-ulTsoTestLastTick;
+    ulTsoTestLastTick=ulTsoTestTick;
+    ulTsoTestRuns++;
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Every # slots optional task
+
+static BOOL tsotestnslots(void)
+{
+    if(ulTsoTestRuns<sizeof(ulTsoTestRunTick)/sizeof(ULONG))
+        ulTsoTestRunTick[ulTsoTestRuns]=ulTsoTestTick;
+    ulTsoTestRuns++;
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Tick hooks: tick count, max iterations per slot
+
+static void tsotestpretick(ULONG ulTick)
+{
+    uwTsoTestSlotRuns=0;
+}
+
+static void tsotestposttick(ULONG ulTick)
+{
+    if(uwTsoTestSlotRuns>uwTsoTestMaxSlotRuns)
+        uwTsoTestMaxSlotRuns=uwTsoTestSlotRuns;
+    ulTsoTestTick++;
+}
+
+//***************************************************************************
+// Scheduler restart with the load task first and the given optional task
+
+static BOOL tsotestinit(BOOL (* pfTask)(void), UBYTE ubFlags, SYSTEMSTATUS uStatus, UWORD uwNSlots)
+{
+    BOOL bOk=TaskSched_Init();
+
+    bOk=TaskSched_AddRTTask(&tsotestload, TASKSCHEDULER_FLAG_NONE, 0, 0, 0) && bOk;
+    bOk=TaskSched_AddRTTask(pfTask, ubFlags, uStatus, uStatus, uwNSlots) && bOk;
+    Timer_Init(REALTIME_TASK_FREQ, TaskSched_RTScheduler);
+
+    ulTsoTestTick=0;
+    ulTsoTestRuns=ulTsoTestLastTick=ulTsoTestMaxGap=0;
+    uwTsoTestMaxSlotRuns=0;
+    sHostSimStats.uwMaxTime=0;
+
+    return bOk;
+}
+
+//***************************************************************************
+// Reiterated work request, run until done: slots taken
+
+static ULONG tsotestrequest(UWORD uwLoad)
+{
+    uwTsoTestLoad=uwLoad;
+    uwTsoTestLeft=TSOTEST_ITERATIONS;
+    uwTsoTestMaxSlotRuns=0;
+    ulTsoTestDoneTick=0xFFFFFFFFul;
+    ulSystemStatus|=SYSTEMSTATUS_MASK(TSOTEST_STATUS_BIT);
+    ulTsoTestTick=0;
+    HostSim_RunTicks(2*TSOTEST_ITERATIONS);
+
+    return ulTsoTestDoneTick+1;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    ULONG ulSlots, i;
+    BOOL bOk=TRUE;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+    HostSim_SetTickHooks(tsotestpretick, tsotestposttick);
+    ulSystemStatus=0ul;
+
+        // reiterated optional task stops at standard time, going on at next
+        // slots until done; slot time stays within one iteration of it
+    HOSTSIMTEST_CHECK(tsotestinit(&tsotestreiterate, TASKSCHEDULER_FLAG_REITERATEIFREQ|TASKSCHEDULER_FLAG_OPTIONAL,
+        SYSTEMSTATUS_MASK(TSOTEST_STATUS_BIT), 0));
+    ulSlots=tsotestrequest(TSOTEST_LOAD_LIGHT);
+    printf("TaskSchedOptionalTest: light load, %lu slots, max %u iterations per slot\n", ulSlots, uwTsoTestMaxSlotRuns);
+    HOSTSIMTEST_CHECK(uwTsoTestLeft==0 && ulSlots==2);
+    HOSTSIMTEST_CHECK(uwTsoTestMaxSlotRuns==(TASKSCHEDULER_RT_STD_EXECUTION_TIME-TSOTEST_LOAD_LIGHT+TSOTEST_ITERATION_TIME-1)/TSOTEST_ITERATION_TIME);
+    HOSTSIMTEST_CHECK(sHostSimStats.uwMaxTime<TASKSCHEDULER_RT_STD_EXECUTION_TIME+TSOTEST_ITERATION_TIME);
+
+    ulSlots=tsotestrequest(TSOTEST_LOAD_HEAVY);
+    printf("TaskSchedOptionalTest: heavy load, %lu slots, max %u iterations per slot\n", ulSlots, uwTsoTestMaxSlotRuns);
+    HOSTSIMTEST_CHECK(uwTsoTestLeft==0);
+    HOSTSIMTEST_CHECK(uwTsoTestMaxSlotRuns==(TASKSCHEDULER_RT_STD_EXECUTION_TIME-TSOTEST_LOAD_HEAVY+TSOTEST_ITERATION_TIME-1)/TSOTEST_ITERATION_TIME);
+    HOSTSIMTEST_CHECK(ulSlots==(TSOTEST_ITERATIONS+uwTsoTestMaxSlotRuns-1)/uwTsoTestMaxSlotRuns);
+    HOSTSIMTEST_CHECK(sHostSimStats.uwMaxTime<TASKSCHEDULER_RT_STD_EXECUTION_TIME+TSOTEST_ITERATION_TIME);
+
+        // no time left: carried over, one iteration forced at the deadline
+    tsotestrequest(TSOTEST_LOAD_OVER);
+    printf("TaskSchedOptionalTest: over standard time, %u iterations left\n", uwTsoTestLeft);
+    HOSTSIMTEST_CHECK(uwTsoTestLeft==TSOTEST_ITERATIONS-2*TSOTEST_ITERATIONS/(TASKSCHEDULER_RT_OPTIONAL_DEADLINE+1));
+    HOSTSIMTEST_CHECK(uwTsoTestMaxSlotRuns==1);
+
+        // plain optional task: every slot with time left, otherwise carried
+        // over up to the deadline
+    HOSTSIMTEST_CHECK(tsotestinit(&tsotestoptional, TASKSCHEDULER_FLAG_OPTIONAL, 0, 0));
+    uwTsoTestLoad=TSOTEST_LOAD_HEAVY;
+    HostSim_RunTicks(1000);
+    HOSTSIMTEST_CHECK(ulTsoTestRuns==1000 && ulTsoTestMaxGap==1);
+    uwTsoTestLoad=TSOTEST_LOAD_OVER;
+    ulTsoTestRuns=0;
+    HostSim_RunTicks(9*100);
+    printf("TaskSchedOptionalTest: plain optional over standard time, %lu runs in 900 slots, max gap %lu\n",
+        ulTsoTestRuns, ulTsoTestMaxGap);
+    HOSTSIMTEST_CHECK(ulTsoTestRuns==100);
+    HOSTSIMTEST_CHECK(ulTsoTestMaxGap==TASKSCHEDULER_RT_OPTIONAL_DEADLINE+1);
+
+        // every # slots optional task: carried over to the first slot with
+        // time left, keeping its phase
+    HOSTSIMTEST_CHECK(tsotestinit(&tsotestnslots, TASKSCHEDULER_FLAG_OPTIONAL|TASKSCHEDULER_FLAG_EXEEVERYNSLOTS|TASKSCHEDULER_FLAG_FIXEDPHASE,
+        0, TSOTEST_NSLOTS));
+    uwTsoTestLoad=TSOTEST_LOAD_LIGHT;
+    HostSim_RunTicks(TSOTEST_NSLOTS);
+    uwTsoTestLoad=TSOTEST_LOAD_OVER;
+    HostSim_RunTicks(2);
+    uwTsoTestLoad=TSOTEST_LOAD_LIGHT;
+    HostSim_RunTicks(4*TSOTEST_NSLOTS);
+    bOk=ulTsoTestRuns==6 && ulTsoTestRunTick[1]==ulTsoTestRunTick[0]+TSOTEST_NSLOTS+2;
+    for(i=2;i<ulTsoTestRuns;i++)
+        bOk=bOk && ulTsoTestRunTick[i]==ulTsoTestRunTick[0]+i*TSOTEST_NSLOTS;
+    HOSTSIMTEST_CHECK(bOk);
+
+    return HOSTSIMTEST_RESULT("TaskSchedOptionalTest");
+}
@@ -0,0 +1,248 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : TaskSchedStatsTest.c                                       */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Realtime task statistics and trace: histogram, p99,        */
+/*               overruns, reset through the parameter hook, freeze on overtime */
+/*                                                                          */
+/****************************************************************************/
+
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\CommonParamDB.h"
+#include "common\TaskScheduler.h"
+#include "core\Timer.h"
+#include "drive\AxM-E-Defines.h"
+#include "system\SystemStatus.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // constant cost task [100nsec], in bucket 7 ([64,128))
+#define TSSTEST_FIXED_TIME              100
+    // variable cost task: base cost in bucket 6 ([32,64)), one call every
+    // # at spike cost in bucket 10 ([512,1024))
+#define TSSTEST_BASE_TIME               50
+#define TSSTEST_SPIKE_TIME              800
+#define TSSTEST_SPIKE_PERIOD            100
+    // ticks of the statistics scenario, multiple of the spike period
+#define TSSTEST_TICKS                   1000
+    // variable task cost making the slot cross max time, stay below peak
+#define TSSTEST_OVERRUN_TIME            (TASKSCHEDULER_RT_MAX_EXECUTION_TIME+10-TSSTEST_FIXED_TIME)
+#define TSSTEST_OVERRUNS                5
+    // and crossing peak time
+#define TSSTEST_PEAK_TIME               (TASKSCHEDULER_RT_PEAK_EXECUTION_TIME+60-TSSTEST_FIXED_TIME)
+
+//***************************************************************************
+// Locals
+
+    // variable task: calls, forced cost (0 for the spike pattern)
+static ULONG ulTssTestCalls;
+static UWORD uwTssTestCost;
+
+//***************************************************************************
+// Constant cost task
+
+static BOOL tsstestfixed(void)
+{
+    HostSim_Consume(TSSTEST_FIXED_TIME);
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Variable cost task: base cost with periodic spike, or forced cost
+
+static BOOL tsstestvariable(void)
+{
+    if(uwTssTestCost)
+        HostSim_Consume(uwTssTestCost);
+    else if(ulTssTestCalls%TSSTEST_SPIKE_PERIOD==TSSTEST_SPIKE_PERIOD-1)
+        HostSim_Consume(TSSTEST_SPIKE_TIME);
+    else
+        HostSim_Consume(TSSTEST_BASE_TIME);
+    ulTssTestCalls++;
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Statistics read through the parameter hook, as fieldbus does; return
+// hook result
+
+static UWORD tsstesthookread(UWORD uwElement, HPVOID hpvBuffer, UWORD uwBufSize)
+{
+    UWORD uwSize=uwBufSize;
+
+    return TaskSched_RTStatsHook(NULL, COMMONPARAMDB_CBFLAG_RD|COMMONPARAMDB_CBFLAG_SEGMENT, uwElement, hpvBuffer, &uwSize, NULL);
+}
+
+static UWORD tsstesthookwrite(UWORD uwElement)
+{
+    UWORD uwValue=0;
+    UWORD uwSize=sizeof(uwValue);
+
+    return TaskSched_RTStatsHook(NULL, COMMONPARAMDB_CBFLAG_WR|COMMONPARAMDB_CBFLAG_SEGMENT, uwElement, &uwValue, &uwSize, NULL);
+}
+
+//***************************************************************************
+// Sum of histogram buckets
+
+static ULONG tsstesthisto(const TASKSCHEDULER_RT_STATS_REC * psRec)
+{
+    ULONG ulSum=0;
+    UWORD i;
+
+    for(i=0;i<TASKSCHEDULER_RT_HISTO_BUCKETS;i++)
+        ulSum+=psRec->ulHisto[i];
+
+    return ulSum;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    TASKSCHEDULER_RT_STATS_REC sFixed,sVar,sRec;
+    TASKSCHEDULER_RT_TRACE_TICK sTick;
+    UBYTE ubBuf[sizeof(TASKSCHEDULER_RT_STATS_REC)+8];
+    ULONG ulFreezeCnt,ulHead,ulSize;
+    UWORD uwTasks,uwSize,ct;
+
+    HostSim_Init(HOSTSIM_CLOCK_VIRTUAL);
+
+        // booting: overtime not checked while statistics are collected
+    ulSystemStatus=SYSTEMSTATUS_MASK(SYSTEMSTATUS_BIT_BOOTING);
+    HOSTSIMTEST_CHECK(TaskSched_Init());
+    HOSTSIMTEST_CHECK(TaskSched_AddRTTask(&tsstestfixed, TASKSCHEDULER_FLAG_NONE, 0, 0, 0));
+    HOSTSIMTEST_CHECK(TaskSched_AddRTTask(&tsstestvariable, TASKSCHEDULER_FLAG_NONE, 0, 0, 0));
+    Timer_Init(REALTIME_TASK_FREQ, TaskSched_RTScheduler);
+
+        // min, max, average, p99 at bucket resolution, histogram
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(TSSTEST_TICKS)==0);
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsGet(0, &sFixed));
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsGet(1, &sVar));
+    HOSTSIMTEST_CHECK(!TaskSched_RTStatsGet(2, &sRec));
+    HOSTSIMTEST_CHECK(sFixed.ulTask==(ULONG)&tsstestfixed && sVar.ulTask==(ULONG)&tsstestvariable);
+    HOSTSIMTEST_CHECK(sFixed.ulCalls==TSSTEST_TICKS && sFixed.ulOverruns==0);
+    HOSTSIMTEST_CHECK(sFixed.uwMinTime==TSSTEST_FIXED_TIME && sFixed.uwMaxTime==TSSTEST_FIXED_TIME);
+    HOSTSIMTEST_CHECK(sFixed.uwAvgTime==TSSTEST_FIXED_TIME && sFixed.uwP99Time==TSSTEST_FIXED_TIME);
+    HOSTSIMTEST_CHECK(sFixed.ulHisto[7]==TSSTEST_TICKS);
+    HOSTSIMTEST_CHECK(sVar.ulCalls==TSSTEST_TICKS && sVar.ulOverruns==0);
+    HOSTSIMTEST_CHECK(sVar.uwMinTime==TSSTEST_BASE_TIME && sVar.uwMaxTime==TSSTEST_SPIKE_TIME);
+    HOSTSIMTEST_CHECK(sVar.uwAvgTime==(TSSTEST_BASE_TIME*(TSSTEST_SPIKE_PERIOD-1)+TSSTEST_SPIKE_TIME)/TSSTEST_SPIKE_PERIOD);
+    HOSTSIMTEST_CHECK(sVar.ulHisto[6]==TSSTEST_TICKS-TSSTEST_TICKS/TSSTEST_SPIKE_PERIOD);
+    HOSTSIMTEST_CHECK(sVar.ulHisto[10]==TSSTEST_TICKS/TSSTEST_SPIKE_PERIOD);
+    HOSTSIMTEST_CHECK(tsstesthisto(&sVar)==TSSTEST_TICKS);
+        // 99% of the calls within bucket 6, upper bound 63
+    HOSTSIMTEST_CHECK(sVar.uwP99Time==63);
+        // one more spike: p99 moves to the spike bucket, capped by max
+    uwTssTestCost=TSSTEST_SPIKE_TIME;
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(1)==0);
+    uwTssTestCost=0;
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsGet(1, &sRec));
+    HOSTSIMTEST_CHECK(sRec.uwP99Time==TSSTEST_SPIKE_TIME);
+
+        // parameter hook: no. of tasks, records as the snapshot, sizes,
+        // unused record reads as zero, elements past the rate groups
+    ulSize=0;
+    uwSize=sizeof(ulSize);
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsHook(NULL, COMMONPARAMDB_CBFLAG_RD|COMMONPARAMDB_CBFLAG_INIT|COMMONPARAMDB_CBFLAG_SIZEINQUIRY, 1, &ulSize, &uwSize, NULL)==COMMONPARAMDB_CH_OK);
+    HOSTSIMTEST_CHECK(ulSize==sizeof(TASKSCHEDULER_RT_STATS_REC));
+    HOSTSIMTEST_CHECK(tsstesthookread(0, ubBuf, sizeof(ubBuf))==COMMONPARAMDB_CH_OK);
+    memcpy(&uwTasks, ubBuf, sizeof(UWORD));
+    HOSTSIMTEST_CHECK(uwTasks==2);
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsGet(1, &sVar));
+    HOSTSIMTEST_CHECK(tsstesthookread(2, ubBuf, sizeof(ubBuf))==COMMONPARAMDB_CH_OK);
+    HOSTSIMTEST_CHECK(memcmp(ubBuf, &sVar, sizeof(sVar))==0);
+    HOSTSIMTEST_CHECK(tsstesthookread(3, ubBuf, sizeof(ubBuf))==COMMONPARAMDB_CH_OK);
+    memset(&sRec, 0, sizeof(sRec));
+    HOSTSIMTEST_CHECK(memcmp(ubBuf, &sRec, sizeof(sRec))==0);
+    HOSTSIMTEST_CHECK(tsstesthookread(1, ubBuf, sizeof(TASKSCHEDULER_RT_STATS_REC)-1)==COMMONPARAMDB_CH_WRONGLENGTH);
+    HOSTSIMTEST_CHECK(tsstesthookread(TASKSCHEDULER_RT_MAX_ENTRIES+TASKSCHEDULER_RATE_GROUPS+1, ubBuf, sizeof(ubBuf))==COMMONPARAMDB_CH_INVALID_ELEMENT);
+
+        // reset: records are read only, a write to element 0 resets all
+        // at the next slot, which counts again from its own execution
+    HOSTSIMTEST_CHECK(tsstesthookwrite(1)==COMMONPARAMDB_CH_NO_WRITE_ACCESS);
+    HOSTSIMTEST_CHECK(!bTaskSchedRTStatsReset);
+    HOSTSIMTEST_CHECK(tsstesthookwrite(0)==COMMONPARAMDB_CH_OK);
+    HOSTSIMTEST_CHECK(bTaskSchedRTStatsReset);
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsGet(1, &sRec) && sRec.ulCalls==TSSTEST_TICKS+1);
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(1)==0);
+    HOSTSIMTEST_CHECK(!bTaskSchedRTStatsReset);
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsGet(1, &sRec));
+    HOSTSIMTEST_CHECK(sRec.ulCalls==1 && tsstesthisto(&sRec)==1 && sRec.ulOverruns==0);
+    HOSTSIMTEST_CHECK(sRec.uwMinTime==sRec.uwMaxTime && sRec.uwMaxTime==TSSTEST_BASE_TIME);
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsGet(0, &sRec) && sRec.ulCalls==1 && sRec.uwMaxTime==TSSTEST_FIXED_TIME);
+
+        // overrun charged to the task crossing max slot time only, trace
+        // keeps running while booting
+    uwTssTestCost=TSSTEST_OVERRUN_TIME;
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(TSSTEST_OVERRUNS)==0);
+    uwTssTestCost=0;
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsGet(0, &sFixed) && sFixed.ulOverruns==0);
+    HOSTSIMTEST_CHECK(TaskSched_RTStatsGet(1, &sVar) && sVar.ulOverruns==TSSTEST_OVERRUNS);
+    HOSTSIMTEST_CHECK(sVar.uwMaxTime==TSSTEST_OVERRUN_TIME);
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.uwReason==TASKSCHEDULER_RT_TRACE_RUNNING);
+
+        // trace of the last tick: run mask, enter/exit from slot start
+    HOSTSIMTEST_CHECK(TaskSched_RTTraceGet(0, &sTick));
+    HOSTSIMTEST_CHECK(sTick.ulRunMask==0x3ul && sTick.uwTick==uwTaskSchedFreeTimer);
+    HOSTSIMTEST_CHECK(sTick.uwEnter[0]==0 && sTick.uwExit[0]==TSSTEST_FIXED_TIME);
+    HOSTSIMTEST_CHECK(sTick.uwEnter[1]==TSSTEST_FIXED_TIME && sTick.uwExit[1]==TSSTEST_FIXED_TIME+TSSTEST_OVERRUN_TIME);
+    HOSTSIMTEST_CHECK(sTick.uwTime==TSSTEST_FIXED_TIME+TSSTEST_OVERRUN_TIME);
+    HOSTSIMTEST_CHECK(!TaskSched_RTTraceGet(TASKSCHEDULER_RT_TRACE_TICKS, &sTick));
+
+        // running: slot over peak time freezes the trace on the overtime
+        // tick, later ticks are not recorded
+    ulSystemStatus=0ul;
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(TASKSCHEDULER_RT_TRACE_TICKS)==0);
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.uwReason==TASKSCHEDULER_RT_TRACE_RUNNING);
+    ulFreezeCnt=sTaskSchedRTTrace.ulFreezeCnt;
+    uwTssTestCost=TSSTEST_PEAK_TIME;
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(1)==1);
+    uwTssTestCost=0;
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.uwReason==TASKSCHEDULER_RT_TRACE_SYSOVERTIME);
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.ulFreezeCnt==ulFreezeCnt+1 && sTaskSchedRTTrace.uwTasks==2);
+    ulHead=sTaskSchedRTTrace.ulHead;
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(3*TASKSCHEDULER_RT_TRACE_TICKS)==0);
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.ulHead==ulHead);
+    HOSTSIMTEST_CHECK(TaskSched_RTTraceGet(0, &sTick));
+    HOSTSIMTEST_CHECK(sTick.uwTime==TSSTEST_FIXED_TIME+TSSTEST_PEAK_TIME && sTick.uwExit[1]==sTick.uwTime);
+    HOSTSIMTEST_CHECK(TaskSched_RTTraceGet(1, &sTick) && sTick.uwTime==TSSTEST_FIXED_TIME+TSSTEST_BASE_TIME);
+
+        // first event wins until rearmed, then recording restarts
+    uwTssTestCost=TSSTEST_PEAK_TIME;
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(1)==1);
+    uwTssTestCost=0;
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.ulFreezeCnt==ulFreezeCnt+1);
+    TaskSched_RTTraceRearm();
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.uwReason==TASKSCHEDULER_RT_TRACE_RUNNING && sTaskSchedRTTrace.ulHead==0);
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(2)==0);
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.ulHead==2);
+    HOSTSIMTEST_CHECK(TaskSched_RTTraceGet(1, &sTick) && !TaskSched_RTTraceGet(2, &sTick));
+
+        // slots over max time but under peak: freeze once the slow
+        // overtime counter passes the allowed slots
+    uwTssTestCost=TSSTEST_OVERRUN_TIME;
+    for(ct=0;ct<=TASKSCHEDULER_RT_MAX_ALLOWED_SLOTS;ct++)
+        HOSTSIMTEST_CHECK(HostSim_RunTicks(1)==0);
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.uwReason==TASKSCHEDULER_RT_TRACE_RUNNING);
+    HOSTSIMTEST_CHECK(HostSim_RunTicks(1)==0);
+    uwTssTestCost=0;
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.uwReason==TASKSCHEDULER_RT_TRACE_SYSOVERTIME);
+    HOSTSIMTEST_CHECK(sTaskSchedRTTrace.ulFreezeCnt==ulFreezeCnt+2);
+
+    printf("TaskSchedStatsTest: %lu overruns, trace frozen %lu times\n",
+        (unsigned long)sVar.ulOverruns, (unsigned long)(sTaskSchedRTTrace.ulFreezeCnt-ulFreezeCnt));
+
+    return HOSTSIMTEST_RESULT("TaskSchedStatsTest");
+}
@@ -0,0 +1,380 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : UmConvTest.c                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : UM conversion: fused descriptors against the legacy per    */
+/*               selection formulas over every accepted range, bulk convert */
+/*                                                                          */
+/****************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include "common\CommonDefines.h"
+#include "common\UnitMeasureConversion.h"
+#include "HostSim.h"
+#include "HostSimTest.h"
+
+//***************************************************************************
+// Configuration
+
+    // ratio sweep: binary exponents and mantissas per exponent, both signs
+#define UMCONVTEST_EXP_MIN              -48
+#define UMCONVTEST_EXP_MAX              48
+#define UMCONVTEST_MANTISSAS            16
+    // random input values per accepted ratio, after the edge values
+#define UMCONVTEST_VALUES               2000
+    // bulk convert: random arrays, up to the max length
+#define UMCONVTEST_BULK_ARRAYS          200
+#define UMCONVTEST_BULK_MAXLEN          300
+    // guard elements past the end of the bulk destination
+#define UMCONVTEST_BULK_GUARD           4
+
+//***************************************************************************
+// Structures
+
+    // legacy conversion data structure: shift and function selector
+    // resolved at every call
+typedef struct _umconvtest_legacy
+{
+    SLONG slMult;
+    SWORD swShift;
+    UWORD uwSelection;
+} UMCONVTEST_LEGACY;
+
+//***************************************************************************
+// Locals
+
+static ULONG ulUmConvTestSeed=0x5EED1234ul;
+static ULONG ulUmConvTestSel32to32[7];
+static ULONG ulUmConvTestSel16to32[7];
+static ULONG ulUmConvTestSel32to16[7];
+static SLONG slUmConvTestSrc[UMCONVTEST_BULK_MAXLEN];
+static SWORD swUmConvTestSrc[UMCONVTEST_BULK_MAXLEN];
+static SLONG slUmConvTestDst[UMCONVTEST_BULK_MAXLEN+UMCONVTEST_BULK_GUARD];
+static SWORD swUmConvTestDst[UMCONVTEST_BULK_MAXLEN+UMCONVTEST_BULK_GUARD];
+
+    // edge input values
+static const SLONG slUmConvTestEdge[]={0, 1, -1, 2, -2, 32767, -32768, 65535, -65536,
+    0x7FFFFFFFl, -0x7FFFFFFFl-1, 0x40000000l, -0x40000000l, 0x00FFFFFFl, -0x01000000l};
+
+//***************************************************************************
+// Random value
+
+static ULONG umconvtestrand(void)
+{
+    ulUmConvTestSeed=ulUmConvTestSeed*1664525ul+1013904223ul;
+
+    return ulUmConvTestSeed;
+}
+
+//***************************************************************************
+// Random 32bit value, random magnitude
+
+static SLONG umconvtestrand32(void)
+{
+    ULONG ulValue=umconvtestrand();
+
+    return (SLONG)ulValue>>(umconvtestrand()>>27);
+}
+
+//***************************************************************************
+// Legacy selection, copy of the original ShiftSelection()
+
+static BOOL umconvtestselection(SWORD * pswShift, UWORD * puwSelection)
+{
+    if(*pswShift>-32 && *pswShift<=-16)
+    {
+        *puwSelection=1;
+        *pswShift=-*pswShift-16;
+    }
+    else if(*pswShift>-16 && *pswShift<=0)
+    {
+        *puwSelection=2;
+        *pswShift=-*pswShift;
+    }
+    else if(*pswShift>0 && *pswShift<8)
+    {
+        *puwSelection=3;
+        *pswShift=*pswShift;
+    }
+    else if(*pswShift>=8 && *pswShift<16)
+    {
+        *puwSelection=4;
+        *pswShift=*pswShift-8;
+    }
+    else if(*pswShift>=16 && *pswShift<24)
+    {
+        *puwSelection=5;
+        *pswShift=*pswShift-16;
+    }
+    else if(*pswShift>=24 && *pswShift<32)
+    {
+        *puwSelection=6;
+        *pswShift=*pswShift-24;
+    }
+    else
+        return TRUE;
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Legacy initializations, copy of the original UmConv_Init_*()
+
+static BOOL umconvtestinit32to32(UMCONVTEST_LEGACY * psConv, DOUBL dbRatio)
+{
+    if(UmConv_MultShiftCalc(dbRatio, &psConv->slMult, &psConv->swShift, 32))
+        return TRUE;
+
+    return umconvtestselection(&psConv->swShift, &psConv->uwSelection);
+}
+
+static BOOL umconvtestinit16to32(UMCONVTEST_LEGACY * psConv, DOUBL dbRatio)
+{
+    if(UmConv_MultShiftCalc(dbRatio, &psConv->slMult, &psConv->swShift, 32))
+        return TRUE;
+
+    psConv->swShift-=16;
+
+    if(umconvtestselection(&psConv->swShift, &psConv->uwSelection))
+        return TRUE;
+
+    return psConv->uwSelection>4;
+}
+
+static BOOL umconvtestinit32to16(UMCONVTEST_LEGACY * psConv, DOUBL dbRatio)
+{
+    SLONG slMult;
+
+    if(UmConv_MultShiftCalc(dbRatio, &slMult, &psConv->swShift, 16))
+        return TRUE;
+
+    psConv->slMult=(SWORD)(slMult&0xffff);
+
+    if(umconvtestselection(&psConv->swShift, &psConv->uwSelection))
+        return TRUE;
+
+    return psConv->uwSelection>4;
+}
+
+//***************************************************************************
+// Legacy 32 to 32: the Zynq port kept the C167 MAC routine commented out
+// with an empty body, this is its per selection scaling of the 64bit
+// product, saturated; the CORND rounding of selections 1 and 2 is not
+// reproduced, the fused conversion truncates as the other two do
+
+static SLONG umconvtestlegacy32to32(const UMCONVTEST_LEGACY * psConv, SLONG slValue)
+{
+    SLLNG sllProd=(SLLNG)slValue*psConv->slMult;
+    SLLNG sllRes;
+
+    switch(psConv->uwSelection)
+    {
+        case 1:  sllRes=(sllProd>>48)>>psConv->swShift; break;
+        case 2:  sllRes=(sllProd>>32)>>psConv->swShift; break;
+        case 3:  sllRes=sllProd>>(32-psConv->swShift); break;
+        case 4:  sllRes=sllProd>>(24-psConv->swShift); break;
+        case 5:  sllRes=sllProd>>(16-psConv->swShift); break;
+        default: sllRes=sllProd>>(8-psConv->swShift); break;
+    }
+
+    if(sllRes>SLONG_MAX_VALUE)
+        return SLONG_MAX_VALUE;
+    if(sllRes<SLONG_MIN_VALUE)
+        return SLONG_MIN_VALUE;
+    return (SLONG)sllRes;
+}
+
+//***************************************************************************
+// Legacy 16 to 32, copy of the original UmConv_Convert_16to32()
+
+static SLONG umconvtestlegacy16to32(const UMCONVTEST_LEGACY * psConv, SWORD swValue)
+{
+    SWORD nshift;
+
+    if(psConv->uwSelection==1)
+        nshift=-psConv->swShift+16;
+    else if(psConv->uwSelection==2)
+        nshift=-psConv->swShift;
+    else if(psConv->uwSelection==3)
+        nshift=psConv->swShift;
+    else
+        nshift=psConv->swShift-8;
+
+    return (SLONG)(((SLLNG)swValue*psConv->slMult)>>(16-nshift));
+}
+
+//***************************************************************************
+// Legacy 32 to 16, copy of the original UmConv_Convert_32to16(); the
+// negative shift count of selections 3 and 4 stands for the left shift
+
+static SWORD umconvtestlegacy32to16(const UMCONVTEST_LEGACY * psConv, SLONG slValue)
+{
+    SWORD nshift;
+    SLONG slShifted;
+
+    if(psConv->uwSelection==1)
+        nshift=psConv->swShift+16;
+    else if(psConv->uwSelection==2)
+        nshift=psConv->swShift;
+    else if(psConv->uwSelection==3)
+        nshift=-psConv->swShift;
+    else
+        nshift=-psConv->swShift-8;
+
+    slShifted=nshift>=0 ? slValue>>nshift : (SLONG)((ULONG)slValue<<-nshift);
+
+    return (SWORD)(((SLLNG)slShifted*(SWORD)psConv->slMult)>>16);
+}
+
+//***************************************************************************
+// One ratio, all three conversions: same acceptance as the legacy
+// initialization, same output on edge and random values; return no. of
+// mismatches
+
+static ULONG umconvtestratio(DOUBL dbRatio)
+{
+    UMCONV_CONV32TO32 s32to32;
+    UMCONV_CONV16TO32 s16to32;
+    UMCONV_CONV32TO16 s32to16;
+    UMCONVTEST_LEGACY sLeg32to32, sLeg16to32, sLeg32to16;
+    BOOL bErr32to32, bErr16to32, bErr32to16;
+    ULONG ulMismatch=0, i, ulNum;
+    SLONG slValue;
+
+    bErr32to32=UmConv_Init_32to32(&s32to32, dbRatio);
+    bErr16to32=UmConv_Init_16to32(&s16to32, dbRatio);
+    bErr32to16=UmConv_Init_32to16(&s32to16, dbRatio);
+    ulMismatch+=(bErr32to32!=umconvtestinit32to32(&sLeg32to32, dbRatio));
+    ulMismatch+=(bErr16to32!=umconvtestinit16to32(&sLeg16to32, dbRatio));
+    ulMismatch+=(bErr32to16!=umconvtestinit32to16(&sLeg32to16, dbRatio));
+
+    if(!bErr32to32)
+        ulUmConvTestSel32to32[sLeg32to32.uwSelection]++;
+    if(!bErr16to32)
+        ulUmConvTestSel16to32[sLeg16to32.uwSelection]++;
+    if(!bErr32to16)
+        ulUmConvTestSel32to16[sLeg32to16.uwSelection]++;
+
+    ulNum=sizeof(slUmConvTestEdge)/sizeof(slUmConvTestEdge[0]);
+    for(i=0;i<ulNum+UMCONVTEST_VALUES;i++)
+    {
+        slValue=i<ulNum ? slUmConvTestEdge[i] : umconvtestrand32();
+
+        if(!bErr32to32)
+            ulMismatch+=(UMCONV_CONVERT_32TO32(&s32to32, slValue)!=umconvtestlegacy32to32(&sLeg32to32, slValue));
+        if(!bErr16to32)
+            ulMismatch+=(UMCONV_CONVERT_16TO32(&s16to32, (SWORD)slValue)!=umconvtestlegacy16to32(&sLeg16to32, (SWORD)slValue));
+        if(!bErr32to16)
+            ulMismatch+=(UMCONV_CONVERT_32TO16(&s32to16, slValue)!=umconvtestlegacy32to16(&sLeg32to16, slValue));
+    }
+
+    return ulMismatch;
+}
+
+//***************************************************************************
+// Bulk convert of random arrays against the single conversion, nothing
+// written past the end; return no. of mismatches
+
+static ULONG umconvtestbulk(void)
+{
+    UMCONV_CONV32TO32 s32to32;
+    UMCONV_CONV16TO32 s16to32;
+    UMCONV_CONV32TO16 s32to16;
+    ULONG ulMismatch=0, ulArray;
+    UWORD uwLen, i;
+    DOUBL dbRatio;
+
+    for(ulArray=0;ulArray<UMCONVTEST_BULK_ARRAYS;ulArray++)
+    {
+        do
+        {
+            dbRatio=ldexp(1.0+(DOUBL)(umconvtestrand()>>8)/16777216.0, (int)(umconvtestrand()>>28)-8);
+            if(umconvtestrand()&0x80000000ul)
+                dbRatio=-dbRatio;
+        }
+        while(UmConv_Init_32to32(&s32to32, dbRatio) || UmConv_Init_16to32_Rev(&s16to32, &s32to16, dbRatio));
+
+        uwLen=ulArray<8 ? (UWORD)ulArray : (UWORD)(umconvtestrand()%(UMCONVTEST_BULK_MAXLEN+1));
+        for(i=0;i<uwLen;i++)
+        {
+            slUmConvTestSrc[i]=umconvtestrand32();
+            swUmConvTestSrc[i]=(SWORD)umconvtestrand();
+        }
+
+        memset(slUmConvTestDst, 0x5A, sizeof(slUmConvTestDst));
+        UmConv_Convert_32to32_Bulk(&s32to32, slUmConvTestDst, slUmConvTestSrc, uwLen);
+        for(i=0;i<uwLen;i++)
+            ulMismatch+=(slUmConvTestDst[i]!=UMCONV_CONVERT_32TO32(&s32to32, slUmConvTestSrc[i]));
+        for(i=0;i<UMCONVTEST_BULK_GUARD;i++)
+            ulMismatch+=(slUmConvTestDst[uwLen+i]!=0x5A5A5A5Al);
+
+        memset(slUmConvTestDst, 0x5A, sizeof(slUmConvTestDst));
+        UmConv_Convert_16to32_Bulk(&s16to32, slUmConvTestDst, swUmConvTestSrc, uwLen);
+        for(i=0;i<uwLen;i++)
+            ulMismatch+=(slUmConvTestDst[i]!=UMCONV_CONVERT_16TO32(&s16to32, swUmConvTestSrc[i]));
+        for(i=0;i<UMCONVTEST_BULK_GUARD;i++)
+            ulMismatch+=(slUmConvTestDst[uwLen+i]!=0x5A5A5A5Al);
+
+        memset(swUmConvTestDst, 0x5A, sizeof(swUmConvTestDst));
+        UmConv_Convert_32to16_Bulk(&s32to16, swUmConvTestDst, slUmConvTestSrc, uwLen);
+        for(i=0;i<uwLen;i++)
+            ulMismatch+=(swUmConvTestDst[i]!=UMCONV_CONVERT_32TO16(&s32to16, slUmConvTestSrc[i]));
+        for(i=0;i<UMCONVTEST_BULK_GUARD;i++)
+            ulMismatch+=(swUmConvTestDst[uwLen+i]!=0x5A5A);
+    }
+
+    return ulMismatch;
+}
+
+//***************************************************************************
+// Main
+
+int main(void)
+{
+    ULONG ulMismatch=0, ulRatios=0;
+    SWORD swExp, swSel;
+    UWORD uwMant;
+    DOUBL dbRatio;
+    BOOL bCovered=TRUE;
+
+    HostSim_Init(HOSTSIM_CLOCK_HOST);
+
+        // ratio sweep, the mantissas include the exact powers of two and
+        // the ones just below the next
+    for(swExp=UMCONVTEST_EXP_MIN;swExp<=UMCONVTEST_EXP_MAX;swExp++)
+        for(uwMant=0;uwMant<=UMCONVTEST_MANTISSAS;uwMant++)
+        {
+            dbRatio=uwMant<UMCONVTEST_MANTISSAS ?
+                ldexp(1.0+(DOUBL)uwMant/UMCONVTEST_MANTISSAS, swExp) :
+                ldexp(2.0-ldexp(1.0, -40), swExp);
+            ulMismatch+=umconvtestratio(dbRatio);
+            ulMismatch+=umconvtestratio(-dbRatio);
+            ulRatios+=2;
+        }
+    HOSTSIMTEST_CHECK(ulMismatch==0);
+
+        // every selection the legacy routines accepted was exercised
+    for(swSel=1;swSel<=6;swSel++)
+    {
+        bCovered=ulUmConvTestSel32to32[swSel]!=0 && bCovered;
+        if(swSel<=4)
+            bCovered=ulUmConvTestSel16to32[swSel]!=0 && ulUmConvTestSel32to16[swSel]!=0 && bCovered;
+        printf("UmConvTest: selection %d, accepted ratios 32to32 %lu 16to32 %lu 32to16 %lu\n", (int)swSel,
+            (unsigned long)ulUmConvTestSel32to32[swSel], (unsigned long)ulUmConvTestSel16to32[swSel],
+            (unsigned long)ulUmConvTestSel32to16[swSel]);
+    }
+    HOSTSIMTEST_CHECK(bCovered);
+
+        // bulk convert
+    HOSTSIMTEST_CHECK(umconvtestbulk()==0);
+
+    printf("UmConvTest: %lu ratios\n", (unsigned long)ulRatios);
+
+    return HOSTSIMTEST_RESULT("UmConvTest");
+}
@@ -27,8 +27,10 @@
 
 #include "common\CommonDefines.h"
 #include "common\MathFunctions.h"
+#include "common\MathBatch.h"
 #include "common\Int64Functions.h"
 #include "common\DspFunctions.h"
+#include "common\LutInterp.h"
 
 #include "AlPlcRuntime2\AlPlcAreaDef.h"
 #include "AlPlcRuntime2\AlPlcRuntimeCore.h"
@@ -535,6 +537,8 @@ PLC_ATTR_PLCIEC_FCNREC plcEmbeddedFunctions[] =
     {"Sin16",                       (uint32_t)&Sin16},
     {"Cos16",                       (uint32_t)&Cos16},
     {"ATan16",                      (uint32_t)&ATan16},
+    {"Sin16Cos16Batch",             (uint32_t)&Sin16Cos16Batch},
+    {"ATan16Batch",                 (uint32_t)&ATan16Batch},
     {"_do_sin",                     (uint32_t)&AlPlcMath_Sin},
     {"_do_cos",                     (uint32_t)&AlPlcMath_Cos},
     {"_do_tan",                     (uint32_t)&AlPlcMath_Tan},
@@ -626,6 +630,9 @@ PLC_ATTR_PLCIEC_FCNREC plcEmbeddedFunctions[] =
     {"sysILoopDSPHalt",             (uint32_t)&Mh_PlcDSPHalt},
     {"sysILoopDSPResume",           (uint32_t)&Mh_PlcDSPResume},
     {"RootOfSquareSum16",           (uint32_t)&RootOfSquareSum16},
+    {"RootOfSquareSum16Batch",      (uint32_t)&RootOfSquareSum16Batch},
+    {"ClarkeBatch16",               (uint32_t)&ClarkeBatch16},
+    {"ParkBatch16",                 (uint32_t)&ParkBatch16},
 
 #if CFG_ETHPMC
     {"sysEpmcMasterParams",         (uint32_t)&EpmcCM_MasterParams},
@@ -635,6 +642,9 @@ PLC_ATTR_PLCIEC_FCNREC plcEmbeddedFunctions[] =
     {"mInterp1D",                   (uint32_t)&_interp1d},
     {"mInterp2D",                   (uint32_t)&_interp2d},
     {"mInterp3D",                   (uint32_t)&_interp3d},
+    {"mLutHermite1D",               (uint32_t)&Lut_PlcHermite1D},
+    {"mLutHermite2D",               (uint32_t)&Lut_PlcHermite2D},
+    {"mLutInterpBrk1D",             (uint32_t)&Lut_PlcInterpBrk1D},
 #endif
 
 #if CFG_ENC_NIKON
@@ -654,6 +664,7 @@ PLC_ATTR_PLCIEC_FCNREC plcEmbeddedFunctions[] =
 //    {"SetBreakpoint",   (uint32_t)&SetBreakpoint},
     {"sysSSComputeGains",           (uint32_t)&PlcCtrLpGainsCompute},
     {"sysSSSelectGains",            (uint32_t)&PlcCtrLpGainsSelect},
+    {"sysSSSelectFloatLoop",        (uint32_t)&PlcCtrLpSelectFloat},
     {"sysHwProductRev",             (uint32_t)&PlcHwProductRev},
 };
 
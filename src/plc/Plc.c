@@ -63,6 +63,18 @@
 
 #define PLCOK                                       // when the PLC do not work well please disable it
 
+//****************************************************************************
+// PLC TEMPORARY FIX - save & restore R11 around calls to PLC code, not
+// needed (and not possible) on host simulation
+
+#ifndef _HW_HOSTSIM
+#define PLC_SAVE_R11()                  asm("sub sp, sp, #8"); asm("str r11, [sp]")
+#define PLC_RESTORE_R11()               asm("ldr r11, [sp]"); asm("add sp, sp, #8")
+#else
+#define PLC_SAVE_R11()
+#define PLC_RESTORE_R11()
+#endif
+
 //****************************************************************************
 // Globals
 
@@ -603,13 +615,11 @@ BOOL PlcImageBackgroundIn(void)
     {
         if(*puwBackgroundImageStatus) {
 /******** PLC TEMPORARY FIX - SAVE & RESTORE R11 ***************/
-            asm("sub sp, sp, #8");
-            asm("str r11, [sp]");
+            PLC_SAVE_R11();
 
             (*sPlcTaskBackground.pfInput)(*puwBackgroundImageStatus++);
 
-            asm("ldr r11, [sp]");
-            asm("add sp, sp, #8");
+            PLC_RESTORE_R11();
         }
         else
             bSysStatPlcImgBackgroundIn=FALSE;
@@ -621,15 +631,13 @@ BOOL PlcImageBackgroundIn(void)
     else
     {
 /******** PLC TEMPORARY FIX - SAVE & RESTORE R11 ***************/
-        asm("sub sp, sp, #8");
-        asm("str r11, [sp]");
+        PLC_SAVE_R11();
         if((*sPlcTaskBackground.pfInput)(uwBackgroundInitCnt)>0)
         {
             *puwBackgroundImageStatus++=uwBackgroundInitCnt;
             *puwBackgroundImageStatus=0;
         }
-        asm("ldr r11, [sp]");
-        asm("add sp, sp, #8");
+        PLC_RESTORE_R11();
 
         uwBackgroundInitCnt++;
 
@@ -656,11 +664,9 @@ BOOL PlcImageBackgroundOut(void)
     {
         if(*puwBackgroundImageStatus) {		
 /******** PLC TEMPORARY FIX - SAVE & RESTORE R11 ***************/
-			asm("sub sp, sp, #8");
-			asm("str r11, [sp]");
+			PLC_SAVE_R11();
             (*sPlcTaskBackground.pfOutput)(*puwBackgroundImageStatus++);
-            asm("ldr r11, [sp]");
-            asm("add sp, sp, #8");
+            PLC_RESTORE_R11();
 		}
         else
             bSysStatPlcImgBackgroundOut=FALSE;
@@ -672,15 +678,13 @@ BOOL PlcImageBackgroundOut(void)
     else
     {
 /******** PLC TEMPORARY FIX - SAVE & RESTORE R11 ***************/
-		asm("sub sp, sp, #8");
-		asm("str r11, [sp]");
+		PLC_SAVE_R11();
         if((*sPlcTaskBackground.pfOutput)(uwBackgroundInitCnt)>0)
         {
             *puwBackgroundImageStatus++=uwBackgroundInitCnt;
             *puwBackgroundImageStatus=0;
         }
-        asm("ldr r11, [sp]");
-        asm("add sp, sp, #8");
+        PLC_RESTORE_R11();
 
         uwBackgroundInitCnt++;
 
@@ -709,12 +713,10 @@ void PlcSlowTaskMgrIn(void)
         uwSlowTaskCounter=0;
 
 /******** PLC TEMPORARY FIX - SAVE & RESTORE R11 ***************/
-        asm("sub sp, sp, #8");
-        asm("str r11, [sp]");
+        PLC_SAVE_R11();
             // image copy in
         (*sPlcTaskSlow.pfInput)(0);
-        asm("ldr r11, [sp]");
-        asm("add sp, sp, #8");
+        PLC_RESTORE_R11();
 
             // trigger the irq for the slow task
 #ifdef _INFINEON_
@@ -815,11 +817,9 @@ void PlcSlowTaskMgrOut(void)
         if(bSlowTaskCopyOutImmediate || uwSlowTaskCounter>=(uwSlowTaskCntReload-1))
         {
 /******** PLC TEMPORARY FIX - SAVE & RESTORE R11 ***************/
-			asm("sub sp, sp, #8");
-			asm("str r11, [sp]");
+			PLC_SAVE_R11();
         	(*sPlcTaskSlow.pfOutput)(0);
-            asm("ldr r11, [sp]");
-            asm("add sp, sp, #8");
+            PLC_RESTORE_R11();
 
                 // disable mgr out and enable mgr in
             bSysStatPlcImgSlowOut=FALSE;
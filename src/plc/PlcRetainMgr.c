@@ -14,10 +14,18 @@
 #include "common\CommonUtility.h"
 #include "PlcRetainMgr.h"
 #include "common\BlockStorage.h"
+#include "common\FlashQueue.h"
 #include "system\SysLogManagement.h"
 #include "system\SysAppDataCodes.h"
 #include "assert.h"
 
+//***************************************************************************
+// Defines
+
+    // blocks indexed in one clock record, if more the index falls back to
+    // scanning the record
+#define PLCRETAINMGR_BLKINDEX_ENTRIES               8
+
 //***************************************************************************
 // Globals
 
@@ -28,19 +36,15 @@ PLCRETAINMGR_DATA psPlcRetMgrData;
 
 BOOL PlcRetMgr_RestoreRetainData(HPVOID hpvBuf, SWORD swSize)
 {
-    HPVOID blkptr;
-    ULONG storagesize;
-    SWORD blkcode;
+    BLKSTOR_INDEX sIndex;
+    BLKSTOR_INDEX_ENTRY sEntries[PLCRETAINMGR_BLKINDEX_ENTRIES];
 
-        // then seek managed blocks
-    storagesize=(ULONG)swSize;
-	while((blkcode=blkstor_enumvalid(&hpvBuf, &storagesize, &blkptr)) != BLKSTOR_ERR_NOTFOUND)
-        switch(blkcode)
-        {
-            case DATACODE_SYSLOG_PLC_RETAIN:
-    		    blkstor_getdata(blkptr,0,DATACODE_SYSLOG_PLC_RETAIN,&psPlcRetMgrData,sizeof(psPlcRetMgrData));
-                break;
-        }
+        // then seek managed blocks, validated once; the clock record could
+        // be in flash, read with the queue held off
+    FlashQ_ReadLock();
+    blkstor_index_build(&sIndex, hpvBuf, (ULONG)swSize, sEntries, PLCRETAINMGR_BLKINDEX_ENTRIES);
+    blkstor_index_getdata(&sIndex,DATACODE_SYSLOG_PLC_RETAIN,&psPlcRetMgrData,sizeof(psPlcRetMgrData));
+    FlashQ_ReadUnlock();
 
     return TRUE;
 }
@@ -184,8 +184,8 @@ BOOL SoftScopeInit(UWORD t)
         // Init runtime
     ALSSCINIT();
 
-        // add slow task for management
-    assert(TaskSched_AddBackgroundTask(&ALSSCMANAGE));
+        // add slow task for management, high priority as it serves uploads
+    assert(TaskSched_AddBackgroundTaskPrio(&ALSSCMANAGE, TASKSCHEDULER_BKG_PRIO_HIGH, 0));
 
         // add realtime task for acquire process
     assert(TaskSched_AddRTTask((BOOL (*)(void))&ALSSCACQUIRE, TASKSCHEDULER_FLAG_NONE, \
@@ -42,6 +42,11 @@ volatile UWORD uwOsFreeRunTimer1kHz;
 volatile ULONG ulOsTimer1Hz;            // externally initialized as used
                                         // as life time clock
 
+#ifndef _INFINEON_
+    // FreeRTOS port IRQ nesting counter, IRQs are re-enabled in handlers
+extern volatile ULONG ulPortInterruptNesting;
+#endif
+
 #if (OS_MEASURESTACKSIZE)
     // Stack measurement status
 UWORD uwOsSysStackFree;
@@ -240,7 +245,7 @@ void Os_Sleep(UWORD uwMilliSeconds)
     else
         FORCETASKSWITCHING();
 #else
-    vTaskDelay(0);
+    vTaskDelay((TickType_t)(((ULONG)uwMilliSeconds*configTICK_RATE_HZ)/1000));
 #endif
 }
 
@@ -619,6 +624,26 @@ BOOL Os_IsInBackground(void)
 #endif
 }
 
+//***************************************************************************
+// Interrupt nesting level; on Infineon only ISR or not is told
+
+UWORD Os_IsrNesting(void)
+{
+#ifdef _INFINEON_
+    return ISINTOISR() ? 1 : 0;
+#else
+    return (UWORD)ulPortInterruptNesting;
+#endif
+}
+
+//***************************************************************************
+// TRUE when the scheduler is started, then tasks can sleep
+
+BOOL Os_IsSchedulerRunning(void)
+{
+    return xTaskGetSchedulerState()==taskSCHEDULER_RUNNING;
+}
+
 #ifdef _INFINEON_
 //***************************************************************************
 // Atomic test and set new task status, return TRUE if test was successful
@@ -211,4 +211,10 @@ void Os_EndCriticalSection(UWORD);
 // Check current runnning level
 BOOL Os_IsInBackground(void);
 
+// Interrupt nesting level of the caller, 0 from tasks
+UWORD Os_IsrNesting(void);
+
+// TRUE when the scheduler is started, then tasks can sleep
+BOOL Os_IsSchedulerRunning(void);
+
 #endif
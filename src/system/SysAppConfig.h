@@ -36,6 +36,20 @@
 // Reserved static user stack for main task
 #define OS_MAINUSRSTATICSTACK      (configMINIMAL_STACK_SIZE*2)
 
+//***************************************************************************
+// AMP: second core runs its own background scheduler, fed by the first
+// core through mailboxes in OCM; only tasks explicitly registered for it
+// move there (TaskSched_AddBackgroundTaskCpu1).
+// The flash queue device server runs there (common\FlashQueue.c), its
+// clients stay on the first core. SysLog, parameter storage and drive
+// background tasks use OS services or first core irq disable for
+// atomicity, so each one moves only once ported to mailboxes.
+// Overridable from the build (host two core tests)
+
+#ifndef CFG_AMP
+#define CFG_AMP                     0
+#endif
+
 //***************************************************************************
 // Power Fail
 
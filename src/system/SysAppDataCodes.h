@@ -25,6 +25,9 @@
 #define DATACODE_SYSLOG_ALARM_V1_DATA               7
 #define DATACODE_SYSLOG_ALARM_DATA                  8
 #define DATACODE_SYSLOG_PLC_RETAIN                  9
+#define DATACODE_SYSLOG_RT_TRACE                    10
+#define DATACODE_SYSLOG_RT_TRACE_TICK               11
+#define DATACODE_SYSLOG_SECTOR                      12
 
 //****************************************************************************
 // PARAM mgm
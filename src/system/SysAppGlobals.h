@@ -110,7 +110,11 @@ EXTERN UWORD sdata uwSysFieldbusSampleRT;
 #define uwSysTimers100ns                TTC_TMR
 // #define uwSysTimers125us                uwXTTCTimersTask
 #define uwSysTimers125us                uwTaskSchedFreeTimer
+#ifdef _HW_HOSTSIM
+#define uwSysTimers1ms                  HostSim_Timers1ms()
+#else
 #define uwSysTimers1ms                  uwXTTCTimers1ms
+#endif
 //#define uwSysTimers1ms                  uwOsFreeRunTimer1kHz
 
 #define ulSysAbsoluteTimer1s            ulOsTimer1Hz
@@ -20,6 +20,7 @@
 #include "system\SysAppGlobals.h"
 #include "system\SystemAlarms.h"
 #include "system\SysLogData.h"
+#include "system\SysLogManagement.h"
 #include "core\SystemReset.h"
 #include "drive\HardwareConfig.h"
 #include "drive\UserIO.h"
@@ -294,6 +295,12 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
         // Local Avg RealTime task exec time
     {0x021D, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD , 0, 1,
             WRDENY_DEFAULT, (HPVOID)&uwTaskSchedRTLocalAvgTime, NULL},
+        // RealTime task and rate group statistics, write to reset
+    {0x021E, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_HOOK, COMMONPARAMDB_TYPE_UWORD , 0, TASKSCHEDULER_RT_MAX_ENTRIES+TASKSCHEDULER_RATE_GROUPS+1,
+            WRDENY_NONE, NULL, &TaskSched_RTStatsHook},
+        // RealTime trace dump (block storage records), write to rearm
+    {0x021F, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_HOOK, COMMONPARAMDB_TYPE_UWORD , 0, SYSLOGMGM_RTTRACE_DUMPSIZE/sizeof(UWORD),
+            WRDENY_NONE, NULL, &SysLogMgm_RTTraceHook},
 
         // System active alarms
     {0x0220, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG , 0, 1,
@@ -316,6 +323,12 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
         // System last key reset
     {0x0226, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD , 0, 1,
             WRDENY_DEFAULT, &uwSysResParam0, NULL},
+        // Background loop max time per core (* 125usec)
+    {0x0227, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD , 0, TASKSCHEDULER_BKG_CPUS,
+            WRDENY_DEFAULT, (HPVOID)&uwTaskSchedBkgLoopMaxTime[0], NULL},
+        // Background task statistics, write to reset
+    {0x0228, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_HOOK, COMMONPARAMDB_TYPE_UWORD , 0, TASKSCHEDULER_BACKGROUND_MAX_ENTRIES+1,
+            WRDENY_NONE, NULL, &TaskSched_BkgStatsHook},
 
     {0x0230, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_RESETREQ, COMMONPARAMDB_TYPE_SBYTE , 0, 1, WRDENY_PARAMSAVE, &sHwConfParams.ubSysMode, NULL},
 
@@ -378,28 +391,28 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x080D, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_RESETREQ, COMMONPARAMDB_TYPE_UBYTE,  0,/*7*/ 1, WRDENY_PARAMSAVE, &sEm_EncMngrParam.flags.b.bDisAbsAfterValid, NULL}, // flags to enable restore of electronic plate at startup
 
         /* ===================== Main and feedback status ===================== */
-    {0x080E, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.ubStatus, NULL},
-    {0x080F, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.ubStatus, NULL},
+    {0x080E, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.ubStatus, NULL},
+    {0x080F, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.ubStatus, NULL},
 
         /* ===================== Main Encoders ===================== */
-    {0x0810, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.sqPostn.hi, NULL},          // Main sensor mechanical turns number
-    {0x0811, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.sqPostn.lo, NULL},          // Main sensor mechanical angle
-    {0x0812, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sqMechAbsPosOffset.hi, NULL},        // Main sensor mechanical Abs position offset HI
-    {0x0813, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sqMechAbsPosOffset.lo, NULL},        // Main sensor mechanical Abs position offset LO
-    {0x0814, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.slSpeed, NULL},             // Main sensor mechanical speed
-    {0x0815, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.slAccel, NULL},             // Main sensor mechanical acceleration
-    {0x0816, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.uwElecAngle, NULL},                  // Main sensor electrical angle
-    {0x0817, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_MainEnc, &MotCtrl_AbsolutePositionScaling}, // Main sensor position 32bit
+    {0x0810, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.sqPostn.hi, NULL},          // Main sensor mechanical turns number
+    {0x0811, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.sqPostn.lo, NULL},          // Main sensor mechanical angle
+    {0x0812, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sqMechAbsPosOffset.hi, NULL},        // Main sensor mechanical Abs position offset HI
+    {0x0813, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sqMechAbsPosOffset.lo, NULL},        // Main sensor mechanical Abs position offset LO
+    {0x0814, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.slSpeed, NULL},             // Main sensor mechanical speed
+    {0x0815, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.slAccel, NULL},             // Main sensor mechanical acceleration
+    {0x0816, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.uwElecAngle, NULL},                  // Main sensor electrical angle
+    {0x0817, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_MainEnc, &MotCtrl_AbsolutePositionScaling}, // Main sensor position 32bit
 
         /* ===================== Feedback to controlloop =========== */
-    {0x0818, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.sqPostn.hi, NULL},     // Mechanical turns number used by control loop
-    {0x0819, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.sqPostn.lo, NULL},     // Mechanical angle to control loop
-    {0x081A, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sqMechAbsPosOffset.hi, NULL},   // Mechanical Abs position offset HI used by control loop
-    {0x081B, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sqMechAbsPosOffset.lo, NULL},   // Mechanical Abs position offset LO used by control loop
-    {0x081C, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.slSpeed, NULL},        // Mechanical speed used by control loop
-    {0x081D, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.slAccel, NULL},        // Mechanical acceleration used by control loop
-    {0x081E, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.uwElecAngle, NULL},             // Main sensor electrical angle used by FPGA
-    {0x081F, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_Fbk2CntrLoop, &MotCtrl_AbsolutePositionScaling}, // TargetPosition 32bit (in modalita' posizionatore)
+    {0x0818, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.sqPostn.hi, NULL},     // Mechanical turns number used by control loop
+    {0x0819, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.sqPostn.lo, NULL},     // Mechanical angle to control loop
+    {0x081A, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sqMechAbsPosOffset.hi, NULL},   // Mechanical Abs position offset HI used by control loop
+    {0x081B, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sqMechAbsPosOffset.lo, NULL},   // Mechanical Abs position offset LO used by control loop
+    {0x081C, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.slSpeed, NULL},        // Mechanical speed used by control loop
+    {0x081D, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.slAccel, NULL},        // Mechanical acceleration used by control loop
+    {0x081E, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.uwElecAngle, NULL},             // Main sensor electrical angle used by FPGA
+    {0x081F, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_Fbk2CntrLoop, &MotCtrl_AbsolutePositionScaling}, // TargetPosition 32bit (in modalita' posizionatore)
 
         /* -------- Endat MAIN -------- */
     {0x0820, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_RESETREQ, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_PARAMSAVE,   &sEn_Params[ENDAT_SEL_MAIN].uwClockFreq, NULL},           // Endat clock frequency
@@ -484,15 +497,15 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
 
 
         /* ===================== Auxiliary ===================== */
-    {0x0880, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.sqPostn.hi, NULL},           // Auxiliary sensor mechanical turns number
-    {0x0881, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.sqPostn.lo, NULL},           // Auxiliary sensor mechanical angle
-    {0x0882, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sqMechAbsPosOffset.hi, NULL},         // Auxiliary sensor mechanical Abs position offset HI
-    {0x0883, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sqMechAbsPosOffset.lo, NULL},         // Auxiliary sensor mechanical Abs position offset LO
-    {0x0884, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.slSpeed, NULL},              // Auxiliary sensor mechanical speed
-    {0x0885, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.slAccel, NULL},              // Auxiliary sensor mechanical acceleration
-    {0x0886, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.uwElecAngle, NULL},                   // Auxiliary sensor electrical angle
-    {0x0887, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_AuxEnc, &MotCtrl_AbsolutePositionScaling}, // Auxiliary sensor position 32bit
-    {0x0888, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.ubStatus, NULL},
+    {0x0880, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.sqPostn.hi, NULL},           // Auxiliary sensor mechanical turns number
+    {0x0881, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.sqPostn.lo, NULL},           // Auxiliary sensor mechanical angle
+    {0x0882, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sqMechAbsPosOffset.hi, NULL},         // Auxiliary sensor mechanical Abs position offset HI
+    {0x0883, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sqMechAbsPosOffset.lo, NULL},         // Auxiliary sensor mechanical Abs position offset LO
+    {0x0884, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.slSpeed, NULL},              // Auxiliary sensor mechanical speed
+    {0x0885, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.slAccel, NULL},              // Auxiliary sensor mechanical acceleration
+    {0x0886, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.uwElecAngle, NULL},                   // Auxiliary sensor electrical angle
+    {0x0887, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_AuxEnc, &MotCtrl_AbsolutePositionScaling}, // Auxiliary sensor position 32bit
+    {0x0888, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.ubStatus, NULL},
 
         /* -------- Endat Auxiliary  -------- */
 #ifndef _HW_DC
@@ -560,7 +573,7 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x08F2, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_RESETREQ, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_PARAMSAVE,   &sEfsParam.ubProcType, NULL},           // procedure type
 	{0x08F3, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_UBYTE,  0, 1, WRDENY_PARAMSAVE,   &sEfsParam.bForce, NULL},//    {0x08F3, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_BITW,  0, 1, WRDENY_PARAMSAVE,   &sEfsParam.options.w, NULL},            // force procedure also if ENCMGR_ELE_ANGLE_VALID
     {0x08F4, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_PARAMSAVE,   &sEfsParam.slSpeedThreshold, NULL},     // wait for speed below this threshold
-    {0x08F5, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,     &sEm_MainEnc.uwDeltaElecAngle, NULL},   // Main sensor elec angle offset calculation
+    {0x08F5, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,     &sEm_MainEnc.uwDeltaElecAngle, NULL},   // Main sensor elec angle offset calculation
     {0x08F6, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_PARAMSAVE,   &sEfsParam.slElecAngleFeed, NULL},      // ratio for feeding electrical angle from IqRef output
     {0x08F7, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_PARAMSAVE,   &sEfsParam.uwIdSteadyTime, NULL},       // time when Id is kept constant [msec]
     {0x08F8, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_PARAMSAVE,   &sEfsParam.sPI_Param.swKi, NULL},
@@ -570,44 +583,44 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x08FC, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_PARAMSAVE,   &sEfsParam.sPI_Param.slOutValLimit, NULL},
 
         /* ===================== Main Abs Encoder ===================== */
-    {0x0900, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.sqPostn.hi, NULL},          // mechanical turns number
-    {0x0901, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.sqPostn.lo, NULL},          // mechanical angle
-    {0x0902, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sqMechAbsPosOffset.hi, NULL},        // mechanical Abs position offset HI
-    {0x0903, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sqMechAbsPosOffset.lo, NULL},        // mechanical Abs position offset LO
-    {0x0904, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.slSpeed, NULL},             // mechanical speed
-    {0x0905, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.slAccel, NULL},             // mechanical acceleration
-    {0x0906, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.uwElecAngle, NULL},                  // electrical angle
-    {0x0907, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_MainAbsEnc, &MotCtrl_AbsolutePositionScaling}, // Main sensor position 32bit
-    {0x0908, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.ubStatus, NULL},
+    {0x0900, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.sqPostn.hi, NULL},          // mechanical turns number
+    {0x0901, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.sqPostn.lo, NULL},          // mechanical angle
+    {0x0902, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sqMechAbsPosOffset.hi, NULL},        // mechanical Abs position offset HI
+    {0x0903, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sqMechAbsPosOffset.lo, NULL},        // mechanical Abs position offset LO
+    {0x0904, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.slSpeed, NULL},             // mechanical speed
+    {0x0905, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.slAccel, NULL},             // mechanical acceleration
+    {0x0906, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.uwElecAngle, NULL},                  // electrical angle
+    {0x0907, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_MainAbsEnc, &MotCtrl_AbsolutePositionScaling}, // Main sensor position 32bit
+    {0x0908, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.ubStatus, NULL},
 
         /* ===================== Main Rel Encoder ===================== */
-    {0x0910, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.sqPostn.hi, NULL},          // mechanical turns number
-    {0x0911, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.sqPostn.lo, NULL},          // mechanical angle
-    {0x0912, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sqMechAbsPosOffset.hi, NULL},        // mechanical Abs position offset HI
-    {0x0913, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sqMechAbsPosOffset.lo, NULL},        // mechanical Abs position offset LO
-    {0x0914, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.slSpeed, NULL},             // mechanical speed
-    {0x0915, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.slAccel, NULL},             // mechanical acceleration
-    {0x0916, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.uwElecAngle, NULL},                  // electrical angle
-    {0x0917, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_MainRelEnc, &MotCtrl_AbsolutePositionScaling}, // Main sensor position 32bit
-    {0x0918, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.ubStatus, NULL},
+    {0x0910, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.sqPostn.hi, NULL},          // mechanical turns number
+    {0x0911, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.sqPostn.lo, NULL},          // mechanical angle
+    {0x0912, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sqMechAbsPosOffset.hi, NULL},        // mechanical Abs position offset HI
+    {0x0913, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sqMechAbsPosOffset.lo, NULL},        // mechanical Abs position offset LO
+    {0x0914, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.slSpeed, NULL},             // mechanical speed
+    {0x0915, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.slAccel, NULL},             // mechanical acceleration
+    {0x0916, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.uwElecAngle, NULL},                  // electrical angle
+    {0x0917, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sEm_MainRelEnc, &MotCtrl_AbsolutePositionScaling}, // Main sensor position 32bit
+    {0x0918, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.ubStatus, NULL},
 
         /* ===================== 64bit direct access ===================== */
-    {0x0920, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.sqPostn, NULL},
-    {0x0921, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sqMechAbsPosOffset, NULL},
-    {0x0922, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.sqPostn, NULL},
-    {0x0923, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sqMechAbsPosOffset, NULL},
-    {0x0924, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.sqPostn, NULL},
-    {0x0925, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sqMechAbsPosOffset, NULL},
-    {0x0926, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.sqPostn, NULL},
-    {0x0927, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sqMechAbsPosOffset, NULL},
-    {0x0928, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.sqPostn, NULL},
-    {0x0929, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sqMechAbsPosOffset, NULL},
-    {0x092A, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sPo_PostnerOut.sDemand.sqPostn, NULL},
+    {0x0920, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sEncData.sqPostn, NULL},
+    {0x0921, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainEnc.sqMechAbsPosOffset, NULL},
+    {0x0922, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sEncData.sqPostn, NULL},
+    {0x0923, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CntrLoop.sqMechAbsPosOffset, NULL},
+    {0x0924, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sEncData.sqPostn, NULL},
+    {0x0925, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_AuxEnc.sqMechAbsPosOffset, NULL},
+    {0x0926, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sEncData.sqPostn, NULL},
+    {0x0927, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainAbsEnc.sqMechAbsPosOffset, NULL},
+    {0x0928, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sEncData.sqPostn, NULL},
+    {0x0929, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sEm_MainRelEnc.sqMechAbsPosOffset, NULL},
+    {0x092A, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sPo_PostnerOut.sDemand.sqPostn, NULL},
 
     {0x0930, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_C_UBYTE, 0, 1, WRDENY_DEFAULT, (HPVOID)2, NULL},
 
         /* ===================== Extras ===================== */
-    {0x0940, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CLExt.slFilteredSpeed, NULL},        // Mechanical filtered speed
+    {0x0940, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sEm_Fbk2CLExt.slFilteredSpeed, NULL},        // Mechanical filtered speed
     {0x0941, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_PARAMSAVE, &sEm_EncMngrParam.slMaxSpeed, NULL},          // Maximum allowed speed [d.u.]
     {0x0942, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_PARAMSAVE, &sEm_EncMngrParam.swElecAngleFFTime, NULL},   // Electrical Angle feed forward time [usec]
 #ifdef _HW_DC
@@ -616,7 +629,7 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x0944, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_RESETREQ, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_PARAMSAVE,   &sEm_EncMngrParam.uwSimSel, NULL},
 
 #if CFG_IPM_PHASEOFFSET
-    {0x0945, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sEm_EncMngrOut.swElecAngleFF, NULL},              // elec angle additional ff offset
+    {0x0945, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sEm_EncMngrOut.swElecAngleFF, NULL},              // elec angle additional ff offset
 
     {0x0950, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_PARAMSAVE, &sEm_EncMngrParam.flags.b.bIpmMgmt, NULL},         // IPM: flags to enable IPM mgmt
     {0x0951, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_PARAMSAVE, &sEm_EncMngrParam.sIPM.slMaxI, NULL},              // IPM: max current at max phase offset
@@ -625,7 +638,7 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x0954, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_PARAMSAVE, &sEm_EncMngrParam.sIPM.flK1, NULL},                // IPM: equation 1st order coeff (K1 * x)
     {0x0955, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_PARAMSAVE, &sEm_EncMngrParam.sIPM.flK2, NULL},                // IPM: equation 2nd order coeff (K2 * x^2)
     {0x0956, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_PARAMSAVE, &sEm_EncMngrParam.sIPM.flK3, NULL},                // IPM: equation 3rd order coeff (K3 * x^3)
-    {0x0957, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sEm_EncMngrOut.swElecAngleIPM, NULL},             // IPM: elec angle additional IPM offset
+    {0x0957, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sEm_EncMngrOut.swElecAngleIPM, NULL},             // IPM: elec angle additional IPM offset
 #endif
 
         /* -------- Incremental MAIN Extras -------- */
@@ -662,7 +675,7 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
 #if (CFG_ENCMGR_OPENLOOP)
     	/* ======== Encoder Manager OpenLoop ======== */
 	{0x09B0, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_RESETREQ, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_PARAMSAVE, &sEm_EncMngrParam.flags.b.bOpenLoop, NULL}, // flags to enable open loop with encoder
-    {0x09B1, COMMONPARAMDB_FLAG_RD,                             COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_EncMngrOut.flags.b.bOpenLoop,   NULL},
+    {0x09B1, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA,                             COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sEm_EncMngrOut.flags.b.bOpenLoop,   NULL},
 #endif
 
         //****************************************************************************
@@ -751,16 +764,16 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x0C17, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_UsrPostnerIn.slTargetSpeed, NULL},             // TargetVelocity (in modalita velocita')
 
         /* --------------- Output --------------- */
-    {0x0C30, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.flags.w, NULL},                     // Flags status modulo sw posizionatore
-    {0x0C32, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sDemand.sqPostn.hi, NULL},          // posizione di riferimento da mandare in anello: turns
-    {0x0C33, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sDemand.sqPostn.lo, NULL},          // posizione di riferimento da mandare in anello: angle
-    {0x0C34, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sDemand.slSpeed, NULL},             // velocita' di riferimento da mandare in anello
-    {0x0C35, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sDemand.slAccel, NULL},             // accelerazione di riferimento da mandare in anello
+    {0x0C30, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.flags.w, NULL},                     // Flags status modulo sw posizionatore
+    {0x0C32, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sDemand.sqPostn.hi, NULL},          // posizione di riferimento da mandare in anello: turns
+    {0x0C33, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sDemand.sqPostn.lo, NULL},          // posizione di riferimento da mandare in anello: angle
+    {0x0C34, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sDemand.slSpeed, NULL},             // velocita' di riferimento da mandare in anello
+    {0x0C35, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sDemand.slAccel, NULL},             // accelerazione di riferimento da mandare in anello
 //    {0x0C36, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.slPosErr, NULL},                    // Position error measured
-    {0x0C36, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sqPosErr, &MotCtrl_RelativePositionScaling}, // Position error 32bit
-    {0x0C37, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sqPosErr.hi, NULL},                 // Position error 32bit: Turns
-    {0x0C38, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sqPosErr.lo, NULL},                 // Position error 32bit: Angle
-    {0x0C39, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sqPosErr, NULL},                    // Position error 64bit
+    {0x0C36, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sqPosErr, &MotCtrl_RelativePositionScaling}, // Position error 32bit
+    {0x0C37, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sqPosErr.hi, NULL},                 // Position error 32bit: Turns
+    {0x0C38, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sqPosErr.lo, NULL},                 // Position error 32bit: Angle
+    {0x0C39, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT, &sPo_PostnerOut.sqPosErr, NULL},                    // Position error 64bit
 
         //****************************************************************************
         // Motor Handler
@@ -790,47 +803,47 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x0E16, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_RESETREQ, COMMONPARAMDB_TYPE_UBYTE,  0, 1, WRDENY_DEFAULT,   &sMh_MotorDataParam.flags.b.bDisVacMgm, NULL},     // MotorHandler bDisVacMgm
     {0x0E17, COMMONPARAMDB_FLAG_RW|COMMONPARAMDB_FLAG_RESETREQ, COMMONPARAMDB_TYPE_UBYTE,  0, 1, WRDENY_DEFAULT,   &sMh_MotorDataParam.flags.b.bEnableDeflux, NULL},  // MotorHandler bEnableDeflux
     {0x0E18, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_PARAMSAVE, &sMh_MotorDataParam.uwVacMinDistortion, NULL},      // Soglia minima accettata distorsione Vac
-    {0x0E20, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIdFb, NULL},                    // Id feedback
-    {0x0E21, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIqFb, NULL},                    // Iq feedback
-    {0x0E22, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIuFb, NULL},                    // Iu feedback
-    {0x0E23, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIvFb, NULL},                    // Iv feedback
-    {0x0E24, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sBackEmfData.swAlpha, NULL},      // BackEmf Alpha
-    {0x0E25, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sBackEmfData.swBeta, NULL},       // BackEmf Beta
-    {0x0E26, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVuEstimated, NULL},             // Vu stimata
-    {0x0E27, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVvEstimated, NULL},             // Vv stimata
-    {0x0E28, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swDcBusValue, NULL},              // valore Dc Bus
-    {0x0E29, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sBackEmfData.uwVmotor, NULL},     // tensione motore
-    {0x0E2A, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sBackEmfData.uwAtanAngle, NULL},  // AtanAngle
-    {0x0E2B, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sI2Fpga.slIdRef, NULL},           // IdRef2Fpga
-    {0x0E2C, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sI2Fpga.slIqRef, NULL},           // IqRef2Fpga
-    {0x0E2D, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIwFb, NULL},                    // Iw feedback
-    {0x0E2E, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIqFltRef, NULL},                // IqFilteredRef2Fpga
-    {0x0E2F, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swACVrs, NULL},                   // Vac RS
-    {0x0E30, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swACVst, NULL},                   // Vac ST
-    {0x0E31, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.ubACStatus, NULL},                // Vac input phases status
-    {0x0E32, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swACVtr, NULL},                   // Vac TR
-    {0x0E33, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVdOut, NULL},                   // Vd Out
-    {0x0E34, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVqOut, NULL},                   // Vq Out
-    {0x0E35, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVMotor, NULL},                  // Vmotor
+    {0x0E20, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIdFb, NULL},                    // Id feedback
+    {0x0E21, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIqFb, NULL},                    // Iq feedback
+    {0x0E22, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIuFb, NULL},                    // Iu feedback
+    {0x0E23, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIvFb, NULL},                    // Iv feedback
+    {0x0E24, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sBackEmfData.swAlpha, NULL},      // BackEmf Alpha
+    {0x0E25, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sBackEmfData.swBeta, NULL},       // BackEmf Beta
+    {0x0E26, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVuEstimated, NULL},             // Vu stimata
+    {0x0E27, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVvEstimated, NULL},             // Vv stimata
+    {0x0E28, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swDcBusValue, NULL},              // valore Dc Bus
+    {0x0E29, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sBackEmfData.uwVmotor, NULL},     // tensione motore
+    {0x0E2A, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sBackEmfData.uwAtanAngle, NULL},  // AtanAngle
+    {0x0E2B, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sI2Fpga.slIdRef, NULL},           // IdRef2Fpga
+    {0x0E2C, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sI2Fpga.slIqRef, NULL},           // IqRef2Fpga
+    {0x0E2D, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIwFb, NULL},                    // Iw feedback
+    {0x0E2E, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIqFltRef, NULL},                // IqFilteredRef2Fpga
+    {0x0E2F, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swACVrs, NULL},                   // Vac RS
+    {0x0E30, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swACVst, NULL},                   // Vac ST
+    {0x0E31, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.ubACStatus, NULL},                // Vac input phases status
+    {0x0E32, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swACVtr, NULL},                   // Vac TR
+    {0x0E33, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVdOut, NULL},                   // Vd Out
+    {0x0E34, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVqOut, NULL},                   // Vq Out
+    {0x0E35, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVMotor, NULL},                  // Vmotor
     {0x0E40, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataUsrInIRef.slIdRef, NULL},             // UsrIdRef (Torque mode)
     {0x0E41, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataUsrInIRef.slIqRef, NULL},             // UsrIqRef (Torque mode)
-    {0x0E4F, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.uwDSPCompLevel, NULL},
-    {0x0E50, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.flAutoModKi, NULL},               // AutoModKp
-    {0x0E51, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.flAutoModKp, NULL},               // AutoModKi
-    {0x0E52, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sIdLimit.slMin, NULL},
-    {0x0E53, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sIdLimit.slMax, NULL},
-    {0x0E54, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sIqLimit.slMin, NULL},
-    {0x0E55, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sIqLimit.slMax, NULL},
+    {0x0E4F, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.uwDSPCompLevel, NULL},
+    {0x0E50, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.flAutoModKi, NULL},               // AutoModKp
+    {0x0E51, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.flAutoModKp, NULL},               // AutoModKi
+    {0x0E52, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sIdLimit.slMin, NULL},
+    {0x0E53, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sIdLimit.slMax, NULL},
+    {0x0E54, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sIqLimit.slMin, NULL},
+    {0x0E55, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sIqLimit.slMax, NULL},
     {0x0E56, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataUsrSetIdLimit.slMin, NULL},
     {0x0E57, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataUsrSetIdLimit.slMax, NULL},
     {0x0E58, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataUsrSetIqLimit.slMin, NULL},
     {0x0E59, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataUsrSetIqLimit.slMax, NULL},
-    {0x0E5A, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sDriveLimit.slOverCurrent, NULL}, // actual overcurrent threshold
-    {0x0E5B, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sDriveLimit.swOverVoltage, NULL}, // actual overvoltage threshold
-    {0x0E5C, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swActiveVBrakeLow, NULL},         // actual brake off threshold
-    {0x0E5D, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swActiveVBrakeHigh, NULL},        // actual brake on threshold
-    {0x0E5E, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.ubActualPwmFrequency, NULL},      // actual switching frequency
-    {0x0E5F, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.ubDSPLoad, NULL},
+    {0x0E5A, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sDriveLimit.slOverCurrent, NULL}, // actual overcurrent threshold
+    {0x0E5B, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.sDriveLimit.swOverVoltage, NULL}, // actual overvoltage threshold
+    {0x0E5C, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swActiveVBrakeLow, NULL},         // actual brake off threshold
+    {0x0E5D, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swActiveVBrakeHigh, NULL},        // actual brake on threshold
+    {0x0E5E, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.ubActualPwmFrequency, NULL},      // actual switching frequency
+    {0x0E5F, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.ubDSPLoad, NULL},
 
     {0x0E60, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_PARAMSAVE, &sMh_MotorDataParam.sIqFiltPars[0].ubType, NULL},
     {0x0E61, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_PARAMSAVE, &sMh_MotorDataParam.sIqFiltPars[0].flFreqMain, NULL},
@@ -853,22 +866,22 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x0E7B, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_PARAMSAVE, &sMh_MotorDataParam.sIqFiltPars[3].flFreqSec, NULL},
     {0x0E7C, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_FLOAT, 0, 1, WRDENY_PARAMSAVE, &sMh_MotorDataParam.sIqFiltPars[3].flDampSec, NULL},
 #if CFG_VMOTOR_READ
-	{0x0E7D, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVuEffective, NULL},             // Vu effective
-	{0x0E7E, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVvEffective, NULL},             // Vv effective
-	{0x0E7F, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVwEffective, NULL},             // Vw effective
+	{0x0E7D, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVuEffective, NULL},             // Vu effective
+	{0x0E7E, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVvEffective, NULL},             // Vv effective
+	{0x0E7F, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.swVwEffective, NULL},             // Vw effective
 #endif
 
 #ifdef _HW_DC
-    {0x0E88, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr1IuFb, NULL},
-    {0x0E89, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr1IvFb, NULL},
-    {0x0E8A, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr1IwFb, NULL},
-    {0x0E8B, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr2IuFb, NULL},
-    {0x0E8C, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr2IvFb, NULL},
-    {0x0E8D, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr2IwFb, NULL},
+    {0x0E88, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr1IuFb, NULL},
+    {0x0E89, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr1IvFb, NULL},
+    {0x0E8A, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr1IwFb, NULL},
+    {0x0E8B, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr2IuFb, NULL},
+    {0x0E8C, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr2IvFb, NULL},
+    {0x0E8D, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slBr2IwFb, NULL},
 #endif
 
 #ifdef _HW_CT
-    {0x0E8E, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIBrake, NULL},
+    {0x0E8E, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMh_MotorDataOut.slIBrake, NULL},
 #endif
         //****************************************************************************
         // Field Weakening
@@ -922,10 +935,10 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
         // Motion Controller
         //****************************************************************************
     {0x1000, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_UsrControl.uwControlWord, NULL},
-    {0x1001, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_Out.uwStatusWord, NULL},
+    {0x1001, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UWORD, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_Out.uwStatusWord, NULL},
     {0x1008, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   (HPVOID)&ulMotCtrlSuppDriveModes},
     {0x1010, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_PARAMSAVE, &sMotCtrlParameters.ubModeOfOperation, NULL},
-    {0x1011, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_Out.ubModeOfOperationDisplay, NULL},
+    {0x1011, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_UBYTE, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_Out.ubModeOfOperationDisplay, NULL},
     {0x1020, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_UsrControl.sqTargetPostn.hi, NULL},     // TargetPosition 32bit: Turns (in modalita' posizionatore)
     {0x1021, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_UsrControl.sqTargetPostn.lo, NULL},     // TargetPosition 32bit: Angle (in modalita' posizionatore)
     {0x1022, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SQWRD, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_UsrControl.sqTargetPostn, NULL},        // TargetPosition 64bit (in modalita' posizionatore)
@@ -936,10 +949,10 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x1027, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SBYTE, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_UsrControl.sbHomingSoftPosSwitch, NULL},
     {0x1028, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SBYTE, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_UsrControl.sbHomingSoftNegSwitch, NULL},
     {0x1029, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SBYTE, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_UsrControl.sbHomingSoftHomeSwitch, NULL},
-    {0x102A, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_Out.slIPQuotaMonitor, NULL},
-    {0x102B, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_PARAMSAVE, &sMh_MotorDataOut.slIqFb, &MotCtrl_RatedTorqueScaling},
+    {0x102A, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_Out.slIPQuotaMonitor, NULL},
+    {0x102B, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_PARAMSAVE, &sMh_MotorDataOut.slIqFb, &MotCtrl_RatedTorqueScaling},
     {0x102C, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_DEFAULT,   &sMotCtrl_UsrControl.swTargetTorque, NULL},
-    {0x102D, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sMotCtrl_Out.sqUserOffset, &MotCtrl_RelativePositionScaling},
+    {0x102D, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_UMCONV|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG, 0, 1, WRDENY_DEFAULT, &sMotCtrl_Out.sqUserOffset, &MotCtrl_RelativePositionScaling},
 
     {0x1030, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_PARAMSAVE, &sMotCtrlParameters.swOptQuickStop},               // quickstop option code
     {0x1031, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_SWORD, 0, 1, WRDENY_PARAMSAVE, &sMotCtrlParameters.swOptShutdown},                // shutdown option code
@@ -1524,11 +1537,11 @@ const COMMONPARAMDB_ENTRY psCommonParamTable[]=
     {0x8304, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_UWORD,0, 1, WRDENY_PARAMSAVE,   &sSyncMgrParam.uwPeakNDiscard},
     {0x8305, COMMONPARAMDB_FLAG_RW, COMMONPARAMDB_TYPE_ULONG,0, 1, WRDENY_PARAMSAVE,   &sSyncMgrParam.ulPeakThreshold},
 
-    {0x8310, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.ulSyncTime},
-    {0x8311, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.ulSyncMax},
-    {0x8312, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_ULONG,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.ulSyncMin},
-    {0x8313, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SBYTE,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.bValid},
-    {0x8315, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_SLONG,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.slSyncInstValue},
+    {0x8310, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.ulSyncTime},
+    {0x8311, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.ulSyncMax},
+    {0x8312, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_ULONG,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.ulSyncMin},
+    {0x8313, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SBYTE,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.bValid},
+    {0x8315, COMMONPARAMDB_FLAG_RD|COMMONPARAMDB_FLAG_RTDATA, COMMONPARAMDB_TYPE_SLONG,0, 1, WRDENY_DEFAULT,     &sSyncMgrDiagnosticOut.slSyncInstValue},
 
     {0x8320, COMMONPARAMDB_FLAG_RD, COMMONPARAMDB_TYPE_C_UBYTE, 0, 1, WRDENY_DEFAULT, (HPVOID)4, NULL},
 
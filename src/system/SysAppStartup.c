@@ -17,6 +17,8 @@
 #include "system\SysAppConfig.h"
 
 #include "core\SystemReset.h"
+#include "core\Cpu1.h"
+#include "common\AmpMailbox.h"
 
 #include "drive\HardwareConfig.h"
 #include "drive\AxM-E-Defines.h"
@@ -357,6 +359,11 @@ static void SystemBoot(void)
             // task scheduler initialization
         TaskSched_Init();
 
+#if CFG_AMP
+            // mailboxes between cores, before any module can post
+        AmpMbox_Init();
+#endif
+
             // parameter area default values load
         parmgm_par_init();
         parmgm_par_default();
@@ -656,6 +663,11 @@ int main()
     /* create main background task */
     (void)Os_TaskCreateEx(TaskSched_BackgroundScheduler,512,"BackGround Task");
 
+#if CFG_AMP
+    /* Start second core on its background scheduler */
+    Cpu1_Start(&TaskSched_BackgroundSchedulerCpu1);
+#endif
+
     /* Start the RTOS scheduler. */
     vTaskStartScheduler();
 
@@ -42,6 +42,7 @@
 #include "plc\Plc.h"
 #include "common\ParametersCheck.h"
 #include "common\WatchDogManagement.h"
+#include "common\FlashQueue.h"
 
 #ifdef _APP_DEBUG
 #include "common\CommonParamDB.h"
@@ -87,6 +88,7 @@ const TASKSCHEDULER_TASK_INIT psSysAppTaskCollection[]=
 	TASK_ENTRY(ModBusComDBCheckTable, 0),
 	TASK_ENTRY(CanOpenComDBCheckTable, 0),
 #endif // app_debug
+	TASK_ENTRY(FlashQ_Init, 0),
 	TASK_ENTRY(SysLogMgm_Init, 0),
 	TASK_ENTRY(ParChk_Init, 0),
 
@@ -212,6 +214,7 @@ const TASKSCHEDULER_TASK_INIT psSysAppTaskCollection[]=
 
 const TASKSCHEDULER_TASK_INIT psSysAppTaskAltCollection[]=
 {
+	TASK_ENTRY(FlashQ_Init, 0),
 	TASK_ENTRY(SysLogMgm_Init, 0),
 
 	TASK_ENTRY(ParChk_Init, 0),
@@ -231,6 +234,7 @@ const TASKSCHEDULER_TASK_INIT psSysAppTaskAltCollection[]=
 
 const TASKSCHEDULER_TASK_INIT psSysAppTaskAltCollectWPars[]=
 {
+	TASK_ENTRY(FlashQ_Init, 0),
 	TASK_ENTRY(SysLogMgm_Init, 0),
 
 	TASK_ENTRY(ParChk_Init, 0),
@@ -250,6 +254,7 @@ const TASKSCHEDULER_TASK_INIT psSysAppTaskAltCollectWPars[]=
 
 const TASKSCHEDULER_TASK_INIT psSysAppTaskAltCollectFullCfg[]=
 {
+	TASK_ENTRY(FlashQ_Init, 0),
 	TASK_ENTRY(SysLogMgm_Init, 0),
 	TASK_ENTRY(ParChk_Init, 0),
 
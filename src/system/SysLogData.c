@@ -31,6 +31,13 @@
 //#include <xe167f.h>
 #include <string.h>
 
+//***************************************************************************
+// Defines
+
+    // blocks indexed in one clock/alarm record, if more the index falls
+    // back to scanning the record
+#define SYSLOGDATA_BLKINDEX_ENTRIES                 8
+
 //***************************************************************************
 // Globals
 
@@ -68,26 +75,21 @@ BOOL SysLogData_Init(void)
 BOOL SysLogData_RestoreClockLogData(HPVOID hpvBuf, SLONG slSize)
 {
     SYSLOGDATA_OS_STATISTICS osstat;
-    HPVOID blkptr;
-    ULONG storagesize;
-    SWORD blkcode;
-
-        // then seek managed blocks
-    storagesize=(ULONG)slSize;
-	while((blkcode=blkstor_enumvalid(&hpvBuf, &storagesize, &blkptr)) != BLKSTOR_ERR_NOTFOUND)
-        switch(blkcode)
-        {
-            case DATACODE_SYSLOG_OS_STATISTICS:
-    		    blkstor_getdata(blkptr,0,DATACODE_SYSLOG_OS_STATISTICS,&osstat,sizeof(osstat));
+    BLKSTOR_INDEX sIndex;
+    BLKSTOR_INDEX_ENTRY sEntries[SYSLOGDATA_BLKINDEX_ENTRIES];
+
+        // validate managed blocks once
+    blkstor_index_build(&sIndex, hpvBuf, (ULONG)slSize, sEntries, SYSLOGDATA_BLKINDEX_ENTRIES);
 
+        // then get them
+    if(blkstor_index_getdata(&sIndex,DATACODE_SYSLOG_OS_STATISTICS,&osstat,sizeof(osstat))>0)
+    {
 #if (OS_MEASURESTACKSIZE)
-                uwOsSysStackFree=osstat.uwOsSysStackFree;
-                uwOsUsrStackFree=osstat.uwOsUsrStackFree;
+        uwOsSysStackFree=osstat.uwOsSysStackFree;
+        uwOsUsrStackFree=osstat.uwOsUsrStackFree;
 #endif
-                uwTaskSchedRTMaxTime=osstat.uwTaskSchedRTMaxTime;
-
-                break;
-        }
+        uwTaskSchedRTMaxTime=osstat.uwTaskSchedRTMaxTime;
+    }
 
     return TRUE;
 }
@@ -101,9 +103,8 @@ BOOL SysLogData_InsertIntoAlarmHistory(SYSLOGMGM_ALARMLOG  * psAlarmLog, HPVOID
 {
     SYSLOGDATA_ALARM  * psAlTb;
     SYSLOGDATA_ALARM_V1_DATA  * psAlV1Src;
-    HPVOID blkptr;
-    ULONG storagesize;
-    SWORD blkcode;
+    BLKSTOR_INDEX sIndex;
+    BLKSTOR_INDEX_ENTRY sEntries[SYSLOGDATA_BLKINDEX_ENTRIES];
     SWORD ct;
 
         // lock table
@@ -127,34 +128,28 @@ BOOL SysLogData_InsertIntoAlarmHistory(SYSLOGMGM_ALARMLOG  * psAlarmLog, HPVOID
         // store alarm definition
     psAlTb->sSys=*psAlarmLog;
 
-        // then seek managed blocks
-    storagesize=(ULONG)swSize;
-	while((blkcode=blkstor_enumvalid(&hpvBuf, &storagesize, &blkptr)) != BLKSTOR_ERR_NOTFOUND)
-        switch(blkcode)
-        {
-            case DATACODE_SYSLOG_ALARM_V1_DATA:
-    		    blkstor_getaddr(blkptr,0,DATACODE_SYSLOG_ALARM_V1_DATA,&psAlV1Src);
-
-                    // copy back in the new data structure and signal the variables that
-                    // were stored with old data structure thus unavailable
-                psAlTb->sData.slIuFb        =psAlV1Src->slIuFb;
-                psAlTb->sData.slIvFb        =psAlV1Src->slIvFb;
-                psAlTb->sData.slIwFb        =SYSLOGDATA_ENTRY_VOID;
-                psAlTb->sData.slIuAvg       =psAlV1Src->slIuAvg;
-                psAlTb->sData.slIvAvg       =psAlV1Src->slIvAvg;
-                psAlTb->sData.slIqFb        =psAlV1Src->slIqFb;
-                psAlTb->sData.slIdFb        =psAlV1Src->slIdFb;
-                psAlTb->sData.swTJunction   =psAlV1Src->swTJunction;
-                psAlTb->sData.swTHeatsink   =psAlV1Src->swTHeatsink;
-                psAlTb->sData.slSpeed       =psAlV1Src->slSpeed;
-                psAlTb->sData.swDCBus       =psAlV1Src->swDCBus;
-                psAlTb->sData.ulBrakeEnergy =SYSLOGDATA_ENTRY_VOID;
-                break;
-
-            case DATACODE_SYSLOG_ALARM_DATA:
-    		    blkstor_getdata(blkptr,0,DATACODE_SYSLOG_ALARM_DATA,&psAlTb->sData,sizeof(psAlTb->sData));
-                break;
-        }
+        // then seek managed blocks, validated once
+    blkstor_index_build(&sIndex, hpvBuf, (ULONG)swSize, sEntries, SYSLOGDATA_BLKINDEX_ENTRIES);
+
+    if(blkstor_index_getaddr(&sIndex,DATACODE_SYSLOG_ALARM_V1_DATA,(void **)&psAlV1Src)>0)
+    {
+            // copy back in the new data structure and signal the variables that
+            // were stored with old data structure thus unavailable
+        psAlTb->sData.slIuFb        =psAlV1Src->slIuFb;
+        psAlTb->sData.slIvFb        =psAlV1Src->slIvFb;
+        psAlTb->sData.slIwFb        =SYSLOGDATA_ENTRY_VOID;
+        psAlTb->sData.slIuAvg       =psAlV1Src->slIuAvg;
+        psAlTb->sData.slIvAvg       =psAlV1Src->slIvAvg;
+        psAlTb->sData.slIqFb        =psAlV1Src->slIqFb;
+        psAlTb->sData.slIdFb        =psAlV1Src->slIdFb;
+        psAlTb->sData.swTJunction   =psAlV1Src->swTJunction;
+        psAlTb->sData.swTHeatsink   =psAlV1Src->swTHeatsink;
+        psAlTb->sData.slSpeed       =psAlV1Src->slSpeed;
+        psAlTb->sData.swDCBus       =psAlV1Src->swDCBus;
+        psAlTb->sData.ulBrakeEnergy =SYSLOGDATA_ENTRY_VOID;
+    }
+
+    blkstor_index_getdata(&sIndex,DATACODE_SYSLOG_ALARM_DATA,&psAlTb->sData,sizeof(psAlTb->sData));
 
         // set last alarm time
     atomic_write(&ulSysLogDataLastAlarmTime, &psAlTb->sSys.ulAbsoluteTime, sizeof(psAlTb->sSys.ulAbsoluteTime));
@@ -240,7 +235,7 @@ SWORD SysLogData_PostClockData(HPUBYTE hpubBuf, SWORD swLeftSize)
 
 BOOL SysLogData_GetFromAlarmHistory(ULONG ulTime, SYSLOGMGM_ALARMLOG  * psLog)
 {
-    SWORD ct;
+    UWORD lo,hi,mid;
     BOOL retval=FALSE;
 
         // if table is empty then immediately exit
@@ -250,19 +245,24 @@ BOOL SysLogData_GetFromAlarmHistory(ULONG ulTime, SYSLOGMGM_ALARMLOG  * psLog)
         // lock table
     Os_MutexWait(&tSysLogDataHistAccessMutex,0);
     
-    if(uwSysLogDataAlarmTblLength>0)
+        // table is sorted from the newest one, binary search of the
+        // oldest one not older than specified
+    lo=0;
+    hi=uwSysLogDataAlarmTblLength;
+    while(lo<hi)
+    {
+        mid=(lo+hi)/2;
+        if(psSysLogDataAlarmTable[mid].sSys.ulAbsoluteTime>=ulTime)
+            lo=mid+1;
+        else
+            hi=mid;
+    }
+
+        // if found copy base alarm info
+    if(lo>0)
     {
-            // start seeking from the oldest one
-        for(ct=uwSysLogDataAlarmTblLength-1;ct>=0;ct--)
-            if(psSysLogDataAlarmTable[ct].sSys.ulAbsoluteTime>=ulTime)
-                break;
-
-            // if found copy base alarm info
-        if(ct>=0)
-        {
-            *psLog=psSysLogDataAlarmTable[ct].sSys;
-            retval=TRUE;
-        }
+        *psLog=psSysLogDataAlarmTable[lo-1].sSys;
+        retval=TRUE;
     }
 
         // unlock table
@@ -25,9 +25,12 @@
 #include "common\FlashManager.h"
 #include "common\ProgramFlashHandler.h"
 #include "system\SysLogData.h"
+#include "system\SysLogRing.h"
+#include "common\FlashQueue.h"
 #include "plc\PlcRetainMgr.h"
 #include "system\Os.h"
 #include "common\TaskScheduler.h"
+#include "common\SpscRing.h"
 #include "common\BlockStorage.h"
 #include "core\SystemReset.h"
 #include "common\ParamStorageManagement.h"
@@ -50,9 +53,13 @@
 // Defines
 
 #define STORAGEGRANULARITY          (PROGRAMFLASH_PAGE_SIZE)
-#define ALARMQUEUESIZE              8
+#define ALARMQUEUESIZE              16
+#define RTALARMRINGSIZE             16      // power of 2
 #define CLOCKQUEUESIZE              2
 
+    // alarms taken from the queues and waiting for flash write
+#define ALARMPENDINGSIZE            16
+
 #define POWERFAILSAVEELEMENTS       2
 
     // for security against manual reset, the only case that cannot be
@@ -72,12 +79,6 @@
 //***************************************************************************
 // Data structure
 
-typedef struct
-{
-    HPVOID hpvStart;
-    ULONG ulSize;
-} BLOCKDEFS;
-
 typedef struct
 {
     ULONG ulAbsTime;
@@ -90,8 +91,16 @@ typedef struct
     HPVOID hpvSrc;
     HPVOID hpvDst;
     UWORD  uwCrc;
+    BOOL   bEncoded;                        // source already encoded
 } POWERFAILSAVE;
 
+typedef struct
+{
+    ULONG  ulPage[STORAGEGRANULARITY/sizeof(ULONG)];    // encoded page
+    ULONG  ulTicket;
+    HPVOID hpvDst;                          // page, NULL if not yet queued
+} PENDINGALARM;
+
 //***************************************************************************
 // Globals
 
@@ -118,32 +127,23 @@ volatile OS_QUEUE SysLogMgm_AlarmQueue;
 //***************************************************************************
 // Storage Blocks definition
 
-static const BLOCKDEFS sClockBlockDefs[]=
+    // clock and alarm blocks form a single ring, shared by both logs
+static const SYSLOGRING_SECTORDEF sSectorDefs[]=
 {
     {(HPVOID)SYSLOG_CLK_BLK0_START, (ULONG)SYSLOG_CLK_BLK0_SIZE},
     {(HPVOID)SYSLOG_CLK_BLK1_START, (ULONG)SYSLOG_CLK_BLK1_SIZE},
     {(HPVOID)SYSLOG_CLK_BLK2_START, (ULONG)SYSLOG_CLK_BLK2_SIZE},
-};
-
-#define CLOCKBLOCKCOUNT             (sizeof(sClockBlockDefs)/sizeof(BLOCKDEFS))
-
-static const BLOCKDEFS sAlarmsBlockDefs[]=
-{
     {(HPVOID)SYSLOG_ALRM_BLK0_START, (ULONG)SYSLOG_ALRM_BLK0_SIZE},
     {(HPVOID)SYSLOG_ALRM_BLK1_START, (ULONG)SYSLOG_ALRM_BLK1_SIZE},
 };
 
-#define ALARMSBLOCKCOUNT            (sizeof(sAlarmsBlockDefs)/sizeof(BLOCKDEFS))
+#define SECTORCOUNT                 (sizeof(sSectorDefs)/sizeof(SYSLOGRING_SECTORDEF))
 
 //***************************************************************************
 // Module management
 
 static BOOL bSysLogManagerEnabled=FALSE;
 static BOOL bFlashStorageEnabled=FALSE;
-static BOOL bRTPostAlarmValid0=FALSE;
-static BOOL bRTPostAlarmValid1=FALSE;
-static BOOL bSavedRTAlarm0=FALSE;
-static BOOL bSavedRTAlarm1=FALSE;
 
 //***************************************************************************
 // Alarm status and queues
@@ -152,8 +152,17 @@ static UBYTE  psAlarmQueue[STORAGEGRANULARITY];
 static ULONG  ulAlarmLastTime;
 static HPVOID hpvAlarmNextFree;
 
-static UBYTE  nubRTPostAlarmArea0[STORAGEGRANULARITY];
-static UBYTE  nubRTPostAlarmArea1[STORAGEGRANULARITY];
+    // alarms posted by realtime task, built in place into the ring slots
+    // and consumed by slow task
+static UBYTE  nubRTPostAlarmArea[RTALARMRINGSIZE][STORAGEGRANULARITY];
+static SPSCRING sRTAlarmRing;
+
+    // alarms waiting for flash write, in post order; the first ones are
+    // queued to the flash, each one is released when written
+static PENDINGALARM sAlarmPending[ALARMPENDINGSIZE];
+static UWORD uwAlarmPendingFirst;
+static UWORD uwAlarmPendingCount;
+static UWORD uwAlarmPendingQueued;
 
 static POWERFAILSAVE  sAlarmPowerFailSave[POWERFAILSAVEELEMENTS];
 static POWERFAILSAVE  * psAlarmPowerFailSave;
@@ -174,45 +183,67 @@ static ULONG ulClockLastSavedTime;
 static ULONG ulClockLastTime;
 static HPVOID hpvClockNextFree;
 
+    // clock page queued to the flash
+static ULONG ulClockWriteBuf[STORAGEGRANULARITY/sizeof(ULONG)];
+static ULONG ulClockWriteTicket;
+static BOOL bClockWriteQueued;
+static BOOL bClockWriteFlush;
+
 static POWERFAILSAVE  sClockPowerFailSave[POWERFAILSAVEELEMENTS];
 static POWERFAILSAVE  * psClockPowerFailSave;
 static UWORD uwClockPowerFailSaveSel;
 
+//***************************************************************************
+// Realtime trace dump area
+
+static ULONG  ulRTTraceDump[(SYSLOGMGM_RTTRACE_DUMPSIZE+sizeof(ULONG)-1)/sizeof(ULONG)];
+static UWORD  uwRTTraceDumpSize;
+
 //***************************************************************************
 // Local prototypes
 
-static BOOL setnextfree(const BLOCKDEFS * blkdefs, const UWORD blkcount, void  * * blkpointer);
+static void insertentry(ENTRYLIST * elst, ULONG ulAbsTime, HPVOID hpvAddress);
+static BOOL migraterecord(UWORD uwStream, HPVOID hpvPage);
+static void setalarmpowerfail(void);
+static void setclockpowerfail(void);
+static void storagefailed(void);
 static void slowtask(void);
-static HPUBYTE encodelogchunk(HPUBYTE,UWORD *);
+static HPUBYTE encodelogchunk(HPUBYTE,HPUBYTE,UWORD *);
+static UWORD encodertrace(void);
 
 //***************************************************************************
 // Init
 
 BOOL SysLogMgm_Init(void)
 {
-    UWORD ct,ctp,pagesize;
-    UWORD cts;
-    SWORD cti;
+    UWORD ct,ctp;
+    SWORD cti,cts;
     HPVOID stor_addr;
     HPVOID found_addr;
     HPVOID sy_addr;
     HPVOID blk_addr;
+    HPVOID clk_addr;
     ULONG stor_size;
+    ULONG seq;
     SWORD blkcode;
     SYSLOGMGM_CLOCKLOG clklog;
     SYSLOGMGM_ALARMLOG alrmlog;
-    ULONG abstime,alarmabstime;
+    ULONG abstime,alarmabstime,ringalarmtime;
+    BOOL clkmigrate;
     ENTRYLIST elst[SYSLOGDATA_ALARMS_MAX_ENTRIES];
 
         // check integrity
     assert(sizeof(SYSLOGMGM_DATATMPIDENT)<=sizeof(BLKSTOR_HEADER));
 
         // local init
-    bFlashStorageEnabled=TRUE;
     psClockPowerFailSave=NULL;
     psAlarmPowerFailSave=NULL;
     uwAlarmPowerFailSaveSel=0;
     uwClockPowerFailSaveSel=0;
+    uwAlarmPendingFirst=0;
+    uwAlarmPendingCount=0;
+    uwAlarmPendingQueued=0;
+    bClockWriteQueued=FALSE;
 
     	// alarm queue
     OS_CREATEPUREQUEUE(SysLogMgm_AlarmQueue,ALARMQUEUESIZE,STORAGEGRANULARITY);
@@ -220,39 +251,82 @@ BOOL SysLogMgm_Init(void)
 //    for(ct=0;ct<ALARMQUEUESIZE;ct++)
 //        Os_QueuePost(SysLogMgm_AlrmAvailableElements, (HPULONG)&ct);
 
-    bRTPostAlarmValid0=FALSE;
-    bRTPostAlarmValid1=FALSE;
-    bSavedRTAlarm0=FALSE;
-    bSavedRTAlarm1=FALSE;
+    	// realtime alarm ring
+    spscring_init(&sRTAlarmRing, nubRTPostAlarmArea, RTALARMRINGSIZE, STORAGEGRANULARITY);
 
         // init syslog data collection
     assert(SysLogData_Init());
 
-        // scan all clock blocks to find the newest page
-    hpvClockNextFree=NULL;
-    abstime=0l;
-    for(ct=0;ct<CLOCKBLOCKCOUNT;ct++)
+        // mount the log ring
+    bFlashStorageEnabled=SysLogRing_Init(sSectorDefs, SECTORCOUNT);
+
+        // records are read through the linear address space up to the
+        // alarm table fill-up
+    FlashQ_ReadLock();
+
+        // erase local table for found alarms in the storage blocks,
+        // it will contain a cronologically sorted list of alarms, up
+        // to SYSLOGDATA_ALARMS_MAX_ENTRIES
+    for(ct=0;ct<SYSLOGDATA_ALARMS_MAX_ENTRIES;ct++)
     {
-            // for each defined block
-        pagesize=(UWORD)(sClockBlockDefs[ct].ulSize/STORAGEGRANULARITY);
-            // scan each block page
-        for(ctp=0;ctp<pagesize;ctp++)
-        {
-            found_addr=stor_addr=&(((HPUBYTE)sClockBlockDefs[ct].hpvStart)[STORAGEGRANULARITY*ctp]);
-            stor_size=STORAGEGRANULARITY;
+        elst[ct].ulAbsTime=0l; 
+        elst[ct].hpvAddress=NULL;
+        elst[ct].uwSize=0;
+    }
 
-            blkcode=blkstor_enumvalid(&stor_addr, &stor_size, &blk_addr);
+        // scan all pages of the blocks not in the ring, that can be written
+        // with the previous format, to find the newest clock page and to
+        // fill-up alarm history table
+    clk_addr=NULL;
+    abstime=0l;
+    for(ct=0;SysLogRing_GetFreeSector(ct, &blk_addr, &stor_size);ct++)
+        for(ctp=0;ctp<(UWORD)(stor_size/STORAGEGRANULARITY);ctp++)
+        {
+            found_addr=&(((HPUBYTE)blk_addr)[STORAGEGRANULARITY*ctp]);
 
                 // just first must be the right one
-    		if(blkcode==DATACODE_SYSLOG_CLOCK)
-    		{
-			    if(blkstor_getdata(blk_addr,0,DATACODE_SYSLOG_CLOCK,&clklog,sizeof(clklog))>0)
-                    if(clklog.ulAbsoluteTime>abstime)
-                    {
-                        abstime=clklog.ulAbsoluteTime;
-                        hpvClockNextFree=found_addr;
-                    }
+            if(blkstor_getdata(found_addr,0,DATACODE_SYSLOG_CLOCK,&clklog,sizeof(clklog))>0)
+            {
+                if(clklog.ulAbsoluteTime>abstime)
+                {
+                    abstime=clklog.ulAbsoluteTime;
+                    clk_addr=found_addr;
+                }
+            }
+            else if(blkstor_getdata(found_addr,0,DATACODE_SYSLOG_ALARMS,&alrmlog,sizeof(alrmlog))>0)
+                insertentry(elst, alrmlog.ulAbsoluteTime, found_addr);
+        }
+
+        // previous format clock is moved into the ring if newer
+    clkmigrate=(clk_addr!=NULL);
+
+        // the newest valid clock record of the ring, the last written one
+    for(seq=SysLogRing_Head(SYSLOGRING_CLOCK);seq>SysLogRing_First(SYSLOGRING_CLOCK);)
+    {
+        found_addr=SysLogRing_GetRecord(SYSLOGRING_CLOCK, --seq);
+        if(found_addr && blkstor_getdata(found_addr,0,DATACODE_SYSLOG_CLOCK,&clklog,sizeof(clklog))>0)
+        {
+            if(clklog.ulAbsoluteTime>=abstime)
+            {
+                abstime=clklog.ulAbsoluteTime;
+                clk_addr=found_addr;
+                clkmigrate=FALSE;
             }
+            break;
+        }
+    }
+
+        // the newest valid alarm records of the ring, replacing previous
+        // format entries with same abstime
+    ringalarmtime=0l;
+    for(ct=0,seq=SysLogRing_Head(SYSLOGRING_ALARM);ct<SYSLOGDATA_ALARMS_MAX_ENTRIES && seq>SysLogRing_First(SYSLOGRING_ALARM);)
+    {
+        found_addr=SysLogRing_GetRecord(SYSLOGRING_ALARM, --seq);
+        if(found_addr && blkstor_getdata(found_addr,0,DATACODE_SYSLOG_ALARMS,&alrmlog,sizeof(alrmlog))>0)
+        {
+            if(ct++==0)
+                ringalarmtime=alrmlog.ulAbsoluteTime;
+            insertentry(elst, alrmlog.ulAbsoluteTime, found_addr);
         }
     }
 
@@ -265,7 +339,7 @@ BOOL SysLogMgm_Init(void)
         if(puwClockElemCrc[ct]==crc16(CRCINITIALSEED, (HPVOID)psClockSave[ct], STORAGEGRANULARITY))
         {
                 // encode it in order to use standard decode structure
-            stor_addr=encodelogchunk((HPVOID)psClockSave[ct],NULL);
+            stor_addr=encodelogchunk((HPVOID)psClockSave[ct],NULL,NULL);
             stor_size=STORAGEGRANULARITY;
     
             blkcode=blkstor_enumvalid(&stor_addr, &stor_size, &blk_addr);
@@ -287,116 +361,20 @@ BOOL SysLogMgm_Init(void)
     if(sy_addr)
     {
             // encode it
-        sy_addr=encodelogchunk(sy_addr,NULL);
+        sy_addr=encodelogchunk(sy_addr,NULL,NULL);
 
             // then restore data collections
         assert(SysLogData_RestoreClockLogData(sy_addr, STORAGEGRANULARITY));
         assert(PlcRetMgr_RestoreRetainData(sy_addr, STORAGEGRANULARITY));
     }
-
-        // if found in flash
-    if(hpvClockNextFree)
-    {
-            // but not in ram
-        if(!sy_addr)
-        {
-                // restore data collections from latest clock log entry
-            assert(SysLogData_RestoreClockLogData(hpvClockNextFree, STORAGEGRANULARITY));
-            assert(PlcRetMgr_RestoreRetainData(hpvClockNextFree, STORAGEGRANULARITY));
-        }
-    }
-        // otherwise set next free for the first time
-    else
-        hpvClockNextFree=sClockBlockDefs[0].hpvStart;
-
-        // set the newest page
-    if(!setnextfree(sClockBlockDefs, CLOCKBLOCKCOUNT, &hpvClockNextFree))
-        bFlashStorageEnabled=FALSE;
-
-        // erase local table for found alarms in the alarms storage blocks,
-        // it will contain a cronologically sorted list of alarms, up
-        // to SYSLOGDATA_ALARMS_MAX_ENTRIES
-    for(ct=0;ct<SYSLOGDATA_ALARMS_MAX_ENTRIES;ct++)
-    {
-        elst[ct].ulAbsTime=0l; 
-        elst[ct].hpvAddress=NULL;
-        elst[ct].uwSize=0;
-    }
-
-        // now scan all alarm blocks to find the newest page and to
-        // fill-up alarm history table
-    hpvAlarmNextFree=NULL;
-    alarmabstime=0l;
-    for(ct=0;ct<ALARMSBLOCKCOUNT;ct++)
+        // if found in flash but not in ram
+    else if(clk_addr)
     {
-            // for each defined block
-        pagesize=(UWORD)(sAlarmsBlockDefs[ct].ulSize/STORAGEGRANULARITY);
-            // scan each block page
-        for(ctp=0;ctp<pagesize;ctp++)
-        {
-            found_addr=stor_addr=&(((HPUBYTE)sAlarmsBlockDefs[ct].hpvStart)[STORAGEGRANULARITY*ctp]);
-            stor_size=STORAGEGRANULARITY;
-
-            blkcode=blkstor_enumvalid(&stor_addr, &stor_size, &blk_addr);
-
-                // just first must be the right one
-            if(blkcode==DATACODE_SYSLOG_ALARMS)
-            {
-                if(blkstor_getdata(blk_addr,0,DATACODE_SYSLOG_ALARMS,&alrmlog,sizeof(alrmlog))>0)
-                {
-                    for(cti=0;cti<SYSLOGDATA_ALARMS_MAX_ENTRIES;cti++)
-                    {
-                            // if found NULL, then either is first entry or is the oldest
-                            // entry yet found
-                        if(elst[cti].hpvAddress==NULL)
-                        {
-                            elst[cti].ulAbsTime=alrmlog.ulAbsoluteTime;
-                            elst[cti].hpvAddress=found_addr;
-                            elst[cti].uwSize=(UWORD)(stor_size+(UWORD)((ULONG)stor_addr-(ULONG)blk_addr));
-                            break;
-                        }
-                        
-                            // if found an older entry than the actual one, then
-                            // move oldest entries
-                        if(elst[cti].ulAbsTime<alrmlog.ulAbsoluteTime)
-                        {
-                            for(cts=SYSLOGDATA_ALARMS_MAX_ENTRIES-1;cts>cti;cts--)
-                                elst[cts]=elst[cts-1];
-    
-                            elst[cti].ulAbsTime=alrmlog.ulAbsoluteTime;
-                            elst[cti].hpvAddress=blk_addr;
-                            elst[cti].uwSize=(UWORD)(stor_size+(UWORD)((ULONG)stor_addr-(ULONG)blk_addr));
-                            break;
-                        }
-    
-                            // if found an entry with same abstime then overwrite it
-                        if(elst[cti].ulAbsTime==alrmlog.ulAbsoluteTime)
-                        {
-                            elst[cti].ulAbsTime=alrmlog.ulAbsoluteTime;
-                            elst[cti].hpvAddress=blk_addr;
-                            elst[cti].uwSize=(UWORD)(stor_size+((ULONG)stor_addr-(ULONG)blk_addr));
-                            break;
-                        }
-                    }
-                    
-                    if(alrmlog.ulAbsoluteTime>alarmabstime)
-                    {
-                        alarmabstime=alrmlog.ulAbsoluteTime;
-                        hpvAlarmNextFree=found_addr;
-                    }
-                }
-            }
-        }
+            // restore data collections from latest clock log entry
+        assert(SysLogData_RestoreClockLogData(clk_addr, STORAGEGRANULARITY));
+        assert(PlcRetMgr_RestoreRetainData(clk_addr, STORAGEGRANULARITY));
     }
 
-        // set next free for the first time if NULL
-    if(hpvAlarmNextFree==NULL)
-        hpvAlarmNextFree=sAlarmsBlockDefs[0].hpvStart;
-
-        // set the newest page
-    if(!setnextfree(sAlarmsBlockDefs, ALARMSBLOCKCOUNT, &hpvAlarmNextFree))
-        bFlashStorageEnabled=FALSE;
-                
         // now fill-up the alarm data collection ram table
         // scan table from oldest to newer
     for(cti=SYSLOGDATA_ALARMS_MAX_ENTRIES-1;cti>=0;cti--)
@@ -408,6 +386,50 @@ BOOL SysLogMgm_Init(void)
                 elst[cti].uwSize-sizeof(alrmlog)));
         }
 
+    FlashQ_ReadUnlock();
+
+        // newest alarm
+    alarmabstime=elst[0].hpvAddress ? elst[0].ulAbsTime : 0l;
+
+    if(bFlashStorageEnabled)
+    {
+            // pin blocks holding previous format records newer than the ring
+            // ones, then move them into the ring, alarms from the oldest;
+            // blocks are unpinned as soon as their records are moved
+        if(clkmigrate)
+            SysLogRing_Pin(clk_addr);
+        for(cti=0;cti<SYSLOGDATA_ALARMS_MAX_ENTRIES;cti++)
+            if(elst[cti].hpvAddress && elst[cti].ulAbsTime>ringalarmtime)
+                SysLogRing_Pin(elst[cti].hpvAddress);
+
+        if(clkmigrate)
+            migraterecord(SYSLOGRING_CLOCK, clk_addr);
+
+        for(cti=SYSLOGDATA_ALARMS_MAX_ENTRIES-1;cti>=0;cti--)
+            if(elst[cti].hpvAddress && elst[cti].ulAbsTime>ringalarmtime)
+            {
+                    // if ring is full of pinned blocks the older alarms are
+                    // just in the ram table
+                if(!migraterecord(SYSLOGRING_ALARM, elst[cti].hpvAddress))
+                    break;
+
+                SysLogRing_UnpinAll();
+                for(cts=cti-1;cts>=0;cts--)
+                    if(elst[cts].hpvAddress && elst[cts].ulAbsTime>ringalarmtime)
+                        SysLogRing_Pin(elst[cts].hpvAddress);
+            }
+
+        SysLogRing_UnpinAll();
+
+            // wait first pages are prepared
+        if(!SysLogRing_WaitReady(SYSLOGRING_CLOCK) || !SysLogRing_WaitReady(SYSLOGRING_ALARM))
+            bFlashStorageEnabled=FALSE;
+    }
+
+        // power fail locations
+    hpvClockNextFree=SysLogRing_NextFree(SYSLOGRING_CLOCK);
+    hpvAlarmNextFree=SysLogRing_NextFree(SYSLOGRING_ALARM);
+
         // last set-up total power on time taking the maximum value between clock, alarm logs
         // and parameter saving
     if(alarmabstime>abstime)
@@ -440,57 +462,59 @@ BOOL SysLogMgm_Init(void)
 }
 
 //***************************************************************************
-// Prepare next location to store data
+// Insert alarm log entry into the list, sorted from the newest one; an
+// entry with same abstime is overwritten
 
-static BOOL setnextfree(const BLOCKDEFS * blkdefs, const UWORD blkcount, void  * * blkpointer)
+static void insertentry(ENTRYLIST * elst, ULONG ulAbsTime, HPVOID hpvAddress)
 {
-    UWORD blkidx;
-    ULONG blkptr;
-
-        // if flash storage disabled then exit as flash failure
-    if(!bFlashStorageEnabled)
-        return TRUE;
-
-        // actual pointer
-    blkptr=(ULONG)*blkpointer;
+    SWORD cti,cts;
 
-        // find the block in which lie the actual pointer
-    for(blkidx=0;blkidx<blkcount;blkidx++)
-        if(blkptr>=(ULONG)blkdefs[blkidx].hpvStart && blkptr<((ULONG)blkdefs[blkidx].hpvStart+blkdefs[blkidx].ulSize))
+    for(cti=0;cti<SYSLOGDATA_ALARMS_MAX_ENTRIES;cti++)
+    {
+            // if found NULL or an older entry than the actual one, then
+            // move oldest entries
+        if(elst[cti].hpvAddress==NULL || elst[cti].ulAbsTime<ulAbsTime)
+        {
+            for(cts=SYSLOGDATA_ALARMS_MAX_ENTRIES-1;cts>cti;cts--)
+                elst[cts]=elst[cts-1];
             break;
+        }
 
-    assert(blkidx<blkcount);
+            // if found an entry with same abstime then overwrite it
+        if(elst[cti].ulAbsTime==ulAbsTime)
+            break;
+    }
 
-    for(;;)
+    if(cti<SYSLOGDATA_ALARMS_MAX_ENTRIES)
     {
-            // try next
-        blkptr+=STORAGEGRANULARITY;
+        elst[cti].ulAbsTime=ulAbsTime;
+        elst[cti].hpvAddress=hpvAddress;
+        elst[cti].uwSize=STORAGEGRANULARITY;
+    }
+}
 
-            // if out of this block
-        if(blkptr>=((ULONG)blkdefs[blkidx].hpvStart+blkdefs[blkidx].ulSize))
-        {
-                // select next block
-            blkidx++;
-            if(blkidx>=blkcount)
-                blkidx=0;
-
-                // then erase it
-           if(ProgramFlashErase(blkdefs[blkidx].hpvStart, blkdefs[blkidx].ulSize))
-               return FALSE;
-
-                // and location is at beginning of this block
-            *blkpointer=blkdefs[blkidx].hpvStart;
-            return TRUE;
-        }
+//***************************************************************************
+// Copy a previous format record page into the ring, just at init as write
+// buffer is used and flash queue is served until completion
 
-            // check location is erased
-       if(ProgramFlashErasedCheck((HPVOID)blkptr, STORAGEGRANULARITY)==0)
-       {
-               // if yes location is found
-           *blkpointer=(HPVOID)blkptr;
-           return TRUE;
-       }
-    }
+static BOOL migraterecord(UWORD uwStream, HPVOID hpvPage)
+{
+    ULONG ulTicket;
+
+        // page is read through linear address space
+    FlashQ_ReadLock();
+    memcpy(ulClockWriteBuf, hpvPage, STORAGEGRANULARITY);
+    FlashQ_ReadUnlock();
+
+    if(!SysLogRing_WaitReady(uwStream))
+        return FALSE;
+
+    if(SysLogRing_Append(uwStream, ulClockWriteBuf, &ulTicket)!=SYSLOGRING_R_OK)
+        return FALSE;
+
+    FlashQ_Wait(ulTicket);
+
+    return TRUE;
 }
 
 //***************************************************************************
@@ -514,8 +538,9 @@ void SysLogMgm_PowerOnFail(void)
                 pfailsave=NULL;
     }
 
-        // if not booting and valid pointer
-    if(!bSysStatBooting && pfailsave)
+        // if not booting and valid pointers, the page is not available
+        // while its block is prepared
+    if(!bSysStatBooting && pfailsave && pfailsave->hpvDst)
     {
             // disable write protection
         SecurityFlashDisableWriteProtection( 0x55AA, 0xAA55 );
@@ -523,8 +548,11 @@ void SysLogMgm_PowerOnFail(void)
             // disable OS exclusive flash lock
         bProgramFlashCritSectBypass=TRUE;
 
-            // encode data
-        hpubWriteBuf=encodelogchunk(pfailsave->hpvSrc,NULL);
+            // encode data if needed
+        if(pfailsave->bEncoded)
+            hpubWriteBuf=pfailsave->hpvSrc;
+        else
+            hpubWriteBuf=encodelogchunk(pfailsave->hpvSrc,NULL,NULL);
 
             // write pre-prepared block
         ProgramFlashLoadWritePage((unsigned long)(pfailsave->hpvDst), (unsigned char *)hpubWriteBuf, STORAGEGRANULARITY);
@@ -538,22 +566,88 @@ void SysLogMgm_PowerOnFail(void)
 #endif
 }
 
+//***************************************************************************
+// Fill alarm log page and set it as power fail source if to be stored
+
+static void buildalarm(HPUBYTE hpubBuf, ULONG sysalarms, ULONG ulAlarmMask, ULONG ulAlarmSubCode, SBYTE bStore)
+{
+    HPUBYTE hpubBPtr=hpubBuf;
+    SWORD leftsize;
+    SYSLOGMGM_DATATMPIDENT  * psIdent;
+    SYSLOGMGM_ALARMLOG  * psAlarmLog;
+
+        // begin with alarm log, allocate space
+    psIdent=(SYSLOGMGM_DATATMPIDENT  *)hpubBPtr;
+    hpubBPtr=&hpubBPtr[sizeof(BLKSTOR_HEADER)];
+
+    psAlarmLog=(SYSLOGMGM_ALARMLOG  *)hpubBPtr;
+    hpubBPtr=&hpubBPtr[sizeof(SYSLOGMGM_ALARMLOG)];
+
+        // then fill up data
+    psIdent->swCode=DATACODE_SYSLOG_ALARMS;
+    psIdent->uwSize=sizeof(SYSLOGMGM_ALARMLOG);
+
+        // critical section for powerontime selection
+    DISABLE_IRQ();
+    if(ulAlarmLastTime<ulSysTimersTotalPowerOnTime)
+        ulAlarmLastTime=ulSysTimersTotalPowerOnTime;
+    else
+        ulAlarmLastTime++;
+    psAlarmLog->ulAbsoluteTime=ulAlarmLastTime;
+    RESTORE_IRQ();
+
+    psAlarmLog->ulActiveAlarms=sysalarms;
+    psAlarmLog->ulAlarm=ulAlarmMask;
+    psAlarmLog->ulAlarmSubCode=ulAlarmSubCode;
+
+        // now add system status data
+    leftsize=SysLogData_PostAlarmData(hpubBPtr, STORAGEGRANULARITY-sizeof(BLKSTOR_HEADER)-sizeof(SYSLOGMGM_ALARMLOG), ulAlarmMask);
+
+        // integrity check
+    assert(leftsize>=sizeof(SYSLOGMGM_DATATMPIDENT));
+
+        // then write termination at the end
+    psIdent=(SYSLOGMGM_DATATMPIDENT  *)&hpubBuf[STORAGEGRANULARITY-leftsize];
+    psIdent->swCode=DATACODE_SYSLOG_INVALID;
+    if(bStore)
+        psIdent->uwSize=POSTOPTIONS_NONE;
+    else
+        psIdent->uwSize=POSTOPTIONS_NOFLASHSTORE;
+
+        // critical section for updating pointer pairs for power fail, just
+        // if flash storage is requested
+    if(bStore)
+    {
+        DISABLE_IRQ();
+        if(psAlarmPowerFailSave==NULL)
+        {
+                // if was NULL then immediately set with this new alarm
+            uwAlarmPowerFailSaveSel=(uwAlarmPowerFailSaveSel>=POWERFAILSAVEELEMENTS-1 ? 0 : uwAlarmPowerFailSaveSel+1);
+            sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvSrc=hpubBuf;
+            sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvDst=hpvAlarmNextFree;
+            sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].bEncoded=FALSE;
+
+                // update here as power fail trap is NMI and can also break atomic sequences
+            psAlarmPowerFailSave=&sAlarmPowerFailSave[uwAlarmPowerFailSaveSel];
+        }
+        RESTORE_IRQ();
+    }
+}
+
 //***************************************************************************
 // Post new alarm; is taken in account that this function could be called
 // from everywhere (e.g. slow tasks, events, realtime, interrupts)
-// in case called from realtime task or interrupts with ILVL greater than
-// realtime task, it use one of the two pre-allocated area buffer for
-// storage in order to minimize time, otherwise rely on standard queue method 
+// in case called from realtime task, that is the only producer as not
+// preemptable, the alarm is built in place into a slot of the realtime
+// alarm ring, with no copy and no queue critical section; realtime task
+// is told by the realtime running flag at the scheduler interrupt level,
+// so interrupts nested into the realtime scheduler use the queue as the
+// other callers and if the ring is full
 
 void SysLogMgm_PostAlarm(ULONG ulAlarmMask, ULONG ulAlarmSubCode, SBYTE bStore)
 {
-    HPUBYTE hpubBuf=psAlarmQueue;
-    HPUBYTE hpubBPtr;
+    HPUBYTE hpubBuf;
     ULONG sysalarms;
-    SWORD leftsize;
-    SYSLOGMGM_DATATMPIDENT  * psIdent;
-    SYSLOGMGM_ALARMLOG  * psAlarmLog;
-//    ULONG ulAlarmElementCnt;
 
         // if fall in the disabled alarms category then exit immediately
     if(ulAlarmMask&ulDisabledAlarmMask)
@@ -574,137 +668,16 @@ void SysLogMgm_PostAlarm(ULONG ulAlarmMask, ULONG ulAlarmSubCode, SBYTE bStore)
         // if log manager enabled
     if(bSysLogManagerEnabled)
     {
-            // if it's to be stored try to use the fast buffers
-        if(bStore)
+            // realtime task, try the ring
+        if(bTaskSchedRealTimeRunning && Os_IsrNesting()==uwTaskSchedRTIsrNesting && (hpubBuf=(HPUBYTE)spscring_reserve(&sRTAlarmRing))!=NULL)
         {
-            UBYTE  * nubFastBuf;
-
-            nubFastBuf=NULL;
-//            if(_testset_(bRTPostAlarmValid0))
-//                nubFastBuf=nubRTPostAlarmArea0;
-//            else if(_testset_(bRTPostAlarmValid1))
-//                nubFastBuf=nubRTPostAlarmArea1;
-            
-            if(nubFastBuf)
-            {
-                register UBYTE  * nubFastBPtr=nubFastBuf;
-                register void  * pvAlarmLog;
-                void  * pvIdent;
-
-                    // begin with alarm log, allocate space
-                pvIdent=(void  *)nubFastBPtr;
-                nubFastBPtr=&nubFastBPtr[sizeof(BLKSTOR_HEADER)];
-        
-                pvAlarmLog=(void  *)nubFastBPtr;
-                nubFastBPtr=&nubFastBPtr[sizeof(SYSLOGMGM_ALARMLOG)];
-        
-                    // then fill up data
-                ((SYSLOGMGM_DATATMPIDENT *)pvIdent)->swCode=DATACODE_SYSLOG_ALARMS;
-                ((SYSLOGMGM_DATATMPIDENT *)pvIdent)->uwSize=sizeof(SYSLOGMGM_ALARMLOG);
-
-                    // critical section for powerontime selection
-                DISABLE_IRQ();
-                if(ulAlarmLastTime<ulSysTimersTotalPowerOnTime)
-                    ulAlarmLastTime=ulSysTimersTotalPowerOnTime;
-                else
-                    ulAlarmLastTime++;
-                ((SYSLOGMGM_ALARMLOG *)pvAlarmLog)->ulAbsoluteTime=ulAlarmLastTime;
-                RESTORE_IRQ();
-
-                ((SYSLOGMGM_ALARMLOG *)pvAlarmLog)->ulActiveAlarms=sysalarms;
-                ((SYSLOGMGM_ALARMLOG *)pvAlarmLog)->ulAlarm=ulAlarmMask;
-                ((SYSLOGMGM_ALARMLOG *)pvAlarmLog)->ulAlarmSubCode=ulAlarmSubCode;
-
-                    // now add system status data
-                leftsize=SysLogData_PostAlarmData(nubFastBPtr, STORAGEGRANULARITY-sizeof(BLKSTOR_HEADER)-sizeof(SYSLOGMGM_ALARMLOG), ulAlarmMask);
-
-                    // integrity check
-                assert(leftsize>=sizeof(SYSLOGMGM_DATATMPIDENT));
-
-                    // then write termination at the end
-                pvIdent=((void  *)(&nubFastBuf[STORAGEGRANULARITY-leftsize]));
-                ((SYSLOGMGM_DATATMPIDENT *)pvIdent)->swCode=DATACODE_SYSLOG_INVALID;
-                ((SYSLOGMGM_DATATMPIDENT *)pvIdent)->uwSize=POSTOPTIONS_NONE;
-
-                    // critical section for updating pointer pairs for power fail
-                DISABLE_IRQ();
-                if(psAlarmPowerFailSave==NULL)
-                {
-                        // if was NULL then immediately set with this new alarm
-                    uwAlarmPowerFailSaveSel=(uwAlarmPowerFailSaveSel>=POWERFAILSAVEELEMENTS-1 ? uwAlarmPowerFailSaveSel+1 : 0);
-                    sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvSrc=nubFastBuf;
-                    sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvDst=hpvAlarmNextFree;
-
-                        // update here as power fail trap is NMI and can also break atomic sequences
-                    psAlarmPowerFailSave=&sAlarmPowerFailSave[uwAlarmPowerFailSaveSel];
-                }
-                RESTORE_IRQ();
-
-                return;
-            }
+            buildalarm(hpubBuf, sysalarms, ulAlarmMask, ulAlarmSubCode, bStore);
+            spscring_commit(&sRTAlarmRing);
         }
-
-            // get an empty element to fill (if ILVL less than realtime ILVL or
-            // fast area are yet full), if not found bypass storage
-//        if(Os_QueueGet(SysLogMgm_AlrmAvailableElements,&ulAlarmElementCnt,0))
+        else
         {
-            hpubBPtr=hpubBuf;
-
-                // begin with alarm log, allocate space
-            psIdent=(SYSLOGMGM_DATATMPIDENT  *)hpubBPtr;
-            hpubBPtr=&hpubBPtr[sizeof(BLKSTOR_HEADER)];
-
-            psAlarmLog=(SYSLOGMGM_ALARMLOG  *)hpubBPtr;
-            hpubBPtr=&hpubBPtr[sizeof(SYSLOGMGM_ALARMLOG)];
-
-                // then fill up data
-            psIdent->swCode=DATACODE_SYSLOG_ALARMS;
-            psIdent->uwSize=sizeof(SYSLOGMGM_ALARMLOG);
-
-                // critical section for powerontime selection
-            DISABLE_IRQ();
-            if(ulAlarmLastTime<ulSysTimersTotalPowerOnTime)
-                ulAlarmLastTime=ulSysTimersTotalPowerOnTime;
-            else
-                ulAlarmLastTime++;
-            psAlarmLog->ulAbsoluteTime=ulAlarmLastTime;
-            RESTORE_IRQ();
-
-            psAlarmLog->ulActiveAlarms=sysalarms;
-            psAlarmLog->ulAlarm=ulAlarmMask;
-            psAlarmLog->ulAlarmSubCode=ulAlarmSubCode;
-
-                // now add system status data
-            leftsize=SysLogData_PostAlarmData(hpubBPtr, STORAGEGRANULARITY-sizeof(BLKSTOR_HEADER)-sizeof(SYSLOGMGM_ALARMLOG), ulAlarmMask);
-
-                // integrity check
-            assert(leftsize>=sizeof(SYSLOGMGM_DATATMPIDENT));
-
-                // then write termination at the end
-            psIdent=(SYSLOGMGM_DATATMPIDENT  *)&hpubBuf[STORAGEGRANULARITY-leftsize];
-            psIdent->swCode=DATACODE_SYSLOG_INVALID;
-            if(bStore)
-                psIdent->uwSize=POSTOPTIONS_NONE;
-            else
-                psIdent->uwSize=POSTOPTIONS_NOFLASHSTORE;
-
-                // critical section for updating pointer pairs for power fail, just
-                // if flash storage is requested
-            if(bStore)
-            {
-                DISABLE_IRQ();
-                if(psAlarmPowerFailSave==NULL)
-                {
-                        // if was NULL then immediately set with this new alarm
-                    uwAlarmPowerFailSaveSel=(uwAlarmPowerFailSaveSel>=POWERFAILSAVEELEMENTS-1 ? uwAlarmPowerFailSaveSel+1 : 0);
-                    sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvSrc=hpubBuf;
-                    sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvDst=hpvAlarmNextFree;
-
-                        // update here as power fail trap is NMI and can also break atomic sequences
-                    psAlarmPowerFailSave=&sAlarmPowerFailSave[uwAlarmPowerFailSaveSel];
-                }
-                RESTORE_IRQ();
-            }
+            hpubBuf=psAlarmQueue;
+            buildalarm(hpubBuf, sysalarms, ulAlarmMask, ulAlarmSubCode, bStore);
 
                 // post alarm in the queue
             Os_QueuePost(SysLogMgm_AlarmQueue, (HPULONG)hpubBuf);
@@ -752,7 +725,73 @@ void SysLogMgm_SetDisableAlarmMask(ULONG ulAlarmMask, UWORD uwKey)
 }
 
 //***************************************************************************
-// Slow task
+// Power fail save of the alarms: the oldest one not yet written, at its
+// queued page or at the next free one
+
+static void setalarmpowerfail(void)
+{
+    PENDINGALARM * psPending;
+
+        // if no alarms to write leave just the one set by post alarm, if
+        // not yet taken by slow task
+    if(uwAlarmPendingCount==0)
+    {
+        if((spscring_peek(&sRTAlarmRing)==NULL && Os_QueueStatus(SysLogMgm_AlarmQueue)!=OS_QUEUESTATUS_VALID) || \
+            (psAlarmPowerFailSave && psAlarmPowerFailSave->bEncoded))
+            psAlarmPowerFailSave=NULL;
+        return;
+    }
+
+    psPending=&sAlarmPending[uwAlarmPendingFirst];
+
+    uwAlarmPowerFailSaveSel=(uwAlarmPowerFailSaveSel>=POWERFAILSAVEELEMENTS-1 ? 0 : uwAlarmPowerFailSaveSel+1);
+    sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvSrc=psPending->ulPage;
+    sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvDst=psPending->hpvDst ? psPending->hpvDst : hpvAlarmNextFree;
+    sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].bEncoded=TRUE;
+
+        // update here as power fail trap is NMI and can break also atomic sequences
+    psAlarmPowerFailSave=&sAlarmPowerFailSave[uwAlarmPowerFailSaveSel];
+}
+
+//***************************************************************************
+// Power fail save of the clock: the selected element, at the next free page
+
+static void setclockpowerfail(void)
+{
+    UWORD sel=uwClockPowerFailSaveSel;
+
+        // update crc of the block in order that if reset is generated by external button
+        // and/or software reset this could recover system timer; this is used also by
+        // power fail trap to double check data consistency
+    puwClockElemCrc[sel]=crc16(CRCINITIALSEED, psClockSave[sel], STORAGEGRANULARITY);
+
+    sClockPowerFailSave[sel].hpvSrc=psClockSave[sel];
+    sClockPowerFailSave[sel].hpvDst=hpvClockNextFree;
+    sClockPowerFailSave[sel].uwCrc=puwClockElemCrc[sel];
+    sClockPowerFailSave[sel].bEncoded=FALSE;
+
+        // update here as power fail trap is NMI and can also break atomic sequences
+    psClockPowerFailSave=&sClockPowerFailSave[sel];
+}
+
+//***************************************************************************
+// Flash failed writing a record or preparing a sector: flash storage is
+// disabled, history goes on in the ram table
+
+static void storagefailed(void)
+{
+    if(!bFlashStorageEnabled)
+        return;
+
+    bFlashStorageEnabled=FALSE;
+
+    SysLogMgm_PostAlarm(SYSTEMALARMS_BIT_HW_FLASH_FAIL, SYSTEMALARMS_SUBCODE_HF_FLASH_SYSLOG, FALSE);
+}
+
+//***************************************************************************
+// Slow task; alarms and clock are written through the flash queue, so an
+// alarm storm is taken at once into the pending alarms and written behind,
+// without blocking the task
 
 static void slowtask(void)
 {
@@ -764,84 +803,48 @@ static void slowtask(void)
     SYSLOGMGM_DATATMPIDENT  * psIdent;
     SYSLOGMGM_CLOCKLOG  * psClockLog;
     SWORD leftsize;
-    POWERFAILSAVE  * psactualpsfail;
-    BOOL bfastarea0=FALSE,bfastarea1=FALSE;
+    PENDINGALARM * psPending;
+    HPUBYTE hpubRTBuf;
     UWORD uwPostOptions;
     UBYTE alarmqueue[STORAGEGRANULARITY];
 
         // get actual clock
     atomic_read(&clockread, (HPULONG)&ulSysTimersTotalPowerOnTime, sizeof(ulSysTimersTotalPowerOnTime));
 
-        // check if new alarm has posted and not yet saved
-    if(Os_QueueStatus(SysLogMgm_AlarmQueue)==OS_QUEUESTATUS_VALID
-            || (bRTPostAlarmValid0 && !bSavedRTAlarm0) || (bRTPostAlarmValid1 && !bSavedRTAlarm1)
-            )
+        // take all posted alarms, realtime ring first, while there's room
+        // for them to be written
+    while(uwAlarmPendingCount<ALARMPENDINGSIZE)
     {
-            // get element from one of the sources
-        if(bRTPostAlarmValid0 && !bSavedRTAlarm0)
-        {
-            bfastarea0=TRUE;
-            hpubBuf=nubRTPostAlarmArea0;
-        }
-        else if(bRTPostAlarmValid1 && !bSavedRTAlarm1)
-        {
-            bfastarea1=TRUE;
-            hpubBuf=nubRTPostAlarmArea1;
-        }
-        else
+            // get element from one of the sources, ring slot used in place
+        hpubRTBuf=(HPUBYTE)spscring_peek(&sRTAlarmRing);
+        if(hpubRTBuf!=NULL)
+            hpubBuf=hpubRTBuf;
+        else if(Os_QueueStatus(SysLogMgm_AlarmQueue)==OS_QUEUESTATUS_VALID)
         {
         	hpubBuf = alarmqueue;
             Os_QueueGet(SysLogMgm_AlarmQueue,(ULONG *)hpubBuf,0);
         }
+        else
+            break;
 
-            // encode data
-        hpubWriteBuf=encodelogchunk(hpubBuf,&uwPostOptions);
+            // encode data into the next pending element
+        psPending=&sAlarmPending[(uwAlarmPendingFirst+uwAlarmPendingCount)%ALARMPENDINGSIZE];
+        hpubWriteBuf=encodelogchunk(hpubBuf,(HPUBYTE)psPending->ulPage,&uwPostOptions);
 
             // check if save into flash is not requested (no history)
-        if(uwPostOptions!=POSTOPTIONS_NOFLASHSTORE)
+        if(uwPostOptions!=POSTOPTIONS_NOFLASHSTORE && bFlashStorageEnabled)
         {
-                // save actual page pointer
-            hpflashptr=hpvAlarmNextFree;
-
-                // and prepare new one
-            if(!setnextfree(sAlarmsBlockDefs, ALARMSBLOCKCOUNT, &hpvAlarmNextFree) && bFlashStorageEnabled)
-            {
-                bFlashStorageEnabled=FALSE;
-                SysLogMgm_PostAlarm(SYSTEMALARMS_BIT_HW_FLASH_FAIL, SYSTEMALARMS_SUBCODE_HF_FLASH_SYSLOG, FALSE);
-            }
-
-                // no critical section here as, if here then there's at last one alarm in the queue,
-                // then psAlarmPowerFailSave is not NULL as set by first SysLogMgm_PostAlarm call
-                // subsequent SysLogMgm_PostAlarm see psAlarmPowerFailSave not NULL then do nothing
-            uwAlarmPowerFailSaveSel=(uwAlarmPowerFailSaveSel>=POWERFAILSAVEELEMENTS-1 ? uwAlarmPowerFailSaveSel+1 : 0);
+            psPending->hpvDst=NULL;
+            uwAlarmPendingCount++;
 
-                // prepare for saving same element but at next location, in case flash writing is
-                // interrupted by power fail
-            sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvSrc=hpubBuf;
-            sAlarmPowerFailSave[uwAlarmPowerFailSaveSel].hpvDst=hpvAlarmNextFree;
-
-                // update here as power fail trap is NMI and can break also atomic sequences
-            psAlarmPowerFailSave=&sAlarmPowerFailSave[uwAlarmPowerFailSaveSel];
-
-                // now can write flash
-            if(bFlashStorageEnabled)
-                if(ProgramFlashLoadWritePage((unsigned long)hpflashptr, (unsigned char *)hpubWriteBuf, STORAGEGRANULARITY))
-                {
-                    bFlashStorageEnabled=FALSE;
-                    SysLogMgm_PostAlarm(SYSTEMALARMS_BIT_HW_FLASH_FAIL, SYSTEMALARMS_SUBCODE_HF_FLASH_SYSLOG, FALSE);
-                }
-
-                // now alarm entry is safely written in flash, leave psAlarmPowerFailSave untouched
-                // in order to not change sequence of written alarms, in the worst case the first alarm
-                // is safely saved, then itself or the following ones are written twice, this case is
-                // detected by inititialization
+                // from now power fail saves the pending element, before the
+                // posted one is given back
+            setalarmpowerfail();
         }
 
-            // signal saved fast areas
-        if(bfastarea0)
-            bSavedRTAlarm0=TRUE;
-        else if(bfastarea1)
-            bSavedRTAlarm1=TRUE;
+            // give back ring slot
+        if(hpubRTBuf!=NULL)
+            spscring_release(&sRTAlarmRing);
 //        else
 //            Os_QueuePost(SysLogMgm_AlrmAvailableElements, (ULONG)&hpubBuf);
 
@@ -852,133 +855,160 @@ static void slowtask(void)
             // update save clock checkpoint as alarm has clock that is also used at startup
         ulClockLastSavedTime=clockread;
     }
-    else
+
+        // queue pending alarms to the flash, in order, while next pages are
+        // available
+    while(bFlashStorageEnabled && uwAlarmPendingQueued<uwAlarmPendingCount)
     {
-            // if here no alarms in the queue
-        psAlarmPowerFailSave=NULL;
+        psPending=&sAlarmPending[(uwAlarmPendingFirst+uwAlarmPendingQueued)%ALARMPENDINGSIZE];
 
-            // release fast areas
-        if(bSavedRTAlarm0)
-            bSavedRTAlarm0=bRTPostAlarmValid0=FALSE;
-        if(bSavedRTAlarm1)
-            bSavedRTAlarm1=bRTPostAlarmValid1=FALSE;
+        hpflashptr=SysLogRing_NextFree(SYSLOGRING_ALARM);
+        if(hpflashptr==NULL || SysLogRing_Append(SYSLOGRING_ALARM, psPending->ulPage, &psPending->ulTicket)!=SYSLOGRING_R_OK)
+            break;
 
-            // if more than previous prepare new data for power fail
-        if(clockread>ulClockLastTime)
-        {
-                // get next location for safe data collection
-            uwClockPowerFailSaveSel=uwClockPowerFailSaveSel>=POWERFAILSAVEELEMENTS-1 ? 0 : uwClockPowerFailSaveSel+1;
-            hpubWriteBuf=(HPUBYTE)&psClockSave[uwClockPowerFailSaveSel];
-            leftsize=STORAGEGRANULARITY;
+        psPending->hpvDst=hpflashptr;
+        uwAlarmPendingQueued++;
+    }
 
-                // begin with clock log, allocate space
-            psIdent=(SYSLOGMGM_DATATMPIDENT  *)hpubWriteBuf;
-            leftsize-=sizeof(BLKSTOR_HEADER);
+        // give back the written ones; if power fails meanwhile the first
+        // one not written is saved again at its page, then itself or the
+        // following ones could be written twice, this case is detected by
+        // inititialization
+    while(uwAlarmPendingQueued && FlashQ_IsDone(sAlarmPending[uwAlarmPendingFirst].ulTicket))
+    {
+        if(FlashQ_Result(sAlarmPending[uwAlarmPendingFirst].ulTicket)==FLASHQ_R_FLASHFAIL)
+            storagefailed();
 
-            psClockLog=(SYSLOGMGM_CLOCKLOG  *)&hpubWriteBuf[STORAGEGRANULARITY-leftsize];
-            leftsize-=sizeof(SYSLOGMGM_CLOCKLOG);
+        uwAlarmPendingFirst=(uwAlarmPendingFirst+1)%ALARMPENDINGSIZE;
+        uwAlarmPendingCount--;
+        uwAlarmPendingQueued--;
+    }
 
-                // then fill up data
-            psIdent->swCode=DATACODE_SYSLOG_CLOCK;
-            psIdent->uwSize=sizeof(SYSLOGMGM_CLOCKLOG);
+        // storage failed, alarms not yet queued are just in the ram table
+    if(!bFlashStorageEnabled && uwAlarmPendingQueued==0)
+        uwAlarmPendingCount=0;
 
-            psClockLog->ulAbsoluteTime=clockread;
+        // if more than previous prepare new data for power fail
+    if(clockread>ulClockLastTime)
+    {
+            // get next location for safe data collection
+        uwClockPowerFailSaveSel=uwClockPowerFailSaveSel>=POWERFAILSAVEELEMENTS-1 ? 0 : uwClockPowerFailSaveSel+1;
+        hpubWriteBuf=(HPUBYTE)&psClockSave[uwClockPowerFailSaveSel];
+        leftsize=STORAGEGRANULARITY;
 
-                // now add system status data
-            leftsize=SysLogData_PostClockData(&hpubWriteBuf[STORAGEGRANULARITY-leftsize], leftsize);
+            // begin with clock log, allocate space
+        psIdent=(SYSLOGMGM_DATATMPIDENT  *)hpubWriteBuf;
+        leftsize-=sizeof(BLKSTOR_HEADER);
 
-                // and plc retain data
-            leftsize=PlcRetMgr_PostClockData(&hpubWriteBuf[STORAGEGRANULARITY-leftsize], leftsize);
+        psClockLog=(SYSLOGMGM_CLOCKLOG  *)&hpubWriteBuf[STORAGEGRANULARITY-leftsize];
+        leftsize-=sizeof(SYSLOGMGM_CLOCKLOG);
 
-                // integrity check
-            assert(leftsize>=sizeof(SYSLOGMGM_DATATMPIDENT));
+            // then fill up data
+        psIdent->swCode=DATACODE_SYSLOG_CLOCK;
+        psIdent->uwSize=sizeof(SYSLOGMGM_CLOCKLOG);
 
-                // then write termination at the end
-            psIdent=(SYSLOGMGM_DATATMPIDENT  *)&hpubWriteBuf[STORAGEGRANULARITY-leftsize];
-            psIdent->swCode=DATACODE_SYSLOG_INVALID;
+        psClockLog->ulAbsoluteTime=clockread;
 
-                // now update pointer pairs for power fail
-            sClockPowerFailSave[uwClockPowerFailSaveSel].hpvSrc=hpubWriteBuf;
-            sClockPowerFailSave[uwClockPowerFailSaveSel].hpvDst=hpvClockNextFree;
+            // now add system status data
+        leftsize=SysLogData_PostClockData(&hpubWriteBuf[STORAGEGRANULARITY-leftsize], leftsize);
 
-                // update crc of the block in order that if reset is generated by external button
-                // and/or software reset this could recover system timer; this is used also by
-                // power fail trap to double check data consistency
-            puwClockElemCrc[uwClockPowerFailSaveSel]=crc16(CRCINITIALSEED, hpubWriteBuf, STORAGEGRANULARITY);
-            sClockPowerFailSave[uwClockPowerFailSaveSel].uwCrc=puwClockElemCrc[uwClockPowerFailSaveSel];
+            // and plc retain data
+        leftsize=PlcRetMgr_PostClockData(&hpubWriteBuf[STORAGEGRANULARITY-leftsize], leftsize);
 
-                // update here as power fail trap is NMI and can also break atomic sequences
-            psClockPowerFailSave=&sClockPowerFailSave[uwClockPowerFailSaveSel];
+            // integrity check
+        assert(leftsize>=sizeof(SYSLOGMGM_DATATMPIDENT));
 
-                // update clock checkpoint
-            ulClockLastTime=clockread;
-        }
+            // then write termination at the end
+        psIdent=(SYSLOGMGM_DATATMPIDENT  *)&hpubWriteBuf[STORAGEGRANULARITY-leftsize];
+        psIdent->swCode=DATACODE_SYSLOG_INVALID;
 
-            // if last time since clock has written to flash (taking in account also alarms)
-            // is more than SAVECLOCKEVERYNSECONDS or syslog flush has requested
-            // then force write
-        if(clockread-ulClockLastSavedTime > SAVECLOCKEVERYNSECONDS || bSysStatSysLogFlush)
-        {
-                // get next location for safe data collection
-            uwClockPowerFailSaveSel=uwClockPowerFailSaveSel>=POWERFAILSAVEELEMENTS-1 ? 0 : uwClockPowerFailSaveSel+1;
-            hpubBuf=(HPUBYTE)&psClockSave[uwClockPowerFailSaveSel];
+            // now update pointer pairs for power fail
+        setclockpowerfail();
+
+            // update clock checkpoint
+        ulClockLastTime=clockread;
+    }
 
-                // then copy actual one
-            memcpy(hpubBuf, psClockPowerFailSave->hpvSrc, STORAGEGRANULARITY);
+        // if last time since clock has written to flash (taking in account also alarms)
+        // is more than SAVECLOCKEVERYNSECONDS or syslog flush has requested
+        // then force write, one at a time
+    if(clockread-ulClockLastSavedTime > SAVECLOCKEVERYNSECONDS || bSysStatSysLogFlush)
+    {
+        if(!bFlashStorageEnabled)
+        {
+            ulClockLastSavedTime=clockread;
+            bSysStatSysLogFlush=FALSE;
+        }
+        else if(!bClockWriteQueued && psClockPowerFailSave && hpvClockNextFree)
+        {
+                // encode actual one into write buffer, then queue it
+            encodelogchunk(psClockPowerFailSave->hpvSrc,(HPUBYTE)ulClockWriteBuf,NULL);
 
-                // and prepare new one
-            if(!setnextfree(sClockBlockDefs, CLOCKBLOCKCOUNT, &hpvClockNextFree) && bFlashStorageEnabled)
+            if(SysLogRing_Append(SYSLOGRING_CLOCK, ulClockWriteBuf, &ulClockWriteTicket)==SYSLOGRING_R_OK)
             {
-                bFlashStorageEnabled=FALSE;
-                SysLogMgm_PostAlarm(SYSTEMALARMS_BIT_HW_FLASH_FAIL, SYSTEMALARMS_SUBCODE_HF_FLASH_SYSLOG, FALSE);
-            }
+                bClockWriteQueued=TRUE;
+                bClockWriteFlush=bSysStatSysLogFlush;
 
-                // now update pointer pairs for power fail
-            sClockPowerFailSave[uwClockPowerFailSaveSel].hpvSrc=hpubBuf;
-            sClockPowerFailSave[uwClockPowerFailSaveSel].hpvDst=hpvClockNextFree;
+                    // update clock checkpoint
+                ulClockLastSavedTime=clockread;
+            }
+        }
+    }
 
-                // update crc of the block in order that if reset is generated by external button
-                // and/or software reset this could recover system timer; this is used also by
-                // power fail trap to double check data consistency
-            puwClockElemCrc[uwClockPowerFailSaveSel]=crc16(CRCINITIALSEED, hpubBuf, STORAGEGRANULARITY);
-            sClockPowerFailSave[uwClockPowerFailSaveSel].uwCrc=puwClockElemCrc[uwClockPowerFailSaveSel];
+        // clock written
+    if(bClockWriteQueued && FlashQ_IsDone(ulClockWriteTicket))
+    {
+        bClockWriteQueued=FALSE;
 
-                // keep actual one
-            psactualpsfail=psClockPowerFailSave;
+        if(FlashQ_Result(ulClockWriteTicket)==FLASHQ_R_FLASHFAIL)
+            storagefailed();
 
-                // update here as power fail trap is NMI and can also break atomic sequences
-            psClockPowerFailSave=&sClockPowerFailSave[uwClockPowerFailSaveSel];
+            // if here alarm queue and clock are safely written in flash
+        if(bClockWriteFlush && uwAlarmPendingCount==0)
+            bSysStatSysLogFlush=FALSE;
+    }
 
-                // now encode data
-            hpubWriteBuf=encodelogchunk(psactualpsfail->hpvSrc,NULL);
+        // ring background step
+    SysLogRing_Tick();
+    if(SysLogRing_Failed())
+        storagefailed();
 
-                // now can write flash
-            if(bFlashStorageEnabled)
-                if(ProgramFlashLoadWritePage((unsigned long)psactualpsfail->hpvDst, (unsigned char *)hpubWriteBuf, STORAGEGRANULARITY))
-                {
-                    bFlashStorageEnabled=FALSE;
-                    SysLogMgm_PostAlarm(SYSTEMALARMS_BIT_HW_FLASH_FAIL, SYSTEMALARMS_SUBCODE_HF_FLASH_SYSLOG, FALSE);
-                }
+        // follow next free pages for power fail; until the new clock page
+        // is published the old one is written with same data; none if
+        // storage failed
+    hpflashptr=bFlashStorageEnabled ? SysLogRing_NextFree(SYSLOGRING_CLOCK) : NULL;
+    if(hpflashptr!=hpvClockNextFree)
+    {
+        hpvClockNextFree=hpflashptr;
 
-                // update clock checkpoint
-            ulClockLastSavedTime=clockread;
+        if(psClockPowerFailSave)
+        {
+                // get next location for safe data collection, then copy actual one
+            uwClockPowerFailSaveSel=uwClockPowerFailSaveSel>=POWERFAILSAVEELEMENTS-1 ? 0 : uwClockPowerFailSaveSel+1;
+            memcpy(psClockSave[uwClockPowerFailSaveSel], psClockPowerFailSave->hpvSrc, STORAGEGRANULARITY);
 
-                // if here alarm queue and clock are safely written in flash
-            bSysStatSysLogFlush=FALSE;
+            setclockpowerfail();
         }
     }
+
+    hpvAlarmNextFree=bFlashStorageEnabled ? SysLogRing_NextFree(SYSLOGRING_ALARM) : NULL;
+    setalarmpowerfail();
 }
 
 //***************************************************************************
 // Take one posted log element, then encode it with blockstorage in order
-// to write it into flash; it allocate and return a static buffer, as
-// system guaranteed no more than one buffer per time is written into flash
+// to write it into flash; if destination is NULL it uses a static buffer,
+// as system guaranteed no more than one buffer per time is encoded there
 
-static HPUBYTE encodelogchunk(HPUBYTE hpubBuf, UWORD * puwPostOptions)
+static HPUBYTE encodelogchunk(HPUBYTE hpubBuf, HPUBYTE hpubDest, UWORD * puwPostOptions)
 {
     static UBYTE  destbuf[STORAGEGRANULARITY];
     SYSLOGMGM_DATATMPIDENT  * psIdent;
-    HPUBYTE bufptr=destbuf;
+    HPUBYTE bufptr;
+
+    if(hpubDest==NULL)
+        hpubDest=destbuf;
+    bufptr=hpubDest;
 
     while(((SYSLOGMGM_DATATMPIDENT  *)hpubBuf)->swCode != DATACODE_SYSLOG_INVALID)
     {
@@ -999,5 +1029,106 @@ static HPUBYTE encodelogchunk(HPUBYTE hpubBuf, UWORD * puwPostOptions)
     if(puwPostOptions)
         *puwPostOptions=((SYSLOGMGM_DATATMPIDENT  *)hpubBuf)->uwSize;
 
-    return destbuf;
+    return hpubDest;
+}
+
+//***************************************************************************
+// Encode realtime trace ring as block storage records, oldest tick first,
+// into the dump area; return encoded size
+
+static UWORD encodertrace(void)
+{
+    HPUBYTE bufptr=(HPUBYTE)ulRTTraceDump;
+    SYSLOGMGM_RTTRACELOG  * psLog;
+    SWORD ct;
+
+        // info record
+    psLog=(SYSLOGMGM_RTTRACELOG  *)&bufptr[sizeof(BLKSTOR_HEADER)];
+    psLog->ulAbsoluteTime=sTaskSchedRTTrace.ulAbsoluteTime;
+    psLog->ulFreezeCnt=sTaskSchedRTTrace.ulFreezeCnt;
+    psLog->uwReason=sTaskSchedRTTrace.uwReason;
+    psLog->uwTasks=sTaskSchedRTTrace.uwTasks;
+    psLog->uwTicks=0;
+    psLog->uwTickSize=sizeof(TASKSCHEDULER_RT_TRACE_TICK);
+    bufptr=&bufptr[sizeof(BLKSTOR_HEADER)+sizeof(SYSLOGMGM_RTTRACELOG)];
+
+        // then ticks, just the recorded ones
+    for(ct=TASKSCHEDULER_RT_TRACE_TICKS-1;ct>=0;ct--)
+        if(TaskSched_RTTraceGet((UWORD)ct, (TASKSCHEDULER_RT_TRACE_TICK  *)&bufptr[sizeof(BLKSTOR_HEADER)]))
+        {
+            assert(blkstor_createheader(DATACODE_SYSLOG_RT_TRACE_TICK, &bufptr[sizeof(BLKSTOR_HEADER)], sizeof(TASKSCHEDULER_RT_TRACE_TICK), (BLKSTOR_HEADER  *)bufptr)>=0);
+            bufptr=&bufptr[sizeof(BLKSTOR_HEADER)+sizeof(TASKSCHEDULER_RT_TRACE_TICK)];
+            psLog->uwTicks++;
+        }
+
+        // info header last, as ticks count is known only now
+    assert(blkstor_createheader(DATACODE_SYSLOG_RT_TRACE, psLog, sizeof(SYSLOGMGM_RTTRACELOG), (BLKSTOR_HEADER  *)ulRTTraceDump)>=0);
+
+    return (UWORD)((ULONG)bufptr-(ULONG)ulRTTraceDump);
+}
+
+//***************************************************************************
+// Hook for realtime trace dump, read is a sequence of block storage records
+// (element is the offset in words), any write rearms the trace
+
+UWORD SysLogMgm_RTTraceHook(COMMONPARAMDB_ENTRY * psEntry, UWORD uwFlags, UWORD uwElement, HPVOID hpvBuffer, UWORD * puwBufSize, HPULONG hpulContext)
+{
+    UWORD uwSize;
+
+        // if abort do nothing
+    if(uwFlags&COMMONPARAMDB_CBFLAG_ABORT)
+        return COMMONPARAMDB_CH_OK;
+
+        // check element access
+    if(uwElement>=SYSLOGMGM_RTTRACE_DUMPSIZE/sizeof(UWORD))
+        return COMMONPARAMDB_CH_INVALID_ELEMENT;
+
+        // if data read
+    if(uwFlags&COMMONPARAMDB_CBFLAG_RD)
+    {
+        if(uwFlags&COMMONPARAMDB_CBFLAG_INIT)
+        {
+                // take a new snapshot on each read starting from beginning
+            if(uwElement==0 || uwRTTraceDumpSize==0)
+                uwRTTraceDumpSize=encodertrace();
+
+                // left data size
+            if(uwElement*sizeof(UWORD)>=uwRTTraceDumpSize)
+                return COMMONPARAMDB_CH_INVALID_ELEMENT;
+            *hpulContext=uwRTTraceDumpSize-uwElement*sizeof(UWORD);
+
+                // data size if requested
+            if(uwFlags&COMMONPARAMDB_CBFLAG_SIZEINQUIRY)
+            {
+                *((HPULONG)hpvBuffer)=*hpulContext;
+                *puwBufSize=sizeof(ULONG);
+            }
+        }
+        else if(uwFlags&COMMONPARAMDB_CBFLAG_SEGMENT)
+        {
+                // data size left
+            uwSize=(UWORD)*hpulContext;
+            if(uwSize>*puwBufSize)
+                uwSize=*puwBufSize;
+
+                // copy data chunk
+            memcpy(hpvBuffer, &((HPUBYTE)ulRTTraceDump)[uwRTTraceDumpSize-*hpulContext], uwSize);
+
+                // update data out buffer size and left size
+            *puwBufSize=uwSize;
+            *hpulContext=*hpulContext-(ULONG)uwSize;
+        }
+    }
+
+        // if data write, rearm trace
+    if(uwFlags&COMMONPARAMDB_CBFLAG_WR)
+    {
+        if(uwElement)
+            return COMMONPARAMDB_CH_NO_WRITE_ACCESS;
+
+        if(uwFlags&COMMONPARAMDB_CBFLAG_SEGMENT)
+            TaskSched_RTTraceRearm();
+    }
+
+    return COMMONPARAMDB_CH_OK;
 }
@@ -14,12 +14,19 @@
 #define _SYSLOGMANAGEMENT_H
 
 #include "common\CommonDefines.h"
+#include "common\CommonParamDB.h"
+#include "common\TaskScheduler.h"
+#include "common\BlockStorage.h"
 
 //***************************************************************************
 // Defines
 
 #define SYSLOGMGM_DISALM_KEY        0xE9A4
 
+    // realtime trace dump, info record followed by one record per tick
+#define SYSLOGMGM_RTTRACE_DUMPSIZE  (sizeof(BLKSTOR_HEADER)+sizeof(SYSLOGMGM_RTTRACELOG)+ \
+                                     (sizeof(BLKSTOR_HEADER)+sizeof(TASKSCHEDULER_RT_TRACE_TICK))*TASKSCHEDULER_RT_TRACE_TICKS)
+
 //***************************************************************************
 // Data structure
 
@@ -36,6 +43,16 @@ typedef struct
     ULONG ulAbsoluteTime;
 } SYSLOGMGM_CLOCKLOG;
 
+typedef struct
+{
+    ULONG ulAbsoluteTime;
+    ULONG ulFreezeCnt;
+    UWORD uwReason;
+    UWORD uwTasks;
+    UWORD uwTicks;
+    UWORD uwTickSize;
+} SYSLOGMGM_RTTRACELOG;
+
 typedef struct
 {
 	SWORD swCode;
@@ -57,4 +74,8 @@ void SysLogMgm_ClearAlarmMask(ULONG ulAlarmMask);
 
 void SysLogMgm_SetDisableAlarmMask(ULONG ulAlarmMask, UWORD uwKey);
 
+    // realtime trace dump as block storage records (DATACODE_SYSLOG_RT_TRACE
+    // followed by DATACODE_SYSLOG_RT_TRACE_TICK oldest first), write rearms it
+UWORD SysLogMgm_RTTraceHook(COMMONPARAMDB_ENTRY *, UWORD, UWORD, HPVOID, UWORD *, HPULONG);
+
 #endif
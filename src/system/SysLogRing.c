@@ -0,0 +1,604 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : SysLogRing.c                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Wear levelled ring of syslog record pages                  */
+/*               in the syslog flash sectors                                */
+/*                                                                          */
+/****************************************************************************/
+
+/////////////////////////////////////////////////////////////////////////////
+// Compiler Option
+#pragma GCC optimize (2)
+
+#include "common\CommonDefines.h"
+#include "system\SysLogRing.h"
+#include "system\SysLogData.h"
+#include "system\SysAppDataCodes.h"
+#include "common\BlockStorage.h"
+#include "common\FlashQueue.h"
+
+#include <string.h>
+
+//***************************************************************************
+// Defines
+
+    // sector not owned by a stream
+#define SYSLOGRING_FREE                 0xFFFF
+
+//***************************************************************************
+// Data structures
+
+typedef struct
+{
+    HPUBYTE hpubStart;
+    ULONG   ulSize;
+    UWORD   uwPages;                            // pages, header one included
+    UWORD   uwStream;                           // owner or SYSLOGRING_FREE
+    BOOL    bPinned;                            // holds records to migrate
+    BOOL    bBusy;                              // next sector of a stream
+    SYSLOGRING_SECTORHEADER sHeader;            // last known header
+} SYSLOGRING_SECTOR;
+
+typedef struct
+{
+    UWORD   uwSector[SYSLOGRING_MAX_SECTORS];   // chain, oldest first
+    UWORD   uwCount;
+    UWORD   uwHeadPage;                         // next page of the active sector
+    SWORD   swNext;                             // next sector, -1 if none
+    BOOL    bNextQueued;                        // header write queued
+    BOOL    bNextReady;                         // erased and header written
+    BOOL    bFailed;                            // next sector preparation failed
+    ULONG   ulNextTicket;
+    ULONG   ulEraseTicket;
+        // header record, kept until written
+    ULONG   ulHeader[(sizeof(BLKSTOR_HEADER)+sizeof(SYSLOGRING_SECTORHEADER)+sizeof(ULONG)-1)/sizeof(ULONG)];
+} SYSLOGRING_STREAM;
+
+//***************************************************************************
+// Locals
+
+static SYSLOGRING_SECTOR sSysLogRingSectors[SYSLOGRING_MAX_SECTORS];
+static UWORD uwSysLogRingSectorCount;
+
+static SYSLOGRING_STREAM sSysLogRingStreams[SYSLOGRING_STREAMS];
+
+    // sequence of the next prepared sector
+static ULONG ulSysLogRingSectorSeq;
+
+    // stream record, first of each page
+static const SWORD swSysLogRingRecordCode[SYSLOGRING_STREAMS]=
+{
+    DATACODE_SYSLOG_CLOCK,
+    DATACODE_SYSLOG_ALARMS,
+};
+
+    // records kept in the stream sectors: the last clock, the alarm history
+static const ULONG ulSysLogRingMinRecords[SYSLOGRING_STREAMS]=
+{
+    1,
+    SYSLOGDATA_ALARMS_MAX_ENTRIES,
+};
+
+//***************************************************************************
+// Local functions
+
+#define _sector(psStream, uwIdx)        (&sSysLogRingSectors[(psStream)->uwSector[uwIdx]])
+#define _active(psStream)               _sector(psStream, (psStream)->uwCount-1)
+#define _page(psSect, uwPage)           ((HPVOID)&(psSect)->hpubStart[(ULONG)(uwPage)*SYSLOGRING_PAGE_SIZE])
+
+    // first not written page of a sector, pages are written in order
+static UWORD _findhead(SYSLOGRING_SECTOR * psSect)
+{
+    UWORD lo=1, hi=psSect->uwPages, mid;
+
+    while(lo<hi)
+    {
+        mid=(lo+hi)/2;
+        if(ProgramFlashErasedCheck(_page(psSect, mid), SYSLOGRING_PAGE_SIZE)==0)
+            hi=mid;
+        else
+            lo=mid+1;
+    }
+
+    return lo;
+}
+
+    // TRUE if the oldest sector of the stream is not needed: the active
+    // sector is always kept, then the older ones up to the minimum records
+static BOOL _reclaimable(UWORD uwStream)
+{
+    SYSLOGRING_STREAM * psStream=&sSysLogRingStreams[uwStream];
+    ULONG records;
+    SWORD ct;
+
+    if(psStream->uwCount<2)
+        return FALSE;
+
+    records=psStream->uwHeadPage-1;
+    for(ct=psStream->uwCount-2;ct>0;ct--)
+    {
+        if(records>=ulSysLogRingMinRecords[uwStream])
+            break;
+        records+=_sector(psStream, ct)->uwPages-1;
+    }
+
+    return records>=ulSysLogRingMinRecords[uwStream];
+}
+
+    // select the sector to prepare: the least erased among the free ones
+    // and the oldest not needed of each stream; on equal wear the older
+    // content, free sectors first; if none, the oldest of the stream with
+    // more sectors, even if needed, as the pool is too small
+static SWORD _allocate(UWORD uwStream)
+{
+    SYSLOGRING_SECTOR * psSect;
+    SWORD sel=-1, ct, cts;
+    ULONG age, selage=0;
+
+    for(ct=0;ct<uwSysLogRingSectorCount;ct++)
+    {
+        psSect=&sSysLogRingSectors[ct];
+
+        if(psSect->bBusy || psSect->bPinned)
+            continue;
+
+        if(psSect->uwStream==SYSLOGRING_FREE)
+            age=0;
+        else if(sSysLogRingStreams[psSect->uwStream].uwSector[0]==ct && _reclaimable(psSect->uwStream))
+            age=psSect->sHeader.ulSectorSeq+1;
+        else
+            continue;
+
+        if(sel<0 || psSect->sHeader.ulEraseCount<sSysLogRingSectors[sel].sHeader.ulEraseCount ||
+            (psSect->sHeader.ulEraseCount==sSysLogRingSectors[sel].sHeader.ulEraseCount && age<selage))
+        {
+            sel=ct;
+            selage=age;
+        }
+    }
+
+    if(sel>=0)
+        return sel;
+
+    cts=uwStream;
+    for(ct=0;ct<SYSLOGRING_STREAMS;ct++)
+        if(sSysLogRingStreams[ct].uwCount>sSysLogRingStreams[cts].uwCount)
+            cts=ct;
+
+    if(sSysLogRingStreams[cts].uwCount>1 && !sSysLogRingSectors[sSysLogRingStreams[cts].uwSector[0]].bPinned)
+        sel=sSysLogRingStreams[cts].uwSector[0];
+
+    return sel;
+}
+
+    // queue header write of the next sector, after its erase; if queue is
+    // full it is retried by the tick
+static void _queueheader(SYSLOGRING_STREAM * psStream)
+{
+    SYSLOGRING_SECTOR * psSect=&sSysLogRingSectors[psStream->swNext];
+
+    if(FlashQ_Write((ULONG)psSect->hpubStart, psStream->ulHeader, sizeof(BLKSTOR_HEADER)+sizeof(SYSLOGRING_SECTORHEADER), NULL, NULL, &psStream->ulNextTicket)==FLASHQ_R_OK)
+        psStream->bNextQueued=TRUE;
+}
+
+    // start preparing next sector of the stream: erase and header write
+static void _prepare(UWORD uwStream)
+{
+    SYSLOGRING_STREAM * psStream=&sSysLogRingStreams[uwStream];
+    SYSLOGRING_SECTORHEADER * psHeader=(SYSLOGRING_SECTORHEADER *)&((HPUBYTE)psStream->ulHeader)[sizeof(BLKSTOR_HEADER)];
+    SYSLOGRING_SECTOR * psSect;
+    SYSLOGRING_STREAM * psOwner;
+    SWORD sel;
+
+    sel=_allocate(uwStream);
+    if(sel<0)
+        return;
+    psSect=&sSysLogRingSectors[sel];
+
+        // fill header, records follow the ones of the active sector
+    psHeader->ulSectorSeq=ulSysLogRingSectorSeq;
+    psHeader->ulFirstRecord=psStream->uwCount ? _active(psStream)->sHeader.ulFirstRecord+_active(psStream)->uwPages-1 : 0;
+    psHeader->ulEraseCount=psSect->sHeader.ulEraseCount+1;
+    psHeader->uwStream=uwStream;
+    psHeader->uwPageSize=SYSLOGRING_PAGE_SIZE;
+    blkstor_createheader(DATACODE_SYSLOG_SECTOR, psHeader, sizeof(*psHeader), (BLKSTOR_HEADER *)psStream->ulHeader);
+
+    if(FlashQ_Erase((ULONG)psSect->hpubStart, psSect->ulSize, NULL, NULL, &psStream->ulEraseTicket)!=FLASHQ_R_OK)
+        return;
+
+        // from now the sector content is lost, take it from its owner (it
+        // is the oldest of the chain)
+    if(psSect->uwStream!=SYSLOGRING_FREE)
+    {
+        psOwner=&sSysLogRingStreams[psSect->uwStream];
+        psOwner->uwCount--;
+        memmove(&psOwner->uwSector[0], &psOwner->uwSector[1], psOwner->uwCount*sizeof(psOwner->uwSector[0]));
+        psSect->uwStream=SYSLOGRING_FREE;
+    }
+
+    psSect->sHeader=*psHeader;
+    psSect->bBusy=TRUE;
+    ulSysLogRingSectorSeq++;
+
+    psStream->swNext=sel;
+    psStream->bNextQueued=FALSE;
+    psStream->bNextReady=FALSE;
+
+    _queueheader(psStream);
+}
+
+//***************************************************************************
+// Mount the pool
+
+BOOL SysLogRing_Init(const SYSLOGRING_SECTORDEF * psDefs, UWORD uwCount)
+{
+    SYSLOGRING_SECTOR * psSect;
+    SYSLOGRING_STREAM * psStream;
+    SYSLOGRING_SECTORHEADER hdr;
+    UWORD ct, cts;
+    ULONG ulMin;
+
+    if(uwCount>SYSLOGRING_MAX_SECTORS)
+        return FALSE;
+
+    memset(sSysLogRingStreams, 0, sizeof(sSysLogRingStreams));
+    for(ct=0;ct<SYSLOGRING_STREAMS;ct++)
+        sSysLogRingStreams[ct].swNext=-1;
+
+    ulSysLogRingSectorSeq=0;
+    uwSysLogRingSectorCount=uwCount;
+
+        // headers and pages are read through the linear address space
+    FlashQ_ReadLock();
+
+    for(ct=0;ct<uwCount;ct++)
+    {
+        psSect=&sSysLogRingSectors[ct];
+        memset(psSect, 0, sizeof(*psSect));
+        psSect->hpubStart=(HPUBYTE)psDefs[ct].hpvStart;
+        psSect->ulSize=psDefs[ct].ulSize;
+        psSect->uwPages=(UWORD)(psDefs[ct].ulSize/SYSLOGRING_PAGE_SIZE);
+        psSect->uwStream=SYSLOGRING_FREE;
+
+            // sectors without valid header are free
+        if(blkstor_getdata(psSect->hpubStart, 0, DATACODE_SYSLOG_SECTOR, &hdr, sizeof(hdr))!=sizeof(hdr) ||
+            hdr.uwStream>=SYSLOGRING_STREAMS || hdr.uwPageSize!=SYSLOGRING_PAGE_SIZE)
+            continue;
+
+        psSect->sHeader=hdr;
+        psSect->uwStream=hdr.uwStream;
+
+        if(hdr.ulSectorSeq>=ulSysLogRingSectorSeq)
+            ulSysLogRingSectorSeq=hdr.ulSectorSeq+1;
+
+            // insert in the stream chain, sorted by sector sequence
+        psStream=&sSysLogRingStreams[hdr.uwStream];
+        for(cts=psStream->uwCount;cts>0 && _sector(psStream, cts-1)->sHeader.ulSectorSeq>hdr.ulSectorSeq;cts--)
+            psStream->uwSector[cts]=psStream->uwSector[cts-1];
+        psStream->uwSector[cts]=ct;
+        psStream->uwCount++;
+    }
+
+        // sectors without header have lost their erase count, if an erase
+        // was interrupted, then take the least one
+    ulMin=0xFFFFFFFFul;
+    for(ct=0;ct<uwCount;ct++)
+        if(sSysLogRingSectors[ct].uwStream!=SYSLOGRING_FREE && sSysLogRingSectors[ct].sHeader.ulEraseCount<ulMin)
+            ulMin=sSysLogRingSectors[ct].sHeader.ulEraseCount;
+
+    if(ulSysLogRingSectorSeq)
+        for(ct=0;ct<uwCount;ct++)
+            if(sSysLogRingSectors[ct].uwStream==SYSLOGRING_FREE)
+                sSysLogRingSectors[ct].sHeader.ulEraseCount=ulMin;
+
+        // head of each stream in its newest sector
+    for(ct=0;ct<SYSLOGRING_STREAMS;ct++)
+    {
+        psStream=&sSysLogRingStreams[ct];
+        if(psStream->uwCount)
+            psStream->uwHeadPage=_findhead(_active(psStream));
+    }
+
+    FlashQ_ReadUnlock();
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Sectors without header
+
+BOOL SysLogRing_GetFreeSector(UWORD uwIdx, HPVOID * phpvStart, ULONG * pulSize)
+{
+    UWORD ct;
+
+    for(ct=0;ct<uwSysLogRingSectorCount;ct++)
+        if(sSysLogRingSectors[ct].uwStream==SYSLOGRING_FREE && !sSysLogRingSectors[ct].bBusy)
+            if(uwIdx--==0)
+            {
+                *phpvStart=sSysLogRingSectors[ct].hpubStart;
+                *pulSize=sSysLogRingSectors[ct].ulSize;
+                return TRUE;
+            }
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Pinning of free sectors
+
+void SysLogRing_Pin(HPVOID hpvAddress)
+{
+    SYSLOGRING_SECTOR * psSect;
+    UWORD ct;
+
+    for(ct=0,psSect=sSysLogRingSectors;ct<uwSysLogRingSectorCount;ct++,psSect++)
+        if((HPUBYTE)hpvAddress>=psSect->hpubStart && (HPUBYTE)hpvAddress<&psSect->hpubStart[psSect->ulSize] &&
+            psSect->uwStream==SYSLOGRING_FREE)
+            psSect->bPinned=TRUE;
+}
+
+void SysLogRing_UnpinAll(void)
+{
+    UWORD ct;
+
+    for(ct=0;ct<uwSysLogRingSectorCount;ct++)
+        sSysLogRingSectors[ct].bPinned=FALSE;
+}
+
+//***************************************************************************
+// Next record page
+
+HPVOID SysLogRing_NextFree(UWORD uwStream)
+{
+    SYSLOGRING_STREAM * psStream=&sSysLogRingStreams[uwStream];
+
+    if(psStream->uwCount==0 || psStream->uwHeadPage>=_active(psStream)->uwPages)
+        return NULL;
+
+    return _page(_active(psStream), psStream->uwHeadPage);
+}
+
+//***************************************************************************
+// Append record
+
+SWORD SysLogRing_Append(UWORD uwStream, const HPVOID hpvPage, ULONG * pulTicket)
+{
+    HPVOID hpvDest;
+
+    hpvDest=SysLogRing_NextFree(uwStream);
+    if(hpvDest==NULL)
+    {
+        SysLogRing_Tick();
+        hpvDest=SysLogRing_NextFree(uwStream);
+        if(hpvDest==NULL)
+            return SYSLOGRING_R_NOTREADY;
+    }
+
+    if(FlashQ_Write((ULONG)hpvDest, hpvPage, SYSLOGRING_PAGE_SIZE, NULL, NULL, pulTicket)!=FLASHQ_R_OK)
+        return SYSLOGRING_R_QUEUEFULL;
+
+    sSysLogRingStreams[uwStream].uwHeadPage++;
+
+        // move to the next sector or start preparing it
+    SysLogRing_Tick();
+
+    return SYSLOGRING_R_OK;
+}
+
+//***************************************************************************
+// Background step
+
+void SysLogRing_Tick(void)
+{
+    SYSLOGRING_STREAM * psStream;
+    UWORD ct;
+
+    for(ct=0;ct<SYSLOGRING_STREAMS;ct++)
+    {
+        psStream=&sSysLogRingStreams[ct];
+
+            // next sector ready when its header is written
+        if(psStream->swNext>=0 && !psStream->bNextQueued)
+            _queueheader(psStream);
+        if(psStream->bNextQueued && !psStream->bNextReady && FlashQ_IsDone(psStream->ulNextTicket))
+        {
+                // erase or header write failed, the stream is not extended
+                // any more
+            if(FlashQ_Result(psStream->ulEraseTicket)==FLASHQ_R_FLASHFAIL || FlashQ_Result(psStream->ulNextTicket)==FLASHQ_R_FLASHFAIL)
+            {
+                sSysLogRingSectors[psStream->swNext].bBusy=FALSE;
+                psStream->swNext=-1;
+                psStream->bNextQueued=FALSE;
+                psStream->bFailed=TRUE;
+                continue;
+            }
+
+            psStream->bNextReady=TRUE;
+        }
+
+            // active sector full, the next one becomes active
+        if(psStream->bNextReady && (psStream->uwCount==0 || psStream->uwHeadPage>=_active(psStream)->uwPages))
+        {
+            sSysLogRingSectors[psStream->swNext].bBusy=FALSE;
+            sSysLogRingSectors[psStream->swNext].uwStream=ct;
+            psStream->uwSector[psStream->uwCount++]=psStream->swNext;
+            psStream->uwHeadPage=1;
+            psStream->swNext=-1;
+            psStream->bNextQueued=FALSE;
+            psStream->bNextReady=FALSE;
+        }
+
+            // head on last page, prepare the next sector
+        if(psStream->swNext<0 && !psStream->bFailed && (psStream->uwCount==0 || psStream->uwHeadPage+1>=_active(psStream)->uwPages))
+            _prepare(ct);
+    }
+}
+
+//***************************************************************************
+// Wait next free page
+
+BOOL SysLogRing_WaitReady(UWORD uwStream)
+{
+    SYSLOGRING_STREAM * psStream=&sSysLogRingStreams[uwStream];
+
+    for(;;)
+    {
+        SysLogRing_Tick();
+
+        if(SysLogRing_NextFree(uwStream))
+            return TRUE;
+
+        if(psStream->swNext<0)
+            return FALSE;
+
+        if(psStream->bNextQueued)
+            FlashQ_Wait(psStream->ulNextTicket);
+        else
+            FlashQ_Tick();
+    }
+}
+
+//***************************************************************************
+// Sector preparation failed
+
+BOOL SysLogRing_Failed(void)
+{
+    UWORD ct;
+
+    for(ct=0;ct<SYSLOGRING_STREAMS;ct++)
+        if(sSysLogRingStreams[ct].bFailed)
+            return TRUE;
+
+    return FALSE;
+}
+
+//***************************************************************************
+// Records sequence
+
+ULONG SysLogRing_First(UWORD uwStream)
+{
+    SYSLOGRING_STREAM * psStream=&sSysLogRingStreams[uwStream];
+
+    if(psStream->uwCount==0)
+        return 0;
+
+    return _sector(psStream, 0)->sHeader.ulFirstRecord;
+}
+
+ULONG SysLogRing_Head(UWORD uwStream)
+{
+    SYSLOGRING_STREAM * psStream=&sSysLogRingStreams[uwStream];
+
+    if(psStream->uwCount==0)
+        return 0;
+
+    return _active(psStream)->sHeader.ulFirstRecord+psStream->uwHeadPage-1;
+}
+
+//***************************************************************************
+// Record by sequence, binary search of the sector
+
+HPVOID SysLogRing_GetRecord(UWORD uwStream, ULONG ulSeq)
+{
+    SYSLOGRING_STREAM * psStream=&sSysLogRingStreams[uwStream];
+    SYSLOGRING_SECTOR * psSect;
+    UWORD lo, hi, mid;
+
+    if(ulSeq<SysLogRing_First(uwStream) || ulSeq>=SysLogRing_Head(uwStream))
+        return NULL;
+
+    lo=0;
+    hi=psStream->uwCount-1;
+    while(lo<hi)
+    {
+        mid=(lo+hi+1)/2;
+        if(_sector(psStream, mid)->sHeader.ulFirstRecord<=ulSeq)
+            lo=mid;
+        else
+            hi=mid-1;
+    }
+
+    psSect=_sector(psStream, lo);
+    if(ulSeq-psSect->sHeader.ulFirstRecord>=(ULONG)psSect->uwPages-1)
+        return NULL;
+
+    return _page(psSect, ulSeq-psSect->sHeader.ulFirstRecord+1);
+}
+
+//***************************************************************************
+// Record time, from the stream record
+
+BOOL SysLogRing_GetRecordTime(UWORD uwStream, ULONG ulSeq, ULONG * pulTime)
+{
+    HPVOID hpvPage, hpvData;
+
+    hpvPage=SysLogRing_GetRecord(uwStream, ulSeq);
+    if(hpvPage==NULL)
+        return FALSE;
+
+    FlashQ_ReadLock();
+
+    if(blkstor_getaddr(hpvPage, 0, swSysLogRingRecordCode[uwStream], &hpvData)<(SWORD)sizeof(ULONG))
+    {
+        FlashQ_ReadUnlock();
+        return FALSE;
+    }
+
+    memcpy(pulTime, hpvData, sizeof(ULONG));
+
+    FlashQ_ReadUnlock();
+
+    return TRUE;
+}
+
+//***************************************************************************
+// Seek by time, binary search over records; not valid records (interrupted
+// writes) are skipped, any valid record before lo is older than ulTime, any
+// valid record from hi on is not
+
+ULONG SysLogRing_SeekTime(UWORD uwStream, ULONG ulTime)
+{
+    ULONG lo, hi, mid, probe, head, time;
+
+    lo=SysLogRing_First(uwStream);
+    hi=head=SysLogRing_Head(uwStream);
+
+    while(lo<hi)
+    {
+        mid=lo+(hi-lo)/2;
+
+        for(probe=mid;probe<hi && !SysLogRing_GetRecordTime(uwStream, probe, &time);probe++);
+
+        if(probe<hi && time<ulTime)
+            lo=probe+1;
+        else
+            hi=mid;
+    }
+
+    for(;lo<head && !SysLogRing_GetRecordTime(uwStream, lo, &time);lo++);
+
+    return lo;
+}
+
+//***************************************************************************
+// Wear
+
+void SysLogRing_GetWear(ULONG * pulMin, ULONG * pulMax)
+{
+    UWORD ct;
+
+    *pulMin=*pulMax=uwSysLogRingSectorCount ? sSysLogRingSectors[0].sHeader.ulEraseCount : 0;
+
+    for(ct=1;ct<uwSysLogRingSectorCount;ct++)
+    {
+        if(sSysLogRingSectors[ct].sHeader.ulEraseCount<*pulMin)
+            *pulMin=sSysLogRingSectors[ct].sHeader.ulEraseCount;
+        if(sSysLogRingSectors[ct].sHeader.ulEraseCount>*pulMax)
+            *pulMax=sSysLogRingSectors[ct].sHeader.ulEraseCount;
+    }
+}
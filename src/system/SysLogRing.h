@@ -0,0 +1,128 @@
+/****************************************************************************/
+/* Project: Ax-Zynq Control Board                                           */
+/*                                                                          */
+/* Copyright © 2021, Ningbo Physis Technology Co.,Ltd. All Rights Reserved. */
+/*                                                                          */
+/* File        : SysLogRing.h                                               */
+/* Author      : Fabio Terrile                                              */
+/*                                                                          */
+/* Description : Wear levelled ring of syslog record pages                  */
+/*               in the syslog flash sectors                                */
+/*                                                                          */
+/****************************************************************************/
+
+#ifndef _SYSLOGRING_H
+#define _SYSLOGRING_H
+
+#include "common\CommonDefines.h"
+#include "common\ProgramFlashHandler.h"
+
+//***************************************************************************
+// Format
+//
+// All syslog sectors (blocks of the linker file) form one pool shared by
+// the clock and the alarm streams. Each stream is a chain of sectors, the
+// first page of a sector holds its header (DATACODE_SYSLOG_SECTOR record),
+// the other pages hold one record each, written in order. A record is a
+// page of block storage records beginning with the stream record
+// (DATACODE_SYSLOG_CLOCK or DATACODE_SYSLOG_ALARMS), whose data begin with
+// the absolute time.
+//
+// Records have sequence numbers: the header stores the sequence of the
+// first record in the sector, so a record is found by index in
+// O(log sectors) and by time in O(log records), times being not
+// decreasing. Appending is O(1), the next sector of a stream is prepared
+// (erase and header) in background when the head reaches the last page of
+// the active one, taking the least erased free sector of the pool; sectors
+// holding the last records needed by a stream are never taken.
+//
+// Sectors without header (erased, or written with the previous format) are
+// free; those holding records still to be migrated can be pinned.
+//
+// Writes go through the flash queue: record pages are read through the
+// linear address space, so lookups are valid only while the queue is idle.
+
+//***************************************************************************
+// Defines
+
+#define SYSLOGRING_CLOCK                0
+#define SYSLOGRING_ALARM                1
+#define SYSLOGRING_STREAMS              2
+
+#define SYSLOGRING_MAX_SECTORS          8
+
+#define SYSLOGRING_PAGE_SIZE            PROGRAMFLASH_PAGE_SIZE
+
+    // return codes
+#define SYSLOGRING_R_OK                 0
+#define SYSLOGRING_R_NOTREADY           (-1)    // next page sector not yet prepared
+#define SYSLOGRING_R_QUEUEFULL          (-2)    // flash queue full, retry
+
+//***************************************************************************
+// Data structures
+
+    // sector header
+typedef struct
+{
+    ULONG ulSectorSeq;                  // newer sectors have greater values
+    ULONG ulFirstRecord;                // sequence of the first record in the sector
+    ULONG ulEraseCount;                 // erase cycles of the sector
+    UWORD uwStream;                     // owner stream
+    UWORD uwPageSize;                   // record size
+} SYSLOGRING_SECTORHEADER;
+
+typedef struct
+{
+    HPVOID hpvStart;
+    ULONG ulSize;
+} SYSLOGRING_SECTORDEF;
+
+//***************************************************************************
+// Global functions
+
+    // mount the pool, no flash writes; sectors are read in definition order
+BOOL SysLogRing_Init(const SYSLOGRING_SECTORDEF * psDefs, UWORD uwCount);
+
+    // sectors without header, for the previous format records scan
+BOOL SysLogRing_GetFreeSector(UWORD uwIdx, HPVOID * phpvStart, ULONG * pulSize);
+
+    // pin the free sector holding the address (not given to streams), or
+    // unpin all of them
+void SysLogRing_Pin(HPVOID hpvAddress);
+void SysLogRing_UnpinAll(void);
+
+    // page of the next record, NULL if its sector is not yet prepared
+HPVOID SysLogRing_NextFree(UWORD uwStream);
+
+    // queue record page write at the next free page; page data must stay
+    // unchanged until the ticket is done (FlashQ_IsDone)
+SWORD SysLogRing_Append(UWORD uwStream, const HPVOID hpvPage, ULONG * pulTicket);
+
+    // background step: complete and start sector preparations
+void SysLogRing_Tick(void);
+
+    // wait next free page is available, FALSE if no sector can be prepared
+BOOL SysLogRing_WaitReady(UWORD uwStream);
+
+    // TRUE if the flash failed preparing a sector, streams are no more
+    // extended
+BOOL SysLogRing_Failed(void);
+
+    // sequence of the oldest record and of the next one
+ULONG SysLogRing_First(UWORD uwStream);
+ULONG SysLogRing_Head(UWORD uwStream);
+
+    // record page by sequence, NULL if not in the ring
+HPVOID SysLogRing_GetRecord(UWORD uwStream, ULONG ulSeq);
+
+    // absolute time of a record, FALSE if the record is not valid
+BOOL SysLogRing_GetRecordTime(UWORD uwStream, ULONG ulSeq, ULONG * pulTime);
+
+    // sequence of the first valid record with time not less than given,
+    // SysLogRing_Head() if none
+ULONG SysLogRing_SeekTime(UWORD uwStream, ULONG ulTime);
+
+    // erase cycles of the most and least erased sector
+void SysLogRing_GetWear(ULONG * pulMin, ULONG * pulMax);
+
+#endif